@@ -44,4 +44,6 @@
 
 #include "dora/dflusher.h"
 
+#include "dora/sec_idx.h"
+
 #endif /** __DORA_H */
@@ -163,6 +163,11 @@ public:
         _partition->enqueue_commit(this);
     }
 
+    base_partition_t* own_partition() const 
+    {
+        return (_partition);
+    }
+
     virtual void giveback()=0;                            
 
 
@@ -44,6 +44,7 @@ ENTER_NAMESPACE(dora);
 
 
 struct rvp_t; 
+class base_partition_t;
 
 /******************************************************************** 
  *
@@ -187,6 +188,9 @@ public:
     // enqueues self on the list of committed actions
     virtual void notify_own_partition()=0; 
 
+    // the partition this action was enqueued to
+    virtual base_partition_t* own_partition() const=0;
+
     // should give memory back to the atomic trash stack
     virtual void giveback()=0;
 
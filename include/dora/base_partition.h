@@ -103,6 +103,9 @@ public:
     virtual base_action_t* dequeue()=0;
     virtual base_action_t* dequeue_commit()=0;
 
+    // enqueues a batch of committed actions with a single wake-up
+    virtual int enqueue_commit_batch(base_action_t** actions, const uint_t n)=0;
+
     // resets/initializes the partition, possibly to a new processor
     virtual int reset(const processorid_t aprsid)=0;
  
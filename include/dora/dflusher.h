@@ -76,11 +76,29 @@
 
    dora-notifier:
    while (true) {
-      rvp* prvp = tonotify->dequeue();
-      prvp->notify_partitions();
-      prvp->notify_client();
+      do {
+         rvp* prvp = tonotify->dequeue();
+         prvp->collect_committed(partBatch);
+         rvpBatch.add(prvp);
+      } while (!tonotify->is_empty());
+      for each partition in partBatch 
+         partition->enqueue_commit_batch(actions);
+      for each prvp in rvpBatch
+         prvp->notify_client();
    }
 
+   That is, the notifier drains whatever the flusher has handed to it and 
+   enqueues the committed actions with a single push (and a single wake-up)
+   per partition, instead of one per action. Clients are already woken up
+   once per batch of trxs (only the last trx of a client batch carries the
+   client's condex), so the client wake-ups are not coalesced further.
+
+   With thousands of xcts per flush group a single notifier becomes the 
+   bottleneck. There can be multiple notifiers per dora-flusher (set by 
+   "dora-notifiers"). Each xct is sharded to a notifier by the partition of 
+   its first action, so that each notifier serves a subset of the partitions
+   and its per-partition batches are larger.
+
    In order to enable this mechanism Shore-kits needs to be configured with:
    --enable-dflusher
 */
@@ -92,6 +110,7 @@
 #include "sm/shore/shore_flusher.h"
 
 #include "dora/rvp.h"
+#include "dora/base_partition.h"
 
 using namespace shore;
 
@@ -118,7 +137,7 @@ public:
 
 private:
 
-    guard<dora_notifier_t> _notifier;
+    std::vector<dora_notifier_t*> _notifiers;
 
     guard<DoraQueue> _dora_toflush;
     guard<DoraQueue> _dora_flushing;
@@ -132,6 +151,13 @@ protected:
                                uint& waiting);
     virtual int _move_from_flushing(const lsn_t& durablelsn);
 
+    // Returns the notifier responsible for the partitions of this xct
+    inline dora_notifier_t* _notifier_for(terminal_rvp_t* prvp) {
+        base_partition_t* pp = prvp->home_partition();
+        uint_t idx = (pp ? (pp->part_id() % _notifiers.size()) : 0);
+        return (_notifiers[idx]);
+    }
+
 public:
 
     dora_flusher_t(ShoreEnv* penv, c_str tname,
@@ -161,15 +187,28 @@ class dora_notifier_t : public base_worker_t
 {   
 public:
     typedef srmwqueue<terminal_rvp_t>    DoraQueue;
+    typedef terminal_rvp_t::PartActionsMap PartActionsMap;
+    typedef std::vector<terminal_rvp_t*> RvpVec;
 
 private:
 
     guard<DoraQueue> _tonotify;
     guard<Pool> _pxct_tonotify_pool;
+
+    // The batch being notified
+    PartActionsMap _part_batch;
+    RvpVec         _rvp_batch;
+
+    // stats
+    uint_t _batches;
+    uint_t _notified;
     
     int _pre_STOP_impl();
     int _work_ACTIVE_impl(); 
 
+    void _add_to_batch(terminal_rvp_t* prvp);
+    void _notify_batch();
+
 public:
 
     dora_notifier_t(ShoreEnv* env, c_str tname,
@@ -44,6 +44,7 @@
 #include "dora/range_table_i.h"
 
 #include "dora/dflusher.h"
+#include "dora/sec_idx.h"
 
 using namespace shore;
 
@@ -98,6 +99,12 @@ protected:
     // A vector of dora-flusher thread(s)
     std::vector<dora_flusher_t*> _vec_flusher;
 
+    // Routing statistics (actions and cross-partition actions per trx)
+    route_stats_t _route_stats;
+
+    // The shore environment of this instance, set at _post_start()
+    ShoreEnv* _shore_env;
+
 public:
     
     DoraEnv();
@@ -136,6 +143,18 @@ public:
     {
         return (_num_flushers);
     }
+
+    inline route_stats_t* route_stats() { return (&_route_stats); }
+
+    // Without the dora-flusher, the xcts committed in the CM_ASYNCH_DURABLE
+    // mode are handed to the durability notifier of the shore environment
+    inline bool is_durable_notify() const {
+        return (_shore_env && _shore_env->isDurableNotify());
+    }
+    inline void notify_when_durable(terminal_rvp_t* arvp) {
+        w_assert2 (_shore_env);
+        _shore_env->to_durable_notifier(arvp);
+    }
             
 
 protected:
@@ -184,6 +184,7 @@ public:
 
     // deque of actions to be committed
     int enqueue_commit(Action* apa, const bool bWake=true);
+    int enqueue_commit_batch(base_action_t** actions, const uint_t n);
     virtual base_action_t* dequeue_commit();
     inline int has_committed(void) const { 
         return (!_committed_queue->is_empty()); 
@@ -323,6 +324,26 @@ int partition_t<DataType>::enqueue_commit(Action* pAction, const bool bWake)
 }
 
 
+/****************************************************************** 
+ *
+ * @fn:     enqueue_commit_batch()
+ *
+ * @brief:  Pushes a batch of committed actions to the partition's 
+ *          committed actions list, waking up the owner only once
+ *
+ ******************************************************************/
+
+template <class DataType>
+int partition_t<DataType>::enqueue_commit_batch(base_action_t** actions, 
+                                                const uint_t n)
+{
+    TRACE( TRACE_TRX_FLOW, "Enq (%d) committed to (%s-%d)\n", 
+           n, _table->name(), _part_id);
+    _committed_queue->push_batch(actions,n,true);
+    return (0);
+}
+
+
 
 /****************************************************************** 
  *
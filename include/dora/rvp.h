@@ -32,6 +32,7 @@
 #ifndef __DORA_RVP_H
 #define __DORA_RVP_H
 
+#include <map>
 
 #include "sm/shore/shore_reqs.h"
 #include "sm/shore/shore_env.h"
@@ -207,6 +208,16 @@ public:
 
     int notify_partitions();  // notifies for committed actions    
 
+    // appends the committed actions to the per-partition batches,
+    // to be enqueued later with one push per partition
+    typedef std::map<base_partition_t*, baseActionsList> PartActionsMap;
+    int collect_committed(PartActionsMap& partBatch);
+
+    // the partition of the first action, used for sharding the notification
+    inline base_partition_t* home_partition() const {
+        return (_actions.empty() ? NULL : _actions[0]->own_partition());
+    }
+
     virtual void upd_committed_stats()=0; // update the committed trx stats
     virtual void upd_aborted_stats()=0;   // update the aborted trx stats
 
@@ -0,0 +1,228 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   sec_idx.h
+ *
+ *  @brief:  Partition-aware routing of secondary index accesses in DORA,
+ *           and routing statistics (messages per trx, by-name latency)
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   A DORA action that accesses a table through a secondary index does not
+   know the routing key up front. Up to now such an access was either executed
+   as a secondary (non-partitioned) action by the dispatcher, or it costed an
+   extra round trip (probe the index, then route to the owner).
+
+   When the routing field is the leading component of the secondary index key
+   (for example C_NAME_IDX on {C_W_ID,C_D_ID,C_LAST,...}), or the secondary
+   key is a function of the routing field (for example TM1 SUB_NBR is the
+   zero-padded S_ID), each DORA partition owns a contiguous slice of the index:
+   the entries whose routing key falls in its range. The sec_idx_router_t
+   records this alignment and sends the access directly to the partition that
+   owns the slice, in one hop.
+
+   In addition, the router keeps one sec_idx_slice_t per partition. It maps a
+   secondary key to the (ordered) list of primary keys that the index returned
+   for it. The first lookup of a secondary key scans the index and fills the
+   slice of the owner; the following ones are served from the slice, without
+   touching the B-tree. The slice is valid as long as the workload does not
+   insert rows or update the indexed fields of the table (true for C_NAME_IDX
+   in TPC-C). Otherwise, the writer has to invalidate() the slice.
+*/
+
+#ifndef __DORA_SEC_IDX_H
+#define __DORA_SEC_IDX_H
+
+#include "util.h"
+#include "shore.h"
+
+#include "dora/range_table_i.h"
+
+using namespace shore;
+
+ENTER_NAMESPACE(dora);
+
+
+/********************************************************************
+ *
+ * @class: sec_idx_slice_t
+ *
+ * @brief: The part of a secondary index that is owned by a partition.
+ *         Maps a secondary key to the primary keys it qualifies, in
+ *         the order the index returns them
+ *
+ * @note:  Accessed only by the worker (and standby threads) of the
+ *         owning partition, so the lock is practically uncontended
+ *
+ ********************************************************************/
+
+class sec_idx_slice_t
+{
+public:
+    typedef map< string, vector<int> > SliceMap;
+
+private:
+
+    tatas_lock _lock;
+    SliceMap   _map;
+
+    // stats
+    uint_t _hits;
+    uint_t _misses;
+
+public:
+
+    sec_idx_slice_t() : _hits(0), _misses(0) { }
+    ~sec_idx_slice_t() { }
+
+    // Returns true and the primary keys of the secondary key, if cached
+    bool get(const string& seckey, vector<int>& pkeys);
+
+    // Stores the primary keys the index returned for the secondary key
+    void put(const string& seckey, const vector<int>& pkeys);
+
+    void invalidate();
+
+    inline uint_t hits() const { return (_hits); }
+    inline uint_t misses() const { return (_misses); }
+    inline uint_t size() const { return (_map.size()); }
+    void reset_stats() { _hits = 0; _misses = 0; }
+
+}; // EOF: sec_idx_slice_t
+
+
+
+/********************************************************************
+ *
+ * @class: sec_idx_router_t
+ *
+ * @brief: Routes the accesses through a secondary index, whose key
+ *         space is sliced along the routing field of a DORA table,
+ *         to the partition that owns the corresponding slice
+ *
+ ********************************************************************/
+
+class sec_idx_router_t
+{
+public:
+    typedef range_table_i<int>  irpTableImpl;
+    typedef partition_t<int>    irpImpl;
+    typedef map< shpid_t, sec_idx_slice_t* > SlicePtrMap;
+
+private:
+
+    const char*   _idxname;
+    irpTableImpl* _ptable;
+
+    // One slice per partition, created the first time it is accessed
+    tatas_lock    _slice_lock;
+    SlicePtrMap   _slice_map;
+
+    // stats
+    volatile uint_t _lookups;
+    volatile uint_t _slices;
+
+public:
+
+    sec_idx_router_t(const char* idxname, irpTableImpl* ptable);
+    ~sec_idx_router_t();
+
+    inline const char* name() const { return (_idxname); }
+
+    // Returns the partition that owns the slice of the given routing key
+    inline irpImpl* route(const int rkey) {
+        cvec_t key((char*)&rkey,sizeof(int));
+        lpid_t pid;
+        w_rc_t r = _ptable->getPartIdxByKey(key,pid);
+        if (r.is_error()) { assert(false); return (NULL); }
+        atomic_inc_uint(&_lookups);
+        return (_ptable->get(pid.page));
+    }
+
+    // Returns the slice of the index owned by the partition of the routing key
+    sec_idx_slice_t* slice(const int rkey);
+
+    // Drops the contents of all the slices
+    void invalidate();
+
+    // A scan over the secondary index that spans multiple slices
+    // is broken into one action per slice
+    inline void add_slices(const uint n) { atomic_add_int(&_slices, n); }
+
+    void reset();
+    void statistics() const;
+
+}; // EOF: sec_idx_router_t
+
+
+
+/********************************************************************
+ *
+ * @class: route_stats_t
+ *
+ * @brief: Counters of the number of actions (messages) that each trx
+ *         sends to partitions, how many of them go to a partition other
+ *         than the trx's home one, and the latency of the lookups through
+ *         a secondary index (for example Payment-by-name)
+ *
+ ********************************************************************/
+
+class route_stats_t
+{
+private:
+
+    volatile uint_t _trxs;
+    volatile uint_t _actions;
+    volatile uint_t _remote;
+
+    volatile uint_t   _byname;
+    volatile uint64_t _byname_us;
+
+public:
+
+    route_stats_t() { reset(); }
+    ~route_stats_t() { }
+
+    inline void add_trx(const uint actions, const uint remote) {
+        atomic_inc_uint(&_trxs);
+        atomic_add_int(&_actions, actions);
+        atomic_add_int(&_remote, remote);
+    }
+
+    inline void add_byname(const long long us) {
+        atomic_inc_uint(&_byname);
+        atomic_add_64(&_byname_us, us);
+    }
+
+    void reset();
+    void print() const;
+
+}; // EOF: route_stats_t
+
+
+EXIT_NAMESPACE(dora);
+
+#endif /** __DORA_SEC_IDX_H */
@@ -180,6 +180,12 @@ public:
     DECLARE_DORA_PARTS(sf);
     DECLARE_DORA_PARTS(cf);
 
+    //// Secondary indexes sliced along the routing field
+
+    // SUB_NBR_IDX {SUB_NBR}, where SUB_NBR is the zero-padded S_ID
+    guard<sec_idx_router_t> _subnbr_sidx;
+    inline sec_idx_router_t* subnbr_sidx() { return (_subnbr_sidx.get()); }
+
 
 
     //// DORA TM1 - TRXs   
@@ -149,6 +149,12 @@ public:
     DECLARE_DORA_PARTS(oli);
     DECLARE_DORA_PARTS(sto);
 
+    //// Secondary indexes sliced along the routing field
+
+    // C_NAME_IDX {C_W_ID,C_D_ID,C_LAST,C_FIRST,C_ID} is sliced on C_W_ID
+    guard<sec_idx_router_t> _cname_sidx;
+    inline sec_idx_router_t* cname_sidx() { return (_cname_sidx.get()); }
+
 
     //// DORA TPCC TRXs
 
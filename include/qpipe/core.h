@@ -25,9 +25,14 @@
 #define __QPIPE_CORE_H
 
 #include "qpipe/core/cpu_bind.h"
+#include "qpipe/core/build_cache.h"
 #include "qpipe/core/dispatcher.h"
+#include "qpipe/core/fifo_bench.h"
 #include "qpipe/core/functors.h"
 #include "qpipe/core/packet.h"
+#include "qpipe/core/plan_cache.h"
+#include "qpipe/core/result_cache.h"
+#include "qpipe/core/runtime_filter.h"
 #include "qpipe/core/stage.h"
 #include "qpipe/core/stage_container.h"
 #include "qpipe/core/tuple.h"
@@ -0,0 +1,210 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   build_cache.h
+ *
+ *  @brief:  Cache of the hash tables built by the hash joins, keyed by
+ *           the signature of the plan of their right relation
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   Many queries join with the same small relations, e.g. the TPC-H ones
+   build hash tables on NATION join REGION or on SUPPLIER with the same
+   filters over and over. OSP shares such a build only between identical
+   joins that run at the same time, and the result cache only keeps the
+   outputs of whole packets.
+
+   When a HASH_JOIN reads its whole right relation in memory, it hands
+   the pages of the relation and the hash table over them to the build
+   cache. A later HASH_JOIN whose right relation has the same plan (as in
+   the result cache, result_cache_t::signature()), the same key and the
+   same DISTINCT flag probes the cached table instead. It neither
+   dispatches its right packet nor reads the right relation.
+
+   The entries are invalidated like the ones of the result cache, by the
+   versions of the tables they read. The cache holds up to qpipe-bcache-mb
+   MB (0 disables it), and the least recently used entries are evicted to
+   make room. An entry is reference counted, thus it is freed when the
+   last join probing it is done, even if it has been evicted. As in the
+   result cache, the map, the LRU list and the reference counts are the
+   plan_cache_t's.
+
+   The functors of the table keep only offsets and sizes, not the join,
+   since the table outlives the join that built it.
+*/
+
+#ifndef __QPIPE_BUILD_CACHE_H
+#define __QPIPE_BUILD_CACHE_H
+
+#include "qpipe/core/tuple.h"
+#include "qpipe/core/tuple_fifo.h"
+#include "qpipe/core/functors.h"
+#include "qpipe/core/plan_cache.h"
+#include "qpipe/core/result_cache.h"
+#include "util/hashtable.h"
+#include "util/fnv.h"
+
+#include <cstring>
+#include <string>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/* exported datatypes */
+
+
+/**
+ *  @brief The functors of the hash table of a right relation
+ */
+struct build_key_t {
+
+    size_t _offset;
+
+    build_key_t(tuple_join_t* join, bool right)
+        : _offset(right ? join->right_key_offset() : join->left_key_offset())
+    {
+    }
+
+    const char* const operator()(const char* tuple) const {
+        return tuple + _offset;
+    }
+};
+
+
+struct build_equal_t {
+
+    size_t _len;
+
+    build_equal_t(size_t len)
+        : _len(len)
+    {
+    }
+
+    bool operator()(const char* a, const char* b) const {
+        return !memcmp(a, b, _len);
+    }
+};
+
+
+struct build_hash_t {
+
+    size_t _len;
+
+    build_hash_t(size_t len)
+        : _len(len)
+    {
+    }
+
+    size_t operator()(const char* key) const {
+        return fnv_hash(key, _len);
+    }
+};
+
+
+typedef hashtable<char *,
+                  const char *,
+                  build_key_t,
+                  build_equal_t,
+                  build_equal_t,
+                  build_hash_t> build_table_t;
+
+
+
+/**
+ *  @brief A cached hash table and the pages of the tuples it points
+ *  to. Both are read-only once the entry is in the cache.
+ */
+struct build_cache_entry_t : public plan_cache_entry_t
+{
+    build_table_t* _table;
+    page_list      _pages;
+
+    build_cache_entry_t()
+        : _table(NULL)
+    {
+    }
+
+    virtual ~build_cache_entry_t();
+
+    build_table_t* table() { return (_table); }
+};
+
+
+
+/**
+ *  @brief The build cache. All its methods are static and thread-safe.
+ */
+class build_cache_t
+{
+    static plan_cache_t _cache;
+
+    static bool _key(query_plan const* right_plan, tuple_join_t* join,
+                     bool distinct, std::string& key,
+                     plan_cache_entry_t::version_list_t& versions);
+
+public:
+
+    // Reads qpipe-bcache-mb
+    static void init();
+
+    static bool is_enabled() { return (_cache.is_enabled()); }
+
+    /**
+     *  @brief Looks up a valid table for the right relation of a join.
+     *  On a hit the entry is pinned and the caller must release() it
+     *  when done probing.
+     */
+    static build_cache_entry_t* lookup(query_plan const* right_plan,
+                                       tuple_join_t* join, bool distinct);
+    static void release(build_cache_entry_t* e) { _cache.release(e); }
+
+    /**
+     *  @brief Inserts the table of the right relation of a join. The
+     *  cache takes over the table and its pages. Returns the entry
+     *  pinned for the caller, who probes it and then releases it. If
+     *  the table is not kept the entry is freed by that release().
+     */
+    static build_cache_entry_t* insert(query_plan const* right_plan,
+                                       tuple_join_t* join, bool distinct,
+                                       build_table_t* table,
+                                       page_list& pages, size_t bytes);
+
+    static void print_stats() { _cache.print_stats(); }
+    static void reset_stats() { _cache.reset_stats(); }
+};
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+template<>
+inline void guard<qpipe::build_cache_entry_t>::action(qpipe::build_cache_entry_t* ptr) {
+    qpipe::build_cache_t::release(ptr);
+}
+
+
+#endif
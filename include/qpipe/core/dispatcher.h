@@ -48,6 +48,9 @@ static const int DISPATCHER_NUM_STATIC_HASH_MAP_BUCKETS = 64;
 
 /* exported datatypes */
 
+struct result_cache_entry_t;
+struct tscan_packet_t;
+
 /**
  *  @brief QPIPE dispatcher that dispatches all packets. All stages
  *  should register themselves with the dispatcher on startup. This
@@ -77,6 +80,8 @@ protected:
     void _register_stage_container(const c_str& packet_type,
                                    stage_container_t* sc, bool osp);
     void _dispatch_packet(packet_t* packet);
+    void _replay_cached_result(packet_t* packet, result_cache_entry_t* entry);
+    void _dispatch_circular_scan(tscan_packet_t* packet);
     void _reserve_workers(const c_str& type, int n);
     void _unreserve_workers(const c_str& type, int n);
     bool _is_osp_enabled_for_type(const c_str& packet_type);
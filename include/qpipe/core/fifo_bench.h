@@ -0,0 +1,79 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   fifo_bench.h
+ *
+ *  @brief:  Microbenchmark of the throughput of the tuple_fifo
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   The "fifobench" shell command passes tuples from a producer thread to
+   the shell thread through a tuple_fifo, for tuple sizes from 8 to 1024
+   bytes, once through the per-tuple interface (allocate()/get_tuple())
+   and once through the batch one (reserve()/commit()/get_tuples()). The
+   producer copies a source tuple into each slot, as a projection does,
+   and the consumer reads the first bytes of each tuple, thus the numbers
+   are the FIFO overhead plus one memcpy per tuple.
+*/
+
+#ifndef __QPIPE_FIFO_BENCH_H
+#define __QPIPE_FIFO_BENCH_H
+
+#include "util.h"
+#include "util/shell.h"
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+// The interface of the tuple_fifo the benchmark uses
+enum eFifoBenchMode { FIFO_BENCH_TUPLE = 0,   // allocate()/get_tuple()
+                      FIFO_BENCH_BATCH = 1 }; // reserve()/commit()/get_tuples()
+
+
+/**
+ *  @brief Passes tuple_count tuples of tuple_size bytes through a
+ *  tuple_fifo. Returns the throughput in tuples/sec, or a negative
+ *  value if tuples were lost.
+ */
+double fifo_bench(const size_t tuple_size, const size_t tuple_count,
+                  const eFifoBenchMode mode);
+
+
+
+struct fifobench_cmd_t : public command_handler_t
+{
+    void setaliases();
+    int handle(const char* cmd);
+    void usage();
+    string desc() const;
+};
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+#endif
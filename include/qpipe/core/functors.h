@@ -518,6 +518,16 @@ public:
         assert(false);
     }
 
+    /**
+     * @brief Returns true if merge() is implemented. The parallel
+     * aggregation then splits the input without regard to the groups
+     * and merges the partial aggregates of each group at the end.
+     */
+
+    virtual bool can_merge() const {
+        return false;
+    }
+
     /**
      *  @brief Convert the internal aggregate state into a final
      *  output tuple. This method will be invoked when there are no
@@ -28,6 +28,7 @@
 #include "qpipe/core/tuple.h"
 #include "qpipe/core/tuple_fifo.h"
 #include "qpipe/core/functors.h"
+#include "qpipe/core/runtime_filter.h"
 #include "qpipe/core/query_state.h"
 #include "util/resource_declare.h"
 
@@ -58,9 +59,18 @@ struct query_plan {
     c_str filter;
     query_plan const** child_plans;
     int child_count;
+
+    /* The version counter of the table read by a leaf (NULL if the
+       input is not a table) and its value when the plan was
+       created. Used by the result cache to tell whether a result
+       computed by this plan is still valid. */
+    volatile uint32_t const* version;
+    uint32_t version_seen;
     
-    query_plan(const c_str &a, const c_str &f, query_plan const** children, int count)
-        : action(a), filter(f), child_plans(children), child_count(count)
+    query_plan(const c_str &a, const c_str &f, query_plan const** children, int count,
+               volatile uint32_t const* v=NULL)
+        : action(a), filter(f), child_plans(children), child_count(count),
+          version(v), version_seen(v ? *v : 0)
     {
     }
 };
@@ -139,6 +149,10 @@ public:
 private:
     guard<tuple_fifo> _output_buffer;
 
+    /* The runtime filter of the join that consumes our output, if
+       any. We hold a reference to it. */
+    runtime_filter_t* _rfilter;
+
 public:
     //guard<tuple_filter_t> _output_filter;
     //MA: Dirty solution to avoid the double-free bug.
@@ -178,6 +192,21 @@ public:
     tuple_fifo* output_buffer() {
         return _output_buffer;
     }
+
+    /**
+     *  @brief Filter the output of this packet with the runtime filter
+     *  of the join that consumes it, once the join publishes it. Must
+     *  be called before the packet is dispatched.
+     */
+    void attach_runtime_filter(runtime_filter_t* rfilter) {
+        assert(_rfilter == NULL);
+        rfilter->add_ref();
+        _rfilter = rfilter;
+    }
+
+    runtime_filter_t* runtime_filter() {
+        return _rfilter;
+    }
     
     /**
      *  @brief Check whether this packet can be merged with the
@@ -0,0 +1,155 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   plan_cache.h
+ *
+ *  @brief:  The lookup, LRU eviction, pinning and stats shared by the
+ *           result cache and the build cache
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   The result cache and the build cache keep different things (the pages
+   of a result, a hash table and its pages) under the same kind of key,
+   the signature of a plan, and validate them the same way, by the
+   versions of the tables the plan reads. The plan_cache_t is the part
+   they share: the map of the entries, the LRU list, the reference counts
+   and the stats. Each of them owns one and adds how its key is built and
+   what its entries hold.
+*/
+
+#ifndef __QPIPE_PLAN_CACHE_H
+#define __QPIPE_PLAN_CACHE_H
+
+#include "util.h"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/* exported datatypes */
+
+
+/**
+ *  @brief An entry of a plan cache. The subclasses free what they hold
+ *  in their destructors, which run when the last reference is dropped.
+ */
+struct plan_cache_entry_t
+{
+    typedef std::pair<volatile uint32_t const*, uint32_t> version_t;
+    typedef std::vector<version_t> version_list_t;
+
+    std::string    _key;
+    version_list_t _versions;    // table versions seen by the plan
+    size_t         _bytes;
+
+    int  _refs;                  // the cache and the readers
+    bool _cached;                // false once evicted or invalidated
+
+    std::list<plan_cache_entry_t*>::iterator _lru;
+
+    plan_cache_entry_t()
+        : _bytes(0), _refs(0), _cached(false)
+    {
+    }
+
+    virtual ~plan_cache_entry_t();
+
+    bool is_valid() const;
+};
+
+
+
+/**
+ *  @brief A size-bounded, LRU, reference counted cache of plan_cache
+ *  entries. All its methods are thread-safe.
+ */
+class plan_cache_t
+{
+    typedef std::map<std::string, plan_cache_entry_t*> entry_map_t;
+    typedef std::list<plan_cache_entry_t*>              lru_list_t;
+
+    const char*     _name;           // for the stats
+    pthread_mutex_t _lock;
+
+    size_t _max_bytes;
+    size_t _max_entry_bytes;
+
+    entry_map_t _entries;
+    lru_list_t  _lru;                // most recently used first
+    size_t      _bytes;
+
+    // stats
+    uint64_t _hits;
+    uint64_t _misses;
+    uint64_t _inserts;
+    uint64_t _invalidations;
+    uint64_t _evictions;
+
+    // Must hold the _lock
+    void _unlink(plan_cache_entry_t* e);
+    void _unpin(plan_cache_entry_t* e);
+
+public:
+
+    plan_cache_t(const char* name);
+
+    // With max_bytes=0 nothing is cached
+    void set_size(size_t max_bytes, size_t max_entry_bytes);
+
+    bool is_enabled() const { return (_max_bytes > 0); }
+    size_t max_entry_bytes() const { return (_max_entry_bytes); }
+
+    /**
+     *  @brief Looks up a valid entry. On a hit the entry is pinned and
+     *  the caller must release() it. Stale entries are dropped here.
+     */
+    plan_cache_entry_t* lookup(const std::string& key);
+    void release(plan_cache_entry_t* e);
+
+    /**
+     *  @brief Inserts an entry whose _key, _versions and _bytes are set,
+     *  evicting the least recently used entries to make room for it. The
+     *  cache takes a reference on top of the ones of the caller.
+     *
+     *  @return false if the entry is not kept, because it is too large
+     *  or its tables were written since its plan was created.
+     */
+    bool insert(plan_cache_entry_t* e);
+
+    void print_stats();
+    void reset_stats();
+};
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+#endif
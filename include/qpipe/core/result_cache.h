@@ -0,0 +1,155 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   result_cache.h
+ *
+ *  @brief:  Cache of the results of (sub)plans, keyed by the plan
+ *           signature and the versions of the tables read
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   OSP shares the work of identical packets that run at the same time. The
+   result cache shares it also across time: the output of a packet is kept
+   as a list of pages and a later packet with the same plan is answered by
+   an RSCAN packet that replays those pages, instead of running its whole
+   subtree again.
+
+   The key of an entry is the signature of the plan of the packet, the
+   action and the filter of each node of the plan tree, e.g.
+
+       HASH_JOIN:...{filter}(TSCAN:ORDERS{filter};TSCAN:LINEITEM{filter})
+
+   Like OSP, it relies on the to_string() of the filters, aggregates and
+   joins describing all their parameters, e.g. the random predicates of
+   the TPC-H queries. A node that leaves a parameter out makes different
+   queries share an entry. The filter of the packet itself is part of the
+   key, since the cached tuples are the ones after that filter (and
+   projection).
+
+   Only plans whose leaves are all table scans are cached. Each table scan
+   takes the version of its table when its plan is created
+   (query_plan::version_seen) and the table manager bumps the version at
+   every write, once init() has turned the version tracking on (the writes
+   leave the versions alone while no cache is enabled). An entry keeps the
+   versions seen by its plan. It is stale if any of its tables has been
+   written since, and it is dropped when a lookup finds it stale, that is
+   writes do not search the cache. A result whose tables changed while it
+   was computed is not inserted.
+
+   The cache holds up to qpipe-rcache-mb MB (0 disables it) and entries of
+   up to qpipe-rcache-entry-mb MB. When full, the least recently used
+   entries are evicted. An entry that is replayed is reference counted, so
+   an eviction does not free it under the RSCAN that reads it. The map,
+   the LRU list and the reference counts are the plan_cache_t's.
+*/
+
+#ifndef __QPIPE_RESULT_CACHE_H
+#define __QPIPE_RESULT_CACHE_H
+
+#include "qpipe/core/tuple.h"
+#include "qpipe/core/tuple_fifo.h"
+#include "qpipe/core/packet.h"
+#include "qpipe/core/plan_cache.h"
+
+#include <string>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/* exported datatypes */
+
+
+/**
+ *  @brief The cached result of a plan. The pages are read-only once the
+ *  entry is in the cache.
+ */
+struct result_cache_entry_t : public plan_cache_entry_t
+{
+    size_t    _tuple_size;
+    page_list _pages;
+
+    result_cache_entry_t()
+        : _tuple_size(0)
+    {
+    }
+
+    virtual ~result_cache_entry_t();
+};
+
+
+
+/**
+ *  @brief The result cache. All its methods are static and thread-safe.
+ */
+class result_cache_t
+{
+    static plan_cache_t _cache;
+
+public:
+
+    // Reads qpipe-rcache-mb and qpipe-rcache-entry-mb
+    static void init();
+
+    static bool is_enabled() { return (_cache.is_enabled()); }
+    static size_t max_entry_bytes() { return (_cache.max_entry_bytes()); }
+
+    /**
+     *  @brief Appends the signature of the plan to key and the versions
+     *  of the tables it reads to versions. Also used by the build cache.
+     *
+     *  @return false if the plan is not cacheable.
+     */
+    static bool signature(query_plan const* plan, std::string& key,
+                          plan_cache_entry_t::version_list_t& versions);
+
+    // Whether the results of the plan can be cached
+    static bool is_cacheable(query_plan const* plan);
+
+    /**
+     *  @brief Looks up a valid result for the plan. On a hit the entry
+     *  is pinned and the caller must release() it when done reading
+     *  its pages.
+     */
+    static result_cache_entry_t* lookup(query_plan const* plan);
+    static void release(result_cache_entry_t* e) { _cache.release(e); }
+
+    /**
+     *  @brief Inserts the result of the plan. The cache takes over the
+     *  pages, it frees them if the result is not kept.
+     */
+    static void insert(query_plan const* plan, size_t tuple_size,
+                       page_list& pages, size_t bytes);
+
+    static void print_stats() { _cache.print_stats(); }
+    static void reset_stats() { _cache.reset_stats(); }
+};
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+#endif
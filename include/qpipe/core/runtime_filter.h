@@ -0,0 +1,206 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   runtime_filter.h
+ *
+ *  @brief:  Bloom filters that a hash join publishes on the keys of its
+ *           build side, to filter the output of its probe side
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   In the star joins of SSB and TPC-H the probe side of each hash join is
+   a scan of the fact table, most of whose tuples find no match once the
+   dimensions are filtered. They are still projected, copied through the
+   FIFO and probed.
+
+   A hash join (without outer join) creates a runtime filter and attaches
+   it to its probe-side packet before dispatching it. Once the build side
+   is complete, it publishes a blocked Bloom filter on the keys of the
+   build side. From then on the stage that produces the probe side (e.g.
+   a TSCAN or a SIEVE) drops, in stage_adaptor_t::output_page(), every
+   projected tuple whose key is not in the filter, before it reaches the
+   output FIFO. The tuples produced before the build completes are not
+   filtered. A pipelined hash join publishes a filter for each side, when
+   the other side reaches EOF.
+
+   The filter is split in blocks of 512 bits (a cache line). A key sets
+   RF_PROBES bits of a single block, chosen by its FNV hash, the same hash
+   as the hash joins use. With qpipe-rfilter-bits bits per key the false
+   positive rate is about 1% at 10 bits.
+
+   A filter that drops less than 1/RF_USELESS_RATIO of the first
+   RF_SAMPLE tuples it checks is not applied any more. A filter that
+   would be larger than RF_MAX_BYTES is never published.
+
+   The filter is shared by the join and the probe-side packet and freed
+   by the last one to release it, since either may finish first. Its
+   counters are added to the global ones when it is freed.
+
+   Packets with a runtime filter are not recorded by the result cache,
+   since their output depends on the other side of the join.
+*/
+
+#ifndef __QPIPE_RUNTIME_FILTER_H
+#define __QPIPE_RUNTIME_FILTER_H
+
+#include "util.h"
+#include "util/fnv.h"
+
+#include <vector>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/* exported datatypes */
+
+
+class runtime_filter_t
+{
+public:
+
+    // Bits set per key, in the block of the key
+    static const int    RF_PROBES = 4;
+
+    // The filter is given up if it drops less than 1/RF_USELESS_RATIO
+    // of the first RF_SAMPLE tuples
+    static const size_t RF_SAMPLE = 65536;
+    static const size_t RF_USELESS_RATIO = 10;
+
+    static const size_t RF_MAX_BYTES = 64*1024*1024;
+
+private:
+
+    // 512-bit blocks
+    static const size_t RF_BLOCK_WORDS = 8;
+
+    // where the key is in the filtered tuples
+    size_t _key_offset;
+    size_t _key_size;
+
+    array_guard_t<uint64_t> _bits;
+    size_t _block_mask;
+    size_t _keys;
+
+    volatile bool     _ready;
+    volatile uint32_t _refs;
+
+    // Written only by the thread that applies the filter
+    bool   _useless;
+    size_t _checked;
+    size_t _dropped;
+    size_t _dropped_bytes;
+
+    // global stats
+    static pthread_mutex_t _stats_lock;
+    static bool     _enabled;
+    static int      _bits_per_key;
+    static uint64_t _g_filters;
+    static uint64_t _g_published;
+    static uint64_t _g_useless;
+    static uint64_t _g_checked;
+    static uint64_t _g_dropped;
+    static uint64_t _g_dropped_bytes;
+
+    ~runtime_filter_t();
+
+    uint64_t const* _block(const uint32_t hash) const {
+        return (&_bits[(hash & _block_mask) * RF_BLOCK_WORDS]);
+    }
+
+    // The bits of a key within its block, from the high bits of the
+    // hash spread over 64 bits
+    static inline uint64_t _spread(const uint32_t hash) {
+        return ((uint64_t)hash * 0x9E3779B97F4A7C15ULL);
+    }
+
+public:
+
+    // A filter on the key at key_offset of the tuples, not published
+    // yet. The caller holds a reference to it.
+    runtime_filter_t(const size_t key_offset, const size_t key_size);
+
+    // Reads qpipe-rfilter and qpipe-rfilter-bits
+    static void init();
+    static bool is_enabled() { return (_enabled); }
+
+    void add_ref() { atomic_inc_32(&_refs); }
+    void release();
+
+    size_t key_offset() const { return (_key_offset); }
+    size_t key_size() const { return (_key_size); }
+
+    static uint32_t hash(const char* key, const size_t key_size) {
+        return (fnv_hash(key, key_size));
+    }
+
+    /**
+     *  @brief Builds the filter out of the hashes of the keys of the
+     *  build side and makes it visible to the probe side. Called once,
+     *  by the join.
+     */
+    void publish(const std::vector<uint32_t>& hashes);
+
+    // Whether the probe side should apply the filter
+    bool is_ready() const {
+        if (!_ready) return (false);
+        membar_consumer();
+        return (!_useless);
+    }
+
+    // Whether the key of the tuple may be in the build side
+    bool may_contain(const char* tuple) const {
+        uint32_t h = hash(tuple + _key_offset, _key_size);
+        uint64_t const* block = _block(h);
+        uint64_t s = _spread(h);
+        for (int i=0; i<RF_PROBES; i++) {
+            uint32_t bit = (uint32_t)(s >> (64 - 9*(i+1))) & 511;
+            if (!(block[bit >> 6] & (1ULL << (bit & 63))))
+                return (false);
+        }
+        return (true);
+    }
+
+    // Accounts the tuples checked and dropped by a call to output_page()
+    void update(const size_t checked, const size_t dropped,
+                const size_t tuple_size);
+
+    static void print_stats();
+    static void reset_stats();
+
+}; // EOF: runtime_filter_t
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+template<>
+inline void guard<qpipe::runtime_filter_t>::action(qpipe::runtime_filter_t* ptr) {
+    ptr->release();
+}
+
+
+#endif
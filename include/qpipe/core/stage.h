@@ -63,6 +63,17 @@ public:
         virtual void output(page* p)=0;
 	virtual void stop_accepting_packets()=0;	
         virtual bool check_for_cancellation()=0;
+
+        /**
+         *  @brief For stages that read their input in circles, like
+         *  the CSCAN. Must be called before each pass over the
+         *  input. Packets attach at any point of a pass and detach
+         *  once they have received one whole pass.
+         *
+         *  @return false if no packet needs more tuples. The stage
+         *  then accepts no more packets and it should return.
+         */
+        virtual bool next_cycle()=0;
         
         /**
          *  @brief Write a tuple to each waiting output buffer in a
@@ -100,8 +111,10 @@ public:
          * concern themselves with this).
          */
         void flush() {
-            if(!_page->empty())
+            if(!_page->empty()) {
                 output(_page);
+                _page->clear();
+            }
         }
         
     };
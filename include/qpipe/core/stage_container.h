@@ -146,6 +146,11 @@ protected:
     bool _still_accepting_packets;
     bool _contains_late_merger;
 
+    // Set by the first next_cycle() of a circular stage. _cycle_start
+    // is the value of _next_tuple when the current pass started.
+    bool         _circular;
+    unsigned int _cycle_start;
+
     // Group many output() tuples into a page before "sending"
     // entire page to packet list
     guard<page> out_page;
@@ -154,6 +159,14 @@ protected:
     // protect this with _stage_adaptor_mutex.
     volatile bool _cancelled;
 
+    // Copy of the output of the primary packet, inserted to the
+    // result cache if the primary receives all of it. Only touched by
+    // the worker thread.
+    bool      _rc_recording;
+    size_t    _rc_tuple_size;
+    size_t    _rc_bytes;
+    page_list _rc_pages;
+
 	
 public:
 
@@ -165,6 +178,8 @@ public:
     ~stage_adaptor_t() {
 	// we should have deleted the primary packet
 	assert( _packet == NULL );
+	// we should have cached or dropped the recorded output
+	assert( _rc_pages.empty() );
 	// we should have either deleted or handed off ownership
 	// of the packet list
 	assert( _packet_list == NULL );
@@ -203,6 +218,9 @@ public:
     }
 
 
+    virtual bool next_cycle();
+
+
     stage_container_t::merge_t try_merge(packet_t* packet);
     void run_stage(stage_t* stage);
     
@@ -215,6 +233,10 @@ protected:
 private:
 
     void output_page(page* p);
+
+    bool rc_record(const tuple_t &tuple);
+    void rc_insert();
+    void rc_discard();
 };
 
 struct stage_factory_t {
@@ -277,6 +277,15 @@ private:
         return _free_count == 0;
     }
 
+
+    /**
+     *  @brief Returns the number of tuples that can still be added to
+     *  this page.
+     */
+    size_t free_count() const {
+        return _free_count;
+    }
+
     /**
      *  @brief Get a tuple_t to the tuple stored at the specified
      *  index.
@@ -391,6 +400,33 @@ private:
         // use tuple::assign() instead of a naked memcpy()
         allocate_tuple().assign(tuple);
     }
+
+
+
+    /**
+     *  @brief Get the first free tuple of this page without adding
+     *  it. The other free tuples follow it every tuple_size()
+     *  bytes. This is a pre-assembly strategy for many tuples at a
+     *  time: fill some of the free tuples in place and then add them
+     *  with commit().
+     *
+     *  @return The first free tuple. Valid only if the page is not
+     *  full.
+     */
+    tuple_t free_tuple() {
+        return tuple_t(&_data()[_end_offset], tuple_size());
+    }
+
+
+    /**
+     *  @brief Add the next 'count' free tuples to this page. The
+     *  caller should have filled them through free_tuple().
+     */
+    void commit(size_t count) {
+        assert(count <= _free_count);
+        _end_offset += count*tuple_size();
+        _free_count -= count;
+    }
     
 
     /**
@@ -40,6 +40,10 @@ int tuple_fifo_generate_id();
 
 typedef std::list<page*> page_list;
 
+/* Padding between the fields written by the producer and the ones
+   written by the consumer */
+static const size_t TUPLE_FIFO_CACHE_LINE = 64;
+
 /**
  *  @brief Thread-safe tuple buffer. This class allows one thread to
  *  safely pass tuples to another. The producer will fill a page of
@@ -48,6 +52,16 @@ typedef std::list<page*> page_list;
  *  This implementation currently uses an internal allocator to
  *  allocate a new page every time the current page is filled and
  *  handed to the consumer.
+ *
+ *  While in memory, the pages are handed over through two
+ *  single-producer/single-consumer rings: full pages go from the
+ *  producer to the consumer, consumed pages go back for reuse. Each
+ *  side only writes its own index of a ring, thus a page hand-off
+ *  takes no lock. A side that finds the ring full (or empty) spins
+ *  for a while and then parks on a futex, until the other side has
+ *  made room for (or produced) '_threshold' pages. The _lock is
+ *  taken only by the transitions to ON_DISK, DONE_WRITING and
+ *  TERMINATED, and by the disk I/O.
  */
 class tuple_fifo {
 
@@ -112,36 +126,29 @@ private:
     /* state */
     tuple_fifo_state_t _state;
 
-    /* page list management */
-    page_list _pages;
-    page_list _free_pages;
-    size_t _pages_in_fifo; /* number of entries in _pages */
-    size_t _pages_in_memory;
+    /* in-memory page rings, indexed by (counter & _ring_mask) */
+    page** _ring;          /* full pages, producer -> consumer */
+    page** _free_ring;     /* consumed pages, consumer -> producer */
+    size_t _ring_mask;
     size_t _memory_capacity;
     size_t _threshold;
 
-    /* page file management */
+    /* page file management (ON_DISK states) */
     FILE*  _page_file;
-    size_t _next_page;
-    size_t _file_head_page;
+    volatile size_t _pages_on_disk; /* written by the producer */
+    size_t _disk_next_page;         /* next to read, by the consumer */
     
     /* useful fields to store */
     size_t _tuple_size;
     size_t _page_size;
 
-    /* stats (don't affect correctness) */
-    size_t _num_inserted;
-    size_t _num_removed;
-    size_t _num_waits_on_insert;
-    size_t _num_waits_on_remove;
-
     /* read and write page management */
     char*  _read_end;
     guard<page> _read_page;
     page::iterator _read_iterator;
     guard<page> _write_page;
 
-    /* synch vars */
+    /* synch vars, for the state transitions and the disk I/O */
     pthread_mutex_t _lock;
     pthread_cond_t _reader_notify;
     pthread_cond_t _writer_notify;
@@ -149,6 +156,26 @@ private:
     /* debug vars */
     pthread_t _reader_tid;
     pthread_t _writer_tid;
+
+    /* Written by the producer. The two sides write to separate cache
+       lines, so that a hand-off does not bounce both. */
+    char _producer_pad[TUPLE_FIFO_CACHE_LINE];
+    volatile size_t _ring_tail;
+    volatile size_t _free_head;
+    volatile size_t _writer_parked;  /* free slots awaited, 0 if running */
+    volatile uint32_t _reader_seq;   /* futex the consumer parks on */
+    size_t _num_inserted;
+    size_t _num_waits_on_insert;
+
+    /* Written by the consumer */
+    char _consumer_pad[TUPLE_FIFO_CACHE_LINE];
+    volatile size_t _ring_head;
+    volatile size_t _free_tail;
+    volatile size_t _reader_parked;  /* pages awaited, 0 if running */
+    volatile uint32_t _writer_seq;   /* futex the producer parks on */
+    size_t _num_removed;
+    size_t _num_waits_on_remove;
+    char _end_pad[TUPLE_FIFO_CACHE_LINE];
     
 public:
 
@@ -176,23 +203,33 @@ public:
                size_t threshold=64,
                size_t page_size=get_default_page_size())
         : _fifo_id(tuple_fifo_generate_id()),
-          _pages_in_fifo(0),
-          _pages_in_memory(0),
+          _ring(NULL),
+          _free_ring(NULL),
+          _ring_mask(0),
           _memory_capacity(capacity),
           _threshold(threshold),
-          _next_page(0),
-          _file_head_page(0),
+          _page_file(NULL),
+          _pages_on_disk(0),
+          _disk_next_page(0),
           _tuple_size(tuple_size),
           _page_size(page_size),
-          _num_inserted(0),
-          _num_removed(0),
-          _num_waits_on_insert(0),
-          _num_waits_on_remove(0),
           _lock(thread_mutex_create()),
           _reader_notify(thread_cond_create()),
           _writer_notify(thread_cond_create()),
 	  _reader_tid(0),
-          _writer_tid(0)
+          _writer_tid(0),
+          _ring_tail(0),
+          _free_head(0),
+          _writer_parked(0),
+          _reader_seq(0),
+          _num_inserted(0),
+          _num_waits_on_insert(0),
+          _ring_head(0),
+          _free_tail(0),
+          _reader_parked(0),
+          _writer_seq(0),
+          _num_removed(0),
+          _num_waits_on_remove(0)
     {
         init();
     }
@@ -261,6 +298,53 @@ public:
         _num_inserted++;
         return _write_page->allocate_tuple();
     };
+
+
+
+    /**
+     *  @brief Only the producer may call this method. Reserve space
+     *  for up to 'count' tuples in this buffer, which are added only
+     *  when the producer invokes commit(). If the buffer is full,
+     *  wait for the consumer like allocate() does.
+     *
+     *  This is the batch version of allocate(). The tuples are
+     *  consecutive in the current page, thus the producer pays for
+     *  the checks of the buffer once per batch instead of once per
+     *  tuple.
+     *
+     *  @param count The number of tuples the caller would like to
+     *  write. Must be at least 1.
+     *
+     *  @param first On return, points to the first reserved
+     *  tuple. The others follow it every tuple_size() bytes.
+     *
+     *  @return The number of reserved tuples, between 1 and
+     *  'count'. The caller may fill fewer. It must commit() them
+     *  before any other operation on this buffer.
+     *
+     *  @throw Can throw TerminatedBufferException if the consumer has
+     *  terminated the buffer.
+     */
+    size_t reserve(size_t count, tuple_t &first) {
+        assert(count > 0);
+        ensure_write_ready();
+        first = _write_page->free_tuple();
+        size_t free_count = _write_page->free_count();
+        return (count < free_count)? count : free_count;
+    }
+
+
+    /**
+     *  @brief Only the producer may call this method. Add to this
+     *  buffer the first 'count' tuples of the last reserve().
+     */
+    void commit(size_t count) {
+        _write_page->commit(count);
+        _num_inserted += count;
+    }
+
+
+    void append_tuples(page::iterator begin, page::iterator end);
     
 
     /**
@@ -281,6 +365,43 @@ public:
     }
 
 
+
+    /**
+     *  @brief Only the consumer may call this method. Get the next
+     *  tuples of the buffer in one operation: the rest of the current
+     *  page, or a full page if the previous call consumed the
+     *  current one. If the buffer is empty, wait for the producer
+     *  like get_tuple() does.
+     *
+     *  @param begin On return, the first tuple of the span.
+     *
+     *  @param end On return, the end of the span.
+     *
+     *  @param max The maximum number of tuples to return, 0 for the
+     *  whole span.
+     *
+     *  @return The number of tuples in [begin, end). 0 if the buffer
+     *  has been closed and is empty. The tuples are valid until the
+     *  next read operation on this buffer.
+     *
+     *  @throw Can throw TerminatedBufferException if the producer has
+     *  terminated the buffer.
+     */
+    size_t get_tuples(page::iterator &begin, page::iterator &end, size_t max=0) {
+        if (!ensure_read_ready())
+            return 0;
+        size_t count = (_read_end - _read_iterator->data)/_tuple_size;
+        if (max && (count > max))
+            count = max;
+        begin = _read_iterator;
+        _read_iterator = page::iterator(_tuple_size,
+                                        _read_iterator->data + count*_tuple_size);
+        end = _read_iterator;
+        _num_removed += count;
+        return count;
+    }
+
+
     bool copy_page(page* dst, int timeout_ms=0);
 
 
@@ -340,22 +461,36 @@ public:
 private:
 
     size_t _available_in_memory_writes() {
-        assert(is_in_memory());
         return _memory_capacity - _available_in_memory_reads();
     }
 
     size_t _available_in_memory_reads() {
-        assert(is_in_memory());
-        return _pages_in_memory;
+        return _ring_tail - _ring_head;
     }
 
     size_t _available_fifo_reads() {
-        return _pages_in_fifo;
+        return _available_in_memory_reads() + (_pages_on_disk - _disk_next_page);
     }
 
-    void _termination_check() {
-        if(is_terminated())
+    /* Whether a parked side may run again */
+    bool _writer_ready(size_t slots) {
+        return (_available_in_memory_writes() >= slots) || is_terminated();
+    }
+
+    bool _reader_ready(size_t pages) {
+        return (_available_fifo_reads() >= pages)
+            || is_done_writing() || is_terminated();
+    }
+
+    void _termination_check(bool have_lock=false) {
+        if(is_terminated()) {
+            /* Let the terminating side leave its critical section
+               before we throw, since our caller may delete us. */
+            if (!have_lock) {
+                critical_section_t cs(_lock);
+            }
             THROW1(TerminatedBufferException, "Buffer closed unexpectedly");
+        }
     }
 
     void _set_read_page(page* p) {
@@ -364,18 +499,8 @@ private:
 	_read_end = _read_page->end()->data;
     }
 
-    page* _alloc_page() {
-        /* Allocate a new _write_page. */
-        if (_free_pages.empty())
-            /* Allocate using page::alloc. */
-            return page::alloc(tuple_size());
-
-        /* Allocate from free list. */
-        page* p = _free_pages.front();
-        _free_pages.pop_front();
-        p->clear();
-        return p;
-    }
+    page* _alloc_page();
+    void  _recycle_page(page* p);
 
     void init();
     void destroy();
@@ -383,6 +508,7 @@ private:
     /* These methods control access and waiting. */
     int  _get_read_page(int timeout);
     void _flush_write_page(bool done_writing);
+    void _flush_to_disk(bool done_writing);
 
 
     bool is_in_memory() {
@@ -407,6 +533,11 @@ private:
     
     bool wait_for_writer(int timeout);
     void ensure_writer_running();
+
+    bool _park(volatile size_t* parked, volatile uint32_t* seq,
+               pthread_cond_t &cond, size_t count, bool reader,
+               int timeout_ms);
+    void _unpark(volatile uint32_t* seq, pthread_cond_t &cond);
     
 };
 
@@ -39,6 +39,8 @@
 #include "qpipe/stages/sort.h"
 #include "qpipe/stages/sorted_in.h"
 #include "qpipe/stages/tscan.h"
+#include "qpipe/stages/cscan.h"
+#include "qpipe/stages/rscan.h"
 #include "qpipe/stages/echo.h"
 #include "qpipe/stages/sieve.h"
 #include "qpipe/stages/delay_writer.h"
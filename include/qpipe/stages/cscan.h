@@ -0,0 +1,130 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   cscan.h
+ *
+ *  @brief:  The QPipe circular (shared) table scan stage
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   OSP merges a TSCAN packet into a running scan of the same table. A
+   packet that merges late receives the rest of the scan and, once the
+   scan ends, its packet list is re-enqueued and a new scan from the
+   start of the table serves the tuples it missed. Every such rerun is
+   a new scan, in the xct of whichever late merger became the primary.
+
+   With qpipe-cscan=1 the dispatcher hands every TSCAN packet over to a
+   CSCAN packet. A CSCAN stage reads its table in circles, as in
+   cooperative scans: all the CSCAN packets of a table merge into the
+   running CSCAN, whatever their filters, and each one detaches once it
+   has received one whole pass starting where it attached (see
+   stage_adaptor_t::next_cycle()). The stage keeps looping as long as
+   packets are attached, thus concurrent queries keep the buffer pool
+   and disk traffic close to one scan of the table. Each attached
+   packet has its own filter, projection and output FIFO.
+
+   A pass runs in a read-only xct of the stage, committed at the end of
+   the pass, since the scan outlives the xcts of the queries it serves.
+   A query thus sees the tuples committed by the start of the passes it
+   reads, which is enough for the read-only TPC-H and SSB queries. The
+   table must not change size while it is scanned (see next_cycle()).
+
+   The result of a CSCAN packet is that of a TSCAN with the same plan,
+   thus the result cache treats them alike.
+*/
+
+#ifndef __QPIPE_CSCAN_H
+#define __QPIPE_CSCAN_H
+
+#include "qpipe/stages/tscan.h"
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/******************************************************************
+ * 
+ * @class: Packet for the circular scans
+ *
+ ******************************************************************/
+
+struct cscan_packet_t : public tscan_packet_t
+{
+    static const c_str PACKET_TYPE;
+
+    /**
+     *  @param: tscan
+     *  The TSCAN packet this packet replaces. We take over its output
+     *  buffer, its filter and its runtime filter, if any. The caller
+     *  deletes it.
+     */
+    cscan_packet_t(tscan_packet_t* tscan);
+
+}; // EOF: cscan_packet_t
+
+
+
+/******************************************************************
+ * 
+ * @class: Circular scan stage
+ *
+ ******************************************************************/
+
+class cscan_stage_t : public stage_t 
+{
+    static bool _enabled;
+
+    // stats
+    static volatile uint32_t _packets;
+    static volatile uint32_t _passes;
+
+public:
+
+    typedef cscan_packet_t stage_packet_t;
+    static const c_str DEFAULT_STAGE_NAME;
+
+    cscan_stage_t() { }
+    virtual ~cscan_stage_t() { }
+
+    // Reads qpipe-cscan
+    static void init();
+    static bool is_enabled() { return (_enabled); }
+
+    static void print_stats();
+    static void reset_stats();
+
+protected:
+    
+    virtual void process_packet();
+
+    friend struct cscan_packet_t;
+
+}; // EOF: cscan_stage_t
+
+
+EXIT_NAMESPACE(qpipe);
+
+#endif
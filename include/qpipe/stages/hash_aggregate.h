@@ -26,6 +26,9 @@
 
 #include "qpipe/core.h"
 #include "util/resource_declare.h"
+#include "util/hashtable.h"
+
+#include <vector>
 
 using namespace qpipe;
 
@@ -38,20 +41,31 @@ struct hash_aggregate_packet_t : public packet_t {
     guard<key_extractor_t> _extractor;
     guard<key_compare_t> _compare;
 
+    // The expected number of groups, used to size the hash table. The
+    // table grows if there are more (0 = unknown).
+    size_t _groups_hint;
+
+    // The number of threads that aggregate the input. 0 uses
+    // qpipe-agg-workers, 1 aggregates in the stage worker only.
+    int _workers;
+
     hash_aggregate_packet_t(const c_str    &packet_id,
                                tuple_fifo* out_buffer,
                                tuple_filter_t* out_filter,
                                packet_t* input,
                                tuple_aggregate_t *aggregate,
                                key_extractor_t* extractor,
-                               key_compare_t* compare)
+                               key_compare_t* compare,
+                               size_t groups_hint=0,
+                               int workers=0)
         : packet_t(packet_id, PACKET_TYPE, out_buffer, out_filter,
                    create_plan(out_filter, aggregate, extractor, input->plan()),
                    true, /* merging allowed */
                    true  /* unreserve worker on completion */
                    ),
           _input(input), _input_buffer(input->output_buffer()),
-          _aggregate(aggregate), _extractor(extractor), _compare(compare)
+          _aggregate(aggregate), _extractor(extractor), _compare(compare),
+          _groups_hint(groups_hint), _workers(workers)
     {
     }
 
@@ -75,20 +89,129 @@ struct hash_aggregate_packet_t : public packet_t {
 
 
 
+/**
+ *  @brief Hash aggregation. The aggregate tuples (key and aggregate
+ *  state) are allocated inline in pages, and an open-addressing
+ *  hashtable over them finds the group of each input tuple.
+ *
+ *  When the aggregate pages reach their quota, the groups already in
+ *  memory keep aggregating, while the input tuples of new groups are
+ *  spilled to one of SPILL_PARTITIONS temp files, by a hash of their
+ *  key. After the input ends the groups in memory are output and each
+ *  spilled partition is aggregated the same way, with a different
+ *  hash per level of spilling.
+ *
+ *  With more than one worker (the packet's _workers or
+ *  qpipe-agg-workers) the stage thread only reads the input and
+ *  routes each tuple by a hash of its key to one of the worker
+ *  threads. Each worker aggregates its groups in its own table, with
+ *  its own copy of the functor and its share of the page quota, and
+ *  spills to its own partitions. The groups of the workers are
+ *  disjoint, so the stage thread outputs them as they are and then
+ *  aggregates the spilled partitions of each worker.
+ */
 class hash_aggregate_stage_t : public stage_t {
 
+    /* Helper classes used by the hashtable data structure. All of
+       these are very short, so give the compiler the option of
+       inlining. */
+
+    struct extractkey_t {
+        key_extractor_t *_extract;
+
+        extractkey_t(key_extractor_t* extract)
+            : _extract(extract)
+        {
+        }
+
+        const char* const operator()(const char* value) const {
+            return _extract->extract_key(value);
+        }
+    };
+
+
+    /* Can be used for both EqualKey and EqualData template
+       parameter. */
+    struct equalbytes_t {
+
+        size_t _len;
+        equalbytes_t(size_t len)
+            : _len(len)
+        {
+        }
+
+        bool operator()(const char *k1, const char *k2) const {
+            return !memcmp(k1, k2, _len);
+        }
+    };
+
+
+    struct hashfcn_t {
+
+        size_t _len;
+        hashfcn_t(size_t len)
+            : _len(len)
+        {
+        }
+
+        size_t operator()(const char *key) const {
+            return fnv_hash(key, _len);
+        }
+    };
+
+    typedef hashtable<char *,
+                      const char *,
+                      extractkey_t,
+                      equalbytes_t,
+                      equalbytes_t,
+                      hashfcn_t> tuple_hash_t;
+
+
+    /* A partition of the input tuples whose groups did not fit in
+       memory */
+    struct spill_t {
+        FILE* _file;
+        c_str _file_name;
+        qpipe::page* _page;
+        size_t _count;
+
+        spill_t()
+            : _file(NULL), _page(NULL), _count(0)
+        {
+        }
+    };
+
+    typedef std::vector<spill_t> spill_list_t;
+
+    /* A thread of the parallel aggregation */
+    class worker_t;
+
+
     page_trash_stack _page_list;
     size_t _page_count;
     tuple_aggregate_t* _aggregate;
+    key_extractor_t* _tup_key;
     qpipe::page* _agg_page;
     size_t _tuple_align;
+    size_t _in_size;
 public:
     static const c_str DEFAULT_STAGE_NAME;
     typedef hash_aggregate_packet_t stage_packet_t;
 
 protected:
     virtual void process_packet();
-    int alloc_agg(tuple_t &agg, const char* key);
+    int alloc_agg(tuple_t &agg, const char* key, bool may_spill);
+
+private:
+    template<class Input>
+    void aggregate_run(Input &input, int level, size_t groups_hint, tuple_t &out);
+    void aggregate_spills(spill_list_t &spills, int level, tuple_t &out);
+    void aggregate_parallel(hash_aggregate_packet_t* packet, int workers,
+                            tuple_t &out);
+
+    static void spill_tuple(spill_list_t &spills, const tuple_t &in,
+                            const char* key, size_t key_size,
+                            size_t in_size, int level);
 };
 
 
@@ -34,10 +34,6 @@
 #include "qpipe/core.h"
 #include "util/hashtable.h"
 
-#if defined(linux) || defined(__linux)
-#include <ext/hash_set>
-#endif
-
 #include <string>
 
 using std::string;
@@ -161,62 +157,13 @@ private:
 
     /* datatypes */
 
-    /* Helper classes used by the hashtable data structure. All of
-       these are very short, so give the compiler the option of
-       inlining. */
-    
-    struct extractkey_t {
-        
-        tuple_join_t *_join;
-        bool _right;
-
-        extractkey_t(tuple_join_t *join, bool right)
-            : _join(join)
-            , _right(right)
-        {
-        }
-        
-        const char* const operator()(const char* value) const {
-            return _right ? _join->right_key_bytes(value) : _join->left_key_bytes(value);
-        }
-    };
-
-
-    /* Can be used for both EqualKey and EqualData template
-       parameter. */
-    struct equalbytes_t {
-        
-        size_t _len;
-        equalbytes_t(size_t len)
-            : _len(len)
-        {
-        }
-
-        bool operator()(const char *k1, const char *k2) const {
-            return !memcmp(k1, k2, _len);
-        }
-    };
-
-    
-    struct hashfcn_t {
-        
-        size_t _len;
-        hashfcn_t(size_t len)
-            : _len(len)
-        {
-        }
-        
-        size_t operator()(const char *key) const {
-            return fnv_hash(key, _len);
-        }
-    };    
-
-    typedef hashtable<char *,
-                      const char *,
-                      extractkey_t,
-                      equalbytes_t,
-                      equalbytes_t,
-                      hashfcn_t> tuple_hash_t;
+    /* Helper classes used by the hashtable data structure. They
+       keep only offsets and sizes, so that a table can outlive its
+       join in the build cache. */
+    typedef build_key_t   extractkey_t;
+    typedef build_equal_t equalbytes_t;
+    typedef build_hash_t  hashfcn_t;
+    typedef build_table_t tuple_hash_t;
     
 
     /* These are our bookkeeping data structures. */
@@ -256,7 +203,8 @@ private:
             // open a new file for the left side partition
             it->file = create_tmp_file(it->file_name2, "hash-join-left");
             
-            // resize the page to match left-side tuples
+            // replace the page with one that matches left-side tuples
+            it->_page->free();
             it->_page = page::alloc(_left_tuple_size);
         }
     };
@@ -277,6 +225,23 @@ private:
 
     template<class Action>
     void close_file(partition_list_t::iterator it, Action a);
+
+    void probe_tuple(tuple_hash_t &table, const char* left_key,
+                     tuple_t &left, tuple_t &out, bool outer_join);
+
+    void join_file_partition(partition_t &p, tuple_hash_t &table,
+                             tuple_t &out, bool outer_join, bool distinct,
+                             int level=0);
+
+    void split_file(const c_str &file_name, bool right,
+                    partition_list_t &subs, int level, bool outer_join);
+
+    bool build_table(hash_join_packet_t* packet, runtime_filter_t* rfilter,
+                     guard<tuple_hash_t> &table);
+
+    bool has_file_partitions();
+
+    void publish_filter(runtime_filter_t* rfilter, tuple_hash_t* table);
     
    
 
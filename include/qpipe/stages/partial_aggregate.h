@@ -38,20 +38,26 @@ struct partial_aggregate_packet_t : public packet_t {
     guard<key_extractor_t> _extractor;
     guard<key_compare_t> _compare;
 
+    // The number of threads that aggregate the input. 0 uses
+    // qpipe-agg-workers, 1 aggregates in the stage worker only.
+    int _workers;
+
     partial_aggregate_packet_t(const c_str    &packet_id,
                                tuple_fifo* out_buffer,
                                tuple_filter_t* out_filter,
                                packet_t* input,
                                tuple_aggregate_t *aggregate,
                                key_extractor_t* extractor,
-                               key_compare_t* compare)
+                               key_compare_t* compare,
+                               int workers=0)
         : packet_t(packet_id, PACKET_TYPE, out_buffer, out_filter,
                    create_plan(out_filter, aggregate, extractor, input->plan()),
                    true, /* merging allowed */
                    true  /* unreserve worker on completion */
                    ),
           _input(input), _input_buffer(input->output_buffer()),
-          _aggregate(aggregate), _extractor(extractor), _compare(compare)
+          _aggregate(aggregate), _extractor(extractor), _compare(compare),
+          _workers(workers)
     {
     }
 
@@ -75,9 +81,26 @@ struct partial_aggregate_packet_t : public packet_t {
 
 
 
+/**
+ *  @brief Sort-based aggregation, whose output is ordered by the
+ *  group key.
+ *
+ *  With more than one worker (the packet's _workers or
+ *  qpipe-agg-workers) the stage thread only reads the input pages and
+ *  hands them to threads that each pre-aggregate into their own
+ *  run. If the aggregate can_merge() the pages are dealt round-robin
+ *  and the partial aggregates of a group are merged at the end.
+ *  Otherwise each tuple is routed by a hash of its key, thus each
+ *  group is aggregated by one thread only and the functor is used
+ *  unchanged. Either way the runs are combined into one ordered run
+ *  at the end.
+ */
 class partial_aggregate_stage_t : public stage_t {
+public:
     typedef std::set<hint_tuple_pair_t, tuple_less_t> tuple_set_t;
 
+private:
+
     page_trash_stack _page_list;
     size_t _page_count;
     tuple_aggregate_t* _aggregate;
@@ -90,6 +113,10 @@ public:
 protected:
     virtual void process_packet();
     int alloc_agg(hint_tuple_pair_t &agg, const char* key);
+
+private:
+    void aggregate_serial(partial_aggregate_packet_t* packet);
+    void aggregate_parallel(partial_aggregate_packet_t* packet, int workers);
 };
 
 
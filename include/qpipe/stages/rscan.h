@@ -0,0 +1,126 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   rscan.h
+ *
+ *  @brief:  The QPipe result scan stage, which replays a result of the
+ *           result cache
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#ifndef __QPIPE_RSCAN_H
+#define __QPIPE_RSCAN_H
+
+#include "qpipe/core.h"
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/******************************************************************
+ * 
+ * @class: Packet for the result scans
+ *
+ ******************************************************************/
+
+struct rscan_packet_t : public packet_t 
+{
+    static const c_str PACKET_TYPE;
+
+    result_cache_entry_t* _entry;
+
+    /**
+     *  @param: packet_id 
+     *  The ID of this packet.
+     *
+     *  @param: output_buffer 
+     *  The buffer where this packet should send its data. It is the
+     *  output buffer of the packet that the result scan replaces.
+     *
+     *  @param: entry
+     *  The cached result, pinned by result_cache_t::lookup(). The packet
+     *  releases it when it is destroyed.
+     *
+     *  The cached tuples are already filtered and projected, thus the
+     *  packet uses a trivial filter. Result scans are not merged, two
+     *  of them read the same pages without sharing a worker.
+     */
+    rscan_packet_t(const c_str&          packet_id,
+                   tuple_fifo*           output_buffer,
+                   result_cache_entry_t* entry)
+        : packet_t(packet_id, PACKET_TYPE, output_buffer,
+                   new trivial_filter_t(entry->_tuple_size),
+                   create_plan(entry),
+                   false, /* merging not allowed */
+                   true   /* unreserve worker on completion */
+                   ),
+          _entry(entry)
+    {
+        assert (output_buffer->tuple_size() == entry->_tuple_size);
+    }
+
+    virtual ~rscan_packet_t() {
+        result_cache_t::release(_entry);
+    }
+
+    static query_plan* create_plan(result_cache_entry_t* entry) {
+        c_str action("%s:%s", PACKET_TYPE.data(), entry->_key.c_str());
+        return new query_plan(action, c_str::EMPTY_STRING, NULL, 0);
+    }
+
+    virtual void declare_worker_needs(resource_declare_t* declare) {
+        declare->declare(_packet_type, 1);
+        /* no inputs */
+    }
+
+}; // EOF: rscan_packet_t
+
+
+
+/******************************************************************
+ * 
+ * @class: Result scan stage
+ *
+ ******************************************************************/
+
+class rscan_stage_t : public stage_t 
+{
+public:
+
+    typedef rscan_packet_t stage_packet_t;
+    static const c_str DEFAULT_STAGE_NAME;
+
+    rscan_stage_t() { }
+    virtual ~rscan_stage_t() { }
+
+protected:
+    
+    virtual void process_packet();
+
+}; // EOF: rscan_stage_t
+
+
+EXIT_NAMESPACE(qpipe);
+
+#endif
@@ -94,6 +94,18 @@ struct tscan_packet_t : public packet_t
     static query_plan* create_plan(tuple_filter_t* filter, table_desc_t* file);
     void declare_worker_needs(resource_declare_t* declare);
 
+protected:
+
+    // For the packets of the other scans of a table (see cscan.h)
+    tscan_packet_t(const c_str&    packet_id,
+                   const c_str&    packet_type,
+		   tuple_fifo*     output_buffer,
+		   tuple_filter_t* output_filter,
+		   ss_m*           db,
+                   table_desc_t*   table,
+                   xct_t*          pxct,
+                   lock_mode_t     lm);
+
 }; // EOF: tscan_packet_t
 
 
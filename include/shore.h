@@ -46,11 +46,17 @@
 #include "sm/shore/shore_msg.h"
 #include "sm/shore/shore_row.h"
 #include "sm/shore/shore_row_cache.h"
+#include "sm/shore/shore_rec_cache.h"
+#include "sm/shore/shore_log_profile.h"
 #include "sm/shore/shore_table.h"
 #include "sm/shore/shore_asc_sort_buf.h"
 #include "sm/shore/shore_desc_sort_buf.h"
 #include "sm/shore/shore_helper_loader.h"
+#include "sm/shore/shore_bulk_loader.h"
+#include "sm/shore/shore_load_cache.h"
+#include "sm/shore/shore_warmup.h"
 #include "sm/shore/shore_table_man.h"
+#include "sm/shore/shore_fixed_row.h"
 #include "sm/shore/shore_env.h"
 
 #include "sm/shore/shore_client.h"
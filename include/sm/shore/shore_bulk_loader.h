@@ -0,0 +1,218 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_bulk_loader.h
+ *
+ *  @brief:  Bulk-load mode, where the indexes are built from sorted runs
+ *           at the end of the load
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   Normally the loaders call add_tuple() for every generated row, which
+   inserts the record and then each index entry, one key at a time and fully
+   logged. The inserts land on random leaves, so most of the load time goes
+   to B-tree traversals, page splits and log volume.
+
+   With db-bulkload=1 the tables filled by the parallel loaders are switched
+   to bulk mode before their first row is inserted:
+
+   1. The heap files are set to insert-only (t_insert_file), for which
+      Shore-MT logs only the page allocations and not the records.
+
+   2. add_tuple() only appends the record. The (key,rid) entries of each
+      index are appended to an in-memory run owned by the loader thread.
+      When the run grows beyond db-bulkload-runsize MB it is sorted and
+      spilled to a file in db-bulkload-dir. Spills happen only between two
+      loader xcts (mark_runs()), so that the entries of an aborted and
+      retried xct can be dropped (rollback_runs()).
+
+   3. At the end (finish()), db-loaders threads build the indexes in
+      parallel. The runs of each index are k-way merged. A regular index is
+      built bottom-up by ss_m::bulkld_index() from the merged, sorted stream;
+      a partitioned index gets one merged stream per partition. The MRBT
+      indexes do not support bulkld_index(), thus the merged stream is
+      inserted in key order, in large xcts, so that the inserts go to the
+      right-most leaf instead of random ones.
+
+   4. The heap files are set back to t_regular and the buffer pool is
+      forced, so that the loaded data become durable.
+
+   The sort order of the runs follows the key description of each field
+   (see field_desc_t::_set_keydesc()), which is the order of the B-tree.
+*/
+
+#ifndef __SHORE_BULK_LOADER_H
+#define __SHORE_BULK_LOADER_H
+
+#include <stdio.h>
+
+#include "sm/shore/shore_table.h"
+
+
+ENTER_NAMESPACE(shore);
+
+
+// Defaults of the bulk-load knobs
+const int BULK_RUN_MB     = 64;     // db-bulkload-runsize
+const int BULK_MR_BATCH   = 10000;  // entries per xct when rebuilding a MRBT
+const int BULK_READ_CNT   = 4096;   // entries read at a time from a spilled run
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: bulk_loader_t
+ *
+ * @brief: Collects the index entries of one table into per-thread
+ *         sorted runs and builds the indexes out of them
+ *
+ * --------------------------------------------------------------- */
+
+class bulk_loader_t
+{
+public:
+
+    // One part of a key, compared according to its key description
+    struct kpart_t {
+        sqltype_t _type;
+        uint_t    _off;
+        uint_t    _sz;
+    };
+
+    // Entry: [pnum (int)][key (keysz)][element (rid_t and payload)]
+    struct bulk_idx_t {
+        index_desc_t*        _pidx;
+        uint_t               _pos;       // position in the thread runs
+        uint_t               _keysz;
+        uint_t               _esz;
+        std::vector<kpart_t> _parts;
+        double               _build_secs;
+    };
+
+    // Compares two entries, first by partition then by key
+    struct entry_less {
+        const bulk_idx_t* _pbi;
+        entry_less(const bulk_idx_t* pbi) : _pbi(pbi) { }
+        bool operator()(const char* a, const char* b) const {
+            return (bulk_loader_t::cmp_entry(_pbi,a,b) < 0);
+        }
+    };
+
+    // The run of one index, owned by one loader thread
+    struct run_t {
+        bulk_idx_t* _pbi;
+        char*       _buf;
+        uint_t      _cnt;        // entries in buf
+        uint_t      _cap;        // capacity of buf in entries
+        uint_t      _mark;       // entries at the last mark
+        std::vector<std::string> _files; // sorted runs spilled to disk
+
+        run_t(bulk_idx_t* pbi);
+        ~run_t();
+
+        char* append();
+        void  sort(std::vector<char*>& sorted);
+        w_rc_t spill(const char* dir);
+    };
+
+    // The runs of all the indexes of the table, owned by one loader thread
+    struct thread_runs_t {
+        bulk_loader_t*      _owner;
+        std::vector<run_t*> _runs;
+        uint64_t            _rows;
+        uint64_t            _rows_mark;
+    };
+
+private:
+
+    table_man_t*              _pman;
+    std::vector<bulk_idx_t*>  _idxs;
+
+    mcs_lock                     _runs_lock;
+    std::vector<thread_runs_t*>  _truns;     // of all the loader threads
+
+    // stats
+    uint64_t _rows;
+    double   _load_secs;
+
+    thread_runs_t* _my_runs();
+    w_rc_t _bulkld_part(ss_m* db, bulk_idx_t* pbi, const int pnum,
+                        const stid_t& src);
+
+    // all the tables being bulk-loaded
+    static std::vector<bulk_loader_t*> _loaders;
+    static bool        _active;
+    static uint_t      _gen;         // bumped at every begin()
+    static stopwatch_t _timer;
+    static std::string _dir;
+    static uint_t      _run_bytes;
+
+public:
+
+    bulk_loader_t(table_man_t* pman);
+    ~bulk_loader_t();
+
+    table_man_t* manager() { return (_pman); }
+
+    // Called by table_man_t::add_tuple() after the record is appended
+    w_rc_t add_entries(table_row_t* ptuple);
+
+    // Merges the runs of the index and builds it
+    w_rc_t build_index(ss_m* db, bulk_idx_t* pbi);
+
+    static int cmp_entry(const bulk_idx_t* pbi, const char* a, const char* b);
+
+
+    /* --- driving the bulk load of the registered tables --- */
+
+    // Returns true if db-bulkload is set
+    static bool is_enabled();
+    static bool is_active() { return (_active); }
+
+    // Switches the given tables to bulk mode. Should be called after the
+    // tables are created and before their first row is inserted, since the
+    // indexes are built bottom-up and thus should be empty.
+    static w_rc_t begin(ss_m* db, const std::vector<table_man_t*>& tables);
+
+    // Builds all the indexes using the given number of threads,
+    // restores the tables to normal mode and reports the rows/s
+    static w_rc_t finish(ss_m* db, const int threads);
+
+    // Loader thread hooks, for a xct that may be retried:
+    //
+    //     bulk_loader_t::mark_runs();
+    // retry:
+    //     bulk_loader_t::rollback_runs();
+    //     begin_xct(); ...
+    static void mark_runs();
+    static void rollback_runs();
+
+}; // EOF: bulk_loader_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_BULK_LOADER_H */
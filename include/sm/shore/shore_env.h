@@ -175,6 +175,7 @@ const int    SHORE_NUM_DB_OPTIONS  = 5;
             TRACE( TRACE_TRX_FLOW, "Xct (%d) aborted [0x%x]\n", xct_id, e.err_num()); \
             w_rc_t e2 = _pssm->abort_xct();                             \
             if(e2.is_error()) TRACE( TRACE_ALWAYS, "Xct (%d) abort failed [0x%x]\n", xct_id, e2.err_num()); \
+            table_man_t::rec_cache_on_abort();                          \
             prequest->notify_client();                                  \
             _request_pool.destroy(prequest);				\
             if ((*&_measure)!=MST_MEASURE) return (e);                  \
@@ -193,7 +194,11 @@ const int    SHORE_NUM_DB_OPTIONS  = 5;
         _inc_##trxlid##_att();                                          \
         w_rc_t e = xct_##trximpl(xct_id, in);                           \
         if (!e.is_error()) {                                            \
-            if (isAsynchCommit()) e = _pssm->commit_xct(true);          \
+            if (isDurableNotify()) {                                    \
+                lsn_t xctLastLsn;                                       \
+                e = _pssm->commit_xct(true,&xctLastLsn);                \
+                prequest->set_last_lsn(xctLastLsn); }                   \
+            else if (isAsynchCommit()) e = _pssm->commit_xct(true);     \
             else e = _pssm->commit_xct(); }                             \
         if (e.is_error()) {                                             \
             if (e.err_num() != smlevel_0::eDEADLOCK)                    \
@@ -202,12 +207,14 @@ const int    SHORE_NUM_DB_OPTIONS  = 5;
             TRACE( TRACE_TRX_FLOW, "Xct (%d) aborted [0x%x]\n", xct_id, e.err_num()); \
             w_rc_t e2 = _pssm->abort_xct();                             \
             if(e2.is_error()) TRACE( TRACE_ALWAYS, "Xct (%d) abort failed [0x%x]\n", xct_id, e2.err_num()); \
+            table_man_t::rec_cache_on_abort();                          \
             prequest->notify_client();                                  \
             if ((*&_measure)!=MST_MEASURE) return (e);                  \
             _env_stats.inc_trx_att();                                   \
             return (e); }                                               \
         TRACE( TRACE_TRX_FLOW, "Xct (%d) completed\n", xct_id);         \
         prequest->notify_client();                                      \
+        if (isDurableNotify()) to_durable_notifier(prequest);           \
         if ((*&_measure)!=MST_MEASURE) return (RCOK);                   \
         _env_stats.inc_trx_com();                                       \
         return (RCOK); }
@@ -395,6 +402,7 @@ public:
 class base_worker_t;
 class trx_worker_t;
 class flusher_t;
+class durability_notifier_t;
 class ShoreEnv;
 
 
@@ -423,6 +431,21 @@ enum MeasurementState { MST_UNDEF   = 0x0,
 };
 
 
+
+/******************************************************************** 
+ *
+ * @enum  eCommitMode
+ *
+ * @brief Commit modes of the baseline (non-flusher) system
+ *
+ ********************************************************************/
+
+enum eCommitMode { CM_SYNCH          = 0x0,   // client waits for durability
+                   CM_ASYNCH         = 0x1,   // client acked, no durability signal
+                   CM_ASYNCH_DURABLE = 0x2    // client acked, durability notified
+};
+
+
 /******************************************************************** 
  * 
  *  ShoreEnv
@@ -572,6 +595,7 @@ public:
     virtual w_rc_t load_schema()=0; 
 
     virtual w_rc_t warmup()=0;
+    w_rc_t warmup_bufpool(); // parallel warmup of all the registered tables
     virtual w_rc_t loaddata()=0;
     virtual w_rc_t check_consistency()=0;
 
@@ -664,6 +688,14 @@ public:
     // Takes a checkpoint (forces dirty pages)
     int checkpoint();
 
+    // Snapshots of the loaded database, kept at db-snapshot-dir/<name>
+    int snapshot(const char* name);
+    int restore(const char* name);
+
+    // Called by the snapshot thread
+    int snapshot_impl(const char* name);
+    int restore_impl(const char* name);
+
     string sysname() { return (_sysname); }
 
     env_stats_t* get_env_stats() { return (&_env_stats); }
@@ -694,9 +726,19 @@ public:
 
 
     // Control whether asynchronous commit will be used
-    inline bool isAsynchCommit() const { return (_asynch_commit); }
+    inline bool isAsynchCommit() const { return (_commit_mode != CM_SYNCH); }
     void setAsynchCommit(const bool bAsynch);
 
+    // Asynchronous commit, with a separate notification when each xct
+    // becomes durable (see shore_flusher.h)
+    inline bool isDurableNotify() const { return (_commit_mode == CM_ASYNCH_DURABLE); }
+    eCommitMode getCommitMode() const { return (_commit_mode); }
+    void setCommitMode(const eCommitMode aMode);
+    void setDurableCallback(durable_cb_t cb, void* arg);
+
+    // Hands an acked xct to the durability notifier (also used by DORA)
+    void to_durable_notifier(base_request_t* ar);
+
 
     // SLI
 public:
@@ -726,12 +768,19 @@ protected:
     virtual int        _stop_flusher();
     void               to_base_flusher(Request* ar);
 
+    // DURABILITY NOTIFIER, for CM_ASYNCH_DURABLE
+    guard<durability_notifier_t> _durable_notifier;
+    durable_cb_t       _durable_cb;
+    void*              _durable_cb_arg;
+    int                _start_durable_notifier();
+    int                _stop_durable_notifier();
+
 
 protected:
    
     // returns 0 on success
     int _set_sys_params();
-    bool _asynch_commit;    
+    eCommitMode _commit_mode;    
 
 }; // EOF ShoreEnv
 
@@ -33,7 +33,9 @@
  *  If the type is SQL_TIME or strings, the data is stored in _data and
  *  the union contains the pointer to it.  The space of _data is
  *  allocated at setup time for fixed length fields and at set_value
- *  time for variable length fields.
+ *  time for variable length fields. If the value belongs to a table_row_t,
+ *  _data instead points to a slot of maxsize bytes in the contiguous
+ *  arena of the row, and it is never (re)allocated.
  *
  *  @author: Ippokratis Pandis, January 2008
  *
@@ -107,7 +109,9 @@ enum  sqltype_t
     SQL_TIME,       /* TIMESTAMP */      // Deprecated, use SQL_FLOAT instead
 
     SQL_NUMERIC,    /* NUMERIC */        /* Not tested */
-    SQL_SNUMERIC    /* SIGNED NUMERIC */ /* Not tested */
+    SQL_SNUMERIC,   /* SIGNED NUMERIC */ /* Not tested */
+
+    SQL_DATE        /* DATE */           // Days since 1970-01-01 (time_util.h)
 
 }; // EOF: sqltype_t
 
@@ -229,6 +233,7 @@ struct field_value_t
 	short        _smallint; /* SMALLINT */
 	char         _char;     /* CHAR */
 	int          _int;      /* INT */
+	int          _date;     /* DATE */
 	double       _float;    /* FLOAT */
 	long long    _long;     /* LONG */
 	timestamp_t* _time;     /* TIME or DATE */
@@ -236,6 +241,7 @@ struct field_value_t
     }   _value;   
 
     char* _data;      /* buffer for _value._time or _value._string */
+    bool     _ext_data;  /* _data points to the row arena, not owned */
     uint_t   _data_size; /* allocated size of the data buffer (watermark) */
     uint_t   _real_size; /* current size of the value */
     uint_t   _max_size;  /* maximum possible size of the buffer (shortcut) */
@@ -247,24 +253,24 @@ struct field_value_t
 
     field_value_t() 
         :  _pfield_desc(NULL), _null_flag(true), _data(NULL), 
-           _data_size(0), _real_size(0), _max_size(0)
+           _ext_data(false), _data_size(0), _real_size(0), _max_size(0)
     { 
     }
 
 
     field_value_t(field_desc_t* pfd) 
         : _pfield_desc(pfd), _null_flag(true), _data(NULL), 
-          _data_size(0), _real_size(0), _max_size(0)
+          _ext_data(false), _data_size(0), _real_size(0), _max_size(0)
     { 
         setup(pfd); /* It will assert if pfd = NULL */
     }
 
 
     ~field_value_t() {
-        if (_data) {
+        if (_data && !_ext_data) {
             free (_data);
-            _data = NULL;
         }
+        _data = NULL;
     }
 
 
@@ -272,8 +278,16 @@ struct field_value_t
     /* --- setup field value --- */
     /* ------------------------- */
 
-    /* setup according to the given field_desc_t */
-    void setup(field_desc_t* pfd);
+    /* setup according to the given field_desc_t, if extbuf is set the
+       data of the value are stored there (extbuf has fieldmaxsize() bytes) */
+    void setup(field_desc_t* pfd, char* extbuf = NULL);
+
+    /* true if the value needs a data buffer (time and strings) */
+    static inline bool needs_data(const sqltype_t type) {
+        return ((type == SQL_TIME) || (type == SQL_VARCHAR) ||
+                (type == SQL_FIXCHAR) || (type == SQL_NUMERIC) ||
+                (type == SQL_SNUMERIC));
+    }
 
     /* clear value */
     void reset();
@@ -343,6 +357,7 @@ struct field_value_t
     void   set_long_value(const long long data);
     void   set_decimal_value(const decimal data);
     void   set_time_value(const time_t data);
+    void   set_date_value(const int data);
     void   set_tstamp_value(const timestamp_t& data);
     void   set_char_value(const char data);
     void   set_fixed_string_value(const char* string, const uint len);
@@ -359,6 +374,7 @@ struct field_value_t
     long long    get_long_value() const;
     decimal      get_decimal_value() const;
     time_t       get_time_value() const;
+    int          get_date_value() const;
     timestamp_t& get_tstamp_value() const;
 
     bool load_value_from_file(ifstream& is, const char delim);
@@ -413,6 +429,7 @@ inline void field_desc_t::setup(sqltype_t type,
         _size = sizeof(char);
         break;
     case SQL_INT:
+    case SQL_DATE:
         _size = sizeof(int);
         break;
     case SQL_FLOAT:
@@ -468,6 +485,7 @@ inline const char* field_desc_t::_set_keydesc()
     case SQL_SMALLINT:  
     case SQL_CHAR:  
     case SQL_INT:       
+    case SQL_DATE:
         sprintf(_keydesc, "i%d", _size); break;
 
     case SQL_FLOAT:     
@@ -503,17 +521,26 @@ inline const char* field_desc_t::_set_keydesc()
  *
  *********************************************************************/
 
-inline void field_value_t::setup(field_desc_t* pfd)
+inline void field_value_t::setup(field_desc_t* pfd, char* extbuf)
 {
     assert (pfd);
 
     // if it is already setup for this field do nothing
-    if (_pfield_desc == pfd)
+    if ((_pfield_desc == pfd) && (!extbuf || (_data == extbuf)))
         return;
 
     _pfield_desc = pfd;
     uint_t sz = 0;
 
+    // use the buffer from the row arena, sized for the max value
+    if (extbuf) {
+        assert (needs_data(pfd->type()));
+        if (_data && !_ext_data) free (_data);
+        _data = extbuf;
+        _data_size = pfd->fieldmaxsize();
+        _ext_data = true;
+    }
+
     switch (_pfield_desc->type()) {
     case SQL_BIT:
         _max_size = sizeof(bool);
@@ -525,6 +552,7 @@ inline void field_value_t::setup(field_desc_t* pfd)
         _max_size = sizeof(char);
         break;
     case SQL_INT:
+    case SQL_DATE:
         _max_size = sizeof(int);
         break;
     case SQL_FLOAT:
@@ -538,9 +566,11 @@ inline void field_value_t::setup(field_desc_t* pfd)
         _data_size = sz;
         _real_size = sz; 
         _max_size = sz;
-        if (_data)
-            free (_data);
-        _data = (char*)malloc(sz);
+        if (!_ext_data) {
+            if (_data)
+                free (_data);
+            _data = (char*)malloc(sz);
+        }
         _value._time = (timestamp_t*)_data;
         break;    
     case SQL_VARCHAR:
@@ -604,6 +634,7 @@ inline void field_value_t::reset()
         _value._char = 0;
         break;
     case SQL_INT:
+    case SQL_DATE:
         _value._int = 0;
         break;
     case SQL_FLOAT:
@@ -617,7 +648,8 @@ inline void field_value_t::reset()
     case SQL_FIXCHAR:
     case SQL_NUMERIC:
     case SQL_SNUMERIC:
-        if (_data && _data_size) memset(_data, 0, _data_size);
+        // the row arena is cleared at once by table_row_t::reset()
+        if (_data && _data_size && !_ext_data) memset(_data, 0, _data_size);
     }
 }
 
@@ -646,6 +678,8 @@ inline void field_value_t::alloc_space(const uint_t len)
         return;
 
     // if not, release previously allocated space and allocate new
+    // (the arena slots are of max size, so it never gets here for them)
+    assert (!_ext_data);
     if (_data) { 
 	free(_data);
     }
@@ -680,6 +714,7 @@ inline void field_value_t::set_value(const void* data,
     case SQL_SMALLINT:
     case SQL_CHAR:
     case SQL_INT:
+    case SQL_DATE:
     case SQL_FLOAT:
     case SQL_LONG:
 	memcpy(&_value, data, _max_size); 
@@ -727,6 +762,7 @@ inline void field_value_t::set_min_value()
 	_value._char = MIN_SMALLINT;
 	break;
     case SQL_INT:
+    case SQL_DATE:
 	_value._int = MIN_INT;
 	break;
     case SQL_FLOAT:
@@ -765,6 +801,7 @@ inline void field_value_t::set_max_value()
 	_value._char = 'z';
 	break;
     case SQL_INT:
+    case SQL_DATE:
 	_value._int = MAX_INT;
 	break;
     case SQL_FLOAT:
@@ -814,6 +851,7 @@ inline bool field_value_t::copy_value(void* data) const
         memcpy(data, &_value._char, _max_size);
         break;
     case SQL_INT:
+    case SQL_DATE:
         memcpy(data, &_value._int, _max_size);
         break;
     case SQL_FLOAT:
@@ -908,11 +946,23 @@ inline void field_value_t::set_decimal_value(const decimal data)
 inline void field_value_t::set_time_value(const time_t data)
 { 
     assert (_pfield_desc);
-    assert (_pfield_desc->type() == SQL_FLOAT);
     _null_flag = false;
+    if (_pfield_desc->type() == SQL_DATE) {
+        _value._date = timet_to_date(data);
+        return;
+    }
+    assert (_pfield_desc->type() == SQL_FLOAT);
     _value._float = data;
 }
 
+inline void field_value_t::set_date_value(const int data)
+{ 
+    assert (_pfield_desc);
+    assert (_pfield_desc->type() == SQL_DATE);
+    _null_flag = false;
+    _value._date = data;
+}
+
 inline void field_value_t::set_tstamp_value(const timestamp_t& data)
 {
     assert (_pfield_desc);
@@ -1045,10 +1095,21 @@ inline decimal field_value_t::get_decimal_value() const
 inline time_t field_value_t::get_time_value() const
 {
     assert (_pfield_desc);
+    if (_pfield_desc->type() == SQL_DATE) {
+        // the local midnight, as str_to_timet() of the date string
+        return (date_to_timet(_value._date));
+    }
     assert (_pfield_desc->type() == SQL_FLOAT);
     return ((time_t)_value._float);
 }
 
+inline int field_value_t::get_date_value() const
+{
+    assert (_pfield_desc);
+    assert (_pfield_desc->type() == SQL_DATE);
+    return (_value._date);
+}
+
 inline timestamp_t& field_value_t::get_tstamp_value() const
 {
     assert (_pfield_desc);
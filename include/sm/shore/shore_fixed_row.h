@@ -0,0 +1,192 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_fixed_row.h
+ *
+ *  @brief:  Fixed-layout (zero-copy) rows, for tables whose records
+ *           are of fixed size
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   The table_row_t keeps each field in a separate field_value_t. Every read
+   goes through table_man_t::load() and every write through format(), which
+   walk the schema and copy the fields one by one.
+
+   When all the fields of a table are of fixed length and not nullable, the
+   disk format of a record is just the packed concatenation of its fields.
+   For such tables the record can be declared once as a packed struct,
+   mirroring the table_desc_t, for example:
+
+       #pragma pack(push,1)
+       struct account_rec_t {
+           int    A_ID;
+           int    A_B_ID;
+           double A_BALANCE;
+       };
+       #pragma pack(pop)
+
+   and accessed through a fixed_row_t<account_rec_t>. A probe copies the
+   record with a single memcpy (or serves it from the record cache), the
+   fields are read and modified directly in the struct, and an update writes
+   (and logs) only the bytes of the modified field. The layout is checked
+   against the table description when the manager is constructed.
+
+   The fixed-layout accesses are used by the transactions when the kits are
+   configured with --enable-fixedrows (CFG_FIXED_ROWS).
+*/
+
+#ifndef __SHORE_FIXED_ROW_H
+#define __SHORE_FIXED_ROW_H
+
+#include <stddef.h>
+
+#include "sm/shore/shore_table_man.h"
+
+
+ENTER_NAMESPACE(shore);
+
+
+// (offset,size) of a field of a fixed-layout record, to be passed to update_field()
+#define FIXED_FIELD(rec,field)                          \
+    offsetof(rec,field), sizeof(((rec*)0)->field)
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @struct: fixed_row_t
+ *
+ * @brief:  A fixed-layout record and its rid
+ *
+ * --------------------------------------------------------------- */
+
+template <class Rec>
+struct fixed_row_t
+{
+    Rec   _rec;
+    rid_t _rid;
+
+    fixed_row_t() : _rid(rid_t::null) { memset(&_rec, 0, sizeof(Rec)); }
+    ~fixed_row_t() { }
+
+    inline Rec* operator->() { return (&_rec); }
+    inline char* data() { return ((char*)&_rec); }
+
+    inline const rid_t& rid() const { return (_rid); }
+    inline bool is_rid_valid() const { return (_rid != rid_t::null); }
+
+}; // EOF: fixed_row_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: fixed_table_man_impl
+ *
+ * @brief: Table manager that, additionally to the table_row_t based
+ *         accesses, can access the records as fixed_row_t<Rec>
+ *
+ * --------------------------------------------------------------- */
+
+template <class TableDesc, class Rec>
+class fixed_table_man_impl : public table_man_impl<TableDesc>
+{
+public:
+    typedef fixed_row_t<Rec> fixed_row;
+
+    fixed_table_man_impl(TableDesc* aTableDesc,
+                         bool construct_cache=true)
+        : table_man_impl<TableDesc>(aTableDesc, construct_cache)
+    {
+        // if the layout does not match, only the table_row_t
+        // based accesses can be used
+        if (!this->set_fixed_layout(sizeof(Rec))) {
+            TRACE( TRACE_ALWAYS, "Fixed layout of (%s) does not match\n",
+                   aTableDesc->name());
+        }
+    }
+
+    ~fixed_table_man_impl() { }
+
+
+    /* --- access through index --- */
+
+    inline w_rc_t probe_by_name(ss_m* db,
+                                const char* idx_name,
+                                fixed_row& row,
+                                lock_mode_t lock_mode = SH)
+    {
+        index_desc_t* pindex = this->_ptable->find_index(idx_name);
+        assert (pindex);
+        return (this->index_probe_fixed(db, pindex, row.data(), sizeof(Rec),
+                                        row._rid, lock_mode));
+    }
+
+    inline w_rc_t probe_forupdate_by_name(ss_m* db,
+                                          const char* idx_name,
+                                          fixed_row& row)
+    {
+        return (probe_by_name(db, idx_name, row, EX));
+    }
+
+    inline w_rc_t probe_nl_by_name(ss_m* db,
+                                   const char* idx_name,
+                                   fixed_row& row)
+    {
+        return (probe_by_name(db, idx_name, row, NL));
+    }
+
+
+    /* --- record manipulation --- */
+
+    // writes only the given field, use as:
+    // update_field(db, row, FIXED_FIELD(Rec, field))
+    inline w_rc_t update_field(ss_m* db,
+                               fixed_row& row,
+                               const uint_t offset,
+                               const uint_t len,
+                               const lock_mode_t lock_mode = EX)
+    {
+        assert (offset+len <= sizeof(Rec));
+        return (this->update_fixed(db, row._rid, row.data(),
+                                   offset, len, lock_mode));
+    }
+
+    inline w_rc_t add_row(ss_m* db,
+                          fixed_row& row,
+                          const lock_mode_t lock_mode = EX,
+                          const lpid_t& primary_root = lpid_t::null)
+    {
+        return (this->add_fixed(db, row.data(), sizeof(Rec), row._rid,
+                                lock_mode, primary_root));
+    }
+
+}; // EOF: fixed_table_man_impl
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_FIXED_ROW_H */
@@ -68,6 +68,42 @@
    --enable-dflusher
 */
 
+
+/**
+   Without the flusher there are two commit modes: the synchronous, where the
+   worker blocks until the commit record is durable, and the asynchronous 
+   ("asynch" shell command), where the client is notified as soon as the 
+   commit record is in the log buffer but never learns whether and when the 
+   xct became durable.
+
+   The third mode (CM_ASYNCH_DURABLE, "asynch durable") keeps the early ack 
+   of the asynchronous commit and adds a separate durability notification:
+
+   worker:
+   {  ...
+      commit_xct(lazy, &lsn);
+      notify_client();                          // acknowledged
+      notifier->enqueue(lsn); }
+
+   notifier:
+   while (true) {
+      if (time_to_flush()) sync_log();
+      else sleep(min(backoff, time_to_timeout));
+      for each waiting lsn < durable_lsn:
+         durable_cb(xct_id, lsn);               // durable
+   }
+
+   The flush decision uses the same knobs as the flusher (flusher-group-size,
+   flusher-timeout). While the group is neither big nor old enough the
+   notifier sleeps, doubling the sleep up to NOTIFIER_MAX_BACKOFF_US, instead
+   of spinning. When no xct is waiting it blocks in its input queue.
+
+   The DORA terminal rvps hand their xcts to the same notifier, when running
+   without the dora-flusher. The latencies from the submission of the request to the
+   ack and to the durability notification are kept in two histograms, 
+   printed and reset by the "stats" command.
+*/
+
 #ifndef __SHORE_FLUSHER_H
 #define __SHORE_FLUSHER_H
 
@@ -136,6 +172,9 @@ const int FLUSHER_GROUP_SIZE_THRESHOLD  = 100;    // Flush every 100 xcts
 const int FLUSHER_LOG_SIZE_THRESHOLD    = 200000; // Flush every 200K
 const int FLUSHER_TIME_THRESHOLD        = 1000;   // Flush every 1000usec (msec)
 
+const int NOTIFIER_MIN_BACKOFF_US       = 10;     // First sleep of the notifier
+const int NOTIFIER_MAX_BACKOFF_US       = 500;    // Longest sleep of the notifier
+
 
 class flusher_t : public base_worker_t
 {   
@@ -182,6 +221,104 @@ public:
 
 
 
+/******************************************************************** 
+ *
+ * @struct: latency_hist_t
+ *
+ * @brief:  Histogram of latencies, in power-of-two usec buckets
+ * 
+ ********************************************************************/
+
+const int LATENCY_HIST_BUCKETS = 32;   // up to ~35 mins
+
+struct latency_hist_t
+{
+    uint64_t volatile _bucket[LATENCY_HIST_BUCKETS];
+    uint64_t volatile _count;
+    uint64_t volatile _total_us;
+
+    latency_hist_t() { reset(); }
+
+    void add(const long long us);
+
+    // Upper bound (usecs) of the bucket of the p-th percentile
+    long long percentile(const double p) const;
+
+    void print(const char* name) const;
+    void reset();
+
+}; // EOF: latency_hist_t
+
+
+
+/******************************************************************** 
+ *
+ * @struct: durable_entry_t
+ *
+ * @brief:  A xct committed asynchronously, waiting to become durable
+ * 
+ ********************************************************************/
+
+struct durable_entry_t
+{
+    lsn_t     _lsn;
+    int       _xct_id;
+    long long _submit_us;
+};
+
+
+
+/******************************************************************** 
+ *
+ * @class: durability_notifier_t
+ *
+ * @brief: Flushes the log in groups on behalf of the asynchronously 
+ *         committed xcts, and notifies when each one becomes durable
+ * 
+ ********************************************************************/
+
+class durability_notifier_t : public base_worker_t
+{   
+public:
+    typedef srmwqueue<durable_entry_t>  DurableQueue;
+
+private:
+
+    guard<Pool>          _pentry_ptr_pool;
+    guard<DurableQueue>  _pending;        // pushed by the workers
+    std::vector<durable_entry_t*> _waiting;  // owned by the notifier
+
+    blob_pool            _entry_pool;
+
+    durable_cb_t         _cb;
+    void*                _cb_arg;
+
+    latency_hist_t       _ack_hist;
+    latency_hist_t       _durable_hist;
+    flusher_stats_t      _stats;
+
+    int _pre_STOP_impl();
+    int _work_ACTIVE_impl(); 
+    uint _notify_durable(const lsn_t& durablelsn);
+
+public:
+
+    durability_notifier_t(ShoreEnv* env, c_str tname,
+                          processorid_t aprsid = PBIND_NONE);
+    ~durability_notifier_t();
+
+    // Set before switching to CM_ASYNCH_DURABLE
+    void set_callback(durable_cb_t cb, void* arg) { _cb = cb; _cb_arg = arg; }
+
+    // Called by the worker, after the client has been acked
+    void enqueue(const lsn_t& lsn, const int xct_id, const long long submit_us);
+
+    int statistics();  
+
+}; // EOF: durability_notifier_t
+
+
+
 EXIT_NAMESPACE(shore);
 
 #endif /** __SHORE_FLUSHER_H */
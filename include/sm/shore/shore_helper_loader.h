@@ -101,6 +101,43 @@ public:
 }; // EOF: db_init_smt_t
 
 
+
+/****************************************************************** 
+ *
+ *  @class: db_snapshot_smt_t
+ *
+ *  @brief: An smthread inherited class that it is used for taking
+ *          a snapshot of the database or restoring from one
+ *
+ ******************************************************************/
+
+class db_snapshot_smt_t : public thread_t 
+{
+private:
+    ShoreEnv*   _env;
+    std::string _name;
+    bool        _restore;
+    int         _rv;
+
+public:
+    
+    db_snapshot_smt_t(c_str tname, ShoreEnv* db, 
+                      const char* aname, const bool brestore) 
+	: thread_t(tname), _env(db), _name(aname), _restore(brestore), _rv(0)
+    {
+        assert (_env);
+    }
+
+    ~db_snapshot_smt_t() { }
+
+    // thread entrance
+    void work();
+
+    inline int rv() { return (_rv); }
+
+}; // EOF: db_snapshot_smt_t
+
+
     
 /****************************************************************** 
  *
@@ -275,9 +312,11 @@ public:
                 assert (pdest); // if NULL invalid key
             
 		int pnum = _pmanager->get_pnum(_pindex, _ptuple);
+                char el[MAX_INDEX_EL];
+                int elsz = _pmanager->format_el(_pindex, _ptuple, el);
                 W_DO(_pssm->create_assoc(_pindex->fid(pnum),
                                          vec_t(pdest, key_sz),
-                                         vec_t(&(_ptuple->_rid), sizeof(rid_t))));
+                                         vec_t(el, elsz)));
             
                 _has_to_consume = false;
                 cons_happened = true; // a consumption just happened
@@ -28,6 +28,16 @@
  *  All the secondary indexes on the table are linked together.  
  *  An index is described by an array of serial number of fields.
  *
+ *  An index may also carry a payload of fields, which are not part of
+ *  the key. The element of each entry of such a (covering) index is the
+ *  rid of the record followed by the payload fields, in disk format. Then
+ *  a probe or a scan that needs only the key and the payload fields does
+ *  not have to pin the record (see table_man_t::index_probe_covered()).
+ *  The payload fields should be of fixed length and not nullable, so that
+ *  the element has a fixed size and the fields a fixed offset in the
+ *  record. The payloads of the multi-rooted (MRBT) indexes are ignored,
+ *  since their elements are moved around by the PLP relocations.
+ *
  *  @author: Mengzhi Wang, April 2001
  *  @author: Ippokratis Pandis, January 2008
  *
@@ -50,6 +60,13 @@ ENTER_NAMESPACE(shore);
 class table_desc_t;
 
 
+// The maximum size of the payload of a covering index entry
+const unsigned int MAX_INDEX_PAYLOAD = 128;
+
+// The maximum size of an index element, the rid and the payload
+const unsigned int MAX_INDEX_EL = sizeof(rid_t) + MAX_INDEX_PAYLOAD;
+
+
 /******************************************************************
  *
  *  @class: index_desc_t
@@ -88,6 +105,13 @@ private:
     int		  _partition_count;
     stid_t*	  _partition_stids;
 
+    /* the payload fields carried by the entries, if covering */
+    uint*           _payload;                  /* index of fields in the base table */
+    uint_t*         _payload_off;              /* offset of each field in the record */
+    uint_t*         _payload_sz;               /* size of each field */
+    uint_t          _payload_cnt;
+    uint_t          _payload_bytes;
+
 public:
 
     /* ------------------- */
@@ -161,6 +185,30 @@ public:
     inline void set_keysize(const uint_t sz) { atomic_swap_uint(&_maxkeysize, sz); }
 
 
+    /* ------------------------ */
+    /* --- covering payload --- */
+    /* ------------------------ */
+
+    // set through table_desc_t::set_index_payload()
+    inline bool   is_covering() const { return ((_payload_cnt>0) && (!_mr)); }
+    inline uint_t payload_count() const { return (_payload_cnt); }
+    inline uint_t payload_bytes() const { return (_payload_bytes); }
+    inline uint_t payload_index(const uint_t i) const { 
+        assert (i<_payload_cnt); return (_payload[i]); 
+    }
+    inline uint_t payload_off(const uint_t i) const { 
+        assert (i<_payload_cnt); return (_payload_off[i]); 
+    }
+    inline uint_t payload_sz(const uint_t i) const { 
+        assert (i<_payload_cnt); return (_payload_sz[i]); 
+    }
+
+    // size of the element of an entry
+    inline uint_t el_size() const { 
+        return (sizeof(rid_t) + (is_covering() ? _payload_bytes : 0)); 
+    }
+
+
     /* ---------------------------------- */
     /* --- index link list operations --- */
     /* ---------------------------------- */
@@ -0,0 +1,192 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_load_cache.h
+ *
+ *  @brief:  Cache of the generated records of a database, which is
+ *           replayed by the following loads of the same database
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   The TPC-H and SSB loaders call dbgen for every row and then format each
+   row into a Shore record. Loading the same scaling factor again repeats
+   all this work.
+
+   With db-loadcache=1 the first load of a database captures the records,
+   exactly as formatted by table_man_t::format(), to files in
+   db-loadcache-dir/<name>. Each loader thread appends to its own file per
+   table, as [size (uint4_t)][record] entries. As with the bulk loader, the
+   records of a xct are buffered by the thread and reach the file only after
+   the xct commits (mark()), so that the records of an aborted and retried
+   xct are dropped (rollback()).
+
+   At the end of the load a MANIFEST is written, with the signature of the
+   schema (the name and the type, size and nullability of each field of each
+   table) and the size, number of records and checksum of each file. The
+   MANIFEST is written last, thus a capture that did not finish leaves no
+   valid cache behind.
+
+   The next load of the same database (same name, which includes the
+   scaling factor) finds the MANIFEST, verifies the schema signature and the
+   checksum of each file, and if all match, it does not call dbgen at all.
+   db-loaders threads map the files and insert the records as they are,
+   through table_man_t::add_formatted(), either fully logged or through the
+   bulk loader (db-bulkload=1). A stale or corrupted cache is reported and
+   ignored, and the database is generated (and captured) again.
+*/
+
+#ifndef __SHORE_LOAD_CACHE_H
+#define __SHORE_LOAD_CACHE_H
+
+#include <stdio.h>
+
+#include "sm/shore/shore_table.h"
+
+
+ENTER_NAMESPACE(shore);
+
+
+// Defaults of the load cache
+const uint_t LOAD_CACHE_FLUSH_MB = 16;   // buffered bytes per file before a write
+const uint_t LOAD_CACHE_XCT_ROWS = 1000; // records per xct at replay
+const uint_t LOAD_CACHE_LOG_RETRIES = 5; // retries of an xct out of log space
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: load_cache_t
+ *
+ * @brief: Captures the formatted records of a set of tables to files,
+ *         and replays them to the tables
+ *
+ * --------------------------------------------------------------- */
+
+class load_cache_t
+{
+public:
+
+    // One file of the cache, the records of one table by one loader
+    struct cfile_t {
+        uint_t      _itable;
+        std::string _name;
+        uint64_t    _rows;
+        uint64_t    _bytes;
+        uint32_t    _sum;        // fnv_hash() of the file
+    };
+
+    // The file of one table of one loader thread, while capturing
+    struct cwriter_t {
+        cfile_t           _file;
+        FILE*             _fp;
+        std::vector<char> _buf;        // records of the running xct(s)
+        uint64_t          _buf_rows;
+    };
+
+    // All the writers of one loader thread
+    struct thread_writers_t {
+        std::vector<cwriter_t*> _writers;  // one per table, opened lazily
+        bool                    _spilled;  // written since the last mark
+    };
+
+private:
+
+    std::string               _name;
+    std::string               _dir;
+    std::vector<table_man_t*> _tables;
+    uint32_t                  _schema_sig;
+    bool                      _usable;
+
+    // capture
+    bool                            _capturing;
+    bool                            _broken;   // a rolled back xct was spilled
+    mcs_lock                        _writers_lock;
+    std::vector<thread_writers_t*>  _twriters;
+    uint_t                          _next_file;
+
+    // replay
+    std::vector<cfile_t>      _files;
+
+    thread_writers_t* _my_writers();
+    w_rc_t _flush(cwriter_t* pw);
+    w_rc_t _write_manifest();
+    bool   _read_manifest();
+    std::string _path(const std::string& file) const;
+
+    // the cache being captured, at most one at a time
+    static load_cache_t* _active;
+    static uint_t        _gen;       // bumped at every begin_capture()
+
+public:
+
+    // name identifies the database, e.g. "tpch-sf10"
+    load_cache_t(const char* name, const std::vector<table_man_t*>& tables);
+    ~load_cache_t();
+
+    // Returns true if db-loadcache is set
+    static bool is_enabled();
+
+    // Returns true if a complete cache matching the schema exists,
+    // and all its files pass the checksum
+    bool is_valid();
+
+    // Inserts all the records of the cache, using the given number of
+    // threads. Should be called after the tables are created.
+    w_rc_t replay(ss_m* db, const int threads);
+
+
+    /* --- capturing the records of a load --- */
+
+    // Starts capturing the records added to the tables
+    w_rc_t begin_capture();
+
+    // Writes the last records and the MANIFEST
+    w_rc_t end_capture();
+
+    // Called by table_man_t::add_tuple() with the formatted record
+    void capture(table_man_t* pman, const char* rec, const uint_t recsz);
+
+    // Loader thread hooks, for a xct that may be retried:
+    //
+    //     load_cache_t::mark();
+    // retry:
+    //     load_cache_t::rollback();
+    //     begin_xct(); ...
+    static void mark();
+    static void rollback();
+
+
+    /* --- replay --- */
+
+    uint_t file_count() const { return (_files.size()); }
+    w_rc_t replay_file(ss_m* db, const uint_t ifile, uint64_t& rows);
+
+}; // EOF: load_cache_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_LOAD_CACHE_H */
@@ -0,0 +1,216 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_log_profile.h
+ *
+ *  @brief:  Profile of the log volume, per xct type and per table
+ *           operation
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   The flusher statistics give only the total log volume, as the difference
+   of the LSNs. With db-log-profile=1 the log bytes and the log records
+   inserted are accounted:
+
+   - Per xct type, by the trx_worker_t around each run_one_xct().
+
+   - Per table and table_man_t operation (add_tuple, update_tuple,
+     update_dirty, update_fixed, delete_tuple and index insert), by a
+     log_probe_t around the operation. The index inserts are accounted
+     also as part of the add_tuple that issued them.
+
+   The amounts are read from the per-thread SM statistics of the thread that
+   runs the operation, not from the LSN of the log. The LSN of the log moves
+   also by the records of all the concurrent xcts, thus the difference of
+   two LSNs sampled by one thread is not the log of the operation.
+
+   Along with the log, each update_tuple() accounts the size of the record
+   it wrote. update_tuple() always writes the whole record, thus an update
+   that modifies only one field (e.g. C_BALANCE of TPC-C CUSTOMER) logs the
+   whole record, before and after. Those show up as updates whose log bytes
+   per op are about twice the record size, and are candidates for
+   update_dirty() or update_fixed(), which account only the bytes they
+   write.
+
+   The profile is printed by the "logstats" shell command and at the end of
+   each measure iteration, and it is reset with the rest of the stats.
+*/
+
+#ifndef __SHORE_LOG_PROFILE_H
+#define __SHORE_LOG_PROFILE_H
+
+#include "util.h"
+#include "sm_vas.h"
+
+#include <map>
+
+
+ENTER_NAMESPACE(shore);
+
+
+// The operations of the table manager that are profiled
+enum eLogOp { LOP_ADD_TUPLE    = 0,
+              LOP_UPDATE_TUPLE = 1,
+              LOP_UPDATE_DIRTY = 2,
+              LOP_UPDATE_FIXED = 3,
+              LOP_DELETE_TUPLE = 4,
+              LOP_INDEX_INSERT = 5,
+              LOP_COUNT        = 6 };
+
+extern const char* LOG_OP_NAMES[LOP_COUNT];
+
+// The xct types are used directly as the index of the per-type counters,
+// the larger ones share the last counter
+const int LOG_PROFILE_XCT_TYPES = 2048;
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @struct: log_counter_t
+ *
+ * @brief:  Log bytes and log records of a class of operations.
+ *          Updated concurrently by all the workers.
+ *
+ * --------------------------------------------------------------- */
+
+struct log_counter_t
+{
+    volatile uint64_t _ops;
+    volatile uint64_t _bytes;
+    volatile uint64_t _records;
+    volatile uint64_t _payload;   // bytes of the records written
+
+    log_counter_t() { reset(); }
+
+    inline void add(const uint64_t bytes, const uint64_t records,
+                    const uint64_t payload)
+    {
+        atomic_inc_64(&_ops);
+        atomic_add_64(&_bytes, bytes);
+        atomic_add_64(&_records, records);
+        if (payload) atomic_add_64(&_payload, payload);
+    }
+
+    void reset() { _ops = 0; _bytes = 0; _records = 0; _payload = 0; }
+
+    void print(const char* name, const char* op) const;
+};
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: log_profile_t
+ *
+ * @brief: The switch and the per xct type counters of the profile
+ *
+ * --------------------------------------------------------------- */
+
+class log_profile_t
+{
+    static bool          _enabled;
+    static log_counter_t _xct[LOG_PROFILE_XCT_TYPES];
+
+public:
+
+    // The log inserted by the calling thread so far
+    static inline uint64_t my_log_bytes() {
+        return (smthread_t::me()->TL_stats().sm.log_bytes_generated);
+    }
+    static inline uint64_t my_log_records() {
+        return (smthread_t::me()->TL_stats().sm.log_records_generated);
+    }
+
+    // Reads db-log-profile
+    static void init();
+
+    static inline bool is_enabled() { return (_enabled); }
+    static void set_enabled(const bool enabled) { _enabled = enabled; }
+
+    static inline void add_xct(const int xct_type, const uint64_t bytes,
+                               const uint64_t records)
+    {
+        int i = ((xct_type>=0) && (xct_type<LOG_PROFILE_XCT_TYPES) ?
+                 xct_type : LOG_PROFILE_XCT_TYPES-1);
+        _xct[i].add(bytes, records, 0);
+    }
+
+    // Prints the per xct type and the per table profile. The names of
+    // the xct types are taken from pnames, if given.
+    static void print(const std::map<int,std::string>* pnames = NULL);
+    static void reset();
+
+}; // EOF: log_profile_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: log_probe_t
+ *
+ * @brief: Accounts the log inserted by the calling thread during its
+ *         lifetime to a counter, if the profile is enabled
+ *
+ * --------------------------------------------------------------- */
+
+class log_probe_t
+{
+    log_counter_t* _pcounter;
+    uint64_t       _bytes;
+    uint64_t       _records;
+    uint64_t       _payload;
+
+public:
+
+    log_probe_t(log_counter_t* pcounter)
+        : _pcounter(log_profile_t::is_enabled() ? pcounter : NULL),
+          _bytes(0), _records(0), _payload(0)
+    {
+        if (_pcounter) {
+            _bytes = log_profile_t::my_log_bytes();
+            _records = log_profile_t::my_log_records();
+        }
+    }
+
+    ~log_probe_t()
+    {
+        if (_pcounter) {
+            _pcounter->add(log_profile_t::my_log_bytes() - _bytes,
+                           log_profile_t::my_log_records() - _records,
+                           _payload);
+        }
+    }
+
+    // The size of the record written by the operation
+    void set_payload(const uint64_t payload) { _payload = payload; }
+
+}; // EOF: log_probe_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_LOG_PROFILE_H */
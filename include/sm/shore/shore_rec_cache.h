@@ -0,0 +1,201 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_rec_cache.h
+ *
+ *  @brief:  Hot-key record cache in front of the index probes of
+ *           read-mostly tables
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   Tables like TPC-C ITEM, TPC-E TRADE_TYPE/STATUS_TYPE/SECURITY and the TM1
+   SUBSCRIBER are read over and over through index_probe(). Each probe
+   descends the B-tree, pins the heap page and unpacks the record.
+
+   The rec_cache_t keeps a direct-mapped array of slots, each holding the
+   (index, formatted key) -> (rid, record in disk format) of a recent probe.
+   Reads are lock-free: each slot is protected by a sequence number which is
+   odd while the slot is being filled, and the reader validates that it did
+   not change while copying.
+
+   A slot is validated by two versions:
+
+   - The version of the record, one of REC_CACHE_STRIPES counters picked by
+     the rid. Every update/delete of a record bumps the counter of its rid,
+     after the record is written. Thus, a write invalidates only the slots
+     of the records that share its stripe, not the whole cache. The version
+     is read after the probe finds the rid and before the record is pinned,
+     so a slot filled with a record that is being updated is stale.
+
+   - The epoch of the cache, bumped by invalidate() when an xct aborts and
+     when the database is restored. A rollback does not say which records
+     it restored, so it invalidates all the slots of the tables that may be
+     updated. The epoch is read before the probe.
+
+   Since a hit skips the heap page pin, it skips also the record lock. Thus,
+   hits are served only for probes in NL mode (DORA/PLP, or the *_nl calls),
+   or for any lock mode but EX if the table is declared read-only. Probes
+   for update are never served from the cache, not even in NL mode, since
+   the caller is going to write the record it reads.
+
+   The hit/miss counters are striped by thread, one cache line per stripe,
+   so that bumping them on every probe does not make all the threads
+   contend for the same line. print_stats() sums the stripes.
+*/
+
+#ifndef __SHORE_REC_CACHE_H
+#define __SHORE_REC_CACHE_H
+
+#include "util.h"
+#include "sm_vas.h"
+
+
+ENTER_NAMESPACE(shore);
+
+
+class index_desc_t;
+
+
+// Upper limit on the number of slots of each record cache
+const uint_t REC_CACHE_MAX_SLOTS = 1<<20;
+
+// Number of record version counters of each record cache
+const uint_t REC_CACHE_STRIPES = 256;
+
+// Number of hit/miss counters of each record cache
+const uint_t REC_CACHE_STAT_STRIPES = 64;
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: rec_cache_t
+ *
+ * @brief: Per-table, version-validated, lock-free record cache
+ *
+ * --------------------------------------------------------------- */
+
+class rec_cache_t
+{
+private:
+
+    struct slot_t {
+        volatile uint_t _seq;     // odd while being filled
+        uint_t          _epoch;   // cache epoch when filled
+        uint_t          _rver;    // record version when filled
+        index_desc_t*   _pidx;
+        uint_t          _keysz;
+        uint_t          _recsz;
+        rid_t           _rid;
+        char*           _key;     // points inside _area
+        char*           _rec;     // points inside _area
+    };
+
+    slot_t*  _slots;
+    char*    _area;
+    uint_t   _mask;
+    uint_t   _entrysz;            // max key size = max record size
+
+    // the record versions, one cache line each
+    struct stripe_t {
+        volatile uint_t _ver;
+        char            _pad[64 - sizeof(uint_t)];
+    };
+
+    stripe_t        _stripes[REC_CACHE_STRIPES];
+    volatile uint_t _epoch;       // bumped when the whole cache is invalid
+
+    // stats, one cache line per stripe of threads
+    struct stat_stripe_t {
+        volatile uint_t _hits;
+        volatile uint_t _misses;
+        volatile uint_t _fills;
+        char            _pad[64 - 3*sizeof(uint_t)];
+    };
+
+    stat_stripe_t   _stats[REC_CACHE_STAT_STRIPES];
+    volatile uint_t _invalidations;
+
+    // the stripe of the calling thread
+    stat_stripe_t& _stat_stripe();
+
+    inline stripe_t& _stripe(const rid_t& arid) {
+        return (_stripes[(arid.pid.page*31 + arid.slot) % REC_CACHE_STRIPES]);
+    }
+
+    inline uint_t _hash(index_desc_t* pidx, const char* key,
+                        const uint_t keysz) const
+    {
+        // FNV-1a over the formatted key, mixed with the index
+        uint_t h = 2166136261u ^ (uint_t)((long)pidx >> 4);
+        for (uint_t i=0; i<keysz; ++i) {
+            h = (h ^ (unsigned char)key[i]) * 16777619u;
+        }
+        return (h & _mask);
+    }
+
+public:
+
+    rec_cache_t(const uint_t slots, const uint_t entrysz);
+    ~rec_cache_t();
+
+    // The epoch should be read before the probe that fills a slot, and
+    // the version of the record after the probe, before the record is read
+    inline uint_t epoch() const { return (*&_epoch); }
+    inline uint_t version(const rid_t& arid) { return (*&_stripe(arid)._ver); }
+
+    // Returns true and copies the record to abuf (of size >= entrysz) if
+    // the (index,key) pair is cached and valid
+    bool lookup(index_desc_t* pidx, const char* key, const uint_t keysz,
+                rid_t& arid, char* abuf);
+
+    // Fills the slot of (index,key) with the record read at the given
+    // epoch and record version
+    void fill(index_desc_t* pidx, const char* key, const uint_t keysz,
+              const rid_t& arid, const char* rec, const uint_t recsz,
+              const uint_t epoch, const uint_t rver);
+
+    // Invalidates the cached copies of a record. Should be called after
+    // the record is written.
+    inline void invalidate(const rid_t& arid) {
+        atomic_inc_uint(&_stripe(arid)._ver);
+    }
+
+    // Invalidates all the cached records
+    inline void invalidate() {
+        atomic_inc_uint(&_epoch);
+        atomic_inc_uint(&_invalidations);
+    }
+
+    void reset_stats();
+    void print_stats(const char* tname) const;
+
+}; // EOF: rec_cache_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_REC_CACHE_H */
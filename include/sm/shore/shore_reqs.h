@@ -146,9 +146,10 @@ struct base_request_t
     tid_t               _tid;
     int                 _xct_id;
     trx_result_tuple_t  _result;
+    long long           _submit_us; // when the client submitted it
 
     base_request_t() 
-        : _xct(NULL),_xct_id(-1)
+        : _xct(NULL),_xct_id(-1),_submit_us(0)
     { }
 
     base_request_t(xct_t* pxct, const tid_t& atid, const int axctid,
@@ -156,6 +157,8 @@ struct base_request_t
         : _xct(pxct),_tid(atid),_xct_id(axctid),_result(aresult)
     {
         assert (pxct);
+        stopwatch_t now;
+        _submit_us = now.now();
     }
 
     ~base_request_t() 
@@ -171,6 +174,8 @@ struct base_request_t
         _tid = atid;
         _xct_id = axctid;
         _result = aresult;
+        stopwatch_t now;
+        _submit_us = now.now();
     }
 
     inline xct_t* xct() { return (_xct); }
@@ -182,6 +187,7 @@ struct base_request_t
     lsn_t        _my_last_lsn;
     inline void  set_last_lsn(const lsn_t& alsn) { _my_last_lsn = alsn; }
     inline lsn_t my_last_lsn() { return (_my_last_lsn); }
+    inline long long submit_us() const { return (_submit_us); }
 
 }; // EOF: base_request_t
 
@@ -231,6 +237,12 @@ struct trx_request_t : public base_request_t
 
 
 
+// Called when a xct committed in CM_ASYNCH_DURABLE mode becomes durable
+// (see shore_flusher.h)
+typedef void (*durable_cb_t)(const int xct_id, const lsn_t& lsn, void* arg);
+
+
+
 EXIT_NAMESPACE(shore);
 
 #endif /** __SHORE_REQS_H */
@@ -110,6 +110,10 @@ ENTER_NAMESPACE(shore);
 typedef blob_pool ats_char_t;
 typedef intptr_t offset_t;
 
+// The fields tracked one by one by the dirty mask of a row. A set to any
+// field beyond them sets the last bit, which marks the whole row dirty.
+const uint_t ROW_DIRTY_BITS = 64;
+
 
 /* ---------------------------------------------------------------
  *
@@ -159,6 +163,9 @@ struct table_row_t
     rid_t          _rid;          /* record id */    
     field_value_t* _pvalues;      /* set of values */
 
+    char*          _arena;        /* data of the time/string values */
+    uint_t         _arena_sz;
+
     // pre-calculated offsets
     offset_t _fixed_offset;
     offset_t _var_slot_offset;
@@ -168,6 +175,8 @@ struct table_row_t
     rep_row_t*     _rep;          /* a pointer to a row representation struct */
     rep_row_t*     _rep_key;      /* a pointer to a row-key representation struct */
 
+    uint64_t       _dirty;        /* fields set since the last load */
+
 
     /* -------------------- */
     /* --- construction --- */
@@ -178,8 +187,9 @@ struct table_row_t
 	: _ptable(NULL),
 	  _field_cnt(0), _is_setup(false), 
 	  _rid(rid_t::null), _pvalues(NULL), 
+	  _arena(NULL), _arena_sz(0),
 	  _fixed_offset(0),_var_slot_offset(0),_var_offset(0),_null_count(0),
-	  _rep(NULL), _rep_key(NULL)
+	  _rep(NULL), _rep_key(NULL), _dirty(0)
     {
         assert (ptd);
         setup(ptd);
@@ -214,6 +224,26 @@ struct table_row_t
     uint size() const;
 
 
+    /* -------------------------------------- */
+    /* --- fields set since the last load --- */
+    /* -------------------------------------- */
+
+    // Every set_value()/set_null() marks the field dirty. Loading the row
+    // from its record (table_man_t::load()) clears the mask, thus after a
+    // probe it holds the fields that the update has to write.
+
+    inline void mark_dirty(const uint idx) {
+        _dirty |= (idx < ROW_DIRTY_BITS-1 ? (1ULL<<idx) : (1ULL<<(ROW_DIRTY_BITS-1)));
+    }
+    inline bool is_dirty(const uint idx) const {
+        return (_dirty & ((1ULL<<(ROW_DIRTY_BITS-1)) | 
+                          (idx < ROW_DIRTY_BITS-1 ? (1ULL<<idx) : 0)));
+    }
+    inline bool has_dirty() const { return (_dirty != 0); }
+    inline bool is_all_dirty() const { return (_dirty & (1ULL<<(ROW_DIRTY_BITS-1))); }
+    inline void clear_dirty() { _dirty = 0; }
+
+
     /* ------------------------ */
     /* --- set field values --- */
     /* ------------------------ */
@@ -230,6 +260,10 @@ struct table_row_t
     void set_value(const uint idx, const char* string);
     void set_value(const uint idx, const timestamp_t& time);
 
+    // SQL_DATE fields, as days since the epoch (time_util.h). They can be
+    // also set and read as a time_t or as a "YYYY-MM-DD" string.
+    void set_date_value(const uint idx, const int date);
+
 
     /* ------------------------ */
     /* --- get field values --- */
@@ -245,6 +279,7 @@ struct table_row_t
     bool get_value(const uint idx, decimal& dest) const;
     bool get_value(const uint idx, time_t& dest) const;
     bool get_value(const uint idx, timestamp_t& dest) const;
+    bool get_date_value(const uint idx, int& dest) const;
 
 
     /* ----------------- */
@@ -265,8 +300,10 @@ struct table_row_t
     /* clear the tuple and prepare it for re-use */
     void reset() { 
         assert (_is_setup);
+        if (_arena) memset(_arena, 0, _arena_sz);
         for (uint_t i=0; i<_field_cnt; i++)
             _pvalues[i].reset();
+        _dirty = 0;
     }        
 
     void freevalues()
@@ -275,6 +312,11 @@ struct table_row_t
             delete [] _pvalues;
             _pvalues = NULL;
         }
+        if (_arena) {
+            free (_arena);
+            _arena = NULL;
+            _arena_sz = 0;
+        }
     }
 
 }; // EOF: table_row_t
@@ -325,6 +367,7 @@ inline void table_row_t::set_null(const uint idx)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_null();
 }
 
@@ -333,6 +376,7 @@ inline void table_row_t::set_value(const uint idx, const int v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_int_value(v);
 }
 
@@ -341,6 +385,7 @@ inline void table_row_t::set_value(const uint idx, const bool v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_bit_value(v);
 }
 
@@ -349,6 +394,7 @@ inline void table_row_t::set_value(const uint idx, const short v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_smallint_value(v);
 }
 
@@ -357,6 +403,7 @@ inline void table_row_t::set_value(const uint idx, const double v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_float_value(v);
 }
 
@@ -365,6 +412,7 @@ inline void table_row_t::set_value(const uint idx, const long long v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_long_value(v);
 }
 
@@ -373,6 +421,7 @@ inline void table_row_t::set_value(const uint idx, const decimal v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_decimal_value(v);
 }
 
@@ -381,6 +430,7 @@ inline void table_row_t::set_value(const uint idx, const time_t v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_time_value(v);
 }
 
@@ -389,6 +439,7 @@ inline void table_row_t::set_value(const uint idx, const char v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_char_value(v);
 }
 
@@ -397,8 +448,13 @@ inline void table_row_t::set_value(const uint idx, const char* string)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
 
     sqltype_t sqlt = _pvalues[idx].field_desc()->type();
+    if (sqlt == SQL_DATE) {
+        _pvalues[idx].set_date_value(str_to_date(string));
+        return;
+    }
     assert (sqlt == SQL_VARCHAR || sqlt == SQL_FIXCHAR );
 
     int len = strlen(string);
@@ -417,9 +473,19 @@ inline void table_row_t::set_value(const uint idx, const timestamp_t& time)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_value(&time, 0);
 }
 
+inline void table_row_t::set_date_value(const uint idx, const int date)
+{
+    assert (_is_setup);
+    assert (idx < _field_cnt);
+    assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
+    _pvalues[idx].set_date_value(date);
+}
+
 
 
 /******************************************************************
@@ -490,6 +556,12 @@ inline bool table_row_t::get_value(const uint idx,
         destbuf[0] = '\0';
         return (false);
     }
+    if (_pvalues[idx].field_desc()->type() == SQL_DATE) {
+        // formatted as "YYYY-MM-DD", as the dates were stored before
+        assert (bufsize > (uint)DATE_STR_LEN);
+        date_to_str(destbuf, _pvalues[idx].get_date_value());
+        return (true);
+    }
     // if variable length
     uint_t sz = MIN(bufsize-1, _pvalues[idx]._max_size);
     _pvalues[idx].get_string_value(destbuf, sz);
@@ -560,6 +632,19 @@ inline bool table_row_t::get_value(const uint idx,
     return true;
 }
 
+inline bool table_row_t::get_date_value(const uint idx,
+                                        int& dest) const
+{
+    assert (_is_setup);
+    assert(idx < _field_cnt);
+    if (_pvalues[idx].is_null()) {
+        dest = 0;
+        return false;
+    }
+    dest = _pvalues[idx].get_date_value();
+    return true;
+}
+
 
 
 EXIT_NAMESPACE(shore);
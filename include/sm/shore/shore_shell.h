@@ -94,6 +94,8 @@ DECLARE_ENV_CMD(db_print);
 DECLARE_ENV_CMD(db_fetch);
 DECLARE_ENV_CMD(stats_verbose);
 DECLARE_ENV_CMD(log);
+DECLARE_ENV_CMD(snapshot);
+DECLARE_ENV_CMD(restore);
 
 
 
@@ -158,6 +160,7 @@ DECLARE_KIT_CMD(test);
 DECLARE_KIT_CMD(warmup);
 DECLARE_KIT_CMD(load);
 DECLARE_KIT_CMD(trxs);
+DECLARE_KIT_CMD(logstats);
 
 
 
@@ -213,6 +216,8 @@ protected:
     guard<stats_verbose_cmd_t>  _stats_verboser;
     guard<db_print_cmd_t>       _db_printer;
     guard<db_fetch_cmd_t>       _db_fetch;
+    guard<snapshot_cmd_t>       _snapshoter;
+    guard<restore_cmd_t>        _restorer;
     
     guard<log_cmd_t>            _logger;
     guard<asynch_cmd_t>         _asyncher;
@@ -229,6 +234,7 @@ protected:
     guard<warmup_cmd_t>         _warmuper;
     guard<load_cmd_t>           _loader;
     guard<trxs_cmd_t>           _trxser;
+    guard<logstats_cmd_t>       _logstatser;
 
 public:
 
@@ -258,6 +264,7 @@ public:
     virtual int load_trxs_map(void)=0;
     virtual int load_bp_map(void)=0;
     void print_sup_trxs(void) const;
+    void print_log_profile(void) const;
     void print_sup_bp(void);
     const char* translate_trx(const int iSelectedTrx) const;
     const char* translate_bp(const eBindingType abt);
@@ -102,6 +102,8 @@
 #include "shore_field.h"
 #include "shore_index.h"
 #include "shore_row.h"
+#include "shore_rec_cache.h"
+#include "shore_log_profile.h"
 
 
 ENTER_NAMESPACE(shore);
@@ -141,6 +143,15 @@ protected:
     uint   _sMaxKeyLen;
     uint  _numParts;
 
+    // Hot-key record cache (for read-mostly tables)
+    uint_t _rc_slots;                    // 0 - no record cache
+    bool   _read_only;                   // never updated by the workload
+
+    // Bumped by every write through the table manager, if some cache
+    // keeps track of the versions
+    volatile uint32_t _version;
+    static bool _track_versions;
+
     int find_field_by_name(const char* field_name) const;
 
 public:
@@ -175,6 +186,39 @@ public:
     w_rc_t get_main_rangemap(key_ranges_map*& prangemap);
 
 
+    /* ------------------------------------------------ */
+    /* --- hot-key record cache, read-mostly tables --- */
+    /* ------------------------------------------------ */
+
+    // @note: Should be set at the table constructor, before the
+    //        table manager is constructed
+    void set_rec_cache(const uint_t slots, const bool bReadOnly=false) {
+        _rc_slots = slots;
+        _read_only = bReadOnly;
+    }
+    uint_t rec_cache_slots() const { return (_rc_slots); }
+    bool   is_read_only() const { return (_read_only); }
+
+
+    /* --------------------- */
+    /* --- table version --- */
+    /* --------------------- */
+
+    // @note: Changes with every insert, update and delete of a tuple. The
+    //        QPipe result and build caches compare it with the version
+    //        they saw when they cached a result that read this table.
+    //        Those caches turn the tracking on when they are enabled;
+    //        otherwise the writes do not touch the (shared) version.
+    uint32_t version() const { return (_version); }
+    volatile uint32_t const* version_ptr() const { return (&_version); }
+    inline void bump_version() { 
+        if (_track_versions) atomic_inc_32(&_version); 
+    }
+
+    static void set_track_versions(const bool track) { _track_versions = track; }
+    static bool track_versions() { return (_track_versions); }
+
+
     /* ----------------------------------------- */
     /* --- create physical table and indexes --- */
     /* ----------------------------------------- */
@@ -205,6 +249,13 @@ public:
                                    const uint num,
                                    const uint4_t& pd=PD_NORMAL);
 
+    // makes an index covering: its entries carry also the given fields,
+    // which should be of fixed length and not nullable. Should be called
+    // after the index is created, before the table is loaded.
+    w_rc_t set_index_payload(const char* idx_name,
+                             const uint* fields,
+                             const uint num);
+
 
 
     /* ------------------------ */
@@ -266,6 +317,32 @@ typedef std::list<table_desc_t*> table_list_t;
 
 
 
+/* ---------------------------------------------------------------
+ *
+ * @class: version_bump_t
+ *
+ * @brief: Bumps the version of a table when it goes out of scope,
+ *         that is after the write of the table manager operation
+ *         that declares it, whichever way that returns.
+ *
+ * --------------------------------------------------------------- */
+
+class version_bump_t
+{
+    table_desc_t* _ptable;
+
+public:
+    version_bump_t(table_desc_t* ptable) : _ptable(ptable) { }
+    ~version_bump_t() { _ptable->bump_version(); }
+
+}; // EOF: version_bump_t
+
+
+class bulk_loader_t;
+class load_cache_t;
+
+
+
 /* ---------------------------------------------------------------
  *
  * @class: table_man_t
@@ -282,19 +359,55 @@ protected:
 
     guard<ats_char_t> _pts;   /* trash stack */
 
+    guard<rec_cache_t> _prc;  /* hot-key record cache, if read-mostly */
+
+    std::vector<offset_t> _fixed_off; /* field offsets, if fixed-layout */
+
+    bulk_loader_t* _pbulk;    /* set while bulk loading */
+
+    load_cache_t* _pcache;    /* set while capturing the load */
+
+    log_counter_t _log_ops[LOP_COUNT]; /* log profile per operation */
+
+    w_rc_t _add_index_entries(ss_m* db,
+                              table_tuple* ptuple,
+                              const bool bIgnoreLocks,
+                              const lpid_t& primary_root);
+
+    bool _has_dirty_payloads(table_tuple* ptuple);
+
+    w_rc_t _copy_record(const rid_t& rid,
+                        const lock_mode_t lock_mode,
+                        rep_row_t& arep);
+
+    w_rc_t _update_payloads(ss_m* db,
+                            table_tuple* ptuple,
+                            const lock_mode_t lock_mode,
+                            const bool bIgnoreLocks);
+
 public:
 
     typedef table_row_t table_tuple; 
 
     table_man_t(table_desc_t* aTableDesc,
 		bool construct_cache=true) 
-        : _ptable(aTableDesc)
+        : _ptable(aTableDesc), _pbulk(NULL), _pcache(NULL)
     {
 	// init tuple cache
         if (construct_cache) {
             // init trash stack            
             _pts = new ats_char_t(_ptable->maxsize());
         }
+
+        // init record cache
+        if (_ptable->rec_cache_slots()) {
+            _prc = new rec_cache_t(_ptable->rec_cache_slots(), 
+                                   _ptable->maxsize());
+            if (!_ptable->is_read_only()) {
+                CRITICAL_SECTION(regtablecs,register_table_lock);
+                rec_caches_rw.push_back(_prc.get());
+            }
+        }
     }
 
     virtual ~table_man_t() {}
@@ -317,6 +430,49 @@ public:
     ats_char_t* ts() { assert (_pts); return (_pts); }
 
 
+    /* -------------------------- */
+    /* --- record cache stats --- */
+    /* -------------------------- */
+
+    rec_cache_t* rc() { return (_prc); }
+
+    // prints the stats of the record caches of all the registered tables
+    static void print_rec_cache_stats();
+    static void reset_rec_cache_stats();
+
+    // invalidates the record caches of all the registered tables
+    static void invalidate_rec_caches();
+
+    // The record caches of the tables that may be updated. On abort they
+    // are invalidated, since they may have been filled with rolled back data.
+    static std::vector<rec_cache_t*> rec_caches_rw;
+    static void rec_cache_on_abort();
+
+
+    /* ------------------- */
+    /* --- log profile --- */
+    /* ------------------- */
+
+    // prints the log profile of all the registered tables
+    // (see shore_log_profile.h)
+    static void print_log_stats();
+    static void reset_log_stats();
+
+
+    /* ----------------- */
+    /* --- bulk load --- */
+    /* ----------------- */
+
+    // While set, add_tuple() appends only the record and passes the
+    // index entries to the bulk loader (see shore_bulk_loader.h)
+    void set_bulk_loader(bulk_loader_t* pbl) { _pbulk = pbl; }
+    bool is_bulk_loading() const { return (_pbulk != NULL); }
+
+    // While set, add_tuple() also passes the formatted record to the
+    // load cache (see shore_load_cache.h)
+    void set_load_cache(load_cache_t* pcache) { _pcache = pcache; }
+
+
     /* ---------------------------- */
     /* --- access through index --- */
     /* ---------------------------- */
@@ -346,6 +502,14 @@ public:
         return (index_probe(db, pidx, ptuple, NL, root));
     }
 
+    // idx probe, which returns only the key and the payload fields
+    // of a covering index, without pinning the record
+    w_rc_t index_probe_covered(ss_m* db,
+                               index_desc_t* pidx,
+                               table_tuple*  ptuple,
+                               const lock_mode_t lock_mode = SH,
+                               const lpid_t& root = lpid_t::null);
+
     // probe primary idx
     inline w_rc_t   index_probe_primary(ss_m* db, 
                                         table_tuple* ptuple, 
@@ -401,6 +565,14 @@ public:
                         const lock_mode_t   lock_mode = EX,
                         const lpid_t& primary_root = lpid_t::null);
 
+    // Inserts an already formatted record, e.g. out of the load cache
+    w_rc_t    add_formatted(ss_m* db, 
+                            table_tuple*  ptuple, 
+                            const char* rec,
+                            const uint_t recsz,
+                            const lock_mode_t   lock_mode = EX,
+                            const lpid_t& primary_root = lpid_t::null);
+
     w_rc_t    add_index_entry(ss_m* db,
 			      const char* idx_name,
 			      table_tuple* ptuple, 
@@ -430,12 +602,65 @@ public:
                            table_tuple* ptuple, 
                            const lock_mode_t lock_mode = EX);
 
+    // Direct access through the rid, writes only the fields set since
+    // the tuple was loaded (see table_row_t::is_dirty())
+    w_rc_t    update_dirty(ss_m* db, 
+                           table_tuple* ptuple, 
+                           const lock_mode_t lock_mode = EX);
+
     // Direct access through the rid
     w_rc_t    read_tuple(table_tuple* ptuple, 
                          lock_mode_t lock_mode = SH,
 			 latch_mode_t heap_latch_mode = LATCH_SH);
 
 
+
+    /* --------------------------------------------- */
+    /* --- fixed-layout (zero-copy) row accesses --- */
+    /* --------------------------------------------- */
+
+    // @note: Usable only by tables whose fields are all of fixed length
+    //        and not nullable. The disk format of such a record is the
+    //        packed concatenation of its fields, thus the record can be
+    //        accessed as a packed struct (see shore_fixed_row.h) without
+    //        going through load()/format().
+
+    // Returns true if the table can be accessed as a fixed-layout
+    // record of size recsz, and sets up the field offsets
+    bool   set_fixed_layout(const uint_t recsz);
+    bool   is_fixed_layout() const { return (!_fixed_off.empty()); }
+
+    // idx probe, copies the record as-is to rec
+    w_rc_t index_probe_fixed(ss_m* db,
+                             index_desc_t* pidx,
+                             char*         rec,
+                             const uint_t  recsz,
+                             rid_t&        rid,
+                             lock_mode_t   lock_mode = SH,
+                             const lpid_t& root = lpid_t::null);
+
+    // updates in place only the len bytes at offset of the record
+    w_rc_t update_fixed(ss_m* db,
+                        const rid_t&  rid,
+                        const char*   rec,
+                        const uint_t  offset,
+                        const uint_t  len,
+                        const lock_mode_t lock_mode = EX);
+
+    // inserts the record and its entries to all the indexes
+    w_rc_t add_fixed(ss_m* db,
+                     const char*   rec,
+                     const uint_t  recsz,
+                     rid_t&        rid,
+                     const lock_mode_t lock_mode = EX,
+                     const lpid_t& primary_root = lpid_t::null);
+
+    // format the key value straight from a fixed-layout record
+    int  format_key_fixed(index_desc_t* pindex, const char* rec, 
+                          rep_row_t& arep);
+    int  get_pnum_fixed(index_desc_t* pindex, const char* rec) const;
+
+
     
     /* ----------------------------- */
     /* --- formatting operations --- */
@@ -474,6 +699,21 @@ public:
     int  key_size(index_desc_t* pindex, 
                   const table_tuple* ptuple) const;
 
+    // format the element of an index entry: the rid and, if the index
+    // is covering, the payload fields (from the row or from a record)
+    int  format_el(index_desc_t* pindex, 
+                   const table_tuple* ptuple, 
+                   char* el) const;
+    int  format_el(index_desc_t* pindex, 
+                   const rid_t& rid, 
+                   const char* rec, 
+                   char* el) const;
+
+    // load the rid and the payload fields from an index element
+    void load_el(index_desc_t* pindex, 
+                 table_tuple* ptuple, 
+                 const char* el);
+
 
 
 
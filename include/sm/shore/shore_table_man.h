@@ -381,21 +381,24 @@ public:
 
             vec_t    key(tuple._rep->_dest, key_sz);
 
-            rid_t    rid;
-            vec_t    record(&rid, sizeof(rid_t));
+            // the element of a covering index carries also the payload
+            char     el[MAX_INDEX_EL];
+            vec_t    record(el, index_iter::_file->el_size());
             smsize_t klen = 0;
-            smsize_t elen = sizeof(rid_t);
+            smsize_t elen = index_iter::_file->el_size();
 
             W_DO(index_iter::_scan->curr(&key, klen, &record, elen));
-            tuple.set_rid(rid);
+            _pmanager->load_el(index_iter::_file, &tuple, el);
             
             _pmanager->load_key((const char*)key.ptr(0), 
                                 index_iter::_file, &tuple);
             //tuple.load_key(key.ptr(0), _file);
 
+            // the payload fields of a covering index are already loaded,
+            // the rest of the fields only if the tuple is needed
             if (_need_tuple) {
                 pin_i  pin;
-                W_DO(pin.pin(rid, 0, index_iter::_lm, index_iter::_file->is_latchless()));
+                W_DO(pin.pin(tuple.rid(), 0, index_iter::_lm, index_iter::_file->is_latchless()));
                 if (!_pmanager->load(&tuple, pin.body())) {
                     pin.unpin();
                     return RC(se_WRONG_DISK_DATA);
@@ -34,6 +34,8 @@
 #define __SHORE_TRX_WORKER_H
 
 
+#include <map>
+
 #include "sm/shore/srmwqueue.h"
 #include "sm/shore/shore_reqs.h"
 #include "sm/shore/shore_worker.h"
@@ -52,6 +54,28 @@ ENTER_NAMESPACE(shore);
 
 const int REQUESTS_PER_WORKER_POOL_SZ = 60;
 
+
+/**
+   All the xcts insert their log records to the single log buffer of the 
+   SM, and every insert reserves its log space separately. With
+   db-log-consolidate=1 each worker keeps a running estimate of the log 
+   volume of each xct type it executes, and reserves it with a single 
+   call when the xct begins, so that the xct does not go back to the 
+   reservation path for each of its records. The actual volume (from the 
+   SM per-thread stats) updates the estimate after each xct.
+
+   The inserts themselves are consolidated by the SM (the C-Array and
+   decoupled copy features set by the "log" shell command, or at start by
+   db-log-features). The worker stats report the log bytes of each worker 
+   and the time spent in the reservations, so that runs with and without 
+   the consolidation can be compared.
+
+   The up-front reservation needs the log space reservation API of
+   Shore-6 (USE_SHORE_6). Otherwise only the log volume is reported.
+*/
+
+const int LOG_ESTIMATE_HISTORY = 8;  // weight of the past in the estimate
+
 class trx_worker_t : public base_worker_t
 {
 public:
@@ -63,6 +87,10 @@ private:
     guard<Queue>         _pqueue;
     guard<Pool>          _actionpool;
 
+    // db-log-consolidate, and the log volume estimate per xct type
+    bool                 _log_consolidate;
+    std::map<int,long>   _log_estimate;
+
     // states
     int _work_ACTIVE_impl(); 
 
@@ -0,0 +1,124 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_warmup.h
+ *
+ *  @brief:  Parallel warmup of the buffer pool
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   The warmup brings the database to the buffer pool before a measurement.
+   The stores of all the registered tables (the heap file of each table and
+   each partition of each index) are the warmup units. The indexes come
+   first, since their pages are the ones touched by every probe.
+
+   db-warmup-threads threads take units from a common list. A heap file is
+   read page by page, in file order and with the scan prefetching enabled,
+   so that the SM reads ahead while the page just read is being pinned. An
+   index partition is read by a cursor over all its entries, which brings
+   its leaf pages in key order. A unit that fails is reported and skipped. The
+   number of pages read so far is reported as a percentage of the buffer
+   pool every second. The warmup stops as soon as the buffer pool is full,
+   since reading more pages would only evict the ones already read.
+*/
+
+#ifndef __SHORE_WARMUP_H
+#define __SHORE_WARMUP_H
+
+#include "sm/shore/shore_table.h"
+
+
+ENTER_NAMESPACE(shore);
+
+
+const int WARMUP_THREADS   = 8;     // db-warmup-threads
+const int WARMUP_CHECK_CNT = 256;   // pages read between two fullness checks
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: warmup_t
+ *
+ * @brief: Reads the stores of the registered tables to the buffer
+ *         pool with many threads
+ *
+ * --------------------------------------------------------------- */
+
+class warmup_t
+{
+public:
+
+    // One store to be read
+    struct unit_t {
+        table_desc_t* _ptable;
+        index_desc_t* _pidx;     // NULL for the heap file
+        int           _pnum;
+        stid_t        _fid;
+    };
+
+private:
+
+    ss_m*               _db;
+    std::vector<unit_t> _units;
+
+    volatile uint_t     _next;      // next unit to be read
+    volatile uint_t     _pages;     // pages read so far
+    volatile uint_t     _done;      // threads finished
+    volatile uint_t     _failed;    // units skipped on an error
+    uint_t              _bp_pages;  // capacity of the buffer pool
+    uint_t              _page_size;
+
+    w_rc_t _read_unit(const unit_t& u);
+    w_rc_t _read_heap(const unit_t& u, uint_t& cnt);
+    w_rc_t _read_index(const unit_t& u, uint_t& cnt);
+
+public:
+
+    warmup_t(ss_m* db);
+    ~warmup_t() { }
+
+    // Adds the stores of all the registered tables
+    void add_registered_tables();
+
+    // Reads the stores with the given number of threads
+    w_rc_t run(const int threads);
+
+    // Thread entrance
+    w_rc_t read_units();
+
+    // A buffer pool of unknown size (0) is never full
+    inline bool is_full() const { return (_bp_pages && (*&_pages >= _bp_pages)); }
+    inline double warm_pct() const {
+        return ((_bp_pages ? (100.0*(*&_pages))/(double)_bp_pages : 0));
+    }
+
+}; // EOF: warmup_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_WARMUP_H */
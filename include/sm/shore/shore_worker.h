@@ -87,6 +87,11 @@ struct worker_stats_t
     uint _early_aborts;
     uint _mid_aborts;
 
+    // log generated, and waiting to reserve log space at xct begin
+    uint64_t  _log_bytes;
+    uint      _log_reserves;
+    long long _log_reserve_us;
+
 #ifdef WORKER_VERBOSE_STATS
     void update_served(const double serve_time_ms);
     double _serving_total;   // in msecs
@@ -112,7 +117,8 @@ struct worker_stats_t
         : _processed(0), _problems(0),
           _served_input(0), _served_waiting(0),
           _condex_sleep(0), _failed_sleep(0),
-          _early_aborts(0), _mid_aborts(0)
+          _early_aborts(0), _mid_aborts(0),
+          _log_bytes(0), _log_reserves(0), _log_reserve_us(0)
 #ifdef WORKER_VERBOSE_STATS
         , _serving_total(0), 
           _rvp_exec(0), _rvp_exec_time(0), _rvp_notify_time(0), 
@@ -183,6 +183,27 @@ struct srmwqueue
         }
     }
 
+    // pushes a batch of actions, locking and waking the owner only once
+    template <class InputAction>
+    inline void push_batch(InputAction** as, const uint_t n, const bool bWake) {
+        if (n==0) return;
+        int queue_sz;
+
+        // push actions
+        {
+            CRITICAL_SECTION(cs, _lock);
+            for (uint_t i=0; i<n; ++i) {
+                _for_writers->push_back(static_cast<Action*>(as[i]));
+            }
+            _empty = false;
+            queue_sz = _for_writers->size();
+        }
+
+        if ((queue_sz >= _thres) || bWake) {        
+            _owner->set_ws(_my_ws);
+        }
+    }
+
     // resets queue
     void clear(const bool removeOwner=true) {
         CRITICAL_SECTION(q_cs, _lock);
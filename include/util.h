@@ -56,6 +56,7 @@
 #include "util/w_strlcpy.h"
 #include "util/procstat.h"
 #include "util/skewer.h"
+#include "util/fcopy.h"
 
 #ifdef HAVE_CPUMON
 #ifdef HAVE_GLIBTOP
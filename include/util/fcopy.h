@@ -0,0 +1,65 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   fcopy.h
+ *
+ *  @brief:  Fast copies of (large, sparse) files and directories, used
+ *           for taking snapshots of the database device and log.
+ *           All the functions return 0 on success.
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#ifndef __UTIL_FCOPY_H
+#define __UTIL_FCOPY_H
+
+
+/* exported constants */
+
+#define FCOPY_BLOCK_SIZE        (1<<20)
+#define FCOPY_ERROR_OPEN        -1
+#define FCOPY_ERROR_READ        -2
+#define FCOPY_ERROR_WRITE       -3
+#define FCOPY_ERROR_DIRECTORY   -4
+
+
+/* exported functions */
+
+// Copies src to dst. If the filesystem supports it, dst is a reflink
+// (copy-on-write clone) of src. Otherwise, the file is copied in blocks
+// by the given number of threads, and the all-zero blocks are skipped,
+// so that dst is as sparse as src.
+int fcopy_file(const char* src, const char* dst, const int threads);
+
+// Copies all the regular files of srcdir to dstdir, which is created
+// if it does not exist
+int fcopy_dir(const char* srcdir, const char* dstdir, const int threads);
+
+// Removes all the regular files of dir
+int fcopy_clear_dir(const char* dir);
+
+// Removes all the regular files of dir and then dir itself
+int fcopy_remove_dir(const char* dir);
+
+
+#endif /* __UTIL_FCOPY_H */
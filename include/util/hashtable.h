@@ -25,6 +25,9 @@
 #define __UTIL_HASHTABLE_H
 
 #include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <stdint.h>
 #include <utility>
 #include "util/guard.h"
 
@@ -33,31 +36,47 @@ using std::pair;
 
 
 /**
- * @brief A generic RAII guard class.
+ * @brief An open-addressing hash table with linear probing, over
+ * entries that live elsewhere (typically pointers to tuples stored in
+ * qpipe pages).
  *
- * This class ensures that the object it encloses will be properly
- * disposed of when it goes out of scope, or with an explicit call to
- * done(), whichever comes first.
+ * Each slot holds the entry next to a 32-bit tag of the hash of its
+ * key. A probe compares the tags first and calls EqualKey only when
+ * they match, thus a miss rarely touches the tuple itself, and the
+ * slots of a probe sequence are contiguous in memory.
  *
- * This class is much like the auto_ptr class, other than allowing
- * actions besides delete upon destruct. In particular it is *NOT
- * SAFE* to use it in STL containers because it does not fulfill the
- * Assignable concept.
- *
- * TODO: make generic and configurable (ie, use templates to determine
- * what "null" and "action" are)
+ * The capacity is a power of two, so that a slot is picked with a
+ * mask instead of a division. The table is sized from the expected
+ * number of entries (e.g. a cardinality hint or the exact number of
+ * build tuples of a join) and doubles when it becomes more than 3/4
+ * full, thus there is always an empty slot that ends a probe.
  *
+ * The table never copies the keys, the entries point to tuples that
+ * hold them (e.g. the aggregate tuples of the hash aggregate, which
+ * keep the key and the aggregate state inline in their pages).
  */
 template <class Data, class Key, class ExtractKey, class EqualKey, class EqualData, class HashFcn>
 class hashtable {
-    
+
+public:
+
+    // The smallest table
+    static const size_t MIN_CAPACITY = 16;
+
 private:
 
+    /* A slot. A tag of zero marks an empty slot, thus the tag of an
+       entry always has its high bit set. */
+    struct slot_t {
+        uint32_t _tag;
+        Data     _data;
+    };
+
     /* the table */
-    int _capacity;
-    int _size;
-    array_guard_t<Data>  _data;
-    array_guard_t<bool>  _exists;
+    size_t _capacity;
+    size_t _mask;
+    size_t _size;
+    array_guard_t<slot_t> _slots;
     
     /* key-value functors */
     ExtractKey _extractkey;
@@ -66,160 +85,223 @@ private:
     HashFcn    _hashfcn;
 
 
+    static uint32_t _tag_of(size_t hash_code) {
+        return ((uint32_t)hash_code) | 0x80000000;
+    }
+
+    /* The first slot that is either empty or holds an entry that
+       matches, as given by 'match'. */
+    template <class Match>
+    size_t _probe(uint32_t tag, Match match) const {
+        size_t pos = tag & _mask;
+        while (_slots[pos]._tag) {
+            if ((_slots[pos]._tag == tag) && match(_slots[pos]._data))
+                return pos;
+            pos = (pos + 1) & _mask;
+        }
+        return pos;
+    }
+
+    /* Puts an entry to the first empty slot of its probe sequence. */
+    void _place(uint32_t tag, Data d) {
+        size_t pos = tag & _mask;
+        while (_slots[pos]._tag)
+            pos = (pos + 1) & _mask;
+        _slots[pos]._tag  = tag;
+        _slots[pos]._data = d;
+        _size++;
+    }
+
+    void _grow_for(size_t n) {
+        if (n > max_size(_capacity))
+            rehash(capacity_for(n));
+    }
+
+    struct match_key_t {
+        const hashtable* _parent;
+        Key const*       _key;
+        match_key_t(const hashtable* parent, Key const& key)
+            : _parent(parent), _key(&key) { }
+        bool operator()(Data const& d) const {
+            return _parent->_equalkey(*_key, _parent->_extractkey(d));
+        }
+    };
+
+    struct match_data_t {
+        const hashtable* _parent;
+        Data const*      _data;
+        match_data_t(const hashtable* parent, Data const& data)
+            : _parent(parent), _data(&data) { }
+        bool operator()(Data const& d) const {
+            return _parent->_equaldata(*_data, d);
+        }
+    };
+
+    struct match_none_t {
+        bool operator()(Data const&) const { return false; }
+    };
+
+
 public:
     
    
-    hashtable(int capacity, ExtractKey extractkey,
+    /**
+     * @brief Creates a table for 'expected' entries, which grows if
+     * more are inserted.
+     */
+    hashtable(size_t expected, ExtractKey extractkey,
               EqualKey equalkey, EqualData equaldata, HashFcn hashfcn)
-        : _capacity(capacity)
+        : _capacity(capacity_for(expected))
+        , _mask(_capacity - 1)
         , _size(0)
-        , _data(new Data[capacity])
-        , _exists(new bool[capacity])
+        , _slots(new slot_t[_capacity])
         , _extractkey(extractkey)
         , _equalkey(equalkey)
         , _equaldata(equaldata)
         , _hashfcn(hashfcn)
     {
-        /* initialize _exists */
-        for (int i = 0; i < capacity; i++) {
-	    _exists[i] = false;
+        clear();
+    }
+
+
+    /**
+     * @brief The capacity of a table that holds 'n' entries without
+     * growing: the smallest power of two that keeps it at most 3/4
+     * full.
+     */
+    static size_t capacity_for(size_t n) {
+        size_t capacity = MIN_CAPACITY;
+        while (max_size(capacity) < n)
+            capacity <<= 1;
+        return capacity;
+    }
+
+    static size_t max_size(size_t capacity) {
+        return (capacity >> 1) + (capacity >> 2);
+    }
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    size_t bytes() const { return _capacity * sizeof(slot_t); }
+
+    size_t hash(Key const& k) const { return _hashfcn(k); }
+
+
+    /**
+     * @brief Resizes the table to 'capacity' slots (a power of two
+     * that fits the current entries). The tags are kept, thus the
+     * keys are not hashed again.
+     */
+    void rehash(size_t capacity) {
+        assert((capacity & (capacity - 1)) == 0);
+        assert(max_size(capacity) >= _size);
+
+        array_guard_t<slot_t> old = _slots.release();
+        size_t old_capacity = _capacity;
+
+        _capacity = capacity;
+        _mask = capacity - 1;
+        _slots = new slot_t[capacity];
+        clear();
+
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old[i]._tag)
+                _place(old[i]._tag, old[i]._data);
         }
     }
 
+
+    /**
+     * @brief Makes room for 'n' entries in total, so that inserting
+     * them does not rehash.
+     */
+    void reserve(size_t n) {
+        _grow_for(n);
+    }
+
     
     /**
-     * @brief 
+     * @brief Inserts an entry, even if an entry with an equal key
+     * exists. 'hash_code' is the hash() of the key of the entry.
+     *
+     * @return The stored entry.
      */
-    void insert_noresize(Data d) {
-        
-        /* Check for space. */
-        assert(_size < _capacity);
-        size_t hash_code = _hashfcn(_extractkey(d));
-        int hash_pos = (int)(hash_code % (size_t)_capacity);
-
-        /* Linear probing */
-        int pos;
-        /* Loop 1: Probe until we find empty slot or hit the end of
-           the array. */
-        for (pos = hash_pos;
-             (pos < _capacity) && _exists[pos]; pos++);
-        if (pos == _capacity) {
-            /* Reached end of table with no slot. */
-            /* Loop 2: Continue probing from beginning of array. */
-            for (pos = 0;
-                 (pos < _capacity) && _exists[pos]; pos++);
-        }
-        /* At this point, we had better have stopped because we found
-           an empty slot. We already verified at the start of the
-           function that there is space available. */
-        assert(pos != _capacity);
-        assert(! _exists[pos] );
-
-        _data[pos] = d;
-        _exists[pos] = true;
+    Data* insert_equal(Data d, size_t hash_code) {
+        _grow_for(_size + 1);
+        uint32_t tag = _tag_of(hash_code);
+        size_t pos = _probe(tag, match_none_t());
+        _slots[pos]._tag  = tag;
+        _slots[pos]._data = d;
         _size++;
+        return &_slots[pos]._data;
     }
-        
+
+    Data* insert_equal(Data d) {
+        return insert_equal(d, _hashfcn(_extractkey(d)));
+    }
+
 
     /**
-     * @brief 
+     * @brief Inserts an entry, unless an equal entry (as given by
+     * EqualData) exists.
+     *
+     * @return true if the entry was inserted.
      */
-    bool insert_unique_noresize(Data d) {
-        
-        /* Don't check for free space! */
-        size_t hash_code = _hashfcn(_extractkey(d));
-        int hash_pos = (int)(hash_code % (size_t)_capacity);
-
-        int pos;
-        /* Linear probing */
-        /* Loop 1: Probe until we find empty slot, find a copy, or hit
-           the end of the array. */
-        for (pos = hash_pos;
-             (pos < _capacity)
-                 && _exists[pos]
-                 && !_equaldata(_data[pos],d); pos++);
-        if (pos == _capacity) {
-            /* Reached end of table with no slot. */
-            /* Loop 2: Continue probing from beginning of array. */
-            for (pos = hash_pos;
-                 (pos < _capacity)
-                     && _exists[pos]
-                     && !_equaldata(_data[pos],d); pos++);
-        }
+    bool insert_unique(Data d) {
+        _grow_for(_size + 1);
+        uint32_t tag = _tag_of(_hashfcn(_extractkey(d)));
+        size_t pos = _probe(tag, match_data_t(this, d));
+        if (_slots[pos]._tag)
+            return false;
+        _slots[pos]._tag  = tag;
+        _slots[pos]._data = d;
+        _size++;
+        return true;
+    }
 
-        /* At this point, we may have reached the end of the array
-           again (since we did not check for free space at the
-           beginning). We have dealt with this kind of this with an
-           assert() before... */
-        assert(pos != _capacity);
-        
-        if (!_exists[pos]) {
-            /* Found an empty slot. Insert here. */
-            _data[pos] = d;
-            _exists[pos] = true;
-            _size++;
-            return true;
-        }
 
-        
-        /* If we are here, we must have found a copy of the data. */
-        assert( _equaldata(_data[pos],d) );
-        return false;
+    /**
+     * @brief The first entry with key 'k', or NULL. 'hash_code' is
+     * the hash() of 'k'.
+     */
+    Data* find(Key const& k, size_t hash_code) {
+        size_t pos = _probe(_tag_of(hash_code), match_key_t(this, k));
+        return (_slots[pos]._tag ? &_slots[pos]._data : NULL);
+    }
+
+    Data* find(Key const& k) {
+        return find(k, _hashfcn(k));
     }
 
 
     /**
      * @brief Check for the specified data.
      */
-    bool contains(Data d) {
-
-        /* Don't check for free space! */
-        size_t hash_code = _hashfcn(_extractkey(d));
-        int hash_pos = (int)(hash_code % (size_t)_capacity);
-
-        int pos;
-        /* Linear probing */
-        /* Loop 1: Probe until we find empty slot, find a copy, or hit
-           the end of the array. */
-        for (pos = hash_pos;
-             (pos < _capacity)
-                 && _exists[pos]
-                 && !_equaldata(_data[pos],d); pos++);
-        if (pos == _capacity) {
-            /* Reached end of table with no slot. */
-            /* Loop 2: Continue probing from beginning of array. */
-            for (pos = hash_pos;
-                 (pos < _capacity)
-                     && _exists[pos]
-                     && !_equaldata(_data[pos],d); pos++);
-        }
+    bool contains(Data d) const {
+        uint32_t tag = _tag_of(_hashfcn(_extractkey(d)));
+        return (_slots[_probe(tag, match_data_t(this, d))]._tag != 0);
+    }
 
-        if (pos == _capacity) {
-            /* table is full and still does not contain 'd' */
-            return false;
-        }
-        
-        if (!_exists[pos]) {
-            /* Found an empty slot. Table does not contain data. */
-            return false;
-        }
 
-        /* If we are here, we have found a copy of the data. */        
-        assert(_equaldata(_data[pos],d));
-        return true;
+    /**
+     * @brief The entry at slot 'pos' (0 to capacity()-1), or NULL if
+     * the slot is empty. Used to visit all the entries.
+     */
+    Data* get(size_t pos) {
+        return (_slots[pos]._tag ? &_slots[pos]._data : NULL);
     }
 
 
     void clear() {
-        for (int i = 0; i < _capacity; i++)
-            _exists[i] = false;
+        for (size_t i = 0; i < _capacity; i++)
+            _slots[i]._tag = 0;
         _size = 0;
     }
 
 
     /**
-     *  @brief Iterator over the tuples in this page. Each dereference
-     *  returns a tuple_t.
+     *  @brief Iterator over the entries with a given key, as
+     *  returned by equal_range().
      */
 
     class iterator {
@@ -229,17 +311,33 @@ public:
         /* the enclosing hash table */
         hashtable* _parent;
         
-        /* the data we use for equal_range() */
-        Key _key;
+        /* the key we search for, and its tag */
+        Key      _key;
+        uint32_t _tag;
 
-        /* iterator position management */
-        int  _start_index;
-        int  _curr_index;
+        /* iterator position */
+        size_t _curr_index;
 
         /* For checking whether an iterator is equal to the END
            iterator. */
         bool _is_end;
 
+
+        /* Stops at the first matching entry at or after
+           '_curr_index', or at END on an empty slot. */
+        void _seek(size_t curr) {
+            while (_parent->_slots[curr]._tag) {
+                if ((_parent->_slots[curr]._tag == _tag)
+                    && _parent->_equalkey(_key, _parent->_extractkey(_parent->_slots[curr]._data)))
+                {
+                    _curr_index = curr;
+                    return;
+                }
+                curr = (curr + 1) & _parent->_mask;
+            }
+            _is_end = true;
+        }
+
         
     public:
 
@@ -255,27 +353,14 @@ public:
 	{
 	}
 
-        iterator(hashtable* parent, Key const& key, int start_index)
+        iterator(hashtable* parent, Key const& key, size_t hash_code)
             : _parent(parent)
             , _key(key)
-            , _start_index(start_index)
-            , _curr_index(start_index)
+            , _tag(hashtable::_tag_of(hash_code))
+            , _curr_index(0)
             , _is_end(false)
         {
-            /* If there is no data at this location, immediately END. */
-            if (!parent->_exists[start_index]) {
-                _is_end = true;
-                return;
-            }
-            
-            /* If the data here has a key equal to the key we are
-               searching for, stay here. */
-            if (parent->_equalkey(key, parent->_extractkey(parent->_data[start_index])))
-                return;
-            
-            /* Otherwise, use ++ to advance to the first key that does
-               match (or go to END). */
-            ++*this;
+            _seek(_tag & parent->_mask);
         }
 
         bool operator ==(const iterator &other) const {
@@ -289,14 +374,7 @@ public:
             /* This should only be used on iterators from the same
                table. */
             assert(_parent == other._parent);
-
-            /* Iterators should be at the same position, searching for
-               the same key. */
-            return
-                   _start_index == other._start_index
-                && _curr_index  == other._curr_index
-                && _parent->_equalkey(_key, other._key)
-                ;
+            return (_curr_index == other._curr_index);
         }
 
         bool operator !=(const iterator &other) const {
@@ -312,50 +390,14 @@ public:
 	}
 
 	Data* get() {
-            /* Make sure we did not wrap. */
             assert(!_is_end);
-          
-            if (0) {
-                TRACE(TRACE_ALWAYS, "Looking at data %s stored at position %d\n",
-                      _parent->_data[_curr_index],
-                      _curr_index);
-            }
-
-            return &_parent->_data[_curr_index];
+            return &_parent->_slots[_curr_index]._data;
         }
 
         iterator &operator ++() {
-
             assert(!_is_end);
-
-            int curr = _curr_index;
-            while (1) {
-                
-                /* Continue to increment 'curr' (allowing for
-                   wrapping). We can stop if parent's entry at 'curr'
-                   is equal to our key. We enter the END state if the
-                   parent stores nothing at 'curr' or if 'curr' wraps
-                   back to '_start_index'. */
-		if(++curr == _parent->_capacity)
-		    curr = 0;
-
-                /* check for end cases */
-                if (!_parent->_exists[curr]) {
-                    _is_end = true;
-                    return *this;
-                }
-                
-                if (curr == _start_index) {
-                    /* wrapped to the beginning of the table */
-                    _is_end = true;
-                    return *this;
-                }
-
-                if (_parent->_equalkey(_key, _parent->_extractkey(_parent->_data[curr]))) {
-                    _curr_index = curr;
-                    return *this;
-                }
-            }
+            _seek((_curr_index + 1) & _parent->_mask);
+            return *this;
         }
 
         iterator operator ++(int) {
@@ -367,9 +409,7 @@ public:
     
     
     std::pair<iterator, iterator> equal_range(Key const& k) {
-        size_t hash_code = _hashfcn(k);
-        int hash_pos = (int)(hash_code % (size_t)_capacity);
-        return std::make_pair(iterator(this, k, hash_pos), iterator(this));
+        return std::make_pair(iterator(this, k, _hashfcn(k)), iterator(this));
     }
 
 };
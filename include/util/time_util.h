@@ -64,5 +64,69 @@ time_t time_day_end(time_t t);
 
 
 
+/** Compact dates (the SQL_DATE type)
+ *
+ *  A date is stored as an int, the number of days since 1970-01-01 in the
+ *  proleptic Gregorian calendar. Two dates compare as ints, and the day,
+ *  month and year are extracted with integer arithmetic only.
+ *
+ *  The conversions from and to time_t are in local time, as the ones of
+ *  str_to_timet(): date_to_timet(str_to_date(s)) == str_to_timet(s).
+ */
+
+// Days since 1970-01-01 of year y, month m (1-12), day d (1-31)
+inline int ymd_to_date(int y, const int m, const int d)
+{
+    y -= (m <= 2);
+    const int era = (y >= 0 ? y : y-399) / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153*(m + (m > 2 ? -3 : 9)) + 2)/5 + d-1;
+    const int doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+    return (era * 146097 + doe - 719468);
+}
+
+inline void date_to_ymd(int date, int& y, int& m, int& d)
+{
+    date += 719468;
+    const int era = (date >= 0 ? date : date - 146096) / 146097;
+    const int doe = date - era * 146097;
+    const int yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+    const int doy = doe - (365*yoe + yoe/4 - yoe/100);
+    const int mp = (5*doy + 2)/153;
+    d = doy - (153*mp+2)/5 + 1;
+    m = mp + (mp < 10 ? 3 : -9);
+    y = yoe + era * 400 + (m <= 2);
+}
+
+inline int date_year(const int date)
+{
+    int y, m, d;
+    date_to_ymd(date, y, m, d);
+    return (y);
+}
+
+// From/to a string in format YYYY-MM-DD, without sscanf() and mktime()
+inline int str_to_date(char const* str)
+{
+    return (ymd_to_date((str[0]-'0')*1000 + (str[1]-'0')*100 +
+                        (str[2]-'0')*10 + (str[3]-'0'),
+                        (str[5]-'0')*10 + (str[6]-'0'),
+                        (str[8]-'0')*10 + (str[9]-'0')));
+}
+
+// The length of "YYYY-MM-DD", dst must hold DATE_STR_LEN+1 chars
+const int DATE_STR_LEN = 10;
+void   date_to_str(char* dst, const int date);
+
+// The local date of a time_t, and the local midnight of a date
+int    timet_to_date(const time_t time);
+time_t date_to_timet(const int date);
+
+// Add a number of months or years, the day is clipped to the month
+int    date_add_month(const int date, const int months);
+int    date_add_year(const int date, const int years);
+
+
+
 #endif // __TIME_UTIL_H
 
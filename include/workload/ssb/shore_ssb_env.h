@@ -262,6 +262,9 @@ public:
 
     // --- operations over tables --- //
     w_rc_t loaddata();  
+
+    // the managers of the loaded tables, in the order of creation
+    void load_tables(std::vector<table_man_t*>& tables);
     
     // SSB Tables
     DECLARE_TABLE(part_t,part_man_impl,part);
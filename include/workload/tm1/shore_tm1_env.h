@@ -188,7 +188,7 @@ public:
     virtual int info() const;
     virtual int statistics();        
 
-    virtual w_rc_t warmup() { return(RCOK); /* do nothing */ };
+    virtual w_rc_t warmup() { return (warmup_bufpool()); }
     virtual w_rc_t check_consistency() { return(RCOK); /* do nothing */ };
 
     virtual void print_throughput(const double iQueriedSF, 
@@ -39,7 +39,7 @@
 
 #include "workload/tm1/tm1_const.h"
 
-#include "sm/shore/shore_table_man.h"
+#include "sm/shore/shore_fixed_row.h"
 
 using namespace shore;
 
@@ -61,6 +61,69 @@ DECLARE_TABLE_SCHEMA_PD(special_facility_t);
 DECLARE_TABLE_SCHEMA_PD(call_forwarding_t);
 
 
+
+/* --------------------------------------------------- */
+/* --- Fixed-layout records, see shore_fixed_row.h --- */
+/* --- They should mirror the schema definitions   --- */
+/* --------------------------------------------------- */
+
+#pragma pack(push,1)
+
+struct subscriber_rec_t {
+    int   S_ID;
+    char  SUB_NBR[TM1_SUB_NBR_SZ];
+    bool  BIT_XX[10];
+    short HEX_XX[10];
+    short BYTE2_XX[10];
+    int   MSC_LOCATION;
+    int   VLR_LOCATION;
+#ifdef CFG_HACK
+    char  S_PADDING[100-10*sizeof(bool)-20*sizeof(short)-3*sizeof(int)
+                    -TM1_SUB_NBR_SZ*sizeof(char)];
+#endif
+};
+
+struct access_info_rec_t {
+    int   S_ID;
+    short AI_TYPE;
+    short DATA1;
+    short DATA2;
+    char  DATA3[TM1_AI_DATA3_SZ];
+    char  DATA4[TM1_AI_DATA4_SZ];
+#ifdef CFG_HACK
+    char  AI_PADDING[50-3*sizeof(short)-1*sizeof(int)
+                     -(TM1_AI_DATA3_SZ+TM1_AI_DATA4_SZ)*sizeof(char)];
+#endif
+};
+
+struct special_facility_rec_t {
+    int   S_ID;
+    short SF_TYPE;
+    bool  IS_ACTIVE;
+    short ERROR_CNTRL;
+    short DATA_A;
+    char  DATA_B[TM1_SF_DATA_B_SZ];
+#ifdef CFG_HACK
+    char  SF_PADDING[50-1*sizeof(bool)-3*sizeof(short)-1*sizeof(int)
+                     -TM1_SF_DATA_B_SZ*sizeof(char)];
+#endif
+};
+
+struct call_forwarding_rec_t {
+    int   S_ID;
+    short SF_TYPE;
+    short START_TIME;
+    short END_TIME;
+    char  NUMBERX[TM1_CF_NUMBERX_SZ];
+#ifdef CFG_HACK
+    char  CF_PADDING[50-3*sizeof(short)-1*sizeof(int)
+                     -TM1_CF_NUMBERX_SZ*sizeof(char)];
+#endif
+};
+
+#pragma pack(pop)
+
+
 EXIT_NAMESPACE(tm1);
 
 
@@ -47,7 +47,7 @@ ENTER_NAMESPACE(tm1);
 /* ---------------------------------------------------------------- */
 
 
-class sub_man_impl : public table_man_impl<subscriber_t>
+class sub_man_impl : public fixed_table_man_impl<subscriber_t,subscriber_rec_t>
 {
     typedef table_row_t sub_tuple;
     typedef index_scan_iter_impl<subscriber_t> sub_idx_iter;
@@ -55,7 +55,7 @@ class sub_man_impl : public table_man_impl<subscriber_t>
 public:
 
     sub_man_impl(subscriber_t* aSubscriberDesc)
-        : table_man_impl<subscriber_t>(aSubscriberDesc)
+        : fixed_table_man_impl<subscriber_t,subscriber_rec_t>(aSubscriberDesc)
     { }
     ~sub_man_impl() { }
 
@@ -103,14 +103,14 @@ public:
 
 
 
-class ai_man_impl : public table_man_impl<access_info_t>
+class ai_man_impl : public fixed_table_man_impl<access_info_t,access_info_rec_t>
 {
     typedef table_row_t ai_tuple;
 
 public:
 
     ai_man_impl(access_info_t* aAIDesc)
-        : table_man_impl<access_info_t>(aAIDesc)
+        : fixed_table_man_impl<access_info_t,access_info_rec_t>(aAIDesc)
     { }
     ~ai_man_impl() { }
 
@@ -131,7 +131,7 @@ public:
 
 
 
-class sf_man_impl : public table_man_impl<special_facility_t>
+class sf_man_impl : public fixed_table_man_impl<special_facility_t,special_facility_rec_t>
 {
     typedef table_row_t sf_tuple;
     typedef index_scan_iter_impl<special_facility_t> sf_idx_iter;
@@ -139,7 +139,7 @@ class sf_man_impl : public table_man_impl<special_facility_t>
 public:
 
     sf_man_impl(special_facility_t* aSFDesc)
-        : table_man_impl<special_facility_t>(aSFDesc)
+        : fixed_table_man_impl<special_facility_t,special_facility_rec_t>(aSFDesc)
     { }
     ~sf_man_impl() { }
 
@@ -180,7 +180,7 @@ public:
 
 
 
-class cf_man_impl : public table_man_impl<call_forwarding_t>
+class cf_man_impl : public fixed_table_man_impl<call_forwarding_t,call_forwarding_rec_t>
 {
     typedef table_row_t cf_tuple;
     typedef index_scan_iter_impl<call_forwarding_t> cf_idx_iter;
@@ -188,7 +188,7 @@ class cf_man_impl : public table_man_impl<call_forwarding_t>
 public:
 
     cf_man_impl(call_forwarding_t* aCFDesc)
-        : table_man_impl<call_forwarding_t>(aCFDesc)
+        : fixed_table_man_impl<call_forwarding_t,call_forwarding_rec_t>(aCFDesc)
     { }
     ~cf_man_impl() { }
 
@@ -39,7 +39,7 @@
 #include "sm_vas.h"
 #include "util.h"
 
-#include "sm/shore/shore_table_man.h"
+#include "sm/shore/shore_fixed_row.h"
 
 using namespace shore;
 
@@ -61,6 +61,54 @@ DECLARE_TABLE_SCHEMA_PD(account_t);
 DECLARE_TABLE_SCHEMA_PD(history_t);
 
 
+
+/* --------------------------------------------------- */
+/* --- Fixed-layout records, see shore_fixed_row.h --- */
+/* --- They should mirror the schema definitions   --- */
+/* --------------------------------------------------- */
+
+#pragma pack(push,1)
+
+struct branch_rec_t {
+    int    B_ID;
+    double B_BALANCE;
+#ifdef CFG_HACK
+    char   B_PADDING[100-sizeof(int)-sizeof(double)];
+#endif
+};
+
+struct teller_rec_t {
+    int    T_ID;
+    int    T_B_ID;
+    double T_BALANCE;
+#ifdef CFG_HACK
+    char   T_PADDING[100-2*sizeof(int)-sizeof(double)];
+#endif
+};
+
+struct account_rec_t {
+    int    A_ID;
+    int    A_B_ID;
+    double A_BALANCE;
+#ifdef CFG_HACK
+    char   A_PADDING[100-2*sizeof(int)-sizeof(double)];
+#endif
+};
+
+struct history_rec_t {
+    int    H_B_ID;
+    int    H_T_ID;
+    int    H_A_ID;
+    double H_DELTA;
+    double H_TIME;
+#ifdef CFG_HACK
+    char   H_PADDING[50-3*sizeof(int)-2*sizeof(double)];
+#endif
+};
+
+#pragma pack(pop)
+
+
 EXIT_NAMESPACE(tpcb);
 
 #endif /* __SHORE_TPCB_SCHEMA_H */
@@ -47,14 +47,14 @@ ENTER_NAMESPACE(tpcb);
 /* ------------------------------------------------------------------ */
 
 
-class branch_man_impl : public table_man_impl<branch_t>
+class branch_man_impl : public fixed_table_man_impl<branch_t,branch_rec_t>
 {
     typedef table_row_t branch_tuple;
 
 public:
 
     branch_man_impl(branch_t* aBranchDesc)
-        : table_man_impl<branch_t>(aBranchDesc)
+        : fixed_table_man_impl<branch_t,branch_rec_t>(aBranchDesc)
     { }
 
     ~branch_man_impl() { }
@@ -76,14 +76,14 @@ public:
 
 
 
-class teller_man_impl : public table_man_impl<teller_t>
+class teller_man_impl : public fixed_table_man_impl<teller_t,teller_rec_t>
 {
     typedef table_row_t teller_tuple;
 
 public:
 
     teller_man_impl(teller_t* aTellerDesc)
-        : table_man_impl<teller_t>(aTellerDesc)
+        : fixed_table_man_impl<teller_t,teller_rec_t>(aTellerDesc)
     { }
 
     ~teller_man_impl() { }
@@ -101,7 +101,7 @@ public:
 
 
 
-class account_man_impl : public table_man_impl<account_t>
+class account_man_impl : public fixed_table_man_impl<account_t,account_rec_t>
 {
     typedef table_row_t account_tuple;
     typedef table_scan_iter_impl<account_t> account_table_iter;
@@ -110,7 +110,7 @@ class account_man_impl : public table_man_impl<account_t>
 public:
 
     account_man_impl(account_t* aAccountDesc)
-        : table_man_impl<account_t>(aAccountDesc)
+        : fixed_table_man_impl<account_t,account_rec_t>(aAccountDesc)
     { }
 
     ~account_man_impl() { }
@@ -145,14 +145,14 @@ public:
 
 
 
-class history_man_impl : public table_man_impl<history_t>
+class history_man_impl : public fixed_table_man_impl<history_t,history_rec_t>
 {
     typedef table_row_t history_tuple;
 
 public:
 
     history_man_impl(history_t* aHistoryDesc)
-        : table_man_impl<history_t>(aHistoryDesc)
+        : fixed_table_man_impl<history_t,history_rec_t>(aHistoryDesc)
     { }
 
     ~history_man_impl() { }
@@ -41,6 +41,7 @@
 #define FLAT_FILE_H
 
 #include "EGenUtilities_stdafx.h"
+#include "MappedFile.h"
 
 namespace TPCE
 {
@@ -55,26 +56,11 @@ protected:
 
     void ReadList(const char *szListFile)
     {
-        ifstream    tmpFile;
+        // the file is parsed in place, out of its mapped pages
+        CMappedFile             tmpFile(szListFile);   //throws if the open fails
+        CMappedFileTokenizer    tmpTok(tmpFile);
 
-        if (szListFile)
-        {
-            tmpFile.open(szListFile, ios_base::in);
-            if (tmpFile)
-            {
-                ReadList(tmpFile);
-                tmpFile.close();
-            }
-            else
-            {   //Open failed
-                tmpFile.close();
-                throw CSystemErr(CSystemErr::eCreateFile, "CFlatFile::ReadList");
-            }
-        }
-        else
-        {
-            throw CSystemErr(CSystemErr::eCreateFile, "CFlatFile::ReadList");
-        }
+        ReadList(tmpTok);
     }
 
     void ReadList(const string &str)
@@ -102,6 +88,20 @@ protected:
     }
 
 
+    void ReadList(CMappedFileTokenizer &tmpFile)
+    {
+        T   row;
+        memset(&row, 0, sizeof(row));
+
+        tmpFile.SkipWs();
+        while(!tmpFile.Eof())
+        {
+            row.Load(tmpFile);  //read the row
+            m_list.Add(&row);   //insert into the container
+            tmpFile.SkipWs();
+        }
+    }
+
 public:
 
     //Constructor.
@@ -42,6 +42,7 @@
 #define INPUT_FILE_H
 
 #include "EGenUtilities_stdafx.h"
+#include "MappedFile.h"
 
 namespace TPCE
 {
@@ -55,26 +56,11 @@ template <typename T, typename TKeyAndElementsLimits> class CInputFile
 
     void ReadList(const char *szListFile)
     {
-        ifstream    tmpFile;
+        // the file is parsed in place, out of its mapped pages
+        CMappedFile             tmpFile(szListFile);   //throws if the open fails
+        CMappedFileTokenizer    tmpTok(tmpFile);
 
-        if (szListFile)
-        {
-            tmpFile.open(szListFile, ios_base::in);
-            if (tmpFile)
-            {
-                ReadList(tmpFile);
-                tmpFile.close();
-            }
-            else
-            {   //Open failed
-                tmpFile.close();
-                throw CSystemErr(CSystemErr::eCreateFile, "CInputFile::ReadList");
-            }
-        }
-        else
-        {
-            throw CSystemErr(CSystemErr::eCreateFile, "CInputFile::ReadList");
-        }
+        ReadList(tmpTok);
     }
 
     void ReadList(const string &str)
@@ -101,6 +87,18 @@ template <typename T, typename TKeyAndElementsLimits> class CInputFile
         }
     }
 
+    void ReadList(CMappedFileTokenizer &tmpFile) {
+        T   row;
+        memset(&row, 0, sizeof(row));
+        int iThreshold = 0, iWeight;
+        while(tmpFile.Get(iWeight)) //first the weight
+        {
+            row.Load(tmpFile);  //then the rest of the row
+            iThreshold += iWeight;  //used as the key
+            m_list.Add(iThreshold-1/*because weights start from 1*/, &row, iWeight);//add to the container
+        }
+    }
+
 public:
 
     //Constructor.
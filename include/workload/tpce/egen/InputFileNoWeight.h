@@ -42,6 +42,7 @@
 #define INPUT_FILE_NO_WEIGHT_H
 
 #include "EGenUtilities_stdafx.h"
+#include "MappedFile.h"
 
 namespace TPCE
 {
@@ -56,26 +57,11 @@ template <typename T> class CInputFileNoWeight
 
     void ReadList(const char *szListFile)
     {
-        ifstream    tmpFile;
+        // the file is parsed in place, out of its mapped pages
+        CMappedFile             tmpFile(szListFile);   //throws if the open fails
+        CMappedFileTokenizer    tmpTok(tmpFile);
 
-        if (szListFile)
-        {
-            tmpFile.open(szListFile, ios_base::in);
-            if (tmpFile)
-            {
-                ReadList(tmpFile);
-                tmpFile.close();
-            }
-            else
-            {   //Open failed
-                tmpFile.close();
-                throw CSystemErr(CSystemErr::eCreateFile, "CInputFileNoWeight::ReadList");
-            }
-        }
-        else
-        {
-            throw CSystemErr(CSystemErr::eCreateFile, "CInputFileNoWeight::ReadList");
-        }
+        ReadList(tmpTok);
     }
 
     void ReadList(const string &str)
@@ -112,6 +98,30 @@ template <typename T> class CInputFileNoWeight
                 }
     }
 
+    void ReadList(CMappedFileTokenizer &tmpFile)
+    {
+        T   row;
+        memset(&row, 0, sizeof(row));
+        int iIndex;
+        int iLastIndex = -1; /* must be different from the 1st index in the input file */
+
+        while(tmpFile.Get(iIndex))  //read the first column, which is the index
+        {
+            row.Load(tmpFile);  //read the row
+            if (iIndex!=iLastIndex)
+            {
+                PVectorT parray_row = new vector<T>;
+                if (parray_row!=NULL)
+                    m_list.push_back(parray_row);   //new array
+                else
+                    throw CMemoryErr("CInputFileNoWeight::ReadFile");
+                iLastIndex = iIndex;
+            }
+            //Indices in the file start with 1 => substract 1.
+            m_list[(UINT)(iIndex-1)]->push_back(row);   //insert into the container
+        }
+    }
+
 public:
 
     //Constructor.
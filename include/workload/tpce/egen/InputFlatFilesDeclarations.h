@@ -63,6 +63,7 @@ typedef struct TAccountNameInputRow : public TBaseInputRow
     char    NAME[ cCA_NAME_len+1 ];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PAccountNameInputRow;
 
 //AreaCodes.txt
@@ -72,6 +73,7 @@ typedef struct TAreaCodeInputRow : public TBaseInputRow
     char        AREA_CODE[ cAREA_len+1 ];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PAreaCodeInputRow;
 
 //Company.txt
@@ -84,6 +86,7 @@ typedef struct TCompanyInputRow : public TBaseInputRow
     char    CO_DESC[ cCO_DESC_len+1 ];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PCompanyInputRow;
 
 //CompanyCompetitor.txt
@@ -94,6 +97,7 @@ typedef struct TCompanyCompetitorInputRow : public TBaseInputRow
     char    CP_IN_ID[cIN_ID_len+1];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PCompanyCompetitorInputRow;
 
 //CompanySPRate.txt
@@ -103,6 +107,7 @@ typedef struct TCompanySPRateInputRow : public TBaseInputRow
     char        CO_SP_RATE[ cCO_SP_RATE_len+1 ];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PCompanySPRateInputRow;
 
 //MaleFirstNames.txt and FemaleFirstNames.txt
@@ -111,6 +116,7 @@ typedef struct TFirstNameInputRow : public TBaseInputRow
     char    FIRST_NAME[cF_NAME_len+1];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PFirstNameInputRow;
 
 
@@ -120,6 +126,7 @@ typedef struct TLastNameInputRow : public TBaseInputRow
     char    LAST_NAME[cL_NAME_len+1];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PLastNameInputRow;
 
 //NewsItem.txt
@@ -128,6 +135,7 @@ typedef struct TNewsInputRow : public TBaseInputRow
     char    WORD[cWORD_len+1];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PNewsInputRow;
 
 //Street Names.txt
@@ -136,6 +144,7 @@ typedef struct TStreetNameInputRow : public TBaseInputRow
     char        STREET[ cAD_LINE_len+1 ];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PStreetNameInputRow;
 
 //StreetSuffix.txt
@@ -144,6 +153,7 @@ typedef struct TStreetSuffixInputRow : public TBaseInputRow
     char        SUFFIX[ cAD_LINE_len+1 ];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PStreetSuffixInputRow;
 
 //Security.txt
@@ -157,6 +167,7 @@ typedef struct TSecurityInputRow : public TBaseInputRow
     TIdent      S_CO_ID;
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PSecuritiesInputRow;
 
 //TaxRatesDivision.txt and TaxRatesCountry.txt
@@ -167,6 +178,7 @@ typedef struct TTaxRateInputRow : public TBaseInputRow
     double  TAX_RATE;   //the actual taxrate - needed to calculate tax for the TRADE table
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PTaxRateInputRow;
 
 //ZipCode.txt
@@ -178,6 +190,7 @@ typedef struct TZipCodeInputRow : public TBaseInputRow
     char    ZC_DIV[cZC_DIV_len+1];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PZipCodeInputRow;
 
 
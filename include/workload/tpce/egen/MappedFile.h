@@ -0,0 +1,279 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   MappedFile.h
+ *
+ *  @brief:  Memory-mapped input flat file and a tokenizer over it
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   The input flat files used to be parsed through an ifstream, with one
+   formatted extraction (or one getline+sscanf) per field. The CMappedFile
+   maps the whole file read-only and the CMappedFileTokenizer parses the
+   fields directly out of the mapped pages, without copying the lines and
+   without going through the stream locale machinery.
+
+   The tokenizer calls follow the semantics of the istream calls used by the
+   Load() functions, so that the two versions read exactly the same rows:
+
+       file>>ws                      SkipWs()
+       file>>num                     Get(num)
+       file>>str                     GetWord(str, sizeof(str))
+       file.get(str, sizeof(str), d) GetUntil(str, sizeof(str), d)
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "EGenStandardTypes.h"
+#include "error.h"
+
+namespace TPCE
+{
+
+/*
+*   Read-only mapping of a whole input flat file.
+*/
+class CMappedFile
+{
+    const char* m_pData;
+    size_t      m_iSize;
+
+    // non-copyable
+    CMappedFile(const CMappedFile&);
+    CMappedFile& operator=(const CMappedFile&);
+
+public:
+
+    CMappedFile(const char *szFileName)
+        : m_pData(NULL), m_iSize(0)
+    {
+        if (!szFileName)
+        {
+            throw CSystemErr(CSystemErr::eCreateFile, "CMappedFile::CMappedFile");
+        }
+
+        int fd = open(szFileName, O_RDONLY);
+        if (fd < 0)
+        {
+            throw CSystemErr(CSystemErr::eCreateFile, "CMappedFile::CMappedFile");
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) < 0)
+        {
+            close(fd);
+            throw CSystemErr(CSystemErr::eReadFile, "CMappedFile::CMappedFile");
+        }
+
+        m_iSize = (size_t)st.st_size;
+        if (m_iSize > 0)
+        {
+            void* p = mmap(NULL, m_iSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                close(fd);
+                throw CSystemErr(CSystemErr::eMapViewOfFile, "CMappedFile::CMappedFile");
+            }
+            // the files are read once, front to back
+            madvise(p, m_iSize, MADV_SEQUENTIAL);
+            m_pData = (const char*)p;
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        close(fd);
+    }
+
+    ~CMappedFile()
+    {
+        if (m_pData)
+        {
+            munmap((void*)m_pData, m_iSize);
+        }
+    }
+
+    const char* Begin() const { return m_pData; }
+    const char* End() const { return m_pData + m_iSize; }
+    size_t      Size() const { return m_iSize; }
+};
+
+
+/*
+*   Zero-copy tokenizer over a mapped file. The data are not NUL-terminated,
+*   so every scan is bounded by the end of the mapping.
+*/
+class CMappedFileTokenizer
+{
+    const char* m_pCur;
+    const char* m_pEnd;
+
+    static bool IsSpace(char c)
+    {
+        return (c==' ' || c=='\t' || c=='\n' || c=='\r' || c=='\v' || c=='\f');
+    }
+
+    static bool IsDigit(char c)
+    {
+        return (c>='0' && c<='9');
+    }
+
+public:
+
+    CMappedFileTokenizer(const CMappedFile& file)
+        : m_pCur(file.Begin()), m_pEnd(file.End())
+    {
+    }
+
+    CMappedFileTokenizer(const char* pBegin, const char* pEnd)
+        : m_pCur(pBegin), m_pEnd(pEnd)
+    {
+    }
+
+    bool Eof() const { return (m_pCur >= m_pEnd); }
+
+    // file>>ws
+    void SkipWs()
+    {
+        while ((m_pCur < m_pEnd) && IsSpace(*m_pCur)) ++m_pCur;
+    }
+
+    // file>>num, for all the integer types
+    template <typename T> bool Get(T& val)
+    {
+        SkipWs();
+        bool bNeg = false;
+        if ((m_pCur < m_pEnd) && (*m_pCur=='-' || *m_pCur=='+'))
+        {
+            bNeg = (*m_pCur=='-');
+            ++m_pCur;
+        }
+        if ((m_pCur >= m_pEnd) || !IsDigit(*m_pCur)) return (false);
+
+        T v = 0;
+        while ((m_pCur < m_pEnd) && IsDigit(*m_pCur))
+        {
+            v = v*10 + (T)(*m_pCur - '0');
+            ++m_pCur;
+        }
+        val = (bNeg ? (T)(0-v) : v);
+        return (true);
+    }
+
+    // file>>bool, which reads 0 or 1
+    bool Get(bool& val)
+    {
+        int v = 0;
+        if (!Get(v)) return (false);
+        val = (v!=0);
+        return (true);
+    }
+
+    // file>>double. The mantissa is accumulated as an integer and scaled
+    // once, which is exact for the few decimal digits of the input files.
+    bool Get(double& val)
+    {
+        SkipWs();
+        bool bNeg = false;
+        if ((m_pCur < m_pEnd) && (*m_pCur=='-' || *m_pCur=='+'))
+        {
+            bNeg = (*m_pCur=='-');
+            ++m_pCur;
+        }
+
+        UINT64 iMant = 0;
+        int iDigits = 0;
+        int iScale = 0;
+        while ((m_pCur < m_pEnd) && IsDigit(*m_pCur))
+        {
+            iMant = iMant*10 + (*m_pCur - '0');
+            ++m_pCur; ++iDigits;
+        }
+        if ((m_pCur < m_pEnd) && (*m_pCur=='.'))
+        {
+            ++m_pCur;
+            while ((m_pCur < m_pEnd) && IsDigit(*m_pCur))
+            {
+                iMant = iMant*10 + (*m_pCur - '0');
+                ++m_pCur; ++iDigits; --iScale;
+            }
+        }
+        if (iDigits==0) return (false);
+
+        if ((m_pCur < m_pEnd) && (*m_pCur=='e' || *m_pCur=='E'))
+        {
+            ++m_pCur;
+            int iExp = 0;
+            if (!Get(iExp)) return (false);
+            iScale += iExp;
+        }
+
+        double d = (double)iMant;
+        double p = 1.0;
+        for (int i = (iScale<0 ? -iScale : iScale); i>0; --i) p *= 10.0;
+        d = (iScale<0 ? d/p : d*p);
+
+        val = (bNeg ? -d : d);
+        return (true);
+    }
+
+    // file>>str, reads up to the next whitespace
+    bool GetWord(char* szBuf, size_t iSize)
+    {
+        SkipWs();
+        size_t i = 0;
+        while ((m_pCur < m_pEnd) && !IsSpace(*m_pCur))
+        {
+            if (i+1 < iSize) szBuf[i++] = *m_pCur;
+            ++m_pCur;
+        }
+        szBuf[i] = '\0';
+        return (i>0);
+    }
+
+    // file.get(str, sizeof(str), delim), reads up to (not including) the
+    // delimiter and at most iSize-1 characters
+    bool GetUntil(char* szBuf, size_t iSize, char cDelim)
+    {
+        size_t i = 0;
+        while ((m_pCur < m_pEnd) && (*m_pCur != cDelim) && (i+1 < iSize))
+        {
+            szBuf[i++] = *m_pCur++;
+        }
+        szBuf[i] = '\0';
+        return (i>0);
+    }
+};
+
+}   // namespace TPCE
+
+#endif //MAPPED_FILE_H
@@ -51,6 +51,8 @@ using namespace std;
 namespace TPCE
 {
 
+class CMappedFileTokenizer;
+
 //Base abstract structure for an input file row
 //Must be able to read itself from a file.
 typedef struct TBaseInputRow
@@ -110,6 +112,7 @@ typedef struct CHARGE_ROW : public TBaseInputRow
     double                  CH_CHRG;
 
     void                    Load(istream &file);    //loads itself (one row) from the input stream
+    void                    Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PCHARGE_ROW;
 const char ChargeRowFmt[] = "%s|%d|%.2f\n";
 
@@ -124,6 +127,7 @@ typedef struct COMMISSION_RATE_ROW : public TBaseInputRow
     double                  CR_RATE;
 
     void                    Load(istream &file);    //loads itself (one row) from the input stream
+    void                    Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PCOMMISSION_RATE_ROW;
 const char CommissionRateRowFmt[] = "%d|%s|%s|%.0f|%.0f|%.2f\n";
 
@@ -230,6 +234,7 @@ typedef struct EXCHANGE_ROW
     TIdent                  EX_AD_ID;
 
     void                    Load(istream &file);    //loads itself (one row) from the input stream
+    void                    Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PEXCHANGE_ROW;
 const char ExchangeRowFmt[] = "%s|%s|%d|%d|%d|%s|%" PRId64 "\n";
 
@@ -292,6 +297,7 @@ typedef struct INDUSTRY_ROW : public TBaseInputRow
     char                    IN_SC_ID[cSC_ID_len+1];
 
     void                    Load(istream &file);    //loads itself (one row) from the input stream
+    void                    Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PINDUSTRY_ROW;
 const char IndustryRowFmt[] = "%s|%s|%s\n";
 
@@ -334,6 +340,7 @@ typedef struct SECTOR_ROW : public TBaseInputRow
     char                    SC_NAME[cSC_NAME_len+1];
 
     void Load(istream &file);   //loads itself (one row) from the input stream
+    void Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PSECTOR_ROW;
 const char SectorRowFmt[] = "%s|%s\n";
 
@@ -376,6 +383,7 @@ typedef struct STATUS_TYPE_ROW : public TBaseInputRow
     char                    ST_NAME[cST_NAME_len+1];
 
     void                    Load(istream &file);    //loads itself (one row) from the input stream
+    void                    Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PSTATUS_TYPE_ROW;
 const char StatusTypeRowFmt[] = "%s|%s\n";
 
@@ -439,6 +447,7 @@ typedef struct TRADE_TYPE_ROW
     bool                    TT_IS_MRKT;
 
     void                    Load(istream &file);    //loads itself (one row) from the input stream
+    void                    Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PTRADE_TYPE_ROW;
 const char TradeTypeRowFmt[] = "%s|%s|%s|%s\n";
 
@@ -466,6 +475,7 @@ typedef struct ZIP_CODE_ROW : public TBaseInputRow
     char                    ZC_DIV[cZC_DIV_len+1];
 
     void                    Load(istream &file);    //loads itself (one row) from the input stream
+    void                    Load(CMappedFileTokenizer &file); //loads itself (one row) from a mapped file
 } *PZIP_CODE_ROW;
 const char ZipCodeRowFmt[] = "%s|%s|%s\n";
 
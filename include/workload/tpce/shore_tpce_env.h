@@ -61,6 +61,10 @@ using namespace TPCE;
 //#define TESTING_TPCE
 
 int egen_init(int argc, char* argv[]);
+
+// The caller owns the returned generator and its logger and format
+CGenerateAndLoad* egen_range_init(TIdent iCount, TIdent iStartFrom,
+                                  CEGenLogger*& pLog, CLogFormatTab*& pFmt);
 void egen_release();
 extern CGenerateAndLoad*  pGenerateAndLoad;
 
@@ -223,6 +227,11 @@ public:
     class table_creator_t;
     struct checkpointer_t;
 
+    // the pipelined loader, see shore_tpce_loader.h
+    class egen_loader_t;
+    class egen_generator_t;
+    class egen_inserter_t;
+
 protected:       
     /*
      * note: PIN: the definition of the scaling factor in tpce is different from
@@ -393,6 +402,7 @@ public:
         zipCodeBuffer.release();
     }
     
+    void populate_small();
     void populate_customer();
     void populate_address();
     void populate_ca_and_ap();
@@ -411,6 +421,9 @@ public:
     void populate_unit_trade();
     void populate_growing();
     void find_maxtrade_id();
+
+    // generates and inserts the tables in parallel, see shore_tpce_loader.h
+    void pipelined_load(const int gens, const int inserters, const int qsize);
     // Public methods //    
 
     // --- operations over tables --- //
@@ -0,0 +1,226 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_tpce_loader.h
+ *
+ *  @brief:  Pipelined TPC-E loader, where EGen generation and the
+ *           inserts to the database run in parallel
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   The baseline loader (table_builder_t) generates and inserts the tables one
+   after the other, from a single thread and a single EGen instance, through
+   the global EgenTupleContainer buffers.
+
+   The pipelined loader instead:
+
+   1. Splits the customers into tpce-egen-loaders disjoint ranges, each
+      a multiple of the load unit, and creates one CGenerateAndLoad per range
+      (egen_range_init()). EGen is designed so that instances over disjoint
+      ranges generate disjoint rows (ids, trades, companies, securities).
+
+   2. For each EGen instance forks one generator thread per group of
+      independent tables: the customer tables, the market (company and
+      security) tables and the growing (trade) tables. The groups use
+      separate EGen table generators, thus they run concurrently.
+
+   3. The generators pack the rows into egen_batch_t objects, each the unit
+      of one loader xct, and push them into a bounded egen_batch_queue_t.
+      When the queue is full the generators block, so the memory used by the
+      pipeline is bounded by tpce-load-queue batches.
+
+   4. db-loaders inserter threads pop the batches and insert them, each
+      batch in one xct, retried on deadlock as the baseline loader does.
+
+   The fixed tables are still loaded first, from the instance created by
+   egen_init(). Setting tpce-egen-loaders to 0 selects the baseline loader.
+*/
+
+#ifndef __SHORE_TPCE_LOADER_H
+#define __SHORE_TPCE_LOADER_H
+
+#include <deque>
+#include <vector>
+
+#include "workload/tpce/shore_tpce_env.h"
+
+
+ENTER_NAMESPACE(tpce);
+
+
+// Defaults of the loader knobs
+const int TPCE_EGEN_LOADERS   = 4;    // tpce-egen-loaders
+const int TPCE_LOAD_INSERTERS = 10;   // db-loaders
+const int TPCE_LOAD_QUEUE     = 32;   // tpce-load-queue, in batches
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: egen_rows_base_t
+ *
+ * @brief: The rows of one table in a batch
+ *
+ * --------------------------------------------------------------- */
+
+class egen_rows_base_t
+{
+public:
+    virtual ~egen_rows_base_t() { }
+    virtual uint_t size() const=0;
+    virtual w_rc_t load(ShoreTPCEEnv* env)=0;
+};
+
+
+template <class Row>
+class egen_rows_t : public egen_rows_base_t
+{
+public:
+    typedef w_rc_t (ShoreTPCEEnv::*load_one_fn)(rep_row_t&, Row*);
+
+private:
+    table_man_t*     _pman;
+    load_one_fn      _load_one;
+    std::vector<Row> _rows;
+
+public:
+
+    egen_rows_t(table_man_t* pman, load_one_fn fn, const uint_t cap)
+        : _pman(pman), _load_one(fn)
+    {
+        assert (_pman);
+        _rows.reserve(cap);
+    }
+    ~egen_rows_t() { }
+
+    // EGen reuses the row it returns, thus it is copied
+    inline void append(const Row* prow) { _rows.push_back(*prow); }
+
+    uint_t size() const { return (_rows.size()); }
+
+    // Inserts the rows, in the context of the caller xct
+    w_rc_t load(ShoreTPCEEnv* env)
+    {
+        rep_row_t areprow(_pman->ts());
+        areprow.set(_pman->table()->maxsize());
+        for (uint_t i=0; i<_rows.size(); ++i) {
+            W_DO((env->*_load_one)(areprow, &_rows[i]));
+        }
+        return (RCOK);
+    }
+
+}; // EOF: egen_rows_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: egen_batch_t
+ *
+ * @brief: The rows inserted by one loader xct, possibly of more than
+ *         one table (e.g. CUSTOMER_ACCOUNT and ACCOUNT_PERMISSION)
+ *
+ * --------------------------------------------------------------- */
+
+class egen_batch_t
+{
+    std::vector<egen_rows_base_t*> _parts;
+
+public:
+
+    egen_batch_t() { }
+    ~egen_batch_t()
+    {
+        for (uint_t i=0; i<_parts.size(); ++i) delete (_parts[i]);
+    }
+
+    template <class Row>
+    egen_rows_t<Row>* add(table_man_t* pman,
+                          typename egen_rows_t<Row>::load_one_fn fn,
+                          const uint_t cap)
+    {
+        egen_rows_t<Row>* prows = new egen_rows_t<Row>(pman, fn, cap);
+        _parts.push_back(prows);
+        return (prows);
+    }
+
+    uint_t rows() const
+    {
+        uint_t r = 0;
+        for (uint_t i=0; i<_parts.size(); ++i) r += _parts[i]->size();
+        return (r);
+    }
+
+    w_rc_t load(ShoreTPCEEnv* env)
+    {
+        for (uint_t i=0; i<_parts.size(); ++i) W_DO(_parts[i]->load(env));
+        return (RCOK);
+    }
+
+}; // EOF: egen_batch_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: egen_batch_queue_t
+ *
+ * @brief: Bounded queue of batches between the generators and the
+ *         inserters
+ *
+ * --------------------------------------------------------------- */
+
+class egen_batch_queue_t
+{
+    pthread_mutex_t _lock;
+    pthread_cond_t  _not_empty;
+    pthread_cond_t  _not_full;
+
+    std::deque<egen_batch_t*> _batches;
+    uint_t _cap;
+    int    _producers;   // generators still running
+
+public:
+
+    egen_batch_queue_t(const uint_t cap, const int producers);
+    ~egen_batch_queue_t();
+
+    // Blocks while the queue is full
+    void push(egen_batch_t* pbatch);
+
+    // Blocks while the queue is empty. Returns NULL when the queue is
+    // empty and all the generators are done.
+    egen_batch_t* pop();
+
+    // Called by each generator when it has generated all its rows
+    void producer_done();
+
+}; // EOF: egen_batch_queue_t
+
+
+EXIT_NAMESPACE(tpce);
+
+#endif /* __SHORE_TPCE_LOADER_H */
@@ -583,6 +583,9 @@ public:
 
     w_rc_t t_index_probe(ss_m* db, trade_tuple* ptuple, const TIdent trade_id);
 
+    // returns only the fields carried by the entries of T_INDEX
+    w_rc_t t_index_probe_covered(ss_m* db, trade_tuple* ptuple, const TIdent trade_id);
+
     w_rc_t t_update_tax_by_index(ss_m* db, trade_tuple* ptuple, const TIdent t_id,
 				 const double tax_amount, lock_mode_t lm = EX);
     
@@ -58,6 +58,8 @@ ENTER_NAMESPACE(tpch);
 
 using std::map;
 
+class tpch_result_t;
+
 
 
 // Sets the scaling factor of the TPC-H database
@@ -256,6 +258,63 @@ private:
 
     w_rc_t _post_init_impl();
 
+    // The implementation of the Baseline queries (tpch-engine), and the
+    // number of queries whose two implementations disagreed
+    int           _query_engine;
+    volatile uint _query_mismatches;
+
+    template <class Input>
+    w_rc_t _run_query(const char* qname, Input& in,
+                      w_rc_t (ShoreTPCHEnv::*piter)(Input&, tpch_result_t*),
+                      w_rc_t (ShoreTPCHEnv::*pfused)(Input&, tpch_result_t*));
+
+    // The iterator and the fused plans of the queries (see tpch_fused.h).
+    // Each records its result to presult, if given.
+    w_rc_t _iter_q1(q1_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q2(q2_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q3(q3_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q4(q4_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q5(q5_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q6(q6_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q7(q7_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q8(q8_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q9(q9_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q10(q10_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q11(q11_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q12(q12_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q13(q13_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q14(q14_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q15(q15_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q16(q16_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q17(q17_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q18(q18_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q19(q19_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q20(q20_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q21(q21_input_t& in, tpch_result_t* presult);
+    w_rc_t _iter_q22(q22_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q1(q1_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q2(q2_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q3(q3_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q4(q4_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q5(q5_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q6(q6_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q7(q7_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q8(q8_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q9(q9_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q10(q10_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q11(q11_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q12(q12_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q13(q13_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q14(q14_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q15(q15_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q16(q16_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q17(q17_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q18(q18_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q19(q19_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q20(q20_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q21(q21_input_t& in, tpch_result_t* presult);
+    w_rc_t _fused_q22(q22_input_t& in, tpch_result_t* presult);
+
     // Helper functions for the loading
     w_rc_t _gen_one_nation(const int id, rep_row_t& areprow);
     w_rc_t _gen_one_region(const int id, rep_row_t& areprow);
@@ -302,6 +361,9 @@ public:
 
     // --- operations over tables --- //
     w_rc_t loaddata();  
+
+    // the managers of the loaded tables, in the order of creation
+    void load_tables(std::vector<table_man_t*>& tables);
     
     // TPCH Tables
     DECLARE_TABLE(nation_t,nation_man_impl,nation);
@@ -0,0 +1,436 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   tpch_fused.h
+ *
+ *  @brief:  Operator templates for the fused (compiled) plans of the
+ *           Baseline TPC-H queries, and the checker of their results
+ *
+ *  @author: agent, Oct 2026
+ */
+
+
+/**
+   The iterator implementations of the Baseline queries (_iter_qN) read
+   each row into a tpch_XXX_tuple, convert every date to a time_t and
+   group through std::map.
+
+   A fused plan is a chain of push operators, each one holding the next by
+   reference, whose types are all known at compile time:
+
+       scan --> filter_op --> probe_op --> aggregate_op
+                          \-> build_op
+
+   fused_scan() drives the chain from a file or an index scan iterator and
+   calls the head operator with the current row. The operators are small
+   structs whose operator() is inlined into the loop of fused_scan(), thus
+   the whole plan compiles into one loop per scanned table with no virtual
+   calls. The predicates, the keys and the aggregate updates of each query
+   are plain functors that read the columns through col_t<>, date_col_t<>
+   and str_col_t<>, which resolve the field index and the type at compile
+   time. Dates are compared as SQL_DATE day numbers (date_key()).
+
+   The joins and the group-bys use a fused_map_t, an open-addressing map
+   (util/hashtable.h) that keeps the key and the value inline in its slots.
+   The keys must be packed PODs (no padding), they are hashed with fnv and
+   compared with memcmp.
+
+   With tpch-engine=2 (check) each query runs both plans, each recording
+   its result to a tpch_result_t, and the two are compared by
+   tpch_result_t::check().
+*/
+
+#ifndef __TPCH_FUSED_H
+#define __TPCH_FUSED_H
+
+#include <time.h>
+#include <string.h>
+
+#include <vector>
+
+#include "util.h"
+#include "util/hashtable.h"
+#include "util/fnv.h"
+
+#include "sm/shore/shore_row.h"
+
+#include "workload/tpch/tpch_struct.h"
+
+
+ENTER_NAMESPACE(tpch);
+
+using namespace shore;
+
+
+// The implementations of the Baseline queries
+enum eTPCHEngine { TPCH_ENGINE_ITER  = 0,   // hand-written iterator loops
+                   TPCH_ENGINE_FUSED = 1,   // fused operator templates
+                   TPCH_ENGINE_CHECK = 2 }; // both, results compared
+
+
+
+/********************************************************************
+ *
+ *  @fn:    date_key
+ *
+ *  @brief: The local date of a time_t, as the day number of a SQL_DATE
+ *          field, to compare with the dates of the rows
+ *
+ ********************************************************************/
+
+inline int date_key(const time_t t) { return (timet_to_date(t)); }
+
+// date_to_timet(d) is the midnight of d, thus for any time_t t:
+//     date_to_timet(d) <= t  iff  d <= date_key(t)
+//     date_to_timet(d) <  t  iff  d <= date_key(t-1)
+inline int date_key_before(const time_t t) { return (date_key(t-1)); }
+
+
+
+/********************************************************************
+ *
+ *  Typed column access
+ *
+ *  col_t<IDX,T>::get(row) reads field IDX of the row as a T. The
+ *  overload of table_row_t::get_value() is picked at compile time.
+ *
+ ********************************************************************/
+
+template <uint IDX, class T>
+struct col_t {
+    static inline T get(const table_row_t& row) {
+        T v;
+        row.get_value(IDX, v);
+        return (v);
+    }
+};
+
+template <uint IDX>
+struct date_col_t {
+    static inline int get(const table_row_t& row) {
+        int d;
+        row.get_date_value(IDX, d);
+        return (d);
+    }
+};
+
+template <uint IDX, uint LEN>
+struct str_col_t {
+    static inline void get(const table_row_t& row, char* buf) {
+        row.get_value(IDX, buf, STRSIZE(LEN));
+    }
+};
+
+// col_t<IDX,T> as a functor, to use a column as a join or a group key
+template <uint IDX, class T>
+struct col_of_t {
+    inline T operator()(const table_row_t& row) const {
+        return (col_t<IDX,T>::get(row));
+    }
+};
+
+
+
+/********************************************************************
+ *
+ *  @class: fused_map_t
+ *
+ *  @brief: A map from a packed POD Key to a Value, stored inline in
+ *          the slots of an open-addressing hashtable. Used both for
+ *          the build side of the joins and for the group-bys.
+ *
+ ********************************************************************/
+
+template <class Key, class Value>
+class fused_map_t
+{
+public:
+
+    typedef Value value_t;
+
+    struct entry_t {
+        Key   _key;
+        Value _value;
+    };
+
+private:
+
+    struct extract_key_t {
+        Key const& operator()(entry_t const& e) const { return (e._key); }
+    };
+    struct equal_key_t {
+        bool operator()(Key const& a, Key const& b) const {
+            return (memcmp(&a, &b, sizeof(Key)) == 0);
+        }
+    };
+    struct equal_entry_t {
+        bool operator()(entry_t const& a, entry_t const& b) const {
+            return (memcmp(&a._key, &b._key, sizeof(Key)) == 0);
+        }
+    };
+    struct hash_key_t {
+        size_t operator()(Key const& k) const {
+            return (fnv_hash((const char*)&k, sizeof(Key)));
+        }
+    };
+
+    typedef hashtable<entry_t, Key, extract_key_t, equal_key_t,
+                      equal_entry_t, hash_key_t> table_t;
+
+    table_t _table;
+
+public:
+
+    fused_map_t(const size_t expected = 0)
+        : _table(expected, extract_key_t(), equal_key_t(),
+                 equal_entry_t(), hash_key_t())
+    { }
+
+    size_t size() const { return (_table.size()); }
+
+    // The value of key k, or NULL
+    inline Value* find(Key const& k) {
+        entry_t* e = _table.find(k);
+        return (e ? &e->_value : NULL);
+    }
+
+    // The value of key k, inserted as init if not found. The returned
+    // pointer is valid only up to the next insertion.
+    inline Value* get_or_insert(Key const& k, Value const& init) {
+        size_t h = _table.hash(k);
+        entry_t* e = _table.find(k, h);
+        if (!e) {
+            entry_t ne;
+            ne._key = k;
+            ne._value = init;
+            e = _table.insert_equal(ne, h);
+        }
+        return (&e->_value);
+    }
+
+    // Calls f(key, value) for every entry, in no particular order
+    template <class F>
+    void for_each(F& f) {
+        for (size_t i=0; i<_table.capacity(); i++) {
+            entry_t* e = _table.get(i);
+            if (e) f(e->_key, e->_value);
+        }
+    }
+
+}; // EOF: fused_map_t
+
+
+
+/********************************************************************
+ *
+ *  Push operators
+ *
+ *  Each operator takes the tuple of its producer (a table_row_t for
+ *  the first one of a plan) and pushes to the next one. After a probe
+ *  the next operator gets both the tuple and the matching build value.
+ *
+ ********************************************************************/
+
+// Passes on the tuples that satisfy Pred
+template <class Pred, class Next>
+struct filter_op
+{
+    Pred  _pred;
+    Next& _next;
+
+    filter_op(Pred pred, Next& next) : _pred(pred), _next(next) { }
+
+    template <class T>
+    inline void operator()(const T& t) { if (_pred(t)) _next(t); }
+};
+
+
+// Inserts each tuple to a join map, as KeyOf(t) -> ValueOf(t). The
+// build side has unique keys; later duplicates are ignored.
+template <class Map, class KeyOf, class ValueOf>
+struct build_op
+{
+    Map&    _map;
+    KeyOf   _keyof;
+    ValueOf _valueof;
+
+    build_op(Map& map, KeyOf keyof, ValueOf valueof)
+        : _map(map), _keyof(keyof), _valueof(valueof) { }
+
+    template <class T>
+    inline void operator()(const T& t) {
+        _map.get_or_insert(_keyof(t), _valueof(t));
+    }
+
+    // after a probe (semi-join), the matching build value is ignored
+    template <class T, class J>
+    inline void operator()(const T& t, J&) {
+        _map.get_or_insert(_keyof(t), _valueof(t));
+    }
+};
+
+
+// The value of the build side of a semi-join, which is only a set of keys
+struct mark_t {
+    template <class T>
+    inline char operator()(const T&) const { return (1); }
+};
+
+
+// The predicate of a semi-join (In) or an anti-join (!In) with a map
+template <class Map, class KeyOf, bool In>
+struct in_map_t
+{
+    Map&  _map;
+    KeyOf _keyof;
+
+    in_map_t(Map& map, KeyOf keyof) : _map(map), _keyof(keyof) { }
+
+    template <class T>
+    inline bool operator()(const T& t) const {
+        return ((_map.find(_keyof(t)) != NULL) == In);
+    }
+};
+
+
+// Looks up KeyOf(t) in a join map and pushes (t, value) on a match
+template <class Map, class KeyOf, class Next>
+struct probe_op
+{
+    Map&  _map;
+    KeyOf _keyof;
+    Next& _next;
+
+    probe_op(Map& map, KeyOf keyof, Next& next)
+        : _map(map), _keyof(keyof), _next(next) { }
+
+    template <class T>
+    inline void operator()(const T& t) {
+        typename Map::value_t* v = _map.find(_keyof(t));
+        if (v) _next(t, *v);
+    }
+};
+
+
+// Groups by KeyOf and folds each tuple into the group with Update.
+// Update is called as update(value, t) or update(value, t, joined).
+template <class Map, class KeyOf, class Update>
+struct aggregate_op
+{
+    Map&   _map;
+    KeyOf  _keyof;
+    Update _update;
+
+    aggregate_op(Map& map, KeyOf keyof, Update update)
+        : _map(map), _keyof(keyof), _update(update) { }
+
+    template <class T>
+    inline void operator()(const T& t) {
+        _update(*_map.get_or_insert(_keyof(t), _update.init()), t);
+    }
+
+    template <class T, class J>
+    inline void operator()(const T& t, J& joined) {
+        _update(*_map.get_or_insert(_keyof(t, joined), _update.init()),
+                t, joined);
+    }
+};
+
+
+
+/********************************************************************
+ *
+ *  @fn:    fused_scan
+ *
+ *  @brief: Drives a plan from a file or an index scan iterator,
+ *          pushing each row to the head operator
+ *
+ ********************************************************************/
+
+template <class Iter, class Row, class Op>
+inline w_rc_t fused_scan(ss_m* db, Iter* iter, Row& row, Op& op)
+{
+    // Iter::next() is called qualified, thus not through the vtable
+    bool eof;
+    W_DO(iter->Iter::next(db, eof, row));
+    while (!eof) {
+        op(const_cast<const Row&>(row));
+        W_DO(iter->Iter::next(db, eof, row));
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ *  @class: tpch_result_t
+ *
+ *  @brief: The result of a query as rows of numbers (keys, dates as
+ *          day numbers and aggregates), compared by check() regardless
+ *          of the order of the rows
+ *
+ ********************************************************************/
+
+class tpch_result_t
+{
+public:
+    typedef std::vector<double> row_t;
+
+    // Relative difference tolerated between two aggregates, which the
+    // two plans may sum in different order and precision
+    static const double TOLERANCE;
+
+private:
+    std::vector<row_t> _rows;
+
+public:
+
+    tpch_result_t() { }
+
+    // Starts a new row, the values are appended with add()
+    row_t& new_row() {
+        _rows.push_back(row_t());
+        return (_rows.back());
+    }
+
+    void add(const double v) { _rows.back().push_back(v); }
+
+    size_t size() const { return (_rows.size()); }
+    const row_t& row(const size_t i) const { return (_rows[i]); }
+
+    // Sorts the rows, so that two results can be compared row by row
+    void sort();
+
+    // Compares the result of the iterator plan with the one of the fused
+    // plan of a query. Traces the first difference and returns false if
+    // they differ.
+    static bool check(const char* qname, tpch_result_t& iter_res,
+                      tpch_result_t& fused_res);
+
+}; // EOF: tpch_result_t
+
+
+EXIT_NAMESPACE(tpch);
+
+#endif /* __TPCH_FUSED_H */
@@ -54,12 +54,17 @@ dora_flusher_t::dora_flusher_t(ShoreEnv* penv,
     assert (_dora_flushing.get());
     _dora_flushing->setqueue(WS_COMMIT_Q,this,0,0);  // wake-up immediately
 
-    // Create and start the notifier
-    fprintf(stdout, "Starting dora-notifier...\n");
-    _notifier = new dora_notifier_t(_env, c_str("DNotifier"));
-    assert(_notifier.get());
-    _notifier->fork();
-    _notifier->start();
+    // Create and start the notifier(s)
+    int numNotifiers = envVar::instance()->getVarInt("dora-notifiers",1);
+    if (numNotifiers<1) numNotifiers = 1;
+    fprintf(stdout, "Starting (%d) dora-notifier(s)...\n", numNotifiers);
+    for (int i=0; i<numNotifiers; i++) {
+        dora_notifier_t* aNotifier = new dora_notifier_t(_env, c_str("DNotifier-%d",i));
+        assert(aNotifier);
+        _notifiers.push_back(aNotifier);
+        aNotifier->fork();
+        aNotifier->start();
+    }
 }
 
 dora_flusher_t::~dora_flusher_t() 
@@ -71,6 +76,11 @@ dora_flusher_t::~dora_flusher_t()
 
     assert (_dora_flushing->is_empty());
     _dora_flushing.done();
+
+    for (uint_t i=0; i<_notifiers.size(); i++) {
+        delete (_notifiers[i]);
+    }
+    _notifiers.clear();
 }
 
 
@@ -111,7 +121,7 @@ int dora_flusher_t::_check_waiting(bool& bSleepNext,
             // send it directly back to the executor of its final-rvp
             if (durablelsn > xctlsn) {
                 //_send_to_last_executor(prvp);
-                _notifier->enqueue_tonotify(prvp);
+                _notifier_for(prvp)->enqueue_tonotify(prvp);
                 _stats.alreadyFlushed++;
             }
             else {
@@ -152,7 +162,7 @@ int dora_flusher_t::_move_from_flushing(const lsn_t& durablelsn)
         xctlsn = prvp->my_last_lsn();
         assert (xctlsn < durablelsn);
         //_send_to_last_executor(prvp);
-        _notifier->enqueue_tonotify(prvp);
+        _notifier_for(prvp)->enqueue_tonotify(prvp);
     }
 
     return (0); 
@@ -175,9 +185,11 @@ int dora_flusher_t::_pre_STOP_impl()
     uint afterStop = 0;
     terminal_rvp_t* prvp = NULL;
 
-    // Stop notifier
-    _notifier->stop();
-    _notifier->join();
+    // Stop notifier(s)
+    for (uint_t i=0; i<_notifiers.size(); i++) {
+        _notifiers[i]->stop();
+        _notifiers[i]->join();
+    }
 
     // Notify the clients and clean up queues
     // We don't need to notify the partitions about the actions because the
@@ -219,7 +231,8 @@ dora_notifier_t::dora_notifier_t(ShoreEnv* env,
                                  c_str tname,
                                  processorid_t aprsid, 
                                  const int use_sli) 
-    : base_worker_t(env, tname, aprsid, use_sli)
+    : base_worker_t(env, tname, aprsid, use_sli),
+      _batches(0), _notified(0)
 { 
     _pxct_tonotify_pool = new Pool(sizeof(xct_t*),FLUSHER_BUFFER_EXPECTED_SZ);
     _tonotify = new DoraQueue(_pxct_tonotify_pool.get());
@@ -263,19 +276,69 @@ int dora_notifier_t::_work_ACTIVE_impl()
         
         // It will block if empty
         prvp = _tonotify->pop(); 
+        if (!prvp) continue;
 
-        if (prvp) {
-            prvp->upd_committed_stats();
-            prvp->notify_partitions();
-            prvp->notify_client();
-            prvp->giveback();
-            prvp = NULL;
+        // Batch it, along with everything else that is already waiting
+        _add_to_batch(prvp);
+        while (!_tonotify->is_empty()) {
+            prvp = _tonotify->pop();
+            if (prvp) _add_to_batch(prvp);
         }
+
+        _notify_batch();
     }
     return (0);
 }
 
 
+/****************************************************************** 
+ *
+ * @fn:     _add_to_batch()
+ *
+ * @brief:  Adds a flushed xct to the batch under notification. Its 
+ *          committed actions are appended to the batch of their partition.
+ *
+ ******************************************************************/
+
+void dora_notifier_t::_add_to_batch(terminal_rvp_t* prvp)
+{
+    assert (prvp);
+    prvp->upd_committed_stats();
+    prvp->collect_committed(_part_batch);
+    _rvp_batch.push_back(prvp);
+}
+
+
+/****************************************************************** 
+ *
+ * @fn:     _notify_batch()
+ *
+ * @brief:  Enqueues the committed actions with a single push per 
+ *          partition, then notifies the clients and gives back the rvps
+ *
+ ******************************************************************/
+
+void dora_notifier_t::_notify_batch()
+{
+    for (PartActionsMap::iterator it=_part_batch.begin(); 
+         it!=_part_batch.end(); ++it) {
+        if (!it->second.empty()) {
+            it->first->enqueue_commit_batch(&(it->second[0]), it->second.size());
+            it->second.clear();
+        }
+    }
+
+    for (RvpVec::iterator it=_rvp_batch.begin(); it!=_rvp_batch.end(); ++it) {
+        (*it)->notify_client();
+        (*it)->giveback();
+    }
+
+    _batches++;
+    _notified += _rvp_batch.size();
+    _rvp_batch.clear();
+}
+
+
 
 /****************************************************************** 
  *
@@ -306,6 +369,11 @@ int dora_notifier_t::_pre_STOP_impl()
         TRACE( TRACE_ALWAYS, 
                "Xcts notified at stop (%d)\n",
                afterStop);
+
+    if (_batches>0) 
+        TRACE( TRACE_STATISTICS, 
+               "Notified (%d) xcts in (%d) batches\n",
+               _notified, _batches);
     return(0); 
 }
 
@@ -51,6 +51,7 @@ typedef partition_t<int> irpImpl;
  ********************************************************************/
 
 DoraEnv::DoraEnv()
+    : _shore_env(NULL)
 { 
     _check_type();
 }
@@ -121,6 +122,8 @@ int DoraEnv::_statistics(ShoreEnv* /* penv */)
         _irptp_vec[i]->statistics();
     }
 
+    _route_stats.print();
+
 #ifdef CFG_FLUSHER
     TRACE( TRACE_STATISTICS, "Flushers: (%d)\n", _num_flushers);
 
@@ -176,6 +179,8 @@ uint DoraEnv::_check_type()
 
 int DoraEnv::_post_start(ShoreEnv* penv)
 {
+    _shore_env = penv;
+
 #ifdef CFG_FLUSHER
     // Start the flusher
     TRACE( TRACE_ALWAYS, "Creating dora-flusher...\n");
@@ -275,6 +280,8 @@ w_rc_t DoraEnv::_newrun(ShoreEnv* /* penv */)
     for (uint i=0; i<_irptp_vec.size(); i++) {
         W_DO(_irptp_vec[i]->prepareNewRun());
     }
+    _route_stats.reset();
+    table_man_t::reset_rec_cache_stats();
     return (RCOK);
 }
 
@@ -209,6 +209,24 @@ int terminal_rvp_t::notify_partitions()
     return (_actions.size());
 }
 
+
+/****************************************************************** 
+ *
+ * @fn:    collect_committed()
+ *
+ * @brief: Instead of notifying each partition separately, it appends 
+ *         the committed actions to the batch of their partition
+ *
+ ******************************************************************/
+
+int terminal_rvp_t::collect_committed(PartActionsMap& partBatch)
+{
+    for (baseActionsIt it=_actions.begin(); it!=_actions.end(); ++it) {
+        partBatch[(*it)->own_partition()].push_back(*it);
+    }
+    return (_actions.size());
+}
+
 /****************************************************************** 
  *
  * @fn:    run()
@@ -245,11 +263,15 @@ w_rc_t terminal_rvp_t::_run()
 
     // try to commit    
     w_rc_t rcdec;
+#ifndef CFG_FLUSHER
+    bool bDurableNotify = false;
+#endif
     if (_decision == AD_ABORT) 
     {
         // We cannot abort lazily because log rollback works on 
         // disk-resident records
         rcdec = _db->abort_xct();
+        table_man_t::rec_cache_on_abort();
 
         if (rcdec.is_error()) 
         {
@@ -274,7 +296,15 @@ w_rc_t terminal_rvp_t::_run()
         rcdec = _db->commit_xct(true,&xctLastLsn);
         set_last_lsn(xctLastLsn);
 #else        
-        rcdec = _db->commit_xct();    
+        if (_denv->is_durable_notify()) {
+            // Commit lazily, the notifier tells when it is durable
+            lsn_t xctLastLsn;
+            rcdec = _db->commit_xct(true,&xctLastLsn);
+            set_last_lsn(xctLastLsn);
+        }
+        else {
+            rcdec = _db->commit_xct();    
+        }
 #endif
 
         if (rcdec.is_error()) {
@@ -282,6 +312,7 @@ w_rc_t terminal_rvp_t::_run()
                    _tid.get_lo(), rcdec.err_num());
             upd_aborted_stats();
             w_rc_t eabort = _db->abort_xct();
+            table_man_t::rec_cache_on_abort();
 
             if (eabort.is_error()) {
                 TRACE( TRACE_ALWAYS, "Xct (%d) abort failed [0x%x]\n",
@@ -297,9 +328,9 @@ w_rc_t terminal_rvp_t::_run()
             // DF2. Enqueue to the "to flush" queue of DFlusher             
             _denv->enqueue_toflush(this);
 #else
-            (void)_denv;
             TRACE( TRACE_TRX_FLOW, "Xct (%d) committed\n", _tid.get_lo());
             upd_committed_stats();
+            bDurableNotify = _denv->is_durable_notify();
 #endif
         }
     }    
@@ -309,6 +340,7 @@ w_rc_t terminal_rvp_t::_run()
     // client. Otherwise, we will not notify the client here, but only after we 
     // know that the xct had been flushed
     notify_client();
+    if (bDurableNotify) _denv->notify_when_durable(this);
 
     // In addition, if DFlusher is enabled, the notification of the partitions and the
     // giveback of the RVP will happen by the dflusher
@@ -0,0 +1,199 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   sec_idx.cpp
+ *
+ *  @brief:  Implementation of the partition-aware secondary index routing
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "dora/common.h"
+#include "dora/sec_idx.h"
+
+using namespace shore;
+
+ENTER_NAMESPACE(dora);
+
+
+/********************************************************************
+ *
+ *  @class: sec_idx_slice_t
+ *
+ ********************************************************************/
+
+bool sec_idx_slice_t::get(const string& seckey, vector<int>& pkeys)
+{
+    CRITICAL_SECTION(scs, _lock);
+    SliceMap::const_iterator it = _map.find(seckey);
+    if (it == _map.end()) {
+        ++_misses;
+        return (false);
+    }
+    ++_hits;
+    pkeys = it->second;
+    return (true);
+}
+
+void sec_idx_slice_t::put(const string& seckey, const vector<int>& pkeys)
+{
+    CRITICAL_SECTION(scs, _lock);
+    _map[seckey] = pkeys;
+}
+
+void sec_idx_slice_t::invalidate()
+{
+    CRITICAL_SECTION(scs, _lock);
+    _map.clear();
+}
+
+
+
+/********************************************************************
+ *
+ *  @class: sec_idx_router_t
+ *
+ ********************************************************************/
+
+sec_idx_router_t::sec_idx_router_t(const char* idxname,
+                                   irpTableImpl* ptable)
+    : _idxname(idxname), _ptable(ptable)
+{
+    assert (_idxname);
+    assert (_ptable);
+    reset();
+}
+
+sec_idx_router_t::~sec_idx_router_t()
+{
+    for (SlicePtrMap::iterator it = _slice_map.begin();
+         it != _slice_map.end(); ++it) {
+        delete (it->second);
+    }
+    _slice_map.clear();
+}
+
+
+/********************************************************************
+ *
+ *  @fn:    slice
+ *
+ *  @brief: Returns the slice of the partition that owns the routing key.
+ *          The slice is created the first time it is asked for.
+ *
+ ********************************************************************/
+
+sec_idx_slice_t* sec_idx_router_t::slice(const int rkey)
+{
+    cvec_t key((char*)&rkey,sizeof(int));
+    lpid_t pid;
+    w_rc_t r = _ptable->getPartIdxByKey(key,pid);
+    if (r.is_error()) { assert(false); return (NULL); }
+
+    CRITICAL_SECTION(rcs, _slice_lock);
+    sec_idx_slice_t*& pslice = _slice_map[pid.page];
+    if (!pslice) pslice = new sec_idx_slice_t();
+    return (pslice);
+}
+
+void sec_idx_router_t::invalidate()
+{
+    CRITICAL_SECTION(rcs, _slice_lock);
+    for (SlicePtrMap::iterator it = _slice_map.begin();
+         it != _slice_map.end(); ++it) {
+        it->second->invalidate();
+    }
+}
+
+void sec_idx_router_t::reset()
+{
+    _lookups = 0;
+    _slices = 0;
+
+    CRITICAL_SECTION(rcs, _slice_lock);
+    for (SlicePtrMap::iterator it = _slice_map.begin();
+         it != _slice_map.end(); ++it) {
+        it->second->reset_stats();
+    }
+}
+
+void sec_idx_router_t::statistics() const
+{
+    TRACE( TRACE_STATISTICS, "SecIdx (%s) -> (%s)\n",
+           _idxname, _ptable->table()->name());
+    TRACE( TRACE_STATISTICS, "Routed     (%d)\n", _lookups);
+    if (_slices) {
+        TRACE( TRACE_STATISTICS, "Slices     (%d)\n", _slices);
+    }
+
+    uint_t hits = 0;
+    uint_t misses = 0;
+    uint_t entries = 0;
+    for (SlicePtrMap::const_iterator it = _slice_map.begin();
+         it != _slice_map.end(); ++it) {
+        hits += it->second->hits();
+        misses += it->second->misses();
+        entries += it->second->size();
+    }
+    if (hits+misses) {
+        TRACE( TRACE_STATISTICS, "Slice hits (%d) misses (%d) keys (%d)\n",
+               hits, misses, entries);
+    }
+}
+
+
+
+/********************************************************************
+ *
+ *  @class: route_stats_t
+ *
+ ********************************************************************/
+
+void route_stats_t::reset()
+{
+    _trxs = 0;
+    _actions = 0;
+    _remote = 0;
+    _byname = 0;
+    _byname_us = 0;
+}
+
+void route_stats_t::print() const
+{
+    if (_trxs==0) return;
+
+    TRACE( TRACE_STATISTICS, "Routed trxs   (%d)\n", _trxs);
+    TRACE( TRACE_STATISTICS, "Actions/trx   (%.2f)\n",
+           (double)_actions/(double)_trxs);
+    TRACE( TRACE_STATISTICS, "XPart/trx     (%.2f)\n",
+           (double)_remote/(double)_trxs);
+
+    if (_byname) {
+        TRACE( TRACE_STATISTICS, "ByName lookups (%d)\n", _byname);
+        TRACE( TRACE_STATISTICS, "ByName latency (%.2f) us\n",
+               (double)_byname_us/(double)_byname);
+    }
+}
+
+
+EXIT_NAMESPACE(dora);
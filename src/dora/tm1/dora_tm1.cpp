@@ -111,6 +111,9 @@ int DoraTM1Env::start()
     // CALL FORWARDING
     GENERATE_DORA_PARTS(cf,cf);
 
+    // The SUB_NBR lookups go to the SUBSCRIBER partition that owns the slice
+    _subnbr_sidx = new sec_idx_router_t("SUB_NBR_IDX", sub());
+
     // Call the post-start procedure of the dora environment
     DoraEnv::_post_start(this);
     return (0);
@@ -279,6 +282,7 @@ int DoraTM1Env::conf()
 
 w_rc_t DoraTM1Env::newrun()
 {
+    if (_subnbr_sidx) _subnbr_sidx->reset();
     return (DoraEnv::_newrun(this));
 }
 
@@ -322,6 +326,7 @@ int DoraTM1Env::info() const
 int DoraTM1Env::statistics() 
 {
     DoraEnv::_statistics(this);
+    if (_subnbr_sidx) _subnbr_sidx->statistics();
     return (0);
 
     // TM1 STATS
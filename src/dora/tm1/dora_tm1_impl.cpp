@@ -487,7 +487,7 @@ w_rc_t upd_sub_usd_action::trx_exec()
 #ifndef TM1USD2
     if (_prvp->isAborted()) { W_DO(RC(de_MIDWAY_ABORT)); }
 #endif
-    W_DO(_penv->sub_man()->update_tuple(_penv->db(), prsub, NL));
+    W_DO(_penv->sub_man()->update_dirty(_penv->db(), prsub, NL));
 
 #ifdef PRINT_TRX_RESULTS
     // dumps the status of all the table rows used
@@ -531,7 +531,7 @@ w_rc_t upd_sf_usd_action::trx_exec()
 	   _tid.get_lo(), _in._s_id, _in._sf_type);
     W_DO(_penv->sf_man()->sf_idx_nl(_penv->db(), prsf, _in._s_id, _in._sf_type));
     prsf->set_value(4, _in._a_data);
-    W_DO(_penv->sf_man()->update_tuple(_penv->db(), prsf, NL));
+    W_DO(_penv->sf_man()->update_dirty(_penv->db(), prsf, NL));
 
 #ifdef PRINT_TRX_RESULTS
     // dumps the status of all the table rows used
@@ -619,7 +619,7 @@ w_rc_t upd_sub_usdmix_action::trx_exec()
 	   "App: %d USD:sub-idx-nl (%d)\n", _tid.get_lo(), _in._s_id);
     W_DO(_penv->sub_man()->sub_idx_nl(_penv->db(), prsub, _in._s_id));
     prsub->set_value(2, _in._a_bit);
-    W_DO(_penv->sub_man()->update_tuple(_penv->db(), prsub, NL));
+    W_DO(_penv->sub_man()->update_dirty(_penv->db(), prsub, NL));
 
 #ifdef PRINT_TRX_RESULTS
     // dumps the status of all the table rows used
@@ -663,7 +663,7 @@ w_rc_t upd_sf_usdmix_action::trx_exec()
 	   _tid.get_lo(), _in._s_id, _in._sf_type);
     W_DO(_penv->sf_man()->sf_idx_nl(_penv->db(), prsf, _in._s_id, _in._sf_type));
     prsf->set_value(4, _in._a_data);
-    W_DO(_penv->sf_man()->update_tuple(_penv->db(), prsf, NL));
+    W_DO(_penv->sf_man()->update_dirty(_penv->db(), prsf, NL));
 
 #ifdef PRINT_TRX_RESULTS
     // dumps the status of all the table rows used
@@ -730,7 +730,7 @@ w_rc_t upd_sub_ul_action::trx_exec()
     prsub->set_value(33, _in._vlr_loc);
     
     // 2. Update tuple
-    W_DO(_penv->sub_man()->update_tuple(_penv->db(), prsub, NL));
+    W_DO(_penv->sub_man()->update_dirty(_penv->db(), prsub, NL));
 
 #ifdef PRINT_TRX_RESULTS
     // dumps the status of all the table rows used
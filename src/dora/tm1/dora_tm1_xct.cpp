@@ -822,6 +822,10 @@ w_rc_t DoraTM1Env::dora_get_sub_nbr(const int xct_id,
 
     // Setup the final RVP with the correct intratrx
     final_gsn_rvp* frvp = new_final_gsn_rvp(pxct,atid,xct_id,atrt,intratrx);    
+
+    // Each action scans only the slice of SUB_NBR_IDX of its partition
+    _subnbr_sidx->add_slices(intratrx);
+    _route_stats.add_trx(intratrx, intratrx-1);
     
     // Generate and enqueue the actions
     for (vector<uint>::iterator vit = rangeVec.begin(); vit < rangeVec.end(); vit++) {
@@ -830,7 +834,7 @@ w_rc_t DoraTM1Env::dora_get_sub_nbr(const int xct_id,
         
         // Find partition and enqueue
         {        
-            irpImpl* my_sub_part = decide_part(sub(),in._s_id);
+            irpImpl* my_sub_part = _subnbr_sidx->route(in._s_id);
 
             // SUB_PART_CS
             CRITICAL_SECTION(sub_part_cs, my_sub_part->_enqueue_lock);
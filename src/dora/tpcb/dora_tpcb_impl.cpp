@@ -97,7 +97,7 @@ w_rc_t upd_br_action::trx_exec()
     prb->set_value(1, total + _in.delta);
     
     // 2. Update tuple
-    W_DO(_penv->branch_man()->update_tuple(_penv->db(), prb, NL));
+    W_DO(_penv->branch_man()->update_dirty(_penv->db(), prb, NL));
 
 #ifdef PRINT_TRX_RESULTS
     // dumps the status of all the table rows used
@@ -143,7 +143,7 @@ w_rc_t upd_te_action::trx_exec()
     prt->set_value(2, total + _in.delta);
     
     // 2. Update tuple
-    W_DO(_penv->teller_man()->update_tuple(_penv->db(), prt, NL));
+    W_DO(_penv->teller_man()->update_dirty(_penv->db(), prt, NL));
 
 #ifdef PRINT_TRX_RESULTS
     // dumps the status of all the table rows used
@@ -189,7 +189,7 @@ w_rc_t upd_ac_action::trx_exec()
     pra->set_value(2, total + _in.delta);
 
     // 2. Update tuple
-    W_DO(_penv->account_man()->update_tuple(_penv->db(), pra, NL));
+    W_DO(_penv->account_man()->update_dirty(_penv->db(), pra, NL));
 
 #ifdef PRINT_TRX_RESULTS
     // dumps the status of all the table rows used
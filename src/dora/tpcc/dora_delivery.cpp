@@ -381,7 +381,7 @@ w_rc_t upd_oline_del_action::trx_exec()
 	
 	// update orderline
 	prol->set_value(6, ts_start);
-	W_DO(_ptpccenv->order_line_man()->update_tuple(_ptpccenv->db(),
+	W_DO(_ptpccenv->order_line_man()->update_dirty(_ptpccenv->db(),
 						       prol, NL));
 	
 	// go to the next orderline
@@ -431,7 +431,7 @@ w_rc_t upd_cust_del_action::trx_exec()
     double balance;
     prcust->get_value(16, balance);
     prcust->set_value(16, balance+_amount);
-    W_DO(_ptpccenv->customer_man()->update_tuple(_ptpccenv->db(), prcust, NL));
+    W_DO(_ptpccenv->customer_man()->update_dirty(_ptpccenv->db(), prcust, NL));
 
 #ifdef PRINT_TRX_RESULTS
     // at the end of the transaction 
@@ -194,37 +194,46 @@ w_rc_t r_cust_ordst_action::trx_exec()
 	
 	assert (_in._c_select <= 60);
 	assert (_in._c_last);
-	
-	guard<index_scan_iter_impl<customer_t> > c_iter;
-	{
-	    index_scan_iter_impl<customer_t>* tmp_c_iter;
-	    TRACE( TRACE_TRX_FLOW, "App: %d ORDST:cust-iter-by-name-idx-nl\n", 
-		   _tid.get_lo());
-	    W_DO(_penv->customer_man()->cust_get_iter_by_index_nl(_penv->db(),
-								  tmp_c_iter,
-								  prcust, lowrep,
-								  highrep, w_id,
-								  d_id,
-								  _in._c_last));
-	    c_iter = tmp_c_iter;
-	}
-	
+
+	// Served from the slice of C_NAME_IDX of this partition, if possible
+	char cname[64];
+	snprintf(cname, sizeof(cname), "%d.%d.%s", w_id, d_id, _in._c_last);
+	string seckey(cname);
+	sec_idx_slice_t* pslice = _penv->cname_sidx()->slice(w_id);
+
 	vector<int> v_c_id;
-	int  a_c_id = 0;
-	int  count = 0;
-	bool eof;
+	if (!pslice->get(seckey, v_c_id)) {
+	    guard<index_scan_iter_impl<customer_t> > c_iter;
+	    {
+		index_scan_iter_impl<customer_t>* tmp_c_iter;
+		TRACE( TRACE_TRX_FLOW, "App: %d ORDST:cust-iter-by-name-idx-nl\n", 
+		       _tid.get_lo());
+		W_DO(_penv->customer_man()->cust_get_iter_by_index_nl(_penv->db(),
+								      tmp_c_iter,
+								      prcust, lowrep,
+								      highrep, w_id,
+								      d_id,
+								      _in._c_last));
+		c_iter = tmp_c_iter;
+	    }
+	
+	    int  a_c_id = 0;
+	    bool eof;
 	
-	W_DO(c_iter->next(_penv->db(), eof, *prcust));
-	while (!eof) {
-	    // push the retrieved customer id to the vector
-	    ++count;
-	    prcust->get_value(0, a_c_id);
-	    v_c_id.push_back(a_c_id);
-	    
-	    TRACE( TRACE_TRX_FLOW, "App: %d ORDST:cust-iter-next\n",
-		   _tid.get_lo());
 	    W_DO(c_iter->next(_penv->db(), eof, *prcust));
+	    while (!eof) {
+		// push the retrieved customer id to the vector
+		prcust->get_value(0, a_c_id);
+		v_c_id.push_back(a_c_id);
+	    
+		TRACE( TRACE_TRX_FLOW, "App: %d ORDST:cust-iter-next\n",
+		       _tid.get_lo());
+		W_DO(c_iter->next(_penv->db(), eof, *prcust));
+	    }
+	    pslice->put(seckey, v_c_id);
 	}
+
+	int count = v_c_id.size();
 	assert (count);
 	
 	// 1b. find the customer id in the middle of the list
@@ -239,8 +239,11 @@ w_rc_t upd_dist_pay_action::trx_exec()
 
 void upd_cust_pay_action::calc_keys() 
 {
-    _down.push_back(_pin._home_wh_id);
-    _down.push_back(_pin._home_d_id);
+    // The key is the customer's (WH|DIST), which may be remote
+    int c_w = _pin._v_cust_wh_selection>85 ? _pin._home_wh_id : _pin._remote_wh_id;
+    int c_d = _pin._v_cust_wh_selection>85 ? _pin._home_d_id : _pin._remote_d_id;
+    _down.push_back(c_w);
+    _down.push_back(c_d);
 }
 
 w_rc_t upd_cust_pay_action::trx_exec() 
@@ -270,42 +273,56 @@ w_rc_t upd_cust_pay_action::trx_exec()
 	
 	assert (_pin._v_cust_ident_selection <= 60);
 	assert (_pin._c_id == 0); // (ip) just checks the generator output
+
+	// The slice of C_NAME_IDX for (c_w) is owned by this partition.
+	// If it has already seen this name, there is no need for the scan.
+	stopwatch_t byname_timer;
+
+	char cname[64];
+	snprintf(cname, sizeof(cname), "%d.%d.%s", c_w, c_d, _pin._c_last);
+	string seckey(cname);
+	sec_idx_slice_t* pslice = _ptpccenv->cname_sidx()->slice(c_w);
+
+	vector<int> v_c_id;
+	if (!pslice->get(seckey, v_c_id)) {
+	    rep_row_t lowrep(_ptpccenv->customer_man()->ts());
+	    rep_row_t highrep(_ptpccenv->customer_man()->ts());
 	
-	rep_row_t lowrep(_ptpccenv->customer_man()->ts());
-	rep_row_t highrep(_ptpccenv->customer_man()->ts());
-	
-	TRACE( TRACE_TRX_FLOW, "App: %d PAY:cust-get-iter-by-name-index (%s)\n", 
-	       _tid.get_lo(), _pin._c_last);
+	    TRACE( TRACE_TRX_FLOW, "App: %d PAY:cust-get-iter-by-name-index (%s)\n", 
+		   _tid.get_lo(), _pin._c_last);
 	
-	guard<index_scan_iter_impl<customer_t> > c_iter;
-	{
-	    index_scan_iter_impl<customer_t>* tmp_c_iter;
-	    W_DO(_ptpccenv->customer_man()->
-		 cust_get_iter_by_index_nl(_ptpccenv->db(), tmp_c_iter, prcust, 
-					   lowrep, highrep, c_w, c_d,
-					   _pin._c_last));
-	    c_iter = tmp_c_iter;
-	}
+	    guard<index_scan_iter_impl<customer_t> > c_iter;
+	    {
+		index_scan_iter_impl<customer_t>* tmp_c_iter;
+		W_DO(_ptpccenv->customer_man()->
+		     cust_get_iter_by_index_nl(_ptpccenv->db(), tmp_c_iter, prcust, 
+					       lowrep, highrep, c_w, c_d,
+					       _pin._c_last));
+		c_iter = tmp_c_iter;
+	    }
 	
-	vector<int> v_c_id;
-	int a_c_id = 0;
-	int count = 0;
-	bool eof;
+	    int a_c_id = 0;
+	    bool eof;
 	
-	W_DO(c_iter->next(_ptpccenv->db(), eof, *prcust));
-	while (!eof) {
-	    count++;
-	    prcust->get_value(0, a_c_id);
-	    v_c_id.push_back(a_c_id);
-
-	    TRACE( TRACE_TRX_FLOW, "App: %d PAY:cust-iter-next (%d)\n", 
-		   _tid.get_lo(), a_c_id);
 	    W_DO(c_iter->next(_ptpccenv->db(), eof, *prcust));
+	    while (!eof) {
+		prcust->get_value(0, a_c_id);
+		v_c_id.push_back(a_c_id);
+
+		TRACE( TRACE_TRX_FLOW, "App: %d PAY:cust-iter-next (%d)\n", 
+		       _tid.get_lo(), a_c_id);
+		W_DO(c_iter->next(_ptpccenv->db(), eof, *prcust));
+	    }
+	    pslice->put(seckey, v_c_id);
 	}
+
+	int count = v_c_id.size();
 	assert (count);
 	
 	// find the customer id in the middle of the list
 	_pin._c_id = v_c_id[(count+1)/2-1];
+
+	_ptpccenv->route_stats()->add_byname(byname_timer.time_us());
     }
     assert (_pin._c_id>0);
 
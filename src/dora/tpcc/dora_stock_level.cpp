@@ -239,7 +239,7 @@ w_rc_t r_ol_stock_action::trx_exec()
      *       AND s_w_id = :w_id AND s_i_id = ol_i_id
      *       AND s_quantity < :threshold;
      *
-     *   Plan: 1. index scan on OL_IDX 
+     *   Plan: 1. index-only scan on OL_IDX (covers ol_i_id)
      *         2. sort ol tuples in the order of i_id from 1
      *         3. index scan on S_IDX
      *         4. fetch stock with sargable on quantity from 3
@@ -259,7 +259,7 @@ w_rc_t r_ol_stock_action::trx_exec()
 	W_DO(_penv->order_line_man()->
 	     ol_get_range_iter_by_index_nl(_penv->db(), tmp_ol_iter, prol, lowrep,
 					   highrep, w_id, d_id, _in._next_o_id-20,
-					   _in._next_o_id));
+					   _in._next_o_id, false));
 	ol_iter = tmp_ol_iter;
     }
     
@@ -141,6 +141,9 @@ int DoraTPCCEnv::start()
     // STOCK
     GENERATE_DORA_PARTS(sto,stock);
 
+    // The by-name lookups go to the CUSTOMER partition that owns the slice
+    _cname_sidx = new sec_idx_router_t("C_NAME_IDX", cus());
+
     // Call the pre-start procedure of the dora environment
     DoraEnv::_post_start(this);
     return (0);
@@ -376,6 +379,7 @@ int DoraTPCCEnv::conf()
 
 w_rc_t DoraTPCCEnv::newrun()
 {
+    if (_cname_sidx) _cname_sidx->reset();
     return (DoraEnv::_newrun(this));
 }
 
@@ -419,6 +423,7 @@ int DoraTPCCEnv::info() const
 int DoraTPCCEnv::statistics() 
 {
     DoraEnv::_statistics(this);
+    if (_cname_sidx) _cname_sidx->statistics();
 
     // TPCC STATS
     TRACE( TRACE_STATISTICS, "----- TPCC  -----\n");
@@ -258,10 +258,20 @@ w_rc_t DoraTPCCEnv::dora_payment(const int xct_id,
     {
         int wh = apin._home_wh_id;
 
+        // The customer may belong to a remote warehouse. The customer action
+        // is sent to the partition that owns the customer's warehouse. If the
+        // customer is selected by name, this partition owns also the slice of
+        // C_NAME_IDX with the customer, so the lookup completes in one hop.
+        int c_w = (apin._v_cust_wh_selection>85 ? wh : apin._remote_wh_id);
+
         // first, figure out to which partitions to enqueue
         irpImpl* my_wh_part   = decide_part(whs(),wh);
         irpImpl* my_dist_part = decide_part(dis(),wh);
-        irpImpl* my_cust_part = decide_part(cus(),wh);
+        irpImpl* my_cust_part = (apin._v_cust_ident_selection <= 60 ? 
+                                 _cname_sidx->route(c_w) : 
+                                 decide_part(cus(),c_w));
+
+        _route_stats.add_trx(3, (c_w==wh ? 0 : 1));
 
         // then, start enqueueing
 
@@ -347,7 +357,12 @@ w_rc_t DoraTPCCEnv::dora_order_status(const int xct_id,
         int wh = aordstin._wh_id;
 
         // first, figure out to which partitions to enqueue
-        irpImpl* my_cust_part = decide_part(cus(),wh);
+        // (if by name, to the owner of the C_NAME_IDX slice)
+        irpImpl* my_cust_part = (aordstin._c_id == 0 ? 
+                                 _cname_sidx->route(wh) : 
+                                 decide_part(cus(),wh));
+
+        _route_stats.add_trx(1, 0);
 
         // CUST_PART_CS
         CRITICAL_SECTION(cust_part_cs, my_cust_part->_enqueue_lock);
@@ -0,0 +1,167 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   build_cache.cpp
+ *
+ *  @brief:  Implementation of the QPipe build cache
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "util.h"
+#include "qpipe/core/build_cache.h"
+#include "sm/shore/shore_table.h"
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+#define MB (1024*1024)
+
+
+plan_cache_t build_cache_t::_cache("Build cache");
+
+
+
+/******************************************************************
+ *
+ *  @class: build_cache_entry_t
+ *
+ ******************************************************************/
+
+build_cache_entry_t::~build_cache_entry_t()
+{
+    delete _table;
+    for (page_list::iterator it = _pages.begin(); it != _pages.end(); ++it) {
+        (*it)->free();
+    }
+    _pages.clear();
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    init
+ *
+ *  @brief: Reads the size of the cache. With qpipe-bcache-mb=0 (the
+ *          default) no table is kept.
+ *
+ ******************************************************************/
+
+void build_cache_t::init()
+{
+    envVar* ev = envVar::instance();
+    int cache_mb = ev->getVarInt("qpipe-bcache-mb", 0);
+    if (cache_mb <= 0) {
+        _cache.set_size(0, 0);
+        return;
+    }
+
+    // a table may take the whole cache
+    _cache.set_size((size_t)cache_mb * MB, (size_t)cache_mb * MB);
+    shore::table_desc_t::set_track_versions(true);
+    TRACE( TRACE_ALWAYS, "Build cache (%d) MB\n", cache_mb);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    _key
+ *
+ *  @brief: The key of the table of the right relation of a join: the
+ *          signature of the plan of the relation, the key of the join
+ *          and whether duplicates are dropped. Returns false if the
+ *          plan is not cacheable.
+ *
+ ******************************************************************/
+
+bool build_cache_t::_key(query_plan const* right_plan, tuple_join_t* join,
+                         bool distinct, std::string& key,
+                         plan_cache_entry_t::version_list_t& versions)
+{
+    if (right_plan == NULL)
+        return (false);
+    if (!result_cache_t::signature(right_plan, key, versions))
+        return (false);
+
+    c_str suffix("|key(%zd, %zd):%zd:%d", join->right_key_offset(),
+                 join->key_size(), join->right_tuple_size(), distinct);
+    key += suffix.data();
+    return (true);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    lookup
+ *
+ *  @brief: Find a valid table for the right relation and pin it
+ *
+ ******************************************************************/
+
+build_cache_entry_t* build_cache_t::lookup(query_plan const* right_plan,
+                                           tuple_join_t* join, bool distinct)
+{
+    if (!is_enabled())
+        return (NULL);
+
+    std::string key;
+    plan_cache_entry_t::version_list_t versions;
+    if (!_key(right_plan, join, distinct, key, versions))
+        return (NULL);
+
+    return (static_cast<build_cache_entry_t*>(_cache.lookup(key)));
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    insert
+ *
+ *  @brief: Keep the table of the right relation, unless it is too
+ *          large or its tables were written while it was read
+ *
+ ******************************************************************/
+
+build_cache_entry_t* build_cache_t::insert(query_plan const* right_plan,
+                                           tuple_join_t* join, bool distinct,
+                                           build_table_t* table,
+                                           page_list& pages, size_t bytes)
+{
+    build_cache_entry_t* e = new build_cache_entry_t();
+    e->_table = table;
+    e->_pages.swap(pages);
+    e->_bytes = bytes;
+    e->_refs = 1;                // the caller
+
+    if (is_enabled() && _key(right_plan, join, distinct, e->_key, e->_versions))
+        _cache.insert(e);
+    return (e);
+}
+
+
+EXIT_NAMESPACE(qpipe);
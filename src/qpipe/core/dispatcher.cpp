@@ -23,6 +23,9 @@
 
 #include "util.h"
 #include "qpipe/core/dispatcher.h"
+#include "qpipe/core/result_cache.h"
+#include "qpipe/stages/rscan.h"
+#include "qpipe/stages/cscan.h"
 
 #include <cstdio>
 #include <cstring>
@@ -86,11 +89,79 @@ void dispatcher_t::_dispatch_packet(packet_t* packet) {
   if (sc == NULL)
     THROW2(DispatcherException, 
            "Packet type %s unregistered\n", packet->_packet_type.data());
+
+  if (result_cache_t::is_enabled() && packet->unreserve_worker_on_completion()) {
+    result_cache_entry_t* entry = result_cache_t::lookup(packet->plan());
+    if (entry) {
+      _replay_cached_result(packet, entry);
+      return;
+    }
+  }
+
+  if (cscan_stage_t::is_enabled()
+      && (packet->_packet_type == tscan_packet_t::PACKET_TYPE)) {
+    _dispatch_circular_scan((tscan_packet_t*)packet);
+    return;
+  }
+
   sc->enqueue(packet);
 }
 
 
 
+/**
+ *  @brief Hand a table scan over to the circular scan of its table. A
+ *  CSCAN packet takes over the output buffer and the filter of the
+ *  packet. The TSCAN worker reserved for the packet is released, as
+ *  when the packet merges, and the packet is deleted.
+ *
+ *  THIS FUNCTION IS NOT THREAD-SAFE IF MAP LOOKUP IS NOT THREAD SAFE.
+ */
+void dispatcher_t::_dispatch_circular_scan(tscan_packet_t* packet) {
+
+  _reserve_workers(cscan_packet_t::PACKET_TYPE, 1);
+  cscan_packet_t* cscan = new cscan_packet_t(packet);
+
+  guard<worker_releaser_t> wr = releaser_acquire();
+  packet->declare_worker_needs(wr);
+  wr->release_resources();
+  delete packet;
+
+  _scdir[cscan->_packet_type]->enqueue(cscan);
+}
+
+
+
+/**
+ *  @brief Answer the packet from the result cache. An RSCAN packet
+ *  takes over the output buffer of the packet and replays the cached
+ *  result. The workers reserved for the packet and its subtree are
+ *  released, as when the packet merges, and the packet is deleted
+ *  without its subtree ever being dispatched.
+ *
+ *  THIS FUNCTION IS NOT THREAD-SAFE IF MAP LOOKUP IS NOT THREAD SAFE.
+ */
+void dispatcher_t::_replay_cached_result(packet_t* packet,
+                                         result_cache_entry_t* entry) {
+
+  TRACE(TRACE_DEBUG, "%s answered from the result cache\n",
+        packet->_packet_id.data());
+
+  _reserve_workers(rscan_packet_t::PACKET_TYPE, 1);
+  rscan_packet_t* rscan =
+    new rscan_packet_t(packet->_packet_id, packet->release_output_buffer(), entry);
+  rscan->assign_query_state(packet->get_query_state());
+
+  guard<worker_releaser_t> wr = releaser_acquire();
+  packet->declare_worker_needs(wr);
+  wr->release_resources();
+  delete packet;
+
+  _scdir[rscan->_packet_type]->enqueue(rscan);
+}
+
+
+
 /**
  *  @brief THIS FUNCTION IS NOT THREAD-SAFE IF MAP LOOKUP IS NOT
  *  THREAD SAFE.
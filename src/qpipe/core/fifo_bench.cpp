@@ -0,0 +1,222 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   fifo_bench.cpp
+ *
+ *  @brief:  Microbenchmark of the throughput of the tuple_fifo
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "util.h"
+#include "util/stopwatch.h"
+#include "qpipe/core/tuple_fifo.h"
+#include "qpipe/core/fifo_bench.h"
+
+#include <cstring>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+const size_t FIFO_BENCH_DEFAULT_TUPLES = 10000000;
+
+const size_t FIFO_BENCH_SIZES[] = { 8, 16, 32, 64, 128, 256, 512, 1024 };
+const int    FIFO_BENCH_NUM_SIZES = sizeof(FIFO_BENCH_SIZES)/sizeof(size_t);
+
+
+
+/******************************************************************
+ *
+ *  @class: fifo_bench_producer_t
+ *
+ *  @brief: Writes the tuples to the FIFO and sends EOF
+ *
+ ******************************************************************/
+
+class fifo_bench_producer_t
+{
+    tuple_fifo*    _fifo;
+    size_t         _count;
+    eFifoBenchMode _mode;
+
+public:
+
+    fifo_bench_producer_t(tuple_fifo* fifo, const size_t count,
+                          const eFifoBenchMode mode)
+        : _fifo(fifo), _count(count), _mode(mode)
+    {
+    }
+
+    void run() {
+        size_t size = _fifo->tuple_size();
+        array_guard_t<char> src = new char[size];
+        memset(src, 0, size);
+
+        _fifo->writer_init();
+
+        if (_mode == FIFO_BENCH_TUPLE) {
+            for (size_t i=0; i<_count; i++) {
+                memcpy(src, &i, sizeof(i));
+                tuple_t out = _fifo->allocate();
+                memcpy(out.data, src, size);
+            }
+        }
+        else {
+            size_t i = 0;
+            while (i < _count) {
+                tuple_t out;
+                size_t n = _fifo->reserve(_count - i, out);
+                for (size_t k=0; k<n; k++, i++) {
+                    memcpy(src, &i, sizeof(i));
+                    memcpy(out.data, src, size);
+                    out.data += size;
+                }
+                _fifo->commit(n);
+            }
+        }
+
+        // the consumer deletes the FIFO after joining us
+        _fifo->send_eof();
+    }
+};
+
+
+
+/******************************************************************
+ *
+ *  @fn:    fifo_bench
+ *
+ *  @brief: Runs the producer in a new thread and consumes in the
+ *          calling one
+ *
+ ******************************************************************/
+
+double fifo_bench(const size_t tuple_size, const size_t tuple_count,
+                  const eFifoBenchMode mode)
+{
+    assert (tuple_size >= sizeof(size_t));
+
+    tuple_fifo* fifo = new tuple_fifo(tuple_size);
+    fifo_bench_producer_t producer(fifo, tuple_count, mode);
+
+    stopwatch_t timer;
+    thread_t* thread = member_func_thread(&producer,
+                                          &fifo_bench_producer_t::run,
+                                          c_str("FIFO_BENCH_PRODUCER"));
+    pthread_t tid = thread_create(thread);
+
+    size_t received = 0;
+    size_t checksum = 0;
+    size_t key;
+    if (mode == FIFO_BENCH_TUPLE) {
+        tuple_t in;
+        while (fifo->get_tuple(in)) {
+            memcpy(&key, in.data, sizeof(key));
+            checksum += key;
+            received++;
+        }
+    }
+    else {
+        page::iterator it, end;
+        while (size_t n = fifo->get_tuples(it, end)) {
+            for ( ; it != end; ++it) {
+                memcpy(&key, it->data, sizeof(key));
+                checksum += key;
+            }
+            received += n;
+        }
+    }
+    double secs = timer.time();
+
+    thread_join<void>(tid);
+    delete (fifo);
+
+    // the keys are 0 .. tuple_count-1
+    size_t expected = (tuple_count ? tuple_count*(tuple_count-1)/2 : 0);
+    if ((received != tuple_count) || (checksum != expected)) {
+        TRACE( TRACE_ALWAYS, "Received (%lld) of (%lld) tuples, bad checksum\n",
+               (long long)received, (long long)tuple_count);
+        return (-1.0);
+    }
+    return ((secs > 0.0)? (double)tuple_count/secs : 0.0);
+}
+
+
+
+/******************************************************************
+ *
+ *  @class: fifobench_cmd_t
+ *
+ ******************************************************************/
+
+void fifobench_cmd_t::setaliases()
+{
+    _name = string("fifobench");
+    _aliases.push_back("fifobench");
+}
+
+
+int fifobench_cmd_t::handle(const char* cmd)
+{
+    char cmd_tag[SERVER_COMMAND_BUFFER_SIZE];
+    char count_tag[SERVER_COMMAND_BUFFER_SIZE];
+    size_t count = FIFO_BENCH_DEFAULT_TUPLES;
+    if (sscanf(cmd, "%s %s", cmd_tag, count_tag) == 2) {
+        long long c = atoll(count_tag);
+        if (c <= 0) {
+            usage();
+            return (SHELL_NEXT_CONTINUE);
+        }
+        count = (size_t)c;
+    }
+
+    TRACE( TRACE_ALWAYS, "FIFO throughput, (%lld) tuples per run\n",
+           (long long)count);
+    for (int i=0; i<FIFO_BENCH_NUM_SIZES; i++) {
+        size_t size = FIFO_BENCH_SIZES[i];
+        double tps = fifo_bench(size, count, FIFO_BENCH_TUPLE);
+        double bps = fifo_bench(size, count, FIFO_BENCH_BATCH);
+        TRACE( TRACE_ALWAYS,
+               "size (%4d) tuple (%8.2f) Mtps batch (%8.2f) Mtps speedup (%.2f)\n",
+               (int)size, tps/1e6, bps/1e6, ((tps > 0.0)? bps/tps : 0.0));
+    }
+    return (SHELL_NEXT_CONTINUE);
+}
+
+
+void fifobench_cmd_t::usage()
+{
+    TRACE( TRACE_ALWAYS,
+           "fifobench [<tuples>] - Measures the tuple_fifo throughput in tuples/sec\n" \
+           "                       per tuple size, per-tuple vs. batch interface\n");
+}
+
+
+string fifobench_cmd_t::desc() const
+{
+    return string("Measures the throughput of the QPipe tuple FIFO");
+}
+
+
+EXIT_NAMESPACE(qpipe);
@@ -76,6 +76,7 @@ packet_t::packet_t(const c_str    &packet_id,
       _packet_id("%s_%s", thread_get_self()->thread_name().data(), packet_id.data()),
       _packet_type(packet_type),
       _output_buffer(output_buffer),
+      _rfilter(NULL),
       _output_filter(output_filter),
       _next_tuple_on_merge(stage_container_t::NEXT_TUPLE_UNINITIALIZED),
       _next_tuple_needed  (stage_container_t::NEXT_TUPLE_INITIAL_VALUE)
@@ -101,6 +102,9 @@ packet_t::~packet_t(void) {
     TRACE(TRACE_PACKET_FLOW, "Destroying %s packet with ID %s\n",
 	  _packet_type.data(),
 	  _packet_id.data());
+
+    if (_rfilter)
+        _rfilter->release();
 }
 
 
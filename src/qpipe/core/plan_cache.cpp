@@ -0,0 +1,246 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   plan_cache.cpp
+ *
+ *  @brief:  Implementation of the cache shared by the QPipe result and
+ *           build caches
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "qpipe/core/plan_cache.h"
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+#define MB (1024*1024)
+
+
+
+/******************************************************************
+ *
+ *  @class: plan_cache_entry_t
+ *
+ ******************************************************************/
+
+plan_cache_entry_t::~plan_cache_entry_t()
+{
+    assert (_refs == 0);
+}
+
+
+/**
+ *  @brief An entry is valid if none of the tables it read has been
+ *  written since its plan was created.
+ */
+bool plan_cache_entry_t::is_valid() const
+{
+    for (version_list_t::const_iterator it = _versions.begin();
+         it != _versions.end(); ++it) {
+        if (*(it->first) != it->second)
+            return (false);
+    }
+    return (true);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    Construction/destruction
+ *
+ ******************************************************************/
+
+plan_cache_t::plan_cache_t(const char* name)
+    : _name(name), _lock(thread_mutex_create()),
+      _max_bytes(0), _max_entry_bytes(0), _bytes(0),
+      _hits(0), _misses(0), _inserts(0), _invalidations(0), _evictions(0)
+{
+}
+
+
+void plan_cache_t::set_size(size_t max_bytes, size_t max_entry_bytes)
+{
+    _max_bytes = max_bytes;
+    _max_entry_bytes = max_entry_bytes;
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    _unlink/_unpin
+ *
+ *  @brief: Remove an entry from the cache and drop a reference to an
+ *          entry. The caller must hold the _lock.
+ *
+ ******************************************************************/
+
+void plan_cache_t::_unlink(plan_cache_entry_t* e)
+{
+    assert (e->_cached);
+    _entries.erase(e->_key);
+    _lru.erase(e->_lru);
+    _bytes -= e->_bytes;
+    e->_cached = false;
+    _unpin(e);
+}
+
+
+void plan_cache_t::_unpin(plan_cache_entry_t* e)
+{
+    assert (e->_refs > 0);
+    if (--e->_refs == 0)
+        delete e;
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    lookup/release
+ *
+ *  @brief: Find a valid entry and pin it. Stale entries are dropped
+ *          here, that is writes do not search the cache.
+ *
+ ******************************************************************/
+
+plan_cache_entry_t* plan_cache_t::lookup(const std::string& key)
+{
+    critical_section_t cs(_lock);
+
+    entry_map_t::iterator it = _entries.find(key);
+    if (it == _entries.end()) {
+        ++_misses;
+        return (NULL);
+    }
+
+    plan_cache_entry_t* e = it->second;
+    if (!e->is_valid()) {
+        // some table was written after the entry was computed
+        ++_invalidations;
+        ++_misses;
+        _unlink(e);
+        return (NULL);
+    }
+
+    ++_hits;
+    ++e->_refs;
+    _lru.erase(e->_lru);
+    _lru.push_front(e);
+    e->_lru = _lru.begin();
+    return (e);
+}
+
+
+void plan_cache_t::release(plan_cache_entry_t* e)
+{
+    assert (e);
+    critical_section_t cs(_lock);
+    _unpin(e);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    insert
+ *
+ *  @brief: Keep an entry, evicting the least recently used entries
+ *          to make room for it. An entry with the same key is
+ *          replaced.
+ *
+ ******************************************************************/
+
+bool plan_cache_t::insert(plan_cache_entry_t* e)
+{
+    assert (e);
+    if (!is_enabled() || (e->_bytes > _max_entry_bytes) || !e->is_valid())
+        // the tables were written while the entry was computed
+        return (false);
+
+    critical_section_t cs(_lock);
+
+    entry_map_t::iterator it = _entries.find(e->_key);
+    if (it != _entries.end())
+        _unlink(it->second);
+
+    while (_bytes + e->_bytes > _max_bytes) {
+        assert (!_lru.empty());
+        ++_evictions;
+        _unlink(_lru.back());
+    }
+
+    ++e->_refs;                  // the cache
+    e->_cached = true;
+    _lru.push_front(e);
+    e->_lru = _lru.begin();
+    _entries[e->_key] = e;
+    _bytes += e->_bytes;
+    ++_inserts;
+    return (true);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    print_stats/reset_stats
+ *
+ ******************************************************************/
+
+void plan_cache_t::print_stats()
+{
+    if (!is_enabled()) return;
+
+    critical_section_t cs(_lock);
+    uint64_t lookups = _hits + _misses;
+    TRACE( TRACE_ALWAYS,
+           "%s: hits (%lld) misses (%lld) hit ratio (%.1f%%)\n",
+           _name, (long long)_hits, (long long)_misses,
+           (lookups ? 100.0*(double)_hits/(double)lookups : 0.0));
+    TRACE( TRACE_ALWAYS,
+           "%s: inserts (%lld) invalidations (%lld) evictions (%lld)\n",
+           _name, (long long)_inserts, (long long)_invalidations,
+           (long long)_evictions);
+    TRACE( TRACE_ALWAYS,
+           "%s: entries (%d) memory (%.1f/%.1f MB)\n",
+           _name, (int)_entries.size(), (double)_bytes/(double)MB,
+           (double)_max_bytes/(double)MB);
+}
+
+
+void plan_cache_t::reset_stats()
+{
+    critical_section_t cs(_lock);
+    _hits = 0;
+    _misses = 0;
+    _inserts = 0;
+    _invalidations = 0;
+    _evictions = 0;
+}
+
+
+EXIT_NAMESPACE(qpipe);
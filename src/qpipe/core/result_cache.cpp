@@ -0,0 +1,193 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   result_cache.cpp
+ *
+ *  @brief:  Implementation of the QPipe result cache
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "util.h"
+#include "qpipe/core/result_cache.h"
+#include "sm/shore/shore_table.h"
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+#define MB (1024*1024)
+
+
+plan_cache_t result_cache_t::_cache("Result cache");
+
+
+
+/******************************************************************
+ *
+ *  @class: result_cache_entry_t
+ *
+ ******************************************************************/
+
+result_cache_entry_t::~result_cache_entry_t()
+{
+    for (page_list::iterator it = _pages.begin(); it != _pages.end(); ++it) {
+        (*it)->free();
+    }
+    _pages.clear();
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    init
+ *
+ *  @brief: Reads the size of the cache. With qpipe-rcache-mb=0 (the
+ *          default) nothing is cached.
+ *
+ ******************************************************************/
+
+void result_cache_t::init()
+{
+    envVar* ev = envVar::instance();
+    int cache_mb = ev->getVarInt("qpipe-rcache-mb", 0);
+    int entry_mb = ev->getVarInt("qpipe-rcache-entry-mb", 16);
+    if (cache_mb <= 0) {
+        _cache.set_size(0, 0);
+        return;
+    }
+    if ((entry_mb <= 0) || (entry_mb > cache_mb)) entry_mb = cache_mb;
+
+    _cache.set_size((size_t)cache_mb * MB, (size_t)entry_mb * MB);
+    shore::table_desc_t::set_track_versions(true);
+    TRACE( TRACE_ALWAYS, "Result cache (%d) MB, entries up to (%d) MB\n",
+           cache_mb, entry_mb);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    signature
+ *
+ *  @brief: Appends the signature of the plan to key and the versions
+ *          of the tables it reads to versions. Returns false if the
+ *          plan is not cacheable, that is if any of its leaves is not
+ *          a table.
+ *
+ ******************************************************************/
+
+bool result_cache_t::signature(query_plan const* plan, std::string& key,
+                               plan_cache_entry_t::version_list_t& versions)
+{
+    key += plan->action.data();
+    key += '{';
+    key += plan->filter.data();
+    key += '}';
+
+    if (plan->child_count == 0) {
+        if (plan->version == NULL)
+            return (false);
+        versions.push_back(plan_cache_entry_t::version_t(plan->version,
+                                                         plan->version_seen));
+        return (true);
+    }
+
+    key += '(';
+    for (int i=0; i < plan->child_count; i++) {
+        query_plan const* child = plan->child_plans[i];
+        if (child == NULL)
+            return (false);
+        if (i > 0)
+            key += ';';
+        if (!signature(child, key, versions))
+            return (false);
+    }
+    key += ')';
+    return (true);
+}
+
+
+bool result_cache_t::is_cacheable(query_plan const* plan)
+{
+    if (plan == NULL)
+        return (false);
+
+    std::string key;
+    plan_cache_entry_t::version_list_t versions;
+    return (signature(plan, key, versions));
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    lookup
+ *
+ *  @brief: Find a valid result for the plan and pin it
+ *
+ ******************************************************************/
+
+result_cache_entry_t* result_cache_t::lookup(query_plan const* plan)
+{
+    if (!is_enabled() || (plan == NULL))
+        return (NULL);
+
+    std::string key;
+    plan_cache_entry_t::version_list_t versions;
+    if (!signature(plan, key, versions))
+        return (NULL);
+
+    return (static_cast<result_cache_entry_t*>(_cache.lookup(key)));
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    insert
+ *
+ *  @brief: Keep the result of the plan, unless it is too large or
+ *          its tables were written while it was computed
+ *
+ ******************************************************************/
+
+void result_cache_t::insert(query_plan const* plan, size_t tuple_size,
+                            page_list& pages, size_t bytes)
+{
+    guard<result_cache_entry_t> e = new result_cache_entry_t();
+    e->_tuple_size = tuple_size;
+    e->_pages.swap(pages);
+    e->_bytes = bytes;
+
+    if (!is_enabled() || !signature(plan, e->_key, e->_versions))
+        return;
+
+    // The cache holds the only reference
+    if (_cache.insert(e.get()))
+        e.release();
+}
+
+
+EXIT_NAMESPACE(qpipe);
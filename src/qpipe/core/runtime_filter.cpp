@@ -0,0 +1,223 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   runtime_filter.cpp
+ *
+ *  @brief:  Implementation of the hash join runtime filters
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "util.h"
+#include "qpipe/core/runtime_filter.h"
+
+#include <cstring>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+#define MB (1024*1024)
+
+
+pthread_mutex_t runtime_filter_t::_stats_lock = thread_mutex_create();
+
+bool     runtime_filter_t::_enabled = true;
+int      runtime_filter_t::_bits_per_key = 10;
+uint64_t runtime_filter_t::_g_filters = 0;
+uint64_t runtime_filter_t::_g_published = 0;
+uint64_t runtime_filter_t::_g_useless = 0;
+uint64_t runtime_filter_t::_g_checked = 0;
+uint64_t runtime_filter_t::_g_dropped = 0;
+uint64_t runtime_filter_t::_g_dropped_bytes = 0;
+
+
+
+/******************************************************************
+ *
+ *  @fn:    init
+ *
+ *  @brief: Reads whether the hash joins publish runtime filters and
+ *          how many bits per key they use
+ *
+ ******************************************************************/
+
+void runtime_filter_t::init()
+{
+    envVar* ev = envVar::instance();
+    _enabled = (ev->getVarInt("qpipe-rfilter", 1) != 0);
+    _bits_per_key = ev->getVarInt("qpipe-rfilter-bits", 10);
+    if (_bits_per_key < 1) _bits_per_key = 1;
+    if (_enabled) {
+        TRACE( TRACE_ALWAYS, "Runtime filters with (%d) bits per key\n",
+               _bits_per_key);
+    }
+}
+
+
+
+runtime_filter_t::runtime_filter_t(const size_t key_offset,
+                                   const size_t key_size)
+    : _key_offset(key_offset), _key_size(key_size),
+      _block_mask(0), _keys(0), _ready(false), _refs(1),
+      _useless(false), _checked(0), _dropped(0), _dropped_bytes(0)
+{
+}
+
+
+/**
+ *  @brief Adds the counters of the filter to the global ones
+ */
+runtime_filter_t::~runtime_filter_t()
+{
+    critical_section_t cs(_stats_lock);
+    ++_g_filters;
+    if (_ready) ++_g_published;
+    if (_useless) ++_g_useless;
+    _g_checked += _checked;
+    _g_dropped += _dropped;
+    _g_dropped_bytes += _dropped_bytes;
+}
+
+
+void runtime_filter_t::release()
+{
+    if (atomic_dec_32_nv(&_refs) == 0)
+        delete this;
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    publish
+ *
+ *  @brief: Sizes the filter to _bits_per_key bits per key, rounded
+ *          up to a power of two blocks, and sets the bits of the keys
+ *
+ ******************************************************************/
+
+void runtime_filter_t::publish(const std::vector<uint32_t>& hashes)
+{
+    assert (!_ready);
+
+    size_t bits = hashes.size() * _bits_per_key;
+    size_t blocks = 1;
+    while (blocks * RF_BLOCK_WORDS * 64 < bits)
+        blocks *= 2;
+    size_t bytes = blocks * RF_BLOCK_WORDS * sizeof(uint64_t);
+    if (bytes > RF_MAX_BYTES) {
+        TRACE( TRACE_DEBUG, "Runtime filter on (%d) keys too large\n",
+               (int)hashes.size());
+        return;
+    }
+
+    _bits = new uint64_t[blocks * RF_BLOCK_WORDS];
+    memset(_bits, 0, bytes);
+    _block_mask = blocks - 1;
+    _keys = hashes.size();
+
+    for (size_t k=0; k<hashes.size(); k++) {
+        uint32_t h = hashes[k];
+        uint64_t* block = (uint64_t*)_block(h);
+        uint64_t s = _spread(h);
+        for (int i=0; i<RF_PROBES; i++) {
+            uint32_t bit = (uint32_t)(s >> (64 - 9*(i+1))) & 511;
+            block[bit >> 6] |= (1ULL << (bit & 63));
+        }
+    }
+
+    // the bits before the flag
+    membar_producer();
+    _ready = true;
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    update
+ *
+ *  @brief: Called by the producer of the filtered side, after each
+ *          page. Gives up a filter that does not drop enough.
+ *
+ ******************************************************************/
+
+void runtime_filter_t::update(const size_t checked, const size_t dropped,
+                              const size_t tuple_size)
+{
+    bool sampled = (_checked < RF_SAMPLE);
+    _checked += checked;
+    _dropped += dropped;
+    _dropped_bytes += dropped * tuple_size;
+
+    if (sampled && (_checked >= RF_SAMPLE)
+        && (_dropped * RF_USELESS_RATIO < _checked)) {
+        TRACE( TRACE_DEBUG,
+               "Runtime filter dropped (%d) of (%d) tuples, giving up\n",
+               (int)_dropped, (int)_checked);
+        _useless = true;
+    }
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    print_stats/reset_stats
+ *
+ ******************************************************************/
+
+void runtime_filter_t::print_stats()
+{
+    if (!is_enabled()) return;
+
+    critical_section_t cs(_stats_lock);
+    TRACE( TRACE_ALWAYS,
+           "Runtime filters: created (%lld) published (%lld) given up (%lld)\n",
+           (long long)_g_filters, (long long)_g_published,
+           (long long)_g_useless);
+    TRACE( TRACE_ALWAYS,
+           "Runtime filters: checked (%lld) dropped (%lld) selectivity (%.1f%%)\n",
+           (long long)_g_checked, (long long)_g_dropped,
+           (_g_checked ? 100.0*(double)(_g_checked-_g_dropped)/(double)_g_checked
+            : 100.0));
+    TRACE( TRACE_ALWAYS,
+           "Runtime filters: FIFO traffic saved (%.1f MB)\n",
+           (double)_g_dropped_bytes/(double)MB);
+}
+
+
+void runtime_filter_t::reset_stats()
+{
+    critical_section_t cs(_stats_lock);
+    _g_filters = 0;
+    _g_published = 0;
+    _g_useless = 0;
+    _g_checked = 0;
+    _g_dropped = 0;
+    _g_dropped_bytes = 0;
+}
+
+
+EXIT_NAMESPACE(qpipe);
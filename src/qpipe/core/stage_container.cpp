@@ -23,6 +23,7 @@
 
 #include "qpipe/core/stage_container.h"
 #include "qpipe/core/dispatcher.h"
+#include "qpipe/core/result_cache.h"
 #include "util.h"
 
 #include <cstdio>
@@ -531,7 +532,12 @@ stage_container_t::stage_adaptor_t::stage_adaptor_t(stage_container_t* container
       _next_tuple(NEXT_TUPLE_INITIAL_VALUE),
       _still_accepting_packets(true),
       _contains_late_merger(false),
-      _cancelled(false)
+      _circular(false),
+      _cycle_start(NEXT_TUPLE_INITIAL_VALUE),
+      _cancelled(false),
+      _rc_recording(false),
+      _rc_tuple_size(0),
+      _rc_bytes(0)
 {
     
     assert( !packet_list->empty() );
@@ -552,6 +558,17 @@ stage_container_t::stage_adaptor_t::stage_adaptor_t(stage_container_t* container
         packet->_next_tuple_on_merge = NEXT_TUPLE_INITIAL_VALUE;
 	packet->output_buffer()->writer_init();
     }
+
+    // Record the output of the primary for the result cache, if it is
+    // going to receive all of it and no join filters it.
+    if ( result_cache_t::is_enabled()
+         && (_packet->runtime_filter() == NULL)
+         && _packet->unreserve_worker_on_completion()
+         && (_packet->_next_tuple_needed == NEXT_TUPLE_INITIAL_VALUE)
+         && result_cache_t::is_cacheable(_packet->plan()) ) {
+        _rc_recording = true;
+        _rc_tuple_size = _packet->output_buffer()->tuple_size();
+    }
 }
 
 
@@ -606,11 +623,13 @@ stage_container_t::merge_t stage_container_t::stage_adaptor_t::try_merge(packet_
     // If we are here, we detected work sharing!
     _packet_list->push_front(packet);
     packet->_next_tuple_on_merge = _next_tuple;
-    if ((_next_tuple == NEXT_TUPLE_INITIAL_VALUE) || _contains_late_merger)
+    if ((_next_tuple == NEXT_TUPLE_INITIAL_VALUE) || _contains_late_merger
+        || _circular)
         /* Either we will be done when the primary packet finishes or
            there is already a late merger within the packet chain. In
            the latter case, the late merger has enough worker threads
-           reserved for both of us. */
+           reserved for both of us. A circular stage wraps around for
+           the late mergers itself. */
         ret = stage_container_t::MERGE_SUCCESS_RELEASE_RESOURCES;
     else {
         /* We are are a late merger (and we are the first late
@@ -681,24 +700,58 @@ void stage_container_t::stage_adaptor_t::output_page(page* p) {
 	tuple_fifo* output_buffer = curr_packet->output_buffer();
 	tuple_filter_t* output_filter = curr_packet->_output_filter;
         bool terminate_curr_packet = false;
+        bool record = _rc_recording && (curr_packet == _packet);
+
+        // the runtime filter of the join that reads this packet, once
+        // it is published
+        runtime_filter_t* rfilter = curr_packet->runtime_filter();
+        if (rfilter && !rfilter->is_ready())
+            rfilter = NULL;
+        size_t rf_checked = 0;
+        size_t rf_dropped = 0;
+
         try {
             
             // Drain all tuples in output page into the current packet's
-            // output buffer.
+            // output buffer. We reserve space in the output buffer for
+            // as many tuples as the page holds, project the selected
+            // ones into it, and commit them in one batch.
             page::iterator page_it = p->begin();
             while(page_it != pend) {
 
-                // apply current packet's filter to this tuple
-                tuple_t in_tup = page_it.advance();
-                if(output_filter->select(in_tup)) {
-
-                    // this tuple selected by filter!
-
-                    // allocate space in the output buffer and project into it
-                    tuple_t out_tup = output_buffer->allocate();
-                    output_filter->project(out_tup, in_tup);
+                tuple_t out_tup;
+                size_t reserved = output_buffer->reserve(p->tuple_count(), out_tup);
+                size_t filled = 0;
+                while((filled < reserved) && (page_it != pend)) {
+
+                    // apply current packet's filter to this tuple
+                    tuple_t in_tup = page_it.advance();
+                    if(output_filter->select(in_tup)) {
+
+                        // this tuple selected by filter! project it into
+                        // the next reserved slot
+                        output_filter->project(out_tup, in_tup);
+
+                        // and drop it if its key cannot join
+                        if (rfilter) {
+                            rf_checked++;
+                            if (!rfilter->may_contain(out_tup.data)) {
+                                rf_dropped++;
+                                continue;
+                            }
+                        }
+
+                        if (record)
+                            record = rc_record(out_tup);
+                        out_tup.data += out_tup.size;
+                        filled++;
+                    }
                 }
+                output_buffer->commit(filled);
             }
+
+            if (rfilter)
+                rfilter->update(rf_checked, rf_dropped, output_buffer->tuple_size());
             
 
             // If this packet has run more than once, it may have received
@@ -723,6 +776,11 @@ void stage_container_t::stage_adaptor_t::output_page(page* p) {
         
         // check for packet termination
         if (terminate_curr_packet) {
+            // A primary that terminates early did not receive its
+            // whole output
+            if (curr_packet == _packet)
+                rc_discard();
+
             // Finishing up a stage packet is tricky. We must treat
             // terminating the primary packet as a special case. The
             // good news is that the finish_packet() method handle all
@@ -745,6 +803,135 @@ void stage_container_t::stage_adaptor_t::output_page(page* p) {
 
 
 
+/**
+ *  @brief Called by a circular stage before each pass over its
+ *  input. Detaches the packets that have received a whole pass.
+ *
+ *  A packet that attached during a pass needs the tuples of the next
+ *  pass up to the point where it attached. We flush the last partial
+ *  page of each pass, thus all the passes are split into the same
+ *  pages and the packet detaches through the _next_tuple_needed check
+ *  of output_page(), at the page boundary where it attached. This
+ *  assumes that the input does not change between passes. A packet
+ *  that misses its boundary detaches at the end of that pass.
+ *
+ *  @return false if no packet is left. We then stop accepting
+ *  packets, under the same lock, thus no packet can attach to a stage
+ *  that is about to return.
+ *
+ *  ONLY THE WORKER THREAD OF THIS ADAPTOR SHOULD CALL THIS METHOD.
+ */
+bool stage_container_t::stage_adaptor_t::next_cycle() {
+
+    if (!_circular) {
+        // First pass. The packets merged so far receive all of it.
+        critical_section_t cs(_stage_adaptor_lock);
+        _circular = true;
+        _cycle_start = _next_tuple;
+        return true;
+    }
+
+    // the tail of the pass that just ended
+    flush();
+
+    packet_list_t finished;
+    packet_list_t::iterator it;
+
+    critical_section_t cs(_stage_adaptor_lock);
+    // * * * BEGIN CRITICAL SECTION * * *
+    unsigned int cycle_length = _next_tuple - _cycle_start;
+    for (it = _packet_list->begin(); it != _packet_list->end(); ) {
+
+        packet_t* curr_packet = *it;
+        if (curr_packet->_next_tuple_on_merge <= _cycle_start) {
+            // attached when the pass started, or earlier
+            finished.push_back(curr_packet);
+            it = _packet_list->erase(it);
+            continue;
+        }
+
+        curr_packet->_next_tuple_needed =
+            curr_packet->_next_tuple_on_merge + cycle_length;
+        ++it;
+    }
+    _cycle_start = _next_tuple;
+
+    bool packets_remaining = !_packet_list->empty();
+    if (!packets_remaining)
+        _still_accepting_packets = false;
+    // * * * END CRITICAL SECTION * * *
+    cs.exit();
+
+
+    for (it = finished.begin(); it != finished.end(); ++it) {
+        // the primary received its whole output
+        if (*it == _packet)
+            rc_insert();
+        finish_packet(*it);
+    }
+
+    return packets_remaining;
+}
+
+
+
+/**
+ *  @brief Append a tuple of the primary's output to the recorded
+ *  result. Stops recording if the result grows larger than the
+ *  largest entry of the result cache.
+ *
+ *  @return false if we are no longer recording.
+ *
+ *  ONLY THE WORKER THREAD OF THIS ADAPTOR SHOULD CALL THIS METHOD.
+ */
+bool stage_container_t::stage_adaptor_t::rc_record(const tuple_t &tuple) {
+
+    page* p = _rc_pages.empty() ? NULL : _rc_pages.back();
+    if ((p == NULL) || p->full()) {
+        p = page::alloc(_rc_tuple_size);
+        _rc_pages.push_back(p);
+        _rc_bytes += p->page_size();
+        if (_rc_bytes > result_cache_t::max_entry_bytes()) {
+            rc_discard();
+            return false;
+        }
+    }
+    p->append_tuple(tuple);
+    return true;
+}
+
+
+
+/**
+ *  @brief Hand the recorded output of the primary over to the result
+ *  cache, once the primary has received all of it.
+ */
+void stage_container_t::stage_adaptor_t::rc_insert() {
+
+    if (_rc_recording && !_cancelled) {
+        result_cache_t::insert(_packet->plan(), _rc_tuple_size,
+                               _rc_pages, _rc_bytes);
+        rc_discard();
+    }
+}
+
+
+
+/**
+ *  @brief Stop recording and free the recorded output.
+ */
+void stage_container_t::stage_adaptor_t::rc_discard() {
+
+    page_list::iterator it;
+    for (it = _rc_pages.begin(); it != _rc_pages.end(); ++it)
+        (*it)->free();
+    _rc_pages.clear();
+    _rc_bytes = 0;
+    _rc_recording = false;
+}
+
+
+
 /**
  *  @brief Send EOF to the packet's output buffer. Delete the buffer
  *  if the consumer has already terminated it. If packet is not the
@@ -871,9 +1058,12 @@ void stage_container_t::stage_adaptor_t::cleanup() {
         // The packet is not finished. Simply update its progress
         // counter(s). The worker thread that picks up this packet
         // list should set the _stage_next_tuple_on_merge fields to
-        // NEXT_TUPLE_INITIAL_VALUE.
-        curr_packet->_next_tuple_needed =
-            curr_packet->_next_tuple_on_merge;
+        // NEXT_TUPLE_INITIAL_VALUE. A circular stage stops early only
+        // if none of the packets it has sent tuples to needs more,
+        // thus the ones left have received nothing and need a whole
+        // pass.
+        curr_packet->_next_tuple_needed = _circular ?
+            NEXT_TUPLE_INITIAL_VALUE : curr_packet->_next_tuple_on_merge;
         curr_packet->_next_tuple_on_merge = NEXT_TUPLE_UNINITIALIZED;
         ++it;
     }
@@ -885,9 +1075,12 @@ void stage_container_t::stage_adaptor_t::cleanup() {
     
     /* We will return and be able to process more packets. We can
        unreserve ourself from the container. Remember to drop
-       non-idle count before this! */
+       non-idle count before this! A circular stage released the
+       workers of its late mergers, thus the ones we re-enqueue take
+       over ours. */
     _container->_rp.notify_idle();
-    if (_packet->unreserve_worker_on_completion())
+    bool hand_over = _circular && !_packet_list->empty();
+    if (_packet->unreserve_worker_on_completion() && !hand_over)
         _container->_rp.unreserve(1);
 
 
@@ -902,6 +1095,10 @@ void stage_container_t::stage_adaptor_t::cleanup() {
     cs.exit();
 
     
+    // The primary received its whole output. Hand it over to the
+    // result cache.
+    rc_insert();
+
     // TODO Terminate inputs of primary packet. finish_packet()
     // already took care of its output buffer.
     _packet_list = NULL;
@@ -949,6 +1146,8 @@ void stage_container_t::stage_adaptor_t::abort_queries() {
 
     delete _packet_list;
     _packet_list = NULL;
+
+    rc_discard();
     
     // handle primary packet
     delete _packet;
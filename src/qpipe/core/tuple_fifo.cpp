@@ -26,6 +26,20 @@
 #include "util/trace.h"
 #include "util/acounter.h"
 #include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#define TUPLE_FIFO_USE_FUTEX
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#ifndef FUTEX_WAIT_PRIVATE
+#define FUTEX_WAIT_PRIVATE FUTEX_WAIT
+#define FUTEX_WAKE_PRIVATE FUTEX_WAKE
+#endif
+#endif
 
 
 ENTER_NAMESPACE(qpipe);
@@ -39,6 +53,18 @@ static const bool FLUSH_TO_DISK_ON_FULL = false;
 
 
 
+/* A side that finds the ring full (or empty) re-checks this many
+   times before it parks */
+static const int TUPLE_FIFO_SPINS = 1000;
+
+static inline void tuple_fifo_spin_pause() {
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__("pause");
+#endif
+}
+
+
+
 /* Global tuple_fifo statistics */
 
 /* statistics data structures */
@@ -139,9 +165,9 @@ static qpipe::page* SENTINEL_PAGE = qpipe::page::alloc(1, &SENTINEL_POOL);
 /* definitions of exported methods */
 
 /*
- * Creates a new (temporary) file in the BDB bufferpool for the FIFO
- * to use as a backing store. The file will be deleted automatically
- * when the FIFO is destroyed.
+ * Allocates the page rings. The FIFO holds at most _memory_capacity
+ * full pages, plus the read and the write page, thus neither ring
+ * can overflow.
  */
 void tuple_fifo::init() {
 
@@ -150,6 +176,18 @@ void tuple_fifo::init() {
 
     _reader_tid = pthread_self();
 
+    /* Size the rings. A parked side waits for '_threshold' pages or
+       slots, which must fit in the ring. */
+    assert(_memory_capacity > 0);
+    if ((_threshold == 0) || (_threshold > _memory_capacity))
+        _threshold = _memory_capacity;
+    size_t ring_size = 1;
+    while (ring_size < _memory_capacity + 2)
+        ring_size *= 2;
+    _ring = new page*[ring_size];
+    _free_ring = new page*[ring_size];
+    _ring_mask = ring_size - 1;
+
     /* Prepare for reading. */
     _set_read_page(SENTINEL_PAGE);
 
@@ -178,26 +216,18 @@ void tuple_fifo::writer_init() {
 
 
 
-/**
- * @brief Function object. Wrapper around p->free() that can be passed
- * to std::for_each.
- */
-struct free_page {
-    void operator()(qpipe::page* p) {
-	p->free();
-    }
-};
-
-
-
 /**
  * @brief Deallocate the pags in this tuple_fifo and add our local
  * statistics to global ones.
  */
 void tuple_fifo::destroy() {
 
-    std::for_each(_pages.begin(), _pages.end(), free_page());
-    std::for_each(_free_pages.begin(), _free_pages.end(), free_page());
+    for (size_t i = _ring_head; i != _ring_tail; i++)
+        _ring[i & _ring_mask]->free();
+    for (size_t i = _free_head; i != _free_tail; i++)
+        _free_ring[i & _ring_mask]->free();
+    delete [] _ring;
+    delete [] _free_ring;
 	
     /* update stats */
     critical_section_t cs(tuple_fifo_stats_mutex);
@@ -219,8 +249,6 @@ void tuple_fifo::destroy() {
           (double)_num_waits_on_remove/_num_removed);
 }
 
-
-
 /**
  *  @brief Only the consumer may call this method. Retrieve a page
  *  of tuples from the buffer in one operation.
@@ -243,23 +271,47 @@ bool tuple_fifo::copy_page(page* dst, int timeout_ms) {
     /* no partial pages allowed! */
     assert(_read_iterator == _read_page->begin());
 
-    /* copy over tuples */
+    /* copy over tuples, a span at a time */
     dst->clear();
-    size_t capacity = dst->capacity();
-    for(size_t i = 0; i < capacity; i++) {
-        tuple_t tuple;
-        if (!get_tuple(tuple))
+    while(!dst->full()) {
+        page::iterator begin, end;
+        size_t count = get_tuples(begin, end, dst->free_count());
+        if (count == 0)
             break;
-        dst->append_tuple(tuple);
+        memcpy(dst->free_tuple().data, begin->data, count*tuple_size());
+        dst->commit(count);
     }
 
     /* return page */
-    _num_removed += dst->tuple_count();
     return true;
 }
 
 
 
+/**
+ *  @brief Only the producer may call this method. Append the tuples
+ *  [begin, end) of a page to this buffer, a reserve()/commit() batch
+ *  at a time.
+ *
+ *  @throw Can throw TerminatedBufferException if the consumer has
+ *  terminated the buffer.
+ */
+void tuple_fifo::append_tuples(page::iterator begin, page::iterator end) {
+
+    const char* src = begin->data;
+    size_t count = (end->data - begin->data)/tuple_size();
+    while(count > 0) {
+        tuple_t first;
+        size_t n = reserve(count, first);
+        memcpy(first.data, src, n*tuple_size());
+        commit(n);
+        src += n*tuple_size();
+        count -= n;
+    }
+}
+
+
+
 /**
  * @brief Only the producer may call this method. Notify the
  * tuple_fifo that the caller will be inserting no more data.  The
@@ -312,10 +364,11 @@ bool tuple_fifo::terminate() {
         return false;
     
     // make sure nobody is sleeping (either the reader or writer could
-    // be calling this)
+    // be calling this). The other side takes the _lock before it
+    // throws, thus it cannot delete the buffer under us.
     _state.transition(tuple_fifo_state_t::TERMINATED);
-    thread_cond_signal(_reader_notify);
-    thread_cond_signal(_writer_notify);
+    _unpark(&_reader_seq, _reader_notify);
+    _unpark(&_writer_seq, _writer_notify);
     
     // * * * END CRITICAL SECTION * * *
     return true;
@@ -325,95 +378,247 @@ bool tuple_fifo::terminate() {
 
 /* definitions of helper methods */
 
+/**
+ * @brief Park the calling side until it is ready to run with 'count'
+ * pages (or free slots). We announce 'count' in 'parked' and check
+ * again after a full barrier. The other side publishes a page (or a
+ * slot), issues a full barrier and then reads 'parked', thus either
+ * we see its page or it sees us parked and bumps 'seq'.
+ *
+ * @return false if 'timeout_ms' is positive and it expired.
+ */
+bool tuple_fifo::_park(volatile size_t* parked, volatile uint32_t* seq,
+                       pthread_cond_t &cond, size_t count, bool reader,
+                       int timeout_ms)
+{
+    bool woken = true;
+    while (woken && !(reader? _reader_ready(count) : _writer_ready(count))) {
+        uint32_t old_seq = *seq;
+        *parked = count;
+        membar_enter();
+        if (reader? _reader_ready(count) : _writer_ready(count))
+            break;
+
+#ifdef TUPLE_FIFO_USE_FUTEX
+        struct timespec timeout;
+        timeout.tv_sec  = timeout_ms / 1000;
+        timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+        int ret = syscall(SYS_futex, (int*)seq, FUTEX_WAIT_PRIVATE,
+                          (int)old_seq, (timeout_ms > 0)? &timeout : NULL,
+                          NULL, 0);
+        woken = !((ret == -1) && (errno == ETIMEDOUT));
+#else
+        critical_section_t cs(_lock);
+        if (*seq == old_seq)
+            woken = thread_cond_wait(cond, _lock, timeout_ms);
+#endif
+    }
+    *parked = 0;
+    return woken;
+}
+
+
+
+/**
+ * @brief Wake the side parked on 'seq'. Without futexes the caller
+ * must hold the _lock.
+ */
+void tuple_fifo::_unpark(volatile uint32_t* seq, pthread_cond_t &cond) {
+    atomic_inc_32(seq);
+#ifdef TUPLE_FIFO_USE_FUTEX
+    (void)cond;
+    syscall(SYS_futex, (int*)seq, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+    thread_cond_signal(cond);
+#endif
+}
+
+
+
+/**
+ * @brief The producer waits for free slots in the ring. A consumer
+ * that keeps up frees one soon, thus we spin for a while. Otherwise
+ * we park until '_threshold' slots are free, so that a slow consumer
+ * wakes us once per batch of pages and not once per page.
+ */
 inline void tuple_fifo::wait_for_reader() {
     _num_waits_on_insert++;
-    thread_cond_wait(_writer_notify, _lock);
+    for (int i = 0; (i < TUPLE_FIFO_SPINS) && !_writer_ready(1); i++)
+        tuple_fifo_spin_pause();
+    if (!_writer_ready(1))
+        _park(&_writer_parked, &_writer_seq, _writer_notify,
+              _threshold, false, 0);
+    _termination_check();
 }
 
 inline void tuple_fifo::ensure_reader_running() {
-    thread_cond_signal(_reader_notify);
+    membar_enter();
+    size_t pages = _reader_parked;
+    if (pages && _reader_ready(pages)) {
+#ifdef TUPLE_FIFO_USE_FUTEX
+        _unpark(&_reader_seq, _reader_notify);
+#else
+        critical_section_t cs(_lock);
+        _unpark(&_reader_seq, _reader_notify);
+#endif
+    }
 }
 
+/**
+ * @brief The consumer waits for pages, like the producer does for
+ * free slots.
+ */
 inline bool tuple_fifo::wait_for_writer(int timeout_ms) {
     _num_waits_on_remove++;
-    return thread_cond_wait(_reader_notify, _lock, timeout_ms);
+    for (int i = 0; (i < TUPLE_FIFO_SPINS) && !_reader_ready(1); i++)
+        tuple_fifo_spin_pause();
+    if (_reader_ready(1))
+        return true;
+    return _park(&_reader_parked, &_reader_seq, _reader_notify,
+                 _threshold, true, timeout_ms);
 }
 
 inline void tuple_fifo::ensure_writer_running() {
-    thread_cond_signal(_writer_notify);
+    membar_enter();
+    size_t slots = _writer_parked;
+    if (slots && _writer_ready(slots)) {
+#ifdef TUPLE_FIFO_USE_FUTEX
+        _unpark(&_writer_seq, _writer_notify);
+#else
+        critical_section_t cs(_lock);
+        _unpark(&_writer_seq, _writer_notify);
+#endif
+    }
+}
+
+
+
+/**
+ * @brief Only the producer may call this method. Take a page from
+ * the free ring, or allocate a new one.
+ */
+page* tuple_fifo::_alloc_page() {
+    size_t head = _free_head;
+    if (head == _free_tail)
+        /* Allocate using page::alloc. */
+        return page::alloc(tuple_size());
+
+    /* Reuse a page the consumer is done with. */
+    membar_consumer();
+    page* p = _free_ring[head & _ring_mask];
+    membar_exit();
+    _free_head = head + 1;
+    p->clear();
+    return p;
+}
+
+
+
+/**
+ * @brief Only the consumer may call this method. Return a page we
+ * are done reading to the producer.
+ */
+void tuple_fifo::_recycle_page(page* p) {
+    size_t tail = _free_tail;
+    if (tail - _free_head > _ring_mask) {
+        /* cannot happen, see init() */
+        p->free();
+        return;
+    }
+    _free_ring[tail & _ring_mask] = p;
+    membar_exit();
+    _free_tail = tail + 1;
 }
 
 
 
 /**
- * @brief Get a page from the tuple_fifo.
+ * @brief Only the producer may call this method. Hand the write page
+ * over to the consumer and get a new one, or close the buffer if
+ * 'done_writing'.
  *
- * @return NULL if the tuple_fifo has been closed. A page otherwise.
+ * In memory the page goes through the ring. The transitions to
+ * DONE_WRITING and ON_DISK and the disk writes hold the _lock. Once
+ * on disk, the pages already in the ring stay there and the consumer
+ * reads them before the ones in the file.
  */
 void tuple_fifo::_flush_write_page(bool done_writing) {
 
     // after the call to send_eof() the write page is NULL
     assert(!is_done_writing());
-    
-    // * * * BEGIN CRITICAL SECTION * * *
-    critical_section_t cs(_lock);
     _termination_check();
 
 
-    switch(_state.current()) {
-    case tuple_fifo_state_t::IN_MEMORY: {
-        
-            
-        /* Wait for space to free up if we are using a "no flush"
-           policy. */
-        if (!FLUSH_TO_DISK_ON_FULL) {
-            /* tuple_fifo stays in memory */
-            /* If the buffer is currently full, we must wait for space to
-               open up. Once we start waiting we continue waiting until
-               space for '_threshold' pages is available. */
-            for(size_t threshold=1;
-                _available_in_memory_writes() < threshold; threshold = _threshold) {
-                /* wait until something important changes */
+    if (_state.current() == tuple_fifo_state_t::IN_MEMORY) {
+
+        if (!_write_page->empty()) {
+
+            /* If the ring is full we either wait for the consumer or,
+               with a disk flush policy, go on disk. */
+            if (_available_in_memory_writes() == 0) {
+                if (FLUSH_TO_DISK_ON_FULL) {
+                    _flush_to_disk(done_writing);
+                    return;
+                }
                 wait_for_reader();
-                _termination_check();
             }
+
+            /* Publish the page. The tuples must be visible before the
+               index is. */
+            size_t tail = _ring_tail;
+            _ring[tail & _ring_mask] = _write_page.release();
+            membar_exit();
+            _ring_tail = tail + 1;
         }
 
+        if (done_writing) {
 
-        /* At this point, we don't have to wait for space anymore. If
-           we still don't have enough space, it must be because we are
-           using a disk flush policy. Check whether we can proceed
-           without flushing to disk. */
-        if (_available_in_memory_writes() >= 1) {
-            
-            /* Add _write_page to other tuple_fifo pages unless
-               empty. */
-            if(!_write_page->empty()) {
-                _pages.push_back(_write_page.release());
-                _pages_in_memory++;
-                _pages_in_fifo++;
-            }
-            
-            /* Allocate a new _write_page if necessary. */
-            if(done_writing) {
-                /* Allocation of a new _write_page is not necessary
-                   (because we are done writing). Just do state
-                   transition. */
-                _state.transition(tuple_fifo_state_t::IN_MEMORY_DONE_WRITING);
-                _write_page.done();
-            }
-            else
-                _write_page = _alloc_page();
-            
-            /* wake the reader if necessary */
-            if(_available_in_memory_reads() >= _threshold || is_done_writing())
-                ensure_reader_running();
-            
-            break;
+            // * * * BEGIN CRITICAL SECTION * * *
+            critical_section_t cs(_lock);
+            _termination_check(true);
+
+            _state.transition(tuple_fifo_state_t::IN_MEMORY_DONE_WRITING);
+            _write_page.done();
+
+            /* The consumer takes the _lock before it reports EOF, and
+               may delete the buffer after that. Thus we wake it
+               before leaving the critical section. */
+            membar_enter();
+            if (_reader_parked)
+                _unpark(&_reader_seq, _reader_notify);
+
+            // * * * END CRITICAL SECTION * * *
+            return;
         }
 
+        _write_page = _alloc_page();
+
+        /* wake the reader if necessary */
+        ensure_reader_running();
+        return;
+    }
+
+
+    assert(_state.current() == tuple_fifo_state_t::ON_DISK);
+    _flush_to_disk(done_writing);
+}
+
+
+
+/**
+ * @brief Only the producer may call this method. Append the write
+ * page to the disk file, creating the file and moving to ON_DISK the
+ * first time.
+ */
+void tuple_fifo::_flush_to_disk(bool done_writing) {
+
+    // * * * BEGIN CRITICAL SECTION * * *
+    critical_section_t cs(_lock);
+    _termination_check(true);
+
+
+    if (_state.current() == tuple_fifo_state_t::IN_MEMORY) {
 
-        /* If we are here, we need to flush to disk. */
         /* Create on disk file. */
         c_str filepath = tuple_fifo_directory_t::generate_filepath(_fifo_id);
         _page_file = fopen(filepath.data(), "w+");
@@ -423,96 +628,39 @@ void tuple_fifo::_flush_write_page(bool done_writing) {
                    "fopen(%s) failed", filepath.data());
         TRACE(TRACE_ALWAYS, "Created tuple_fifo file %s\n",
               filepath.data());
-        
-        /* Append this page to _pages and flush the entire
-           page_list to disk. */
-        if(!_write_page->empty()) {
-            _pages.push_back(_write_page.release());
-            _pages_in_memory++;
-            _pages_in_fifo++;
-        }
-        for (page_list::iterator it = _pages.begin(); it != _pages.end(); ) {
-            qpipe::page* p = *it;
-            p->fwrite_full_page(_page_file);
-
-            /* done with page */
-            p->clear();
-            _free_pages.push_back(p);
-            it = _pages.erase(it);
-
-            assert(_pages_in_memory > 0);
-            _pages_in_memory--;
-        }
-        fflush(_page_file);
-        
-        /* update _file_head_page */
-        assert(_file_head_page == 0);
-        _file_head_page = _next_page;
 
         _state.transition(tuple_fifo_state_t::ON_DISK);
-        if (done_writing) {
-            /* transition again! */
-            _state.transition(tuple_fifo_state_t::ON_DISK_DONE_WRITING);
-            _write_page.done();
-        }
-        else {
-            /* allocate from free list */
-            assert(!_free_pages.empty());
-            _write_page = _alloc_page();
-
-            /* TODO It's clear whether we want to replace the
-               SENTINAL_PAGE here. On the one hand, if we can replace
-               it, we can free the rest of the pages in the free
-               list. On the other, we still need to check for the
-               SENTINAL_PAGE in _get_read_page since pages may be
-               removed using get_page (instead of tuples removed with
-               get_tuple). */
-            if (_read_page == SENTINEL_PAGE) {
-                _set_read_page(_alloc_page());
-                /* After this point, we should not release either of
-                   these pages. */
-            }
-        }
-
-        /* wake the reader if necessary */
-        if(_available_fifo_reads() >= _threshold || is_done_writing())
-            ensure_reader_running();
+    }
 
-        break;
-
-    } /* endof case: IN_MEMORY */
-        
-    case tuple_fifo_state_t::ON_DISK: {
 
+    if (!_write_page->empty()) {
         int fseek_ret = fseek(_page_file, 0, SEEK_END);
         assert(!fseek_ret);
         if (fseek_ret)
             THROW1(FileException, "fseek to EOF");
         _write_page->fwrite_full_page(_page_file);
         fflush(_page_file);
-        _pages_in_fifo++;
-
-        if (done_writing) {
-            _state.transition(tuple_fifo_state_t::ON_DISK_DONE_WRITING);
-            _write_page.done();
-        }
-        else {
-            /* simply reuse write page */
-            _write_page->clear();
-        }
-        
-        /* wake the reader if necessary */
-        if(_available_fifo_reads() >= _threshold || is_done_writing())
-            ensure_reader_running();
-
-        break;
+        _pages_on_disk++;
     }
 
-    default:
-        unreachable();
-
-    } /* endof switch statement */
+    if (done_writing) {
+        _state.transition(tuple_fifo_state_t::ON_DISK_DONE_WRITING);
+        _write_page.done();
+    }
+    else if (_write_page == SENTINEL_PAGE) {
+        _write_page = _alloc_page();
+    }
+    else {
+        /* simply reuse write page */
+        _write_page->clear();
+    }
+    
 
+    /* wake the reader if necessary, see _flush_write_page() */
+    membar_enter();
+    size_t pages = _reader_parked;
+    if (pages && _reader_ready(pages))
+        _unpark(&_reader_seq, _reader_notify);
 
     // * * * END CRITICAL SECTION * * *
 }
@@ -533,95 +681,66 @@ void tuple_fifo::_flush_write_page(bool done_writing) {
  */
 int tuple_fifo::_get_read_page(int timeout_ms) {
 
-    // * * * BEGIN CRITICAL SECTION * * *
-    critical_section_t cs(_lock);
     _termination_check();
 
 
-    /* Free the page so the writer can use it. */
-    if (is_in_memory() && (_read_page != SENTINEL_PAGE)) {
-        /* We are still maintaining an in-memory page list from which
-           we are pulling pages. We release them to _free_pages as we
-           are done with them. */
-        _read_page->clear();
-        _free_pages.push_back(_read_page.release());
-        _set_read_page(SENTINEL_PAGE);
-    }
-
+    /* If the buffer is currently empty, we must wait for the writer
+       unless 'timeout_ms' is negative. Once we park we continue
+       waiting until either '_threshold' pages are available OR the
+       writer has invoked send_eof() or terminate(). */
+    if ((timeout_ms >= 0) && !_reader_ready(1))
+        wait_for_writer(timeout_ms);
+    _termination_check();
 
-    /* If 'wait_on_empty' and the buffer is currently empty, we must
-       wait for space to open up. Once we start waiting we continue
-       waiting until either space for '_threshold' pages is available
-       OR the writer has invoked send_eof() or terminate(). */
-    for(size_t t=1;
-        (timeout_ms >= 0) && !is_done_writing() && (_available_fifo_reads() < t);
-        t = _threshold) {
-        /* We are to either wait for a page or wait for timeout_ms. */
-        if(!wait_for_writer(timeout_ms))
-            /* Timed out! */
-            break;
-        _termination_check();
-    }
 
+    /* Read the state before the indices. The writer publishes all its
+       pages before it moves to DONE_WRITING. */
+    bool done_writing = is_done_writing();
+    membar_consumer();
 
     TRACE(TRACE_ALWAYS&TRACE_MASK_DISK,
           "available reads = %d\n", (int)_available_fifo_reads());
-    if(_available_fifo_reads() == 0) {
-        /* If we are here, we exited the loop above because one of the
-           other conditions failed. We either noticed that the
-           tuple_fifo has been closed or we've timed out. */
-        if(is_done_writing()) {
-            /* notify caller that the tuple_fifo is closed */
-            TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "Returning -1\n");
-	    return -1;
-        }
-	if(timeout_ms != 0)
-            /* notify caller that we timed out */
-	    return 0;
-	unreachable();
-    }
 
 
-    switch(_state.current()) {
-    case tuple_fifo_state_t::IN_MEMORY:
-    case tuple_fifo_state_t::IN_MEMORY_DONE_WRITING: {
-        /* pull the page from page_list */
-        assert(!_pages.empty());
-        _set_read_page(_pages.front());
-        _pages.pop_front();
-        assert(_pages_in_memory > 0);
-        _pages_in_memory--;
-        break;
+    if (_available_in_memory_reads() > 0) {
+
+        /* pull the page from the ring */
+        size_t head = _ring_head;
+        membar_consumer();
+        page* p = _ring[head & _ring_mask];
+
+        /* Free the page we are done with so the writer can use it. */
+        if (_read_page != SENTINEL_PAGE)
+            _recycle_page(_read_page.release());
+        _set_read_page(p);
+
+        membar_exit();
+        _ring_head = head + 1;
+
+        /* wake the writer if necessary */
+        if (!FLUSH_TO_DISK_ON_FULL)
+            ensure_writer_running();
+        return 1;
     }
-    case tuple_fifo_state_t::ON_DISK:
-    case tuple_fifo_state_t::ON_DISK_DONE_WRITING: {
-
-        /* We are on disk. We should not be releasing _read_page after
-           iterating over its entries. However, we still need to be
-           prepared against code which extracts pages from the
-           tuple_fifo using get_page(). get_page() sets _read_page to
-           the SENTINEL_PAGE. */
-        if (_read_page == SENTINEL_PAGE)
-            _set_read_page(_alloc_page());
-        else {
-            /* We are reusing the same read page... do a reset */
-            _read_page->clear();
-            _set_read_page(_read_page.release());
-        }
 
 
-        /* Make sure that at this point, we are not dealing with the
-           SENTINAL_PAGE. */
-        assert(_read_page != SENTINEL_PAGE);
+    if (_pages_on_disk > _disk_next_page) {
+
+        // * * * BEGIN CRITICAL SECTION * * *
+        critical_section_t cs(_lock);
+        _termination_check(true);
+
+        /* We read the file one page at a time, into the same page. */
+        if (_read_page == SENTINEL_PAGE)
+            _set_read_page(page::alloc(tuple_size()));
         assert(_read_page->page_size() == malloc_page_pool::instance()->page_size());
 
 
         /* read page from disk file */
         _read_page->clear();
-        TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "_next_page = %d\n", (int)_next_page);
-        TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "_file_head_page = %d\n", (int)_file_head_page);
-        unsigned long seek_pos =
-            (_next_page - _file_head_page) * get_default_page_size();
+        TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "_disk_next_page = %d\n",
+              (int)_disk_next_page);
+        unsigned long seek_pos = _disk_next_page * get_default_page_size();
         TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "fseek to %lu\n", seek_pos);
         int fseek_ret = fseek(_page_file, seek_pos, SEEK_SET);
         assert(!fseek_ret);
@@ -630,6 +749,7 @@ int tuple_fifo::_get_read_page(int timeout_ms) {
         int fread_ret = _read_page->fread_full_page(_page_file);
         assert(fread_ret);
         _set_read_page(_read_page.release());
+        _disk_next_page++;
 
 
         size_t page_size = _read_page->page_size();
@@ -649,28 +769,25 @@ int tuple_fifo::_get_read_page(int timeout_ms) {
         TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "Read %d %d-byte tuples\n",
               (int)_read_page->tuple_count(),
               (int)_read_page->tuple_size());
-        break;
-    }
-
-    default:
-        unreachable();
-    } /* endof switch statement */
 
-    
-    assert(_pages_in_fifo > 0);
-    _pages_in_fifo--;
-    _next_page++;
-    
-    
-    /* wake the writer if necessary */
-    if(!FLUSH_TO_DISK_ON_FULL
-       && (_available_in_memory_writes() >= _threshold)
-       && !is_done_writing())
-        ensure_writer_running();
+        // * * * END CRITICAL SECTION * * *
+        return 1;
+    }
 
 
-    // * * * END CRITICAL SECTION * * *
-    return 1;
+    /* If we are here, either the tuple_fifo has been closed or we've
+       timed out. */
+    if (done_writing) {
+        /* Wait for the writer to leave send_eof(), since our caller
+           may delete the tuple_fifo once we report EOF. */
+        critical_section_t cs(_lock);
+        TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "Returning -1\n");
+        return -1;
+    }
+    if (timeout_ms != 0)
+        /* notify caller that we timed out */
+        return 0;
+    unreachable();
 }
 
 
@@ -58,35 +58,36 @@ void aggregate_stage_t::process_packet()
 
     int i = 0;
     bool first = true;
-    while (1) {
-
-        // No more tuples?
-        tuple_t src;
-        if(!input_buffer->get_tuple(src))
-            // Exit from loop, but can't return quite yet since we may
-            // still have one more aggregation to perform.
-            break;
-            
-        // got another tuple
-        const char* key = extract->extract_key(src);
-
-        // break group?
-        if(first || /* allow init() call if first tuple */
-           (key_size && memcmp(last_key, key, key_size))) {
-
-            if(!first) {
-                aggregate->finish(dest, agg.data);
-                TRACE(0&TRACE_ALWAYS, "key_size = %d\n", key_size);
-                adaptor->output(dest);
-            }
+    page::iterator it, end;
+    // Read the input a span of tuples at a time. When there are no
+    // more tuples we exit from the loop, but can't return quite yet
+    // since we may still have one more aggregation to perform.
+    while (input_buffer->get_tuples(it, end)) {
+
+        while (it != end) {
+
+            // got another tuple
+            tuple_t src = it.advance();
+            const char* key = extract->extract_key(src);
+
+            // break group?
+            if(first || /* allow init() call if first tuple */
+               (key_size && memcmp(last_key, key, key_size))) {
+
+                if(!first) {
+                    aggregate->finish(dest, agg.data);
+                    TRACE(0&TRACE_ALWAYS, "key_size = %d\n", key_size);
+                    adaptor->output(dest);
+                }
  
-            aggregate->init(agg.data);
-            memcpy(last_key, key, key_size);
-            first = false;
-        }
+                aggregate->init(agg.data);
+                memcpy(last_key, key, key_size);
+                first = false;
+            }
         
-        aggregate->aggregate(agg.data, src);
-        i++;
+            aggregate->aggregate(agg.data, src);
+            i++;
+        }
     }
 
     // output the last group, if any
@@ -0,0 +1,205 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   cscan.cpp
+ *
+ *  @brief:  Implementation of the QPipe circular table scan stage
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "qpipe/stages/cscan.h"
+
+#include "sm_vas.h"
+
+using namespace shore;
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+const c_str cscan_packet_t::PACKET_TYPE = "CSCAN";
+
+const c_str cscan_stage_t::DEFAULT_STAGE_NAME = "CSCAN_STAGE";
+
+
+bool cscan_stage_t::_enabled = false;
+
+volatile uint32_t cscan_stage_t::_packets = 0;
+volatile uint32_t cscan_stage_t::_passes = 0;
+
+
+
+/******************************************************************
+ * 
+ * @class: Packet for the circular scans
+ *
+ ******************************************************************/
+
+cscan_packet_t::cscan_packet_t(tscan_packet_t* tscan)
+    : tscan_packet_t(tscan->_packet_id, PACKET_TYPE,
+                     tscan->release_output_buffer(),
+                     tscan->_output_filter,
+                     tscan->_db, tscan->_table, tscan->_xct, tscan->_lm)
+{
+    assign_query_state(tscan->get_query_state());
+    if (tscan->runtime_filter())
+        attach_runtime_filter(tscan->runtime_filter());
+    atomic_inc_32(&cscan_stage_t::_packets);
+}
+
+
+
+/******************************************************************
+ * 
+ * @class: Stage for circular scans
+ *
+ ******************************************************************/
+
+
+/******************************************************************
+ *
+ *  @fn:    init
+ *
+ *  @brief: Reads whether the table scans are circular. With
+ *          qpipe-cscan=0 (the default) the TSCAN packets are
+ *          processed by the TSCAN stage.
+ *
+ ******************************************************************/
+
+void cscan_stage_t::init()
+{
+    envVar* ev = envVar::instance();
+    _enabled = (ev->getVarInt("qpipe-cscan", 0) != 0);
+    if (_enabled) {
+        TRACE( TRACE_ALWAYS, "Circular table scans\n");
+    }
+}
+
+
+
+/* The read-only xct of a pass. It is committed when the pass
+   completes, and aborted if the pass is cut short by an exception. */
+struct pass_xct_t
+{
+    ss_m* _db;
+    bool  _done;
+
+    pass_xct_t(ss_m* db) : _db(db), _done(false) {
+        w_rc_t e = _db->begin_xct();
+        if (e.is_error())
+            THROW1(QPipeException, "Could not begin the xct of a pass");
+    }
+
+    void commit() {
+        _done = true;
+        w_rc_t e = _db->commit_xct();
+        if (e.is_error())
+            THROW1(QPipeException, "Could not commit the xct of a pass");
+    }
+
+    ~pass_xct_t() {
+        if (_done) return;
+        // Must not throw, we may be unwinding
+        w_rc_t e = _db->abort_xct();
+        if (e.is_error())
+            TRACE( TRACE_ALWAYS, "Could not abort the xct of a pass\n");
+    }
+};
+
+
+
+/******************************************************************
+ * 
+ * @fn:     process_packet
+ *
+ * @brief:  Reads the table in passes, until no packet is attached.
+ *          The primary packet only provides the table, it detaches
+ *          after the first pass like any other packet.
+ *
+ ******************************************************************/
+
+void cscan_stage_t::process_packet() 
+{
+    adaptor_t* adaptor = _adaptor;
+    cscan_packet_t* packet = (cscan_packet_t*)adaptor->get_packet();
+    uint tsz(packet->_table->maxsize());
+
+    while (adaptor->next_cycle()) {
+
+        if (adaptor->check_for_cancellation())
+            return;
+
+        pass_xct_t pass(packet->_db);
+        {
+            // The scanner unpins its pages before the xct ends
+            simple_table_iter_t tscanner(packet->_db, packet->_table, packet->_lm);
+            bool eof(false);
+            pin_i* handle(NULL);
+
+            w_rc_t e = tscanner.next(eof,handle);
+            while (!e.is_error() && !eof) {
+                tuple_t at((char*)handle->body(),tsz);
+                adaptor->output(at);
+                e = tscanner.next(eof,handle);
+            }
+
+            // A partial pass would break the passes of the packets that
+            // attached in it
+            if (e.is_error())
+                THROW2(QPipeException, "Pass over %s failed",
+                       packet->_table->name());
+        }
+        pass.commit();
+
+        atomic_inc_32(&_passes);
+    }
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    print_stats/reset_stats
+ *
+ ******************************************************************/
+
+void cscan_stage_t::print_stats()
+{
+    if (!is_enabled()) return;
+
+    TRACE( TRACE_ALWAYS,
+           "Circular scans: packets (%d) passes (%d) packets per pass (%.2f)\n",
+           (int)_packets, (int)_passes,
+           (_passes ? (double)_packets/(double)_passes : 0.0));
+}
+
+
+void cscan_stage_t::reset_stats()
+{
+    _packets = 0;
+    _passes = 0;
+}
+
+
+EXIT_NAMESPACE(qpipe);
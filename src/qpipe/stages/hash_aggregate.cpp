@@ -23,17 +23,10 @@
 
 #include "qpipe/stages/hash_aggregate.h"
 
-#if defined(linux) || defined(__linux)
-/*GNU found*/
-#include <ext/hash_set>
-using __gnu_cxx::hashtable;
-using __gnu_cxx::hash_set;
-#else
-/*Solaris*/
-#include <hash_set>
-using std::hash_set;
-using std::hashtable;
-#endif
+#include <cstdio>
+#include <cerrno>
+#include <deque>
+#include <vector>
 
 
 const c_str hash_aggregate_packet_t::PACKET_TYPE = "HASH_AGGREGATE";
@@ -47,65 +40,233 @@ const c_str hash_aggregate_stage_t::DEFAULT_STAGE_NAME = "HASH_AGGREGATE_STAGE";
 // the maximum number of pages allowed in a single run
 static const size_t MAX_RUN_PAGES = 10000;
 
+// the number of partitions the input tuples of the groups that do not
+// fit in a run are spilled to
+static const size_t SPILL_PARTITIONS = 16;
 
+// the deepest level of spilling. The last level keeps all its groups
+// in memory, whatever their number.
+static const int MAX_SPILL_LEVEL = 4;
 
-/* Helper classes used by the hashtable data structure. All of
-   these are very short, so give the compiler the option of
-   inlining. */
-    
-struct extractkey_t {
-    key_extractor_t *_extract;
+// the maximum number of input pages queued to a parallel worker
+static const size_t MAX_QUEUED_PAGES = 64;
+
+
+
+/* Reads the tuples of a tuple_fifo */
+struct fifo_input_t {
+    tuple_fifo* _buffer;
 
-    extractkey_t(key_extractor_t* extract)
-	: _extract(extract)
+    fifo_input_t(tuple_fifo* buffer)
+        : _buffer(buffer)
     {
     }
-        
-    const char* const operator()(const char* value) const {
-	return _extract->extract_key(value);
+
+    bool get_tuple(tuple_t &in) {
+        return _buffer->get_tuple(in);
     }
 };
 
 
-/* Can be used for both EqualKey and EqualData template
-   parameter. */
-struct equalbytes_t {
-        
-    size_t _len;
-    equalbytes_t(size_t len)
-	: _len(len)
+/* Reads the tuples of a spilled partition back, page by page */
+struct file_input_t {
+    FILE* _file;
+    qpipe::page* _page;
+    qpipe::page::iterator _it;
+    qpipe::page::iterator _end;
+
+    file_input_t(FILE* file, qpipe::page* page)
+        : _file(file), _page(page), _it(), _end()
     {
     }
 
-    bool operator()(const char *k1, const char *k2) const {
-	return !memcmp(k1, k2, _len);
+    bool get_tuple(tuple_t &in) {
+        while(_it == _end) {
+            if(!_page->fread_full_page(_file))
+                return false;
+            _it = _page->begin();
+            _end = _page->end();
+        }
+        in = _it.advance();
+        return true;
     }
 };
 
-    
-struct hashfcn_t {
-        
-    size_t _len;
-    hashfcn_t(size_t len)
-	: _len(len)
+
+
+/**
+ *  @brief A thread of the parallel aggregation. Aggregates the input
+ *  tuples queued to it into its own table, with its own copy of the
+ *  aggregate functor. The tuples of new groups that do not fit in its
+ *  share of the pages are spilled to its own partitions. The pages of
+ *  its aggregate tuples live as long as the worker does. An exception
+ *  of the thread is kept, for the stage to rethrow after the join.
+ */
+class hash_aggregate_stage_t::worker_t {
+public:
+
+    guard<tuple_aggregate_t> _aggregate;
+    guard<key_extractor_t>   _tup_key;
+    tuple_hash_t             _run;
+    page_trash_stack         _page_list;
+    qpipe::page*             _agg_page;
+    size_t                   _page_count;
+    size_t                   _max_pages;
+    size_t                   _in_size;
+    size_t                   _tuples;
+    spill_list_t             _spills;
+    bool                     _failed;
+    c_str                    _error;
+
+private:
+
+    pthread_mutex_t          _lock;
+    pthread_cond_t           _cond;
+    std::deque<qpipe::page*> _queue;
+    bool                     _eof;
+    pthread_t                _tid;
+
+public:
+
+    worker_t(hash_aggregate_packet_t* packet, size_t groups_hint,
+             size_t max_pages, size_t in_size)
+        : _aggregate(packet->_aggregate->clone()),
+          _tup_key(packet->_extractor->clone()),
+          _run(groups_hint,
+               extractkey_t(_aggregate->key_extractor()),
+               equalbytes_t(_aggregate->key_extractor()->key_size()),
+               equalbytes_t(_aggregate->key_extractor()->key_size()),
+               hashfcn_t(_aggregate->key_extractor()->key_size())),
+          _agg_page(NULL), _page_count(0), _max_pages(max_pages),
+          _in_size(in_size), _tuples(0), _spills(SPILL_PARTITIONS),
+          _failed(false),
+          _lock(thread_mutex_create()), _cond(thread_cond_create()),
+          _eof(false), _tid(0)
     {
     }
-        
-    size_t operator()(const char *key) const {
-	return fnv_hash(key, _len);
+
+    // Also stops the thread, if the stage is unwinding
+    ~worker_t() {
+        finish();
+        join();
+        for(size_t i=0; i < _queue.size(); i++)
+            _queue[i]->free();
+        thread_cond_destroy(_cond);
+        thread_mutex_destroy(_lock);
     }
+
+    void start(const int id) {
+        thread_t* t = member_func_thread(this, &worker_t::run,
+                                         c_str("HASH_AGG_WORKER_%d", id));
+        _tid = thread_create(t);
+    }
+
+    void join() {
+        if(_tid) {
+            thread_join<void>(_tid);
+            _tid = 0;
+        }
+    }
+
+    // Queues a page, waits while the queue is full
+    void push(qpipe::page* p) {
+        critical_section_t cs(_lock);
+        while(_queue.size() >= MAX_QUEUED_PAGES)
+            thread_cond_wait(_cond, _lock);
+        _queue.push_back(p);
+        thread_cond_broadcast(_cond);
+    }
+
+    // No more pages will be queued
+    void finish() {
+        critical_section_t cs(_lock);
+        _eof = true;
+        thread_cond_broadcast(_cond);
+    }
+
+    void run();
+
+private:
+
+    qpipe::page* pop() {
+        critical_section_t cs(_lock);
+        while(_queue.empty() && !_eof)
+            thread_cond_wait(_cond, _lock);
+        if(_queue.empty())
+            return NULL;
+        qpipe::page* p = _queue.front();
+        _queue.pop_front();
+        thread_cond_broadcast(_cond);
+        return p;
+    }
+
+    void aggregate(const tuple_t &in);
 };
 
-typedef hash_set<char*, hashfcn_t, equalbytes_t>::allocator_type alloc_t;
-typedef hashtable<char *, const char *,
-		  hashfcn_t, extractkey_t,
-		  equalbytes_t, alloc_t> tuple_hash_t;
 
 
-int hash_aggregate_stage_t::alloc_agg(tuple_t &agg, const char* key) {
+void hash_aggregate_stage_t::worker_t::run() {
+    qpipe::page* p;
+    while((p = pop()) != NULL) {
+        guard<qpipe::page> page = p;
+
+        // after a failure, keep draining so that push() never blocks
+        if(_failed)
+            continue;
+        try {
+            for(qpipe::page::iterator it=page->begin(); it != page->end(); ++it)
+                aggregate(*it);
+        } catch(QPipeException &e) {
+            _error = c_str("%s", e.what());
+            _failed = true;
+        } catch(std::exception &e) {
+            _error = c_str("%s", e.what());
+            _failed = true;
+        }
+    }
+}
+
+
+
+/**
+ *  @brief Same as the first level of aggregate_run(), on the share of
+ *  the pages of this worker.
+ */
+void hash_aggregate_stage_t::worker_t::aggregate(const tuple_t &in) {
+    key_extractor_t* agg_key = _aggregate->key_extractor();
+    size_t key_size = agg_key->key_size();
+
+    const char* key = _tup_key->extract_key(in);
+    size_t hash_code = _run.hash(key);
+    char** candidate = _run.find(key, hash_code);
+    if(!candidate) {
+        if(!_agg_page || _agg_page->full()) {
+            if(_page_count >= _max_pages) {
+                // out of memory, leave the group for later
+                spill_tuple(_spills, in, key, _tup_key->key_size(), _in_size, 0);
+                return;
+            }
+            _agg_page = qpipe::page::alloc(_aggregate->tuple_size());
+            _page_list.add(_agg_page);
+            _page_count++;
+        }
+
+        char* agg = _agg_page->allocate();
+        _aggregate->init(agg);
+        memcpy(agg_key->extract_key(agg), key, key_size);
+        candidate = _run.insert_equal(agg, hash_code);
+    }
+
+    _aggregate->aggregate(*candidate, in);
+    _tuples++;
+}
+
+
+
+int hash_aggregate_stage_t::alloc_agg(tuple_t &agg, const char* key, bool may_spill) {
     // out of space?
     if(!_agg_page || _agg_page->full()) {
-        if(_page_count >= MAX_RUN_PAGES)
+        if(may_spill && _page_count >= MAX_RUN_PAGES)
             return 1;
 
         _agg_page = qpipe::page::alloc(_aggregate->tuple_size());
@@ -126,75 +287,269 @@ int hash_aggregate_stage_t::alloc_agg(tuple_t &agg, const char* key) {
     return 0;
 }
 
-void hash_aggregate_stage_t::process_packet() {
-    hash_aggregate_packet_t* packet;
-    packet = (hash_aggregate_packet_t*) _adaptor->get_packet();
-    tuple_fifo* input_buffer = packet->_input_buffer;
-    dispatcher_t::dispatch_packet(packet->_input);
-    _aggregate = packet->_aggregate;
+
+
+/**
+ *  @brief Appends an input tuple whose group did not fit in memory to
+ *  its partition. The partition is picked by a hash of the key seeded
+ *  by the level, thus the groups of one partition spread over the
+ *  partitions of the next level.
+ */
+void hash_aggregate_stage_t::spill_tuple(spill_list_t &spills, const tuple_t &in,
+                                         const char* key, size_t key_size,
+                                         size_t in_size, int level)
+{
+    uint32_t h = fnv_hash(key, key_size, FNV_INIT + (uint32_t)level + 1);
+    spill_t &s = spills[(h >> 16) % spills.size()];
+
+    if(!s._file) {
+        s._file = create_tmp_file(s._file_name, "hash-agg-spill");
+        s._page = qpipe::page::alloc(in_size);
+    }
+    else if(s._page->full()) {
+        s._page->fwrite_full_page(s._file);
+        s._page->clear();
+    }
+
+    s._page->append_tuple(in);
+    s._count++;
+}
+
+
+
+/**
+ *  @brief Aggregates the tuples of 'input' in one run and outputs
+ *  the groups, then aggregates each partition that was spilled.
+ */
+template<class Input>
+void hash_aggregate_stage_t::aggregate_run(Input &input, int level,
+                                           size_t groups_hint, tuple_t &out)
+{
     key_extractor_t* agg_key = _aggregate->key_extractor();
-    key_extractor_t* tup_key = packet->_extractor;
-    //    key_compare_t* compare = packet->_compare;
-    
-    
-    // create a set to hold the sorted run
-    //    tuple_less_t less(agg_key, compare);
     size_t key_size = agg_key->key_size();
-    hashfcn_t hf(key_size);
-    equalbytes_t eql(key_size);
-    extractkey_t ext(agg_key);
+    bool may_spill = (level < MAX_SPILL_LEVEL);
 
-    // start with 10001 buckets
-    tuple_hash_t run(10001, hf, eql, ext);
+    // no more groups than the pages of a run hold fit in memory
+    size_t run_groups = MAX_RUN_PAGES *
+        qpipe::page::capacity(get_default_page_size(), _aggregate->tuple_size());
+    if(may_spill && groups_hint > run_groups)
+        groups_hint = run_groups;
+
+    spill_list_t spills(may_spill? SPILL_PARTITIONS : 0);
+    {
+        tuple_hash_t run(groups_hint,
+                         extractkey_t(agg_key),
+                         equalbytes_t(key_size),
+                         equalbytes_t(key_size),
+                         hashfcn_t(key_size));
 
-    // read in the tuples and aggregate them in the set
-    while(!input_buffer->eof()) {
         _page_list.clear();
         _page_count = 0;
         _agg_page = NULL;
-        while(_page_count < MAX_RUN_PAGES && !input_buffer->eof()) {
-            guard<qpipe::page> page = NULL;
-            tuple_t in;
-            while(1) {
-                // out of pages?
-                if(!input_buffer->get_tuple(in))
-                   break;
-
-                // search for the key in the hash table
-		char const* key = tup_key->extract_key(in);
-		tuple_hash_t::iterator candidate = run.find(key);
-                if(candidate == run.end()) {
-                    // initialize a blank aggregate tuple
-		    tuple_t agg;
-                    if(alloc_agg(agg, key))
-                        break;
-                    
-                    // insert the new aggregate tuple
-                    candidate = run.insert_unique(agg.data).first;
-                }
-                else {
-                    TRACE(TRACE_DEBUG, "Merging a tuple\n");
+
+        // read in the tuples and aggregate them in the table
+        tuple_t in;
+        while(input.get_tuple(in)) {
+
+            // search for the key in the hash table
+            const char* key = _tup_key->extract_key(in);
+            size_t hash_code = run.hash(key);
+            char** candidate = run.find(key, hash_code);
+            if(!candidate) {
+                // initialize a blank aggregate tuple
+                tuple_t agg;
+                if(alloc_agg(agg, key, may_spill)) {
+                    // out of memory, leave the group for later
+                    spill_tuple(spills, in, key, _tup_key->key_size(),
+                                _in_size, level);
+                    continue;
                 }
 
-                // update an existing aggregate tuple (which may have
-                // just barely been inserted)
-                _aggregate->aggregate(*candidate, in);
+                // insert the new aggregate tuple
+                candidate = run.insert_equal(agg.data, hash_code);
             }
-        }
 
-        // TODO: handle cases where the run doesn't fit in memory
-        assert(input_buffer->eof());
+            // update an existing aggregate tuple (which may have
+            // just barely been inserted)
+            _aggregate->aggregate(*candidate, in);
+        }
 
         // write out the result
-        size_t out_size = packet->_output_filter->input_tuple_size();
-        array_guard_t<char> out_data = new char[out_size];
-        tuple_t out(out_data, out_size);
-        for(tuple_hash_t::iterator it=run.begin(); it != run.end(); ++it) {
+        TRACE(TRACE_DEBUG, "Level %d run: %zd groups, %zd pages\n",
+              level, run.size(), _page_count);
+        for(size_t i=0; i < run.capacity(); i++) {
+            char** agg = run.get(i);
+            if(!agg)
+                continue;
+
             // convert the aggregate tuple to an output tuple
-            _aggregate->finish(out, *it);
+            _aggregate->finish(out, *agg);
             _adaptor->output(out);
         }
+
+        // release the run before the spilled partitions
+        _page_list.clear();
+        _page_count = 0;
+        _agg_page = NULL;
+    }
+
+    aggregate_spills(spills, level, out);
+}
+
+
+
+/**
+ *  @brief Aggregates the partitions that were spilled at 'level',
+ *  one at a time, and removes their files.
+ */
+void hash_aggregate_stage_t::aggregate_spills(spill_list_t &spills, int level,
+                                              tuple_t &out)
+{
+    for(spill_list_t::iterator it=spills.begin(); it != spills.end(); ++it) {
+        if(!it->_file)
+            continue;
+
+        guard<qpipe::page> page = it->_page;
+        if(!page->empty())
+            page->fwrite_full_page(it->_file);
+        fclose(it->_file);
+
+        TRACE(TRACE_TEMP_FILE, "Aggregating %zd spilled tuples of %s\n",
+              it->_count, it->_file_name.data());
+
+        file_guard_t file = fopen(it->_file_name.data(), "r");
+        if(!file) {
+            THROW3(FileException, "Caught %s while reopening %s",
+                   errno_to_str().data(), it->_file_name.data());
+        }
+        page->clear();
+        file_input_t spilled(file, page);
+        aggregate_run(spilled, level+1, it->_count, out);
+
+        file.done();
+        if(remove(it->_file_name.data()))
+            TRACE(TRACE_ALWAYS, "Unable to remove temp file %s\n",
+                  it->_file_name.data());
+    }
+}
+
+
+
+void hash_aggregate_stage_t::process_packet() {
+    hash_aggregate_packet_t* packet;
+    packet = (hash_aggregate_packet_t*) _adaptor->get_packet();
+    tuple_fifo* input_buffer = packet->_input_buffer;
+    dispatcher_t::dispatch_packet(packet->_input);
+    _aggregate = packet->_aggregate;
+    _tup_key = packet->_extractor;
+    _in_size = input_buffer->tuple_size();
+
+    size_t out_size = packet->_output_filter->input_tuple_size();
+    array_guard_t<char> out_data = new char[out_size];
+    tuple_t out(out_data, out_size);
+
+    int workers = packet->_workers;
+    if(workers <= 0)
+        workers = envVar::instance()->getVarInt("qpipe-agg-workers", 1);
+
+    if(workers > 1) {
+        aggregate_parallel(packet, workers, out);
+        return;
     }
+
+    fifo_input_t input(input_buffer);
+    aggregate_run(input, 0, packet->_groups_hint, out);
 }
 
 
+
+/**
+ *  @brief Routes the input tuples by key to 'workers' threads, which
+ *  aggregate them in parallel, then outputs the groups of each worker
+ *  and aggregates the partitions each one spilled. If the stage
+ *  throws, the guards stop, join and delete the workers.
+ */
+void hash_aggregate_stage_t::aggregate_parallel(hash_aggregate_packet_t* packet,
+                                                int workers, tuple_t &out)
+{
+    tuple_fifo* input_buffer = packet->_input_buffer;
+    size_t key_size = _tup_key->key_size();
+    stopwatch_t timer;
+
+    // each worker gets its share of the groups and of the pages
+    size_t max_pages = MAX_RUN_PAGES / workers;
+    if(max_pages == 0)
+        max_pages = 1;
+    size_t run_groups = max_pages *
+        qpipe::page::capacity(get_default_page_size(), _aggregate->tuple_size());
+    size_t groups_hint = packet->_groups_hint / workers;
+    if(groups_hint > run_groups)
+        groups_hint = run_groups;
+
+    array_guard_t<guard<worker_t> > pool = new guard<worker_t>[workers];
+    for(int i=0; i < workers; i++) {
+        pool[i] = new worker_t(packet, groups_hint, max_pages, _in_size);
+        pool[i]->start(i);
+    }
+
+    // route each tuple to the worker that owns its group. The seed
+    // differs from the ones of the tables and the spilling, otherwise
+    // the keys of a worker would all collide in the low bits.
+    array_guard_t<guard<qpipe::page> > staging = new guard<qpipe::page>[workers];
+    guard<qpipe::page> page = qpipe::page::alloc(_in_size);
+    while(input_buffer->copy_page(page)) {
+        for(qpipe::page::iterator it=page->begin(); it != page->end(); ++it) {
+            const char* key = _tup_key->extract_key(it->data);
+            uint32_t h = fnv_hash(key, key_size, FNV_INIT + MAX_SPILL_LEVEL + 1);
+            int w = (h >> 16) % workers;
+            guard<qpipe::page> &s = staging[w];
+            if(!s)
+                s = qpipe::page::alloc(_in_size);
+            s->append_tuple(*it);
+            if(s->full())
+                pool[w]->push(s.release());
+        }
+    }
+
+    for(int i=0; i < workers; i++) {
+        if(staging[i])
+            pool[i]->push(staging[i].release());
+        pool[i]->finish();
+    }
+    for(int i=0; i < workers; i++)
+        pool[i]->join();
+    double aggregate_time = timer.time();
+
+    for(int i=0; i < workers; i++) {
+        if(pool[i]->_failed)
+            THROW2(QPipeException, "Aggregation worker failed: %s\n",
+                   pool[i]->_error.data());
+    }
+
+    // write out the groups of each worker, they are disjoint
+    std::vector<spill_list_t> spills(workers);
+    for(int i=0; i < workers; i++) {
+        worker_t* w = pool[i].get();
+        TRACE(TRACE_STATISTICS, "Worker %d: %zd tuples, %zd groups, %zd pages\n",
+              i, w->_tuples, w->_run.size(), w->_page_count);
+
+        for(size_t j=0; j < w->_run.capacity(); j++) {
+            char** agg = w->_run.get(j);
+            if(!agg)
+                continue;
+            w->_aggregate->finish(out, *agg);
+            _adaptor->output(out);
+        }
+
+        // keep the spilled partitions, release the pages of the run
+        spills[i].swap(w->_spills);
+        pool[i].done();
+    }
+    TRACE(TRACE_STATISTICS, "%d workers: aggregated in %.3f secs\n",
+          workers, aggregate_time);
+
+    // the spilled partitions of different workers hold different
+    // groups, aggregate them as the serial path does
+    for(int i=0; i < workers; i++)
+        aggregate_spills(spills[i], 0, out);
+}
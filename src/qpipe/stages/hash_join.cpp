@@ -31,7 +31,9 @@
 #include "qpipe/stages/hash_join.h"
 
 #include <cstring>
+#include <cstdio>
 #include <algorithm>
+#include <vector>
 
 
 ENTER_NAMESPACE(qpipe);
@@ -41,6 +43,14 @@ const c_str hash_join_packet_t::PACKET_TYPE = "HASH_JOIN";
 
 const c_str hash_join_stage_t::DEFAULT_STAGE_NAME = "HASH_JOIN";
 
+// the number of sub-partitions a file partition that does not fit in
+// memory is split to
+static const size_t SPLIT_PARTITIONS = 16;
+
+// the deepest level of splitting. The last level joins its partitions
+// in memory, whatever their size.
+static const int MAX_SPLIT_LEVEL = 4;
+
 
 
 void hash_join_stage_t::process_packet() {
@@ -58,24 +68,170 @@ void hash_join_stage_t::process_packet() {
        plans, the right relation will be a table scan. */
 
 
+    /* Unless this is an outer join, the left tuples whose keys are
+       not in the right relation are useless. Have the left side drop
+       them, once we have read the right relation. */
+    guard<runtime_filter_t> rfilter;
+    if (!outer_join && runtime_filter_t::is_enabled()) {
+        rfilter = new runtime_filter_t(_join->left_key_offset(),
+                                       _join->key_size());
+        packet->_left->attach_runtime_filter(rfilter);
+    }
+
+
+    /* A join with the same right relation may have left its hash
+       table in the build cache. Then we do not read the right
+       relation at all. */
+    guard<build_cache_entry_t> build;
+    if (build_cache_t::is_enabled())
+        build = build_cache_t::lookup(packet->_right->plan(), _join, distinct);
+
+    tuple_fifo *left_buffer = packet->_left_buffer;
+    guard<tuple_hash_t> table;
+
+    if (build) {
+        /* The right subtree is never dispatched, release the workers
+           reserved for it. Its packets are deleted with ours. */
+        guard<dispatcher_t::worker_releaser_t> wr =
+            dispatcher_t::releaser_acquire();
+        packet->_right->declare_worker_needs(wr);
+        wr->release_resources();
+
+        if (rfilter)
+            publish_filter(rfilter, build->table());
+        dispatcher_t::dispatch_packet(packet->_left);
+    }
+    else {
+        if (!build_table(packet, rfilter, table))
+            /* No right side tuples! "Normal" (inner) join returns
+               nothing. Outer join returns everything in left relation
+               with appropriate null values. */
+            /* TODO Handle outer join here. */
+            return;
+
+        /* A right relation that fits in memory is kept in the build
+           cache. The cache takes over the table and the pages of the
+           partitions. */
+        if (build_cache_t::is_enabled() && !has_file_partitions()) {
+            page_list pages;
+            size_t bytes = table->capacity() * sizeof(char*);
+            for(partition_list_t::iterator it=partitions.begin(); it != partitions.end(); ++it) {
+                for(qpipe::page* p = it->_page; p; p = p->next) {
+                    pages.push_back(p);
+                    bytes += p->page_size();
+                }
+                it->_page = NULL;
+            }
+            build = build_cache_t::insert(packet->_right->plan(), _join,
+                                          distinct, table.release(),
+                                          pages, bytes);
+        }
+    }
+
+
+    // start building left side hash partitions
+    if(!left_buffer->ensure_read_ready())
+        // No left-side tuples... no join tuples.
+        return;
+
+    
+    // read in the left relation now
+    extractkey_t left_key_extractor(_join, false);
+    hashfcn_t    hasher(_join->key_size());
+    tuple_t left(NULL, _join->left_tuple_size());
+    array_guard_t<char> data = new char[_join->output_tuple_size()];
+    tuple_t out(data, _join->output_tuple_size());
+    // read a span of tuples at a time, until eof
+    qpipe::page::iterator lit, lend;
+    while(left_buffer->get_tuples(lit, lend)) {
+
+        while(lit != lend) {
+            left = lit.advance();
+
+            const char* left_key = left_key_extractor(left.data);
+
+            // the cached table holds the whole right relation
+            if(build) {
+                probe_tuple(*build->table(), left_key, left, out, outer_join);
+                continue;
+            }
+
+            // which partition?
+            int hash_code = hasher(left_key);
+            int partition = hash_code % partitions.size();
+            partition_t &p = partitions[partition];
+
+            // empty partition?
+            if(p.size == 0)
+                continue;
+
+            // add to file partition?
+            if(p.file) {
+                qpipe::page* pg = p._page;
+
+                // flush to disk?
+                if(pg->full()) {
+                    pg->fwrite_full_page(p.file);
+                    pg->clear();
+                }
+
+                // add the tuple to the page
+                pg->append_tuple(left);
+            }
+
+            // check in-memory hash table
+            else
+                probe_tuple(*table, left_key, left, out, outer_join);
+        }
+    }
+
+    // the cached table and its pages are freed by the cache
+    if(build)
+        return;
+
+    // close all the files and release in-memory pages
+    table->clear();
+    for(partition_list_t::iterator it=partitions.begin(); it != partitions.end(); ++it) {
+        bool spilled = (it->file != NULL);
+        if(spilled) 
+            close_file(it, left_action_t());
+
+        // delete the page list
+        for(guard<qpipe::page> pg = it->_page; pg; pg = pg->next);
+        it->_page = NULL;
+
+        // join the two sides of a file partition, one at a time
+        if(spilled)
+            join_file_partition(*it, *table, out, outer_join, distinct);
+    }
+}
+
+
+
+/**
+ *  @brief Dispatches both sides, divides the right relation into
+ *  partitions and builds the hash table of the in-memory ones.
+ *
+ *  @return false if the right relation is empty.
+ */
+bool hash_join_stage_t::build_table(hash_join_packet_t* packet,
+                                    runtime_filter_t* rfilter,
+                                    guard<tuple_hash_t> &table)
+{
+    bool distinct = packet->_distinct;
+    std::vector<uint32_t> rf_hashes;
+
     /* First divide the right relation into partitions. */
     tuple_fifo *right_buffer = packet->_right_buffer;
     dispatcher_t::dispatch_packet(packet->_right);
-    tuple_fifo *left_buffer = packet->_left_buffer;
     dispatcher_t::dispatch_packet(packet->_left);
 
 
     /* Quick check for no-tuple case. */
-    if(!right_buffer->ensure_read_ready()) {
-        /* No right side tuples! "Normal" (inner) join returns
-           nothing. Outer join returns everything in left relation
-           with appropriate null values. */
-        /* TODO Handle outer join here. */
-        return;
-    }
+    if(!right_buffer->ensure_read_ready())
+        return false;
     
     
-    hash_join_stage_t::extractkey_t extract_left (_join, false);
     hash_join_stage_t::extractkey_t extract_right(_join, true);
     hash_join_stage_t::hashfcn_t    hashfcn(_join->key_size());
 
@@ -84,30 +240,40 @@ void hash_join_stage_t::process_packet() {
        relation. Read each tuple and assign it to the appropriate
        partition. We don't have a "primary" partition and secondary
        partitions.  If any of our partitions fill up, we flush to
-       disk. */
-    tuple_t right;
-    while(1) {
-
-        /* check for EOF */
-        if(!right_buffer->get_tuple(right))
-            break;
-
-        /* Identify the partition that needs this tuple. */
-        size_t hash_code = hashfcn(extract_right(right.data));
-        int    hash_int  = (int)hash_code;
-        int    partition = hash_int % partitions.size();
-
-        /* Simple optimization: Flush _before_ inserting into a full
-           page, not after we fill a page. This can avoid one
-           unnecessary flush per partition. */
-        // assert(0);
-        test_overflow(partition);
-
-        /* If the partition was full, we would have flushed its data
-           and cleared it of tuples. We can now safely append to the
-           page. */
-        qpipe::page* &p = partitions[partition]._page;
-        p->append_tuple(right);
+       disk. The input is read a span of tuples at a time, until
+       EOF. */
+    qpipe::page::iterator rit, rend;
+    while(right_buffer->get_tuples(rit, rend)) {
+
+        while(rit != rend) {
+            tuple_t right = rit.advance();
+
+            /* Identify the partition that needs this tuple. */
+            size_t hash_code = hashfcn(extract_right(right.data));
+            int    hash_int  = (int)hash_code;
+            int    partition = hash_int % partitions.size();
+
+            if (rfilter)
+                rf_hashes.push_back((uint32_t)hash_code);
+
+            /* Simple optimization: Flush _before_ inserting into a full
+               page, not after we fill a page. This can avoid one
+               unnecessary flush per partition. */
+            // assert(0);
+            test_overflow(partition);
+
+            /* If the partition was full, we would have flushed its data
+               and cleared it of tuples. We can now safely append to the
+               page. */
+            qpipe::page* &p = partitions[partition]._page;
+            p->append_tuple(right);
+        }
+    }
+
+    /* The right relation is complete, publish its keys */
+    if (rfilter) {
+        rfilter->publish(rf_hashes);
+        std::vector<uint32_t>().swap(rf_hashes);
     }
 
     /* TODO Flush all partitions to disk and free the partition
@@ -126,11 +292,14 @@ void hash_join_stage_t::process_packet() {
     equalbytes_t equal_rtup(_join->right_tuple_size());
     hashfcn_t    hasher(_join->key_size());
     
-    tuple_hash_t table(page_count * page_capacity,
-                       right_key_extractor,
-                       equal_key,
-                       equal_rtup,
-                       hasher);
+    /* The in-memory partitions hold at most page_count pages of
+       tuples. Size the table for them, so that it never grows while
+       we build it. */
+    table = new tuple_hash_t(page_count * page_capacity,
+                             right_key_extractor,
+                             equal_key,
+                             equal_rtup,
+                             hasher);
     
     /* Flush any partitions that went to disk */
     right_action_t right_action(_join->left_tuple_size());
@@ -152,9 +321,9 @@ void hash_join_stage_t::process_packet() {
                     // Distinguish between DISTINCT join and
                     // non-DISTINCT join, as DB/2 does
                     if(distinct)
-                        table.insert_unique_noresize(it->data);
+                        table->insert_unique(it->data);
                     else
-                        table.insert_noresize(it->data);
+                        table->insert_equal(it->data);
                 }
 
                 p = p->next;
@@ -162,78 +331,233 @@ void hash_join_stage_t::process_packet() {
         }
     }
 
+    return true;
+}
 
-    // start building left side hash partitions
-    if(!left_buffer->ensure_read_ready())
-        // No left-side tuples... no join tuples.
+
+
+/**
+ *  @brief Whether any partition of the right relation went to disk
+ */
+bool hash_join_stage_t::has_file_partitions() {
+
+    for(partition_list_t::iterator it=partitions.begin(); it != partitions.end(); ++it) {
+        if(it->file)
+            return true;
+    }
+    return false;
+}
+
+
+
+/**
+ *  @brief Publishes the keys of a cached table to the runtime filter
+ *  of the left side.
+ */
+void hash_join_stage_t::publish_filter(runtime_filter_t* rfilter,
+                                       tuple_hash_t* table) {
+
+    extractkey_t extract_right(_join, true);
+    std::vector<uint32_t> hashes;
+    hashes.reserve(table->size());
+    for(size_t i=0; i < table->capacity(); i++) {
+        char** entry = table->get(i);
+        if(entry)
+            hashes.push_back((uint32_t)table->hash(extract_right(*entry)));
+    }
+    rfilter->publish(hashes);
+}
+
+
+
+/**
+ *  @brief Outputs the joins of a left tuple with the matching right
+ *  tuples of the hash table.
+ */
+void hash_join_stage_t::probe_tuple(tuple_hash_t &table, const char* left_key,
+                                    tuple_t &left, tuple_t &out, bool outer_join)
+{
+    std::pair<tuple_hash_t::iterator, tuple_hash_t::iterator> range;
+    range = table.equal_range(left_key);
+
+    if(outer_join && range.first == range.second) {
+        _join->left_outer_join(out, left);
+        _adaptor->output(out);
         return;
+    }
 
-    
-    // read in the left relation now
-    extractkey_t left_key_extractor(_join, false);
-    tuple_t left(NULL, _join->left_tuple_size());
-    array_guard_t<char> data = new char[_join->output_tuple_size()];
-    while(1) {
-
-        // eof?
-        if(!left_buffer->get_tuple(left))
-            break;
-     
-        // which partition?
-        const char* left_key = left_key_extractor(left.data);
-        int hash_code = hasher(left_key);
-        int partition = hash_code % partitions.size();
-        partition_t &p = partitions[partition];
-
-        // empty partition?
-        if(p.size == 0)
-            continue;
+    tuple_t right(NULL, _join->right_tuple_size());
+    for(tuple_hash_t::iterator it = range.first; it != range.second; ++it) {
+        right.data = *it;
+        _join->join(out, left, right);
+        _adaptor->output(out);
+    }
+}
 
-        // add to file partition?
-        if(p.file) {
-            qpipe::page* pg = p._page;
 
-            // flush to disk?
-            if(pg->full()) {
-                pg->fwrite_full_page(p.file);
-                pg->clear();
-            }
 
-            // add the tuple to the page
-            pg->append_tuple(left);
+/**
+ *  @brief Joins a partition that went to disk: reads its right side
+ *  back into memory and builds the (empty) hash table out of it, then
+ *  probes the table with its left side. The files are removed.
+ *
+ *  If the right side does not fit in the page quota either, both
+ *  sides are split into SPLIT_PARTITIONS sub-partitions by a hash of
+ *  the key seeded by the level, and each one is joined the same way.
+ */
+void hash_join_stage_t::join_file_partition(partition_t &p, tuple_hash_t &table,
+                                            tuple_t &out, bool outer_join,
+                                            bool distinct, int level)
+{
+    if(p.size > page_quota && level < MAX_SPLIT_LEVEL) {
+        TRACE(TRACE_TEMP_FILE, "Splitting file partition %s (%d pages) at level %d\n",
+              p.file_name1.data(), p.size, level);
+
+        partition_list_t subs(SPLIT_PARTITIONS);
+        split_file(p.file_name1, true, subs, level, outer_join);
+        split_file(p.file_name2, false, subs, level, outer_join);
+
+        if(remove(p.file_name1.data()))
+            TRACE(TRACE_ALWAYS, "Unable to remove temp file %s\n", p.file_name1.data());
+        if(remove(p.file_name2.data()))
+            TRACE(TRACE_ALWAYS, "Unable to remove temp file %s\n", p.file_name2.data());
+
+        for(partition_list_t::iterator it=subs.begin(); it != subs.end(); ++it) {
+            // an inner join has nothing to do without right tuples
+            if(it->size == 0 && !outer_join)
+                continue;
+            join_file_partition(*it, table, out, outer_join, distinct, level+1);
         }
+        return;
+    }
 
-        // check in-memory hash table
-        else {
-            std::pair<tuple_hash_t::iterator, tuple_hash_t::iterator> range;
-            range = table.equal_range(left_key);
-
-            tuple_t out(data, _join->output_tuple_size());
-            if(outer_join && range.first == range.second) {
-                _join->left_outer_join(out, left);
-                _adaptor->output(out);
+    size_t page_capacity =
+        qpipe::page::capacity(get_default_page_size(),
+                              _join->right_tuple_size());
+    table.reserve(p.size * page_capacity);
+
+    TRACE(TRACE_TEMP_FILE, "Joining file partition %s (%d pages) with %s\n",
+          p.file_name1.data(), p.size, p.file_name2.data());
+
+    // build (a sub-partition of an outer join may have no right side)
+    page_trash_stack right_pages;
+    if(p.size > 0) {
+        file_guard_t file = fopen(p.file_name1.data(), "r");
+        if(!file) {
+            THROW3(FileException, "Caught %s while reopening %s",
+                   errno_to_str().data(), p.file_name1.data());
+        }
+        while(1) {
+            guard<qpipe::page> pg = qpipe::page::alloc(_join->right_tuple_size());
+            if(!pg->fread_full_page(file))
+                break;
+
+            for(qpipe::page::iterator it=pg->begin(); it != pg->end(); ++it) {
+                if(distinct)
+                    table.insert_unique(it->data);
+                else
+                    table.insert_equal(it->data);
             }
-            else {
-                for(tuple_hash_t::iterator it = range.first; it != range.second; ++it) {
-                    right.data = *it;
-                    _join->join(out, left, right);
-                    _adaptor->output(out);
-                }
+            right_pages.add(pg.release());
+        }
+    }
+
+    // probe
+    {
+        file_guard_t file = fopen(p.file_name2.data(), "r");
+        if(!file) {
+            THROW3(FileException, "Caught %s while reopening %s",
+                   errno_to_str().data(), p.file_name2.data());
+        }
+        extractkey_t left_key_extractor(_join, false);
+        guard<qpipe::page> pg = qpipe::page::alloc(_join->left_tuple_size());
+        while(pg->fread_full_page(file)) {
+            for(qpipe::page::iterator it=pg->begin(); it != pg->end(); ++it) {
+                tuple_t left = *it;
+                probe_tuple(table, left_key_extractor(left.data), left, out, outer_join);
             }
         }
     }
 
-    // close all the files and release in-memory pages
     table.clear();
-    for(partition_list_t::iterator it=partitions.begin(); it != partitions.end(); ++it) {
-        // delete the page list
-        for(guard<qpipe::page> pg = it->_page; pg; pg = pg->next);
-        if(it->file) 
-            close_file(it, left_action_t());
+    if(p.size > 0 && remove(p.file_name1.data()))
+        TRACE(TRACE_ALWAYS, "Unable to remove temp file %s\n", p.file_name1.data());
+    if(remove(p.file_name2.data()))
+        TRACE(TRACE_ALWAYS, "Unable to remove temp file %s\n", p.file_name2.data());
+}
+
+
+
+/**
+ *  @brief Splits one side of a file partition into the sub-partitions
+ *  of the next level. The right side goes first: the pages written to
+ *  each sub-partition are its size. The left side then gets a file in
+ *  every sub-partition that may produce output, even if no tuple goes
+ *  there, and drops the tuples that cannot.
+ */
+void hash_join_stage_t::split_file(const c_str &file_name, bool right,
+                                   partition_list_t &subs, int level,
+                                   bool outer_join)
+{
+    size_t tuple_size = right? _join->right_tuple_size() : _join->left_tuple_size();
+    size_t key_size = _join->key_size();
+    extractkey_t extract(_join, right);
+
+    std::vector<qpipe::page*> pages(subs.size(), (qpipe::page*)NULL);
+    std::vector<FILE*> files(subs.size(), (FILE*)NULL);
+    if(!right) {
+        for(size_t i=0; i < subs.size(); i++) {
+            if(subs[i].size > 0 || outer_join) {
+                files[i] = create_tmp_file(subs[i].file_name2, "hash-join-left");
+                pages[i] = qpipe::page::alloc(tuple_size);
+            }
+        }
     }
 
-    // TODO: handle the file partitions now...
+    {
+        file_guard_t file = fopen(file_name.data(), "r");
+        if(!file) {
+            THROW3(FileException, "Caught %s while reopening %s",
+                   errno_to_str().data(), file_name.data());
+        }
+        guard<qpipe::page> pg = qpipe::page::alloc(tuple_size);
+        while(pg->fread_full_page(file)) {
+            for(qpipe::page::iterator it=pg->begin(); it != pg->end(); ++it) {
+                uint32_t h = fnv_hash(extract(it->data), key_size,
+                                      FNV_INIT + (uint32_t)level + 1);
+                size_t i = (h >> 16) % subs.size();
+
+                qpipe::page* &sp = pages[i];
+                if(!sp) {
+                    // the left tuples without right ones to join
+                    if(!right)
+                        continue;
+                    files[i] = create_tmp_file(subs[i].file_name1, "hash-join-right");
+                    sp = qpipe::page::alloc(tuple_size);
+                }
+                else if(sp->full()) {
+                    sp->fwrite_full_page(files[i]);
+                    sp->clear();
+                    if(right)
+                        subs[i].size++;
+                }
+                sp->append_tuple(*it);
+            }
+        }
+    }
 
+    // write the last pages and close the files
+    for(size_t i=0; i < subs.size(); i++) {
+        if(!pages[i])
+            continue;
+        if(!pages[i]->empty()) {
+            pages[i]->fwrite_full_page(files[i]);
+            if(right)
+                subs[i].size++;
+        }
+        pages[i]->free();
+        fclose(files[i]);
+    }
 }
 
 
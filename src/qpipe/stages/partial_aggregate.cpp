@@ -23,6 +23,9 @@
 
 #include "qpipe/stages/partial_aggregate.h"
 
+#include <deque>
+#include <vector>
+
 
 
 const c_str partial_aggregate_packet_t::PACKET_TYPE = "PARTIAL_AGGREGATE";
@@ -36,6 +39,145 @@ const c_str partial_aggregate_stage_t::DEFAULT_STAGE_NAME = "PARTIAL_AGGREGATE_S
 // the maximum number of pages allowed in a single run
 static const size_t MAX_RUN_PAGES = 10000;
 
+// the maximum number of input pages queued to a parallel worker
+static const size_t MAX_QUEUED_PAGES = 64;
+
+
+
+/**
+ *  @brief A thread of the parallel aggregation. Aggregates the input
+ *  pages queued to it into its own run, with its own copy of the
+ *  aggregate functor. The pages of its aggregate tuples live as long
+ *  as the worker does.
+ */
+class partial_agg_worker_t {
+public:
+
+    typedef partial_aggregate_stage_t::tuple_set_t tuple_set_t;
+
+    guard<tuple_aggregate_t> _aggregate;
+    guard<key_extractor_t>   _tup_key;
+    tuple_set_t              _run;
+    page_trash_stack         _page_list;
+    qpipe::page*             _agg_page;
+    size_t                   _tuples;
+
+private:
+
+    pthread_mutex_t          _lock;
+    pthread_cond_t           _cond;
+    std::deque<qpipe::page*> _queue;
+    bool                     _eof;
+    pthread_t                _tid;
+
+public:
+
+    partial_agg_worker_t(partial_aggregate_packet_t* packet)
+        : _aggregate(packet->_aggregate->clone()),
+          _tup_key(packet->_extractor->clone()),
+          _run(tuple_less_t(_aggregate->key_extractor(), packet->_compare)),
+          _agg_page(NULL), _tuples(0),
+          _lock(thread_mutex_create()), _cond(thread_cond_create()),
+          _eof(false), _tid(0)
+    {
+    }
+
+    ~partial_agg_worker_t() {
+        for(size_t i=0; i < _queue.size(); i++)
+            _queue[i]->free();
+        thread_cond_destroy(_cond);
+        thread_mutex_destroy(_lock);
+    }
+
+    void start(const int id) {
+        thread_t* t = member_func_thread(this, &partial_agg_worker_t::run,
+                                         c_str("AGG_WORKER_%d", id));
+        _tid = thread_create(t);
+    }
+
+    void join() {
+        thread_join<void>(_tid);
+    }
+
+    // Queues a page, waits while the queue is full
+    void push(qpipe::page* p) {
+        critical_section_t cs(_lock);
+        while(_queue.size() >= MAX_QUEUED_PAGES)
+            thread_cond_wait(_cond, _lock);
+        _queue.push_back(p);
+        thread_cond_broadcast(_cond);
+    }
+
+    // No more pages will be queued
+    void finish() {
+        critical_section_t cs(_lock);
+        _eof = true;
+        thread_cond_broadcast(_cond);
+    }
+
+    void run();
+
+private:
+
+    qpipe::page* pop() {
+        critical_section_t cs(_lock);
+        while(_queue.empty() && !_eof)
+            thread_cond_wait(_cond, _lock);
+        if(_queue.empty())
+            return NULL;
+        qpipe::page* p = _queue.front();
+        _queue.pop_front();
+        thread_cond_broadcast(_cond);
+        return p;
+    }
+
+    void aggregate(const tuple_t &in);
+};
+
+
+
+void partial_agg_worker_t::run() {
+    qpipe::page* p;
+    while((p = pop()) != NULL) {
+        guard<qpipe::page> page = p;
+        for(qpipe::page::iterator it=page->begin(); it != page->end(); ++it)
+            aggregate(*it);
+    }
+}
+
+
+
+/**
+ *  @brief Same as the serial aggregation, except that a run is not
+ *  bounded by MAX_RUN_PAGES (neither is the serial one, which asserts
+ *  that its input fits).
+ */
+void partial_agg_worker_t::aggregate(const tuple_t &in) {
+    key_extractor_t* agg_key = _aggregate->key_extractor();
+    int hint = _tup_key->extract_hint(in);
+
+    // see process_packet() for the pointer math
+    size_t offset = agg_key->key_offset();
+    const char* key_data = _tup_key->extract_key(in);
+    hint_tuple_pair_t key(hint, (char*)key_data - offset);
+
+    tuple_set_t::iterator candidate = _run.find(key);
+    if(candidate == _run.end()) {
+        if(!_agg_page || _agg_page->full()) {
+            _agg_page = qpipe::page::alloc(_aggregate->tuple_size());
+            _page_list.add(_agg_page);
+        }
+
+        hint_tuple_pair_t agg(hint, _agg_page->allocate());
+        _aggregate->init(agg.data);
+        memcpy(agg_key->extract_key(agg.data), key_data, agg_key->key_size());
+        candidate = _run.insert(agg).first;
+    }
+
+    _aggregate->aggregate(candidate->data, in);
+    _tuples++;
+}
+
 
 
 int partial_aggregate_stage_t::alloc_agg(hint_tuple_pair_t &agg, const char* key) {
@@ -65,9 +207,23 @@ int partial_aggregate_stage_t::alloc_agg(hint_tuple_pair_t &agg, const char* key
 void partial_aggregate_stage_t::process_packet() {
     partial_aggregate_packet_t* packet;
     packet = (partial_aggregate_packet_t*) _adaptor->get_packet();
-    tuple_fifo* input_buffer = packet->_input_buffer;
     dispatcher_t::dispatch_packet(packet->_input);
     _aggregate = packet->_aggregate;
+
+    int workers = packet->_workers;
+    if(workers <= 0)
+        workers = envVar::instance()->getVarInt("qpipe-agg-workers", 1);
+
+    if(workers > 1)
+        aggregate_parallel(packet, workers);
+    else
+        aggregate_serial(packet);
+}
+
+
+
+void partial_aggregate_stage_t::aggregate_serial(partial_aggregate_packet_t* packet) {
+    tuple_fifo* input_buffer = packet->_input_buffer;
     key_extractor_t* agg_key = _aggregate->key_extractor();
     key_extractor_t* tup_key = packet->_extractor;
     key_compare_t* compare = packet->_compare;
@@ -148,3 +304,101 @@ void partial_aggregate_stage_t::process_packet() {
         }
     }
 }
+
+
+
+/**
+ *  @brief Splits the input across 'workers' threads, which aggregate
+ *  it in parallel, and outputs their runs combined in key order.
+ */
+void partial_aggregate_stage_t::aggregate_parallel(partial_aggregate_packet_t* packet,
+                                                   int workers)
+{
+    tuple_fifo* input_buffer = packet->_input_buffer;
+    key_extractor_t* tup_key = packet->_extractor;
+    size_t in_size = input_buffer->tuple_size();
+    bool by_key = !_aggregate->can_merge();
+    stopwatch_t timer;
+
+    std::vector<partial_agg_worker_t*> pool;
+    for(int i=0; i < workers; i++) {
+        pool.push_back(new partial_agg_worker_t(packet));
+        pool[i]->start(i);
+    }
+
+    // hand the input to the workers, a page at a time
+    std::vector<qpipe::page*> staging(workers, (qpipe::page*)NULL);
+    int next = 0;
+    while(1) {
+        qpipe::page* p = qpipe::page::alloc(in_size);
+        if(!input_buffer->copy_page(p)) {
+            p->free();
+            break;
+        }
+
+        if(!by_key) {
+            pool[next]->push(p);
+            next = (next + 1) % workers;
+            continue;
+        }
+
+        // route each tuple to the worker that owns its group
+        guard<qpipe::page> page = p;
+        for(qpipe::page::iterator it=page->begin(); it != page->end(); ++it) {
+            const char* key = tup_key->extract_key(it->data);
+            int w = fnv_hash(key, tup_key->key_size()) % workers;
+            qpipe::page* &s = staging[w];
+            if(!s)
+                s = qpipe::page::alloc(in_size);
+            s->append_tuple(*it);
+            if(s->full()) {
+                pool[w]->push(s);
+                s = NULL;
+            }
+        }
+    }
+
+    for(int i=0; i < workers; i++) {
+        if(staging[i])
+            pool[i]->push(staging[i]);
+        pool[i]->finish();
+    }
+    for(int i=0; i < workers; i++)
+        pool[i]->join();
+    double aggregate_time = timer.time();
+
+
+    // combine the runs. The groups of different workers are disjoint
+    // when routed by key, otherwise the partial aggregates of a group
+    // are merged.
+    tuple_less_t less(_aggregate->key_extractor(), packet->_compare);
+    tuple_set_t run(less);
+    for(int i=0; i < workers; i++) {
+        partial_agg_worker_t* w = pool[i];
+        TRACE(TRACE_STATISTICS, "Worker %d: %zd tuples, %zd groups\n",
+              i, w->_tuples, w->_run.size());
+
+        for(tuple_set_t::iterator it=w->_run.begin(); it != w->_run.end(); ++it) {
+            std::pair<tuple_set_t::iterator, bool> ins = run.insert(*it);
+            if(!ins.second) {
+                assert(!by_key);
+                _aggregate->merge(ins.first->data, it->data);
+            }
+        }
+    }
+    TRACE(TRACE_STATISTICS, "%d workers (%s): aggregated in %.3f secs, merged in %.3f secs\n",
+          workers, (by_key? "by key" : "round-robin"), aggregate_time, timer.time());
+
+    // write out the result
+    size_t out_size = packet->_output_filter->input_tuple_size();
+    array_guard_t<char> out_data = new char[out_size];
+    tuple_t out(out_data, out_size);
+    for(tuple_set_t::iterator it=run.begin(); it != run.end(); ++it) {
+        _aggregate->finish(out, it->data);
+        _adaptor->output(out);
+    }
+
+    // the aggregate tuples live in the pages of the workers
+    for(int i=0; i < workers; i++)
+        delete pool[i];
+}
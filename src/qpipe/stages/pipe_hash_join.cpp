@@ -29,20 +29,10 @@
 
 
 #include "qpipe/stages/pipe_hash_join.h"
+#include "util/hashtable.h"
 #include <cstring>
 #include <algorithm>
-
-#if defined(linux) || defined(__linux)
-/*GNU found*/
-#include <ext/hash_set>
-using __gnu_cxx::hashtable;
-using __gnu_cxx::hash_set;
-#else
-/*Solaris*/
-#include <hash_set>
-using std::hash_set;
-using std::hashtable;
-#endif
+#include <vector>
 
 
 
@@ -102,16 +92,28 @@ struct hashfcn_t {
 };
 
 
-typedef hash_set<char*, hashfcn_t, equalbytes_t>::allocator_type alloc_t;
-
 typedef hashtable<char *, const char *,
-                  hashfcn_t, extractkey_t,
-                  equalbytes_t, alloc_t> tuple_hash_t;
-
-// typedef hashtable<char *, const char *,
-//                   extractkey_t,
-//                   equalbytes_t, equalbytes_t, 
-//                   hashfcn_t> tuple_hash_t;
+                  extractkey_t,
+                  equalbytes_t, equalbytes_t, 
+                  hashfcn_t> tuple_hash_t;
+
+
+/* Publishes the keys of a complete side to the filter of the other
+   side, then drops our reference to the filter. */
+static void publish_filter(guard<runtime_filter_t>& rfilter,
+                           tuple_hash_t& table, extractkey_t const& ke,
+                           hashfcn_t const& hf)
+{
+    std::vector<uint32_t> hashes;
+    hashes.reserve(table.size());
+    for (size_t i=0; i<table.capacity(); i++) {
+        char** entry = table.get(i);
+        if (entry)
+            hashes.push_back((uint32_t)hf(ke(*entry)));
+    }
+    rfilter->publish(hashes);
+    rfilter.done();
+}
 
 
 void pipe_hash_join_stage_t::process_packet() {
@@ -125,6 +127,21 @@ void pipe_hash_join_stage_t::process_packet() {
 
     // TODO: deal with relations that don't fit in memory
 
+    _join = packet->_join;
+
+    /* Each side can drop the tuples whose keys are not in the other
+       side, once the other side is complete. */
+    guard<runtime_filter_t> left_filter;
+    guard<runtime_filter_t> right_filter;
+    if (runtime_filter_t::is_enabled()) {
+        left_filter = new runtime_filter_t(_join->left_key_offset(),
+                                           _join->key_size());
+        packet->_left->attach_runtime_filter(left_filter);
+        right_filter = new runtime_filter_t(_join->right_key_offset(),
+                                            _join->key_size());
+        packet->_right->attach_runtime_filter(right_filter);
+    }
+
 
     /* Dispatch both producers */
     tuple_fifo *right_buffer = packet->_right_buffer;
@@ -132,7 +149,6 @@ void pipe_hash_join_stage_t::process_packet() {
     tuple_fifo *left_buffer = packet->_left_buffer;
     dispatcher_t::dispatch_packet(packet->_left);
 
-    _join = packet->_join;
     tuple_t left(NULL, left_buffer->tuple_size());
     tuple_t right(NULL, right_buffer->tuple_size());
     extractkey_t left_ke(_join, true);
@@ -140,12 +156,9 @@ void pipe_hash_join_stage_t::process_packet() {
     equalbytes_t eq(_join->key_size());
     hashfcn_t hf(_join->key_size());
 
-    // init the hash tables
-    // tuple_hash_t left_hash(10001, left_ke, eq, eq, hf);
-    // tuple_hash_t right_hash(10001, right_ke, eq, eq, hf);
-
-    tuple_hash_t left_hash(10001, hf, eq, left_ke);
-    tuple_hash_t right_hash(10001, hf, eq, right_ke);
+    // init the hash tables, they grow with the inputs
+    tuple_hash_t left_hash(10001, left_ke, eq, eq, hf);
+    tuple_hash_t right_hash(10001, right_ke, eq, eq, hf);
 
 
     // and the page store
@@ -178,8 +191,8 @@ void pipe_hash_join_stage_t::process_packet() {
 	    // this 'left' purposely masks the previously declared one
 	    tuple_t left = it.advance();
 	    left_hash.insert_equal(left.data);
-	    hit probe = right_hash.find(left_ke(left.data));
-	    for(; probe != right_hash.end(); ++probe) {
+	    std::pair<hit, hit> range = right_hash.equal_range(left_ke(left.data));
+	    for(hit probe = range.first; probe != range.second; ++probe) {
 		right.data = *probe;
 		_join->join(out, left, right);
 		_adaptor->output(out);
@@ -202,8 +215,8 @@ void pipe_hash_join_stage_t::process_packet() {
 	    // this 'right' purposely masks the previously declared one
 	    tuple_t right = it.advance();
 	    right_hash.insert_equal(right.data);
-	    hit probe = left_hash.find(right_ke(right.data));
-	    for(; probe != left_hash.end(); ++probe) {
+	    std::pair<hit, hit> range = left_hash.equal_range(right_ke(right.data));
+	    for(hit probe = range.first; probe != range.second; ++probe) {
 		left.data = *probe;
 		_join->join(out, left, right);
 		_adaptor->output(out);
@@ -215,6 +228,12 @@ void pipe_hash_join_stage_t::process_packet() {
     }
     
  do_decide:
+    // publish the filters of the sides whose other side is complete
+    if (left_filter && (right_ready == -1))
+        publish_filter(left_filter, right_hash, right_ke, hf);
+    if (right_filter && (left_ready == -1))
+        publish_filter(right_filter, left_hash, left_ke, hf);
+
     // now what?
     if(left_ready == 1)
 	goto do_left;
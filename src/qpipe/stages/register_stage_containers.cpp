@@ -36,6 +36,7 @@ ENTER_NAMESPACE(qpipe);
 #define MAX_NUM_CLIENTS 128
 
 #define MAX_NUM_TSCAN_THREADS             MAX_NUM_CLIENTS * 2 // Q4, Q16 have two scans
+#define MAX_NUM_CSCAN_THREADS             MAX_NUM_CLIENTS
 #define MAX_NUM_AGGREGATE_THREADS         MAX_NUM_CLIENTS
 #define MAX_NUM_PARTIAL_AGGREGATE_THREADS MAX_NUM_CLIENTS * 2 // Q1 uses two partial aggregates
 #define MAX_NUM_HASH_JOIN_THREADS         MAX_NUM_CLIENTS
@@ -43,13 +44,20 @@ ENTER_NAMESPACE(qpipe);
 #define MAX_NUM_FUNC_CALL_THREADS         MAX_NUM_CLIENTS
 #define MAX_NUM_SORT_THREADS              MAX_NUM_CLIENTS * 2 // Q16 uses two sorts
 #define MAX_NUM_SORTED_IN_STAGE_THREADS   MAX_NUM_CLIENTS
+#define MAX_NUM_RSCAN_THREADS             MAX_NUM_CLIENTS
 
 
 void register_stage_containers() 
 {
     TRACE( TRACE_ALWAYS, "Registering stage containers\n");
 
+    result_cache_t::init();
+    runtime_filter_t::init();
+    build_cache_t::init();
+    cscan_stage_t::init();
+
     register_stage<tscan_stage_t>(MAX_NUM_TSCAN_THREADS, true);
+    register_stage<cscan_stage_t>(MAX_NUM_CSCAN_THREADS, true);
     register_stage<aggregate_stage_t>(MAX_NUM_AGGREGATE_THREADS, true);
     register_stage<partial_aggregate_stage_t>(MAX_NUM_PARTIAL_AGGREGATE_THREADS, true);
     register_stage<hash_aggregate_stage_t>(MAX_NUM_AGGREGATE_THREADS, true);
@@ -62,6 +70,7 @@ void register_stage_containers()
     register_stage<sorted_in_stage_t>(MAX_NUM_SORTED_IN_STAGE_THREADS, true);
     register_stage<echo_stage_t>(MAX_NUM_CLIENTS, true);
     register_stage<sieve_stage_t>(MAX_NUM_CLIENTS, true);
+    register_stage<rscan_stage_t>(MAX_NUM_RSCAN_THREADS, false);
 }
 
 EXIT_NAMESPACE(qpipe);
@@ -0,0 +1,67 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   rscan.cpp
+ *
+ *  @brief:  Implementation of the QPipe result scan stage
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "qpipe/stages/rscan.h"
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+const c_str rscan_packet_t::PACKET_TYPE = "RSCAN";
+
+const c_str rscan_stage_t::DEFAULT_STAGE_NAME = "RSCAN_STAGE";
+
+
+
+/******************************************************************
+ * 
+ * @fn:     process_packet
+ *
+ * @brief:  Outputs the pages of the cached result. The pages are
+ *          shared with the cache and the other result scans, the
+ *          adaptor only reads them.
+ *
+ ******************************************************************/
+
+void rscan_stage_t::process_packet() 
+{
+    adaptor_t* adaptor = _adaptor;
+    rscan_packet_t* packet = (rscan_packet_t*)adaptor->get_packet();
+
+    page_list& pages = packet->_entry->_pages;
+    for (page_list::iterator it = pages.begin(); it != pages.end(); ++it) {
+        if (adaptor->check_for_cancellation())
+            return;
+        adaptor->output(*it);
+    }
+}
+
+
+EXIT_NAMESPACE(qpipe);
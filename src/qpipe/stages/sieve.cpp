@@ -51,14 +51,15 @@ void sieve_stage_t::process_packet() {
     tuple_t dest(dest_data, dest_size);
 
 
-    while (1) {
-
-        tuple_t src;
-        if (!input_buffer->get_tuple(src))
-            break;
-
-        if (sieve->pass(dest, src))
-            adaptor->output(dest);
+    // read the input a span of tuples at a time
+    page::iterator it, end;
+    while (input_buffer->get_tuples(it, end)) {
+
+        while (it != end) {
+            tuple_t src = it.advance();
+            if (sieve->pass(dest, src))
+                adaptor->output(dest);
+        }
     }
 
     if (sieve->flush(dest))
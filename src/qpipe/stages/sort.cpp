@@ -507,10 +507,13 @@ void sort_stage_t::process_packet() {
         THROW1(QPipeException, "Merge failed. Terminating Sort");
     
 
-    // transfer the output of the last merge to the stage output
-    tuple_t out;
-    while (merge_output->get_tuple(out))
-        _adaptor->output(out);
+    // transfer the output of the last merge to the stage output, a
+    // span of tuples at a time
+    qpipe::page::iterator it, end;
+    while (merge_output->get_tuples(it, end)) {
+        while (it != end)
+            _adaptor->output(it.advance());
+    }
     
 }
 
@@ -71,12 +71,32 @@ tscan_packet_t::tscan_packet_t(const c_str&    packet_id,
     assert(_xct);
 }
 
+tscan_packet_t::tscan_packet_t(const c_str&    packet_id,
+                               const c_str&    packet_type,
+                               tuple_fifo*     output_buffer,
+                               tuple_filter_t* output_filter,
+                               ss_m*           db,
+                               table_desc_t*   table,
+                               xct_t*          pxct,
+                               lock_mode_t     lm)
+    : packet_t(packet_id, packet_type, output_buffer, output_filter,
+               create_plan(output_filter, table),
+               true, /* merging allowed */
+               true  /* unreserve worker on completion */
+               ),
+      _db(db), _table(table), _xct(pxct), _lm(lm)
+{
+    assert(_db);
+    assert(_table);
+}
+
 
 query_plan* tscan_packet_t::create_plan(tuple_filter_t* filter, 
                                         table_desc_t* table) 
 {
     c_str action("%s:%s", PACKET_TYPE.data(), table->name());
-    return new query_plan(action, filter->to_string(), NULL, 0);
+    return new query_plan(action, filter->to_string(), NULL, 0,
+                          table->version_ptr());
 }
     
 void tscan_packet_t::declare_worker_needs(resource_declare_t* declare) 
@@ -271,6 +271,7 @@ void asc_sort_man_impl::sort()
     case SQL_SMALLINT:
         qsort(_sort_buf, _tuple_count, _tuple_size, compare_smallint_asc); break;
     case SQL_INT:
+    case SQL_DATE:
         qsort(_sort_buf, _tuple_count, _tuple_size, compare_int_asc); break;
     case SQL_LONG:
             qsort(_sort_buf, _tuple_count, _tuple_size, compare_long_asc); break;
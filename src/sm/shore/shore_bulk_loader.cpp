@@ -0,0 +1,743 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_bulk_loader.cpp
+ *
+ *  @brief:  Implementation of the bulk-load mode
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include <algorithm>
+#include <queue>
+#include <unistd.h>
+
+#include "sm/shore/shore_bulk_loader.h"
+
+using namespace shore;
+
+
+ENTER_NAMESPACE(shore);
+
+
+std::vector<bulk_loader_t*> bulk_loader_t::_loaders;
+bool        bulk_loader_t::_active = false;
+uint_t      bulk_loader_t::_gen = 0;
+stopwatch_t bulk_loader_t::_timer;
+std::string bulk_loader_t::_dir;
+uint_t      bulk_loader_t::_run_bytes = BULK_RUN_MB<<20;
+
+
+// The runs of the calling loader thread, valid if taken at the current _gen
+static __thread std::vector<bulk_loader_t::thread_runs_t*>* thr_runs = NULL;
+static __thread uint_t thr_gen = 0;
+
+// Unique names for the spilled runs
+static volatile uint_t spill_seq = 0;
+
+
+
+/******************************************************************
+ *
+ *  @class: run_reader_t
+ *
+ *  @brief: Iterates over the sorted entries of a run, either spilled
+ *          to a file or still in memory
+ *
+ ******************************************************************/
+
+class run_reader_t
+{
+private:
+    const bulk_loader_t::bulk_idx_t* _pbi;
+
+    // spilled run
+    FILE*  _fp;
+    char*  _buf;
+    uint_t _cnt;
+    uint_t _pos;
+
+    // in-memory run
+    std::vector<char*> _sorted;
+    bool   _inmem;
+
+public:
+
+    run_reader_t(const bulk_loader_t::bulk_idx_t* pbi, const char* fname)
+        : _pbi(pbi), _fp(NULL), _buf(NULL), _cnt(0), _pos(0), _inmem(false)
+    {
+        _fp = fopen(fname, "r");
+        if (!_fp) {
+            TRACE( TRACE_ALWAYS, "Cannot open run (%s)\n", fname);
+        }
+        _buf = (char*)malloc(BULK_READ_CNT*_pbi->_esz);
+        assert (_buf);
+    }
+
+    run_reader_t(const bulk_loader_t::bulk_idx_t* pbi,
+                 bulk_loader_t::run_t* prun)
+        : _pbi(pbi), _fp(NULL), _buf(NULL), _cnt(0), _pos(0), _inmem(true)
+    {
+        prun->sort(_sorted);
+        _cnt = _sorted.size();
+    }
+
+    ~run_reader_t()
+    {
+        if (_fp) fclose(_fp);
+        if (_buf) free(_buf);
+    }
+
+    // Returns the next entry, or NULL at the end of the run
+    const char* next()
+    {
+        if (_inmem) {
+            return (_pos<_cnt ? _sorted[_pos++] : NULL);
+        }
+        if (_pos==_cnt) {
+            if (!_fp) return (NULL);
+            _cnt = fread(_buf, _pbi->_esz, BULK_READ_CNT, _fp);
+            _pos = 0;
+            if (_cnt==0) return (NULL);
+        }
+        return (_buf + (_pos++)*_pbi->_esz);
+    }
+
+}; // EOF: run_reader_t
+
+
+
+/******************************************************************
+ *
+ *  @class: bulk_builder_t
+ *
+ *  @brief: Thread that builds indexes, out of a common list of jobs
+ *
+ ******************************************************************/
+
+typedef std::pair<bulk_loader_t*, bulk_loader_t::bulk_idx_t*> bulk_job_t;
+
+static std::vector<bulk_job_t> bulk_jobs;
+static volatile uint_t bulk_next_job = 0;
+
+class bulk_builder_t : public thread_t
+{
+private:
+    ss_m* _db;
+    int   _err;
+public:
+    bulk_builder_t(ss_m* db, const int id)
+        : thread_t(c_str("BLD-%d",id)), _db(db), _err(0) { }
+    virtual void work();
+    int err() const { return (_err); }
+};
+
+void bulk_builder_t::work()
+{
+    for (;;) {
+        uint_t ijob = atomic_inc_uint_nv(&bulk_next_job) - 1;
+        if (ijob >= bulk_jobs.size()) break;
+
+        bulk_job_t& job = bulk_jobs[ijob];
+        w_rc_t e = job.first->build_index(_db, job.second);
+        if (e.is_error()) {
+            TRACE( TRACE_ALWAYS, "Building (%s) failed (%x)\n",
+                   job.second->_pidx->name(), e.err_num());
+            _err = e.err_num();
+        }
+    }
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    cmp_entry
+ *
+ *  @brief: Compares two entries by partition, then by key, then by rid.
+ *          Each key part is compared according to its key description:
+ *          "i" parts as signed integers, "f" parts as floating point
+ *          (also SQL_LONG, whose key description is "f8"), and "b"
+ *          parts byte by byte.
+ *
+ ******************************************************************/
+
+template <class T>
+static inline int _cmp_val(const char* a, const char* b)
+{
+    T x, y;
+    memcpy(&x, a, sizeof(T));
+    memcpy(&y, b, sizeof(T));
+    return ((x<y) ? -1 : ((y<x) ? 1 : 0));
+}
+
+int bulk_loader_t::cmp_entry(const bulk_idx_t* pbi, const char* a, const char* b)
+{
+    int c = _cmp_val<int>(a,b);
+    if (c) return (c);
+
+    a += sizeof(int);
+    b += sizeof(int);
+
+    for (uint_t i=0; i<pbi->_parts.size(); ++i) {
+        const kpart_t& kp = pbi->_parts[i];
+        const char* x = a + kp._off;
+        const char* y = b + kp._off;
+
+        switch (kp._type) {
+        case SQL_BIT:
+        case SQL_SMALLINT:
+        case SQL_CHAR:
+        case SQL_INT:
+        case SQL_DATE:
+            switch (kp._sz) {
+            case 1: c = _cmp_val<int8_t>(x,y); break;
+            case 2: c = _cmp_val<int16_t>(x,y); break;
+            case 8: c = _cmp_val<int64_t>(x,y); break;
+            default: c = _cmp_val<int32_t>(x,y); break;
+            }
+            break;
+
+        case SQL_FLOAT:
+        case SQL_LONG:
+            if (kp._sz==sizeof(float)) c = _cmp_val<float>(x,y);
+            else c = _cmp_val<double>(x,y);
+            break;
+
+        default:
+            c = memcmp(x,y,kp._sz);
+            break;
+        }
+        if (c) return (c);
+    }
+    return (memcmp(a+pbi->_keysz, b+pbi->_keysz, sizeof(rid_t)));
+}
+
+
+
+/******************************************************************
+ *
+ *  @struct: run_t
+ *
+ ******************************************************************/
+
+bulk_loader_t::run_t::run_t(bulk_idx_t* pbi)
+    : _pbi(pbi), _buf(NULL), _cnt(0), _cap(1024), _mark(0)
+{
+    _buf = (char*)malloc(_cap*_pbi->_esz);
+    assert (_buf);
+}
+
+bulk_loader_t::run_t::~run_t()
+{
+    if (_buf) free (_buf);
+    for (uint_t i=0; i<_files.size(); ++i) {
+        unlink(_files[i].c_str());
+    }
+}
+
+char* bulk_loader_t::run_t::append()
+{
+    if (_cnt == _cap) {
+        _cap <<= 1;
+        _buf = (char*)realloc(_buf, _cap*_pbi->_esz);
+        assert (_buf);
+    }
+    return (_buf + (_cnt++)*_pbi->_esz);
+}
+
+void bulk_loader_t::run_t::sort(std::vector<char*>& sorted)
+{
+    sorted.resize(_cnt);
+    for (uint_t i=0; i<_cnt; ++i) {
+        sorted[i] = _buf + i*_pbi->_esz;
+    }
+    std::sort(sorted.begin(), sorted.end(), entry_less(_pbi));
+}
+
+w_rc_t bulk_loader_t::run_t::spill(const char* dir)
+{
+    if (_cnt==0) return (RCOK);
+
+    std::vector<char*> sorted;
+    sort(sorted);
+
+    c_str fname("%s/shore-bulk-%d-%d.run", dir, getpid(),
+                atomic_inc_uint_nv(&spill_seq));
+    FILE* fp = fopen(fname.data(), "w");
+    if (!fp) {
+        TRACE( TRACE_ALWAYS, "Cannot create run (%s)\n", fname.data());
+        return (RC(se_ERROR_IN_IDX_LOAD));
+    }
+    for (uint_t i=0; i<_cnt; ++i) {
+        if (fwrite(sorted[i], _pbi->_esz, 1, fp) != 1) {
+            fclose(fp);
+            unlink(fname.data());
+            return (RC(se_ERROR_IN_IDX_LOAD));
+        }
+    }
+    fclose(fp);
+    _files.push_back(std::string(fname.data()));
+
+    _cnt = 0;
+    _mark = 0;
+    return (RCOK);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    Construction/destruction
+ *
+ *  @brief: Sets up the entry layout and the key parts of each index
+ *
+ ******************************************************************/
+
+bulk_loader_t::bulk_loader_t(table_man_t* pman)
+    : _pman(pman), _rows(0), _load_secs(0)
+{
+    assert (_pman);
+    table_desc_t* ptable = _pman->table();
+
+    for (index_desc_t* pidx = ptable->indexes(); pidx; pidx = pidx->next()) {
+        bulk_idx_t* pbi = new bulk_idx_t;
+        pbi->_pidx = pidx;
+        pbi->_pos = _idxs.size();
+        pbi->_keysz = ptable->index_maxkeysize(pidx);
+        pbi->_esz = sizeof(int) + pbi->_keysz + pidx->el_size();
+        pbi->_build_secs = 0;
+
+        uint_t off = 0;
+        for (uint_t i=0; i<pidx->field_count(); ++i) {
+            field_desc_t* pfd = ptable->desc(pidx->key_index(i));
+            kpart_t kp;
+            kp._type = pfd->type();
+            kp._off = off;
+            kp._sz = pfd->fieldmaxsize();
+            pbi->_parts.push_back(kp);
+            off += kp._sz;
+        }
+        assert (off == pbi->_keysz);
+
+        _idxs.push_back(pbi);
+    }
+}
+
+bulk_loader_t::~bulk_loader_t()
+{
+    for (uint_t i=0; i<_truns.size(); ++i) {
+        for (uint_t j=0; j<_truns[i]->_runs.size(); ++j) {
+            delete (_truns[i]->_runs[j]);
+        }
+        delete (_truns[i]);
+    }
+    for (uint_t i=0; i<_idxs.size(); ++i) {
+        delete (_idxs[i]);
+    }
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    _my_runs()
+ *
+ *  @brief: Returns the runs of the calling thread for this table,
+ *          creating them at the first row the thread loads
+ *
+ ******************************************************************/
+
+bulk_loader_t::thread_runs_t* bulk_loader_t::_my_runs()
+{
+    if (thr_gen != _gen) {
+        if (!thr_runs) thr_runs = new std::vector<thread_runs_t*>;
+        thr_runs->clear();
+        thr_gen = _gen;
+    }
+
+    for (uint_t i=0; i<thr_runs->size(); ++i) {
+        if ((*thr_runs)[i]->_owner == this) return ((*thr_runs)[i]);
+    }
+
+    thread_runs_t* ptr = new thread_runs_t;
+    ptr->_owner = this;
+    ptr->_rows = 0;
+    ptr->_rows_mark = 0;
+    for (uint_t i=0; i<_idxs.size(); ++i) {
+        ptr->_runs.push_back(new run_t(_idxs[i]));
+    }
+
+    {
+        CRITICAL_SECTION(runs_cs, _runs_lock);
+        _truns.push_back(ptr);
+    }
+    thr_runs->push_back(ptr);
+    return (ptr);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    add_entries()
+ *
+ *  @brief: Appends the (key,element) entry of the just inserted record
+ *          to the run of each index
+ *
+ ******************************************************************/
+
+w_rc_t bulk_loader_t::add_entries(table_row_t* ptuple)
+{
+    assert (ptuple);
+    assert (ptuple->_rep);
+
+    thread_runs_t* ptr = _my_runs();
+
+    for (uint_t i=0; i<_idxs.size(); ++i) {
+        bulk_idx_t* pbi = _idxs[i];
+        int ksz = _pman->format_key(pbi->_pidx, ptuple, *ptuple->_rep);
+        assert (ksz == (int)pbi->_keysz);
+        int pnum = _pman->get_pnum(pbi->_pidx, ptuple);
+
+        char* pe = ptr->_runs[i]->append();
+        memcpy(pe, &pnum, sizeof(int));
+        memcpy(pe+sizeof(int), ptuple->_rep->_dest, ksz);
+        _pman->format_el(pbi->_pidx, ptuple, pe+sizeof(int)+ksz);
+    }
+    ++ptr->_rows;
+    return (RCOK);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    build_index()
+ *
+ *  @brief: Merges all the runs of the index. A regular index is built
+ *          bottom-up, one partition at a time, out of a temporary
+ *          (not logged) file with the merged entries. A MRBT is filled
+ *          in key order, BULK_MR_BATCH entries per xct.
+ *
+ ******************************************************************/
+
+struct heap_entry_t {
+    const char* _e;
+    uint_t      _ir;
+};
+
+struct heap_greater {
+    const bulk_loader_t::bulk_idx_t* _pbi;
+    heap_greater(const bulk_loader_t::bulk_idx_t* pbi) : _pbi(pbi) { }
+    bool operator()(const heap_entry_t& a, const heap_entry_t& b) const {
+        return (bulk_loader_t::cmp_entry(_pbi, a._e, b._e) > 0);
+    }
+};
+
+w_rc_t bulk_loader_t::build_index(ss_m* db, bulk_idx_t* pbi)
+{
+    assert (db);
+    assert (pbi);
+    stopwatch_t timer;
+    index_desc_t* pidx = pbi->_pidx;
+
+    // 1. Open all the runs of the index
+    std::vector<run_reader_t*> readers;
+    for (uint_t i=0; i<_truns.size(); ++i) {
+        run_t* prun = _truns[i]->_runs[pbi->_pos];
+        for (uint_t j=0; j<prun->_files.size(); ++j) {
+            readers.push_back(new run_reader_t(pbi, prun->_files[j].c_str()));
+        }
+        if (prun->_cnt) {
+            readers.push_back(new run_reader_t(pbi, prun));
+        }
+    }
+
+    std::priority_queue<heap_entry_t, std::vector<heap_entry_t>, heap_greater>
+        heads((heap_greater(pbi)));
+    for (uint_t i=0; i<readers.size(); ++i) {
+        heap_entry_t he = { readers[i]->next(), i };
+        if (he._e) heads.push(he);
+    }
+
+    // 2. Merge
+    w_rc_t e = RCOK;
+    uint64_t entries = 0;
+    int curp = -1;
+    stid_t src;
+    ss_m::RELOCATE_RECORD_CALLBACK_FUNC reloc_func = &table_man_t::relocate_records;
+
+    e = db->begin_xct();
+    while (!e.is_error() && !heads.empty()) {
+        heap_entry_t he = heads.top();
+        heads.pop();
+
+        int pnum;
+        rid_t rid;
+        memcpy(&pnum, he._e, sizeof(int));
+        const char* key = he._e + sizeof(int);
+        memcpy(&rid, key + pbi->_keysz, sizeof(rid_t));
+
+        if (pidx->is_mr()) {
+            el_filler ef;
+            ef._el.put(vec_t(&rid, sizeof(rid_t)));
+            e = db->create_mr_assoc(pidx->fid(pnum),
+                                    vec_t(key, pbi->_keysz),
+                                    ef, true, pidx->is_latchless(),
+                                    reloc_func, lpid_t::null);
+            if (!e.is_error() && ((entries+1) % BULK_MR_BATCH == 0)) {
+                e = db->commit_xct();
+                if (!e.is_error()) e = db->begin_xct();
+            }
+        }
+        else {
+            // a new partition starts, load the previous one
+            if (pnum != curp) {
+                if (curp >= 0) e = _bulkld_part(db, pbi, curp, src);
+                if (!e.is_error()) {
+                    e = db->create_file(_pman->table()->vid(), src,
+                                        ss_m::t_temporary);
+                }
+                curp = pnum;
+            }
+            if (!e.is_error()) {
+                rid_t trid;
+                e = db->create_rec(src, vec_t(key, pbi->_keysz),
+                                   pidx->el_size(),
+                                   vec_t(key + pbi->_keysz, pidx->el_size()),
+                                   trid);
+            }
+        }
+        ++entries;
+
+        he._e = readers[he._ir]->next();
+        if (he._e) heads.push(he);
+    }
+
+    if (!e.is_error() && (curp >= 0)) e = _bulkld_part(db, pbi, curp, src);
+    if (!e.is_error()) e = db->commit_xct();
+    if (e.is_error()) W_IGNORE(db->abort_xct());
+
+    for (uint_t i=0; i<readers.size(); ++i) {
+        delete (readers[i]);
+    }
+
+    pbi->_build_secs = timer.time();
+    TRACE( TRACE_STATISTICS, "Index (%s) entries (%lld) built in (%.1f) secs\n",
+           pidx->name(), entries, pbi->_build_secs);
+    return (e);
+}
+
+
+w_rc_t bulk_loader_t::_bulkld_part(ss_m* db, bulk_idx_t* pbi, const int pnum,
+                                   const stid_t& src)
+{
+    sm_du_stats_t stats;
+    W_DO(db->bulkld_index(pbi->_pidx->fid(pnum), 1, &src, stats,
+                          !pbi->_pidx->is_unique(), true));
+    W_DO(db->destroy_file(src));
+    return (RCOK);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    is_enabled()/begin()
+ *
+ *  @brief: Switches the heap files to insert-only and the table
+ *          managers to bulk mode. The PLP tables whose records live
+ *          in the leaves of the primary index are loaded as usual.
+ *
+ ******************************************************************/
+
+bool bulk_loader_t::is_enabled()
+{
+    return (envVar::instance()->getVarInt("db-bulkload",0) == 1);
+}
+
+w_rc_t bulk_loader_t::begin(ss_m* db, const std::vector<table_man_t*>& tables)
+{
+    assert (db);
+    if (_active) return (RCOK);
+
+    _dir = envVar::instance()->getVar("db-bulkload-dir","/tmp");
+    _run_bytes = envVar::instance()->getVarInt("db-bulkload-runsize",
+                                               BULK_RUN_MB) << 20;
+
+    W_DO(db->begin_xct());
+    for (uint_t i=0; i<tables.size(); ++i) {
+        table_desc_t* ptable = tables[i]->table();
+        if ((ptable->get_pd() & (PD_MRBT_PART | PD_MRBT_LEAF)) &&
+            ptable->primary_idx() && ptable->primary_idx()->is_latchless()) {
+            continue;
+        }
+        W_DO(db->set_store_property(ptable->fid(), ss_m::t_insert_file));
+        _loaders.push_back(new bulk_loader_t(tables[i]));
+    }
+    W_DO(db->commit_xct());
+
+    ++_gen;
+    _active = true;
+    for (uint_t i=0; i<_loaders.size(); ++i) {
+        _loaders[i]->manager()->set_bulk_loader(_loaders[i]);
+    }
+    _timer.reset();
+
+    TRACE( TRACE_ALWAYS, "Bulk loading (%d) tables. Runs of (%d) MB in (%s)\n",
+           _loaders.size(), (_run_bytes>>20), _dir.c_str());
+    return (RCOK);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    finish()
+ *
+ *  @brief: Called after all the loaders have finished. Builds the
+ *          indexes in parallel, makes the heap files regular again,
+ *          and reports the load rate of each table.
+ *
+ ******************************************************************/
+
+w_rc_t bulk_loader_t::finish(ss_m* db, const int threads)
+{
+    assert (db);
+    if (!_active) return (RCOK);
+
+    double load_secs = _timer.time();
+
+    // 1. Stop collecting entries
+    for (uint_t i=0; i<_loaders.size(); ++i) {
+        bulk_loader_t* pbl = _loaders[i];
+        pbl->manager()->set_bulk_loader(NULL);
+        pbl->_load_secs = load_secs;
+        pbl->_rows = 0;
+        for (uint_t j=0; j<pbl->_truns.size(); ++j) {
+            pbl->_rows += pbl->_truns[j]->_rows;
+        }
+    }
+    _active = false;
+
+    // 2. Build the indexes
+    bulk_jobs.clear();
+    bulk_next_job = 0;
+    for (uint_t i=0; i<_loaders.size(); ++i) {
+        for (uint_t j=0; j<_loaders[i]->_idxs.size(); ++j) {
+            bulk_jobs.push_back(bulk_job_t(_loaders[i], _loaders[i]->_idxs[j]));
+        }
+    }
+
+    int nbuilders = std::min((int)bulk_jobs.size(), std::max(threads,1));
+    TRACE( TRACE_ALWAYS, "Building (%d) indexes with (%d) threads\n",
+           bulk_jobs.size(), nbuilders);
+
+    int err = 0;
+    {
+        array_guard_t< guard<bulk_builder_t> > builders(new guard<bulk_builder_t>[nbuilders]);
+        for (int i=0; i<nbuilders; i++) {
+            builders[i] = new bulk_builder_t(db, i);
+            builders[i]->fork();
+        }
+        for (int i=0; i<nbuilders; i++) {
+            builders[i]->join();
+            if (builders[i]->err()) err = builders[i]->err();
+        }
+    }
+
+    // 3. Make the heap files regular and durable
+    W_DO(db->begin_xct());
+    for (uint_t i=0; i<_loaders.size(); ++i) {
+        W_DO(db->set_store_property(_loaders[i]->manager()->table()->fid(),
+                                    ss_m::t_regular));
+    }
+    W_DO(db->commit_xct());
+    W_DO(db->force_buffers());
+
+    // 4. Report
+    for (uint_t i=0; i<_loaders.size(); ++i) {
+        bulk_loader_t* pbl = _loaders[i];
+        double build_secs = 0;
+        for (uint_t j=0; j<pbl->_idxs.size(); ++j) {
+            build_secs += pbl->_idxs[j]->_build_secs;
+        }
+        TRACE( TRACE_STATISTICS,
+               "Bulk (%s) rows (%lld) rows/s (%.0f) index build (%.1f) secs\n",
+               pbl->manager()->table()->name(), pbl->_rows,
+               (load_secs>0 ? (double)pbl->_rows/load_secs : 0.0),
+               build_secs);
+        delete (pbl);
+    }
+    _loaders.clear();
+    bulk_jobs.clear();
+
+    if (err) return (RC(se_ERROR_IN_IDX_LOAD));
+    return (RCOK);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    mark_runs()/rollback_runs()
+ *
+ *  @brief: Called by the loader threads around each xct. A mark is taken
+ *          after a successful xct, and then full runs are spilled. On a
+ *          retry the entries appended after the last mark are dropped.
+ *
+ ******************************************************************/
+
+void bulk_loader_t::mark_runs()
+{
+    if (!_active || !thr_runs || (thr_gen != _gen)) return;
+
+    for (uint_t i=0; i<thr_runs->size(); ++i) {
+        thread_runs_t* ptr = (*thr_runs)[i];
+        ptr->_rows_mark = ptr->_rows;
+        for (uint_t j=0; j<ptr->_runs.size(); ++j) {
+            run_t* prun = ptr->_runs[j];
+            if (prun->_cnt*prun->_pbi->_esz >= _run_bytes) {
+                W_COERCE(prun->spill(_dir.c_str()));
+            }
+            prun->_mark = prun->_cnt;
+        }
+    }
+}
+
+void bulk_loader_t::rollback_runs()
+{
+    if (!_active || !thr_runs || (thr_gen != _gen)) return;
+
+    for (uint_t i=0; i<thr_runs->size(); ++i) {
+        thread_runs_t* ptr = (*thr_runs)[i];
+        ptr->_rows = ptr->_rows_mark;
+        for (uint_t j=0; j<ptr->_runs.size(); ++j) {
+            ptr->_runs[j]->_cnt = ptr->_runs[j]->_mark;
+        }
+    }
+}
+
+
+EXIT_NAMESPACE(shore);
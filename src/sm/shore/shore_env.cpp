@@ -34,6 +34,12 @@
 #include "sm/shore/shore_trx_worker.h"
 #include "sm/shore/shore_flusher.h"
 #include "sm/shore/shore_helper_loader.h"
+#include "sm/shore/shore_warmup.h"
+#include "sm/shore/shore_log_profile.h"
+
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 ENTER_NAMESPACE(shore);
@@ -99,6 +105,7 @@ ShoreEnv::ShoreEnv()
       _insert_freq(0),_delete_freq(0),_probe_freq(100),
       _request_pool(sizeof(trx_request_t)),
       _bUseSLI(false),_bUseELR(false),_bUseFlusher(false),
+      _durable_cb(NULL), _durable_cb_arg(NULL), _commit_mode(CM_SYNCH),
       _bAlarmSet(false), _start_imbalance(0), _skew_type(SKEW_NONE)
 {
     _popts = new option_group_t(1);
@@ -500,10 +507,29 @@ int ShoreEnv::start()
     // read from env params the loopcnt
     int lc = envVar::instance()->getVarInt("db-worker-queueloops",0);    
 
+    // the log insertion features of the SM, e.g. the consolidation array
+    string logfeatures = envVar::instance()->getVar("db-log-features","");
+    if (!logfeatures.empty()) {
+        w_rc_t e = _pssm->set_log_features(logfeatures.c_str());
+        if (e.is_error()) {
+            TRACE( TRACE_ALWAYS, "Invalid log features (%s)\n", logfeatures.c_str());
+        }
+        else {
+            char const* enabled = _pssm->get_log_features();
+            TRACE( TRACE_ALWAYS, "Log features: %s\n", enabled);
+            delete[] enabled;
+        }
+    }
+
+    // the log volume per xct type and per table operation
+    log_profile_t::init();
+
 #ifdef CFG_FLUSHER
     _start_flusher();
 #endif
 
+    if (isDurableNotify() && !_durable_notifier) _start_durable_notifier();
+
     WorkerPtr aworker;
     for (uint i=0; i<_worker_cnt; i++) {
         aworker = new Worker(this,c_str("work-%d", i),PBIND_NONE,_bUseSLI);
@@ -512,6 +538,8 @@ int ShoreEnv::start()
         aworker->start();
         aworker->fork();
     }
+
+    set_dbc(DBC_ACTIVE);
     return (0);
 }
 
@@ -565,6 +593,8 @@ int ShoreEnv::stop()
     _stop_flusher();
 #endif
 
+    _stop_durable_notifier();
+
     // Set the stoped flag
     set_dbc(DBC_STOPPED);
 
@@ -626,6 +656,11 @@ int ShoreEnv::statistics()
     if (_base_flusher) _base_flusher->statistics();
 #endif    
 
+    if (_durable_notifier) _durable_notifier->statistics();
+
+    // Hit rate of the record caches, if any
+    table_man_t::print_rec_cache_stats();
+
     // If reached this point the Shore environment is closed
     //gatherstats_sm();
     return (0);
@@ -943,6 +978,270 @@ int ShoreEnv::checkpoint()
 
 
 
+/********************************************************************* 
+ *
+ *  @fn:      warmup_bufpool()
+ *
+ *  @brief:   Reads the indexes and the heap files of all the registered
+ *            tables to the buffer pool with db-warmup-threads threads,
+ *            until they are all read or the buffer pool is full
+ *
+ *********************************************************************/
+
+w_rc_t ShoreEnv::warmup_bufpool() 
+{    
+    assert (_pssm);
+    int threads = envVar::instance()->getVarInt("db-warmup-threads",WARMUP_THREADS);
+    warmup_t warmer(_pssm);
+    warmer.add_registered_tables();
+    return (warmer.run(threads>0 ? threads : 1));
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:      snapshot()/restore()
+ *
+ *  @brief:   Take a snapshot of the loaded database, or restore the
+ *            database from a snapshot. Since they call the SM, the work
+ *            is done by a db_snapshot_smt_t thread.
+ *
+ *  @note:    Used for starting back-to-back measurements from the
+ *            same database state without reloading
+ *
+ *********************************************************************/
+
+int ShoreEnv::snapshot(const char* name) 
+{    
+    assert (name);
+    db_snapshot_smt_t* snapper = 
+        new db_snapshot_smt_t(c_str("snapshot"), this, name, false);
+    assert (snapper);
+    snapper->fork();
+    snapper->join(); 
+    int rv = snapper->rv();
+    delete (snapper);
+    snapper = NULL;
+    return (rv);
+}
+
+int ShoreEnv::restore(const char* name) 
+{    
+    assert (name);
+    db_snapshot_smt_t* restorer = 
+        new db_snapshot_smt_t(c_str("restore"), this, name, true);
+    assert (restorer);
+    restorer->fork();
+    restorer->join(); 
+    int rv = restorer->rv();
+    delete (restorer);
+    restorer = NULL;
+    return (rv);
+}
+
+
+// Snapshots are kept under db-snapshot-dir
+static string _snapshot_basedir()
+{
+    return (envVar::instance()->getVar("db-snapshot-dir","snapshots"));
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:      snapshot_impl()
+ *
+ *  @brief:   Forces the dirty pages, takes a checkpoint and copies the 
+ *            device and the log files to db-snapshot-dir/<name>/{db,log}
+ *
+ *  @note:    The copies are reflinks if the filesystem supports them
+ *            (so the snapshot is almost free), otherwise they are sparse
+ *            copies done by db-snapshot-threads threads. There should be
+ *            no active xcts, so that the copied volume is consistent.
+ *
+ *********************************************************************/
+
+int ShoreEnv::snapshot_impl(const char* name) 
+{    
+    CRITICAL_SECTION(cs, _init_mutex);
+    if (!_initialized || !_loaded) {
+        TRACE( TRACE_ALWAYS, "Database not loaded. Cannot take snapshot...\n");
+        return (1);
+    }
+
+    int activexcts = ss_m::num_active_xcts();
+    if (activexcts) {
+        TRACE( TRACE_ALWAYS, "(%d) active xcts. Cannot take snapshot...\n",
+               activexcts);
+        return (2);
+    }
+
+    string basedir = _snapshot_basedir();
+    string dir = basedir + "/" + name;
+    if (((mkdir(basedir.c_str(), 0755) != 0) && (errno != EEXIST)) ||
+        ((mkdir(dir.c_str(), 0755) != 0) && (errno != EEXIST))) {
+        TRACE( TRACE_ALWAYS, "Cannot create (%s)\n", dir.c_str());
+        return (3);
+    }
+
+    int threads = envVar::instance()->getVarInt("db-snapshot-threads",8);
+    string device = _dev_opts[SHORE_DB_OPTIONS[0][0]];
+    string logdir = _sm_opts[SHORE_DB_SM_OPTIONS[1][0]];
+    string snaplog = dir + "/log";
+
+    TRACE( TRACE_ALWAYS, "Taking snapshot (%s)...\n", dir.c_str());
+    stopwatch_t timer;
+
+    // After the checkpoint the volume is clean and the restart
+    // from the copied log has nothing to redo
+    w_rc_t e = ss_m::force_buffers();
+    if (!e.is_error()) e = ss_m::checkpoint();
+    if (e.is_error()) {
+        TRACE( TRACE_ALWAYS, "Checkpoint failed [0x%x]\n", e.err_num());
+        return (4);
+    }
+
+    fcopy_clear_dir(snaplog.c_str());
+    if (fcopy_file(device.c_str(), (dir + "/db").c_str(), threads) ||
+        fcopy_dir(logdir.c_str(), snaplog.c_str(), threads)) {
+        TRACE( TRACE_ALWAYS, "Error copying to (%s)\n", dir.c_str());
+        return (5);
+    }
+
+    TRACE( TRACE_ALWAYS, "Snapshot (%s) taken in (%.1f) secs\n", 
+           name, timer.time());
+    return (0);
+}
+
+
+// Moves the copies of the device and the log over the live ones. The
+// log directory is swapped first and moved back if the device cannot
+// be renamed, so on failure the live device and log are untouched.
+static int _restore_swap(const string& device, const string& tmpdev,
+                         const string& logdir, const string& tmplog)
+{
+    string oldlog = logdir + ".restore-old";
+    fcopy_remove_dir(oldlog.c_str());
+    if (rename(logdir.c_str(), oldlog.c_str()) != 0) return (1);
+    if (rename(tmplog.c_str(), logdir.c_str()) != 0) {
+        rename(oldlog.c_str(), logdir.c_str());
+        return (2);
+    }
+    if (rename(tmpdev.c_str(), device.c_str()) != 0) {
+        rename(logdir.c_str(), tmplog.c_str());
+        rename(oldlog.c_str(), logdir.c_str());
+        return (3);
+    }
+    fcopy_remove_dir(oldlog.c_str());
+    return (0);
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:      restore_impl()
+ *
+ *  @brief:   Restores the device and the log from db-snapshot-dir/<name>
+ *
+ *  @note:    - Copies the snapshot next to the live device and log, which
+ *              are not touched if the copy fails
+ *            - Stops the workers (and the DORA partitions)
+ *            - Closes the SM and renames the copies over the device and
+ *              the log
+ *            - Restarts the SM on the restored device (without clobbering)
+ *              and reloads the fids. If the renames failed, the SM is
+ *              restarted on the old device.
+ *            - Invalidates the record caches and resets the stats
+ *            - Starts again, which regenerates the DORA partitions
+ *
+ *********************************************************************/
+
+int ShoreEnv::restore_impl(const char* name) 
+{    
+    string dir = _snapshot_basedir() + "/" + name;
+    string snapdb = dir + "/db";
+    string snaplog = dir + "/log";
+    struct stat st;
+    if ((stat(snapdb.c_str(), &st) != 0) || (stat(snaplog.c_str(), &st) != 0)) {
+        TRACE( TRACE_ALWAYS, "No snapshot (%s)\n", dir.c_str());
+        return (1);
+    }
+
+    int threads = envVar::instance()->getVarInt("db-snapshot-threads",8);
+    string device = _dev_opts[SHORE_DB_OPTIONS[0][0]];
+    string logdir = _sm_opts[SHORE_DB_SM_OPTIONS[1][0]];
+    while ((logdir.size() > 1) && (logdir[logdir.size()-1] == '/'))
+        logdir.erase(logdir.size()-1);
+    string tmpdev = device + ".restore-tmp";
+    string tmplog = logdir + ".restore-tmp";
+
+    TRACE( TRACE_ALWAYS, "Restoring snapshot (%s)...\n", dir.c_str());
+    stopwatch_t timer;
+
+    unlink(tmpdev.c_str());
+    fcopy_remove_dir(tmplog.c_str());
+    if (fcopy_dir(snaplog.c_str(), tmplog.c_str(), threads) ||
+        fcopy_file(snapdb.c_str(), tmpdev.c_str(), threads)) {
+        TRACE( TRACE_ALWAYS, "Error copying from (%s)\n", dir.c_str());
+        unlink(tmpdev.c_str());
+        fcopy_remove_dir(tmplog.c_str());
+        return (4);
+    }
+
+    if (stop()) return (2);
+
+    int rv = 0;
+    {
+        CRITICAL_SECTION(cs, _init_mutex);
+        if (!_initialized) {
+            TRACE( TRACE_ALWAYS, "Environment not initialized...\n");
+            return (3);
+        }
+
+        close_sm();
+        _pssm = NULL;
+        _initialized = false;
+
+        if (_restore_swap(device, tmpdev, logdir, tmplog)) {
+            TRACE( TRACE_ALWAYS, "Error moving (%s) over (%s). Restarting on it\n",
+                   tmpdev.c_str(), device.c_str());
+            unlink(tmpdev.c_str());
+            fcopy_remove_dir(tmplog.c_str());
+            rv = 4;
+        }
+
+        // The (restored or old) device should be mounted, not formatted
+        _sys_opts[SHORE_SYS_OPTIONS[0][0]] = "0";
+        if (start_sm()) {
+            TRACE( TRACE_ALWAYS, "Error starting Shore database\n");
+            return (5);
+        }
+
+        W_COERCE(db()->begin_xct());
+        W_COERCE(load_and_register_fids());
+        W_COERCE(db()->commit_xct());    
+
+        _initialized = true;
+        _loaded = true;
+    }
+
+    if (rv == 0) {
+        table_man_t::invalidate_rec_caches();
+        reset_stats();
+    }
+
+    if (start()) return (6);
+    if (rv) return (rv);
+    W_COERCE(newrun());
+
+    TRACE( TRACE_ALWAYS, "Snapshot (%s) restored in (%.1f) secs\n", 
+           name, timer.time());
+    return (0);
+}
+
+
+
 /****************************************************************** 
  *
  *  @fn:    get_trx_{att,com}()
@@ -1228,7 +1527,80 @@ int ShoreEnv::dump()
 
 void ShoreEnv::setAsynchCommit(const bool bAsynch)
 {
-    _asynch_commit = bAsynch;
+    setCommitMode(bAsynch ? CM_ASYNCH : CM_SYNCH);
+}
+
+
+/****************************************************************** 
+ *
+ *  @fn:    setCommitMode()
+ *
+ *  @brief: Sets the commit mode. The durability notifier is started 
+ *          the first time CM_ASYNCH_DURABLE is selected.
+ *
+ *  @note:  Not available with the flusher, which already notifies the
+ *          clients only when their xcts are durable
+ *
+ ******************************************************************/
+
+void ShoreEnv::setCommitMode(const eCommitMode aMode)
+{
+#ifdef CFG_FLUSHER
+    if (aMode == CM_ASYNCH_DURABLE) {
+        TRACE( TRACE_ALWAYS, "Durability notification not used with the flusher\n");
+        return;
+    }
+#endif
+
+    if ((aMode == CM_ASYNCH_DURABLE) && (!_durable_notifier)) {
+        _start_durable_notifier();
+    }
+    _commit_mode = aMode;
+}
+
+
+/****************************************************************** 
+ *
+ *  @fn:    setDurableCallback()
+ *
+ *  @brief: Registers the function called for each xct committed in 
+ *          CM_ASYNCH_DURABLE mode, when it becomes durable
+ *
+ ******************************************************************/
+
+void ShoreEnv::setDurableCallback(durable_cb_t cb, void* arg)
+{
+    _durable_cb = cb;
+    _durable_cb_arg = arg;
+    if (_durable_notifier) _durable_notifier->set_callback(cb,arg);
+}
+
+
+/****************************************************************** 
+ *
+ *  @fn:    {start,stop}_durable_notifier()
+ *
+ *  @brief: Starts/stops the durability notifier
+ *
+ ******************************************************************/
+
+int ShoreEnv::_start_durable_notifier()
+{
+    _durable_notifier = new durability_notifier_t(this,c_str("durable-notifier"));
+    assert (_durable_notifier);
+    _durable_notifier->set_callback(_durable_cb,_durable_cb_arg);
+    _durable_notifier->fork();
+    _durable_notifier->start();
+    return (0);
+}
+
+int ShoreEnv::_stop_durable_notifier()
+{
+    if (!_durable_notifier) return (0);
+    _durable_notifier->stop();
+    _durable_notifier->join();
+    _durable_notifier.done();
+    return (0);
 }
 
 
@@ -1283,6 +1655,22 @@ void ShoreEnv::to_base_flusher(Request* ar)
 }
 
 
+/****************************************************************** 
+ *
+ *  @fn:    to_durable_notifier()
+ *
+ *  @brief: Hands an acked, asynchronously committed xct to the 
+ *          durability notifier. The request itself is not kept.
+ *
+ ******************************************************************/
+
+void ShoreEnv::to_durable_notifier(base_request_t* ar)
+{
+    assert (_durable_notifier);
+    _durable_notifier->enqueue(ar->my_last_lsn(), ar->xct_id(), ar->submit_us());
+}
+
+
 /****************************************************************** 
  *
  *  @fn:    db_print_init
@@ -78,6 +78,9 @@ void  field_desc_t::print_desc(ostream & os)
     case SQL_SNUMERIC:
 	os << "Type: SNUMERIC \t size: " << _size << endl;
 	break;
+    case SQL_DATE:
+	os << "Type: DATE \t size: " << sizeof(int) << endl;
+	break;
     }
 } 
 
@@ -131,6 +134,7 @@ bool field_value_t::load_value_from_file(ifstream & is,
     case SQL_FLOAT:     _value._float = atof(string); break;
     case SQL_LONG:     _value._float = atol(string); break;
     case SQL_TIME:      break;
+    case SQL_DATE:      _value._date = str_to_date(string); break;
     case SQL_VARCHAR:   {
         if (string[0] == '\"') string[strlen(string)-1] = '\0';
         set_var_string_value(string+1, strlen(string)-1);
@@ -194,6 +198,11 @@ void  field_value_t::print_value(ostream & os)
         _value._time->string(mstr,32);
 	os << mstr;
 	break;
+    case SQL_DATE:
+        char dstr[16];
+        date_to_str(dstr, _value._date);
+	os << dstr;
+	break;
     case SQL_VARCHAR:
     case SQL_FIXCHAR:
 	//os << "\"";
@@ -260,6 +269,10 @@ int field_value_t::get_debug_str(char* &buf)
         _value._time->string(mstr,32);
         sprintf(buf, "SQL_TIME:     \t%s", mstr);
 	break;
+    case SQL_DATE:
+        strcat(buf, "SQL_DATE:     \t");
+        date_to_str(buf+strlen(buf), _value._date);
+	break;
     case SQL_VARCHAR:
         strcat(buf, "SQL_VARCHAR:  \t");
         strncat(buf, _value._string, _real_size);
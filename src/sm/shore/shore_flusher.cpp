@@ -419,4 +419,262 @@ int flusher_t::_pre_STOP_impl()
 }
 
 
+
+
+/****************************************************************** 
+ *
+ * @struct: latency_hist_t
+ * 
+ ******************************************************************/
+
+void latency_hist_t::add(const long long us)
+{
+    int b = 0;
+    for (long long v = us; (v > 1) && (b < LATENCY_HIST_BUCKETS-1); v >>= 1) ++b;
+    atomic_inc_64(&_bucket[b]);
+    atomic_inc_64(&_count);
+    atomic_add_64(&_total_us, (us > 0 ? us : 0));
+}
+
+long long latency_hist_t::percentile(const double p) const
+{
+    uint64_t target = (uint64_t)(p * (double)_count);
+    uint64_t seen = 0;
+    for (int b=0; b<LATENCY_HIST_BUCKETS; ++b) {
+        seen += _bucket[b];
+        if (seen > target) return (2ll<<b);
+    }
+    return (2ll<<(LATENCY_HIST_BUCKETS-1));
+}
+
+void latency_hist_t::print(const char* name) const
+{
+    if (_count == 0) {
+        TRACE( TRACE_STATISTICS, "%s: no xcts\n", name);
+        return;
+    }
+    TRACE( TRACE_STATISTICS, 
+           "%s: (%lld) xcts. Avg (%.1f)us. 50%% < (%lld)us. 90%% < (%lld)us. 99%% < (%lld)us\n",
+           name, (long long)_count, (double)_total_us/(double)_count,
+           percentile(0.5), percentile(0.9), percentile(0.99));
+}
+
+void latency_hist_t::reset()
+{
+    for (int b=0; b<LATENCY_HIST_BUCKETS; ++b) _bucket[b] = 0;
+    _count = 0;
+    _total_us = 0;
+}
+
+
+
+
+/******************************************************************** 
+ *
+ * @class: durability_notifier_t
+ * 
+ ********************************************************************/
+
+durability_notifier_t::durability_notifier_t(ShoreEnv* env, 
+                                             c_str tname,
+                                             processorid_t aprsid) 
+    : base_worker_t(env, tname, aprsid, 0),
+      _entry_pool(sizeof(durable_entry_t)),
+      _cb(NULL), _cb_arg(NULL)
+{ 
+    _pentry_ptr_pool = new Pool(sizeof(durable_entry_t*),FLUSHER_BUFFER_EXPECTED_SZ);
+    _pending = new DurableQueue(_pentry_ptr_pool.get());
+    assert (_pending.get());
+    _pending->setqueue(WS_COMMIT_Q,this,2000,0);  // wake-up immediately, spin 2000
+    _waiting.reserve(FLUSHER_BUFFER_EXPECTED_SZ);
+}
+
+durability_notifier_t::~durability_notifier_t() 
+{ 
+    assert (_pending->is_empty());
+    assert (_waiting.empty());
+    _pending.done();
+    _pentry_ptr_pool.done();
+}
+
+int durability_notifier_t::statistics()
+{
+    _ack_hist.print("Ack latency");
+    _durable_hist.print("Durable latency");
+    TRACE( TRACE_STATISTICS, "Flushes:     (%d)\n", _stats.flushes);
+    _ack_hist.reset();
+    _durable_hist.reset();
+    _stats.reset();
+    return (0);
+}
+
+
+/****************************************************************** 
+ *
+ * @fn:     enqueue()
+ *
+ * @brief:  Records the ack latency of a xct that just committed 
+ *          asynchronously and hands it to the notifier
+ * 
+ ******************************************************************/
+
+void durability_notifier_t::enqueue(const lsn_t& lsn, 
+                                    const int xct_id, 
+                                    const long long submit_us)
+{
+    stopwatch_t now;
+    long long now_us = now.now();
+    _ack_hist.add(now_us - submit_us);
+
+    durable_entry_t* pe = new (_entry_pool) durable_entry_t;
+    pe->_lsn = lsn;
+    pe->_xct_id = xct_id;
+    pe->_submit_us = submit_us;
+    _pending->push(pe,true);
+}
+
+
+/****************************************************************** 
+ *
+ * @fn:     _work_ACTIVE_impl()
+ *
+ * @brief:  Collects the asynchronously committed xcts, flushes the log
+ *          when enough of them are waiting or enough time has passed,
+ *          and notifies the ones that became durable
+ *
+ * @return: 0 on success
+ * 
+ ******************************************************************/
+
+int durability_notifier_t::_work_ACTIVE_impl()
+{    
+    envVar* ev = envVar::instance();
+    int binding = ev->getVarInt("flusher-binding",0);
+    if (binding==0) _prs_id = PBIND_NONE;
+    TRY_TO_BIND(_prs_id,_is_bound);
+
+    uint maxGroupSize = ev->getVarInt("flusher-group-size",FLUSHER_GROUP_SIZE_THRESHOLD);
+    long long maxTimeIntervalusec = ev->getVarInt("flusher-timeout",FLUSHER_TIME_THRESHOLD);
+
+    lsn_t durablelsn;
+    durable_entry_t* pe = NULL;
+    stopwatch_t timer;
+    long long lastflush = timer.now();
+    long long backoff = NOTIFIER_MIN_BACKOFF_US;
+
+    while (get_control() == WC_ACTIVE) {        
+        set_ws(WS_LOOP);
+
+        // Collect the newly committed xcts. If none is waiting, it
+        // blocks in the queue until one arrives.
+        bool bBlock = _waiting.empty();
+        while ((!_pending->is_empty()) || bBlock) {
+            pe = _pending->pop();
+
+            // The only way for pop() to return NULL is when signalled to stop
+            if (!pe) return (0);
+            _waiting.push_back(pe);
+            bBlock = false;
+            backoff = NOTIFIER_MIN_BACKOFF_US;
+            _stats.served++;
+        }
+
+        // Some of them may be durable already
+        _env->db()->get_durable_lsn(durablelsn);
+        _stats.alreadyFlushed += _notify_durable(durablelsn);
+        if (_waiting.empty()) continue;
+
+        // Flush the group if it is big or old enough, otherwise ask for
+        // a lazy flush
+        long long now = timer.now();
+        if ((_waiting.size() >= maxGroupSize) || 
+            (now - lastflush >= maxTimeIntervalusec)) {
+            _stats.flushes++;
+            _stats.waiting += _waiting.size();
+            if (_waiting.size() >= maxGroupSize) _stats.trigByXcts++;
+            else _stats.trigByTimeout++;
+            _env->db()->sync_log(); // it will block
+            lastflush = timer.now();
+            backoff = NOTIFIER_MIN_BACKOFF_US;
+
+            _env->db()->get_durable_lsn(durablelsn);
+            _notify_durable(durablelsn);
+        }
+        else {
+            // Not yet time to flush. Sleep until the timeout expires or
+            // for the backoff, whichever comes first, instead of spinning.
+            long long left = maxTimeIntervalusec - (now - lastflush);
+            usleep((useconds_t)(backoff < left ? backoff : left));
+            if (backoff < NOTIFIER_MAX_BACKOFF_US) backoff <<= 1;
+        }
+    }
+    return (0);
+}
+
+
+/****************************************************************** 
+ *
+ * @fn:     _notify_durable()
+ *
+ * @brief:  Notifies the waiting xcts whose commit lsn is durable and 
+ *          removes them from the waiting list
+ *
+ * @return: The number of xcts notified
+ * 
+ ******************************************************************/
+
+uint durability_notifier_t::_notify_durable(const lsn_t& durablelsn)
+{
+    stopwatch_t timer;
+    long long now_us = timer.now();
+    uint notified = 0;
+    uint j = 0;
+
+    for (uint i=0; i<_waiting.size(); ++i) {
+        durable_entry_t* pe = _waiting[i];
+        if (durablelsn > pe->_lsn) {
+            _durable_hist.add(now_us - pe->_submit_us);
+            if (_cb) _cb(pe->_xct_id, pe->_lsn, _cb_arg);
+            _entry_pool.destroy(pe);
+            ++notified;
+        }
+        else {
+            _waiting[j++] = pe;
+        }
+    }
+    _waiting.resize(j);
+    return (notified);
+}
+
+
+/****************************************************************** 
+ *
+ * @fn:     _pre_STOP_impl()
+ *
+ * @brief:  Flushes and notifies the xcts still waiting
+ *
+ * @return: 0 on success
+ * 
+ ******************************************************************/
+
+int durability_notifier_t::_pre_STOP_impl() 
+{ 
+    durable_entry_t* pe = NULL;
+    while (!_pending->is_empty()) {
+        pe = _pending->pop();
+        if (pe) _waiting.push_back(pe);
+    }
+
+    if (!_waiting.empty()) {
+        uint afterStop = _waiting.size();
+        lsn_t durablelsn;
+        _env->db()->sync_log();
+        _env->db()->get_durable_lsn(durablelsn);
+        _notify_durable(durablelsn);
+        TRACE( TRACE_ALWAYS, "Xcts made durable at stop (%d)\n", afterStop);
+    }
+    return(0); 
+}
+
+
 EXIT_NAMESPACE(shore);
@@ -96,6 +96,18 @@ void db_log_smt_t::work()
 }
 
 
+void db_snapshot_smt_t::work() 
+{
+    assert (_env);
+    if (_restore) {
+        _rv = _env->restore_impl(_name.c_str());
+    }
+    else {
+        _rv = _env->snapshot_impl(_name.c_str());
+    }
+}
+
+
 void db_load_smt_t::work() 
 {
     _rc = _env->loaddata();
@@ -50,7 +50,9 @@ index_desc_t::index_desc_t(const char* name, const int fieldcnt,
       _unique(unique), _primary(primary),
       _rmapholder(rmapholder),
       _next(NULL), _maxkeysize(0),
-      _partition_count((partitions > 0)? partitions : 1), _partition_stids(0)
+      _partition_count((partitions > 0)? partitions : 1), _partition_stids(0),
+      _payload(NULL), _payload_off(NULL), _payload_sz(NULL),
+      _payload_cnt(0), _payload_bytes(0)
 {
     // Copy the indexes of keys
     _key = new uint[_base._field_count];
@@ -129,6 +131,13 @@ index_desc_t::~index_desc_t()
         delete [] _partition_stids;
         _partition_stids = NULL;
     }
+
+    if (_payload) {
+        delete [] _payload;
+        delete [] _payload_off;
+        delete [] _payload_sz;
+        _payload = NULL;
+    }
 }
 
 
@@ -213,6 +222,10 @@ void index_desc_t::print_desc(ostream& os)
 	os << _keydesc[i] << "|";
     }
     os << endl;
+    if (_payload_cnt) {
+        os << "Payload fields: " << _payload_cnt 
+           << " (" << _payload_bytes << " bytes)" << endl;
+    }
 }
 
 
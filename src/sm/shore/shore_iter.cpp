@@ -150,15 +150,16 @@ w_rc_t simple_index_iter_t::next(bool& eof, rid_t& rid)
     W_DO(_scanner->next(eof));
 
     if (!eof) {        
-        rid_t    tmprid;
-        vec_t    record(&tmprid, sizeof(rid_t));
-        smsize_t elen = sizeof(rid_t);
+        // the element of a covering index carries also the payload
+        char     el[MAX_INDEX_EL];
+        vec_t    record(el, _idx->el_size());
+        smsize_t elen = _idx->el_size();
         
         vec_t tmpvec;
         smsize_t tmpsz=0;
 
         W_DO(_scanner->curr(&tmpvec, tmpsz, &record, elen));
-        rid = tmprid;
+        memcpy(&rid, el, sizeof(rid_t));
     }    
     return (RCOK);
 }
@@ -0,0 +1,639 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_load_cache.cpp
+ *
+ *  @brief:  Implementation of the cache of the generated records
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "sm/shore/shore_load_cache.h"
+#include "sm/shore/shore_bulk_loader.h"
+
+using namespace shore;
+
+
+ENTER_NAMESPACE(shore);
+
+
+load_cache_t* load_cache_t::_active = NULL;
+uint_t        load_cache_t::_gen = 0;
+
+
+// The writers of the calling loader thread, valid if taken at the current _gen
+static __thread load_cache_t::thread_writers_t* thr_writers = NULL;
+static __thread uint_t thr_gen = 0;
+
+static const char* LOAD_CACHE_MAGIC = "shore-kits-loadcache";
+static const int   LOAD_CACHE_VERSION = 1;
+static const char* LOAD_CACHE_MANIFEST = "MANIFEST";
+
+
+
+/******************************************************************
+ *
+ *  @class: mapped_file_t
+ *
+ *  @brief: Read-only mapping of a file of the cache
+ *
+ ******************************************************************/
+
+class mapped_file_t
+{
+    const char* _data;
+    size_t      _size;
+public:
+    mapped_file_t() : _data(NULL), _size(0) { }
+    ~mapped_file_t() { if (_data) munmap((void*)_data, _size); }
+
+    bool open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return (false);
+        struct stat st;
+        if (fstat(fd, &st) < 0) { ::close(fd); return (false); }
+        _size = st.st_size;
+        if (_size > 0) {
+            void* p = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) { ::close(fd); _size = 0; return (false); }
+            madvise(p, _size, MADV_SEQUENTIAL);
+            _data = (const char*)p;
+        }
+        ::close(fd);
+        return (true);
+    }
+
+    const char* data() const { return (_data); }
+    size_t size() const { return (_size); }
+};
+
+
+
+/******************************************************************
+ *
+ *  @class: load_replayer_t
+ *
+ *  @brief: Thread that inserts the records of the cache, out of a
+ *          common list of files
+ *
+ ******************************************************************/
+
+static volatile uint_t replay_next_file = 0;
+
+class load_replayer_t : public thread_t
+{
+private:
+    ss_m*         _db;
+    load_cache_t* _pcache;
+    uint64_t      _rows;
+    int           _err;
+public:
+    load_replayer_t(ss_m* db, load_cache_t* pcache, const int id)
+        : thread_t(c_str("RPL-%d",id)), _db(db), _pcache(pcache),
+          _rows(0), _err(0) { }
+    virtual void work();
+    uint64_t rows() const { return (_rows); }
+    int err() const { return (_err); }
+};
+
+void load_replayer_t::work()
+{
+    for (;;) {
+        uint_t ifile = atomic_inc_uint_nv(&replay_next_file) - 1;
+        if (ifile >= _pcache->file_count()) break;
+
+        w_rc_t e = _pcache->replay_file(_db, ifile, _rows);
+        if (e.is_error()) {
+            TRACE( TRACE_ALWAYS, "Replaying file (%d) failed (%x)\n",
+                   ifile, e.err_num());
+            _err = e.err_num();
+        }
+    }
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    Construction
+ *
+ *  @brief: The signature of the schema covers the name of each table
+ *          and the type, size and nullability of each of its fields,
+ *          i.e. everything that determines the format of the records
+ *
+ ******************************************************************/
+
+load_cache_t::load_cache_t(const char* name,
+                           const std::vector<table_man_t*>& tables)
+    : _name(name), _tables(tables), _schema_sig(FNV_INIT), _usable(true),
+      _capturing(false), _broken(false), _next_file(0)
+{
+    _dir = envVar::instance()->getVar("db-loadcache-dir","loadcache");
+
+    for (uint_t i=0; i<_tables.size(); ++i) {
+        table_desc_t* ptable = _tables[i]->table();
+        _schema_sig = fnv_hash(ptable->name(), strlen(ptable->name()), _schema_sig);
+        for (uint_t j=0; j<ptable->field_count(); ++j) {
+            field_desc_t* pfd = ptable->desc(j);
+            int f[3] = { (int)pfd->type(), (int)pfd->fieldmaxsize(),
+                         (int)pfd->allow_null() };
+            _schema_sig = fnv_hash((const char*)f, sizeof(f), _schema_sig);
+        }
+
+        // The MRBT-partitioned tables are loaded through add_plp_tuple()
+        if ((ptable->get_pd() & (PD_MRBT_PART | PD_MRBT_LEAF)) &&
+            ptable->primary_idx() && ptable->primary_idx()->is_latchless()) {
+            _usable = false;
+        }
+    }
+
+    if (!_usable) {
+        TRACE( TRACE_ALWAYS, "Load cache (%s) not used with MRBT partitioning\n",
+               _name.c_str());
+    }
+}
+
+load_cache_t::~load_cache_t()
+{
+    assert (!_capturing);
+}
+
+bool load_cache_t::is_enabled()
+{
+    return (envVar::instance()->getVarInt("db-loadcache",0) == 1);
+}
+
+std::string load_cache_t::_path(const std::string& file) const
+{
+    return (_dir + "/" + _name + "/" + file);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    is_valid()
+ *
+ *  @brief: Reads the MANIFEST and checks that the schema signature
+ *          matches and that each file has the recorded size, number
+ *          of records and checksum
+ *
+ ******************************************************************/
+
+bool load_cache_t::_read_manifest()
+{
+    _files.clear();
+
+    FILE* fp = fopen(_path(LOAD_CACHE_MANIFEST).c_str(), "r");
+    if (!fp) return (false);
+
+    char magic[64];
+    int version = 0;
+    char name[256];
+    uint32_t sig = 0;
+    uint_t nfiles = 0;
+    bool ok = ((fscanf(fp, "%63s %d\n", magic, &version) == 2) &&
+               (strcmp(magic, LOAD_CACHE_MAGIC) == 0) &&
+               (version == LOAD_CACHE_VERSION) &&
+               (fscanf(fp, "name %255s\n", name) == 1) &&
+               (_name == name) &&
+               (fscanf(fp, "schema %x\n", &sig) == 1) &&
+               (fscanf(fp, "files %u\n", &nfiles) == 1));
+
+    if (ok && (sig != _schema_sig)) {
+        TRACE( TRACE_ALWAYS, "Load cache (%s) is stale, the schema has changed\n",
+               _name.c_str());
+        ok = false;
+    }
+
+    for (uint_t i=0; ok && (i<nfiles); ++i) {
+        cfile_t f;
+        unsigned long long rows, bytes;
+        char fname[256];
+        ok = ((fscanf(fp, "%u %llu %llu %x %255s\n", &f._itable, &rows,
+                      &bytes, &f._sum, fname) == 5) &&
+              (f._itable < _tables.size()));
+        f._rows = rows;
+        f._bytes = bytes;
+        f._name = fname;
+        if (ok) _files.push_back(f);
+    }
+    fclose(fp);
+
+    if (!ok) _files.clear();
+    return (ok);
+}
+
+bool load_cache_t::is_valid()
+{
+    if (!_usable) return (false);
+    if (!_read_manifest()) return (false);
+
+    stopwatch_t timer;
+    uint64_t bytes = 0;
+    for (uint_t i=0; i<_files.size(); ++i) {
+        cfile_t& f = _files[i];
+        mapped_file_t mf;
+        if (!mf.open(_path(f._name).c_str()) || (mf.size() != f._bytes)) {
+            TRACE( TRACE_ALWAYS, "Load cache file (%s) is missing or truncated\n",
+                   f._name.c_str());
+            return (false);
+        }
+
+        // the records should be exactly the recorded ones
+        uint64_t rows = 0;
+        uint_t maxsz = _tables[f._itable]->table()->maxsize();
+        size_t pos = 0;
+        while (pos + sizeof(uint4_t) <= mf.size()) {
+            uint4_t sz;
+            memcpy(&sz, mf.data()+pos, sizeof(uint4_t));
+            if ((sz == 0) || (sz > maxsz)) break;
+            pos += sizeof(uint4_t) + sz;
+            ++rows;
+        }
+        uint32_t sum = (mf.size() ? fnv_hash(mf.data(), mf.size()) : FNV_INIT);
+        if ((pos != mf.size()) || (rows != f._rows) || (sum != f._sum)) {
+            TRACE( TRACE_ALWAYS, "Load cache file (%s) failed the checksum\n",
+                   f._name.c_str());
+            return (false);
+        }
+        bytes += f._bytes;
+    }
+
+    TRACE( TRACE_ALWAYS, "Load cache (%s) valid. (%d) files (%lld) MB checked in (%.1f) secs\n",
+           _name.c_str(), _files.size(), (long long)(bytes>>20), timer.time());
+    return (true);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    replay()
+ *
+ *  @brief: Inserts the records of all the files, each file by one
+ *          thread, LOAD_CACHE_XCT_ROWS records per xct
+ *
+ *  @note:  An xct that deadlocks is retried. One that runs out of log
+ *          space is retried after a checkpoint, which lets the log be
+ *          reclaimed, reserving the space it needed the last time.
+ *
+ ******************************************************************/
+
+w_rc_t load_cache_t::replay(ss_m* db, const int threads)
+{
+    assert (db);
+    assert (!_capturing);
+
+    stopwatch_t timer;
+    replay_next_file = 0;
+    int nthreads = std::min((int)_files.size(), std::max(threads,1));
+    TRACE( TRACE_ALWAYS, "Replaying (%d) files of load cache (%s) with (%d) threads\n",
+           _files.size(), _name.c_str(), nthreads);
+
+    int err = 0;
+    uint64_t rows = 0;
+    {
+        array_guard_t< guard<load_replayer_t> > replayers(new guard<load_replayer_t>[nthreads]);
+        for (int i=0; i<nthreads; i++) {
+            replayers[i] = new load_replayer_t(db, this, i);
+            replayers[i]->fork();
+        }
+        for (int i=0; i<nthreads; i++) {
+            replayers[i]->join();
+            if (replayers[i]->err()) err = replayers[i]->err();
+            rows += replayers[i]->rows();
+        }
+    }
+
+    double secs = timer.time();
+    TRACE( TRACE_STATISTICS, "Replayed (%lld) rows in (%.1f) secs (%.0f rows/s)\n",
+           (long long)rows, secs, (secs>0 ? (double)rows/secs : 0.0));
+
+    if (err) return (RC(se_ERROR_IN_LOAD));
+    return (RCOK);
+}
+
+w_rc_t load_cache_t::replay_file(ss_m* db, const uint_t ifile, uint64_t& rows)
+{
+    assert (ifile < _files.size());
+    cfile_t& f = _files[ifile];
+    table_man_t* pman = _tables[f._itable];
+
+    mapped_file_t mf;
+    if (!mf.open(_path(f._name).c_str())) return (RC(se_ERROR_IN_LOAD));
+
+    table_row_t tuple(pman->table());
+    rep_row_t arep(pman->ts());
+    arep.set(pman->table()->maxsize());
+    tuple._rep = &arep;
+
+    const char* p = mf.data();
+    const char* end = mf.data() + mf.size();
+    while (p < end) {
+        const char* start = p;
+        uint_t n = 0;
+        w_rc_t e = RCOK;
+        long log_space_needed = 0;
+        uint_t log_retries = 0;
+
+        bulk_loader_t::mark_runs();
+    retry:
+        bulk_loader_t::rollback_runs();
+        p = start;
+        n = 0;
+        e = RCOK;
+        W_DO(db->begin_xct());
+#ifdef USE_SHORE_6
+        if (log_space_needed > 0) {
+            W_DO(db->xct_reserve_log_space(log_space_needed));
+        }
+#endif
+        while ((n < LOAD_CACHE_XCT_ROWS) && (p < end)) {
+            uint4_t sz;
+            memcpy(&sz, p, sizeof(uint4_t));
+            p += sizeof(uint4_t);
+            e = pman->add_formatted(db, &tuple, p, sz);
+            if (e.is_error()) break;
+            p += sz;
+            ++n;
+        }
+        if (!e.is_error()) e = db->commit_xct();
+
+        if (e.is_error()) {
+#ifdef USE_SHORE_6
+            long used = db->xct_log_space_needed();
+#else
+            long used = 0;
+#endif
+            W_COERCE(db->abort_xct());
+            if (e.err_num() == smlevel_0::eDEADLOCK) goto retry;
+            if ((e.err_num() == smlevel_0::eOUTOFLOGSPACE) &&
+                (++log_retries <= LOAD_CACHE_LOG_RETRIES)) {
+                TRACE( TRACE_ALWAYS, "Out of log space at file (%d), checkpointing\n",
+                       ifile);
+                W_DO(ss_m::checkpoint());
+                log_space_needed = used;
+                goto retry;
+            }
+            return (e);
+        }
+        rows += n;
+    }
+    return (RCOK);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    begin_capture()/end_capture()
+ *
+ *  @brief: The old MANIFEST is removed first, so that the cache is not
+ *          valid until the new capture completes
+ *
+ ******************************************************************/
+
+w_rc_t load_cache_t::begin_capture()
+{
+    if (!_usable) return (RCOK);
+    assert (!_active);
+
+    std::string sub = _dir + "/" + _name;
+    if (((mkdir(_dir.c_str(), 0755) < 0) && (errno != EEXIST)) ||
+        ((mkdir(sub.c_str(), 0755) < 0) && (errno != EEXIST))) {
+        TRACE( TRACE_ALWAYS, "Cannot create (%s). Load cache not captured\n",
+               sub.c_str());
+        return (RCOK);
+    }
+    unlink(_path(LOAD_CACHE_MANIFEST).c_str());
+
+    _files.clear();
+    _broken = false;
+    _next_file = 0;
+    ++_gen;
+    _active = this;
+    _capturing = true;
+    for (uint_t i=0; i<_tables.size(); ++i) {
+        _tables[i]->set_load_cache(this);
+    }
+
+    TRACE( TRACE_ALWAYS, "Capturing the load to cache (%s)\n", sub.c_str());
+    return (RCOK);
+}
+
+w_rc_t load_cache_t::end_capture()
+{
+    if (!_capturing) return (RCOK);
+
+    for (uint_t i=0; i<_tables.size(); ++i) {
+        _tables[i]->set_load_cache(NULL);
+    }
+    _capturing = false;
+    _active = NULL;
+
+    // all the xcts of the loaders have committed, thus the records
+    // still buffered are written as well
+    for (uint_t i=0; i<_twriters.size(); ++i) {
+        thread_writers_t* ptw = _twriters[i];
+        for (uint_t j=0; j<ptw->_writers.size(); ++j) {
+            cwriter_t* pw = ptw->_writers[j];
+            if (!pw) continue;
+            if (_flush(pw).is_error()) _broken = true;
+            if (fclose(pw->_fp) != 0) _broken = true;
+            _files.push_back(pw->_file);
+            delete (pw);
+        }
+        delete (ptw);
+    }
+    _twriters.clear();
+
+    if (_broken) {
+        TRACE( TRACE_ALWAYS, "Load cache (%s) incomplete, not written\n",
+               _name.c_str());
+        _files.clear();
+        return (RCOK);
+    }
+    return (_write_manifest());
+}
+
+w_rc_t load_cache_t::_write_manifest()
+{
+    std::string tmp = _path(LOAD_CACHE_MANIFEST) + ".tmp";
+    FILE* fp = fopen(tmp.c_str(), "w");
+    if (!fp) return (RC(se_ERROR_IN_LOAD));
+
+    fprintf(fp, "%s %d\n", LOAD_CACHE_MAGIC, LOAD_CACHE_VERSION);
+    fprintf(fp, "name %s\n", _name.c_str());
+    fprintf(fp, "schema %x\n", _schema_sig);
+    fprintf(fp, "files %u\n", (uint_t)_files.size());
+    uint64_t rows = 0;
+    for (uint_t i=0; i<_files.size(); ++i) {
+        cfile_t& f = _files[i];
+        fprintf(fp, "%u %llu %llu %x %s\n", f._itable,
+                (unsigned long long)f._rows, (unsigned long long)f._bytes,
+                f._sum, f._name.c_str());
+        rows += f._rows;
+    }
+    if ((fclose(fp) != 0) ||
+        (rename(tmp.c_str(), _path(LOAD_CACHE_MANIFEST).c_str()) < 0)) {
+        return (RC(se_ERROR_IN_LOAD));
+    }
+
+    TRACE( TRACE_ALWAYS, "Load cache (%s) written. (%d) files (%lld) rows\n",
+           _name.c_str(), _files.size(), (long long)rows);
+    return (RCOK);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    capture()
+ *
+ *  @brief: Appends the record to the buffer of the calling thread for
+ *          the table. A buffer that grows beyond LOAD_CACHE_FLUSH_MB
+ *          (only the single, long xct of the baseline loaders does) is
+ *          written before the xct commits.
+ *
+ ******************************************************************/
+
+load_cache_t::thread_writers_t* load_cache_t::_my_writers()
+{
+    if ((thr_gen != _gen) || !thr_writers) {
+        thr_writers = new thread_writers_t;
+        thr_writers->_writers.resize(_tables.size(), NULL);
+        thr_writers->_spilled = false;
+        thr_gen = _gen;
+
+        CRITICAL_SECTION(writers_cs, _writers_lock);
+        _twriters.push_back(thr_writers);
+    }
+    return (thr_writers);
+}
+
+void load_cache_t::capture(table_man_t* pman, const char* rec, const uint_t recsz)
+{
+    assert (_capturing);
+
+    uint_t itable = 0;
+    while ((itable < _tables.size()) && (_tables[itable] != pman)) ++itable;
+    assert (itable < _tables.size());
+
+    thread_writers_t* ptw = _my_writers();
+    cwriter_t* pw = ptw->_writers[itable];
+    if (!pw) {
+        pw = new cwriter_t;
+        pw->_file._itable = itable;
+        pw->_file._name = c_str("%s.%d", pman->table()->name(),
+                                atomic_inc_uint_nv(&_next_file)).data();
+        pw->_file._rows = 0;
+        pw->_file._bytes = 0;
+        pw->_file._sum = FNV_INIT;
+        pw->_buf_rows = 0;
+        pw->_fp = fopen(_path(pw->_file._name).c_str(), "wb");
+        if (!pw->_fp) {
+            TRACE( TRACE_ALWAYS, "Cannot create (%s)\n", pw->_file._name.c_str());
+            _broken = true;
+            delete (pw);
+            return;
+        }
+        ptw->_writers[itable] = pw;
+    }
+
+    uint4_t sz = recsz;
+    pw->_buf.insert(pw->_buf.end(), (const char*)&sz, (const char*)&sz + sizeof(uint4_t));
+    pw->_buf.insert(pw->_buf.end(), rec, rec + recsz);
+    ++pw->_buf_rows;
+
+    if (pw->_buf.size() >= (LOAD_CACHE_FLUSH_MB<<20)) {
+        if (_flush(pw).is_error()) _broken = true;
+        ptw->_spilled = true;
+    }
+}
+
+w_rc_t load_cache_t::_flush(cwriter_t* pw)
+{
+    if (pw->_buf.empty()) return (RCOK);
+
+    size_t sz = pw->_buf.size();
+    if (fwrite(&pw->_buf[0], 1, sz, pw->_fp) != sz) {
+        TRACE( TRACE_ALWAYS, "Writing (%s) failed\n", pw->_file._name.c_str());
+        return (RC(se_ERROR_IN_LOAD));
+    }
+    pw->_file._sum = fnv_hash(&pw->_buf[0], sz, pw->_file._sum);
+    pw->_file._bytes += sz;
+    pw->_file._rows += pw->_buf_rows;
+    pw->_buf.clear();
+    pw->_buf_rows = 0;
+    return (RCOK);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    mark()/rollback()
+ *
+ *  @brief: Called by the loader threads around each xct. At a mark the
+ *          records of the committed xct are written. On a retry the
+ *          records buffered after the last mark are dropped. If some
+ *          of them were already written the cache cannot be completed.
+ *
+ ******************************************************************/
+
+void load_cache_t::mark()
+{
+    load_cache_t* pcache = _active;
+    if (!pcache || !thr_writers || (thr_gen != _gen)) return;
+
+    for (uint_t i=0; i<thr_writers->_writers.size(); ++i) {
+        cwriter_t* pw = thr_writers->_writers[i];
+        if (pw && pcache->_flush(pw).is_error()) pcache->_broken = true;
+    }
+    thr_writers->_spilled = false;
+}
+
+void load_cache_t::rollback()
+{
+    load_cache_t* pcache = _active;
+    if (!pcache || !thr_writers || (thr_gen != _gen)) return;
+
+    for (uint_t i=0; i<thr_writers->_writers.size(); ++i) {
+        cwriter_t* pw = thr_writers->_writers[i];
+        if (!pw) continue;
+        pw->_buf.clear();
+        pw->_buf_rows = 0;
+    }
+    if (thr_writers->_spilled) pcache->_broken = true;
+}
+
+
+EXIT_NAMESPACE(shore);
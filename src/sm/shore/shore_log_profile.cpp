@@ -0,0 +1,144 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_log_profile.cpp
+ *
+ *  @brief:  Implementation of the log volume profile
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "sm/shore/shore_log_profile.h"
+#include "sm/shore/shore_table.h"
+
+using namespace shore;
+
+
+ENTER_NAMESPACE(shore);
+
+
+const char* LOG_OP_NAMES[LOP_COUNT] = { "add_tuple",
+                                        "update_tuple",
+                                        "update_dirty",
+                                        "update_fixed",
+                                        "delete_tuple",
+                                        "index_insert" };
+
+bool          log_profile_t::_enabled = false;
+log_counter_t log_profile_t::_xct[LOG_PROFILE_XCT_TYPES];
+
+
+
+/******************************************************************
+ *
+ *  @fn:    log_counter_t::print
+ *
+ ******************************************************************/
+
+void log_counter_t::print(const char* name, const char* op) const
+{
+    if (_ops==0) return;
+
+    if (_payload) {
+        // the record size shows whether the log is dominated by the
+        // whole-record images
+        TRACE( TRACE_ALWAYS,
+               "%-20s %-14s ops (%lld) KB (%.1f) recs (%lld) B/op (%.1f) recs/op (%.1f) rec B/op (%.1f)\n",
+               name, op, (long long)_ops, (double)_bytes/1024.0,
+               (long long)_records,
+               (double)_bytes/(double)_ops, (double)_records/(double)_ops,
+               (double)_payload/(double)_ops);
+    }
+    else {
+        TRACE( TRACE_ALWAYS,
+               "%-20s %-14s ops (%lld) KB (%.1f) recs (%lld) B/op (%.1f) recs/op (%.1f)\n",
+               name, op, (long long)_ops, (double)_bytes/1024.0,
+               (long long)_records,
+               (double)_bytes/(double)_ops, (double)_records/(double)_ops);
+    }
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    init
+ *
+ *  @brief: Reads whether the profile is enabled
+ *
+ ******************************************************************/
+
+void log_profile_t::init()
+{
+    _enabled = (envVar::instance()->getVarInt("db-log-profile",0) == 1);
+    if (_enabled) {
+        TRACE( TRACE_ALWAYS, "Log profile enabled\n");
+    }
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    print/reset
+ *
+ *  @brief: The profile per xct type and per table operation
+ *
+ ******************************************************************/
+
+void log_profile_t::print(const std::map<int,std::string>* pnames)
+{
+    if (!_enabled) {
+        TRACE( TRACE_ALWAYS, "Log profile disabled (db-log-profile)\n");
+        return;
+    }
+
+    TRACE( TRACE_ALWAYS, "Log profile per xct type\n");
+    char name[32];
+    for (int i=0; i<LOG_PROFILE_XCT_TYPES; ++i) {
+        if (_xct[i]._ops==0) continue;
+
+        std::map<int,std::string>::const_iterator it;
+        if (pnames && ((it = pnames->find(i)) != pnames->end())) {
+            _xct[i].print(it->second.c_str(), "xct");
+        }
+        else {
+            snprintf(name, sizeof(name), "type-%d", i);
+            _xct[i].print(name, "xct");
+        }
+    }
+
+    TRACE( TRACE_ALWAYS, "Log profile per table operation\n");
+    table_man_t::print_log_stats();
+}
+
+void log_profile_t::reset()
+{
+    for (int i=0; i<LOG_PROFILE_XCT_TYPES; ++i) {
+        _xct[i].reset();
+    }
+    table_man_t::reset_log_stats();
+}
+
+
+EXIT_NAMESPACE(shore);
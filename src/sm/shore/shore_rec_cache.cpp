@@ -0,0 +1,236 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_rec_cache.cpp
+ *
+ *  @brief:  Implementation of the hot-key record cache
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "sm/shore/shore_rec_cache.h"
+
+using namespace shore;
+
+
+ENTER_NAMESPACE(shore);
+
+
+// The threads are spread round-robin over the stat stripes
+static volatile uint_t _stat_next = 0;
+static __thread int _stat_stripe_id = -1;
+
+
+
+/******************************************************************
+ *
+ *  @fn:    Construction/destruction
+ *
+ *  @brief: The number of slots is rounded up to a power of two and
+ *          capped by REC_CACHE_MAX_SLOTS. Each slot has room for a
+ *          key and a record of up to entrysz bytes each.
+ *
+ ******************************************************************/
+
+rec_cache_t::rec_cache_t(const uint_t slots, const uint_t entrysz)
+    : _slots(NULL), _area(NULL), _mask(0), _entrysz(entrysz), _epoch(0)
+{
+    assert (slots>0);
+    assert (entrysz>0);
+
+    uint_t sz = 1;
+    while ((sz < slots) && (sz < REC_CACHE_MAX_SLOTS)) sz <<= 1;
+    _mask = sz-1;
+
+    _slots = new slot_t[sz];
+    _area = (char*)malloc(sz*2*_entrysz);
+    assert (_slots && _area);
+
+    for (uint_t i=0; i<sz; ++i) {
+        _slots[i]._seq = 0;
+        _slots[i]._epoch = 0;
+        _slots[i]._rver = 0;
+        _slots[i]._pidx = NULL;
+        _slots[i]._keysz = 0;
+        _slots[i]._recsz = 0;
+        _slots[i]._key = _area + (i*2*_entrysz);
+        _slots[i]._rec = _slots[i]._key + _entrysz;
+    }
+    for (uint_t i=0; i<REC_CACHE_STRIPES; ++i) {
+        _stripes[i]._ver = 0;
+    }
+
+    reset_stats();
+}
+
+rec_cache_t::~rec_cache_t()
+{
+    if (_slots) {
+        delete [] _slots;
+        _slots = NULL;
+    }
+    if (_area) {
+        free (_area);
+        _area = NULL;
+    }
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    lookup()
+ *
+ *  @brief: Lock-free read of a slot. The copy is valid only if the
+ *          slot sequence number was even and did not change, and the
+ *          slot was filled at the current epoch and record version.
+ *
+ ******************************************************************/
+
+bool rec_cache_t::lookup(index_desc_t* pidx, const char* key,
+                         const uint_t keysz, rid_t& arid, char* abuf)
+{
+    assert (key && abuf);
+
+    if (keysz > _entrysz) return (false);
+
+    slot_t& s = _slots[_hash(pidx,key,keysz)];
+
+    uint_t seq = *&s._seq;
+    if (seq & 1) goto miss;
+    membar_consumer();
+
+    if ((s._epoch != *&_epoch) || (s._pidx != pidx) ||
+        (s._keysz != keysz) || memcmp(s._key,key,keysz)) goto miss;
+
+    {
+        uint_t recsz = s._recsz;
+        if (recsz > _entrysz) goto miss;
+        rid_t rid = s._rid;
+        if (s._rver != version(rid)) goto miss;
+        memcpy(abuf, s._rec, recsz);
+
+        membar_consumer();
+        if (*&s._seq != seq) goto miss;
+
+        arid = rid;
+    }
+
+    atomic_inc_uint(&_stat_stripe()._hits);
+    return (true);
+
+ miss:
+    atomic_inc_uint(&_stat_stripe()._misses);
+    return (false);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    fill()
+ *
+ *  @brief: Fills a slot. If another thread is filling the same slot
+ *          it simply gives up.
+ *
+ ******************************************************************/
+
+void rec_cache_t::fill(index_desc_t* pidx, const char* key, const uint_t keysz,
+                       const rid_t& arid, const char* rec, const uint_t recsz,
+                       const uint_t epoch, const uint_t rver)
+{
+    if ((keysz > _entrysz) || (recsz > _entrysz)) return;
+
+    slot_t& s = _slots[_hash(pidx,key,keysz)];
+
+    uint_t seq = *&s._seq;
+    if (seq & 1) return;
+    if (atomic_cas_32(&s._seq, seq, seq+1) != seq) return;
+    membar_producer();
+
+    s._epoch = epoch;
+    s._rver = rver;
+    s._pidx = pidx;
+    s._keysz = keysz;
+    s._recsz = recsz;
+    s._rid = arid;
+    memcpy(s._key, key, keysz);
+    memcpy(s._rec, rec, recsz);
+
+    membar_producer();
+    s._seq = seq+2;
+
+    atomic_inc_uint(&_stat_stripe()._fills);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    stats
+ *
+ *  @brief: Each thread bumps the counters of its own stripe, which
+ *          it picks on its first probe. The stats sum the stripes.
+ *
+ ******************************************************************/
+
+rec_cache_t::stat_stripe_t& rec_cache_t::_stat_stripe()
+{
+    if (_stat_stripe_id < 0) {
+        _stat_stripe_id = atomic_inc_uint_nv(&_stat_next) % REC_CACHE_STAT_STRIPES;
+    }
+    return (_stats[_stat_stripe_id]);
+}
+
+void rec_cache_t::reset_stats()
+{
+    for (uint_t i=0; i<REC_CACHE_STAT_STRIPES; ++i) {
+        _stats[i]._hits = 0;
+        _stats[i]._misses = 0;
+        _stats[i]._fills = 0;
+    }
+    _invalidations = 0;
+}
+
+void rec_cache_t::print_stats(const char* tname) const
+{
+    uint_t hits = 0;
+    uint_t misses = 0;
+    uint_t fills = 0;
+    for (uint_t i=0; i<REC_CACHE_STAT_STRIPES; ++i) {
+        hits += _stats[i]._hits;
+        misses += _stats[i]._misses;
+        fills += _stats[i]._fills;
+    }
+
+    uint_t probes = hits + misses;
+    if (probes==0) return;
+
+    TRACE( TRACE_STATISTICS,
+           "RecCache (%s) slots (%d) probes (%d) hits (%.1f%%) fills (%d) invals (%d)\n",
+           tname, _mask+1, probes, (100.0*hits)/(double)probes,
+           fills, _invalidations);
+}
+
+
+EXIT_NAMESPACE(shore);
@@ -129,8 +129,9 @@ table_row_t::table_row_t()
     : _ptable(NULL),
       _field_cnt(0), _is_setup(false), 
       _rid(rid_t::null), _pvalues(NULL), 
+      _arena(NULL), _arena_sz(0),
       _fixed_offset(0),_var_slot_offset(0),_var_offset(0),_null_count(0),
-      _rep(NULL), _rep_key(NULL)
+      _rep(NULL), _rep_key(NULL), _dirty(0)
 { 
 }
         
@@ -149,6 +150,11 @@ table_row_t::~table_row_t()
  *          to its table description. This setup will be done only 
  *          *once*. When this row will be initialized in the row cache.
  *
+ *  @note:  The data of all the time and string values are stored in one
+ *          contiguous arena, allocated here, with a fixed max-sized slot
+ *          per field. Thus, setting a value never allocates, and reset()
+ *          is a single memset.
+ *
  ******************************************************************/
 
 int table_row_t::setup(table_desc_t* ptd) 
@@ -162,6 +168,8 @@ int table_row_t::setup(table_desc_t* ptd)
     }
 
     // else do the normal setup
+    freevalues();
+    _null_count = 0;
     _ptable = ptd;
     _field_cnt = ptd->field_count();
     assert (_field_cnt>0);
@@ -170,9 +178,29 @@ int table_row_t::setup(table_desc_t* ptd)
     uint var_count  = 0;
     uint fixed_size = 0;
 
+    // the arena is sized from the max disk size of the tuple, which is 
+    // always larger than the data of the values, plus the alignment
+    // padding of the timestamps
+    _arena_sz = ptd->maxsize() + sizeof(long long)*_field_cnt;
+    _arena = (char*)malloc(_arena_sz);
+    memset(_arena, 0, _arena_sz);
+    uint_t arena_off = 0;
+
     // setup each field and calculate offsets along the way
     for (uint i=0; i<_field_cnt; i++) {
-        _pvalues[i].setup(ptd->desc(i));
+        field_desc_t* pfd = ptd->desc(i);
+        if (field_value_t::needs_data(pfd->type())) {
+            if (pfd->type() == SQL_TIME) {
+                arena_off = (arena_off + sizeof(long long)-1) 
+                    & ~(sizeof(long long)-1);
+            }
+            assert (arena_off + pfd->fieldmaxsize() <= _arena_sz);
+            _pvalues[i].setup(pfd, _arena + arena_off);
+            arena_off += pfd->fieldmaxsize();
+        }
+        else {
+            _pvalues[i].setup(pfd);
+        }
 
         // count variable- and fixed-sized fields
         if (_pvalues[i].is_variable_length())
@@ -30,6 +30,7 @@
 
 #include "sm/shore/shore_shell.h"
 #include "k_defines.h"
+#include "sm/shore/shore_log_profile.h"
 
 
 ENTER_NAMESPACE(shore);
@@ -115,6 +116,12 @@ void shore_shell_t::print_sup_trxs(void) const
             TRACE( TRACE_ALWAYS, "%d -> %s\n", cit->first, cit->second.c_str());
 }
 
+// The log profile, with the names of the supported trxs
+void shore_shell_t::print_log_profile(void) const 
+{
+    log_profile_t::print(&_sup_trxs);
+}
+
 const char* shore_shell_t::translate_trx(const int iSelectedTrx) const
 {
     mapSupTrxsConstIt cit = _sup_trxs.find(iSelectedTrx);
@@ -767,6 +774,8 @@ int shore_shell_t::register_commands()
     REGISTER_CMD_PARAM(stats_verbose_cmd_t,_stats_verboser,_env);
     REGISTER_CMD_PARAM(db_print_cmd_t,_db_printer,_env);
     REGISTER_CMD_PARAM(db_fetch_cmd_t,_db_fetch,_env);
+    REGISTER_CMD_PARAM(snapshot_cmd_t,_snapshoter,_env);
+    REGISTER_CMD_PARAM(restore_cmd_t,_restorer,_env);
 
     REGISTER_CMD_PARAM(log_cmd_t,_logger,_env);
     REGISTER_CMD_PARAM(asynch_cmd_t,_asyncher,_env);
@@ -783,6 +792,7 @@ int shore_shell_t::register_commands()
     REGISTER_CMD_PARAM(warmup_cmd_t,_warmuper,this);
     REGISTER_CMD_PARAM(load_cmd_t,_loader,this);
     REGISTER_CMD_PARAM(trxs_cmd_t,_trxser,this);
+    REGISTER_CMD_PARAM(logstats_cmd_t,_logstatser,this);
 
     return (0);
 }
@@ -1271,6 +1281,99 @@ string db_fetch_cmd_t::desc() const
 }
 
 
+/*********************************************************************
+ *
+ *  "snapshot" command
+ *
+ *  Takes a snapshot of the loaded database (device and log)
+ *
+ *********************************************************************/
+
+void snapshot_cmd_t::setaliases() 
+{ 
+    _name = string("snapshot"); 
+    _aliases.push_back("snapshot"); 
+    _aliases.push_back("snap"); 
+}
+
+int snapshot_cmd_t::handle(const char* cmd)
+{
+    char cmd_tag[SERVER_COMMAND_BUFFER_SIZE];
+    char name_tag[SERVER_COMMAND_BUFFER_SIZE];
+
+    if ( sscanf(cmd, "%s %s", cmd_tag, name_tag) < 2) {
+        usage();
+        return (SHELL_NEXT_CONTINUE);
+    }
+    assert (_env);
+
+    if (_env->snapshot(name_tag)) {
+        TRACE( TRACE_ALWAYS, "Snapshot (%s) failed\n", name_tag);
+    }
+    return (SHELL_NEXT_CONTINUE);
+}
+
+void snapshot_cmd_t::usage(void)
+{
+    TRACE( TRACE_ALWAYS, "SNAPSHOT Usage:\n\n"                          \
+           "*** snapshot <NAME>\n"                                       \
+           "\nParameters:\n"                                             \
+           "<NAME> - The snapshot is kept at <db-snapshot-dir>/<NAME>\n\n");
+}
+
+string snapshot_cmd_t::desc() const 
+{ 
+    return (string("Checkpoints and takes a snapshot of the database and the log")); 
+}
+
+
+
+/*********************************************************************
+ *
+ *  "restore" command
+ *
+ *  Restores the database (device and log) from a snapshot
+ *
+ *********************************************************************/
+
+void restore_cmd_t::setaliases() 
+{ 
+    _name = string("restore"); 
+    _aliases.push_back("restore"); 
+}
+
+int restore_cmd_t::handle(const char* cmd)
+{
+    char cmd_tag[SERVER_COMMAND_BUFFER_SIZE];
+    char name_tag[SERVER_COMMAND_BUFFER_SIZE];
+
+    if ( sscanf(cmd, "%s %s", cmd_tag, name_tag) < 2) {
+        usage();
+        return (SHELL_NEXT_CONTINUE);
+    }
+    assert (_env);
+
+    if (_env->restore(name_tag)) {
+        TRACE( TRACE_ALWAYS, "Restore of (%s) failed\n", name_tag);
+    }
+    return (SHELL_NEXT_CONTINUE);
+}
+
+void restore_cmd_t::usage(void)
+{
+    TRACE( TRACE_ALWAYS, "RESTORE Usage:\n\n"                           \
+           "*** restore <NAME>\n"                                        \
+           "\nParameters:\n"                                             \
+           "<NAME> - A snapshot taken with the snapshot command\n\n");
+}
+
+string restore_cmd_t::desc() const 
+{ 
+    return (string("Restores the database and the log from a snapshot")); 
+}
+
+
+
 /*********************************************************************
  *
  *  "log" command
@@ -1347,24 +1450,40 @@ void asynch_cmd_t::setaliases()
     _aliases.push_back("asynch"); 
 }
 
-int asynch_cmd_t::handle(const char* /* cmd */)
+int asynch_cmd_t::handle(const char* cmd)
 {
-    _enabled = !_enabled;    
-    _env->setAsynchCommit(_enabled);
-    TRACE( TRACE_ALWAYS, "AsynchCommit=%d\n", _enabled);
+    char cmd_tag[SERVER_COMMAND_BUFFER_SIZE];
+    char mode_tag[SERVER_COMMAND_BUFFER_SIZE];
+
+    // "asynch durable" acks early and notifies durability separately
+    if ((sscanf(cmd, "%s %s", cmd_tag, mode_tag) == 2) && 
+        (strcasecmp("durable", mode_tag) == 0)) {
+        _enabled = true;
+        _env->setCommitMode(CM_ASYNCH_DURABLE);
+    }
+    else {
+        _enabled = !_enabled;    
+        _env->setAsynchCommit(_enabled);
+    }
+    TRACE( TRACE_ALWAYS, "AsynchCommit=%d DurableNotify=%d\n", 
+           _env->isAsynchCommit(), _env->isDurableNotify());
     return (SHELL_NEXT_CONTINUE);
 }
 
 void asynch_cmd_t::usage()
 {
     TRACE( TRACE_ALWAYS, "Asynch Usage:\n\n"       \
-           "*** asynch\n\n");
+           "*** asynch [durable]\n\n"               \
+           "Without argument toggles asynchronous commit.\n" \
+           "With \"durable\" the clients are acked at commit and notified\n" \
+           "separately when the xct becomes durable. The ack and durable\n" \
+           "latencies are reported by \"stats\".\n\n");
 }
 
 
 string asynch_cmd_t::desc() const
 {
-    return (string("Sets the fake log disk delay"));
+    return (string("Sets the commit mode"));
 }
 
 
@@ -1680,5 +1799,61 @@ string trxs_cmd_t::desc() const
 
 
 
+/*********************************************************************
+ *
+ *  "logstats" command
+ *
+ *  The log bytes and records per trx type and per table operation
+ *  (see shore_log_profile.h)
+ *
+ *********************************************************************/
+
+void logstats_cmd_t::setaliases() 
+{ 
+    _name = string("logstats"); 
+    _aliases.push_back("logstats"); 
+}
+
+int logstats_cmd_t::handle(const char* cmd) 
+{ 
+    char cmd_tag[SERVER_COMMAND_BUFFER_SIZE];
+    char mode_tag[SERVER_COMMAND_BUFFER_SIZE];
+
+    if ( sscanf(cmd, "%s %s", cmd_tag, mode_tag) < 2) {
+        _kit->print_log_profile();
+    }
+    else if (strcasecmp("reset", mode_tag) == 0) {
+        log_profile_t::reset();
+    }
+    else if (strcasecmp("on", mode_tag) == 0) {
+        log_profile_t::reset();
+        log_profile_t::set_enabled(true);
+    }
+    else if (strcasecmp("off", mode_tag) == 0) {
+        log_profile_t::set_enabled(false);
+    }
+    else {
+        usage();
+    }
+    return (SHELL_NEXT_CONTINUE); 
+}
+
+void logstats_cmd_t::usage() 
+{ 
+    TRACE( TRACE_ALWAYS, "LOGSTATS Usage:\n\n"                         \
+           "*** logstats [reset|on|off]\n"                              \
+           "\nParameters:\n"                                            \
+           "<none>  - Prints the log bytes and records per trx type and per table operation\n" \
+           "<reset> - Resets the counters\n"                            \
+           "<on|off> - Starts/stops profiling (see db-log-profile)\n\n");
+}
+
+string logstats_cmd_t::desc() const 
+{
+    return string("Prints the log volume per transaction type and per table operation");
+}
+
+
+
 EXIT_NAMESPACE(shore);
 
@@ -30,6 +30,8 @@
  */
 
 #include "sm/shore/shore_table.h"
+#include "sm/shore/shore_bulk_loader.h"
+#include "sm/shore/shore_load_cache.h"
 
 using namespace shore;
 
@@ -57,12 +59,16 @@ using namespace shore;
  ******************************************************************/
 
 
+bool table_desc_t::_track_versions = false;
+
+
 table_desc_t::table_desc_t(const char* name, int fieldcnt, uint4_t pd)
     : file_desc_t(name, fieldcnt, pd), _db(NULL),
       _indexes(NULL), _primary_idx(NULL),
       _maxsize(0),
       _sMinKey(NULL),_sMinKeyLen(0),
-      _sMaxKey(NULL),_sMaxKeyLen(0)
+      _sMaxKey(NULL),_sMaxKeyLen(0),
+      _rc_slots(0), _read_only(false), _version(0)
 {
     // Create placeholders for the field descriptors
     _desc = new field_desc_t[fieldcnt];
@@ -406,6 +412,83 @@ bool table_desc_t::create_primary_idx_desc(const char* name,
 }
 
 
+
+/****************************************************************** 
+ *  
+ *  @fn:    set_index_payload
+ *
+ *  @brief: Sets the fields carried by the entries of a (covering) index,
+ *          and their offsets in the disk format of the record
+ *
+ *  @note:  The fixed-length fields are laid out in the order of the 
+ *          fields, after the null bitmap (see table_man_t::format()).
+ *          Thus, the offset of a fixed-length field does not depend 
+ *          on the values of the record.
+ *
+ ******************************************************************/
+
+w_rc_t table_desc_t::set_index_payload(const char* idx_name,
+                                       const uint* fields,
+                                       const uint num)
+{
+    index_desc_t* pindex = find_index(idx_name);
+    assert (pindex);
+    assert (pindex->_payload == NULL);
+    assert (num>0);
+
+    // the size of the null bitmap
+    uint_t null_count = 0;
+    for (uint_t i=0; i<_field_count; i++) {
+        if (_desc[i].allow_null()) null_count++;
+    }
+    uint_t fixed_offset = 0;
+    if (null_count) fixed_offset = ((null_count-1) >> 3) + 1;
+
+    uint* pfields  = new uint[num];
+    uint_t* poffs  = new uint_t[num];
+    uint_t* psizes = new uint_t[num];
+    uint_t bytes = 0;
+
+    for (uint_t i=0; i<num; i++) {
+        assert (fields[i] < _field_count);
+        field_desc_t* pfd = &_desc[fields[i]];
+        if (pfd->is_variable_length() || pfd->allow_null()) {
+            TRACE( TRACE_ALWAYS, "(%s) payload field (%s) is not fixed\n",
+                   idx_name, pfd->name());
+            delete [] pfields;
+            delete [] poffs;
+            delete [] psizes;
+            return (RC(se_INVALID_INPUT));
+        }
+
+        uint_t off = fixed_offset;
+        for (uint_t j=0; j<fields[i]; j++) {
+            if (!_desc[j].is_variable_length()) off += _desc[j].fieldmaxsize();
+        }
+
+        pfields[i] = fields[i];
+        poffs[i] = off;
+        psizes[i] = pfd->fieldmaxsize();
+        bytes += psizes[i];
+    }
+
+    if (bytes > MAX_INDEX_PAYLOAD) {
+        TRACE( TRACE_ALWAYS, "(%s) payload too large (%d)\n", idx_name, bytes);
+        delete [] pfields;
+        delete [] poffs;
+        delete [] psizes;
+        return (RC(se_INVALID_INPUT));
+    }
+
+    pindex->_payload = pfields;
+    pindex->_payload_off = poffs;
+    pindex->_payload_sz = psizes;
+    pindex->_payload_cnt = num;
+    pindex->_payload_bytes = bytes;
+    return (RCOK);
+}
+
+
 // Returns the stid of the primary index. If no primary index exists it
 // returns the stid of the table
 stid_t table_desc_t::get_primary_stid()
@@ -732,6 +815,9 @@ bool table_man_t::load(table_tuple* ptuple,
 	    fixed_offset += ptuple->_pvalues[i].maxsize();
 	}
     }
+
+    // the tuple now matches the record
+    ptuple->clear_dirty();
     return (true);
 }
 
@@ -890,6 +976,97 @@ int table_man_t::key_size(index_desc_t* pindex,
 
 
 
+/****************************************************************** 
+ *
+ *  @fn:      format_el
+ *
+ *  @brief:   Writes the element of the entry of a row to an index: the
+ *            rid and, if the index is covering, the payload fields. 
+ *            Returns the size of the element, which is el_size().
+ *            The buffer should have at least MAX_INDEX_EL bytes.
+ *
+ *  @note:    The second version reads the payload fields straight out
+ *            of a record in disk format, e.g. the pinned record before
+ *            it gets updated.
+ *
+ ******************************************************************/
+
+int table_man_t::format_el(index_desc_t* pindex,
+                           const table_tuple* ptuple,
+                           char* el) const
+{
+    assert (pindex);
+    assert (ptuple);
+    assert (el);
+
+    memcpy(el, &(ptuple->_rid), sizeof(rid_t));
+    if (!pindex->is_covering()) return (sizeof(rid_t));
+
+    uint_t offset = sizeof(rid_t);
+    for (uint_t i=0; i<pindex->payload_count(); i++) {
+        ptuple->_pvalues[pindex->payload_index(i)].copy_value(el+offset);
+        offset += pindex->payload_sz(i);
+    }
+    return (offset);
+}
+
+int table_man_t::format_el(index_desc_t* pindex,
+                           const rid_t& rid,
+                           const char* rec,
+                           char* el) const
+{
+    assert (pindex);
+    assert (rec);
+    assert (el);
+
+    memcpy(el, &rid, sizeof(rid_t));
+    if (!pindex->is_covering()) return (sizeof(rid_t));
+
+    uint_t offset = sizeof(rid_t);
+    for (uint_t i=0; i<pindex->payload_count(); i++) {
+        memcpy(el+offset, rec+pindex->payload_off(i), pindex->payload_sz(i));
+        offset += pindex->payload_sz(i);
+    }
+    return (offset);
+}
+
+
+/****************************************************************** 
+ *
+ *  @fn:      load_el
+ *
+ *  @brief:   Given the element of an index entry, sets the rid and, if
+ *            the index is covering, the payload fields of the row.
+ *
+ *  @warning: This function should be the inverse of the format_el()
+ *            function changes to one of the two functions should be
+ *            mirrored to the other.
+ *
+ ******************************************************************/
+
+void table_man_t::load_el(index_desc_t* pindex,
+                          table_tuple* ptuple,
+                          const char* el)
+{
+    assert (pindex);
+    assert (ptuple);
+    assert (el);
+
+    rid_t rid;
+    memcpy(&rid, el, sizeof(rid_t));
+    ptuple->set_rid(rid);
+    if (!pindex->is_covering()) return;
+
+    uint_t offset = sizeof(rid_t);
+    for (uint_t i=0; i<pindex->payload_count(); i++) {
+        ptuple->_pvalues[pindex->payload_index(i)].set_value(el+offset, 
+                                                             pindex->payload_sz(i));
+        offset += pindex->payload_sz(i);
+    }
+}
+
+
+
 /* ---------------------------- */
 /* --- access through index --- */
 /* ---------------------------- */
@@ -911,6 +1088,7 @@ int table_man_t::get_pnum(index_desc_t* pindex,
 
 mcs_lock table_man_t::register_table_lock;
 std::map<stid_t, table_man_t*> table_man_t::stid_to_tableman;
+std::vector<rec_cache_t*> table_man_t::rec_caches_rw;
 
 void table_man_t::register_table_man()
 {
@@ -919,6 +1097,110 @@ void table_man_t::register_table_man()
 }
 
 
+/********************************************************************* 
+ *
+ *  @fn:    print_rec_cache_stats/reset_rec_cache_stats
+ *  
+ *  @brief: Hit rate of the record caches of all the registered tables
+ *
+ *********************************************************************/
+
+void table_man_t::print_rec_cache_stats()
+{
+    CRITICAL_SECTION(regtablecs,register_table_lock);
+    std::map<stid_t, table_man_t*>::iterator it;
+    for (it=stid_to_tableman.begin(); it!=stid_to_tableman.end(); ++it) {
+        if (it->second->rc()) {
+            it->second->rc()->print_stats(it->second->table()->name());
+        }
+    }
+}
+
+void table_man_t::reset_rec_cache_stats()
+{
+    CRITICAL_SECTION(regtablecs,register_table_lock);
+    std::map<stid_t, table_man_t*>::iterator it;
+    for (it=stid_to_tableman.begin(); it!=stid_to_tableman.end(); ++it) {
+        if (it->second->rc()) {
+            it->second->rc()->reset_stats();
+        }
+    }
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:    invalidate_rec_caches
+ *  
+ *  @brief: Invalidates the record caches of all the registered tables,
+ *          for example when the database is restored from a snapshot
+ *
+ *********************************************************************/
+
+void table_man_t::invalidate_rec_caches()
+{
+    CRITICAL_SECTION(regtablecs,register_table_lock);
+    std::map<stid_t, table_man_t*>::iterator it;
+    for (it=stid_to_tableman.begin(); it!=stid_to_tableman.end(); ++it) {
+        if (it->second->rc()) {
+            it->second->rc()->invalidate();
+        }
+    }
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:    print_log_stats/reset_log_stats
+ *  
+ *  @brief: Log profile of all the registered tables, per operation
+ *
+ *********************************************************************/
+
+void table_man_t::print_log_stats()
+{
+    CRITICAL_SECTION(regtablecs,register_table_lock);
+    std::map<stid_t, table_man_t*>::iterator it;
+    for (it=stid_to_tableman.begin(); it!=stid_to_tableman.end(); ++it) {
+        for (int op=0; op<LOP_COUNT; ++op) {
+            it->second->_log_ops[op].print(it->second->table()->name(),
+                                           LOG_OP_NAMES[op]);
+        }
+    }
+}
+
+void table_man_t::reset_log_stats()
+{
+    CRITICAL_SECTION(regtablecs,register_table_lock);
+    std::map<stid_t, table_man_t*>::iterator it;
+    for (it=stid_to_tableman.begin(); it!=stid_to_tableman.end(); ++it) {
+        for (int op=0; op<LOP_COUNT; ++op) {
+            it->second->_log_ops[op].reset();
+        }
+    }
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:    rec_cache_on_abort
+ *  
+ *  @brief: Invalidates the record caches of the tables that are not
+ *          read-only. Should be called after the rollback completes.
+ *
+ *  @note:  The list is set up when the table managers are constructed,
+ *          thus it is accessed without the lock
+ *
+ *********************************************************************/
+
+void table_man_t::rec_cache_on_abort()
+{
+    for (uint_t i=0; i<rec_caches_rw.size(); ++i) {
+        rec_caches_rw[i]->invalidate();
+    }
+}
+
+
 
 /*********************************************************************
  *
@@ -972,7 +1254,12 @@ w_rc_t table_man_t::index_probe(ss_m* db,
     uint4_t system_mode = pindex->get_pd();
 
     bool     found = false;
-    smsize_t len = sizeof(rid_t);
+    char     el[MAX_INDEX_EL];
+    smsize_t len = pindex->el_size();
+
+    // a probe for update is never served from the record cache, even if
+    // it is turned to NL below
+    const bool for_update = (lock_mode==EX);
 
     // if index created with NO-LOCK option (e.g., DORA) then:
     // - ignore lock mode (use NL)
@@ -987,6 +1274,25 @@ w_rc_t table_man_t::index_probe(ss_m* db,
     int key_sz = format_key(pindex, ptuple, *ptuple->_rep);
     assert (ptuple->_rep->_dest); // if NULL invalid key
 
+    // if the table has a record cache, try to serve the probe from it.
+    // a hit skips the record lock, so only NL probes (or any but EX
+    // probes on read-only tables) can be served, and never a probe for
+    // update
+    uint_t rcepoch = 0;
+    if (_prc) {
+        if (!for_update && 
+            ((lock_mode==NL) || (_ptable->is_read_only() && (lock_mode!=EX)))) {
+            rep_row_t arep(_pts);
+            arep.set(_ptable->maxsize());
+            if (_prc->lookup(pindex, ptuple->_rep->_dest, key_sz, 
+                             ptuple->_rid, arep._dest)) {
+                if (!load(ptuple, arep._dest)) return RC(se_WRONG_DISK_DATA);
+                return (RCOK);
+            }
+        }
+        rcepoch = _prc->epoch();
+    }
+
     int pnum = get_pnum(pindex, ptuple);
 
     if (pindex->is_mr()) {
@@ -1003,23 +1309,34 @@ w_rc_t table_man_t::index_probe(ss_m* db,
                                  ));
     }
     else {
+        // the element of a covering index carries also the payload
         W_DO(ss_m::find_assoc(pindex->fid(pnum),
                               vec_t(ptuple->_rep->_dest, key_sz),
-                              &(ptuple->_rid),
+                              el,
                               len,
                               found,
                               bIgnoreLocks
                               ));
+        if (found) memcpy(&(ptuple->_rid), el, sizeof(rid_t));
     }
 
     if (!found) return RC(se_TUPLE_NOT_FOUND);
 
+    // the version of the record, read before the record
+    uint_t rcver = (_prc ? _prc->version(ptuple->rid()) : 0);
+
     // read the tuple
     pin_i pin;
     latch_mode_t heap_latch_mode = LATCH_SH;
     if (system_mode & (PD_MRBT_PART | PD_MRBT_LEAF)) heap_latch_mode = LATCH_NLS;
     W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
 
+    // fill the record cache, if any, with the versions read before
+    if (_prc) {
+        _prc->fill(pindex, ptuple->_rep->_dest, key_sz, ptuple->rid(),
+                   pin.body(), pin.body_size(), rcepoch, rcver);
+    }
+
     if (!load(ptuple, pin.body())) {
         pin.unpin();
         return RC(se_WRONG_DISK_DATA);
@@ -1030,6 +1347,66 @@ w_rc_t table_man_t::index_probe(ss_m* db,
 
 
 
+/********************************************************************* 
+ *
+ *  @fn:    index_probe_covered
+ *  
+ *  @brief: Finds the entry of the specified key using a covering index, 
+ *          and loads the rid and the payload fields of the entry to the
+ *          tuple, without pinning the record
+ *
+ *  @note:  Only the key and the payload fields of the tuple are valid
+ *          afterwards. If the index is not covering (e.g. MRBT) it falls
+ *          back to index_probe().
+ *
+ *  @note:  The record is not locked, the key-value lock of the entry is.
+ *          Every update of a payload field deletes and inserts again the
+ *          entry (see _update_payloads()), thus the lock covers the 
+ *          payload as well.
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::index_probe_covered(ss_m* db,
+                                        index_desc_t* pindex,
+                                        table_tuple*  ptuple,
+                                        const lock_mode_t lock_mode,
+                                        const lpid_t& root)
+{
+    assert (_ptable);
+    assert (pindex);
+    assert (ptuple); 
+    assert (ptuple->_rep);
+
+    if (!pindex->is_covering()) {
+        return (index_probe(db, pindex, ptuple, lock_mode, root));
+    }
+
+    bool     found = false;
+    char     el[MAX_INDEX_EL];
+    smsize_t len = pindex->el_size();
+    bool bIgnoreLocks = pindex->is_relaxed();
+
+    int key_sz = format_key(pindex, ptuple, *ptuple->_rep);
+    assert (ptuple->_rep->_dest); // if NULL invalid key
+
+    int pnum = get_pnum(pindex, ptuple);
+    W_DO(ss_m::find_assoc(pindex->fid(pnum),
+                          vec_t(ptuple->_rep->_dest, key_sz),
+                          el,
+                          len,
+                          found,
+                          bIgnoreLocks
+                          ));
+
+    if (!found) return RC(se_TUPLE_NOT_FOUND);
+    if (len != pindex->el_size()) return RC(se_WRONG_DISK_DATA);
+
+    load_el(pindex, ptuple, el);
+    return (RCOK);
+}
+
+
+
 
 /* -------------------------- */
 /* --- tuple manipulation --- */
@@ -1057,6 +1434,8 @@ w_rc_t table_man_t::add_tuple(ss_m* db,
     assert (_ptable);
     assert (ptuple);
     assert (ptuple->_rep);
+    log_probe_t probe(&_log_ops[LOP_ADD_TUPLE]);
+    version_bump_t vbump(_ptable);
     uint4_t system_mode = _ptable->get_pd();
 
     if ((system_mode & (PD_MRBT_PART | PD_MRBT_LEAF)) &&
@@ -1073,6 +1452,8 @@ w_rc_t table_man_t::add_tuple(ss_m* db,
     int tsz = format(ptuple, *ptuple->_rep);
     assert (ptuple->_rep->_dest); // if NULL invalid
 
+    if (_pcache) _pcache->capture(this, ptuple->_rep->_dest, tsz);
+
     W_DO(db->create_rec(_ptable->fid(), 
                         vec_t(), 
                         tsz,
@@ -1081,6 +1462,81 @@ w_rc_t table_man_t::add_tuple(ss_m* db,
                         bIgnoreLocks
                         ));
 
+    return (_add_index_entries(db, ptuple, bIgnoreLocks, primary_root));
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:    add_formatted
+ *
+ *  @brief: Inserts a record, already in the format of format(), to a
+ *          table and all the indexes of the table
+ *
+ *  @note:  The record is loaded to the tuple, since the index keys are
+ *          formed out of the fields. This function should be called in
+ *          the context of a trx.
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::add_formatted(ss_m* db, 
+                                  table_tuple* ptuple,
+                                  const char* rec,
+                                  const uint_t recsz,
+                                  const lock_mode_t lock_mode,
+                                  const lpid_t& primary_root)
+{
+    assert (_ptable);
+    assert (ptuple);
+    assert (ptuple->_rep);
+    assert (rec);
+
+    if (!load(ptuple, rec)) return (RC(se_WRONG_DISK_DATA));
+    log_probe_t probe(&_log_ops[LOP_ADD_TUPLE]);
+    version_bump_t vbump(_ptable);
+
+    uint4_t system_mode = _ptable->get_pd();
+    if ((system_mode & (PD_MRBT_PART | PD_MRBT_LEAF)) &&
+	(_ptable->primary_idx() && _ptable->primary_idx()->is_latchless())) {
+        return (add_plp_tuple(db,ptuple,lock_mode,system_mode,primary_root));
+    }
+
+    bool bIgnoreLocks = false;
+    if (lock_mode==NL) bIgnoreLocks = true;
+
+    W_DO(db->create_rec(_ptable->fid(), 
+                        vec_t(), 
+                        recsz,
+                        vec_t(rec, recsz),
+                        ptuple->_rid,
+                        bIgnoreLocks
+                        ));
+
+    return (_add_index_entries(db, ptuple, bIgnoreLocks, primary_root));
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:    _add_index_entries
+ *
+ *  @brief: Inserts the entries of a just appended tuple to all the 
+ *          indexes of the table, or passes them to the bulk loader
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::_add_index_entries(ss_m* db, 
+                                       table_tuple* ptuple,
+                                       const bool bIgnoreLocks,
+                                       const lpid_t& primary_root)
+{
+    // in bulk-load mode the indexes are built at the end of the load
+    if (_pbulk) {
+        return (_pbulk->add_entries(ptuple));
+    }
+
     // update the indexes
     index_desc_t* index = _ptable->indexes();
     int ksz = 0;
@@ -1090,6 +1546,7 @@ w_rc_t table_man_t::add_tuple(ss_m* db,
         assert (ptuple->_rep->_dest); // if dest == NULL there is invalid key
 
 	int pnum = get_pnum(index, ptuple);
+        log_probe_t probe(&_log_ops[LOP_INDEX_INSERT]);
 
         if (index->is_mr()) {
 	    ss_m::RELOCATE_RECORD_CALLBACK_FUNC reloc_func = &relocate_records;
@@ -1105,9 +1562,11 @@ w_rc_t table_man_t::add_tuple(ss_m* db,
                                      ));
         }
         else {
+            char el[MAX_INDEX_EL];
+            int elsz = format_el(index, ptuple, el);
             W_DO(db->create_assoc(index->fid(pnum),
                                   vec_t(ptuple->_rep->_dest, ksz),
-                                  vec_t(&(ptuple->_rid), sizeof(rid_t)),
+                                  vec_t(el, elsz),
                                   bIgnoreLocks
                                   ));
         }
@@ -1157,6 +1616,7 @@ w_rc_t table_man_t::add_index_entry(ss_m* db,
     assert (ptuple->_rep->_dest); // if dest == NULL there is invalid key
     
     int pnum = get_pnum(pindex, ptuple);
+    log_probe_t probe(&_log_ops[LOP_INDEX_INSERT]);
 
     if (pindex->is_mr()) {
 	ss_m::RELOCATE_RECORD_CALLBACK_FUNC reloc_func = &relocate_records;
@@ -1172,9 +1632,11 @@ w_rc_t table_man_t::add_index_entry(ss_m* db,
 				 ));
     }
     else {
+	char el[MAX_INDEX_EL];
+	int elsz = format_el(pindex, ptuple, el);
 	W_DO(db->create_assoc(pindex->fid(pnum),
 			      vec_t(ptuple->_rep->_dest, ksz),
-			      vec_t(&(ptuple->_rid), sizeof(rid_t)),
+			      vec_t(el, elsz),
 			      bIgnoreLocks
 			      ));
     }
@@ -1382,9 +1844,11 @@ w_rc_t table_man_t::add_plp_tuple(ss_m* db,
                                      lpid_t::null));
         }
         else {
+            char el[MAX_INDEX_EL];
+            int elsz = format_el(index, ptuple, el);
             W_DO(db->create_assoc(index->fid(pnum),
                                   vec_t(ptuple->_rep_key->_dest, ksz),
-                                  vec_t(&(ptuple->_rid), sizeof(rid_t)),
+                                  vec_t(el, elsz),
                                   bIgnoreLocks
                                   ));
         }
@@ -1419,6 +1883,8 @@ w_rc_t table_man_t::delete_tuple(ss_m* db,
     assert (ptuple->_rep);
 
     if (!ptuple->is_rid_valid()) return RC(se_NO_CURRENT_TUPLE);
+    log_probe_t probe(&_log_ops[LOP_DELETE_TUPLE]);
+    version_bump_t vbump(_ptable);
 
     uint4_t system_mode = _ptable->get_pd();
     rid_t todelete = ptuple->rid();
@@ -1432,6 +1898,11 @@ w_rc_t table_man_t::delete_tuple(ss_m* db,
     index_desc_t* pindex = _ptable->indexes();
     int key_sz = 0;
 
+    // the record, if the payload of an entry has to be read. It is copied
+    // and unpinned, the page latch is not held while locking the keys
+    rep_row_t arec(_pts);
+    bool copied = false;
+
     while (pindex) {
         key_sz = format_key(pindex, ptuple, *ptuple->_rep);
         assert (ptuple->_rep->_dest); // if NULL invalid key
@@ -1447,9 +1918,20 @@ w_rc_t table_man_t::delete_tuple(ss_m* db,
                                       (pindex->is_primary() ? primary_root : lpid_t::null)));
         }
         else {
+            char el[MAX_INDEX_EL];
+            int elsz = format_el(pindex, ptuple, el);
+            if (pindex->is_covering() && ptuple->has_dirty()) {
+                // the payload fields of the tuple may have been changed
+                // since it was read, the entry carries those of the record
+                if (!copied) {
+                    W_DO(_copy_record(todelete, lock_mode, arec));
+                    copied = true;
+                }
+                elsz = format_el(pindex, todelete, arec._dest, el);
+            }
             W_DO(db->destroy_assoc(pindex->fid(pnum),
                                    vec_t(ptuple->_rep->_dest, key_sz),
-                                   vec_t(&(todelete), sizeof(rid_t)),
+                                   vec_t(el, elsz),
                                    bIgnoreLocks
                                    ));
         }
@@ -1470,6 +1952,11 @@ w_rc_t table_man_t::delete_tuple(ss_m* db,
         W_DO(db->destroy_rec(todelete, bIgnoreLocks));
     }
 
+    // invalidate the cached copies of the record, if any. It has to be
+    // done after the record is gone, otherwise a concurrent probe may
+    // re-fill it
+    if (_prc) _prc->invalidate(todelete);
+
     // invalidate tuple
     ptuple->set_rid(rid_t::null);
     return (RCOK);
@@ -1526,9 +2013,18 @@ w_rc_t table_man_t::delete_index_entry(ss_m* db,
 				  (pindex->is_primary() ? primary_root : lpid_t::null)));
     }
     else {
+	char el[MAX_INDEX_EL];
+	int elsz = format_el(pindex, ptuple, el);
+	if (pindex->is_covering() && ptuple->has_dirty()) {
+	    // the entry carries the payload fields of the record
+	    pin_i pin;
+	    W_DO(pin.pin(todelete, 0, lock_mode));
+	    elsz = format_el(pindex, todelete, pin.body(), el);
+	    pin.unpin();
+	}
 	W_DO(db->destroy_assoc(pindex->fid(pnum),
 			       vec_t(ptuple->_rep->_dest, key_sz),
-			       vec_t(&(todelete), sizeof(rid_t)),
+			       vec_t(el, elsz),
 			       bIgnoreLocks
 			       ));
     }
@@ -1549,14 +2045,15 @@ w_rc_t table_man_t::delete_index_entry(ss_m* db,
  *  @note:  This function should be called in the context of a trx.
  *          The passed tuple rid() should be valid. 
  *          There is no need of updating the indexes. That's why there
- *          is not parameter to primary_root.
+ *          is not parameter to primary_root. Only the entries of the
+ *          covering indexes whose payload changes are replaced.
  *
  *  !!! In order to update a field included by an index !!!
  *  !!! the tuple should be deleted and inserted again  !!!
  *
  *********************************************************************/
 
-w_rc_t table_man_t::update_tuple(ss_m* /* db */, 
+w_rc_t table_man_t::update_tuple(ss_m* db, 
                                  table_tuple* ptuple,
                                  const lock_mode_t  lock_mode) // physical_design_t
 {
@@ -1565,6 +2062,8 @@ w_rc_t table_man_t::update_tuple(ss_m* /* db */,
     assert (ptuple->_rep);
 
     if (!ptuple->is_rid_valid()) return RC(se_NO_CURRENT_TUPLE);
+    log_probe_t probe(&_log_ops[LOP_UPDATE_TUPLE]);
+    version_bump_t vbump(_ptable);
 
     uint4_t system_mode = _ptable->get_pd();
     bool bIgnoreLocks = false;
@@ -1577,15 +2076,20 @@ w_rc_t table_man_t::update_tuple(ss_m* /* db */,
         heap_latch_mode = LATCH_NLX;
     }
 
+    // the entries of the covering indexes carry the old payload. They are
+    // replaced before the record is pinned for the update, since the index
+    // key locks should not be waited for while holding the page latch
+    W_DO(_update_payloads(db, ptuple, lock_mode, bIgnoreLocks));
+
     // pin record
     pin_i pin;
     W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
     int current_size = pin.body_size();
 
-
     // update record
     int tsz = format(ptuple, *ptuple->_rep);
     assert (ptuple->_rep->_dest); // if NULL invalid
+    probe.set_payload(tsz);
 
     // a. if updated record cannot fit in the previous spot
     w_rc_t rc;
@@ -1617,6 +2121,12 @@ w_rc_t table_man_t::update_tuple(ss_m* /* db */,
     }
 
     if (rc.is_error()) TRACE( TRACE_DEBUG, "Error updating record\n");
+    else ptuple->clear_dirty();
+
+    // invalidate the cached copies of the record, if any. It has to be
+    // done after the record is updated, otherwise a concurrent probe may
+    // re-fill it
+    if (_prc) _prc->invalidate(ptuple->rid());
 
     // 3. unpin
     pin.unpin();
@@ -1627,40 +2137,592 @@ w_rc_t table_man_t::update_tuple(ss_m* /* db */,
 
 /********************************************************************* 
  *
- *  @fn:    read_tuple
+ *  @fn:    _has_dirty_payloads
  *
- *  @brief: Access a tuple directly through its RID
+ *  @brief: Whether the entry of any covering index has to be replaced,
+ *          that is whether any of its payload fields is dirty
  *
- *  @note:  This function should be called in the context of a trx
- *          The passed RID should be valid.
- *          No index probe its involved that's why it does not get
- *          any hint about the starting root pid.
+ *  @note:  The key fields are not updated in place, thus the entry is 
+ *          replaced under the same key. A caller that updates a key field
+ *          deletes the entry before the update and inserts it after, thus
+ *          the entries of an index with a dirty key field are left alone.
  *
  *********************************************************************/
 
-w_rc_t table_man_t::read_tuple(table_tuple* ptuple,
-                               lock_mode_t lock_mode,
-			       latch_mode_t heap_latch_mode)
+static bool _is_payload_dirty(index_desc_t* pindex, table_row_t* ptuple)
 {
-    assert (_ptable);
-    assert (ptuple);
+    if (!pindex->is_covering()) return (false);
 
-    if (!ptuple->is_rid_valid()) return RC(se_NO_CURRENT_TUPLE);
-
-    uint4_t system_mode = _ptable->get_pd();
-    if (system_mode & ( PD_MRBT_LEAF | PD_MRBT_PART) ) {
-        heap_latch_mode = LATCH_NLS;
-	lock_mode = NL;
+    bool dirty = ptuple->is_all_dirty();
+    for (uint_t i=0; (!dirty) && (i<pindex->payload_count()); i++) {
+        dirty = ptuple->is_dirty(pindex->payload_index(i));
     }
-
-    pin_i  pin;
-    W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
-    if (!load(ptuple, pin.body())) {
-        pin.unpin();
-        return RC(se_WRONG_DISK_DATA);
+    // if a key field is dirty as well, the caller has deleted the
+    // entry and inserts it again (see delete_index_entry())
+    for (uint_t i=0; dirty && (i<pindex->field_count()); i++) {
+        if (ptuple->is_dirty(pindex->key_index(i))) dirty = false;
     }
-    pin.unpin();
+    return (dirty);
+}
+
+bool table_man_t::_has_dirty_payloads(table_tuple* ptuple)
+{
+    if (!ptuple->has_dirty()) return (false);
 
+    for (index_desc_t* pindex = _ptable->indexes(); pindex; pindex = pindex->next()) {
+        if (_is_payload_dirty(pindex, ptuple)) return (true);
+    }
+    return (false);
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:    _copy_record
+ *
+ *  @brief: Copies the record out of its page. The record is locked in
+ *          lock_mode, but the page is unlatched on return.
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::_copy_record(const rid_t& rid,
+                                 const lock_mode_t lock_mode,
+                                 rep_row_t& arep)
+{
+    latch_mode_t heap_latch_mode = LATCH_SH;
+    if (_ptable->get_pd() & (PD_MRBT_PART | PD_MRBT_LEAF)) heap_latch_mode = LATCH_NLS;
+
+    pin_i pin;
+    W_DO(pin.pin(rid, 0, lock_mode, heap_latch_mode));
+    arep.set(pin.body_size());
+    memcpy(arep._dest, pin.body(), pin.body_size());
+    pin.unpin();
+    return (RCOK);
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:    _update_payloads
+ *
+ *  @brief: Replaces the entries of the covering indexes whose payload
+ *          fields are dirty in the tuple. The old entries are formed out
+ *          of a copy of the record before it gets updated.
+ *
+ *  @note:  The record is copied and unpinned before any index entry is
+ *          touched, thus no page latch is held while waiting for the
+ *          key locks. The record lock (lock_mode) keeps it from changing
+ *          until the caller updates it.
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::_update_payloads(ss_m* db, 
+                                     table_tuple* ptuple,
+                                     const lock_mode_t lock_mode,
+                                     const bool bIgnoreLocks)
+{
+    if (!_has_dirty_payloads(ptuple)) return (RCOK);
+
+    rep_row_t arec(_pts);
+    W_DO(_copy_record(ptuple->rid(), lock_mode, arec));
+    const char* oldrec = arec._dest;
+
+    rep_row_t akey(_pts);
+    index_desc_t* pindex = _ptable->indexes();
+
+    while (pindex) {
+        if (_is_payload_dirty(pindex, ptuple)) {
+            char oldel[MAX_INDEX_EL];
+            char newel[MAX_INDEX_EL];
+            int elsz = format_el(pindex, ptuple->rid(), oldrec, oldel);
+            format_el(pindex, ptuple, newel);
+
+            if (memcmp(oldel, newel, elsz) != 0) {
+                int ksz = format_key(pindex, ptuple, akey);
+                int pnum = get_pnum(pindex, ptuple);
+                W_DO(db->destroy_assoc(pindex->fid(pnum),
+                                       vec_t(akey._dest, ksz),
+                                       vec_t(oldel, elsz),
+                                       bIgnoreLocks));
+                W_DO(db->create_assoc(pindex->fid(pnum),
+                                      vec_t(akey._dest, ksz),
+                                      vec_t(newel, elsz),
+                                      bIgnoreLocks));
+            }
+        }
+	pindex = pindex->next();
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:    update_dirty
+ *
+ *  @brief: Updates a tuple from a table, using direct access through
+ *          its RID, but writes only the fields set since the tuple was
+ *          loaded. Thus, only the changed bytes are logged.
+ *
+ *  @note:  The fixed-length fields which are not nullable are at the
+ *          same offset of the record whatever the values of the other
+ *          fields. If any other field is dirty, the whole record is
+ *          written by update_tuple(). Adjacent dirty fields are written
+ *          by one partial update.
+ *
+ *  !!! As with update_tuple(), fields included by an index !!!
+ *  !!! should not be updated this way                      !!!
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::update_dirty(ss_m* db, 
+                                 table_tuple* ptuple,
+                                 const lock_mode_t  lock_mode)
+{
+    assert (_ptable);
+    assert (ptuple);
+    assert (ptuple->_rep);
+
+    if (!ptuple->is_rid_valid()) return RC(se_NO_CURRENT_TUPLE);
+    if (ptuple->is_all_dirty()) return (update_tuple(db, ptuple, lock_mode));
+
+    // 1. copy the dirty fields to their offsets, and find the ranges
+    ptuple->_rep->set(_ptable->maxsize());
+    offset_t range_begin[ROW_DIRTY_BITS];
+    offset_t range_end[ROW_DIRTY_BITS];
+    uint_t ranges = 0;
+
+    offset_t fixed_offset = ptuple->get_fixed_offset();
+    for (uint_t i=0; i<_ptable->field_count(); i++) {
+        field_value_t& fv = ptuple->_pvalues[i];
+        bool dirty = ptuple->is_dirty(i);
+
+        if (fv.is_variable_length()) {
+            if (dirty) return (update_tuple(db, ptuple, lock_mode));
+            continue;
+        }
+
+        offset_t sz = fv.maxsize();
+        if (dirty) {
+            if (fv.field_desc()->allow_null()) {
+                return (update_tuple(db, ptuple, lock_mode));
+            }
+            fv.copy_value(ptuple->_rep->_dest + fixed_offset);
+            if (ranges && (range_end[ranges-1] == fixed_offset)) {
+                range_end[ranges-1] += sz;
+            }
+            else {
+                range_begin[ranges] = fixed_offset;
+                range_end[ranges] = fixed_offset + sz;
+                ++ranges;
+            }
+        }
+        fixed_offset += sz;
+    }
+
+    if (ranges == 0) return (RCOK);
+
+    log_probe_t probe(&_log_ops[LOP_UPDATE_DIRTY]);
+    version_bump_t vbump(_ptable);
+
+    uint4_t system_mode = _ptable->get_pd();
+    bool bIgnoreLocks = false;
+    if (lock_mode==NL) bIgnoreLocks = true;
+
+    bool no_heap_latch = false;   
+    latch_mode_t heap_latch_mode = LATCH_EX;
+    if (system_mode & ( PD_MRBT_LEAF | PD_MRBT_PART) ) {
+        no_heap_latch = true;
+        heap_latch_mode = LATCH_NLX;
+    }
+
+    // 2. replace the covering index entries (see update_tuple()), then
+    //    pin record
+    W_DO(_update_payloads(db, ptuple, lock_mode, bIgnoreLocks));
+    pin_i pin;
+    W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
+
+    // 3. write the ranges
+    w_rc_t rc;
+    uint_t written = 0;
+    for (uint_t r=0; r<ranges; r++) {
+        vec_t arange(ptuple->_rep->_dest + range_begin[r], 
+                     range_end[r] - range_begin[r]);
+        if (no_heap_latch) {
+            rc = pin.update_mrbt_rec(range_begin[r], arange, bIgnoreLocks, true);
+        } else {
+            rc = pin.update_rec(range_begin[r], arange, bIgnoreLocks);
+        }
+        if (rc.is_error()) break;
+        written += (range_end[r] - range_begin[r]);
+    }
+    probe.set_payload(written);
+
+    if (rc.is_error()) TRACE( TRACE_DEBUG, "Error updating record\n");
+    else ptuple->clear_dirty();
+
+    if (_prc) _prc->invalidate(ptuple->rid());
+
+    // 4. unpin
+    pin.unpin();
+    return (rc);
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:    read_tuple
+ *
+ *  @brief: Access a tuple directly through its RID
+ *
+ *  @note:  This function should be called in the context of a trx
+ *          The passed RID should be valid.
+ *          No index probe its involved that's why it does not get
+ *          any hint about the starting root pid.
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::read_tuple(table_tuple* ptuple,
+                               lock_mode_t lock_mode,
+			       latch_mode_t heap_latch_mode)
+{
+    assert (_ptable);
+    assert (ptuple);
+
+    if (!ptuple->is_rid_valid()) return RC(se_NO_CURRENT_TUPLE);
+
+    uint4_t system_mode = _ptable->get_pd();
+    if (system_mode & ( PD_MRBT_LEAF | PD_MRBT_PART) ) {
+        heap_latch_mode = LATCH_NLS;
+	lock_mode = NL;
+    }
+
+    pin_i  pin;
+    W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
+    if (!load(ptuple, pin.body())) {
+        pin.unpin();
+        return RC(se_WRONG_DISK_DATA);
+    }
+    pin.unpin();
+
+    return (RCOK);
+}
+
+
+
+/* --------------------------------------------- */
+/* --- fixed-layout (zero-copy) row accesses --- */
+/* --------------------------------------------- */
+
+
+/********************************************************************* 
+ *
+ *  @fn:    set_fixed_layout
+ *
+ *  @brief: Checks that all the fields are of fixed length and not
+ *          nullable, and that they add up to recsz bytes. If so, it 
+ *          computes the offset of each field in the disk format.
+ *
+ *********************************************************************/
+
+bool table_man_t::set_fixed_layout(const uint_t recsz)
+{
+    assert (_ptable);
+
+    std::vector<offset_t> offs;
+    offset_t offset = 0;
+    for (uint_t i=0; i<_ptable->field_count(); i++) {
+        field_desc_t* pfd = _ptable->desc(i);
+        if (pfd->allow_null() || pfd->is_variable_length()) {
+            TRACE( TRACE_ALWAYS, "(%s) field (%s) is not fixed\n",
+                   _ptable->name(), pfd->name());
+            return (false);
+        }
+        offs.push_back(offset);
+        offset += pfd->fieldmaxsize();
+    }
+
+    if ((offset != recsz) || (_ptable->maxsize() != recsz)) {
+        TRACE( TRACE_ALWAYS, "(%s) layout size mismatch (%d) (%d)\n",
+               _ptable->name(), offset, recsz);
+        return (false);
+    }
+
+    _fixed_off = offs;
+    return (true);
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:    format_key_fixed/get_pnum_fixed
+ *
+ *  @brief: Same as format_key() and get_pnum(), but the key fields
+ *          are read directly from a fixed-layout record
+ *
+ *********************************************************************/
+
+int table_man_t::format_key_fixed(index_desc_t* pindex,
+                                  const char* rec,
+                                  rep_row_t& arep)
+{
+    assert (is_fixed_layout());
+    assert (pindex);
+    assert (rec);
+
+    int isz = _ptable->index_maxkeysize(pindex);
+    arep.set(isz);
+
+    offset_t offset = 0;
+    for (uint_t i=0; i<pindex->field_count(); i++) {
+        int ix = pindex->key_index(i);
+        uint_t sz = _ptable->desc(ix)->fieldmaxsize();
+        memcpy(arep._dest+offset, rec+_fixed_off[ix], sz);
+        offset += sz;
+    }
+    return (isz);
+}
+
+int table_man_t::get_pnum_fixed(index_desc_t* pindex, 
+                                const char* rec) const
+{
+    assert (pindex);
+    if (!pindex->is_partitioned()) return (0);
+
+    int first_key;
+    memcpy(&first_key, rec+_fixed_off[pindex->key_index(0)], sizeof(int));
+    return (first_key % pindex->get_partition_count());
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:    index_probe_fixed
+ *
+ *  @brief: Probes the index with the key fields of the passed record.
+ *          If found, the record is copied as-is from the pinned page
+ *          (or the record cache) to rec, without calling load().
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::index_probe_fixed(ss_m* /* db */,
+                                      index_desc_t* pindex,
+                                      char*         rec,
+                                      const uint_t  recsz,
+                                      rid_t&        rid,
+                                      lock_mode_t   lock_mode,
+                                      const lpid_t& root)
+{
+    assert (_ptable);
+    assert (pindex);
+    assert (rec);
+
+    uint4_t system_mode = pindex->get_pd();
+
+    bool     found = false;
+    char     el[MAX_INDEX_EL];
+    smsize_t len = pindex->el_size();
+
+    const bool for_update = (lock_mode==EX);
+    bool bIgnoreLocks = false;
+    if (pindex->is_relaxed()) {
+        lock_mode   = NL;
+        bIgnoreLocks = true;
+    }
+
+    rep_row_t akey(_pts);
+    int key_sz = format_key_fixed(pindex, rec, akey);
+
+    // record cache, same rules as in index_probe()
+    uint_t rcepoch = 0;
+    if (_prc) {
+        if (!for_update && 
+            ((lock_mode==NL) || (_ptable->is_read_only() && (lock_mode!=EX)))) {
+            if (_prc->lookup(pindex, akey._dest, key_sz, rid, rec)) {
+                return (RCOK);
+            }
+        }
+        rcepoch = _prc->epoch();
+    }
+
+    int pnum = get_pnum_fixed(pindex, rec);
+
+    if (pindex->is_mr()) {
+        W_DO(ss_m::find_mr_assoc(pindex->fid(pnum),
+                                 vec_t(akey._dest, key_sz),
+                                 &rid, len, found,
+                                 bIgnoreLocks,
+                                 pindex->is_latchless(),
+                                 root));
+    }
+    else {
+        W_DO(ss_m::find_assoc(pindex->fid(pnum),
+                              vec_t(akey._dest, key_sz),
+                              el, len, found,
+                              bIgnoreLocks));
+        if (found) memcpy(&rid, el, sizeof(rid_t));
+    }
+
+    if (!found) return RC(se_TUPLE_NOT_FOUND);
+
+    uint_t rcver = (_prc ? _prc->version(rid) : 0);
+
+    pin_i pin;
+    latch_mode_t heap_latch_mode = LATCH_SH;
+    if (system_mode & (PD_MRBT_PART | PD_MRBT_LEAF)) heap_latch_mode = LATCH_NLS;
+    W_DO(pin.pin(rid, 0, lock_mode, heap_latch_mode));
+
+    if ((uint_t)pin.body_size() != recsz) {
+        pin.unpin();
+        return RC(se_WRONG_DISK_DATA);
+    }
+
+    if (_prc) {
+        _prc->fill(pindex, akey._dest, key_sz, rid,
+                   pin.body(), recsz, rcepoch, rcver);
+    }
+
+    memcpy(rec, pin.body(), recsz);
+    pin.unpin();
+    return (RCOK);
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:    update_fixed
+ *
+ *  @brief: Writes only the len bytes at offset of the record. Only
+ *          those bytes are logged.
+ *
+ *  @note:  As with update_tuple(), fields included by an index should
+ *          not be updated this way. Neither should the payload fields of
+ *          a covering index, since their entries are not replaced.
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::update_fixed(ss_m* /* db */,
+                                 const rid_t& rid,
+                                 const char*  rec,
+                                 const uint_t offset,
+                                 const uint_t len,
+                                 const lock_mode_t lock_mode)
+{
+    assert (_ptable);
+    assert (rec);
+
+    if (rid == rid_t::null) return RC(se_NO_CURRENT_TUPLE);
+    log_probe_t probe(&_log_ops[LOP_UPDATE_FIXED]);
+    version_bump_t vbump(_ptable);
+    probe.set_payload(len);
+
+    uint4_t system_mode = _ptable->get_pd();
+    bool bIgnoreLocks = false;
+    if (lock_mode==NL) bIgnoreLocks = true;
+
+    bool no_heap_latch = false;   
+    latch_mode_t heap_latch_mode = LATCH_EX;
+    if (system_mode & ( PD_MRBT_LEAF | PD_MRBT_PART) ) {
+        no_heap_latch = true;
+        heap_latch_mode = LATCH_NLX;
+    }
+
+    pin_i pin;
+    W_DO(pin.pin(rid, 0, lock_mode, heap_latch_mode));
+
+    w_rc_t rc;
+    if (no_heap_latch) {
+        rc = pin.update_mrbt_rec(offset, vec_t(rec+offset, len),
+                                 bIgnoreLocks, true);
+    } else {
+        rc = pin.update_rec(offset, vec_t(rec+offset, len), bIgnoreLocks);
+    }
+
+    if (rc.is_error()) TRACE( TRACE_DEBUG, "Error updating record\n");
+
+    if (_prc) _prc->invalidate(rid);
+
+    pin.unpin();
+    return (rc);
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:    add_fixed
+ *
+ *  @brief: Inserts a fixed-layout record and its index entries
+ *
+ *  @note:  The PLP (latch-less heap) insertions go through add_tuple()
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::add_fixed(ss_m* db,
+                              const char*  rec,
+                              const uint_t recsz,
+                              rid_t&       rid,
+                              const lock_mode_t lock_mode,
+                              const lpid_t& primary_root)
+{
+    assert (_ptable);
+    assert (rec);
+
+    uint4_t system_mode = _ptable->get_pd();
+    if ((system_mode & (PD_MRBT_PART | PD_MRBT_LEAF)) &&
+	(_ptable->primary_idx() && _ptable->primary_idx()->is_latchless())) {
+        return RC(se_CANNOT_INSERT_TUPLE);
+    }
+
+    bool bIgnoreLocks = false;
+    if (lock_mode==NL) bIgnoreLocks = true;
+
+    log_probe_t probe(&_log_ops[LOP_ADD_TUPLE]);
+    version_bump_t vbump(_ptable);
+    W_DO(db->create_rec(_ptable->fid(), 
+                        vec_t(), 
+                        recsz,
+                        vec_t(rec, recsz),
+                        rid,
+                        bIgnoreLocks
+                        ));
+
+    rep_row_t akey(_pts);
+    index_desc_t* index = _ptable->indexes();
+    int ksz = 0;
+
+    while (index) {
+        ksz = format_key_fixed(index, rec, akey);
+	int pnum = get_pnum_fixed(index, rec);
+        log_probe_t iprobe(&_log_ops[LOP_INDEX_INSERT]);
+
+        if (index->is_mr()) {
+	    ss_m::RELOCATE_RECORD_CALLBACK_FUNC reloc_func = &relocate_records;
+            el_filler ef;
+            ef._el.put(vec_t(&rid, sizeof(rid_t)));
+            W_DO(db->create_mr_assoc(index->fid(pnum),
+                                     vec_t(akey._dest, ksz),
+                                     ef,
+                                     bIgnoreLocks,
+                                     bIgnoreLocks && index->is_latchless(),
+                                     reloc_func,
+                                     (index->is_primary() ? primary_root : lpid_t::null)
+                                     ));
+        }
+        else {
+            char el[MAX_INDEX_EL];
+            int elsz = format_el(index, rid, rec, el);
+            W_DO(db->create_assoc(index->fid(pnum),
+                                  vec_t(akey._dest, ksz),
+                                  vec_t(el, elsz),
+                                  bIgnoreLocks
+                                  ));
+        }
+	index = index->next();
+    }
     return (RCOK);
 }
 
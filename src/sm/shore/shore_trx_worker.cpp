@@ -32,6 +32,7 @@
 
 #include "sm/shore/shore_trx_worker.h"
 #include "sm/shore/shore_env.h"
+#include "sm/shore/shore_log_profile.h"
 
 ENTER_NAMESPACE(shore);
 
@@ -50,6 +51,7 @@ trx_worker_t::trx_worker_t(ShoreEnv* env, c_str tname,
     : base_worker_t(env, tname, aprsid, use_sli)
 { 
     assert (env);
+    _log_consolidate = (envVar::instance()->getVarInt("db-log-consolidate",0) == 1);
     _actionpool = new Pool(sizeof(Request*),REQUESTS_PER_WORKER_POOL_SZ);
     _pqueue = new Queue( _actionpool.get() );
 }
@@ -145,10 +147,38 @@ int trx_worker_t::_serve_action(Request* prequest)
     TRACE( TRACE_TRX_FLOW, "Begin (%d)\n", atid.get_lo());
     prequest->_xct = pxct;
     prequest->_tid = atid;
+
+    // with the flusher the request may be gone after it runs
+    int xct_type = prequest->type();
+
+#ifdef USE_SHORE_6
+    // Reserve the expected log space of the xct at once
+    if (_log_consolidate) {
+        long estimate = _log_estimate[xct_type];
+        if (estimate > 0) {
+            stopwatch_t reserve_time;
+            w_rc_t e = _env->db()->xct_reserve_log_space(estimate);
+            _stats._log_reserve_us += reserve_time.time_us();
+            ++_stats._log_reserves;
+            if (e.is_error()) {
+                TRACE( TRACE_TRX_FLOW, "Problem reserving log (%ld) [0x%x]\n",
+                       estimate, e.err_num());
+            }
+        }
+    }
+#endif
+    uint64_t log_before = log_profile_t::my_log_bytes();
+    uint64_t logrec_before = log_profile_t::my_log_records();
             
     // Serve request
     {
     w_rc_t e = _env->run_one_xct(prequest);
+    uint64_t log_used = log_profile_t::my_log_bytes() - log_before;
+    _stats._log_bytes += log_used;
+    if (log_profile_t::is_enabled()) {
+        log_profile_t::add_xct(xct_type, log_used,
+                               log_profile_t::my_log_records() - logrec_before);
+    }
     if (e.is_error()) {
         TRACE( TRACE_TRX_FLOW, "Problem running xct (%d) (%d) [0x%x]\n",
                prequest->_tid.get_lo(), prequest->_xct_id, e.err_num());
@@ -157,6 +187,14 @@ int trx_worker_t::_serve_action(Request* prequest)
     }
     }
 
+    // Update the estimate with the log this xct actually inserted
+    if (_log_consolidate) {
+        long used = (long)(log_profile_t::my_log_bytes() - log_before);
+        long& estimate = _log_estimate[xct_type];
+        estimate = (estimate == 0 ? used : 
+                    (estimate*(LOG_ESTIMATE_HISTORY-1) + used)/LOG_ESTIMATE_HISTORY);
+    }
+
     // Update worker stats
     ++_stats._processed;    
     return (0);
@@ -0,0 +1,286 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_warmup.cpp
+ *
+ *  @brief:  Implementation of the parallel buffer pool warmup
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include <unistd.h>
+
+#include "sm/shore/shore_warmup.h"
+
+using namespace shore;
+
+
+ENTER_NAMESPACE(shore);
+
+
+
+/******************************************************************
+ *
+ *  @class: warmup_smt_t
+ *
+ *  @brief: Thread that reads units out of the common list
+ *
+ ******************************************************************/
+
+class warmup_smt_t : public thread_t
+{
+private:
+    warmup_t* _pwarmup;
+    w_rc_t    _rc;
+public:
+    warmup_smt_t(warmup_t* pwarmup, const int id)
+        : thread_t(c_str("WARM-%d",id)), _pwarmup(pwarmup) { }
+    virtual void work() { _rc = _pwarmup->read_units(); }
+    w_rc_t rc() const { return (_rc); }
+};
+
+
+
+/******************************************************************
+ *
+ *  @fn:    Construction
+ *
+ *  @brief: The capacity of the buffer pool is taken from the SM. If
+ *          the SM does not report it, from the configured bufpoolsize.
+ *          If that is not set either, the warmup is not bounded.
+ *
+ ******************************************************************/
+
+warmup_t::warmup_t(ss_m* db)
+    : _db(db), _next(0), _pages(0), _done(0), _failed(0),
+      _bp_pages(0), _page_size(0)
+{
+    assert (_db);
+
+    sm_config_info_t info;
+    if (!ss_m::config_info(info).is_error() && info.page_size) {
+        _bp_pages = (uint_t)((info.buffer_pool_size*1024ULL)/info.page_size);
+        _page_size = info.page_size;
+    }
+    else {
+        int bpkb = envVar::instance()->getSysVarInt("bufpoolsize");
+        if (bpkb > 0) _bp_pages = (uint_t)((bpkb*1024ULL)/8192);
+        TRACE( TRACE_ALWAYS, "No SM config info, bufpool (%d) pages\n", _bp_pages);
+    }
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    add_registered_tables
+ *
+ *  @brief: The index partitions of all the tables go first, then
+ *          the heap files
+ *
+ ******************************************************************/
+
+void warmup_t::add_registered_tables()
+{
+    std::vector<unit_t> heaps;
+
+    CRITICAL_SECTION(regtablecs,table_man_t::register_table_lock);
+    std::map<stid_t, table_man_t*>::iterator it;
+    for (it=table_man_t::stid_to_tableman.begin(); 
+         it!=table_man_t::stid_to_tableman.end(); ++it) {
+        table_desc_t* ptable = it->second->table();
+
+        for (index_desc_t* pidx = ptable->indexes(); pidx; pidx = pidx->next()) {
+            for (int pnum=0; pnum<pidx->get_partition_count(); ++pnum) {
+                unit_t u = { ptable, pidx, pnum, pidx->fid(pnum) };
+                _units.push_back(u);
+            }
+        }
+
+        unit_t u = { ptable, NULL, 0, ptable->fid() };
+        heaps.push_back(u);
+    }
+
+    _units.insert(_units.end(), heaps.begin(), heaps.end());
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    run
+ *
+ *  @brief: Forks the threads and reports the warm percentage of the
+ *          buffer pool every second, until all the threads are done
+ *
+ ******************************************************************/
+
+w_rc_t warmup_t::run(const int threads)
+{
+    assert (threads>0);
+
+    TRACE( TRACE_ALWAYS, "Warming up (%d) stores with (%d) threads, bufpool (%d) pages\n",
+           (int)_units.size(), threads, _bp_pages);
+
+    stopwatch_t timer;
+
+    array_guard_t< guard<warmup_smt_t> > warmers(new guard<warmup_smt_t>[threads]);
+    for (int i=0; i<threads; i++) {
+        warmers[i] = new warmup_smt_t(this, i);
+        warmers[i]->fork();
+    }
+
+    while (*&_done < (uint_t)threads) {
+        sleep(1);
+        TRACE( TRACE_ALWAYS, "Warm (%.1f%%) pages (%d)\n",
+               (warm_pct()>100 ? 100 : warm_pct()), *&_pages);
+    }
+
+    w_rc_t rc = RCOK;
+    for (int i=0; i<threads; i++) {
+        warmers[i]->join();
+        if (warmers[i]->rc().is_error()) rc = warmers[i]->rc();
+    }
+
+    double secs = timer.time();
+    TRACE( TRACE_ALWAYS, "Warmup pages (%d) secs (%.1f) pages/s (%.0f) bufpool warm (%.1f%%)%s\n",
+           _pages, secs, (secs>0 ? _pages/secs : 0),
+           (warm_pct()>100 ? 100 : warm_pct()),
+           (is_full() ? " full" : ""));
+    if (_failed) {
+        TRACE( TRACE_ALWAYS, "Warmup skipped (%d) stores that failed\n", _failed);
+    }
+    return (rc);
+}
+
+
+
+/******************************************************************
+ *
+ *  @fn:    read_units
+ *
+ *  @brief: Takes units from the list until there is none left or
+ *          the buffer pool is full
+ *
+ ******************************************************************/
+
+w_rc_t warmup_t::read_units()
+{
+    while (!is_full()) {
+        uint_t iunit = atomic_inc_uint_nv(&_next) - 1;
+        if (iunit >= _units.size()) break;
+
+        // a unit that fails is skipped, the rest still get warmed
+        const unit_t& u = _units[iunit];
+        w_rc_t rc = _read_unit(u);
+        if (rc.is_error()) {
+            TRACE( TRACE_ALWAYS, "Warming up (%s) pnum (%d) failed (%x)\n",
+                   (u._pidx ? u._pidx->name() : u._ptable->name()),
+                   u._pnum, rc.err_num());
+            atomic_inc_uint(&_failed);
+        }
+    }
+    atomic_inc_uint(&_done);
+    return (RCOK);
+}
+
+
+// Reads a store in a xct of its own
+w_rc_t warmup_t::_read_unit(const unit_t& u)
+{
+    W_DO(_db->begin_xct());
+
+    uint_t cnt = 0;
+    w_rc_t e = (u._pidx ? _read_index(u, cnt) : _read_heap(u, cnt));
+
+    if (e.is_error()) {
+        W_IGNORE(_db->abort_xct());
+        return (e);
+    }
+    W_DO(_db->commit_xct());
+
+    TRACE( TRACE_DEBUG, "%s:%d pages (pnum: %d)\n",
+           (u._pidx ? u._pidx->name() : u._ptable->name()), cnt, u._pnum);
+    return (RCOK);
+}
+
+
+// Reads the pages of a heap file in file order, with prefetching
+w_rc_t warmup_t::_read_heap(const unit_t& u, uint_t& cnt)
+{
+    bool eof = false;
+    pin_i* handle;
+    w_rc_t e = RCOK;
+    {
+        scan_file_i scan(u._fid, ss_m::t_cc_none, true);
+        while (!eof) {
+            e = scan.next_page(handle, 0, eof);
+            if (e.is_error()) break;
+            if (eof) break;
+            if ((++cnt % WARMUP_CHECK_CNT) == 0) {
+                atomic_add_int(&_pages, WARMUP_CHECK_CNT);
+                if (is_full()) break;
+            }
+        }
+    }
+    atomic_add_int(&_pages, cnt % WARMUP_CHECK_CNT);
+    return (e);
+}
+
+
+// Reads the leaf pages of a B-tree, by a cursor over all its entries.
+// The cursor does not tell the pages it visits, thus they are counted
+// from the bytes of the entries read.
+w_rc_t warmup_t::_read_index(const unit_t& u, uint_t& cnt)
+{
+    const uint_t ent_bytes = u._pidx->get_keysize() + u._pidx->el_size();
+    const uint_t page_size = (_page_size ? _page_size : 8192);
+    uint64_t bytes = 0;
+
+    bool eof = false;
+    w_rc_t e = RCOK;
+    {
+        scan_index_i scan(u._fid,
+                          scan_index_i::ge, vec_t::neg_inf,
+                          scan_index_i::le, vec_t::pos_inf,
+                          false, ss_m::t_cc_none);
+        while (!eof) {
+            e = scan.next(eof);
+            if (e.is_error()) break;
+            if (eof) break;
+            bytes += ent_bytes;
+            if (bytes >= page_size) {
+                bytes -= page_size;
+                if ((++cnt % WARMUP_CHECK_CNT) == 0) {
+                    atomic_add_int(&_pages, WARMUP_CHECK_CNT);
+                    if (is_full()) break;
+                }
+            }
+        }
+    }
+    atomic_add_int(&_pages, cnt % WARMUP_CHECK_CNT);
+    return (e);
+}
+
+
+EXIT_NAMESPACE(shore);
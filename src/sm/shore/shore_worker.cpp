@@ -104,6 +104,16 @@ void worker_stats_t::print_stats() const
     TRACE( TRACE_STATISTICS, "Failed sleep   (%d) \t%.1f%%\n", 
            _failed_sleep, (double)(100*_failed_sleep)/(double)_processed);
 
+    // How much log this worker inserted, and, if the log space of each xct
+    // is reserved once at begin (db-log-consolidate), how long it waited 
+    // for those reservations
+    TRACE( TRACE_STATISTICS, "Log bytes       (%lld) \t%.0f/xct\n", 
+           (long long)_log_bytes, (double)_log_bytes/(double)executed);
+    if (_log_reserves) {
+        TRACE( TRACE_STATISTICS, "Log reserves    (%d) \t%.2fus\n", 
+               _log_reserves, (double)_log_reserve_us/(double)_log_reserves);
+    }
+
 
 #ifdef WORKER_VERBOSE_STATS
 
@@ -149,6 +159,10 @@ worker_stats_t::operator+= (worker_stats_t const& rhs)
     _early_aborts += rhs._early_aborts;
     _mid_aborts += rhs._mid_aborts;
 
+    _log_bytes += rhs._log_bytes;
+    _log_reserves += rhs._log_reserves;
+    _log_reserve_us += rhs._log_reserve_us;
+
 #ifdef WORKER_VERBOSE_STATS
     _waiting_total += rhs._waiting_total;
     _serving_total += rhs._serving_total;
@@ -182,6 +196,10 @@ void worker_stats_t::reset()
     _early_aborts = 0;
     _mid_aborts = 0;
 
+    _log_bytes = 0;
+    _log_reserves = 0;
+    _log_reserve_us = 0;
+
 #ifdef WORKER_VERBOSE_STATS
     _waiting_total = 0;
     _serving_total = 0;
@@ -389,6 +407,7 @@ bool base_worker_t::abort_one_trx(xct_t* axct)
     assert (axct);
     smthread_t::me()->attach_xct(axct);
     w_rc_t e = ss_m::abort_xct();
+    table_man_t::rec_cache_on_abort();
     if (e.is_error()) {
         TRACE( TRACE_ALWAYS, "Xct abort failed [0x%x]\n", e.err_num());
         return (false);
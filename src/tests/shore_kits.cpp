@@ -51,6 +51,10 @@
 
 #include "k_defines.h"
 
+#ifdef CFG_QPIPE
+#include "qpipe/core/fifo_bench.h"
+#endif
+
 #ifdef CFG_SIMICS
 #include "util/simics-magic-instruction.h"
 #endif
@@ -160,6 +164,10 @@ class kit_t : public shore_shell_t
 private:
     DB* _dbinst;
 
+#ifdef CFG_QPIPE
+    guard<qpipe::fifobench_cmd_t> _fifobencher;
+#endif
+
 public:
 
     kit_t(const char* prompt, 
@@ -178,6 +186,8 @@ public:
     virtual int load_trxs_map();
     virtual int load_bp_map();
 
+    virtual int register_commands();
+
 
     // impl of supported commands
     virtual int _cmd_TEST_impl(const double iQueriedSF, const int iSpread,
@@ -214,6 +224,16 @@ int kit_t<Client,DB>::load_trxs_map(void)
     return (Client::load_sup_xct(_sup_trxs));
 }
 
+template<class Client,class DB>
+int kit_t<Client,DB>::register_commands()
+{
+    shore_shell_t::register_commands();
+#ifdef CFG_QPIPE
+    REGISTER_CMD(qpipe::fifobench_cmd_t,_fifobencher);
+#endif
+    return (0);
+}
+
 template<class Client,class DB>
 int kit_t<Client,DB>::load_bp_map(void)
 {
@@ -282,7 +302,7 @@ int kit_t<Client,DB>::inst_test_env(int argc, char* argv[])
     }
 
     // 5. Now that everything is set, register any additional commands
-    shore_shell_t::register_commands();
+    register_commands();
 
     // 6. Start the VAS
     return (_dbinst->start());
@@ -479,6 +499,7 @@ int kit_t<Client,DB>::_cmd_MEASURE_impl(const double iQueriedSF,
 	    _env->set_measure(MST_MEASURE);
 
 	    _env->reset_stats();
+	    log_profile_t::reset();
 	    delay = 0;
 	    remaining = iDuration;
 	}
@@ -501,6 +522,7 @@ int kit_t<Client,DB>::_cmd_MEASURE_impl(const double iQueriedSF,
 	TRACE(TRACE_ALWAYS, "end measurement\n");
         _env->print_throughput(iQueriedSF,iSpread,iNumOfThreads,delay,
                                miochs, usage);
+        if (log_profile_t::is_enabled()) print_log_profile();
 
 #ifdef HAVE_CPUMON
         _g_mon->print_load(delay);
@@ -0,0 +1,266 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   fcopy.cpp
+ *
+ *  @brief:  Implementation of the fast file copies
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "util/fcopy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+
+#include <vector>
+#include <string>
+
+#include "util/trace.h"
+
+#ifdef __linux__
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
+
+
+/* helper functions */
+
+struct fcopy_part_t {
+    int   _src;
+    int   _dst;
+    off_t _from;
+    off_t _to;
+    int   _rv;
+};
+
+static bool _is_zero(const char* buf, const ssize_t sz)
+{
+    const long* p = (const long*)buf;
+    const ssize_t n = sz / sizeof(long);
+    for (ssize_t i=0; i<n; ++i) if (p[i]) return (false);
+    for (ssize_t i=n*sizeof(long); i<sz; ++i) if (buf[i]) return (false);
+    return (true);
+}
+
+
+// Copies the blocks [_from,_to) of the part, skipping the all-zero ones
+static void* _copy_part(void* arg)
+{
+    fcopy_part_t* part = (fcopy_part_t*)arg;
+    char* buf = (char*)malloc(FCOPY_BLOCK_SIZE);
+    if (!buf) {
+        part->_rv = FCOPY_ERROR_READ;
+        return (NULL);
+    }
+
+    part->_rv = 0;
+    for (off_t off=part->_from; off<part->_to; off+=FCOPY_BLOCK_SIZE) {
+        size_t len = FCOPY_BLOCK_SIZE;
+        if (off+(off_t)len > part->_to) len = part->_to-off;
+
+        ssize_t rd = pread(part->_src, buf, len, off);
+        if (rd < 0) {
+            part->_rv = FCOPY_ERROR_READ;
+            break;
+        }
+        if (rd == 0) break;
+        if (_is_zero(buf, rd)) continue;
+
+        ssize_t wr = pwrite(part->_dst, buf, rd, off);
+        if (wr != rd) {
+            part->_rv = FCOPY_ERROR_WRITE;
+            break;
+        }
+    }
+
+    free (buf);
+    return (NULL);
+}
+
+
+
+/* definitions of exported functions */
+
+
+/**
+ *  @brief Copies src to dst, as a reflink if possible or else with a
+ *  parallel sparse copy.
+ */
+int fcopy_file(const char* src, const char* dst, const int threads)
+{
+    int sfd = open(src, O_RDONLY);
+    if (sfd < 0) {
+        TRACE( TRACE_ALWAYS, "Cannot open (%s): %s\n", src, strerror(errno));
+        return (FCOPY_ERROR_OPEN);
+    }
+
+    struct stat st;
+    if (fstat(sfd, &st) != 0) {
+        close(sfd);
+        return (FCOPY_ERROR_OPEN);
+    }
+
+    int dfd = open(dst, O_WRONLY|O_CREAT|O_TRUNC, st.st_mode & 0777);
+    if (dfd < 0) {
+        TRACE( TRACE_ALWAYS, "Cannot open (%s): %s\n", dst, strerror(errno));
+        close(sfd);
+        return (FCOPY_ERROR_OPEN);
+    }
+
+    int rv = 0;
+
+#ifdef FICLONE
+    // copy-on-write clone, supported by btrfs, xfs (reflink=1), ...
+    if (ioctl(dfd, FICLONE, sfd) == 0) {
+        TRACE( TRACE_DEBUG, "Cloned (%s) to (%s)\n", src, dst);
+        close(dfd);
+        close(sfd);
+        return (0);
+    }
+#endif
+
+    // the holes are left by the size set upfront
+    if (ftruncate(dfd, st.st_size) != 0) {
+        close(dfd);
+        close(sfd);
+        return (FCOPY_ERROR_WRITE);
+    }
+
+    // each thread copies a contiguous range of blocks
+    const off_t blocks = (st.st_size + FCOPY_BLOCK_SIZE - 1) / FCOPY_BLOCK_SIZE;
+    int nthr = (threads>0 ? threads : 1);
+    if (nthr > blocks) nthr = (blocks>0 ? blocks : 1);
+    const off_t per_thr = (blocks + nthr - 1) / nthr;
+
+    std::vector<fcopy_part_t> parts(nthr);
+    std::vector<pthread_t> tids(nthr);
+    for (int i=0; i<nthr; ++i) {
+        parts[i]._src = sfd;
+        parts[i]._dst = dfd;
+        parts[i]._from = i*per_thr*FCOPY_BLOCK_SIZE;
+        parts[i]._to = (i+1)*per_thr*FCOPY_BLOCK_SIZE;
+        if (parts[i]._to > st.st_size) parts[i]._to = st.st_size;
+        parts[i]._rv = 0;
+    }
+    for (int i=1; i<nthr; ++i) {
+        if (pthread_create(&tids[i], NULL, _copy_part, &parts[i]) != 0) {
+            // copy it ourselves
+            _copy_part(&parts[i]);
+            tids[i] = pthread_self();
+        }
+    }
+    _copy_part(&parts[0]);
+    for (int i=1; i<nthr; ++i) {
+        if (!pthread_equal(tids[i], pthread_self())) pthread_join(tids[i], NULL);
+    }
+
+    for (int i=0; i<nthr; ++i) {
+        if (parts[i]._rv) rv = parts[i]._rv;
+    }
+
+    if ((rv==0) && (fsync(dfd) != 0)) rv = FCOPY_ERROR_WRITE;
+
+    close(dfd);
+    close(sfd);
+    return (rv);
+}
+
+
+
+/**
+ *  @brief Copies all the regular files of srcdir to dstdir.
+ */
+int fcopy_dir(const char* srcdir, const char* dstdir, const int threads)
+{
+    if ((mkdir(dstdir, 0755) != 0) && (errno != EEXIST)) {
+        TRACE( TRACE_ALWAYS, "Cannot create (%s): %s\n", dstdir, strerror(errno));
+        return (FCOPY_ERROR_DIRECTORY);
+    }
+
+    DIR* pdir = opendir(srcdir);
+    if (!pdir) {
+        TRACE( TRACE_ALWAYS, "Cannot open (%s): %s\n", srcdir, strerror(errno));
+        return (FCOPY_ERROR_DIRECTORY);
+    }
+
+    int rv = 0;
+    struct dirent* pent;
+    while ((rv==0) && ((pent = readdir(pdir)) != NULL)) {
+        std::string src = std::string(srcdir) + "/" + pent->d_name;
+        struct stat st;
+        if ((stat(src.c_str(), &st) != 0) || !S_ISREG(st.st_mode)) continue;
+
+        std::string dst = std::string(dstdir) + "/" + pent->d_name;
+        rv = fcopy_file(src.c_str(), dst.c_str(), threads);
+    }
+
+    closedir(pdir);
+    return (rv);
+}
+
+
+
+/**
+ *  @brief Removes all the regular files of dir.
+ */
+int fcopy_clear_dir(const char* dir)
+{
+    DIR* pdir = opendir(dir);
+    if (!pdir) return (FCOPY_ERROR_DIRECTORY);
+
+    int rv = 0;
+    struct dirent* pent;
+    while ((pent = readdir(pdir)) != NULL) {
+        std::string path = std::string(dir) + "/" + pent->d_name;
+        struct stat st;
+        if ((stat(path.c_str(), &st) != 0) || !S_ISREG(st.st_mode)) continue;
+        if (unlink(path.c_str()) != 0) rv = FCOPY_ERROR_WRITE;
+    }
+
+    closedir(pdir);
+    return (rv);
+}
+
+
+
+/**
+ *  @brief Removes all the regular files of dir and then dir itself.
+ */
+int fcopy_remove_dir(const char* dir)
+{
+    int rv = fcopy_clear_dir(dir);
+    if ((rv==0) && (rmdir(dir) != 0)) rv = FCOPY_ERROR_DIRECTORY;
+    return (rv);
+}
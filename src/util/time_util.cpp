@@ -31,6 +31,9 @@
 #include "util/time_util.h"
 
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <pthread.h>
 
 #include "k_defines.h"
 
@@ -288,3 +291,118 @@ time_day_end (time_t t)
   
   return mktime (&tm);
 }
+
+
+
+/******************************************************************** 
+ *
+ *  Compact dates (days since 1970-01-01)
+ *
+ ********************************************************************/
+
+
+/******************************************************************** 
+ *
+ *  @fn:     date_to_str
+ *
+ *  @brief:  Writes a date as YYYY-MM-DD (11 bytes with the '\0')
+ *
+ ********************************************************************/
+
+void date_to_str(char* dst, const int date)
+{
+    int y, m, d;
+    date_to_ymd(date, y, m, d);
+    sprintf(dst, "%04d-%02d-%02d", y, m, d);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:     timet_to_date
+ *
+ *  @brief:  The date of a time_t, according to the local time
+ *
+ ********************************************************************/
+
+int timet_to_date(const time_t time)
+{
+    struct tm atm;
+    localtime_r(&time, &atm);
+    return (ymd_to_date(atm.tm_year+1900, atm.tm_mon+1, atm.tm_mday));
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:     date_to_timet
+ *
+ *  @brief:  The local midnight of a date, as str_to_timet()
+ *
+ *  @note:   The scans of the TPC-H dates convert every row, thus the
+ *           midnights of the dates from 1970 to 2037 are computed once,
+ *           with mktime(), to a table. The other dates call mktime().
+ *
+ ********************************************************************/
+
+static const int DATE_TABLE_DAYS = 68*365 + 17;
+
+static time_t*        _date_table = NULL;
+static pthread_once_t _date_table_once = PTHREAD_ONCE_INIT;
+
+static time_t _date_mktime(const int date)
+{
+    tm time_str;
+    memset(&time_str, 0, sizeof(time_str));
+    date_to_ymd(date, time_str.tm_year, time_str.tm_mon, time_str.tm_mday);
+    time_str.tm_year -= 1900;
+    time_str.tm_mon--;
+    time_str.tm_isdst = -1;
+    return mktime(&time_str);
+}
+
+static void _date_table_init()
+{
+    time_t* table = new time_t[DATE_TABLE_DAYS];
+    for (int i=0; i<DATE_TABLE_DAYS; i++) {
+        table[i] = _date_mktime(i);
+    }
+    _date_table = table;
+}
+
+time_t date_to_timet(const int date)
+{
+    if ((date < 0) || (date >= DATE_TABLE_DAYS)) {
+        return (_date_mktime(date));
+    }
+    pthread_once(&_date_table_once, _date_table_init);
+    return (_date_table[date]);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:     date_add_month/date_add_year
+ *
+ *  @brief:  Adds months or years to a date. As in SQL, the day is clipped
+ *           to the last day of the resulting month.
+ *
+ ********************************************************************/
+
+int date_add_month(const int date, const int months)
+{
+    int y, m, d;
+    date_to_ymd(date, y, m, d);
+    int mon = (y*12 + (m-1)) + months;
+    y = mon / 12;
+    m = mon % 12 + 1;
+    int mdays = days_in_month[m-1] +
+        ((m == 2) && ((y%4 == 0) && ((y%100 != 0) || (y%400 == 0))));
+    return (ymd_to_date(y, m, (d > mdays ? mdays : d)));
+}
+
+int date_add_year(const int date, const int years)
+{
+    return (date_add_month(date, years*12));
+}
+
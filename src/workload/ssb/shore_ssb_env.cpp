@@ -30,6 +30,7 @@
 
 #include "workload/ssb/shore_ssb_env.h"
 #include "sm/shore/shore_helper_loader.h"
+#include "sm/shore/shore_load_cache.h"
 
 #include "workload/ssb/ssb_random.h"
 
@@ -111,12 +112,15 @@ struct ShoreSSBEnv::table_creator_t : public thread_t
     //    int _parts_per_thread;
     //    int _custs_per_thread;
 
+    bool _replay;
+
     table_creator_t(ShoreSSBEnv* env, const double sf, const int loader_count,
-                    const int lineorder_per_thread)
+                    const int lineorder_per_thread, const bool replay)
 	: thread_t("SSB C"), 
           _env(env), _sf(sf), 
           _loader_count(loader_count),
-          _lineorder_per_thread(lineorder_per_thread)
+          _lineorder_per_thread(lineorder_per_thread),
+          _replay(replay)
     { }
     virtual void work();
 };
@@ -165,25 +169,37 @@ void ShoreSSBEnv::table_creator_t::work()
     _env->_pcustomer_man->register_table_man();
     _env->_plineorder_man->register_table_man();
 
+    // In bulk-load mode the indexes are built at the end of the load
+    if (bulk_loader_t::is_enabled()) {
+        std::vector<table_man_t*> tables;
+        _env->load_tables(tables);
+        W_COERCE(bulk_loader_t::begin(_env->db(), tables));
+    }
 
-
-    // Do the baseline transaction
-    populate_baseline_input_t in = {_sf, _loader_count, DIVISOR, 
-                                    _lineorder_per_thread};
-
-    w_rc_t e = RCOK;
-
-    long log_space_needed = 0;
- retrybaseline:
-    W_COERCE(_env->db()->begin_xct());
+    // Do the baseline transaction, unless the records are replayed
+    // from the load cache
+    if (!_replay) {
+        populate_baseline_input_t in = {_sf, _loader_count, DIVISOR, 
+                                        _lineorder_per_thread};
+
+        w_rc_t e = RCOK;
+
+        long log_space_needed = 0;
+        bulk_loader_t::mark_runs();
+        load_cache_t::mark();
+     retrybaseline:
+        bulk_loader_t::rollback_runs();
+        load_cache_t::rollback();
+        W_COERCE(_env->db()->begin_xct());
 #ifdef USE_SHORE_6
-    if(log_space_needed > 0) {
-	W_COERCE(_env->db()->xct_reserve_log_space(log_space_needed));
-    }
+        if(log_space_needed > 0) {
+            W_COERCE(_env->db()->xct_reserve_log_space(log_space_needed));
+        }
 #endif
-    e = _env->xct_populate_baseline(0, in);
+        e = _env->xct_populate_baseline(0, in);
 
-    CHECK_XCT_RETURN(e,log_space_needed,retrybaseline,_env);
+        CHECK_XCT_RETURN(e,log_space_needed,retrybaseline,_env);
+    }
     
     W_COERCE(_env->db()->begin_xct());
     W_COERCE(_env->_post_init_impl());
@@ -211,7 +227,11 @@ void ShoreSSBEnv::table_builder_t::work()
         oid = std::min(_lineorder_end-i,LO_POP_UNIT);
 
 	long log_space_needed = 0;
+	bulk_loader_t::mark_runs();
+	load_cache_t::mark();
     retrypart:
+	bulk_loader_t::rollback_runs();
+	load_cache_t::rollback();
 	W_COERCE(_env->db()->begin_xct());
 #ifdef USE_SHORE_6
 	if(log_space_needed > 0) {
@@ -406,6 +426,12 @@ int ShoreSSBEnv::info() const
 
 int ShoreSSBEnv::statistics() 
 {
+#ifdef CFG_QPIPE
+    result_cache_t::print_stats();
+    runtime_filter_t::print_stats();
+    cscan_stage_t::print_stats();
+    build_cache_t::print_stats();
+#endif
     return (0);
 }
 
@@ -447,6 +473,15 @@ int ShoreSSBEnv::stop()
  *
  ******************************************************************/
 
+void ShoreSSBEnv::load_tables(std::vector<table_man_t*>& tables)
+{
+    tables.push_back(part_man());
+    tables.push_back(supplier_man());
+    tables.push_back(date_man());
+    tables.push_back(customer_man());
+    tables.push_back(lineorder_man());
+}
+
 w_rc_t ShoreSSBEnv::loaddata() 
 {
     // 0. lock the loading status and the scaling factor
@@ -480,11 +515,23 @@ w_rc_t ShoreSSBEnv::loaddata()
     long total_lineorders = _scaling_factor*LINEORDER_UNIT_PER_SF;
     long lineorders_per_thread = total_lineorders/loaders_to_use;
 
+    // If there is a valid load cache for this SF, its records are 
+    // replayed instead of generated. Otherwise the load is captured.
+    guard<load_cache_t> cache;
+    bool replay = false;
+    if (load_cache_t::is_enabled()) {
+        std::vector<table_man_t*> tables;
+        load_tables(tables);
+        cache = new load_cache_t(c_str("ssb-sf%g",_scaling_factor).data(), tables);
+        replay = cache->is_valid();
+        if (!replay) W_DO(cache->begin_capture());
+    }
+
     // 2. Fire up the table creator and baseline loader
     {
 	guard<table_creator_t> tc;
 	tc = new table_creator_t(this, _scaling_factor, loaders_to_use,
-                                 lineorders_per_thread);
+                                 lineorders_per_thread, replay);
 	tc->fork();
 	tc->join();
     }
@@ -493,39 +540,49 @@ w_rc_t ShoreSSBEnv::loaddata()
     guard<checkpointer_t> chk(new checkpointer_t(this));
     chk->fork();
 
-    // 4. Fire up the parallel loaders
-    TRACE( TRACE_ALWAYS, "Firing up %d loaders ..\n", loaders_to_use);
-    array_guard_t< guard<table_builder_t> > loaders(new guard<table_builder_t>[loaders_to_use]);
-    for(int i=0; i < loaders_to_use; i++) {
-        	long lineorder_start = (i*lineorders_per_thread) + DIVISOR + 1;
-        	long lineorder_end = ((i+1)*lineorders_per_thread > total_lineorders) ? 
-                    total_lineorders : (i+1)*lineorders_per_thread;
-        assert (lineorder_start <= lineorder_end);
-
-        //	long cust_start = (i*custs_per_thread) + DIVISOR;
-        //	long cust_end = ((i+1)*custs_per_thread > total_custs - 1) ? 
-        //            total_custs : (i+1)*custs_per_thread - 1;
-        //        assert (cust_start <= cust_end);
-
-	loaders[i] = new table_builder_t(this, i, 
-                                         lineorder_start, lineorder_end, 
-                                         _scaling_factor);
-	loaders[i]->fork();
+    // 4. Fire up the parallel loaders, or replay the load cache
+    if (replay) {
+        W_DO(cache->replay(_pssm, loaders_to_use));
     }
+    else {
+        TRACE( TRACE_ALWAYS, "Firing up %d loaders ..\n", loaders_to_use);
+        array_guard_t< guard<table_builder_t> > loaders(new guard<table_builder_t>[loaders_to_use]);
+        for(int i=0; i < loaders_to_use; i++) {
+            long lineorder_start = (i*lineorders_per_thread) + DIVISOR + 1;
+            long lineorder_end = ((i+1)*lineorders_per_thread > total_lineorders) ? 
+                total_lineorders : (i+1)*lineorders_per_thread;
+            assert (lineorder_start <= lineorder_end);
+
+            //	long cust_start = (i*custs_per_thread) + DIVISOR;
+            //	long cust_end = ((i+1)*custs_per_thread > total_custs - 1) ? 
+            //            total_custs : (i+1)*custs_per_thread - 1;
+            //        assert (cust_start <= cust_end);
+
+            loaders[i] = new table_builder_t(this, i, 
+                                             lineorder_start, lineorder_end, 
+                                             _scaling_factor);
+            loaders[i]->fork();
+        }
 
-    for(int i=0; i < loaders_to_use; i++) {
-	loaders[i]->join();
+        for(int i=0; i < loaders_to_use; i++) {
+            loaders[i]->join();
+        }
+
+        if (cache) W_DO(cache->end_capture());
     }
 
+    // 5. If bulk loading, build the indexes
+    W_DO(bulk_loader_t::finish(_pssm, loaders_to_use));
+
     time_t tstop = time(NULL);
 
-    // 5. Print stats
+    // 6. Print stats
     TRACE( TRACE_STATISTICS, "Loading finished. %d tables loaded in (%d) secs...\n",
            SHORE_SSB_TABLES, (tstop - tstart));
 
     dbgenssb::free_asc_date();
 
-    // 6. Notify that the env is loaded
+    // 7. Notify that the env is loaded
     _loaded = true;
     chk->join();
 
@@ -553,13 +610,13 @@ w_rc_t ShoreSSBEnv::check_consistency()
  * @fn:    warmup()
  *
  * @brief: Touches the entire database - For memory-fitting databases
- *         this is enough to bring it to load it to memory
+ *         this is enough to bring it to load it to memory.
  *
  ******************************************************************/
 
 w_rc_t ShoreSSBEnv::warmup()
 {
-    return (check_consistency());
+    return (warmup_bufpool());
 }
 
 
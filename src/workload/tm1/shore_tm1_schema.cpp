@@ -136,6 +136,9 @@ subscriber_t::subscriber_t(const uint4_t& pd)
     else
 #endif
         create_index_desc("SUB_NBR_IDX", 0, keys2, 1, true, false, pd);
+
+    // read-mostly (only UpdSubData and UpdLocation modify it)
+    set_rec_cache(1<<17);
 }
 
 
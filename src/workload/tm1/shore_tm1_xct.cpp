@@ -489,16 +489,7 @@ w_rc_t ShoreTM1Env::xct_get_sub_data(const int xct_id,
     
     // Touches 1 table:
     // Subscriber
-    tuple_guard<sub_man_impl> prsub(_psub_man);
-    
-    rep_row_t areprow(_psub_man->ts());
-
-    // allocate space for the table representations
-    areprow.set(_psub_desc->maxsize()); 
-
-    prsub->_rep = &areprow;
 
-    
     /* SELECT s_id, sub_nbr, 
      *        bit_XX, hex_XX, byte2_XX,
      *        msc_location, vlr_location
@@ -511,6 +502,31 @@ w_rc_t ShoreTM1Env::xct_get_sub_data(const int xct_id,
     // 1. retrieve Subscriber (read-only)
     TRACE( TRACE_TRX_FLOW, "App: %d GSD:sub-idx-probe (%d)\n", 
 	   xct_id, gsdin._s_id);
+
+#ifdef CFG_FIXED_ROWS
+
+    // the fields are read in place, no load()
+    sub_man_impl::fixed_row asubrow;
+    asubrow->S_ID = gsdin._s_id;
+    W_DO(_psub_man->probe_by_name(_pssm, "S_IDX", asubrow));
+
+#ifdef PRINT_TRX_RESULTS
+    TRACE( TRACE_TRX_FLOW, "App: %d GSD: (%d) (%.16s) (%d) (%d)\n", xct_id,
+           asubrow->S_ID, asubrow->SUB_NBR, 
+           asubrow->MSC_LOCATION, asubrow->VLR_LOCATION);
+#endif
+
+#else
+
+    tuple_guard<sub_man_impl> prsub(_psub_man);
+    
+    rep_row_t areprow(_psub_man->ts());
+
+    // allocate space for the table representations
+    areprow.set(_psub_desc->maxsize()); 
+
+    prsub->_rep = &areprow;
+
     W_DO(_psub_man->sub_idx_probe(_pssm, prsub, gsdin._s_id));
     
     tm1_sub_t asub;
@@ -565,6 +581,8 @@ w_rc_t ShoreTM1Env::xct_get_sub_data(const int xct_id,
     prsub->print_tuple();
 #endif
 
+#endif // CFG_FIXED_ROWS
+
     return RCOK;
 
 } // EOF: GET_SUB_DATA
@@ -695,15 +713,6 @@ w_rc_t ShoreTM1Env::xct_get_acc_data(const int xct_id,
 
     // Touches 1 table:
     // AccessInfo
-    tuple_guard<ai_man_impl> prai(_pai_man);
-
-    rep_row_t areprow(_pai_man->ts());
-
-    // allocate space for the table representations
-    areprow.set(_pai_desc->maxsize()); 
-
-    prai->_rep = &areprow;
-
 
     /* SELECT data1, data2, data3, data4
      * FROM   Access_Info
@@ -716,6 +725,30 @@ w_rc_t ShoreTM1Env::xct_get_acc_data(const int xct_id,
     // 1. retrieve AccessInfo (read-only)
     TRACE( TRACE_TRX_FLOW, "App: %d GAD:ai-idx-probe (%d) (%d)\n", 
 	   xct_id, gadin._s_id, gadin._ai_type);
+
+#ifdef CFG_FIXED_ROWS
+
+    ai_man_impl::fixed_row airow;
+    airow->S_ID    = gadin._s_id;
+    airow->AI_TYPE = gadin._ai_type;
+    W_DO(_pai_man->probe_by_name(_pssm, "AI_IDX", airow));
+
+#ifdef PRINT_TRX_RESULTS
+    TRACE( TRACE_TRX_FLOW, "App: %d GAD: (%d) (%d) (%.3s) (%.5s)\n", xct_id,
+           airow->DATA1, airow->DATA2, airow->DATA3, airow->DATA4);
+#endif
+
+#else
+
+    tuple_guard<ai_man_impl> prai(_pai_man);
+
+    rep_row_t areprow(_pai_man->ts());
+
+    // allocate space for the table representations
+    areprow.set(_pai_desc->maxsize()); 
+
+    prai->_rep = &areprow;
+
     W_DO(_pai_man->ai_idx_probe(_pssm, prai, gadin._s_id, gadin._ai_type));
     tm1_ai_t aai;
     prai->get_value(2,  aai.DATA1);
@@ -728,6 +761,8 @@ w_rc_t ShoreTM1Env::xct_get_acc_data(const int xct_id,
     // dumps the status of all the table rows used
     prai->print_tuple();
 #endif
+
+#endif // CFG_FIXED_ROWS
     
     return RCOK;
 
@@ -752,17 +787,6 @@ w_rc_t ShoreTM1Env::xct_upd_sub_data(const int xct_id,
 
     // Touches 2 tables:
     // Subscriber, SpecialFacility
-    tuple_guard<sub_man_impl> prsub(_psub_man);
-    tuple_guard<sf_man_impl> prsf(_psf_man);
-
-    rep_row_t areprow(_psub_man->ts());
-
-    // allocate space for the larger table representation
-    areprow.set(_psub_desc->maxsize()); 
-
-    prsub->_rep = &areprow;
-    prsf->_rep = &areprow;
-
 
     /* UPDATE Subscriber
      * SET bit_1 = <bit_rnd>
@@ -782,19 +806,57 @@ w_rc_t ShoreTM1Env::xct_upd_sub_data(const int xct_id,
     //     operation on this trx that may fail
     //#warning baseline::upd_sub_data does first the Upd(SF) and then Upd(Sub)
     
+#ifdef CFG_FIXED_ROWS
+
+    // only the updated fields are written (and logged)
+    sf_man_impl::fixed_row  sfrow;
+    sub_man_impl::fixed_row subrow;
+
+    // 1. Update SpecialFacility
+    TRACE( TRACE_TRX_FLOW, "App: %d USD:sf-idx-upd (%d) (%d)\n", 
+	   xct_id, usdin._s_id, usdin._sf_type);
+    sfrow->S_ID    = usdin._s_id;
+    sfrow->SF_TYPE = usdin._sf_type;
+    W_DO(_psf_man->probe_forupdate_by_name(_pssm, "SF_IDX", sfrow));
+    sfrow->DATA_A = usdin._a_data;
+    W_DO(_psf_man->update_field(_pssm, sfrow,
+                                FIXED_FIELD(special_facility_rec_t,DATA_A)));
+
+    // 2. Update Subscriber
+    TRACE( TRACE_TRX_FLOW, "App: %d USD:sub-idx-upd (%d)\n", 
+	   xct_id, usdin._s_id);
+    subrow->S_ID = usdin._s_id;
+    W_DO(_psub_man->probe_forupdate_by_name(_pssm, "S_IDX", subrow));
+    subrow->BIT_XX[0] = usdin._a_bit;
+    W_DO(_psub_man->update_field(_pssm, subrow,
+                                 FIXED_FIELD(subscriber_rec_t,BIT_XX[0])));
+
+#else
+
+    tuple_guard<sub_man_impl> prsub(_psub_man);
+    tuple_guard<sf_man_impl> prsf(_psf_man);
+
+    rep_row_t areprow(_psub_man->ts());
+
+    // allocate space for the larger table representation
+    areprow.set(_psub_desc->maxsize()); 
+
+    prsub->_rep = &areprow;
+    prsf->_rep = &areprow;
+
     // 1. Update SpecialFacility
     TRACE( TRACE_TRX_FLOW, "App: %d USD:sf-idx-upd (%d) (%d)\n", 
 	   xct_id, usdin._s_id, usdin._sf_type);
     W_DO(_psf_man->sf_idx_upd(_pssm, prsf, usdin._s_id, usdin._sf_type));    
     prsf->set_value(4, usdin._a_data);        
-    W_DO(_psf_man->update_tuple(_pssm, prsf));
+    W_DO(_psf_man->update_dirty(_pssm, prsf));
 
     // 2. Update Subscriber
     TRACE( TRACE_TRX_FLOW, "App: %d USD:sub-idx-upd (%d)\n", 
 	   xct_id, usdin._s_id);
     W_DO(_psub_man->sub_idx_upd(_pssm, prsub, usdin._s_id));
     prsub->set_value(2, usdin._a_bit);
-    W_DO(_psub_man->update_tuple(_pssm, prsub));
+    W_DO(_psub_man->update_dirty(_pssm, prsub));
 
 #ifdef PRINT_TRX_RESULTS
     // at the end of the transaction 
@@ -803,6 +865,8 @@ w_rc_t ShoreTM1Env::xct_upd_sub_data(const int xct_id,
     prsf->print_tuple();
 #endif
 
+#endif // CFG_FIXED_ROWS
+
     return RCOK;
 
 } // EOF: UPD_SUB_DATA
@@ -826,15 +890,6 @@ w_rc_t ShoreTM1Env::xct_upd_loc(const int xct_id,
 
     // Touches 1 table:
     // Subscriber
-    tuple_guard<sub_man_impl> prsub(_psub_man);
-
-    rep_row_t areprow(_psub_man->ts());
-
-    // allocate space for the larger table representation
-    areprow.set(_psub_desc->maxsize()); 
-
-    prsub->_rep = &areprow;
-
 
     /* UPDATE Subscriber
      * SET    vlr_location = <vlr_location rnd>
@@ -846,15 +901,41 @@ w_rc_t ShoreTM1Env::xct_upd_loc(const int xct_id,
     // 1. Update Subscriber
     TRACE( TRACE_TRX_FLOW, "App: %d UL:sub-nbr-idx-upd (%d)\n", 
 	   xct_id, ulin._s_id);
+
+#ifdef CFG_FIXED_ROWS
+
+    sub_man_impl::fixed_row subrow;
+    strncpy(subrow->SUB_NBR, ulin._sub_nbr, TM1_SUB_NBR_SZ);
+#ifdef USE_DORA_EXT_IDX
+    subrow->S_ID = ulin._s_id;
+#endif
+    W_DO(_psub_man->probe_forupdate_by_name(_pssm, "SUB_NBR_IDX", subrow));
+    subrow->VLR_LOCATION = ulin._vlr_loc;
+    W_DO(_psub_man->update_field(_pssm, subrow,
+                                 FIXED_FIELD(subscriber_rec_t,VLR_LOCATION)));
+
+#else
+
+    tuple_guard<sub_man_impl> prsub(_psub_man);
+
+    rep_row_t areprow(_psub_man->ts());
+
+    // allocate space for the larger table representation
+    areprow.set(_psub_desc->maxsize()); 
+
+    prsub->_rep = &areprow;
+
     W_DO(_psub_man->sub_nbr_idx_upd(_pssm, prsub, ulin._sub_nbr));
     prsub->set_value(33, ulin._vlr_loc);
-    W_DO(_psub_man->update_tuple(_pssm, prsub));
+    W_DO(_psub_man->update_dirty(_pssm, prsub));
 
 #ifdef PRINT_TRX_RESULTS
     // at the end of the transaction 
     // dumps the status of all the table rows used
     prsub->print_tuple();
 #endif
+
+#endif // CFG_FIXED_ROWS
     
     return RCOK;
 
@@ -600,13 +600,13 @@ w_rc_t ShoreTPCBEnv::check_consistency()
  * @fn:    warmup()
  *
  * @brief: Touches the entire database - For memory-fitting databases
- *         this is enough to bring it to load it to memory
+ *         this is enough to bring it to load it to memory.
  *
  ******************************************************************/
 
 w_rc_t ShoreTPCBEnv::warmup()
 {
-    return (check_consistency());
+    return (warmup_bufpool());
 }
 
 
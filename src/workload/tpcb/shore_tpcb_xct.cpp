@@ -282,6 +282,45 @@ w_rc_t ShoreTPCBEnv::xct_acct_update(const int /* xct_id */,
     // account update trx touches 4 tables:
     // branch, teller, account, and history
 
+#ifdef CFG_FIXED_ROWS
+
+    // fixed-layout rows, no load()/format()
+    account_man_impl::fixed_row arow;
+    teller_man_impl::fixed_row  trow;
+    branch_man_impl::fixed_row  brow;
+    history_man_impl::fixed_row hrow;
+
+    // 1. Update account
+    arow->A_ID = ppin.a_id;
+    W_DO(_paccount_man->probe_forupdate_by_name(_pssm, "A_IDX", arow));
+    arow->A_BALANCE += ppin.delta;
+    W_DO(_paccount_man->update_field(_pssm, arow, 
+                                     FIXED_FIELD(account_rec_t,A_BALANCE)));
+
+    // 2. Write to History
+    hrow->H_B_ID  = ppin.b_id;
+    hrow->H_T_ID  = ppin.t_id;
+    hrow->H_A_ID  = ppin.a_id;
+    hrow->H_DELTA = ppin.delta;
+    hrow->H_TIME  = time(NULL);
+    W_DO(_phistory_man->add_row(_pssm, hrow));
+
+    // 3. Update teller
+    trow->T_ID = ppin.t_id;
+    W_DO(_pteller_man->probe_forupdate_by_name(_pssm, "T_IDX", trow));
+    trow->T_BALANCE += ppin.delta;
+    W_DO(_pteller_man->update_field(_pssm, trow, 
+                                    FIXED_FIELD(teller_rec_t,T_BALANCE)));
+
+    // 4. Update branch
+    brow->B_ID = ppin.b_id;
+    W_DO(_pbranch_man->probe_forupdate_by_name(_pssm, "B_IDX", brow));
+    brow->B_BALANCE += ppin.delta;
+    W_DO(_pbranch_man->update_field(_pssm, brow, 
+                                    FIXED_FIELD(branch_rec_t,B_BALANCE)));
+
+#else
+
     // get table tuples from the caches
     tuple_guard<branch_man_impl> prb(_pbranch_man);
     tuple_guard<teller_man_impl> prt(_pteller_man);
@@ -304,7 +343,7 @@ w_rc_t ShoreTPCBEnv::xct_acct_update(const int /* xct_id */,
     W_DO(_paccount_man->a_index_probe_forupdate(_pssm, pracct, ppin.a_id));
     pracct->get_value(2, total);
     pracct->set_value(2, total + ppin.delta);
-    W_DO(_paccount_man->update_tuple(_pssm, pracct));
+    W_DO(_paccount_man->update_dirty(_pssm, pracct));
     
     // 2. Write to History
     prhist->set_value(0, ppin.b_id);
@@ -321,13 +360,13 @@ w_rc_t ShoreTPCBEnv::xct_acct_update(const int /* xct_id */,
     W_DO(_pteller_man->t_index_probe_forupdate(_pssm, prt, ppin.t_id));
     prt->get_value(2, total);
     prt->set_value(2, total + ppin.delta);
-    W_DO(_pteller_man->update_tuple(_pssm, prt));
+    W_DO(_pteller_man->update_dirty(_pssm, prt));
     
     // 4. Update branch
     W_DO(_pbranch_man->b_index_probe_forupdate(_pssm, prb, ppin.b_id));
     prb->get_value(1, total);
     prb->set_value(1, total + ppin.delta);
-    W_DO(_pbranch_man->update_tuple(_pssm, prb));
+    W_DO(_pbranch_man->update_dirty(_pssm, prb));
     
 #ifdef PRINT_TRX_RESULTS
     // at the end of the transaction 
@@ -337,6 +376,8 @@ w_rc_t ShoreTPCBEnv::xct_acct_update(const int /* xct_id */,
     pracct->print_tuple();
     prhist->print_tuple();
 #endif
+
+#endif // CFG_FIXED_ROWS
     
     return RCOK;
 
@@ -136,7 +136,6 @@ void ShoreTPCCEnv::table_creator_t::work()
     _env->_pitem_man->register_table_man();
     _env->_pstock_man->register_table_man();
 
-
     // do the first transaction
     populate_baseline_input_t in = {_sf};
     W_COERCE(_env->db()->begin_xct());
@@ -145,6 +144,20 @@ void ShoreTPCCEnv::table_creator_t::work()
     W_COERCE(_env->db()->begin_xct());
     W_COERCE(_env->_post_init_impl());
     W_COERCE(_env->db()->commit_xct());
+
+    // In bulk-load mode the indexes of the tables filled by the
+    // loaders are built at the end of the load
+    if (bulk_loader_t::is_enabled()) {
+        std::vector<table_man_t*> tables;
+        tables.push_back(_env->customer_man());
+        tables.push_back(_env->history_man());
+        tables.push_back(_env->new_order_man());
+        tables.push_back(_env->order_man());
+        tables.push_back(_env->order_line_man());
+        tables.push_back(_env->item_man());
+        tables.push_back(_env->stock_man());
+        W_COERCE(bulk_loader_t::begin(_env->db(), tables));
+    }
     
 #if 0
     /*
@@ -198,7 +211,9 @@ void ShoreTPCCEnv::table_builder_t::work()
 	int *cids = overlap? _cids : cid_array+0;
 	populate_one_unit_input_t in = {tid, cids};
 	long log_space_needed = 0;
+	bulk_loader_t::mark_runs();
     retry:
+	bulk_loader_t::rollback_runs();
 	W_COERCE(_env->db()->begin_xct());
 
 #ifdef USE_SHORE_6
@@ -574,13 +589,16 @@ w_rc_t ShoreTPCCEnv::loaddata()
 	loaders[i]->join();
     }
 
+    // 4. If bulk loading, build the indexes
+    W_DO(bulk_loader_t::finish(_pssm, loaders_to_use));
+
     time_t tstop = time(NULL);
 
-    // 4. Print stats
+    // 5. Print stats
     TRACE( TRACE_STATISTICS, "Loading finished. %d table loaded in (%d) secs...\n",
            SHORE_TPCC_TABLES, (tstop - tstart));
 
-    // 5. notify that the env is loaded
+    // 6. notify that the env is loaded
     _loaded = true;
     chk->join();
 
@@ -611,13 +629,13 @@ w_rc_t ShoreTPCCEnv::check_consistency()
  * @fn:    warmup()
  *
  * @brief: Touches the entire database - For memory-fitting databases
- *         this is enough to bring it to load it to memory
+ *         this is enough to bring it to load it to memory.
  *
  ******************************************************************/
 
 w_rc_t ShoreTPCCEnv::warmup()
 {
-    return (check_consistency());
+    return (warmup_bufpool());
 }
 
 
@@ -251,6 +251,11 @@ order_line_t::order_line_t(const uint4_t& pd) :
     numIdxPartitions = 10; 
 #endif
     create_primary_idx_desc("OL_IDX", numIdxPartitions, keys, 4, pd);
+
+    // the entries carry also OL_I_ID, then the STOCK-LEVEL scan of the
+    // last 20 orders does not need to read the orderlines
+    uint payload[1] = {4}; // { OL_I_ID }
+    W_COERCE(set_index_payload("OL_IDX", payload, 1));
 }
 
 
@@ -268,6 +273,9 @@ item_t::item_t(const uint4_t& pd) :
     // create unique index on i_index on (i_id)	
     uint keys[1] = {0}; // IDX { I_ID }
     create_primary_idx_desc("I_IDX", 0, keys, 1, pd);
+
+    // ITEM is never updated, cache the hot items
+    set_rec_cache(1<<17, true);
 }
 
 
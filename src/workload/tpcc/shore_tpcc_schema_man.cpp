@@ -99,7 +99,7 @@ warehouse_man_impl::wh_update_ytd(ss_m* db,
     ptuple->get_value(8, ytd);
     ytd += amount;
     ptuple->set_value(8, ytd);
-    W_DO(update_tuple(db, ptuple, lm));
+    W_DO(update_dirty(db, ptuple, lm));
     return (RCOK);
 }
 
@@ -166,7 +166,7 @@ w_rc_t district_man_impl::dist_update_ytd(ss_m* db,
     ptuple->get_value(9, d_ytd);
     d_ytd += amount;
     ptuple->set_value(9, d_ytd);
-    W_DO(update_tuple(db, ptuple, lm));
+    W_DO(update_dirty(db, ptuple, lm));
     return (RCOK);
 }
 
@@ -188,7 +188,7 @@ w_rc_t district_man_impl::dist_update_next_o_id(ss_m* db,
     assert (ptuple->is_rid_valid());
 
     ptuple->set_value(10, next_o_id);
-    return (update_tuple(db, ptuple, lm));
+    return (update_dirty(db, ptuple, lm));
 }
 
 w_rc_t district_man_impl::dist_update_next_o_id_nl(ss_m* db,
@@ -334,7 +334,7 @@ w_rc_t customer_man_impl::cust_update_tuple(ss_m* db,
     if (adata2)
 	ptuple->set_value(21, adata2);
 
-    return (update_tuple(db, ptuple, lm));
+    return (update_dirty(db, ptuple, lm));
 }
 
 
@@ -358,7 +358,7 @@ w_rc_t customer_man_impl::cust_update_discount_balance(ss_m* db,
     assert (discount>=0);
     ptuple->set_value(15, discount);
     ptuple->set_value(16, balance);
-    return (update_tuple(db, ptuple, lm));
+    return (update_dirty(db, ptuple, lm));
 }
 
 w_rc_t customer_man_impl::cust_update_discount_balance_nl(ss_m* db,
@@ -545,7 +545,7 @@ w_rc_t order_man_impl::ord_update_carrier_by_index(ss_m* db,
     W_DO(index_probe_forupdate_by_name(db, "O_IDX", ptuple));
 
     ptuple->set_value(5, carrier_id);
-    W_DO(update_tuple(db, ptuple));
+    W_DO(update_dirty(db, ptuple));
 
     return (RCOK);
 }
@@ -564,7 +564,7 @@ w_rc_t order_man_impl::ord_update_carrier_by_index_nl(ss_m* db,
     W_DO(index_probe_nl_by_name(db, "O_IDX", ptuple));
 
     ptuple->set_value(5, carrier_id);
-    W_DO(update_tuple(db, ptuple, NL));
+    W_DO(update_dirty(db, ptuple, NL));
 
     return (RCOK);
 }
@@ -612,7 +612,10 @@ w_rc_t order_line_man_impl::ol_get_range_iter_by_index(ss_m* db,
     int highsz = format_key(pindex, ptuple, rephigh);
     assert (rephigh._dest);
     
-    // get the tuple iterator (not index only scan)
+    // get the tuple iterator. Without need_tuple it is an index only
+    // scan, which returns the key and OL_I_ID, if OL_IDX is covering
+    // (it is not if it is MRBT)
+    if (!pindex->is_covering()) need_tuple = true;
     W_DO(get_iter_for_index_scan(db, pindex, iter,
                                  alm, need_tuple,
 				 scan_index_i::ge, vec_t(replow._dest, lowsz),
@@ -782,7 +785,7 @@ w_rc_t  stock_man_impl::st_update_tuple(ss_m* db,
     ptuple->set_value(4, pstock->S_ORDER_CNT);
     ptuple->set_value(5, pstock->S_YTD);
     //    return (table_man_impl<stock_t>::update_tuple(db, ptuple));
-    return (update_tuple(db, ptuple, lm));
+    return (update_dirty(db, ptuple, lm));
 }
 
 w_rc_t  stock_man_impl::st_update_tuple_nl(ss_m* db,
@@ -1446,6 +1446,7 @@ w_rc_t ShoreTPCCEnv::xct_delivery(const int xct_id,
     w_rc_t e = _xct_delivery_helper(xct_id, pdin, dlist, d_id, SPLIT_TRX);
     while(SPLIT_TRX && e.is_error() && e.err_num() == smlevel_0::eDEADLOCK) {
 	W_COERCE(_pssm->abort_xct());
+	table_man_t::rec_cache_on_abort();
 	W_DO(_pssm->begin_xct());
 	atomic_inc_32(&delivery_abort_ctr);
 	dlist.push_back(d_id); // retry the failed trx
@@ -1610,7 +1611,7 @@ w_rc_t ShoreTPCCEnv::_xct_delivery_helper(const int xct_id,
 	    total_amount += current_amount;
 	    // update orderline
 	    prol->set_value(6, ts_start);
-	    W_DO(_porder_line_man->update_tuple(_pssm, prol));
+	    W_DO(_porder_line_man->update_dirty(_pssm, prol));
 	    // go to the next orderline
 	    W_DO(ol_iter->next(_pssm, eof, *prol));
 	}
@@ -1633,7 +1634,7 @@ w_rc_t ShoreTPCCEnv::_xct_delivery_helper(const int xct_id,
 	double   balance;
 	prcust->get_value(16, balance);
 	prcust->set_value(16, balance+total_amount);
-	W_DO(_pcustomer_man->update_tuple(_pssm, prcust));
+	W_DO(_pcustomer_man->update_dirty(_pssm, prcust));
 	
 	if(SPLIT_TRX && dlist.size()) {
 #ifdef CFG_FLUSHER
@@ -1717,7 +1718,7 @@ w_rc_t ShoreTPCCEnv::xct_stock_level(const int xct_id,
      *       AND s_w_id = :w_id AND s_i_id = ol_i_id
      *       AND s_quantity < :threshold;
      *
-     *   Plan: 1. index scan on OL_IDX 
+     *   Plan: 1. index-only scan on OL_IDX (covers ol_i_id)
      *         2. sort ol tuples in the order of i_id from 1
      *         3. index scan on S_IDX
      *         4. fetch stock with sargable on quantity from 3
@@ -1748,7 +1749,8 @@ w_rc_t ShoreTPCCEnv::xct_stock_level(const int xct_id,
 							  pslin._wh_id,
 							  pslin._d_id,
 							  next_o_id-20,
-							  next_o_id));
+							  next_o_id,
+							  SH, false));
 	ol_iter = tmp_ol_iter;
     }
     
@@ -611,6 +611,36 @@ char argv[20][100];
 	    return 0;
 	}
 
+	// Creates an additional generator over the customers
+	// [iStartFrom, iStartFrom+iCount), which shares the input files
+	// loaded by egen_init(). Used by the parallel TPC-E loader, which
+	// runs one generator per disjoint customer range. The caller
+	// frees the logger and its format after the generator.
+	CGenerateAndLoad* egen_range_init(TIdent iCount, TIdent iStartFrom,
+					  CEGenLogger*& pLog, CLogFormatTab*& pFmt)
+	{
+		assert(inputFiles!=NULL);
+
+		char szLogFileName[64];
+		snprintf(&szLogFileName[0], sizeof(szLogFileName),
+			 "EGenLoaderFrom %lldTo%lld.log",
+			 iStartFrom, (iStartFrom + iCount)-1);
+
+		// The generator keeps the logger, thus it is not on the stack
+		pFmt = new CLogFormatTab();
+		pLog = new CEGenLogger(eDriverEGenLoader, 0, szLogFileName, pFmt);
+
+		// The symbol map is built lazily on first use, which is not
+		// thread-safe, thus build it before the generators run
+		inputFiles->Securities->LoadSymbolToIdMap();
+
+		return (new CGenerateAndLoad(*inputFiles, iCount, iStartFrom,
+					     iTotalCustomerCount, iLoadUnitSize,
+					     iScaleFactor, iDaysOfInitialTrades,
+					     pLoaderFactory, pLog, Output, szInDir,
+					     bGenerateUsingCache));
+	}
+
 	CCETxnInputGenerator*  transactions_input_init(int customers, int sf, int wdays) 
 	{	
 	//	TDriverCETxnSettings		m_DriverCETxnSettings;
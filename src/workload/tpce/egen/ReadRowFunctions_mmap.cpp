@@ -0,0 +1,258 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   ReadRowFunctions_mmap.cpp
+ *
+ *  @brief:  Functions that read the rows of the input flat files from a
+ *           memory-mapped file (see MappedFile.h)
+ *
+ *  @note:   Each function mirrors, call by call, the istream version in
+ *           ReadRowFunctions_istream.cpp
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "workload/tpce/egen/EGenTables_stdafx.h"
+#include "workload/tpce/egen/MappedFile.h"
+
+using namespace TPCE;
+
+/*
+*   Function to read customer account names from the mapped file.
+*/
+void TAccountNameInputRow::Load(CMappedFileTokenizer &file)
+{
+    // need to eat end-of-line or it will be read into NAME
+    file.SkipWs();
+    file.GetUntil(NAME, sizeof(NAME), '\n');
+}
+
+/*
+*   Function to read phone row from the mapped file.
+*/
+void TAreaCodeInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(AREA_CODE, sizeof(AREA_CODE));
+}
+
+void TCompanyInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.Get(CO_ID);
+    file.GetWord(CO_ST_ID, sizeof(CO_ST_ID));
+    file.SkipWs();
+    file.GetUntil(CO_NAME, sizeof(CO_NAME), '\t');
+    file.GetWord(CO_IN_ID, sizeof(CO_IN_ID));
+    file.SkipWs();
+    file.GetUntil(CO_DESC, sizeof(CO_DESC), '\n');
+}
+
+/*
+*   Function to read CompanyCompetitor row from the mapped file.
+*/
+void TCompanyCompetitorInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.Get(CP_CO_ID);
+    file.Get(CP_COMP_CO_ID);
+    file.SkipWs();
+    file.GetUntil(CP_IN_ID, sizeof(CP_IN_ID), '\n');
+}
+
+/*
+*   Function to read Company SP Rate row from the mapped file.
+*/
+void TCompanySPRateInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.SkipWs();
+    file.GetUntil(CO_SP_RATE, sizeof(CO_SP_RATE), '\n');
+}
+
+/*
+*   Functions to read first/last name rows from the mapped file.
+*/
+void TFirstNameInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(FIRST_NAME, sizeof(FIRST_NAME));   //one field only
+}
+
+void TLastNameInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(LAST_NAME, sizeof(LAST_NAME));     //one field only
+}
+
+void TNewsInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(WORD, sizeof(WORD));               //one field only
+}
+
+void TSecurityInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.Get(S_ID);
+    file.GetWord(S_ST_ID, sizeof(S_ST_ID));
+    file.GetWord(S_SYMB, sizeof(S_SYMB));
+    file.GetWord(S_ISSUE, sizeof(S_ISSUE));
+    file.GetWord(S_EX_ID, sizeof(S_EX_ID));
+    file.Get(S_CO_ID);
+}
+
+/*
+*   Function to read one row from the mapped file.
+*/
+void TStreetNameInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.SkipWs();
+    file.GetUntil(STREET, sizeof(STREET), '\n');    //read up to the delimiter
+}
+
+/*
+*   Function to read one row from the mapped file.
+*/
+void TStreetSuffixInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.SkipWs();
+    file.GetUntil(SUFFIX, sizeof(SUFFIX), '\n');    //read up to the delimiter
+}
+
+/*
+*   Function to read row from the mapped file.
+*/
+void TTaxRateInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(TAX_ID, sizeof(TAX_ID));
+    file.SkipWs();  //advance past whitespace to the next field
+    file.GetUntil(TAX_NAME, sizeof(TAX_NAME), '\t');
+    //now read the actual taxrate
+    file.Get(TAX_RATE);
+}
+
+/*
+*   Function to read one row from the mapped file.
+*/
+void TZipCodeInputRow::Load(CMappedFileTokenizer &file)
+{
+    file.Get(iDivisionTaxKey);
+    file.SkipWs();
+    file.GetUntil(ZC_CODE, sizeof(ZC_CODE), '\t');
+    file.SkipWs();
+    file.GetUntil(ZC_TOWN, sizeof(ZC_TOWN), '\t');  //read up to the delimiter
+    file.SkipWs();
+    file.GetUntil(ZC_DIV, sizeof(ZC_DIV), '\n');
+}
+
+/***********************************************************************************
+*
+* Tables that are fully represented by flat files (no additional processing needed).
+*
+************************************************************************************/
+
+/*
+*   CHARGE
+*/
+void CHARGE_ROW::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(CH_TT_ID, sizeof(CH_TT_ID));
+    file.Get(CH_C_TIER);
+    file.Get(CH_CHRG);
+}
+
+/*
+*   COMMISSION_RATE
+*/
+void COMMISSION_RATE_ROW::Load(CMappedFileTokenizer &file)
+{
+    file.Get(CR_C_TIER);
+    file.GetWord(CR_TT_ID, sizeof(CR_TT_ID));
+    file.GetWord(CR_EX_ID, sizeof(CR_EX_ID));
+    file.Get(CR_FROM_QTY);
+    file.Get(CR_TO_QTY);
+    file.Get(CR_RATE);
+}
+
+/*
+*   EXCHANGE
+*/
+void EXCHANGE_ROW::Load(CMappedFileTokenizer &file)
+{
+    file.SkipWs();
+    file.GetUntil(EX_ID, sizeof(EX_ID), '\t');      //read up to the next tab
+    file.SkipWs();
+    file.GetUntil(EX_NAME, sizeof(EX_NAME), '\t');  //read up to the delimiter
+    file.Get(EX_OPEN);
+    file.Get(EX_CLOSE);
+    file.SkipWs();
+    file.GetUntil(EX_DESC, sizeof(EX_DESC), '\t');  //read up to the delimiter
+    file.Get(EX_AD_ID);
+}
+
+/*
+*   INDUSTRY
+*/
+void INDUSTRY_ROW::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(IN_ID, sizeof(IN_ID));
+    file.SkipWs();
+    file.GetUntil(IN_NAME, sizeof(IN_NAME), '\t');  //read up to the delimiter
+    file.GetWord(IN_SC_ID, sizeof(IN_SC_ID));
+}
+
+/*
+*   SECTOR
+*/
+void SECTOR_ROW::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(SC_ID, sizeof(SC_ID));
+    file.SkipWs();                                  //skip past the next tab
+    file.GetUntil(SC_NAME, sizeof(SC_NAME), '\n');  //read up to the delimiter
+}
+
+/*
+*   STATUS_TYPE
+*/
+void STATUS_TYPE_ROW::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(ST_ID, sizeof(ST_ID));
+    file.SkipWs();
+    file.GetUntil(ST_NAME, sizeof(ST_NAME), '\n');
+}
+
+/*
+*   TRADE_TYPE
+*/
+void TRADE_TYPE_ROW::Load(CMappedFileTokenizer &file)
+{
+    file.GetWord(TT_ID, sizeof(TT_ID));
+    file.SkipWs();
+    file.GetUntil(TT_NAME, sizeof(TT_NAME), '\t');
+    file.Get(TT_IS_SELL);
+    file.Get(TT_IS_MRKT);
+}
+
+/*
+*   ZIP_CODE
+*/
+void ZIP_CODE_ROW::Load(CMappedFileTokenizer &file)
+{
+    file.GetUntil(ZC_TOWN, sizeof(ZC_TOWN), '\t');  //read up to the delimiter
+    file.GetWord(ZC_DIV, sizeof(ZC_DIV));
+    file.GetWord(ZC_CODE, sizeof(ZC_CODE));
+    file.SkipWs();
+}
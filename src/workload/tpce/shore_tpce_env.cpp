@@ -30,6 +30,7 @@
  */
 
 #include "workload/tpce/shore_tpce_env.h"
+#include "workload/tpce/shore_tpce_loader.h"
 #include "sm/shore/shore_helper_loader.h"
 
 #include <w_defines.h>
@@ -620,22 +621,8 @@ public:
 
 void ShoreTPCEEnv::table_builder_t::work() 
 {
-    w_rc_t e = RCOK;
-
     //populating fixed
-    populate_small_input_t in;
-    long log_space_needed = 0;
-    _env->read_small();
- retry:
-    W_COERCE(_env->db()->begin_xct());
-
-    if(log_space_needed > 0) {
-        W_COERCE(_env->db()->xct_reserve_log_space(log_space_needed));
-    }
-
-    e = _env->xct_populate_small(1, in);    
-    CHECK_XCT_RETURN(e,log_space_needed,retry,_env);
-    _env->release_small();
+    _env->populate_small();
 
     //populating scaling tables
     _env->populate_address(); 
@@ -798,8 +785,22 @@ w_rc_t ShoreTPCEEnv::loaddata()
  
 
     // 4. Fire up the loaders
-    TRACE( TRACE_ALWAYS, "Firing up %d loaders ..\n", 1);
-    {
+#ifdef COMPILE_FLAT_FILE_LOAD
+    // the flat files are written by the single EGen instance
+    int egen_loaders = 0;
+#else
+    int egen_loaders = envVar::instance()->getVarInt("tpce-egen-loaders",
+                                                     TPCE_EGEN_LOADERS);
+#endif
+    if (egen_loaders > 0) {
+        int inserters = envVar::instance()->getVarInt("db-loaders",
+                                                      TPCE_LOAD_INSERTERS);
+        int qsize = envVar::instance()->getVarInt("tpce-load-queue",
+                                                  TPCE_LOAD_QUEUE);
+        pipelined_load(egen_loaders, inserters, qsize);
+    }
+    else {
+      TRACE( TRACE_ALWAYS, "Firing up %d loaders ..\n", 1);
       guard<table_builder_t>loader = new table_builder_t(this);
       // array_guard_t< guard<table_builder_t> > loaders(new guard<table_builder_t>[loaders_to_use]);
       loader->fork();
@@ -841,13 +842,13 @@ w_rc_t ShoreTPCEEnv::check_consistency()
  * @fn:    warmup()
  *
  * @brief: Touches the entire database - For memory-fitting databases
- *         this is enough to bring it to load it to memory
+ *         this is enough to bring it to load it to memory.
  *
  ******************************************************************/
 
 w_rc_t ShoreTPCEEnv::warmup()
 {
-    return (check_consistency());
+    return (warmup_bufpool());
 }
 
 
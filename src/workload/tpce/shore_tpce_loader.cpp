@@ -0,0 +1,636 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_tpce_loader.cpp
+ *
+ *  @brief:  Implementation of the pipelined TPC-E loader
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "workload/tpce/shore_tpce_loader.h"
+
+using namespace shore;
+using namespace TPCE;
+
+
+ENTER_NAMESPACE(tpce);
+
+
+// Rows per batch, the same as the capacities of the EgenTupleContainer
+// buffers used by the baseline loader
+const uint_t EB_ADDRESS            = 1000;
+const uint_t EB_CUSTOMER           = 1000;
+const uint_t EB_CUSTOMER_ACCOUNT   = 1000;
+const uint_t EB_CUSTOMER_TAXRATE   = 2000;
+const uint_t EB_WATCH_LIST         = 1000;
+const uint_t EB_COMPANY            = 1000;
+const uint_t EB_COMPANY_COMPETITOR = 3000;
+const uint_t EB_DAILY_MARKET       = 3000;
+const uint_t EB_FINANCIAL          = 1500;
+const uint_t EB_LAST_TRADE         = 1000;
+const uint_t EB_NEWS_ITEM          = 200;
+const uint_t EB_SECURITY           = 1000;
+const uint_t EB_TRADE              = 10000;
+const uint_t EB_BROKER             = 100;
+const uint_t EB_HOLDING_SUMMARY    = 6000;
+const uint_t EB_HOLDING            = 10000;
+
+
+
+/******************************************************************
+ *
+ * @class: egen_batch_queue_t
+ *
+ ******************************************************************/
+
+egen_batch_queue_t::egen_batch_queue_t(const uint_t cap, const int producers)
+    : _lock(thread_mutex_create()),
+      _not_empty(thread_cond_create()),
+      _not_full(thread_cond_create()),
+      _cap(cap), _producers(producers)
+{
+    assert (_cap>0);
+    assert (_producers>0);
+}
+
+egen_batch_queue_t::~egen_batch_queue_t()
+{
+    assert (_batches.empty());
+    thread_cond_destroy(_not_full);
+    thread_cond_destroy(_not_empty);
+    thread_mutex_destroy(_lock);
+}
+
+void egen_batch_queue_t::push(egen_batch_t* pbatch)
+{
+    assert (pbatch);
+    thread_mutex_lock(_lock);
+    while (_batches.size() >= _cap) {
+        thread_cond_wait(_not_full, _lock);
+    }
+    _batches.push_back(pbatch);
+    thread_cond_signal(_not_empty);
+    thread_mutex_unlock(_lock);
+}
+
+egen_batch_t* egen_batch_queue_t::pop()
+{
+    egen_batch_t* pbatch = NULL;
+    thread_mutex_lock(_lock);
+    while (_batches.empty() && (_producers>0)) {
+        thread_cond_wait(_not_empty, _lock);
+    }
+    if (!_batches.empty()) {
+        pbatch = _batches.front();
+        _batches.pop_front();
+        thread_cond_signal(_not_full);
+    }
+    thread_mutex_unlock(_lock);
+    return (pbatch);
+}
+
+void egen_batch_queue_t::producer_done()
+{
+    thread_mutex_lock(_lock);
+    assert (_producers>0);
+    if (--_producers == 0) {
+        // wake up all the inserters, so that they see the end
+        thread_cond_broadcast(_not_empty);
+    }
+    thread_mutex_unlock(_lock);
+}
+
+
+
+/******************************************************************
+ *
+ * @class: egen_generator_t
+ *
+ * @brief: Generates the tables of one group from one EGen instance,
+ *         following the _read_X() functions of the baseline loader
+ *
+ ******************************************************************/
+
+class ShoreTPCEEnv::egen_generator_t : public thread_t
+{
+public:
+    enum group_t { EG_CUSTOMER, EG_MARKET, EG_GROWING };
+
+private:
+    ShoreTPCEEnv*       _env;
+    CGenerateAndLoad*   _pgen;
+    group_t             _group;
+    egen_batch_queue_t* _pqueue;
+
+    // tables with one row per hasNextX() call
+    template <class Row>
+    void _gen_table(table_man_t* pman,
+                    typename egen_rows_t<Row>::load_one_fn fn,
+                    bool (CGenerateAndLoad::*has_next)(),
+                    Row* (CGenerateAndLoad::*get_row)(),
+                    const uint_t cap)
+    {
+        bool hasNext;
+        do {
+            egen_batch_t* pbatch = new egen_batch_t();
+            egen_rows_t<Row>* prows = pbatch->add<Row>(pman, fn, cap);
+            do {
+                hasNext = (_pgen->*has_next)();
+                prows->append((_pgen->*get_row)());
+            } while (hasNext && (prows->size() < cap));
+            _pqueue->push(pbatch);
+        } while (hasNext);
+    }
+
+    void _gen_customer_tables();
+    void _gen_market_tables();
+    void _gen_growing_tables();
+
+public:
+
+    egen_generator_t(ShoreTPCEEnv* env, CGenerateAndLoad* pgen,
+                     const group_t group, egen_batch_queue_t* pqueue,
+                     const int id)
+        : thread_t(c_str("TPC-E gen-%d-%d", id, (int)group)),
+          _env(env), _pgen(pgen), _group(group), _pqueue(pqueue)
+    {
+        assert (_env);
+        assert (_pgen);
+        assert (_pqueue);
+    }
+    ~egen_generator_t() { }
+
+    virtual void work();
+
+}; // EOF: egen_generator_t
+
+
+void ShoreTPCEEnv::egen_generator_t::work()
+{
+    switch (_group) {
+    case EG_CUSTOMER: _gen_customer_tables(); break;
+    case EG_MARKET:   _gen_market_tables(); break;
+    case EG_GROWING:  _gen_growing_tables(); break;
+    default: assert (0);
+    }
+    _pqueue->producer_done();
+}
+
+
+// ADDRESS, CUSTOMER, CUSTOMER_ACCOUNT and ACCOUNT_PERMISSION,
+// CUSTOMER_TAXRATE, WATCH_LIST and WATCH_ITEM
+void ShoreTPCEEnv::egen_generator_t::_gen_customer_tables()
+{
+    bool hasNext;
+
+    _pgen->InitAddress();
+    _gen_table<ADDRESS_ROW>(_env->address_man(),
+                            &ShoreTPCEEnv::_load_one_address,
+                            &CGenerateAndLoad::hasNextAddress,
+                            &CGenerateAndLoad::getAddressRow,
+                            EB_ADDRESS);
+    _pgen->ReleaseAddress();
+
+    _pgen->InitCustomer();
+    _gen_table<CUSTOMER_ROW>(_env->customer_man(),
+                             &ShoreTPCEEnv::_load_one_customer,
+                             &CGenerateAndLoad::hasNextCustomer,
+                             &CGenerateAndLoad::getCustomerRow,
+                             EB_CUSTOMER);
+    _pgen->ReleaseCustomer();
+
+    _pgen->InitCustomerAccountAndAccountPermission();
+    do {
+        egen_batch_t* pbatch = new egen_batch_t();
+        egen_rows_t<CUSTOMER_ACCOUNT_ROW>* pca =
+            pbatch->add<CUSTOMER_ACCOUNT_ROW>(_env->customer_account_man(),
+                                              &ShoreTPCEEnv::_load_one_customer_account,
+                                              EB_CUSTOMER_ACCOUNT);
+        egen_rows_t<ACCOUNT_PERMISSION_ROW>* pap =
+            pbatch->add<ACCOUNT_PERMISSION_ROW>(_env->account_permission_man(),
+                                                &ShoreTPCEEnv::_load_one_account_permission,
+                                                3*EB_CUSTOMER_ACCOUNT);
+        do {
+            hasNext = _pgen->hasNextCustomerAccount();
+            pca->append(_pgen->getCustomerAccountRow());
+            int perms = _pgen->PermissionsPerCustomer();
+            for (int i=0; i<perms; i++) {
+                pap->append(_pgen->getAccountPermissionRow(i));
+            }
+        } while (hasNext && (pca->size() < EB_CUSTOMER_ACCOUNT));
+        _pqueue->push(pbatch);
+    } while (hasNext);
+    _pgen->ReleaseCustomerAccountAndAccountPermission();
+
+    _pgen->InitCustomerTaxrate();
+    int taxrates = _pgen->getTaxratesCount();
+    do {
+        egen_batch_t* pbatch = new egen_batch_t();
+        egen_rows_t<CUSTOMER_TAXRATE_ROW>* pcx =
+            pbatch->add<CUSTOMER_TAXRATE_ROW>(_env->customer_taxrate_man(),
+                                              &ShoreTPCEEnv::_load_one_customer_taxrate,
+                                              EB_CUSTOMER_TAXRATE);
+        do {
+            hasNext = _pgen->hasNextCustomerTaxrate();
+            for (int i=0; i<taxrates; i++) {
+                pcx->append(_pgen->getCustomerTaxrateRow(i));
+            }
+        } while (hasNext && (pcx->size() < EB_CUSTOMER_TAXRATE));
+        _pqueue->push(pbatch);
+    } while (hasNext);
+    _pgen->ReleaseCustomerTaxrate();
+
+    _pgen->InitWatchListAndWatchItem();
+    do {
+        egen_batch_t* pbatch = new egen_batch_t();
+        egen_rows_t<WATCH_LIST_ROW>* pwl =
+            pbatch->add<WATCH_LIST_ROW>(_env->watch_list_man(),
+                                        &ShoreTPCEEnv::_load_one_watch_list,
+                                        EB_WATCH_LIST);
+        egen_rows_t<WATCH_ITEM_ROW>* pwi =
+            pbatch->add<WATCH_ITEM_ROW>(_env->watch_item_man(),
+                                        &ShoreTPCEEnv::_load_one_watch_item,
+                                        iMaxItemsInWL*EB_WATCH_LIST);
+        do {
+            hasNext = _pgen->hasNextWatchList();
+            pwl->append(_pgen->getWatchListRow());
+            int items = _pgen->ItemsPerWatchList();
+            for (int i=0; i<items; ++i) {
+                pwi->append(_pgen->getWatchItemRow(i));
+            }
+        } while (hasNext && (pwl->size() < EB_WATCH_LIST));
+        _pqueue->push(pbatch);
+    } while (hasNext);
+    _pgen->ReleaseWatchListAndWatchItem();
+}
+
+
+// COMPANY, COMPANY_COMPETITOR, DAILY_MARKET, FINANCIAL, LAST_TRADE,
+// NEWS_ITEM and NEWS_XREF, SECURITY
+void ShoreTPCEEnv::egen_generator_t::_gen_market_tables()
+{
+    _pgen->InitCompany();
+    _gen_table<COMPANY_ROW>(_env->company_man(),
+                            &ShoreTPCEEnv::_load_one_company,
+                            &CGenerateAndLoad::hasNextCompany,
+                            &CGenerateAndLoad::getCompanyRow,
+                            EB_COMPANY);
+    _pgen->ReleaseCompany();
+
+    _pgen->InitCompanyCompetitor();
+    _gen_table<COMPANY_COMPETITOR_ROW>(_env->company_competitor_man(),
+                                       &ShoreTPCEEnv::_load_one_company_competitor,
+                                       &CGenerateAndLoad::hasNextCompanyCompetitor,
+                                       &CGenerateAndLoad::getCompanyCompetitorRow,
+                                       EB_COMPANY_COMPETITOR);
+    _pgen->ReleaseCompanyCompetitor();
+
+    _pgen->InitDailyMarket();
+    _gen_table<DAILY_MARKET_ROW>(_env->daily_market_man(),
+                                 &ShoreTPCEEnv::_load_one_daily_market,
+                                 &CGenerateAndLoad::hasNextDailyMarket,
+                                 &CGenerateAndLoad::getDailyMarketRow,
+                                 EB_DAILY_MARKET);
+    _pgen->ReleaseDailyMarket();
+
+    _pgen->InitFinancial();
+    _gen_table<FINANCIAL_ROW>(_env->financial_man(),
+                              &ShoreTPCEEnv::_load_one_financial,
+                              &CGenerateAndLoad::hasNextFinancial,
+                              &CGenerateAndLoad::getFinancialRow,
+                              EB_FINANCIAL);
+    _pgen->ReleaseFinancial();
+
+    _pgen->InitLastTrade();
+    _gen_table<LAST_TRADE_ROW>(_env->last_trade_man(),
+                               &ShoreTPCEEnv::_load_one_last_trade,
+                               &CGenerateAndLoad::hasNextLastTrade,
+                               &CGenerateAndLoad::getLastTradeRow,
+                               EB_LAST_TRADE);
+    _pgen->ReleaseLastTrade();
+
+    _pgen->InitNewsItemAndNewsXRef();
+    bool hasNext;
+    do {
+        egen_batch_t* pbatch = new egen_batch_t();
+        egen_rows_t<NEWS_XREF_ROW>* pnx =
+            pbatch->add<NEWS_XREF_ROW>(_env->news_xref_man(),
+                                       &ShoreTPCEEnv::_load_one_news_xref,
+                                       EB_NEWS_ITEM);
+        egen_rows_t<NEWS_ITEM_ROW>* pni =
+            pbatch->add<NEWS_ITEM_ROW>(_env->news_item_man(),
+                                       &ShoreTPCEEnv::_load_one_news_item,
+                                       EB_NEWS_ITEM);
+        do {
+            hasNext = _pgen->hasNextNewsItemAndNewsXRef();
+            pni->append(_pgen->getNewsItemRow());
+            pnx->append(_pgen->getNewsXRefRow());
+        } while (hasNext && (pni->size() < EB_NEWS_ITEM));
+        _pqueue->push(pbatch);
+    } while (hasNext);
+    _pgen->ReleaseNewsItemAndNewsXRef();
+
+    _pgen->InitSecurity();
+    _gen_table<SECURITY_ROW>(_env->security_man(),
+                             &ShoreTPCEEnv::_load_one_security,
+                             &CGenerateAndLoad::hasNextSecurity,
+                             &CGenerateAndLoad::getSecurityRow,
+                             EB_SECURITY);
+    _pgen->ReleaseSecurity();
+}
+
+
+// TRADE, TRADE_HISTORY, SETTLEMENT, CASH_TRANSACTION, HOLDING_HISTORY,
+// BROKER, HOLDING_SUMMARY and HOLDING, one load unit at a time
+void ShoreTPCEEnv::egen_generator_t::_gen_growing_tables()
+{
+    bool hasNext;
+
+    _pgen->InitHoldingAndTrade();
+    do {
+        // the trades of the load unit, with their history,
+        // settlement and cash transaction rows
+        do {
+            egen_batch_t* pbatch = new egen_batch_t();
+            egen_rows_t<TRADE_ROW>* pt =
+                pbatch->add<TRADE_ROW>(_env->trade_man(),
+                                       &ShoreTPCEEnv::_load_one_trade,
+                                       EB_TRADE);
+            egen_rows_t<TRADE_HISTORY_ROW>* pth =
+                pbatch->add<TRADE_HISTORY_ROW>(_env->trade_history_man(),
+                                               &ShoreTPCEEnv::_load_one_trade_history,
+                                               3*EB_TRADE);
+            egen_rows_t<SETTLEMENT_ROW>* pse =
+                pbatch->add<SETTLEMENT_ROW>(_env->settlement_man(),
+                                            &ShoreTPCEEnv::_load_one_settlement,
+                                            EB_TRADE);
+            egen_rows_t<CASH_TRANSACTION_ROW>* pct =
+                pbatch->add<CASH_TRANSACTION_ROW>(_env->cash_transaction_man(),
+                                                  &ShoreTPCEEnv::_load_one_cash_transaction,
+                                                  EB_TRADE);
+            egen_rows_t<HOLDING_HISTORY_ROW>* phh =
+                pbatch->add<HOLDING_HISTORY_ROW>(_env->holding_history_man(),
+                                                 &ShoreTPCEEnv::_load_one_holding_history,
+                                                 2*EB_TRADE);
+            do {
+                hasNext = _pgen->hasNextTrade();
+                pt->append(_pgen->getTradeRow());
+                int hist = _pgen->getTradeHistoryRowCount();
+                for (int i=0; i<hist; i++) {
+                    pth->append(_pgen->getTradeHistoryRow(i));
+                }
+                if (_pgen->shouldProcessSettlementRow()) {
+                    pse->append(_pgen->getSettlementRow());
+                }
+                if (_pgen->shouldProcessCashTransactionRow()) {
+                    pct->append(_pgen->getCashTransactionRow());
+                }
+                hist = _pgen->getHoldingHistoryRowCount();
+                for (int i=0; i<hist; i++) {
+                    phh->append(_pgen->getHoldingHistoryRow(i));
+                }
+            } while (hasNext && (pt->size() < EB_TRADE));
+            _pqueue->push(pbatch);
+        } while (hasNext);
+
+        _gen_table<BROKER_ROW>(_env->broker_man(),
+                               &ShoreTPCEEnv::_load_one_broker,
+                               &CGenerateAndLoad::hasNextBroker,
+                               &CGenerateAndLoad::getBrokerRow,
+                               EB_BROKER);
+        _gen_table<HOLDING_SUMMARY_ROW>(_env->holding_summary_man(),
+                                        &ShoreTPCEEnv::_load_one_holding_summary,
+                                        &CGenerateAndLoad::hasNextHoldingSummary,
+                                        &CGenerateAndLoad::getHoldingSummaryRow,
+                                        EB_HOLDING_SUMMARY);
+        _gen_table<HOLDING_ROW>(_env->holding_man(),
+                                &ShoreTPCEEnv::_load_one_holding,
+                                &CGenerateAndLoad::hasNextHolding,
+                                &CGenerateAndLoad::getHoldingRow,
+                                EB_HOLDING);
+    } while (_pgen->hasNextLoadUnit());
+    _pgen->ReleaseHoldingAndTrade();
+}
+
+
+
+/******************************************************************
+ *
+ * @class: egen_inserter_t
+ *
+ * @brief: Inserts the batches of the queue, each in one xct
+ *
+ ******************************************************************/
+
+class ShoreTPCEEnv::egen_inserter_t : public thread_t
+{
+    ShoreTPCEEnv*       _env;
+    egen_batch_queue_t* _pqueue;
+    uint64_t            _rows;
+    uint_t              _xcts;
+
+    w_rc_t _load(egen_batch_t* pbatch)
+    {
+        W_DO(pbatch->load(_env));
+        return (_env->db()->commit_xct());
+    }
+
+public:
+
+    egen_inserter_t(ShoreTPCEEnv* env, egen_batch_queue_t* pqueue, const int id)
+        : thread_t(c_str("TPC-E ins-%d", id)),
+          _env(env), _pqueue(pqueue), _rows(0), _xcts(0)
+    {
+        assert (_env);
+        assert (_pqueue);
+    }
+    ~egen_inserter_t() { }
+
+    uint64_t rows() const { return (_rows); }
+    uint_t xcts() const { return (_xcts); }
+
+    virtual void work();
+
+}; // EOF: egen_inserter_t
+
+
+void ShoreTPCEEnv::egen_inserter_t::work()
+{
+    egen_batch_t* pbatch = NULL;
+    while ((pbatch = _pqueue->pop()) != NULL) {
+        long log_space_needed = 0;
+    retry:
+        W_COERCE(_env->db()->begin_xct());
+
+        if (log_space_needed > 0) {
+            W_COERCE(_env->db()->xct_reserve_log_space(log_space_needed));
+        }
+
+        w_rc_t e = _load(pbatch);
+        CHECK_XCT_RETURN(e,log_space_needed,retry,_env);
+
+        _rows += pbatch->rows();
+        ++_xcts;
+        delete (pbatch);
+    }
+}
+
+
+
+/******************************************************************
+ *
+ * @class: egen_loader_t
+ *
+ * @brief: Loads the fixed tables, then forks the generators and the
+ *         inserters of the pipelined load and waits for them
+ *
+ ******************************************************************/
+
+class ShoreTPCEEnv::egen_loader_t : public thread_t
+{
+    ShoreTPCEEnv* _env;
+    int           _gens;
+    int           _inserters;
+    int           _qsize;
+
+public:
+
+    egen_loader_t(ShoreTPCEEnv* env, const int gens,
+                  const int inserters, const int qsize)
+        : thread_t("TPC-E pipelined loader"), _env(env),
+          _gens(gens), _inserters(inserters), _qsize(qsize)
+    {
+        assert (_env);
+        assert (_gens>0);
+        assert (_inserters>0);
+        assert (_qsize>0);
+    }
+    ~egen_loader_t() { }
+
+    virtual void work();
+
+}; // EOF: egen_loader_t
+
+
+// An EGen generator over a customer range, with the logger it uses.
+// The members are destroyed in reverse order: generator, logger, format.
+struct egen_range_t
+{
+    guard<CLogFormatTab>    _fmt;
+    guard<CEGenLogger>      _log;
+    guard<CGenerateAndLoad> _gen;
+};
+
+
+void ShoreTPCEEnv::egen_loader_t::work()
+{
+    // 1. The fixed tables, from the EGen instance of egen_init()
+    _env->populate_small();
+
+    // 2. Split the customers to the EGen instances, in load units
+    const int units = _env->_customers / iDefaultLoadUnitSize;
+    assert (units>0);
+    int gens = (_gens < units ? _gens : units);
+
+    array_guard_t<egen_range_t> pgens(new egen_range_t[gens]);
+    TIdent start = iDefaultStartFromCustomer;
+    for (int i=0; i<gens; i++) {
+        TIdent count = (units/gens + (i < (units%gens) ? 1 : 0)) * iDefaultLoadUnitSize;
+        TRACE( TRACE_ALWAYS, "EGen (%d) customers [%lld,%lld]\n",
+               i, start, start+count-1);
+        CEGenLogger* plog = NULL;
+        CLogFormatTab* pfmt = NULL;
+        pgens[i]._gen = egen_range_init(count, start, plog, pfmt);
+        pgens[i]._log = plog;
+        pgens[i]._fmt = pfmt;
+        start += count;
+    }
+
+    // 3. Fire up the inserters and one generator per group and instance
+    const int groups = 3;
+    egen_batch_queue_t queue(_qsize, gens*groups);
+    stopwatch_t timer;
+
+    TRACE( TRACE_ALWAYS, "Firing up %d generators and %d inserters ..\n",
+           gens*groups, _inserters);
+
+    array_guard_t< guard<egen_inserter_t> > inserters(new guard<egen_inserter_t>[_inserters]);
+    for (int i=0; i<_inserters; i++) {
+        inserters[i] = new egen_inserter_t(_env, &queue, i);
+        inserters[i]->fork();
+    }
+
+    array_guard_t< guard<egen_generator_t> > generators(new guard<egen_generator_t>[gens*groups]);
+    for (int i=0; i<gens; i++) {
+        for (int g=0; g<groups; g++) {
+            generators[i*groups+g] =
+                new egen_generator_t(_env, pgens[i]._gen.get(),
+                                     (egen_generator_t::group_t)g, &queue, i);
+            generators[i*groups+g]->fork();
+        }
+    }
+
+    for (int i=0; i<gens*groups; i++) {
+        generators[i]->join();
+    }
+
+    uint64_t rows = 0;
+    uint_t xcts = 0;
+    for (int i=0; i<_inserters; i++) {
+        inserters[i]->join();
+        rows += inserters[i]->rows();
+        xcts += inserters[i]->xcts();
+    }
+
+    double secs = timer.time();
+    TRACE( TRACE_ALWAYS, "Loaded (%lld) rows in (%d) xcts in (%.1f) secs (%.0f rows/sec)\n",
+           (long long)rows, xcts, secs, (secs>0 ? rows/secs : 0));
+
+    // Release the generators, then their loggers
+    pgens.done();
+
+    // 4. The next trade id, after the loaded trades
+    _env->find_maxtrade_id();
+}
+
+
+
+/******************************************************************
+ *
+ * @fn:    pipelined_load()
+ *
+ * @brief: Runs the pipelined loader, from the context of loaddata()
+ *
+ ******************************************************************/
+
+void ShoreTPCEEnv::pipelined_load(const int gens, const int inserters,
+                                  const int qsize)
+{
+    guard<egen_loader_t> loader = new egen_loader_t(this, gens, inserters, qsize);
+    loader->fork();
+    loader->join();
+}
+
+
+EXIT_NAMESPACE(tpce);
@@ -360,6 +360,15 @@ trade_t::trade_t(const uint4_t& pd)
     create_primary_idx_desc("T_INDEX", 0, keys, 1, pd); //unique
     create_index_desc("T_INDEX_2", 0, keys2, 3, true, false, pd); //non-unique
     create_index_desc("T_INDEX_3", 0, keys3, 2, false, false, pd); //non-unique
+
+    // The entries carry the fields read by the TRADE-LOOKUP frames, which
+    // then do not need to read the trades (T_ID is in the key of all)
+    uint  payload[5] = { 3, 4, 7, 9, 10 };           // frame 1
+    uint  payload2[4] = { 4, 7, 9, 10 };             // frame 2
+    uint  payload3[7] = { 0, 3, 4, 6, 8, 9, 10 };    // frame 3
+    W_COERCE(set_index_payload("T_INDEX", payload, 5));
+    W_COERCE(set_index_payload("T_INDEX_2", payload2, 4));
+    W_COERCE(set_index_payload("T_INDEX_3", payload3, 7));
 }
 
 
@@ -424,6 +433,9 @@ trade_type_t::trade_type_t(const uint4_t& pd)
 
     create_primary_idx_desc("TT_INDEX", 0, keys, 1, pd); //unique
 
+    // read-only, only 5 rows
+    set_rec_cache(16, true);
+
 }
 
 
@@ -642,6 +654,9 @@ security_t::security_t(const uint4_t& pd)
     //create_index_desc("S_INDEX_2", 0, keys2, 4); //unique
     //create_index_desc("S_INDEX_3", 0, keys3, 3); //unique
     create_index_desc("S_INDEX_4", 0, keys4, 3, true, false, pd); //unique
+
+    // read-mostly
+    set_rec_cache(1<<14);
 }
 
 
@@ -675,6 +690,9 @@ status_type_t::status_type_t(const uint4_t& pd)
     uint  keys[1] = { 0 };
 	
     create_primary_idx_desc("ST_INDEX", 0, keys, 1, pd);
+
+    // read-only, only 5 rows
+    set_rec_cache(16, true);
 }
 
 
@@ -1508,6 +1508,13 @@ w_rc_t trade_man_impl::t_index_probe(ss_m* db, trade_tuple* ptuple, const TIdent
     return (index_probe_by_name(db, "T_INDEX", ptuple));
 }
 
+w_rc_t trade_man_impl::t_index_probe_covered(ss_m* db, trade_tuple* ptuple, const TIdent trade_id)
+{
+    assert (ptuple);    
+    ptuple->set_value(0, trade_id);
+    return (index_probe_covered(db, _ptable->find_index("T_INDEX"), ptuple));
+}
+
 w_rc_t trade_man_impl::t_update_tax_by_index(ss_m* db,
                                              trade_tuple* ptuple,
                                              const TIdent t_id,
@@ -1326,6 +1326,23 @@ w_rc_t ShoreTPCEEnv::xct_populate_small(const int xct_id,
     return (_pssm->commit_xct());
 }
 
+void ShoreTPCEEnv::populate_small()
+{
+    populate_small_input_t in;
+    long log_space_needed = 0;
+    read_small();
+ retry:
+    W_COERCE(this->db()->begin_xct());
+
+    if(log_space_needed > 0) {
+        W_COERCE(this->db()->xct_reserve_log_space(log_space_needed));
+    }
+
+    CHECK_XCT_RETURN(this->xct_populate_small(1, in),
+		     log_space_needed, retry, this);
+    release_small();
+}
+
 //customer
 w_rc_t ShoreTPCEEnv::xct_populate_customer(const int xct_id,
 					   populate_customer_input_t& ptoin)
@@ -125,10 +125,11 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	     *		T_ID = trade_id[i] and
 	     *		T_TT_ID = TT_ID
 	     */		
+	    // the fields are carried by the entries of T_INDEX
 	    TRACE( TRACE_TRX_FLOW, "App: %d TL:t-idx-probe (%ld) \n",
 		   xct_id, ptlin._trade_id[num_found]);
-	    W_DO(_ptrade_man->t_index_probe(_pssm, prtrade,
-					    ptlin._trade_id[num_found]));
+	    W_DO(_ptrade_man->t_index_probe_covered(_pssm, prtrade,
+						    ptlin._trade_id[num_found]));
 
 	    prtrade->get_value(4, is_cash[num_found]);
 	    prtrade->get_value(7, bid_price[num_found]);
@@ -246,6 +247,8 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	 *	order by
 	 *		T_DTS asc
 	 */	
+	// index-only scan, if the entries of T_INDEX_2 carry the fields
+	bool need_tuple = !_ptrade_desc->find_index("T_INDEX_2")->is_covering();
 	guard<index_scan_iter_impl<trade_t> > t_iter;
 	{
 	    index_scan_iter_impl<trade_t>* tmp_t_iter;
@@ -256,7 +259,8 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 						   lowrep, highrep,
 						   ptlin._acct_id,
 						   ptlin._start_trade_dts,
-						   ptlin._end_trade_dts));
+						   ptlin._end_trade_dts,
+						   false, need_tuple));
 	    t_iter = tmp_t_iter;
 	}
 
@@ -378,6 +382,8 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	 *		T_DTS asc
 	 *
 	 */
+	// index-only scan, if the entries of T_INDEX_3 carry the fields
+	bool need_tuple = !_ptrade_desc->find_index("T_INDEX_3")->is_covering();
 	guard<index_scan_iter_impl<trade_t> > t_iter;
 	{
 	    index_scan_iter_impl<trade_t>* tmp_t_iter;
@@ -387,7 +393,8 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	    W_DO(_ptrade_man->t_get_iter_by_index3(_pssm, tmp_t_iter, prtrade,
 						   lowrep, highrep, ptlin._symbol,
 						   ptlin._start_trade_dts,
-						   ptlin._end_trade_dts));
+						   ptlin._end_trade_dts,
+						   SH, need_tuple));
 	    t_iter = tmp_t_iter;
 	}
 	
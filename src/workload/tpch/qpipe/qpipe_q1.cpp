@@ -128,8 +128,7 @@ public:
 		}
 
 
-		_prline->get_value(10, _lineitem.L_SHIPDATE, 15);
-		_shipdate = str_to_timet(_lineitem.L_SHIPDATE);
+		_prline->get_value(10, _shipdate);
 
 		// Return true if it passes the filter
 		if  ( _shipdate <= q1_input->l_shipdate ) {
@@ -259,6 +258,24 @@ public:
 		}
 	}
 
+	// the partial aggregates of a group are sums, thus they merge
+	bool can_merge() const { return (true); }
+
+	void merge(char* agg_data, const char* other_data) {
+		q1_aggregate_tuple* tuple = aligned_cast<q1_aggregate_tuple>(agg_data);
+		const q1_aggregate_tuple* other =
+			aligned_cast<const q1_aggregate_tuple>(other_data);
+
+		tuple->L_COUNT_ORDER += other->L_COUNT_ORDER;
+		tuple->L_SUM_QTY += other->L_SUM_QTY;
+		tuple->L_SUM_BASE_PRICE += other->L_SUM_BASE_PRICE;
+		tuple->L_SUM_DISC_PRICE += other->L_SUM_DISC_PRICE;
+		tuple->L_SUM_CHARGE += other->L_SUM_CHARGE;
+		tuple->L_AVG_QTY += other->L_AVG_QTY;
+		tuple->L_AVG_PRICE += other->L_AVG_PRICE;
+		tuple->L_AVG_DISC += other->L_AVG_DISC;
+	}
+
 	void finish(tuple_t &d, const char* agg_data) {
 		q1_aggregate_tuple *dest;
 		dest = aligned_cast<q1_aggregate_tuple>(d.data);
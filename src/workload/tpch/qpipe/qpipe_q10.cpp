@@ -243,8 +243,7 @@ public:
 			assert(false); // RC(se_WRONG_DISK_DATA)
 		}
 
-		_prorders->get_value(4, _orders.O_ORDERDATE, sizeof(_orders.O_ORDERDATE));
-		_orderdate = str_to_timet(_orders.O_ORDERDATE);
+		_prorders->get_value(4, _orderdate);
 
 		return _orderdate >= _first_orderdate && _orderdate < _last_orderdate;
 	}
@@ -176,12 +176,9 @@ public:
 			assert(false); // RC(se_WRONG_DISK_DATA)
 		}
 
-		_prline->get_value(10, _lineitem.L_SHIPDATE, 15);
-		_shipdate = str_to_timet(_lineitem.L_SHIPDATE);
-		_prline->get_value(11, _lineitem.L_COMMITDATE, 15);
-		_commitdate = str_to_timet(_lineitem.L_COMMITDATE);
-		_prline->get_value(12, _lineitem.L_RECEIPTDATE, 15);
-		_receiptdate = str_to_timet(_lineitem.L_RECEIPTDATE);
+		_prline->get_value(10, _shipdate);
+		_prline->get_value(11, _commitdate);
+		_prline->get_value(12, _receiptdate);
 		_prline->get_value(14, _lineitem.L_SHIPMODE, 15);
 		_shipmode=str_to_shipmode(_lineitem.L_SHIPMODE);
 
@@ -174,8 +174,7 @@ public:
             assert(false); // RC(se_WRONG_DISK_DATA)
         }
 
-	_prline->get_value(10, _lineitem.L_SHIPDATE, 15);
-	_shipdate = str_to_timet(_lineitem.L_SHIPDATE);
+	_prline->get_value(10, _shipdate);
 
 	if (_shipdate>=date1 && _shipdate<date2)
 	  {
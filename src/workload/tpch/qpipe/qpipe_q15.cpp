@@ -152,8 +152,7 @@ public:
 			assert(false); // RC(se_WRONG_DISK_DATA)
 		}
 
-		_prline->get_value(10, _lineitem.L_SHIPDATE, sizeof(_lineitem.L_SHIPDATE));
-		_shipdate = str_to_timet(_lineitem.L_SHIPDATE);
+		_prline->get_value(10, _shipdate);
 
 		return _shipdate >= _firstdate && _shipdate < _lastdate;
 	}
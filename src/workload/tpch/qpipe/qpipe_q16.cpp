@@ -293,7 +293,9 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q16_part_tscan_filter_t()");
+		return c_str("q16_part_tscan_filter_t(%s, %s, %d, %d, %d, %d, %d, %d, %d, %d)",
+				_brand, _type, _size[0], _size[1], _size[2], _size[3],
+				_size[4], _size[5], _size[6], _size[7]);
 	}
 };
 
@@ -235,7 +235,7 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q17_part_tscan_filter_t()");
+		return c_str("q17_part_tscan_filter_t(%s, %s)", _brand, _container);
 	}
 };
 
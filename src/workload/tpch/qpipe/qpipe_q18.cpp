@@ -421,7 +421,7 @@ struct q18_qty_filter_t : public tuple_filter_t {
 	}
 
 	virtual c_str to_string() const {
-		return c_str("q18_qty_filter_t");
+		return c_str("q18_qty_filter_t(%.2f)", _quantity.to_double());
 	}
 };
 
@@ -509,10 +509,10 @@ struct q18_sort_key_compare_t : public key_compare_t {
 		q18_sort_key *k1 = aligned_cast<q18_sort_key>(key1);
 		q18_sort_key *k2 = aligned_cast<q18_sort_key>(key2);
 
-		time_t d1 = str_to_timet(k1->O_ORDERDATE);
-		time_t d2 = str_to_timet(k2->O_ORDERDATE);
+		// the "YYYY-MM-DD" dates compare as strings
+		int dc = strncmp(k1->O_ORDERDATE, k2->O_ORDERDATE, DATE_STR_LEN);
 
-		return (k1->O_TOTALPRICE > k2->O_TOTALPRICE ? -1 : (k1->O_TOTALPRICE < k2->O_TOTALPRICE ? 1 : d1 - d2));
+		return (k1->O_TOTALPRICE > k2->O_TOTALPRICE ? -1 : (k1->O_TOTALPRICE < k2->O_TOTALPRICE ? 1 : dc));
 	}
 
 	virtual q18_sort_key_compare_t* clone() const {
@@ -278,7 +278,7 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q20_part_tscan_filter_t()");
+		return c_str("q20_part_tscan_filter_t(%s)", _color);
 	}
 };
 
@@ -461,8 +461,7 @@ public:
 			assert(false); // RC(se_WRONG_DISK_DATA)
 		}
 
-		_prline->get_value(10, _lineitem.L_SHIPDATE, sizeof(_lineitem.L_SHIPDATE));
-		_shipdate = str_to_timet(_lineitem.L_SHIPDATE);
+		_prline->get_value(10, _shipdate);
 
 		return _shipdate >= _first_shipdate && _shipdate < _last_shipdate;
 	}
@@ -487,7 +486,11 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q20_lineitem_tscan_filter_t()");
+		char f_shipdate[15];
+		char l_shipdate[15];
+		timet_to_str(f_shipdate, _first_shipdate);
+		timet_to_str(l_shipdate, _last_shipdate);
+		return c_str("q20_lineitem_tscan_filter_t(%s, %s)", f_shipdate, l_shipdate);
 	}
 };
 
@@ -210,7 +210,7 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q21_nation_tscan_filter_t()");
+		return c_str("q21_nation_tscan_filter_t(%s)", _nname);
 	}
 };
 
@@ -311,10 +311,11 @@ public:
 			assert(false); // RC(se_WRONG_DISK_DATA)
 		}
 
-		_prline->get_value(11, _lineitem.L_COMMITDATE, sizeof(_lineitem.L_COMMITDATE));
-		_prline->get_value(12, _lineitem.L_RECEIPTDATE, sizeof(_lineitem.L_RECEIPTDATE));
+		int commitdate, receiptdate;
+		_prline->get_date_value(11, commitdate);
+		_prline->get_date_value(12, receiptdate);
 
-		return str_to_timet(_lineitem.L_RECEIPTDATE) > str_to_timet(_lineitem.L_COMMITDATE);
+		return receiptdate > commitdate;
 	}
 
 	void project(tuple_t &d, const tuple_t &s) {
@@ -192,7 +192,9 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q22_customer_tscan_filter_t");
+		return c_str("q22_customer_tscan_filter_t(%d, %d, %d, %d, %d, %d, %d)",
+				_cntrycodes[0], _cntrycodes[1], _cntrycodes[2], _cntrycodes[3],
+				_cntrycodes[4], _cntrycodes[5], _cntrycodes[6]);
 	}
 };
 
@@ -268,7 +270,9 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q22_customer_sub_tscan_filter_t");
+		return c_str("q22_customer_sub_tscan_filter_t(%d, %d, %d, %d, %d, %d, %d)",
+				_cntrycodes[0], _cntrycodes[1], _cntrycodes[2], _cntrycodes[3],
+				_cntrycodes[4], _cntrycodes[5], _cntrycodes[6]);
 	}
 };
 
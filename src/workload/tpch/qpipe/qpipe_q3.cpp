@@ -178,8 +178,7 @@ public:
 	}
 
 	c_str to_string() const {
-		//return c_str("q3_customer_tscan_filter_t(%s)", _mktsegment);
-		return c_str("q3_customer_tscan_filter_t");
+		return c_str("q3_customer_tscan_filter_t(%s)", _mktsegment);
 	}
 };
 
@@ -225,8 +224,7 @@ public:
 			assert(false); // RC(se_WRONG_DISK_DATA)
 		}
 
-		_prorders->get_value(4, _orders.O_ORDERDATE, 15);
-		_orderdate = str_to_timet(_orders.O_ORDERDATE);
+		_prorders->get_value(4, _orderdate);
 
 		return _orderdate < q3_input->current_date;
 	}
@@ -237,14 +235,13 @@ public:
 
 		_prorders->get_value(0, _orders.O_ORDERKEY);
 		_prorders->get_value(1, _orders.O_CUSTKEY);
-		_prorders->get_value(4, _orders.O_ORDERDATE, 15);
 		_prorders->get_value(7, _orders.O_SHIPPRIORITY);
 
 		//TRACE(TRACE_RECORD_FLOW, "%d|%d|%s|%d\n", _orders.O_ORDERKEY, _orders.O_CUSTKEY, _orders.O_ORDERDATE, _orders.O_SHIPPRIORITY);
 
 		dest->O_ORDERKEY = _orders.O_ORDERKEY;
 		dest->O_CUSTKEY = _orders.O_CUSTKEY;
-		dest->O_ORDERDATE = str_to_timet(_orders.O_ORDERDATE);
+		_prorders->get_value(4, dest->O_ORDERDATE);
 		dest->O_SHIPPRIORITY = _orders.O_SHIPPRIORITY;
 
 	}
@@ -299,8 +296,7 @@ public:
 			assert(false); // RC(se_WRONG_DISK_DATA)
 		}
 
-		_prline->get_value(10, _lineitem.L_SHIPDATE, 15);
-		_shipdate = str_to_timet(_lineitem.L_SHIPDATE);
+		_prline->get_value(10, _shipdate);
 
 		return _shipdate > q3_input->current_date;
 	}
@@ -145,11 +145,9 @@ public:
             assert(false); // RC(se_WRONG_DISK_DATA)
         }
 
-        _prline->get_value(12, _lineitem.L_RECEIPTDATE, 15);
-        _receiptdate = str_to_timet(_lineitem.L_RECEIPTDATE);
+        _prline->get_value(12, _receiptdate);
 
-        _prline->get_value(11, _lineitem.L_COMMITDATE, 15);
-        _commitdate = str_to_timet(_lineitem.L_COMMITDATE);
+        _prline->get_value(11, _commitdate);
 
 
         // Return true if it passes the filter
@@ -314,8 +312,7 @@ public:
             assert(false); // RC(se_WRONG_DISK_DATA)
         }
 
-        _prorder->get_value(4, _orders.O_ORDERDATE, 15);
-        _orderdate = str_to_timet(_orders.O_ORDERDATE);
+        _prorder->get_value(4, _orderdate);
 
 
         // Return true if it passes the filter
@@ -208,7 +208,7 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q5_region_tscan_filter_t()");
+		return c_str("q5_region_tscan_filter_t(%s)", _name);
 	}
 };
 
@@ -380,8 +380,7 @@ public:
 			assert(false); // RC(se_WRONG_DISK_DATA)
 		}
 
-		_prorders->get_value(4, _orders.O_ORDERDATE, 15);
-		_orderdate = str_to_timet(_orders.O_ORDERDATE);
+		_prorders->get_value(4, _orderdate);
 
 		return _orderdate >= q5_input->o_orderdate && _orderdate < _last_orderdate;
 	}
@@ -404,7 +403,11 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q5_orders_tscan_filter_t()");
+		char f_orderdate[15];
+		char l_orderdate[15];
+		timet_to_str(f_orderdate, q5_input->o_orderdate);
+		timet_to_str(l_orderdate, _last_orderdate);
+		return c_str("q5_orders_tscan_filter_t(%s, %s)", f_orderdate, l_orderdate);
 	}
 };
 
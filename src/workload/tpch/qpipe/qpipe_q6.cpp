@@ -144,8 +144,7 @@ public:
             assert(false); // RC(se_WRONG_DISK_DATA)
         }
 
-        _prline->get_value(10, _lineitem.L_SHIPDATE, 15); //get column 10 (15 characters)
-        _shipdate = str_to_timet(_lineitem.L_SHIPDATE);        
+        _prline->get_value(10, _shipdate);
         _prline->get_value(6, _lineitem.L_DISCOUNT); //get column 6 (float)
         _discount=_lineitem.L_DISCOUNT/100.0;
 #warning MA: Discount from TPCH dbgen is created between 0 and 100 instead between 0 and 1.
@@ -387,8 +387,7 @@ class q7_lineitem_tscan_filter_t : public tuple_filter_t
                 assert(false); // RC(se_WRONG_DISK_DATA)
             }
 
-            _prline->get_value(10, _lineitem.L_SHIPDATE, 15);
-            _shipdate = str_to_timet(_lineitem.L_SHIPDATE);
+            _prline->get_value(10, _shipdate);
 
             return (_shipdate >= _firstdate && _shipdate <= _lastdate);
         }
@@ -401,8 +400,7 @@ class q7_lineitem_tscan_filter_t : public tuple_filter_t
             _prline->get_value(2, _lineitem.L_SUPPKEY);
             _prline->get_value(5, _lineitem.L_EXTENDEDPRICE);
             _prline->get_value(6, _lineitem.L_DISCOUNT);
-            _prline->get_value(10, _lineitem.L_SHIPDATE, 15);
-            _shipdate = str_to_timet(_lineitem.L_SHIPDATE);
+            _prline->get_value(10, _shipdate);
             struct tm *tm_shipdate = gmtime(&_shipdate);
 
             //TRACE(TRACE_RECORD_FLOW, "%d|%d|%.2f|%.2f|%d\n", _lineitem.L_ORDERKEY, _lineitem.L_SUPPKEY, _lineitem.L_EXTENDEDPRICE / 100.0, _lineitem.L_DISCOUNT / 100.0,
@@ -356,8 +356,7 @@ public:
 			assert(false); // RC(se_WRONG_DISK_DATA)
 		}
 
-		_prorders->get_value(4, _orders.O_ORDERDATE, sizeof(_orders.O_ORDERDATE));
-		_orderdate = str_to_timet(_orders.O_ORDERDATE);
+		_prorders->get_value(4, _orderdate);
 
 		return _orderdate >= _first_orderdate && _orderdate <= _last_orderdate;
 	}
@@ -368,8 +367,7 @@ public:
 
 		_prorders->get_value(0, _orders.O_ORDERKEY);
 		_prorders->get_value(1, _orders.O_CUSTKEY);
-		_prorders->get_value(4, _orders.O_ORDERDATE, sizeof(_orders.O_ORDERDATE));
-		_orderdate = str_to_timet(_orders.O_ORDERDATE);
+		_prorders->get_value(4, _orderdate);
 		struct tm *tm_orderdate = gmtime(&_orderdate);
 
 		//TRACE(TRACE_RECORD_FLOW, "%d|%d|%d\n", _orders.O_ORDERKEY, _orders.O_CUSTKEY, tm_orderdate->tm_year + 1900);
@@ -964,7 +962,7 @@ struct q8_aggregate_t : public tuple_aggregate_t {
 		return new q8_aggregate_t(*this);
 	}
 	virtual c_str to_string() const {
-		return "q8_aggregate_t";
+		return c_str("q8_aggregate_t(%s)", _nation);
 	}
 };
 
@@ -470,8 +470,7 @@ public:
 		q9_projected_orders_tuple *dest = aligned_cast<q9_projected_orders_tuple>(d.data);
 
 		_prorders->get_value(0, _orders.O_ORDERKEY);
-		_prorders->get_value(4, _orders.O_ORDERDATE, sizeof(_orders.O_ORDERDATE));
-		_orderdate = str_to_timet(_orders.O_ORDERDATE);
+		_prorders->get_value(4, _orderdate);
 		struct tm *tm_orderdate = gmtime(&_orderdate);
 
 		//TRACE(TRACE_RECORD_FLOW, "%d|%d\n", _orders.O_ORDERKEY, tm_orderdate->tm_year + 1900);
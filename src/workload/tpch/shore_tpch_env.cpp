@@ -30,8 +30,10 @@
 
 #include "workload/tpch/shore_tpch_env.h"
 #include "sm/shore/shore_helper_loader.h"
+#include "sm/shore/shore_load_cache.h"
 
 #include "workload/tpch/tpch_random.h"
+#include "workload/tpch/tpch_fused.h"
 
 #include "workload/tpch/dbgen/dss.h"
 #include "workload/tpch/dbgen/dsstypes.h"
@@ -113,14 +115,17 @@ struct ShoreTPCHEnv::table_creator_t : public thread_t
     int _loader_count;
     int _parts_per_thread;
     int _custs_per_thread;
+    bool _replay;
 
     table_creator_t(ShoreTPCHEnv* env, const double sf, const int loader_count,
-                    const int parts_per_thread, const int custs_per_thread)
+                    const int parts_per_thread, const int custs_per_thread,
+                    const bool replay)
 	: thread_t("TPC-H C"), 
           _env(env), _sf(sf), 
           _loader_count(loader_count),
           _parts_per_thread(parts_per_thread),
-          _custs_per_thread(custs_per_thread)
+          _custs_per_thread(custs_per_thread),
+          _replay(replay)
     { }
     virtual void work();
 };
@@ -178,24 +183,37 @@ void ShoreTPCHEnv::table_creator_t::work()
     _env->_porders_man->register_table_man();
     _env->_plineitem_man->register_table_man();
 
+    // In bulk-load mode the indexes are built at the end of the load
+    if (bulk_loader_t::is_enabled()) {
+        std::vector<table_man_t*> tables;
+        _env->load_tables(tables);
+        W_COERCE(bulk_loader_t::begin(_env->db(), tables));
+    }
 
-    // Do the baseline transaction
-    populate_baseline_input_t in = {_sf, _loader_count, DIVISOR, 
-                                    _parts_per_thread, _custs_per_thread};
-
-    w_rc_t e = RCOK;
-
-    long log_space_needed = 0;
- retrybaseline:
-    W_COERCE(_env->db()->begin_xct());
+    // Do the baseline transaction, unless the records are replayed
+    // from the load cache
+    if (!_replay) {
+        populate_baseline_input_t in = {_sf, _loader_count, DIVISOR, 
+                                        _parts_per_thread, _custs_per_thread};
+
+        w_rc_t e = RCOK;
+
+        long log_space_needed = 0;
+        bulk_loader_t::mark_runs();
+        load_cache_t::mark();
+     retrybaseline:
+        bulk_loader_t::rollback_runs();
+        load_cache_t::rollback();
+        W_COERCE(_env->db()->begin_xct());
 #ifdef USE_SHORE_6
-    if(log_space_needed > 0) {
-	W_COERCE(_env->db()->xct_reserve_log_space(log_space_needed));
-    }
+        if(log_space_needed > 0) {
+            W_COERCE(_env->db()->xct_reserve_log_space(log_space_needed));
+        }
 #endif
-    e = _env->xct_populate_baseline(0, in);
+        e = _env->xct_populate_baseline(0, in);
 
-    CHECK_XCT_RETURN(e,log_space_needed,retrybaseline,_env);
+        CHECK_XCT_RETURN(e,log_space_needed,retrybaseline,_env);
+    }
     
     W_COERCE(_env->db()->begin_xct());
     W_COERCE(_env->_post_init_impl());
@@ -227,7 +245,11 @@ void ShoreTPCHEnv::table_builder_t::work()
         tid = std::min(_part_end-i,PART_POP_UNIT);
 
 	long log_space_needed = 0;
+	bulk_loader_t::mark_runs();
+	load_cache_t::mark();
     retrypart:
+	bulk_loader_t::rollback_runs();
+	load_cache_t::rollback();
 	W_COERCE(_env->db()->begin_xct());
 #ifdef USE_SHORE_6
 	if(log_space_needed > 0) {
@@ -260,7 +282,11 @@ void ShoreTPCHEnv::table_builder_t::work()
         tid = std::min(_cust_end-i,CUST_POP_UNIT);
 
 	long log_space_needed = 0;
+	bulk_loader_t::mark_runs();
+	load_cache_t::mark();
     retrycust:
+	bulk_loader_t::rollback_runs();
+	load_cache_t::rollback();
 	W_COERCE(_env->db()->begin_xct());
 #ifdef USE_SHORE_6
 	if(log_space_needed > 0) {
@@ -292,7 +318,7 @@ void ShoreTPCHEnv::table_builder_t::work()
  ********************************************************************/ 
 
 ShoreTPCHEnv::ShoreTPCHEnv()
-    : ShoreEnv()
+    : ShoreEnv(), _query_engine(TPCH_ENGINE_FUSED), _query_mismatches(0)
 {
     _scaling_factor = TPCH_SCALING_FACTOR;
 
@@ -431,6 +457,16 @@ int ShoreTPCHEnv::info() const
 
 int ShoreTPCHEnv::statistics() 
 {
+    if (_query_engine == TPCH_ENGINE_CHECK) {
+        TRACE( TRACE_ALWAYS, "Query result mismatches = (%d)\n",
+               _query_mismatches);
+    }
+#ifdef CFG_QPIPE
+    result_cache_t::print_stats();
+    runtime_filter_t::print_stats();
+    cscan_stage_t::print_stats();
+    build_cache_t::print_stats();
+#endif
     return (0);
 }
 
@@ -472,6 +508,18 @@ int ShoreTPCHEnv::stop()
  *
  ******************************************************************/
 
+void ShoreTPCHEnv::load_tables(std::vector<table_man_t*>& tables)
+{
+    tables.push_back(nation_man());
+    tables.push_back(region_man());
+    tables.push_back(part_man());
+    tables.push_back(supplier_man());
+    tables.push_back(partsupp_man());
+    tables.push_back(customer_man());
+    tables.push_back(orders_man());
+    tables.push_back(lineitem_man());
+}
+
 w_rc_t ShoreTPCHEnv::loaddata() 
 {
     // 0. lock the loading status and the scaling factor
@@ -503,11 +551,23 @@ w_rc_t ShoreTPCHEnv::loaddata()
     long parts_per_thread = total_parts/loaders_to_use;
     long custs_per_thread = total_custs/loaders_to_use;
 
+    // If there is a valid load cache for this SF, its records are 
+    // replayed instead of generated. Otherwise the load is captured.
+    guard<load_cache_t> cache;
+    bool replay = false;
+    if (load_cache_t::is_enabled()) {
+        std::vector<table_man_t*> tables;
+        load_tables(tables);
+        cache = new load_cache_t(c_str("tpch-sf%g",_scaling_factor).data(), tables);
+        replay = cache->is_valid();
+        if (!replay) W_DO(cache->begin_capture());
+    }
+
     // 2. Fire up the table creator and baseline loader
     {
 	guard<table_creator_t> tc;
 	tc = new table_creator_t(this, _scaling_factor, loaders_to_use,
-                                 parts_per_thread, custs_per_thread);
+                                 parts_per_thread, custs_per_thread, replay);
 	tc->fork();
 	tc->join();
     }
@@ -516,38 +576,48 @@ w_rc_t ShoreTPCHEnv::loaddata()
     guard<checkpointer_t> chk(new checkpointer_t(this));
     chk->fork();
 
-    // 4. Fire up the parallel loaders
-    TRACE( TRACE_ALWAYS, "Firing up %d loaders ..\n", loaders_to_use);
-    array_guard_t< guard<table_builder_t> > loaders(new guard<table_builder_t>[loaders_to_use]);
-    for(int i=0; i < loaders_to_use; i++) {
-	long part_start = (i*parts_per_thread) + DIVISOR;
-	long part_end = ((i+1)*parts_per_thread > total_parts - 1) ? 
-            total_parts : (i+1)*parts_per_thread - 1;
-        assert (part_start <= part_end);
-
-	long cust_start = (i*custs_per_thread) + DIVISOR;
-	long cust_end = ((i+1)*custs_per_thread > total_custs - 1) ? 
-            total_custs : (i+1)*custs_per_thread - 1;
-        assert (cust_start <= cust_end);
-
-	loaders[i] = new table_builder_t(this, i, 
-                                         part_start, part_end, 
-                                         cust_start, cust_end,
-                                         _scaling_factor, loaders_to_use);
-	loaders[i]->fork();
+    // 4. Fire up the parallel loaders, or replay the load cache
+    if (replay) {
+        W_DO(cache->replay(_pssm, loaders_to_use));
     }
+    else {
+        TRACE( TRACE_ALWAYS, "Firing up %d loaders ..\n", loaders_to_use);
+        array_guard_t< guard<table_builder_t> > loaders(new guard<table_builder_t>[loaders_to_use]);
+        for(int i=0; i < loaders_to_use; i++) {
+            long part_start = (i*parts_per_thread) + DIVISOR;
+            long part_end = ((i+1)*parts_per_thread > total_parts - 1) ? 
+                total_parts : (i+1)*parts_per_thread - 1;
+            assert (part_start <= part_end);
+
+            long cust_start = (i*custs_per_thread) + DIVISOR;
+            long cust_end = ((i+1)*custs_per_thread > total_custs - 1) ? 
+                total_custs : (i+1)*custs_per_thread - 1;
+            assert (cust_start <= cust_end);
+
+            loaders[i] = new table_builder_t(this, i, 
+                                             part_start, part_end, 
+                                             cust_start, cust_end,
+                                             _scaling_factor, loaders_to_use);
+            loaders[i]->fork();
+        }
 
-    for(int i=0; i < loaders_to_use; i++) {
-	loaders[i]->join();
+        for(int i=0; i < loaders_to_use; i++) {
+            loaders[i]->join();
+        }
+
+        if (cache) W_DO(cache->end_capture());
     }
 
+    // 5. If bulk loading, build the indexes
+    W_DO(bulk_loader_t::finish(_pssm, loaders_to_use));
+
     time_t tstop = time(NULL);
 
-    // 5. Print stats
+    // 6. Print stats
     TRACE( TRACE_STATISTICS, "Loading finished. %d tables loaded in (%d) secs...\n",
            SHORE_TPCH_TABLES, (tstop - tstart));
 
-    // 6. Notify that the env is loaded
+    // 7. Notify that the env is loaded
     _loaded = true;
     chk->join();
 
@@ -575,13 +645,13 @@ w_rc_t ShoreTPCHEnv::check_consistency()
  * @fn:    warmup()
  *
  * @brief: Touches the entire database - For memory-fitting databases
- *         this is enough to bring it to load it to memory
+ *         this is enough to bring it to load it to memory.
  *
  ******************************************************************/
 
 w_rc_t ShoreTPCHEnv::warmup()
 {
-    return (check_consistency());
+    return (warmup_bufpool());
 }
 
 
@@ -604,6 +674,15 @@ int ShoreTPCHEnv::conf()
     // reread the params
     ShoreEnv::conf();
     upd_sf();
+
+    _query_engine = envVar::instance()->getVarInt("tpch-engine",
+                                                  TPCH_ENGINE_ITER);
+    if ((_query_engine < TPCH_ENGINE_ITER) ||
+        (_query_engine > TPCH_ENGINE_CHECK)) {
+        TRACE( TRACE_ALWAYS, "Bad tpch-engine (%d), using the iterator loops\n",
+               _query_engine);
+        _query_engine = TPCH_ENGINE_ITER;
+    }
     return (0);
 }
 
@@ -0,0 +1,3429 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_tpch_fused.cpp
+ *
+ *  @brief:  Fused plans of the Baseline Shore TPC-H queries, and the
+ *           checker of the query results
+ *
+ *  @author: agent, Oct 2026
+ */
+
+#include "workload/tpch/shore_tpch_env.h"
+#include "workload/tpch/tpch_util.h"
+#include "workload/tpch/tpch_fused.h"
+
+#include <math.h>
+#include <algorithm>
+
+using namespace shore;
+
+
+ENTER_NAMESPACE(tpch);
+
+
+
+/********************************************************************
+ *
+ * tpch_result_t
+ *
+ ********************************************************************/
+
+const double tpch_result_t::TOLERANCE = 1e-6;
+
+void tpch_result_t::sort()
+{
+    std::sort(_rows.begin(), _rows.end());
+}
+
+static bool _same_value(const double a, const double b)
+{
+    double diff = fabs(a-b);
+    double mag = std::max(fabs(a), fabs(b));
+    return ((diff <= tpch_result_t::TOLERANCE) ||
+            (diff <= tpch_result_t::TOLERANCE * mag));
+}
+
+
+/********************************************************************
+ *
+ *  @fn:    check
+ *
+ *  @brief: Sorts and compares the two results row by row. The keys
+ *          are exact, thus the rows of the two results sort in the
+ *          same order unless a group is missing from one of them.
+ *
+ ********************************************************************/
+
+bool tpch_result_t::check(const char* qname, tpch_result_t& iter_res,
+                          tpch_result_t& fused_res)
+{
+    iter_res.sort();
+    fused_res.sort();
+
+    if (iter_res.size() != fused_res.size()) {
+        TRACE( TRACE_ALWAYS, "%s MISMATCH rows iter (%d) fused (%d)\n",
+               qname, (int)iter_res.size(), (int)fused_res.size());
+        return (false);
+    }
+
+    for (size_t i=0; i<iter_res.size(); i++) {
+        const row_t& a = iter_res.row(i);
+        const row_t& b = fused_res.row(i);
+        bool same = (a.size() == b.size());
+        for (size_t j=0; same && j<a.size(); j++) {
+            same = _same_value(a[j], b[j]);
+        }
+        if (!same) {
+            TRACE( TRACE_ALWAYS, "%s MISMATCH row (%d)\n", qname, (int)i);
+            for (size_t j=0; j<std::max(a.size(),b.size()); j++) {
+                TRACE( TRACE_ALWAYS, "  col (%d) iter (%.4f) fused (%.4f)\n",
+                       (int)j, (j<a.size() ? a[j] : 0.0),
+                       (j<b.size() ? b[j] : 0.0));
+            }
+            return (false);
+        }
+    }
+
+    TRACE( TRACE_DEBUG, "%s results match (%d rows)\n",
+           qname, (int)iter_res.size());
+    return (true);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q1 (fused)
+ *
+ * scan lineitem --> filter (shipdate) --> aggregate (flag,status)
+ *
+ ********************************************************************/
+
+struct q1_fkey_t
+{
+    char _flag;
+    char _status;
+};
+
+struct q1_fagg_t
+{
+    double _qty;
+    double _base_price;
+    double _disc_price;
+    double _charge;
+    double _disc;
+    int    _count;
+};
+
+struct q1_fpred_t
+{
+    int _shipdate;
+    q1_fpred_t(const int shipdate) : _shipdate(shipdate) { }
+    inline bool operator()(const table_row_t& r) const {
+        return (date_col_t<10>::get(r) <= _shipdate);
+    }
+};
+
+struct q1_fkeyof_t
+{
+    inline q1_fkey_t operator()(const table_row_t& r) const {
+        q1_fkey_t k;
+        k._flag = col_t<8,char>::get(r);
+        k._status = col_t<9,char>::get(r);
+        return (k);
+    }
+};
+
+struct q1_fupdate_t
+{
+    inline q1_fagg_t init() const {
+        q1_fagg_t a;
+        memset(&a, 0, sizeof(a));
+        return (a);
+    }
+    inline void operator()(q1_fagg_t& a, const table_row_t& r) const {
+        double price = col_t<5,double>::get(r);
+        double disc = col_t<6,double>::get(r);
+        double disc_price = price * (1-disc);
+        a._qty += col_t<4,double>::get(r);
+        a._base_price += price;
+        a._disc_price += disc_price;
+        a._charge += disc_price * (1+col_t<7,double>::get(r));
+        a._disc += disc;
+        a._count++;
+    }
+};
+
+struct q1_foutput_t
+{
+    tpch_result_t* _presult;
+    q1_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const q1_fkey_t& k, const q1_fagg_t& a) {
+        TRACE( TRACE_QUERY_RESULTS,
+               "%c|%c|%.0f|%.2f|%.2f|%.2f|%.2f|%.2f|%.2f|%d\n",
+               k._flag, k._status, a._qty, a._base_price, a._disc_price,
+               a._charge, a._qty/a._count, a._base_price/a._count,
+               a._disc/a._count, a._count);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(k._flag);
+            _presult->add(k._status);
+            _presult->add(a._qty);
+            _presult->add(a._base_price);
+            _presult->add(a._disc_price);
+            _presult->add(a._charge);
+            _presult->add(a._qty/a._count);
+            _presult->add(a._base_price/a._count);
+            _presult->add(a._disc/a._count);
+            _presult->add(a._count);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q1(q1_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+    rep_row_t areprow(_plineitem_man->ts());
+    areprow.set(_plineitem_desc->maxsize());
+    prlineitem->_rep = &areprow;
+
+    table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+    W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+    guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+    // there are only 4 (flag,status) groups
+    typedef fused_map_t<q1_fkey_t,q1_fagg_t> q1_map_t;
+    q1_map_t groups(4);
+
+    typedef aggregate_op<q1_map_t,q1_fkeyof_t,q1_fupdate_t> agg_t;
+    agg_t agg(groups, q1_fkeyof_t(), q1_fupdate_t());
+    filter_op<q1_fpred_t,agg_t> filter(q1_fpred_t(date_key(in.l_shipdate)),
+                                       agg);
+
+    W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+
+    q1_foutput_t output(presult);
+    groups.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q2 (fused)
+ *
+ * scan part     --> filter (size,type) --> build P
+ * scan nation   --> filter (region) --> build N
+ * scan supplier --> filter (in N) --> build S
+ * scan partsupp --> filter (in S) --> probe P --> min cost per part
+ *
+ ********************************************************************/
+
+typedef fused_map_t<int,char>   q2_kmap_t;
+typedef fused_map_t<int,double> q2_mmap_t;
+
+struct q2_fppred_t
+{
+    int  _size;
+    char _types3[10];
+    q2_fppred_t(const int size, const int types3) : _size(size) {
+        types3_to_str(_types3, types3);
+    }
+    inline bool operator()(const table_row_t& r) const {
+        if (col_t<5,int>::get(r) != _size) return (false);
+        char type[STRSIZE(25)];
+        str_col_t<4,25>::get(r, type);
+        return (strstr(type, _types3) != NULL);
+    }
+};
+
+struct q2_fnpred_t
+{
+    int _region;
+    q2_fnpred_t(const int region) : _region(region) { }
+    inline bool operator()(const table_row_t& r) const {
+        return (col_t<2,int>::get(r) == _region);
+    }
+};
+
+// a (part,supplier) whose cost was the minimum of the part when seen
+struct q2_fcand_t
+{
+    int    _partkey;
+    int    _suppkey;
+    double _cost;
+};
+
+// keeps the minimum cost of each part, and the candidate suppliers
+struct q2_fmin_t
+{
+    q2_mmap_t&               _mins;
+    std::vector<q2_fcand_t>& _cands;
+    q2_fmin_t(q2_mmap_t& mins, std::vector<q2_fcand_t>& cands)
+        : _mins(mins), _cands(cands) { }
+    inline void operator()(const table_row_t& r, char&) {
+        q2_fcand_t c;
+        c._partkey = col_t<0,int>::get(r);
+        c._suppkey = col_t<1,int>::get(r);
+        c._cost = col_t<3,double>::get(r);
+        double* pmin = _mins.get_or_insert(c._partkey, c._cost);
+        if (c._cost < *pmin) *pmin = c._cost;
+        if (c._cost == *pmin) _cands.push_back(c);
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q2(q2_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    typedef col_of_t<0,int> key0_t;
+
+    // part
+    q2_kmap_t parts;
+    {
+        tuple_guard<part_man_impl> prpart(_ppart_man);
+        rep_row_t preprow(_ppart_man->ts());
+        preprow.set(_ppart_desc->maxsize());
+        prpart->_rep = &preprow;
+
+        table_scan_iter_impl<part_t>* tmp_p_iter;
+        W_DO(_ppart_man->get_iter_for_file_scan(_pssm, tmp_p_iter));
+        guard< table_scan_iter_impl<part_t> > p_iter(tmp_p_iter);
+
+        typedef build_op<q2_kmap_t,key0_t,mark_t> build_t;
+        build_t build(parts, key0_t(), mark_t());
+        filter_op<q2_fppred_t,build_t>
+            filter(q2_fppred_t(in.p_size, in.p_types3), build);
+
+        W_DO(fused_scan(_pssm, tmp_p_iter, *prpart, filter));
+    }
+
+    // nation
+    q2_kmap_t nations;
+    {
+        tuple_guard<nation_man_impl> prnation(_pnation_man);
+        rep_row_t areprow(_pnation_man->ts());
+        areprow.set(_pnation_desc->maxsize());
+        prnation->_rep = &areprow;
+
+        table_scan_iter_impl<nation_t>* tmp_n_iter;
+        W_DO(_pnation_man->get_iter_for_file_scan(_pssm, tmp_n_iter));
+        guard< table_scan_iter_impl<nation_t> > n_iter(tmp_n_iter);
+
+        typedef build_op<q2_kmap_t,key0_t,mark_t> build_t;
+        build_t build(nations, key0_t(), mark_t());
+        filter_op<q2_fnpred_t,build_t> filter(q2_fnpred_t(in.r_name), build);
+
+        W_DO(fused_scan(_pssm, tmp_n_iter, *prnation, filter));
+    }
+
+    // supplier
+    q2_kmap_t supps;
+    {
+        tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+        rep_row_t sreprow(_psupplier_man->ts());
+        sreprow.set(_psupplier_desc->maxsize());
+        prsupp->_rep = &sreprow;
+
+        table_scan_iter_impl<supplier_t>* tmp_s_iter;
+        W_DO(_psupplier_man->get_iter_for_file_scan(_pssm, tmp_s_iter));
+        guard< table_scan_iter_impl<supplier_t> > s_iter(tmp_s_iter);
+
+        typedef in_map_t<q2_kmap_t,col_of_t<3,int>,true> pred_t;
+        typedef build_op<q2_kmap_t,key0_t,mark_t> build_t;
+        build_t build(supps, key0_t(), mark_t());
+        filter_op<pred_t,build_t>
+            filter(pred_t(nations, col_of_t<3,int>()), build);
+
+        W_DO(fused_scan(_pssm, tmp_s_iter, *prsupp, filter));
+    }
+
+    // partsupp
+    q2_mmap_t mins(parts.size());
+    std::vector<q2_fcand_t> cands;
+    {
+        tuple_guard<partsupp_man_impl> prpartsupp(_ppartsupp_man);
+        rep_row_t psreprow(_ppartsupp_man->ts());
+        psreprow.set(_ppartsupp_desc->maxsize());
+        prpartsupp->_rep = &psreprow;
+
+        table_scan_iter_impl<partsupp_t>* tmp_ps_iter;
+        W_DO(_ppartsupp_man->get_iter_for_file_scan(_pssm, tmp_ps_iter));
+        guard< table_scan_iter_impl<partsupp_t> > ps_iter(tmp_ps_iter);
+
+        q2_fmin_t min(mins, cands);
+        typedef probe_op<q2_kmap_t,key0_t,q2_fmin_t> probe_t;
+        probe_t probe(parts, key0_t(), min);
+        typedef in_map_t<q2_kmap_t,col_of_t<1,int>,true> pred_t;
+        filter_op<pred_t,probe_t>
+            filter(pred_t(supps, col_of_t<1,int>()), probe);
+
+        W_DO(fused_scan(_pssm, tmp_ps_iter, *prpartsupp, filter));
+    }
+
+    // the candidates that are still the minimum of their part
+    for (size_t i=0; i<cands.size(); i++) {
+        const q2_fcand_t& c = cands[i];
+        if (c._cost != *mins.find(c._partkey)) continue;
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d|%.2f\n",
+               c._partkey, c._suppkey, c._cost);
+        if (presult) {
+            presult->new_row();
+            presult->add(c._partkey);
+            presult->add(c._suppkey);
+            presult->add(c._cost);
+        }
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q3 (fused)
+ *
+ * scan customer --> filter (segment) --> build C
+ * scan orders   --> filter (orderdate) --> probe C --> build O
+ * scan lineitem --> filter (shipdate) --> probe O
+ *               --> aggregate (orderkey,orderdate,shippriority)
+ *
+ ********************************************************************/
+
+struct q3_forder_t
+{
+    int _orderdate;
+    int _shippriority;
+};
+
+struct q3_fkey_t
+{
+    int _orderkey;
+    int _orderdate;
+    int _shippriority;
+};
+
+typedef fused_map_t<int,char>            q3_cmap_t;
+typedef fused_map_t<int,q3_forder_t>     q3_omap_t;
+typedef fused_map_t<q3_fkey_t,double>    q3_gmap_t;
+
+struct q3_fcpred_t
+{
+    int _segment;
+    q3_fcpred_t(const int segment) : _segment(segment) { }
+    inline bool operator()(const table_row_t& r) const {
+        char seg[STRSIZE(10)];
+        str_col_t<6,10>::get(r, seg);
+        return (str_to_segment(seg) == _segment);
+    }
+};
+
+struct q3_fcustkey_t
+{
+    inline int operator()(const table_row_t& r) const {
+        return (col_t<0,int>::get(r));
+    }
+};
+
+struct q3_fcvalue_t
+{
+    inline char operator()(const table_row_t&) const { return (1); }
+};
+
+struct q3_fopred_t
+{
+    int _orderdate;
+    q3_fopred_t(const int orderdate) : _orderdate(orderdate) { }
+    inline bool operator()(const table_row_t& r) const {
+        return (date_col_t<4>::get(r) <= _orderdate);
+    }
+};
+
+struct q3_focustkey_t
+{
+    inline int operator()(const table_row_t& r) const {
+        return (col_t<1,int>::get(r));
+    }
+};
+
+// the orders that pass the customer join go to the orders map
+struct q3_fobuild_t
+{
+    q3_omap_t& _orders;
+    q3_fobuild_t(q3_omap_t& orders) : _orders(orders) { }
+    inline void operator()(const table_row_t& r, char&) {
+        q3_forder_t o;
+        o._orderdate = date_col_t<4>::get(r);
+        o._shippriority = col_t<7,int>::get(r);
+        _orders.get_or_insert(col_t<0,int>::get(r), o);
+    }
+};
+
+struct q3_flpred_t
+{
+    int _shipdate;
+    q3_flpred_t(const int shipdate) : _shipdate(shipdate) { }
+    inline bool operator()(const table_row_t& r) const {
+        return (date_col_t<10>::get(r) > _shipdate);
+    }
+};
+
+struct q3_florderkey_t
+{
+    inline int operator()(const table_row_t& r) const {
+        return (col_t<0,int>::get(r));
+    }
+};
+
+struct q3_fgkeyof_t
+{
+    inline q3_fkey_t operator()(const table_row_t& r,
+                                const q3_forder_t& o) const {
+        q3_fkey_t k;
+        k._orderkey = col_t<0,int>::get(r);
+        k._orderdate = o._orderdate;
+        k._shippriority = o._shippriority;
+        return (k);
+    }
+};
+
+struct q3_fupdate_t
+{
+    inline double init() const { return (0); }
+    inline void operator()(double& sum, const table_row_t& r,
+                           const q3_forder_t&) const {
+        sum += col_t<5,double>::get(r) * (1-col_t<6,double>::get(r));
+    }
+};
+
+struct q3_foutput_t
+{
+    tpch_result_t* _presult;
+    q3_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const q3_fkey_t& k, const double& revenue) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%.2f|%d|%d\n",
+               k._orderkey, revenue, k._orderdate, k._shippriority);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(k._orderkey);
+            _presult->add(k._orderdate);
+            _presult->add(k._shippriority);
+            _presult->add(revenue);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q3(q3_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // customer
+    q3_cmap_t custs;
+    {
+        tuple_guard<customer_man_impl> prcustomer(_pcustomer_man);
+        rep_row_t areprow(_pcustomer_man->ts());
+        areprow.set(_pcustomer_desc->maxsize());
+        prcustomer->_rep = &areprow;
+
+        table_scan_iter_impl<customer_t>* tmp_c_iter;
+        W_DO(_pcustomer_man->get_iter_for_file_scan(_pssm, tmp_c_iter));
+        guard< table_scan_iter_impl<customer_t> > c_iter(tmp_c_iter);
+
+        typedef build_op<q3_cmap_t,q3_fcustkey_t,q3_fcvalue_t> build_t;
+        build_t build(custs, q3_fcustkey_t(), q3_fcvalue_t());
+        filter_op<q3_fcpred_t,build_t> filter(q3_fcpred_t(in.c_segment),
+                                              build);
+
+        W_DO(fused_scan(_pssm, tmp_c_iter, *prcustomer, filter));
+    }
+
+    // orders
+    q3_omap_t orders(custs.size());
+    {
+        tuple_guard<orders_man_impl> prorder(_porders_man);
+        rep_row_t areprow(_porders_man->ts());
+        areprow.set(_porders_desc->maxsize());
+        prorder->_rep = &areprow;
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        q3_fobuild_t build(orders);
+        typedef probe_op<q3_cmap_t,q3_focustkey_t,q3_fobuild_t> probe_t;
+        probe_t probe(custs, q3_focustkey_t(), build);
+        filter_op<q3_fopred_t,probe_t>
+            filter(q3_fopred_t(date_key_before(in.current_date)), probe);
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorder, filter));
+    }
+
+    // lineitem
+    q3_gmap_t groups(orders.size());
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t areprow(_plineitem_man->ts());
+        areprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &areprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        typedef aggregate_op<q3_gmap_t,q3_fgkeyof_t,q3_fupdate_t> agg_t;
+        agg_t agg(groups, q3_fgkeyof_t(), q3_fupdate_t());
+        typedef probe_op<q3_omap_t,q3_florderkey_t,agg_t> probe_t;
+        probe_t probe(orders, q3_florderkey_t(), agg);
+        filter_op<q3_flpred_t,probe_t>
+            filter(q3_flpred_t(date_key(in.current_date)), probe);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+    }
+
+    q3_foutput_t output(presult);
+    groups.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q4 (fused)
+ *
+ * index scan orders (orderdate) --> build O
+ * scan lineitem --> filter (commitdate<receiptdate) --> probe O
+ *               --> count each order once per priority
+ *
+ ********************************************************************/
+
+struct q4_forder_t
+{
+    int  _priority;
+    bool _counted;
+};
+
+typedef fused_map_t<int,q4_forder_t> q4_omap_t;
+
+struct q4_forderkey_t
+{
+    inline int operator()(const table_row_t& r) const {
+        return (col_t<0,int>::get(r));
+    }
+};
+
+struct q4_fovalue_t
+{
+    // O_ORDERPRIORITY is "1-URGENT" ... "5-LOW"
+    inline q4_forder_t operator()(const table_row_t& r) const {
+        char prio[STRSIZE(15)];
+        str_col_t<5,15>::get(r, prio);
+        q4_forder_t o;
+        o._priority = prio[0] - '1';
+        o._counted = false;
+        return (o);
+    }
+};
+
+struct q4_flpred_t
+{
+    inline bool operator()(const table_row_t& r) const {
+        return (date_col_t<11>::get(r) < date_col_t<12>::get(r));
+    }
+};
+
+struct q4_fcount_t
+{
+    int _count[END_O_PRIORITY];
+    q4_fcount_t() { memset(_count, 0, sizeof(_count)); }
+    inline void operator()(const table_row_t&, q4_forder_t& o) {
+        if (!o._counted) {
+            o._counted = true;
+            _count[o._priority]++;
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q4(q4_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // orders, same range as the iterator plan
+    q4_omap_t orders;
+    {
+        tuple_guard<orders_man_impl> prorders(_porders_man);
+        rep_row_t areprow(_porders_man->ts());
+        areprow.set(_porders_desc->maxsize());
+        prorders->_rep = &areprow;
+
+        rep_row_t lowrep(_porders_man->ts());
+        rep_row_t highrep(_porders_man->ts());
+        lowrep.set(_porders_desc->maxsize());
+        highrep.set(_porders_desc->maxsize());
+
+        struct tm date;
+        localtime_r(&in.o_orderdate, &date);
+        date.tm_mon += 2;
+        if (date.tm_mon > 11) {
+            date.tm_mon -= 12;
+            date.tm_year ++;
+        }
+        time_t last_orderdate = mktime(&date);
+
+        index_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->o_get_range_iter_by_index(_pssm, tmp_o_iter,
+                                                     prorders,
+                                                     lowrep, highrep,
+                                                     in.o_orderdate,
+                                                     last_orderdate));
+        guard< index_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        build_op<q4_omap_t,q4_forderkey_t,q4_fovalue_t>
+            build(orders, q4_forderkey_t(), q4_fovalue_t());
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorders, build));
+    }
+
+    // lineitem
+    q4_fcount_t count;
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t areprow(_plineitem_man->ts());
+        areprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &areprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        typedef probe_op<q4_omap_t,q4_forderkey_t,q4_fcount_t> probe_t;
+        probe_t probe(orders, q4_forderkey_t(), count);
+        filter_op<q4_flpred_t,probe_t> filter(q4_flpred_t(), probe);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+    }
+
+    for (int i=0; i<END_O_PRIORITY; i++) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d\n", i, count._count[i]);
+        if (presult) {
+            presult->new_row();
+            presult->add(i);
+            presult->add(count._count[i]);
+        }
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q5 (fused)
+ *
+ * scan nation   --> filter (region) --> build N (revenue)
+ * scan customer --> probe N --> build C (nation)
+ * scan orders   --> filter (orderdate) --> probe C --> build O (nation)
+ * scan supplier --> probe N --> build S (nation)
+ * scan lineitem --> probe O --> sum, if the supplier is of the same nation
+ *
+ ********************************************************************/
+
+typedef fused_map_t<int,double> q5_nmap_t;
+typedef fused_map_t<int,int>    q5_kmap_t;
+
+struct q5_fnvalue_t
+{
+    inline double operator()(const table_row_t&) const { return (0); }
+};
+
+// the time_t range [lo,hi) of the iterator plan, as dates
+struct q5_fopred_t
+{
+    int _lo;
+    int _hi;
+    q5_fopred_t(const time_t lo, const time_t hi)
+        : _lo(date_key_before(lo)), _hi(date_key_before(hi)) { }
+    inline bool operator()(const table_row_t& r) const {
+        int d = date_col_t<4>::get(r);
+        return ((d > _lo) && (d <= _hi));
+    }
+};
+
+struct q5_fobuild_t
+{
+    q5_kmap_t& _orders;
+    q5_fobuild_t(q5_kmap_t& orders) : _orders(orders) { }
+    inline void operator()(const table_row_t& r, int& nation) {
+        _orders.get_or_insert(col_t<0,int>::get(r), nation);
+    }
+};
+
+struct q5_frevenue_t
+{
+    q5_nmap_t& _nations;
+    q5_kmap_t& _supps;
+    q5_frevenue_t(q5_nmap_t& nations, q5_kmap_t& supps)
+        : _nations(nations), _supps(supps) { }
+    inline void operator()(const table_row_t& r, int& nation) {
+        int* snation = _supps.find(col_t<2,int>::get(r));
+        if (snation && (*snation == nation)) {
+            *_nations.find(nation) +=
+                col_t<5,double>::get(r) * (1-col_t<6,double>::get(r));
+        }
+    }
+};
+
+struct q5_foutput_t
+{
+    tpch_result_t* _presult;
+    q5_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const int& nation, const double& revenue) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%.2f\n", nation, revenue);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(nation);
+            _presult->add(revenue);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q5(q5_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    typedef col_of_t<0,int> key0_t;
+
+    // nation
+    q5_nmap_t nations;
+    {
+        tuple_guard<nation_man_impl> prnation(_pnation_man);
+        rep_row_t areprow(_pnation_man->ts());
+        areprow.set(_pnation_desc->maxsize());
+        prnation->_rep = &areprow;
+
+        table_scan_iter_impl<nation_t>* tmp_n_iter;
+        W_DO(_pnation_man->get_iter_for_file_scan(_pssm, tmp_n_iter));
+        guard< table_scan_iter_impl<nation_t> > n_iter(tmp_n_iter);
+
+        typedef build_op<q5_nmap_t,key0_t,q5_fnvalue_t> build_t;
+        build_t build(nations, key0_t(), q5_fnvalue_t());
+        filter_op<q2_fnpred_t,build_t> filter(q2_fnpred_t(in.r_name), build);
+
+        W_DO(fused_scan(_pssm, tmp_n_iter, *prnation, filter));
+    }
+
+    // customer
+    q5_kmap_t custs;
+    {
+        tuple_guard<customer_man_impl> prcustomer(_pcustomer_man);
+        rep_row_t acreprow(_pcustomer_man->ts());
+        acreprow.set(_pcustomer_desc->maxsize());
+        prcustomer->_rep = &acreprow;
+
+        table_scan_iter_impl<customer_t>* tmp_c_iter;
+        W_DO(_pcustomer_man->get_iter_for_file_scan(_pssm, tmp_c_iter));
+        guard< table_scan_iter_impl<customer_t> > c_iter(tmp_c_iter);
+
+        typedef build_op<q5_kmap_t,key0_t,col_of_t<3,int> > build_t;
+        build_t build(custs, key0_t(), col_of_t<3,int>());
+        probe_op<q5_nmap_t,col_of_t<3,int>,build_t>
+            probe(nations, col_of_t<3,int>(), build);
+
+        W_DO(fused_scan(_pssm, tmp_c_iter, *prcustomer, probe));
+    }
+
+    // orders, same range as the iterator plan
+    q5_kmap_t orders;
+    {
+        tuple_guard<orders_man_impl> prorders(_porders_man);
+        rep_row_t aoreprow(_porders_man->ts());
+        aoreprow.set(_porders_desc->maxsize());
+        prorders->_rep = &aoreprow;
+
+        struct tm date;
+        localtime_r(&in.o_orderdate, &date);
+        date.tm_year += 1;
+        time_t last_orderdate = mktime(&date);
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        q5_fobuild_t build(orders);
+        typedef probe_op<q5_kmap_t,col_of_t<1,int>,q5_fobuild_t> probe_t;
+        probe_t probe(custs, col_of_t<1,int>(), build);
+        filter_op<q5_fopred_t,probe_t>
+            filter(q5_fopred_t(in.o_orderdate, last_orderdate), probe);
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorders, filter));
+    }
+
+    // supplier
+    q5_kmap_t supps;
+    {
+        tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+        rep_row_t sreprow(_psupplier_man->ts());
+        sreprow.set(_psupplier_desc->maxsize());
+        prsupp->_rep = &sreprow;
+
+        table_scan_iter_impl<supplier_t>* tmp_s_iter;
+        W_DO(_psupplier_man->get_iter_for_file_scan(_pssm, tmp_s_iter));
+        guard< table_scan_iter_impl<supplier_t> > s_iter(tmp_s_iter);
+
+        typedef build_op<q5_kmap_t,key0_t,col_of_t<3,int> > build_t;
+        build_t build(supps, key0_t(), col_of_t<3,int>());
+        probe_op<q5_nmap_t,col_of_t<3,int>,build_t>
+            probe(nations, col_of_t<3,int>(), build);
+
+        W_DO(fused_scan(_pssm, tmp_s_iter, *prsupp, probe));
+    }
+
+    // lineitem
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t alreprow(_plineitem_man->ts());
+        alreprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &alreprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        q5_frevenue_t revenue(nations, supps);
+        probe_op<q5_kmap_t,key0_t,q5_frevenue_t>
+            probe(orders, key0_t(), revenue);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, probe));
+    }
+
+    q5_foutput_t output(presult);
+    nations.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q6 (fused)
+ *
+ * index scan lineitem (shipdate) --> filter (discount,quantity) --> sum
+ *
+ ********************************************************************/
+
+struct q6_fpred_t
+{
+    double _disc_lo;
+    double _disc_hi;
+    double _quantity;
+    q6_fpred_t(const double disc, const double quantity)
+        : _disc_lo(disc-0.01), _disc_hi(disc+0.01), _quantity(quantity) { }
+    inline bool operator()(const table_row_t& r) const {
+        double disc = col_t<6,double>::get(r);
+        return ((disc > _disc_lo) && (disc < _disc_hi) &&
+                (col_t<4,double>::get(r) < _quantity));
+    }
+};
+
+struct q6_fsum_t
+{
+    double _revenue;
+    q6_fsum_t() : _revenue(0) { }
+    inline void operator()(const table_row_t& r) {
+        _revenue += col_t<5,double>::get(r) * col_t<6,double>::get(r);
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q6(q6_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+    rep_row_t areprow(_plineitem_man->ts());
+    areprow.set(_plineitem_desc->maxsize());
+    prlineitem->_rep = &areprow;
+
+    rep_row_t lowrep(_plineitem_man->ts());
+    rep_row_t highrep(_plineitem_man->ts());
+    lowrep.set(_plineitem_desc->maxsize());
+    highrep.set(_plineitem_desc->maxsize());
+
+    // same range as the iterator plan
+    struct tm date;
+    if (gmtime_r(&(in.l_shipdate), &date) == NULL) {
+	return RCOK;
+    }
+    date.tm_year ++;
+    time_t last_shipdate = mktime(&date);
+
+    index_scan_iter_impl<lineitem_t>* tmp_l_iter;
+    W_DO(_plineitem_man->l_get_range_iter_by_index(_pssm, tmp_l_iter,
+                                                   prlineitem, lowrep,
+                                                   highrep, in.l_shipdate,
+                                                   last_shipdate));
+    guard< index_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+    q6_fsum_t sum;
+    filter_op<q6_fpred_t,q6_fsum_t>
+        filter(q6_fpred_t(in.l_discount, in.l_quantity), sum);
+
+    W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+
+    TRACE( TRACE_QUERY_RESULTS, "%.2f\n", sum._revenue);
+    if (presult) {
+        presult->new_row();
+        presult->add(sum._revenue);
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q7 (fused)
+ *
+ * scan customer --> filter (nation1,nation2) --> build C (nation)
+ * scan orders   --> probe C --> build O (customer nation)
+ * scan supplier --> filter (nation1,nation2) --> build S (nation)
+ * scan lineitem --> filter (shipyear) --> probe O
+ *               --> aggregate (supp nation,cust nation,year)
+ *
+ ********************************************************************/
+
+struct q7_fkey_t
+{
+    int _supp_nation;
+    int _cust_nation;
+    int _year;
+};
+
+typedef fused_map_t<int,int>          q7_kmap_t;
+typedef fused_map_t<q7_fkey_t,double> q7_gmap_t;
+
+// C_NATIONKEY and S_NATIONKEY are both field 3
+struct q7_fnpred_t
+{
+    int _nation1;
+    int _nation2;
+    q7_fnpred_t(const int nation1, const int nation2)
+        : _nation1(nation1), _nation2(nation2) { }
+    inline bool operator()(const table_row_t& r) const {
+        int n = col_t<3,int>::get(r);
+        return ((n == _nation1) || (n == _nation2));
+    }
+};
+
+struct q7_fobuild_t
+{
+    q7_kmap_t& _orders;
+    q7_fobuild_t(q7_kmap_t& orders) : _orders(orders) { }
+    inline void operator()(const table_row_t& r, int& nation) {
+        _orders.get_or_insert(col_t<0,int>::get(r), nation);
+    }
+};
+
+struct q7_flpred_t
+{
+    inline bool operator()(const table_row_t& r) const {
+        int y = date_year(date_col_t<10>::get(r));
+        return ((y >= 1995) && (y <= 1996));
+    }
+};
+
+// the shipments between the two nations, in either direction
+struct q7_fvolume_t
+{
+    q7_gmap_t& _groups;
+    q7_kmap_t& _supps;
+    q7_fvolume_t(q7_gmap_t& groups, q7_kmap_t& supps)
+        : _groups(groups), _supps(supps) { }
+    inline void operator()(const table_row_t& r, int& cust_nation) {
+        int* supp_nation = _supps.find(col_t<2,int>::get(r));
+        if (!supp_nation || (*supp_nation == cust_nation)) return;
+        q7_fkey_t k;
+        k._supp_nation = *supp_nation;
+        k._cust_nation = cust_nation;
+        k._year = date_year(date_col_t<10>::get(r));
+        *_groups.get_or_insert(k, 0) +=
+            col_t<5,double>::get(r) * (1-col_t<6,double>::get(r));
+    }
+};
+
+struct q7_foutput_t
+{
+    tpch_result_t* _presult;
+    q7_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const q7_fkey_t& k, const double& revenue) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d|%d|%.2f\n",
+               k._supp_nation, k._cust_nation, k._year, revenue);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(k._supp_nation);
+            _presult->add(k._cust_nation);
+            _presult->add(k._year);
+            _presult->add(revenue);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q7(q7_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    typedef col_of_t<0,int> key0_t;
+
+    // customer
+    q7_kmap_t custs;
+    {
+        tuple_guard<customer_man_impl> prcustomer(_pcustomer_man);
+        rep_row_t areprow(_pcustomer_man->ts());
+        areprow.set(_pcustomer_desc->maxsize());
+        prcustomer->_rep = &areprow;
+
+        table_scan_iter_impl<customer_t>* tmp_c_iter;
+        W_DO(_pcustomer_man->get_iter_for_file_scan(_pssm, tmp_c_iter));
+        guard< table_scan_iter_impl<customer_t> > c_iter(tmp_c_iter);
+
+        typedef build_op<q7_kmap_t,key0_t,col_of_t<3,int> > build_t;
+        build_t build(custs, key0_t(), col_of_t<3,int>());
+        filter_op<q7_fnpred_t,build_t>
+            filter(q7_fnpred_t(in.n_name1, in.n_name2), build);
+
+        W_DO(fused_scan(_pssm, tmp_c_iter, *prcustomer, filter));
+    }
+
+    // orders
+    q7_kmap_t orders;
+    {
+        tuple_guard<orders_man_impl> prorder(_porders_man);
+        rep_row_t o_areprow(_porders_man->ts());
+        o_areprow.set(_porders_desc->maxsize());
+        prorder->_rep = &o_areprow;
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        q7_fobuild_t build(orders);
+        probe_op<q7_kmap_t,col_of_t<1,int>,q7_fobuild_t>
+            probe(custs, col_of_t<1,int>(), build);
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorder, probe));
+    }
+
+    // supplier
+    q7_kmap_t supps;
+    {
+        tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+        rep_row_t sreprow(_psupplier_man->ts());
+        sreprow.set(_psupplier_desc->maxsize());
+        prsupp->_rep = &sreprow;
+
+        table_scan_iter_impl<supplier_t>* tmp_s_iter;
+        W_DO(_psupplier_man->get_iter_for_file_scan(_pssm, tmp_s_iter));
+        guard< table_scan_iter_impl<supplier_t> > s_iter(tmp_s_iter);
+
+        typedef build_op<q7_kmap_t,key0_t,col_of_t<3,int> > build_t;
+        build_t build(supps, key0_t(), col_of_t<3,int>());
+        filter_op<q7_fnpred_t,build_t>
+            filter(q7_fnpred_t(in.n_name1, in.n_name2), build);
+
+        W_DO(fused_scan(_pssm, tmp_s_iter, *prsupp, filter));
+    }
+
+    // lineitem
+    q7_gmap_t groups;
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t alreprow(_plineitem_man->ts());
+        alreprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &alreprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        q7_fvolume_t volume(groups, supps);
+        typedef probe_op<q7_kmap_t,key0_t,q7_fvolume_t> probe_t;
+        probe_t probe(orders, key0_t(), volume);
+        filter_op<q7_flpred_t,probe_t> filter(q7_flpred_t(), probe);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+    }
+
+    q7_foutput_t output(presult);
+    groups.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q8 (fused)
+ *
+ * probe nation (n_name) for its region
+ * scan nation   --> filter (region) --> build N
+ * scan part     --> filter (type) --> build P
+ * scan customer --> filter (in N) --> build C
+ * index scan orders (orderdate) --> filter (in C) --> build O (year)
+ * scan supplier --> build S (nation)
+ * scan lineitem --> filter (in P) --> probe O --> aggregate (year)
+ *
+ ********************************************************************/
+
+struct q8_fshare_t
+{
+    double _nation;
+    double _total;
+};
+
+typedef fused_map_t<int,char>        q8_kmap_t;
+typedef fused_map_t<int,int>         q8_imap_t;
+typedef fused_map_t<int,q8_fshare_t> q8_gmap_t;
+
+struct q8_fppred_t
+{
+    char _type[26];
+    q8_fppred_t(const tpch_p_type type) { type_to_str(type, _type); }
+    inline bool operator()(const table_row_t& r) const {
+        char type[STRSIZE(25)];
+        str_col_t<4,25>::get(r, type);
+        return (strcmp(type, _type) == 0);
+    }
+};
+
+struct q8_foyear_t
+{
+    inline int operator()(const table_row_t& r) const {
+        return (date_year(date_col_t<4>::get(r)));
+    }
+};
+
+// the volume of each year, and the part supplied from the nation
+struct q8_fshare_update_t
+{
+    q8_gmap_t& _groups;
+    q8_imap_t& _supps;
+    int        _nation;
+    q8_fshare_update_t(q8_gmap_t& groups, q8_imap_t& supps, const int nation)
+        : _groups(groups), _supps(supps), _nation(nation) { }
+    inline void operator()(const table_row_t& r, int& year) {
+        static const q8_fshare_t zero = { 0, 0 };
+        double price = col_t<5,double>::get(r) * (1-col_t<6,double>::get(r));
+        q8_fshare_t* s = _groups.get_or_insert(year, zero);
+        int* supp_nation = _supps.find(col_t<2,int>::get(r));
+        if (supp_nation && (*supp_nation == _nation)) s->_nation += price;
+        s->_total += price;
+    }
+};
+
+struct q8_foutput_t
+{
+    tpch_result_t* _presult;
+    q8_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const int& year, const q8_fshare_t& s) {
+        double share = (s._total > 0 ? s._nation / s._total : 0);
+        TRACE( TRACE_QUERY_RESULTS, "%d|%.4f\n", year, share);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(year);
+            _presult->add(share);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q8(q8_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    typedef col_of_t<0,int> key0_t;
+
+    // nation
+    q8_kmap_t nations;
+    {
+        tuple_guard<nation_man_impl> prnation(_pnation_man);
+        rep_row_t areprow(_pnation_man->ts());
+        areprow.set(_pnation_desc->maxsize());
+        prnation->_rep = &areprow;
+
+        W_DO(_pnation_man->n_index_probe(_pssm, prnation, in.n_name));
+        int r_key = col_t<2,int>::get(*prnation);
+
+        table_scan_iter_impl<nation_t>* tmp_n_iter;
+        W_DO(_pnation_man->get_iter_for_file_scan(_pssm, tmp_n_iter));
+        guard< table_scan_iter_impl<nation_t> > n_iter(tmp_n_iter);
+
+        typedef build_op<q8_kmap_t,key0_t,mark_t> build_t;
+        build_t build(nations, key0_t(), mark_t());
+        filter_op<q2_fnpred_t,build_t> filter(q2_fnpred_t(r_key), build);
+
+        W_DO(fused_scan(_pssm, tmp_n_iter, *prnation, filter));
+    }
+
+    // part
+    q8_kmap_t parts;
+    {
+        tuple_guard<part_man_impl> prpart(_ppart_man);
+        rep_row_t preprow(_ppart_man->ts());
+        preprow.set(_ppart_desc->maxsize());
+        prpart->_rep = &preprow;
+
+        table_scan_iter_impl<part_t>* tmp_p_iter;
+        W_DO(_ppart_man->get_iter_for_file_scan(_pssm, tmp_p_iter));
+        guard< table_scan_iter_impl<part_t> > p_iter(tmp_p_iter);
+
+        typedef build_op<q8_kmap_t,key0_t,mark_t> build_t;
+        build_t build(parts, key0_t(), mark_t());
+        filter_op<q8_fppred_t,build_t> filter(q8_fppred_t(in.p_type), build);
+
+        W_DO(fused_scan(_pssm, tmp_p_iter, *prpart, filter));
+    }
+
+    // customer
+    q8_kmap_t custs;
+    {
+        tuple_guard<customer_man_impl> prcustomer(_pcustomer_man);
+        rep_row_t acreprow(_pcustomer_man->ts());
+        acreprow.set(_pcustomer_desc->maxsize());
+        prcustomer->_rep = &acreprow;
+
+        table_scan_iter_impl<customer_t>* tmp_c_iter;
+        W_DO(_pcustomer_man->get_iter_for_file_scan(_pssm, tmp_c_iter));
+        guard< table_scan_iter_impl<customer_t> > c_iter(tmp_c_iter);
+
+        typedef in_map_t<q8_kmap_t,col_of_t<3,int>,true> pred_t;
+        typedef build_op<q8_kmap_t,key0_t,mark_t> build_t;
+        build_t build(custs, key0_t(), mark_t());
+        filter_op<pred_t,build_t>
+            filter(pred_t(nations, col_of_t<3,int>()), build);
+
+        W_DO(fused_scan(_pssm, tmp_c_iter, *prcustomer, filter));
+    }
+
+    // orders, same range as the iterator plan
+    q8_imap_t orders;
+    {
+        tuple_guard<orders_man_impl> prorders(_porders_man);
+        rep_row_t aoreprow(_porders_man->ts());
+        aoreprow.set(_porders_desc->maxsize());
+        prorders->_rep = &aoreprow;
+
+        rep_row_t lowrep(_porders_man->ts());
+        rep_row_t highrep(_porders_man->ts());
+        lowrep.set(_porders_desc->maxsize());
+        highrep.set(_porders_desc->maxsize());
+
+        time_t t1 = date_to_timet(ymd_to_date(1995,1,1));
+        time_t t2 = date_to_timet(ymd_to_date(1996,12,31));
+
+        index_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->o_get_range_iter_by_index(_pssm, tmp_o_iter,
+                                                     prorders, lowrep,
+                                                     highrep, t1, t2));
+        guard< index_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        typedef in_map_t<q8_kmap_t,col_of_t<1,int>,true> pred_t;
+        typedef build_op<q8_imap_t,key0_t,q8_foyear_t> build_t;
+        build_t build(orders, key0_t(), q8_foyear_t());
+        filter_op<pred_t,build_t>
+            filter(pred_t(custs, col_of_t<1,int>()), build);
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorders, filter));
+    }
+
+    // supplier
+    q8_imap_t supps;
+    {
+        tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+        rep_row_t sreprow(_psupplier_man->ts());
+        sreprow.set(_psupplier_desc->maxsize());
+        prsupp->_rep = &sreprow;
+
+        table_scan_iter_impl<supplier_t>* tmp_s_iter;
+        W_DO(_psupplier_man->get_iter_for_file_scan(_pssm, tmp_s_iter));
+        guard< table_scan_iter_impl<supplier_t> > s_iter(tmp_s_iter);
+
+        build_op<q8_imap_t,key0_t,col_of_t<3,int> >
+            build(supps, key0_t(), col_of_t<3,int>());
+
+        W_DO(fused_scan(_pssm, tmp_s_iter, *prsupp, build));
+    }
+
+    // lineitem
+    q8_gmap_t groups(2);
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t alreprow(_plineitem_man->ts());
+        alreprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &alreprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        q8_fshare_update_t share(groups, supps, in.n_name);
+        typedef probe_op<q8_imap_t,key0_t,q8_fshare_update_t> probe_t;
+        probe_t probe(orders, key0_t(), share);
+        typedef in_map_t<q8_kmap_t,col_of_t<1,int>,true> pred_t;
+        filter_op<pred_t,probe_t>
+            filter(pred_t(parts, col_of_t<1,int>()), probe);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+    }
+
+    q8_foutput_t output(presult);
+    groups.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q9 (fused)
+ *
+ * scan part     --> filter (name) --> build P
+ * scan supplier --> build S (nation)
+ * scan orders   --> build O (year)
+ * scan partsupp --> filter (in P) --> build PS (supplycost)
+ * scan lineitem --> filter (in P) --> probe PS --> aggregate (nation,year)
+ *
+ ********************************************************************/
+
+struct q9_fpskey_t
+{
+    int _partkey;
+    int _suppkey;
+};
+
+struct q9_fkey_t
+{
+    int _nation;
+    int _year;
+};
+
+typedef fused_map_t<int,char>           q9_kmap_t;
+typedef fused_map_t<int,int>            q9_imap_t;
+typedef fused_map_t<q9_fpskey_t,double> q9_psmap_t;
+typedef fused_map_t<q9_fkey_t,double>   q9_gmap_t;
+
+struct q9_fppred_t
+{
+    char _name[55];
+    q9_fppred_t(const int name) { pname_to_str(name, _name); }
+    inline bool operator()(const table_row_t& r) const {
+        char name[STRSIZE(55)];
+        str_col_t<1,55>::get(r, name);
+        return (strstr(name, _name) != NULL);
+    }
+};
+
+// (partkey,suppkey) of partsupp (PS_PARTKEY, PS_SUPPKEY) and of
+// lineitem (L_PARTKEY, L_SUPPKEY)
+template <uint PIDX, uint SIDX>
+struct q9_fpsof_t
+{
+    inline q9_fpskey_t operator()(const table_row_t& r) const {
+        q9_fpskey_t k;
+        k._partkey = col_t<PIDX,int>::get(r);
+        k._suppkey = col_t<SIDX,int>::get(r);
+        return (k);
+    }
+};
+
+struct q9_fprofit_t
+{
+    q9_gmap_t& _groups;
+    q9_imap_t& _supps;
+    q9_imap_t& _orders;
+    q9_fprofit_t(q9_gmap_t& groups, q9_imap_t& supps, q9_imap_t& orders)
+        : _groups(groups), _supps(supps), _orders(orders) { }
+    inline void operator()(const table_row_t& r, double& supplycost) {
+        int* year = _orders.find(col_t<0,int>::get(r));
+        int* nation = _supps.find(col_t<2,int>::get(r));
+        if (!year || !nation) return;
+        q9_fkey_t k;
+        k._nation = *nation;
+        k._year = *year;
+        *_groups.get_or_insert(k, 0) +=
+            col_t<5,double>::get(r) * (1-col_t<6,double>::get(r)) -
+            supplycost * col_t<4,double>::get(r);
+    }
+};
+
+struct q9_foutput_t
+{
+    tpch_result_t* _presult;
+    q9_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const q9_fkey_t& k, const double& profit) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d|%.2f\n",
+               k._nation, k._year, profit);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(k._nation);
+            _presult->add(k._year);
+            _presult->add(profit);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q9(q9_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    typedef col_of_t<0,int> key0_t;
+
+    // part
+    q9_kmap_t parts;
+    {
+        tuple_guard<part_man_impl> prpart(_ppart_man);
+        rep_row_t preprow(_ppart_man->ts());
+        preprow.set(_ppart_desc->maxsize());
+        prpart->_rep = &preprow;
+
+        table_scan_iter_impl<part_t>* tmp_p_iter;
+        W_DO(_ppart_man->get_iter_for_file_scan(_pssm, tmp_p_iter));
+        guard< table_scan_iter_impl<part_t> > p_iter(tmp_p_iter);
+
+        typedef build_op<q9_kmap_t,key0_t,mark_t> build_t;
+        build_t build(parts, key0_t(), mark_t());
+        filter_op<q9_fppred_t,build_t> filter(q9_fppred_t(in.p_name), build);
+
+        W_DO(fused_scan(_pssm, tmp_p_iter, *prpart, filter));
+    }
+
+    // supplier
+    q9_imap_t supps;
+    {
+        tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+        rep_row_t sreprow(_psupplier_man->ts());
+        sreprow.set(_psupplier_desc->maxsize());
+        prsupp->_rep = &sreprow;
+
+        table_scan_iter_impl<supplier_t>* tmp_s_iter;
+        W_DO(_psupplier_man->get_iter_for_file_scan(_pssm, tmp_s_iter));
+        guard< table_scan_iter_impl<supplier_t> > s_iter(tmp_s_iter);
+
+        build_op<q9_imap_t,key0_t,col_of_t<3,int> >
+            build(supps, key0_t(), col_of_t<3,int>());
+
+        W_DO(fused_scan(_pssm, tmp_s_iter, *prsupp, build));
+    }
+
+    // orders
+    q9_imap_t orders;
+    {
+        tuple_guard<orders_man_impl> prorder(_porders_man);
+        rep_row_t o_areprow(_porders_man->ts());
+        o_areprow.set(_porders_desc->maxsize());
+        prorder->_rep = &o_areprow;
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        build_op<q9_imap_t,key0_t,q8_foyear_t>
+            build(orders, key0_t(), q8_foyear_t());
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorder, build));
+    }
+
+    typedef in_map_t<q9_kmap_t,col_of_t<0,int>,true> pspred_t;
+    typedef in_map_t<q9_kmap_t,col_of_t<1,int>,true> lpred_t;
+
+    // partsupp
+    q9_psmap_t partsupps;
+    {
+        tuple_guard<partsupp_man_impl> prpartsupp(_ppartsupp_man);
+        rep_row_t apsreprow(_ppartsupp_man->ts());
+        apsreprow.set(_ppartsupp_desc->maxsize());
+        prpartsupp->_rep = &apsreprow;
+
+        table_scan_iter_impl<partsupp_t>* tmp_ps_iter;
+        W_DO(_ppartsupp_man->get_iter_for_file_scan(_pssm, tmp_ps_iter));
+        guard< table_scan_iter_impl<partsupp_t> > ps_iter(tmp_ps_iter);
+
+        typedef build_op<q9_psmap_t,q9_fpsof_t<0,1>,col_of_t<3,double> >
+            build_t;
+        build_t build(partsupps, q9_fpsof_t<0,1>(), col_of_t<3,double>());
+        filter_op<pspred_t,build_t>
+            filter(pspred_t(parts, col_of_t<0,int>()), build);
+
+        W_DO(fused_scan(_pssm, tmp_ps_iter, *prpartsupp, filter));
+    }
+
+    // lineitem
+    q9_gmap_t groups;
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t areprow(_plineitem_man->ts());
+        areprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &areprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        q9_fprofit_t profit(groups, supps, orders);
+        typedef probe_op<q9_psmap_t,q9_fpsof_t<1,2>,q9_fprofit_t> probe_t;
+        probe_t probe(partsupps, q9_fpsof_t<1,2>(), profit);
+        filter_op<lpred_t,probe_t>
+            filter(lpred_t(parts, col_of_t<1,int>()), probe);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+    }
+
+    q9_foutput_t output(presult);
+    groups.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q10 (fused)
+ *
+ * scan orders   --> filter (orderdate) --> build O (customer), C (revenue)
+ * scan lineitem --> filter (returnflag) --> probe O --> sum per customer
+ * probe customer, for each customer of C
+ *
+ ********************************************************************/
+
+typedef fused_map_t<int,int>    q10_omap_t;
+typedef fused_map_t<int,double> q10_cmap_t;
+
+// each customer with an order in the range has a revenue, maybe 0
+struct q10_fobuild_t
+{
+    q10_omap_t& _orders;
+    q10_cmap_t& _custs;
+    q10_fobuild_t(q10_omap_t& orders, q10_cmap_t& custs)
+        : _orders(orders), _custs(custs) { }
+    inline void operator()(const table_row_t& r) {
+        int custkey = col_t<1,int>::get(r);
+        _orders.get_or_insert(col_t<0,int>::get(r), custkey);
+        _custs.get_or_insert(custkey, 0);
+    }
+};
+
+struct q10_flpred_t
+{
+    inline bool operator()(const table_row_t& r) const {
+        return (col_t<8,char>::get(r) == 'R');
+    }
+};
+
+struct q10_frevenue_t
+{
+    q10_cmap_t& _custs;
+    q10_frevenue_t(q10_cmap_t& custs) : _custs(custs) { }
+    inline void operator()(const table_row_t& r, int& custkey) {
+        *_custs.find(custkey) +=
+            col_t<5,double>::get(r) * (1-col_t<6,double>::get(r));
+    }
+};
+
+struct q10_fcollect_t
+{
+    std::vector< std::pair<int,double> >& _custs;
+    q10_fcollect_t(std::vector< std::pair<int,double> >& custs)
+        : _custs(custs) { }
+    void operator()(const int& custkey, const double& revenue) {
+        _custs.push_back(std::pair<int,double>(custkey, revenue));
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q10(q10_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // orders, same range as the iterator plan
+    q10_omap_t orders;
+    q10_cmap_t custs;
+    {
+        tuple_guard<orders_man_impl> prorder(_porders_man);
+        rep_row_t o_areprow(_porders_man->ts());
+        o_areprow.set(_porders_desc->maxsize());
+        prorder->_rep = &o_areprow;
+
+        struct tm date;
+        if (gmtime_r(&(in.o_orderdate), &date) == NULL) {
+            return RCOK;
+        }
+        date.tm_mon += 3;
+        if (date.tm_mon > 11) {
+            date.tm_mon -= 12;
+            date.tm_year ++;
+        }
+        time_t last_orderdate = mktime(&date);
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        q10_fobuild_t build(orders, custs);
+        filter_op<q5_fopred_t,q10_fobuild_t>
+            filter(q5_fopred_t(in.o_orderdate, last_orderdate), build);
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorder, filter));
+    }
+
+    // lineitem
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t areprow(_plineitem_man->ts());
+        areprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &areprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        q10_frevenue_t revenue(custs);
+        typedef probe_op<q10_omap_t,col_of_t<0,int>,q10_frevenue_t> probe_t;
+        probe_t probe(orders, col_of_t<0,int>(), revenue);
+        filter_op<q10_flpred_t,probe_t> filter(q10_flpred_t(), probe);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+    }
+
+    // customer
+    std::vector< std::pair<int,double> > revenues;
+    q10_fcollect_t collect(revenues);
+    custs.for_each(collect);
+
+    tuple_guard<customer_man_impl> prcustomer(_pcustomer_man);
+    rep_row_t acreprow(_pcustomer_man->ts());
+    acreprow.set(_pcustomer_desc->maxsize());
+    prcustomer->_rep = &acreprow;
+
+    for (size_t i=0; i<revenues.size(); i++) {
+        if (_pcustomer_man->c_index_probe(_pssm, prcustomer,
+                                          revenues[i].first).is_error()) {
+            continue;
+        }
+        int nation = col_t<3,int>::get(*prcustomer);
+        double acctbal = col_t<5,double>::get(*prcustomer);
+        TRACE( TRACE_QUERY_RESULTS, "%d|%.2f|%d|%.2f\n",
+               revenues[i].first, revenues[i].second, nation, acctbal);
+        if (presult) {
+            presult->new_row();
+            presult->add(revenues[i].first);
+            presult->add(revenues[i].second);
+            presult->add(nation);
+            presult->add(acctbal);
+        }
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q11 (fused)
+ *
+ * scan supplier --> filter (nation) --> build S
+ * scan partsupp --> filter (in S) --> aggregate (partkey), and the total
+ * the parts above fraction of the total
+ *
+ ********************************************************************/
+
+typedef fused_map_t<int,char>   q11_smap_t;
+typedef fused_map_t<int,double> q11_pmap_t;
+
+// sums the value per part, and the total
+struct q11_fupdate_t
+{
+    double* _ptotal;
+    q11_fupdate_t(double* ptotal) : _ptotal(ptotal) { }
+    inline double init() const { return (0); }
+    inline void operator()(double& sum, const table_row_t& r) const {
+        double value = col_t<2,int>::get(r) * col_t<3,double>::get(r);
+        sum += value;
+        *_ptotal += value;
+    }
+};
+
+struct q11_foutput_t
+{
+    double         _threshold;
+    tpch_result_t* _presult;
+    q11_foutput_t(const double threshold, tpch_result_t* presult)
+        : _threshold(threshold), _presult(presult) { }
+    void operator()(const int& partkey, const double& value) {
+        if (value <= _threshold) return;
+        TRACE( TRACE_QUERY_RESULTS, "%d|%.2f\n", partkey, value);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(partkey);
+            _presult->add(value);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q11(q11_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // supplier
+    q11_smap_t supps;
+    {
+        tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+        rep_row_t sreprow(_psupplier_man->ts());
+        sreprow.set(_psupplier_desc->maxsize());
+        prsupp->_rep = &sreprow;
+
+        table_scan_iter_impl<supplier_t>* tmp_s_iter;
+        W_DO(_psupplier_man->get_iter_for_file_scan(_pssm, tmp_s_iter));
+        guard< table_scan_iter_impl<supplier_t> > s_iter(tmp_s_iter);
+
+        typedef build_op<q11_smap_t,col_of_t<0,int>,mark_t> build_t;
+        build_t build(supps, col_of_t<0,int>(), mark_t());
+        filter_op<q7_fnpred_t,build_t>
+            filter(q7_fnpred_t(in.n_name, in.n_name), build);
+
+        W_DO(fused_scan(_pssm, tmp_s_iter, *prsupp, filter));
+    }
+
+    // partsupp
+    q11_pmap_t parts;
+    double total = 0;
+    {
+        tuple_guard<partsupp_man_impl> prpartsupp(_ppartsupp_man);
+        rep_row_t psreprow(_ppartsupp_man->ts());
+        psreprow.set(_ppartsupp_desc->maxsize());
+        prpartsupp->_rep = &psreprow;
+
+        table_scan_iter_impl<partsupp_t>* tmp_ps_iter;
+        W_DO(_ppartsupp_man->get_iter_for_file_scan(_pssm, tmp_ps_iter));
+        guard< table_scan_iter_impl<partsupp_t> > ps_iter(tmp_ps_iter);
+
+        typedef aggregate_op<q11_pmap_t,col_of_t<0,int>,q11_fupdate_t> agg_t;
+        agg_t agg(parts, col_of_t<0,int>(), q11_fupdate_t(&total));
+        typedef in_map_t<q11_smap_t,col_of_t<1,int>,true> pred_t;
+        filter_op<pred_t,agg_t> filter(pred_t(supps, col_of_t<1,int>()), agg);
+
+        W_DO(fused_scan(_pssm, tmp_ps_iter, *prpartsupp, filter));
+    }
+
+    q11_foutput_t output(total * in.fraction, presult);
+    parts.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q12 (fused)
+ *
+ * index scan lineitem (receiptdate) --> filter (shipmode,dates)
+ *                                   --> aggregate (orderkey)
+ * scan orders --> probe --> count high and low lines per shipmode
+ *
+ ********************************************************************/
+
+// the lines of an order with shipmode1 and shipmode2
+struct q12_flines_t
+{
+    int _lines[2];
+};
+
+typedef fused_map_t<int,q12_flines_t> q12_omap_t;
+
+struct q12_flpred_t
+{
+    int _shipmode1;
+    int _shipmode2;
+    q12_flpred_t(const int shipmode1, const int shipmode2)
+        : _shipmode1(shipmode1), _shipmode2(shipmode2) { }
+    inline bool operator()(const table_row_t& r) const {
+        int commitdate = date_col_t<11>::get(r);
+        if ((commitdate >= date_col_t<12>::get(r)) ||
+            (date_col_t<10>::get(r) >= commitdate)) return (false);
+        char shipmode[STRSIZE(10)];
+        str_col_t<14,10>::get(r, shipmode);
+        int m = str_to_shipmode(shipmode);
+        return ((m == _shipmode1) || (m == _shipmode2));
+    }
+};
+
+struct q12_fupdate_t
+{
+    int _shipmode1;
+    q12_fupdate_t(const int shipmode1) : _shipmode1(shipmode1) { }
+    inline q12_flines_t init() const {
+        q12_flines_t l;
+        memset(&l, 0, sizeof(l));
+        return (l);
+    }
+    inline void operator()(q12_flines_t& l, const table_row_t& r) const {
+        char shipmode[STRSIZE(10)];
+        str_col_t<14,10>::get(r, shipmode);
+        l._lines[(str_to_shipmode(shipmode) == _shipmode1) ? 0 : 1]++;
+    }
+};
+
+struct q12_fcount_t
+{
+    int _high[2];
+    int _low[2];
+    q12_fcount_t() {
+        memset(_high, 0, sizeof(_high));
+        memset(_low, 0, sizeof(_low));
+    }
+    // O_ORDERPRIORITY is "1-URGENT" ... "5-LOW"
+    inline void operator()(const table_row_t& r, q12_flines_t& l) {
+        char prio[STRSIZE(15)];
+        str_col_t<5,15>::get(r, prio);
+        int* count = ((prio[0] == '1') || (prio[0] == '2')) ? _high : _low;
+        count[0] += l._lines[0];
+        count[1] += l._lines[1];
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q12(q12_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // lineitem, same range as the iterator plan
+    q12_omap_t orders;
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t areprow(_plineitem_man->ts());
+        areprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &areprow;
+
+        rep_row_t lowrep(_plineitem_man->ts());
+        rep_row_t highrep(_plineitem_man->ts());
+        lowrep.set(_plineitem_desc->maxsize());
+        highrep.set(_plineitem_desc->maxsize());
+
+        struct tm date;
+        if (gmtime_r(&(in.l_receiptdate), &date) == NULL) {
+            return RCOK;
+        }
+        date.tm_year++;
+        time_t last_receiptdate = mktime(&date);
+
+        index_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->
+             l_get_range_iter_by_receiptdate_index(_pssm, tmp_l_iter,
+                                                   prlineitem, lowrep, highrep,
+                                                   in.l_receiptdate,
+                                                   last_receiptdate));
+        guard< index_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        typedef aggregate_op<q12_omap_t,col_of_t<0,int>,q12_fupdate_t> agg_t;
+        agg_t agg(orders, col_of_t<0,int>(), q12_fupdate_t(in.l_shipmode1));
+        filter_op<q12_flpred_t,agg_t>
+            filter(q12_flpred_t(in.l_shipmode1, in.l_shipmode2), agg);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+    }
+
+    // orders
+    q12_fcount_t count;
+    {
+        tuple_guard<orders_man_impl> prorder(_porders_man);
+        rep_row_t aoreprow(_porders_man->ts());
+        aoreprow.set(_porders_desc->maxsize());
+        prorder->_rep = &aoreprow;
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        probe_op<q12_omap_t,col_of_t<0,int>,q12_fcount_t>
+            probe(orders, col_of_t<0,int>(), count);
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorder, probe));
+    }
+
+    int shipmodes = (in.l_shipmode1 == in.l_shipmode2) ? 1 : 2;
+    for (int i=0; i<shipmodes; i++) {
+        int shipmode = (i == 0) ? in.l_shipmode1 : in.l_shipmode2;
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d|%d\n",
+               shipmode, count._high[i], count._low[i]);
+        if (presult) {
+            presult->new_row();
+            presult->add(shipmode);
+            presult->add(count._high[i]);
+            presult->add(count._low[i]);
+        }
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q13 (fused)
+ *
+ * scan customer --> build C (order count)
+ * scan orders   --> aggregate (custkey) count
+ * group the customers by their count
+ *
+ ********************************************************************/
+
+typedef fused_map_t<int,int> q13_map_t;
+
+struct q13_fzero_t
+{
+    inline int operator()(const table_row_t&) const { return (0); }
+};
+
+struct q13_fupdate_t
+{
+    inline int init() const { return (0); }
+    inline void operator()(int& count, const table_row_t&) const { count++; }
+};
+
+struct q13_fdist_t
+{
+    q13_map_t& _dist;
+    q13_fdist_t(q13_map_t& dist) : _dist(dist) { }
+    void operator()(const int&, const int& count) {
+        (*_dist.get_or_insert(count, 0))++;
+    }
+};
+
+struct q13_foutput_t
+{
+    tpch_result_t* _presult;
+    q13_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const int& count, const int& custdist) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d\n", count, custdist);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(count);
+            _presult->add(custdist);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q13(q13_input_t& /* in */, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // customer, with the ones without orders
+    q13_map_t custs;
+    {
+        tuple_guard<customer_man_impl> prcustomer(_pcustomer_man);
+        rep_row_t areprow(_pcustomer_man->ts());
+        areprow.set(_pcustomer_desc->maxsize());
+        prcustomer->_rep = &areprow;
+
+        table_scan_iter_impl<customer_t>* tmp_c_iter;
+        W_DO(_pcustomer_man->get_iter_for_file_scan(_pssm, tmp_c_iter));
+        guard< table_scan_iter_impl<customer_t> > c_iter(tmp_c_iter);
+
+        build_op<q13_map_t,col_of_t<0,int>,q13_fzero_t>
+            build(custs, col_of_t<0,int>(), q13_fzero_t());
+
+        W_DO(fused_scan(_pssm, tmp_c_iter, *prcustomer, build));
+    }
+
+    // orders
+    {
+        tuple_guard<orders_man_impl> prorder(_porders_man);
+        rep_row_t o_areprow(_porders_man->ts());
+        o_areprow.set(_porders_desc->maxsize());
+        prorder->_rep = &o_areprow;
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        aggregate_op<q13_map_t,col_of_t<1,int>,q13_fupdate_t>
+            agg(custs, col_of_t<1,int>(), q13_fupdate_t());
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorder, agg));
+    }
+
+    q13_map_t dist;
+    q13_fdist_t group(dist);
+    custs.for_each(group);
+
+    q13_foutput_t output(presult);
+    dist.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q14 (fused)
+ *
+ * index scan lineitem (shipdate) --> aggregate (partkey)
+ * scan part --> filter (PROMO) --> probe --> sum
+ *
+ ********************************************************************/
+
+typedef fused_map_t<int,double> q14_pmap_t;
+
+struct q14_fpartkey_t
+{
+    inline int operator()(const table_row_t& r) const {
+        return (col_t<1,int>::get(r));
+    }
+};
+
+// sums the revenue per part, and the total
+struct q14_fupdate_t
+{
+    double* _ptotal;
+    q14_fupdate_t(double* ptotal) : _ptotal(ptotal) { }
+    inline double init() const { return (0); }
+    inline void operator()(double& sum, const table_row_t& r) const {
+        double price = col_t<5,double>::get(r) * (1-col_t<6,double>::get(r));
+        sum += price;
+        *_ptotal += price;
+    }
+};
+
+struct q14_fppred_t
+{
+    inline bool operator()(const table_row_t& r) const {
+        char type[STRSIZE(25)];
+        str_col_t<4,25>::get(r, type);
+        return (strstr(type, "PROMO") != NULL);
+    }
+};
+
+struct q14_fppartkey_t
+{
+    inline int operator()(const table_row_t& r) const {
+        return (col_t<0,int>::get(r));
+    }
+};
+
+struct q14_fpromo_t
+{
+    double _promo;
+    q14_fpromo_t() : _promo(0) { }
+    inline void operator()(const table_row_t&, double& revenue) {
+        _promo += revenue;
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q14(q14_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // lineitem, same range as the iterator plan
+    q14_pmap_t parts;
+    double total = 0;
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t areprow(_plineitem_man->ts());
+        areprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &areprow;
+
+        rep_row_t lowrep(_plineitem_man->ts());
+        rep_row_t highrep(_plineitem_man->ts());
+        lowrep.set(_plineitem_desc->maxsize());
+        highrep.set(_plineitem_desc->maxsize());
+
+        struct tm date;
+        if (gmtime_r(&(in.l_shipdate), &date) == NULL) {
+            return RCOK;
+        }
+        date.tm_mon+=1;
+        if (date.tm_mon > 11) {
+            date.tm_mon -= 12;
+            date.tm_year ++;
+        }
+        time_t last_shipdate = mktime(&date);
+
+        index_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->l_get_range_iter_by_index(_pssm, tmp_l_iter,
+                                                       prlineitem, lowrep,
+                                                       highrep, in.l_shipdate,
+                                                       last_shipdate));
+        guard< index_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        aggregate_op<q14_pmap_t,q14_fpartkey_t,q14_fupdate_t>
+            agg(parts, q14_fpartkey_t(), q14_fupdate_t(&total));
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, agg));
+    }
+
+    // part
+    q14_fpromo_t promo;
+    {
+        tuple_guard<part_man_impl> prpart(_ppart_man);
+        rep_row_t preprow(_ppart_man->ts());
+        preprow.set(_ppart_desc->maxsize());
+        prpart->_rep = &preprow;
+
+        table_scan_iter_impl<part_t>* tmp_p_iter;
+        W_DO(_ppart_man->get_iter_for_file_scan(_pssm, tmp_p_iter));
+        guard< table_scan_iter_impl<part_t> > p_iter(tmp_p_iter);
+
+        typedef probe_op<q14_pmap_t,q14_fppartkey_t,q14_fpromo_t> probe_t;
+        probe_t probe(parts, q14_fppartkey_t(), promo);
+        filter_op<q14_fppred_t,probe_t> filter(q14_fppred_t(), probe);
+
+        W_DO(fused_scan(_pssm, tmp_p_iter, *prpart, filter));
+    }
+
+    double promo_revenue = (total > 0 ? 100 * promo._promo / total : 0);
+    TRACE( TRACE_QUERY_RESULTS, "%.2f\n", promo_revenue);
+    if (presult) {
+        presult->new_row();
+        presult->add(promo_revenue);
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q15 (fused)
+ *
+ * index scan lineitem (shipdate) --> aggregate (suppkey)
+ * the suppliers of the max revenue --> probe supplier
+ *
+ ********************************************************************/
+
+typedef fused_map_t<int,double> q15_smap_t;
+
+struct q15_fupdate_t
+{
+    inline double init() const { return (0); }
+    inline void operator()(double& sum, const table_row_t& r) const {
+        sum += col_t<5,double>::get(r) * (1-col_t<6,double>::get(r));
+    }
+};
+
+struct q15_fmax_t
+{
+    std::vector< std::pair<int,double> > _top;
+    void operator()(const int& suppkey, const double& revenue) {
+        if (!_top.empty() && (revenue < _top[0].second)) return;
+        if (!_top.empty() && (revenue > _top[0].second)) _top.clear();
+        _top.push_back(std::pair<int,double>(suppkey, revenue));
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q15(q15_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // lineitem, same range as the iterator plan
+    q15_smap_t supps;
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t areprow(_plineitem_man->ts());
+        areprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &areprow;
+
+        rep_row_t lowrep(_plineitem_man->ts());
+        rep_row_t highrep(_plineitem_man->ts());
+        lowrep.set(_plineitem_desc->maxsize());
+        highrep.set(_plineitem_desc->maxsize());
+
+        struct tm date;
+        if (gmtime_r(&(in.l_shipdate), &date) == NULL) {
+            return RCOK;
+        }
+        date.tm_mon+=3;
+        if (date.tm_mon > 11) {
+            date.tm_mon -= 12;
+            date.tm_year ++;
+        }
+        time_t last_shipdate = mktime(&date);
+
+        index_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->l_get_range_iter_by_index(_pssm, tmp_l_iter,
+                                                       prlineitem, lowrep,
+                                                       highrep, in.l_shipdate,
+                                                       last_shipdate));
+        guard< index_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        aggregate_op<q15_smap_t,col_of_t<2,int>,q15_fupdate_t>
+            agg(supps, col_of_t<2,int>(), q15_fupdate_t());
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, agg));
+    }
+
+    q15_fmax_t max;
+    supps.for_each(max);
+
+    // supplier
+    tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+    rep_row_t sreprow(_psupplier_man->ts());
+    sreprow.set(_psupplier_desc->maxsize());
+    prsupp->_rep = &sreprow;
+
+    for (size_t i=0; i<max._top.size(); i++) {
+        char name[STRSIZE(25)];
+        if (_psupplier_man->s_index_probe(_pssm, prsupp,
+                                          max._top[i].first).is_error()) {
+            continue;
+        }
+        str_col_t<1,25>::get(*prsupp, name);
+        TRACE( TRACE_QUERY_RESULTS, "%d|%s|%.2f\n",
+               max._top[i].first, name, max._top[i].second);
+        if (presult) {
+            presult->new_row();
+            presult->add(max._top[i].first);
+            presult->add(max._top[i].second);
+        }
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q16 (fused)
+ *
+ * scan part     --> filter (brand,type,size) --> build P
+ * scan supplier --> filter (complaints) --> build S
+ * scan partsupp --> filter (not in S) --> probe P --> aggregate (P)
+ *
+ ********************************************************************/
+
+struct q16_fpart_t
+{
+    int _brand;
+    int _type;
+    int _size;
+};
+
+typedef fused_map_t<int,q16_fpart_t> q16_pmap_t;
+typedef fused_map_t<int,char>        q16_smap_t;
+typedef fused_map_t<q16_fpart_t,int> q16_gmap_t;
+
+// the first two syllables of P_TYPE, as in the iterator plan
+static inline int q16_type(const table_row_t& r)
+{
+    char type[STRSIZE(25)];
+    char* saveptr;
+    str_col_t<4,25>::get(r, type);
+    char* s1 = strtok_r(type, " ", &saveptr);
+    char* s2 = strtok_r(NULL, " ", &saveptr);
+    return (str_to_types1(s1)*10 + str_to_types2(s2));
+}
+
+struct q16_fpbuild_t
+{
+    q16_pmap_t&        _parts;
+    const q16_input_t& _in;
+    q16_fpbuild_t(q16_pmap_t& parts, const q16_input_t& in)
+        : _parts(parts), _in(in) { }
+    inline void operator()(const table_row_t& r) {
+        char brand[STRSIZE(10)];
+        str_col_t<3,10>::get(r, brand);
+        q16_fpart_t p;
+        p._brand = str_to_Brand(brand);
+        p._type = q16_type(r);
+        p._size = col_t<5,int>::get(r);
+        if ((p._brand == _in.p_brand) || (p._type == _in.p_type)) return;
+        for (int i=0; i<8; i++) {
+            if (_in.p_size[i] == p._size) {
+                _parts.get_or_insert(col_t<0,int>::get(r), p);
+                return;
+            }
+        }
+    }
+};
+
+// "Customer" followed by "Complaints"
+struct q16_fspred_t
+{
+    inline bool operator()(const table_row_t& r) const {
+        char comment[STRSIZE(101)];
+        str_col_t<6,101>::get(r, comment);
+        char* p1 = strstr(comment, "Customer");
+        char* p2 = strstr(comment, "Complaints");
+        return ((p1 != NULL) && (p2 != NULL) && (p2 > p1));
+    }
+};
+
+struct q16_fkey_t
+{
+    inline q16_fpart_t operator()(const table_row_t&,
+                                  const q16_fpart_t& p) const {
+        return (p);
+    }
+};
+
+struct q16_fcount_t
+{
+    inline int init() const { return (0); }
+    inline void operator()(int& count, const table_row_t&,
+                           const q16_fpart_t&) const {
+        count++;
+    }
+};
+
+struct q16_foutput_t
+{
+    tpch_result_t* _presult;
+    q16_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const q16_fpart_t& p, const int& count) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d|%d|%d\n",
+               p._brand, p._type, p._size, count);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(p._brand);
+            _presult->add(p._type);
+            _presult->add(p._size);
+            _presult->add(count);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q16(q16_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // part
+    q16_pmap_t parts;
+    {
+        tuple_guard<part_man_impl> prpart(_ppart_man);
+        rep_row_t preprow(_ppart_man->ts());
+        preprow.set(_ppart_desc->maxsize());
+        prpart->_rep = &preprow;
+
+        table_scan_iter_impl<part_t>* tmp_p_iter;
+        W_DO(_ppart_man->get_iter_for_file_scan(_pssm, tmp_p_iter));
+        guard< table_scan_iter_impl<part_t> > p_iter(tmp_p_iter);
+
+        q16_fpbuild_t build(parts, in);
+        W_DO(fused_scan(_pssm, tmp_p_iter, *prpart, build));
+    }
+
+    // supplier, the black list
+    q16_smap_t supps;
+    {
+        tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+        rep_row_t sreprow(_psupplier_man->ts());
+        sreprow.set(_psupplier_desc->maxsize());
+        prsupp->_rep = &sreprow;
+
+        table_scan_iter_impl<supplier_t>* tmp_s_iter;
+        W_DO(_psupplier_man->get_iter_for_file_scan(_pssm, tmp_s_iter));
+        guard< table_scan_iter_impl<supplier_t> > s_iter(tmp_s_iter);
+
+        typedef build_op<q16_smap_t,col_of_t<0,int>,mark_t> build_t;
+        build_t build(supps, col_of_t<0,int>(), mark_t());
+        filter_op<q16_fspred_t,build_t> filter(q16_fspred_t(), build);
+
+        W_DO(fused_scan(_pssm, tmp_s_iter, *prsupp, filter));
+    }
+
+    // partsupp
+    q16_gmap_t groups;
+    {
+        tuple_guard<partsupp_man_impl> prpartsupp(_ppartsupp_man);
+        rep_row_t psreprow(_ppartsupp_man->ts());
+        psreprow.set(_ppartsupp_desc->maxsize());
+        prpartsupp->_rep = &psreprow;
+
+        table_scan_iter_impl<partsupp_t>* tmp_ps_iter;
+        W_DO(_ppartsupp_man->get_iter_for_file_scan(_pssm, tmp_ps_iter));
+        guard< table_scan_iter_impl<partsupp_t> > ps_iter(tmp_ps_iter);
+
+        typedef aggregate_op<q16_gmap_t,q16_fkey_t,q16_fcount_t> agg_t;
+        agg_t agg(groups, q16_fkey_t(), q16_fcount_t());
+        typedef probe_op<q16_pmap_t,col_of_t<0,int>,agg_t> probe_t;
+        probe_t probe(parts, col_of_t<0,int>(), agg);
+        typedef in_map_t<q16_smap_t,col_of_t<1,int>,false> pred_t;
+        filter_op<pred_t,probe_t> filter(pred_t(supps, col_of_t<1,int>()),
+                                         probe);
+
+        W_DO(fused_scan(_pssm, tmp_ps_iter, *prpartsupp, filter));
+    }
+
+    q16_foutput_t output(presult);
+    groups.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q17 (fused)
+ *
+ * scan part     --> filter (brand,container) --> build P
+ * scan lineitem --> probe P --> quantity per part, and keep the line
+ * the price of the lines below 0.2 of the average quantity
+ *
+ ********************************************************************/
+
+struct q17_fqty_t
+{
+    double _sum;
+    int    _count;
+};
+
+struct q17_fline_t
+{
+    int    _partkey;
+    double _price;
+    double _qty;
+};
+
+typedef fused_map_t<int,q17_fqty_t> q17_pmap_t;
+
+struct q17_fppred_t
+{
+    int _brand;
+    int _container;
+    q17_fppred_t(const int brand, const int container)
+        : _brand(brand), _container(container) { }
+    inline bool operator()(const table_row_t& r) const {
+        char brand[STRSIZE(10)];
+        str_col_t<3,10>::get(r, brand);
+        if (str_to_Brand(brand) != _brand) return (false);
+        char container[STRSIZE(10)];
+        char* saveptr;
+        str_col_t<6,10>::get(r, container);
+        char* s1 = strtok_r(container, " ", &saveptr);
+        char* s2 = strtok_r(NULL, " ", &saveptr);
+        return ((str_to_containers1(s1)*10 +
+                 str_to_containers2(s2)) == _container);
+    }
+};
+
+struct q17_fzero_t
+{
+    inline q17_fqty_t operator()(const table_row_t&) const {
+        q17_fqty_t q;
+        q._sum = 0;
+        q._count = 0;
+        return (q);
+    }
+};
+
+struct q17_fcollect_t
+{
+    std::vector<q17_fline_t>& _lines;
+    q17_fcollect_t(std::vector<q17_fline_t>& lines) : _lines(lines) { }
+    inline void operator()(const table_row_t& r, q17_fqty_t& q) {
+        q17_fline_t l;
+        l._partkey = col_t<1,int>::get(r);
+        l._price = col_t<5,double>::get(r);
+        l._qty = col_t<4,double>::get(r);
+        q._sum += l._qty;
+        q._count++;
+        _lines.push_back(l);
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q17(q17_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // part
+    q17_pmap_t parts;
+    {
+        tuple_guard<part_man_impl> prpart(_ppart_man);
+        rep_row_t preprow(_ppart_man->ts());
+        preprow.set(_ppart_desc->maxsize());
+        prpart->_rep = &preprow;
+
+        table_scan_iter_impl<part_t>* tmp_p_iter;
+        W_DO(_ppart_man->get_iter_for_file_scan(_pssm, tmp_p_iter));
+        guard< table_scan_iter_impl<part_t> > p_iter(tmp_p_iter);
+
+        typedef build_op<q17_pmap_t,col_of_t<0,int>,q17_fzero_t> build_t;
+        build_t build(parts, col_of_t<0,int>(), q17_fzero_t());
+        filter_op<q17_fppred_t,build_t>
+            filter(q17_fppred_t(in.p_brand, in.p_container), build);
+
+        W_DO(fused_scan(_pssm, tmp_p_iter, *prpart, filter));
+    }
+
+    // lineitem
+    std::vector<q17_fline_t> lines;
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t areprow(_plineitem_man->ts());
+        areprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &areprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        q17_fcollect_t collect(lines);
+        probe_op<q17_pmap_t,col_of_t<1,int>,q17_fcollect_t>
+            probe(parts, col_of_t<1,int>(), collect);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, probe));
+    }
+
+    double sum = 0;
+    for (size_t i=0; i<lines.size(); i++) {
+        q17_fqty_t* q = parts.find(lines[i]._partkey);
+        if (lines[i]._qty < q->_sum / q->_count * 0.2) {
+            sum += lines[i]._price;
+        }
+    }
+
+    TRACE( TRACE_QUERY_RESULTS, "%.2f\n", sum);
+    if (presult) {
+        presult->new_row();
+        presult->add(sum);
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q18 (fused)
+ *
+ * scan lineitem --> aggregate (orderkey) quantity
+ * scan orders   --> probe (the large orders) --> probe customer
+ *
+ ********************************************************************/
+
+typedef fused_map_t<int,double> q18_omap_t;
+
+struct q18_fupdate_t
+{
+    inline double init() const { return (0); }
+    inline void operator()(double& qty, const table_row_t& r) const {
+        qty += col_t<4,double>::get(r);
+    }
+};
+
+struct q18_flarge_t
+{
+    q18_omap_t& _large;
+    int         _quantity;
+    q18_flarge_t(q18_omap_t& large, const int quantity)
+        : _large(large), _quantity(quantity) { }
+    void operator()(const int& orderkey, const double& qty) {
+        if (qty > _quantity) _large.get_or_insert(orderkey, qty);
+    }
+};
+
+struct q18_forder_t
+{
+    int    _orderkey;
+    int    _custkey;
+    int    _orderdate;
+    double _totalprice;
+    double _qty;
+};
+
+struct q18_fcollect_t
+{
+    std::vector<q18_forder_t>& _orders;
+    q18_fcollect_t(std::vector<q18_forder_t>& orders) : _orders(orders) { }
+    inline void operator()(const table_row_t& r, double& qty) {
+        q18_forder_t o;
+        o._orderkey = col_t<0,int>::get(r);
+        o._custkey = col_t<1,int>::get(r);
+        o._orderdate = date_col_t<4>::get(r);
+        o._totalprice = col_t<3,double>::get(r);
+        o._qty = qty;
+        _orders.push_back(o);
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q18(q18_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // lineitem
+    q18_omap_t orders;
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t lreprow(_plineitem_man->ts());
+        lreprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &lreprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        aggregate_op<q18_omap_t,col_of_t<0,int>,q18_fupdate_t>
+            agg(orders, col_of_t<0,int>(), q18_fupdate_t());
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, agg));
+    }
+
+    q18_omap_t large;
+    q18_flarge_t select(large, in.l_quantity);
+    orders.for_each(select);
+
+    // orders
+    std::vector<q18_forder_t> result;
+    {
+        tuple_guard<orders_man_impl> prorders(_porders_man);
+        rep_row_t oreprow(_porders_man->ts());
+        oreprow.set(_porders_desc->maxsize());
+        prorders->_rep = &oreprow;
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        q18_fcollect_t collect(result);
+        probe_op<q18_omap_t,col_of_t<0,int>,q18_fcollect_t>
+            probe(large, col_of_t<0,int>(), collect);
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorders, probe));
+    }
+
+    // customer
+    tuple_guard<customer_man_impl> prcustomer(_pcustomer_man);
+    rep_row_t creprow(_pcustomer_man->ts());
+    creprow.set(_pcustomer_desc->maxsize());
+    prcustomer->_rep = &creprow;
+
+    for (size_t i=0; i<result.size(); i++) {
+        char name[STRSIZE(25)];
+        if (_pcustomer_man->c_index_probe(_pssm, prcustomer,
+                                          result[i]._custkey).is_error()) {
+            continue;
+        }
+        str_col_t<1,25>::get(*prcustomer, name);
+        TRACE( TRACE_QUERY_RESULTS, "%s|%d|%d|%.2f|%.2f\n",
+               name, result[i]._custkey, result[i]._orderkey,
+               result[i]._totalprice, result[i]._qty);
+        if (presult) {
+            presult->new_row();
+            presult->add(result[i]._custkey);
+            presult->add(result[i]._orderkey);
+            presult->add(date_to_timet(result[i]._orderdate));
+            presult->add(result[i]._totalprice);
+            presult->add(result[i]._qty);
+        }
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q19 (fused)
+ *
+ * scan part     --> build P (which of the three brands)
+ * scan lineitem --> filter (shipmode,shipinstruct) --> probe P
+ *               --> filter (quantity) --> sum
+ *
+ ********************************************************************/
+
+typedef fused_map_t<int,int> q19_pmap_t;
+
+struct q19_fpbuild_t
+{
+    q19_pmap_t&        _parts;
+    const q19_input_t& _in;
+    q19_fpbuild_t(q19_pmap_t& parts, const q19_input_t& in)
+        : _parts(parts), _in(in) { }
+    inline void operator()(const table_row_t& r) {
+        char b[STRSIZE(10)];
+        char c[STRSIZE(10)];
+        str_col_t<3,10>::get(r, b);
+        str_col_t<6,10>::get(r, c);
+        int brand = str_to_Brand(b);
+        int size = col_t<5,int>::get(r);
+        int which = 0;
+        if ((brand == _in.p_brand[0]) &&
+            ((strcmp(c, "SM CASE") == 0) || (strcmp(c, "SM BOX") == 0) ||
+             (strcmp(c, "SM PACK") == 0) || (strcmp(c, "SM PKG") == 0)) &&
+            (size > 1) && (size < 5)) {
+            which = 1;
+        } else if ((brand == _in.p_brand[1]) &&
+                   ((strcmp(c, "MED BAG") == 0) ||
+                    (strcmp(c, "MED BOX") == 0) ||
+                    (strcmp(c, "MED PKG") == 0) ||
+                    (strcmp(c, "MED PACK") == 0)) &&
+                   (size > 1) && (size < 10)) {
+            which = 2;
+        } else if ((brand == _in.p_brand[2]) &&
+                   ((strcmp(c, "LG CASE") == 0) ||
+                    (strcmp(c, "LG BOX") == 0) ||
+                    (strcmp(c, "LG PACK") == 0) ||
+                    (strcmp(c, "LG PKG") == 0)) &&
+                   (size > 1) && (size < 15)) {
+            which = 3;
+        }
+        if (which) _parts.get_or_insert(col_t<0,int>::get(r), which);
+    }
+};
+
+struct q19_flpred_t
+{
+    inline bool operator()(const table_row_t& r) const {
+        char mode[STRSIZE(10)];
+        str_col_t<14,10>::get(r, mode);
+        if ((strcmp(mode, "AIR") != 0) && (strcmp(mode, "AIR REG") != 0)) {
+            return (false);
+        }
+        char instruct[STRSIZE(25)];
+        str_col_t<13,25>::get(r, instruct);
+        return (strcmp(instruct, "DELIVER IN PERSON") == 0);
+    }
+};
+
+struct q19_frevenue_t
+{
+    const q19_input_t& _in;
+    double             _revenue;
+    q19_frevenue_t(const q19_input_t& in) : _in(in), _revenue(0) { }
+    inline void operator()(const table_row_t& r, int& which) {
+        double qty = col_t<4,double>::get(r);
+        if ((qty >= _in.l_quantity[which-1]) &&
+            (qty <= _in.l_quantity[which-1] + 10)) {
+            _revenue += col_t<5,double>::get(r) * (1-col_t<6,double>::get(r));
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q19(q19_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // part
+    q19_pmap_t parts;
+    {
+        tuple_guard<part_man_impl> prpart(_ppart_man);
+        rep_row_t preprow(_ppart_man->ts());
+        preprow.set(_ppart_desc->maxsize());
+        prpart->_rep = &preprow;
+
+        table_scan_iter_impl<part_t>* tmp_p_iter;
+        W_DO(_ppart_man->get_iter_for_file_scan(_pssm, tmp_p_iter));
+        guard< table_scan_iter_impl<part_t> > p_iter(tmp_p_iter);
+
+        q19_fpbuild_t build(parts, in);
+        W_DO(fused_scan(_pssm, tmp_p_iter, *prpart, build));
+    }
+
+    // lineitem
+    q19_frevenue_t revenue(in);
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t lreprow(_plineitem_man->ts());
+        lreprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &lreprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        typedef probe_op<q19_pmap_t,col_of_t<1,int>,q19_frevenue_t> probe_t;
+        probe_t probe(parts, col_of_t<1,int>(), revenue);
+        filter_op<q19_flpred_t,probe_t> filter(q19_flpred_t(), probe);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, filter));
+    }
+
+    TRACE( TRACE_QUERY_RESULTS, "%.2f\n", revenue._revenue);
+    if (presult) {
+        presult->new_row();
+        presult->add(revenue._revenue);
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q20 (fused)
+ *
+ * scan part     --> filter (name) --> build P
+ * scan partsupp --> filter (in P) --> build PS
+ * index scan lineitem (shipdate) --> probe PS --> sum quantity
+ * scan supplier --> filter (nation) --> filter (excess of PS) --> output
+ *
+ ********************************************************************/
+
+struct q20_fpskey_t
+{
+    int _partkey;
+    int _suppkey;
+};
+
+struct q20_fqty_t
+{
+    int    _avail;
+    double _sum;
+};
+
+typedef fused_map_t<int,char>              q20_kmap_t;
+typedef fused_map_t<q20_fpskey_t,q20_fqty_t> q20_psmap_t;
+
+// the first word of P_NAME
+struct q20_fppred_t
+{
+    const char* _color;
+    q20_fppred_t(const char* color) : _color(color) { }
+    inline bool operator()(const table_row_t& r) const {
+        char name[STRSIZE(55)];
+        char* saveptr;
+        str_col_t<1,55>::get(r, name);
+        char* s1 = strtok_r(name, " ", &saveptr);
+        return ((s1 != NULL) && (strcmp(s1, _color) == 0));
+    }
+};
+
+template <uint PIDX, uint SIDX>
+struct q20_fkeyof_t
+{
+    inline q20_fpskey_t operator()(const table_row_t& r) const {
+        q20_fpskey_t k;
+        k._partkey = col_t<PIDX,int>::get(r);
+        k._suppkey = col_t<SIDX,int>::get(r);
+        return (k);
+    }
+};
+
+struct q20_favail_t
+{
+    inline q20_fqty_t operator()(const table_row_t& r) const {
+        q20_fqty_t q;
+        q._avail = col_t<2,int>::get(r);
+        q._sum = 0;
+        return (q);
+    }
+};
+
+struct q20_fsum_t
+{
+    inline void operator()(const table_row_t& r, q20_fqty_t& q) {
+        q._sum += col_t<4,double>::get(r);
+    }
+};
+
+struct q20_fexcess_t
+{
+    q20_kmap_t& _supps;
+    q20_fexcess_t(q20_kmap_t& supps) : _supps(supps) { }
+    void operator()(const q20_fpskey_t& k, const q20_fqty_t& q) {
+        if (q._avail > 0.5 * q._sum) _supps.get_or_insert(k._suppkey, 1);
+    }
+};
+
+struct q20_foutput_t
+{
+    tpch_result_t* _presult;
+    q20_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    inline void operator()(const table_row_t& r) {
+        int suppkey = col_t<0,int>::get(r);
+        TRACE( TRACE_QUERY_RESULTS, "%d\n", suppkey);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(suppkey);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q20(q20_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    char p_name[55];
+    pname_to_str(in.p_color, p_name);
+
+    // part
+    q20_kmap_t parts;
+    {
+        tuple_guard<part_man_impl> prpart(_ppart_man);
+        rep_row_t preprow(_ppart_man->ts());
+        preprow.set(_ppart_desc->maxsize());
+        prpart->_rep = &preprow;
+
+        table_scan_iter_impl<part_t>* tmp_p_iter;
+        W_DO(_ppart_man->get_iter_for_file_scan(_pssm, tmp_p_iter));
+        guard< table_scan_iter_impl<part_t> > p_iter(tmp_p_iter);
+
+        typedef build_op<q20_kmap_t,col_of_t<0,int>,mark_t> build_t;
+        build_t build(parts, col_of_t<0,int>(), mark_t());
+        filter_op<q20_fppred_t,build_t> filter(q20_fppred_t(p_name), build);
+
+        W_DO(fused_scan(_pssm, tmp_p_iter, *prpart, filter));
+    }
+
+    // partsupp
+    q20_psmap_t partsupps;
+    {
+        tuple_guard<partsupp_man_impl> prpartsupp(_ppartsupp_man);
+        rep_row_t psreprow(_ppartsupp_man->ts());
+        psreprow.set(_ppartsupp_desc->maxsize());
+        prpartsupp->_rep = &psreprow;
+
+        table_scan_iter_impl<partsupp_t>* tmp_ps_iter;
+        W_DO(_ppartsupp_man->get_iter_for_file_scan(_pssm, tmp_ps_iter));
+        guard< table_scan_iter_impl<partsupp_t> > ps_iter(tmp_ps_iter);
+
+        typedef build_op<q20_psmap_t,q20_fkeyof_t<0,1>,q20_favail_t> build_t;
+        build_t build(partsupps, q20_fkeyof_t<0,1>(), q20_favail_t());
+        typedef in_map_t<q20_kmap_t,col_of_t<0,int>,true> pred_t;
+        filter_op<pred_t,build_t> filter(pred_t(parts, col_of_t<0,int>()),
+                                         build);
+
+        W_DO(fused_scan(_pssm, tmp_ps_iter, *prpartsupp, filter));
+    }
+
+    // lineitem, same range as the iterator plan
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t lreprow(_plineitem_man->ts());
+        lreprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &lreprow;
+
+        rep_row_t lowrep(_plineitem_man->ts());
+        rep_row_t highrep(_plineitem_man->ts());
+        lowrep.set(_plineitem_desc->maxsize());
+        highrep.set(_plineitem_desc->maxsize());
+
+        struct tm date;
+        if (gmtime_r(&(in.l_shipdate), &date) == NULL) {
+            return RCOK;
+        }
+        date.tm_year ++;
+        time_t last_shipdate = mktime(&date);
+
+        index_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->l_get_range_iter_by_index(_pssm, tmp_l_iter,
+                                                       prlineitem, lowrep,
+                                                       highrep, in.l_shipdate,
+                                                       last_shipdate));
+        guard< index_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        q20_fsum_t sum;
+        probe_op<q20_psmap_t,q20_fkeyof_t<1,2>,q20_fsum_t>
+            probe(partsupps, q20_fkeyof_t<1,2>(), sum);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, probe));
+    }
+
+    q20_kmap_t supps;
+    q20_fexcess_t excess(supps);
+    partsupps.for_each(excess);
+
+    // supplier
+    tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+    rep_row_t sreprow(_psupplier_man->ts());
+    sreprow.set(_psupplier_desc->maxsize());
+    prsupp->_rep = &sreprow;
+
+    table_scan_iter_impl<supplier_t>* tmp_s_iter;
+    W_DO(_psupplier_man->get_iter_for_file_scan(_pssm, tmp_s_iter));
+    guard< table_scan_iter_impl<supplier_t> > s_iter(tmp_s_iter);
+
+    q20_foutput_t output(presult);
+    typedef in_map_t<q20_kmap_t,col_of_t<0,int>,true> pred_t;
+    typedef filter_op<pred_t,q20_foutput_t> excess_t;
+    excess_t in_excess(pred_t(supps, col_of_t<0,int>()), output);
+    filter_op<q7_fnpred_t,excess_t>
+        filter(q7_fnpred_t(in.n_name, in.n_name), in_excess);
+
+    W_DO(fused_scan(_pssm, tmp_s_iter, *prsupp, filter));
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q21 (fused)
+ *
+ * scan supplier --> filter (nation) --> build S
+ * scan orders   --> filter (status) --> build O
+ * scan lineitem --> probe O --> the suppliers of the order, and the
+ *                               late lines of the suppliers of S
+ * count the late lines of the orders with one late supplier
+ *
+ ********************************************************************/
+
+// The supplier of the lines (late lines) of an order, 0 for none yet and
+// -1 for more than one; the suppkeys start at 1
+struct q21_fstate_t
+{
+    int _supp;
+    int _late;
+};
+
+typedef fused_map_t<int,char>         q21_smap_t;
+typedef fused_map_t<int,q21_fstate_t> q21_omap_t;
+typedef fused_map_t<int,int>          q21_cmap_t;
+
+static inline void q21_set_supp(int& state, const int suppkey)
+{
+    if ((state != 0) && (state != suppkey)) state = -1;
+    else state = suppkey;
+}
+
+struct q21_fopred_t
+{
+    inline bool operator()(const table_row_t& r) const {
+        return (col_t<2,char>::get(r) == 'F');
+    }
+};
+
+struct q21_fnone_t
+{
+    inline q21_fstate_t operator()(const table_row_t&) const {
+        q21_fstate_t s;
+        s._supp = 0;
+        s._late = 0;
+        return (s);
+    }
+};
+
+struct q21_fline_t
+{
+    q21_smap_t&                        _supps;
+    std::vector< std::pair<int,int> >& _late;
+    q21_fline_t(q21_smap_t& supps, std::vector< std::pair<int,int> >& late)
+        : _supps(supps), _late(late) { }
+    inline void operator()(const table_row_t& r, q21_fstate_t& s) {
+        int suppkey = col_t<2,int>::get(r);
+        if ((date_col_t<11>::get(r) < date_col_t<12>::get(r)) &&
+            (_supps.find(suppkey) != NULL)) {
+            _late.push_back(std::pair<int,int>(suppkey,
+                                               col_t<0,int>::get(r)));
+            q21_set_supp(s._late, suppkey);
+        }
+        q21_set_supp(s._supp, suppkey);
+    }
+};
+
+struct q21_foutput_t
+{
+    tpch_result_t* _presult;
+    q21_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const int& suppkey, const int& numwait) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d\n", suppkey, numwait);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(suppkey);
+            _presult->add(numwait);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q21(q21_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // supplier
+    q21_smap_t supps;
+    {
+        tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
+        rep_row_t sreprow(_psupplier_man->ts());
+        sreprow.set(_psupplier_desc->maxsize());
+        prsupp->_rep = &sreprow;
+
+        table_scan_iter_impl<supplier_t>* tmp_s_iter;
+        W_DO(_psupplier_man->get_iter_for_file_scan(_pssm, tmp_s_iter));
+        guard< table_scan_iter_impl<supplier_t> > s_iter(tmp_s_iter);
+
+        typedef build_op<q21_smap_t,col_of_t<0,int>,mark_t> build_t;
+        build_t build(supps, col_of_t<0,int>(), mark_t());
+        filter_op<q7_fnpred_t,build_t>
+            filter(q7_fnpred_t(in.n_name, in.n_name), build);
+
+        W_DO(fused_scan(_pssm, tmp_s_iter, *prsupp, filter));
+    }
+
+    // orders
+    q21_omap_t orders;
+    {
+        tuple_guard<orders_man_impl> prorder(_porders_man);
+        rep_row_t o_areprow(_porders_man->ts());
+        o_areprow.set(_porders_desc->maxsize());
+        prorder->_rep = &o_areprow;
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        typedef build_op<q21_omap_t,col_of_t<0,int>,q21_fnone_t> build_t;
+        build_t build(orders, col_of_t<0,int>(), q21_fnone_t());
+        filter_op<q21_fopred_t,build_t> filter(q21_fopred_t(), build);
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorder, filter));
+    }
+
+    // lineitem
+    std::vector< std::pair<int,int> > late;
+    {
+        tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
+        rep_row_t areprow(_plineitem_man->ts());
+        areprow.set(_plineitem_desc->maxsize());
+        prlineitem->_rep = &areprow;
+
+        table_scan_iter_impl<lineitem_t>* tmp_l_iter;
+        W_DO(_plineitem_man->get_iter_for_file_scan(_pssm, tmp_l_iter));
+        guard< table_scan_iter_impl<lineitem_t> > l_iter(tmp_l_iter);
+
+        q21_fline_t line(supps, late);
+        probe_op<q21_omap_t,col_of_t<0,int>,q21_fline_t>
+            probe(orders, col_of_t<0,int>(), line);
+
+        W_DO(fused_scan(_pssm, tmp_l_iter, *prlineitem, probe));
+    }
+
+    q21_cmap_t numwait;
+    for (size_t i=0; i<late.size(); i++) {
+        q21_fstate_t* s = orders.find(late[i].second);
+        if ((s->_supp == -1) && (s->_late != -1)) {
+            (*numwait.get_or_insert(late[i].first, 0))++;
+        }
+    }
+
+    q21_foutput_t output(presult);
+    numwait.for_each(output);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ * TPC-H Q22 (fused)
+ *
+ * scan customer --> filter (cntrycode) --> build C, and the average balance
+ * scan orders   --> probe C --> mark
+ * group the marked customers above the average by cntrycode
+ *
+ ********************************************************************/
+
+struct q22_fcust_t
+{
+    double _acctbal;
+    int    _cntrycode;
+    int    _orders;
+};
+
+struct q22_fgroup_t
+{
+    int    _count;
+    double _acctbal;
+};
+
+typedef fused_map_t<int,q22_fcust_t>  q22_cmap_t;
+typedef fused_map_t<int,q22_fgroup_t> q22_gmap_t;
+
+struct q22_fcbuild_t
+{
+    q22_cmap_t&        _custs;
+    const q22_input_t& _in;
+    double             _sum;
+    q22_fcbuild_t(q22_cmap_t& custs, const q22_input_t& in)
+        : _custs(custs), _in(in), _sum(0) { }
+    inline void operator()(const table_row_t& r) {
+        // C_PHONE starts with the country code and a '-'
+        char phone[STRSIZE(15)];
+        str_col_t<4,15>::get(r, phone);
+        q22_fcust_t c;
+        c._cntrycode = atoi(phone);
+        for (int i=0; i<7; i++) {
+            if (_in.cntrycode[i] == c._cntrycode) {
+                c._acctbal = col_t<5,double>::get(r);
+                c._orders = 0;
+                _custs.get_or_insert(col_t<0,int>::get(r), c);
+                _sum += c._acctbal;
+                return;
+            }
+        }
+    }
+};
+
+struct q22_fmark_t
+{
+    inline void operator()(const table_row_t&, q22_fcust_t& c) {
+        c._orders = 1;
+    }
+};
+
+struct q22_fgroupby_t
+{
+    q22_gmap_t& _groups;
+    double      _avg;
+    q22_fgroupby_t(q22_gmap_t& groups, const double avg)
+        : _groups(groups), _avg(avg) { }
+    void operator()(const int&, const q22_fcust_t& c) {
+        if (!c._orders || (c._acctbal <= _avg)) return;
+        q22_fgroup_t none;
+        none._count = 0;
+        none._acctbal = 0;
+        q22_fgroup_t* g = _groups.get_or_insert(c._cntrycode, none);
+        g->_count++;
+        g->_acctbal += c._acctbal;
+    }
+};
+
+struct q22_foutput_t
+{
+    tpch_result_t* _presult;
+    q22_foutput_t(tpch_result_t* presult) : _presult(presult) { }
+    void operator()(const int& cntrycode, const q22_fgroup_t& g) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d|%.2f\n",
+               cntrycode, g._count, g._acctbal);
+        if (_presult) {
+            _presult->new_row();
+            _presult->add(cntrycode);
+            _presult->add(g._count);
+            _presult->add(g._acctbal);
+        }
+    }
+};
+
+
+w_rc_t ShoreTPCHEnv::_fused_q22(q22_input_t& in, tpch_result_t* presult)
+{
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // customer
+    q22_cmap_t custs;
+    q22_fcbuild_t build(custs, in);
+    {
+        tuple_guard<customer_man_impl> prcustomer(_pcustomer_man);
+        rep_row_t areprow(_pcustomer_man->ts());
+        areprow.set(_pcustomer_desc->maxsize());
+        prcustomer->_rep = &areprow;
+
+        table_scan_iter_impl<customer_t>* tmp_c_iter;
+        W_DO(_pcustomer_man->get_iter_for_file_scan(_pssm, tmp_c_iter));
+        guard< table_scan_iter_impl<customer_t> > c_iter(tmp_c_iter);
+
+        W_DO(fused_scan(_pssm, tmp_c_iter, *prcustomer, build));
+    }
+    if (custs.size() == 0) {
+        return (RCOK);
+    }
+
+    // orders
+    {
+        tuple_guard<orders_man_impl> prorders(_porders_man);
+        rep_row_t aoreprow(_porders_man->ts());
+        aoreprow.set(_porders_desc->maxsize());
+        prorders->_rep = &aoreprow;
+
+        table_scan_iter_impl<orders_t>* tmp_o_iter;
+        W_DO(_porders_man->get_iter_for_file_scan(_pssm, tmp_o_iter));
+        guard< table_scan_iter_impl<orders_t> > o_iter(tmp_o_iter);
+
+        q22_fmark_t mark;
+        probe_op<q22_cmap_t,col_of_t<1,int>,q22_fmark_t>
+            probe(custs, col_of_t<1,int>(), mark);
+
+        W_DO(fused_scan(_pssm, tmp_o_iter, *prorders, probe));
+    }
+
+    q22_gmap_t groups;
+    q22_fgroupby_t group(groups, build._sum / custs.size());
+    custs.for_each(group);
+
+    q22_foutput_t output(presult);
+    groups.for_each(output);
+    return (RCOK);
+}
+
+EXIT_NAMESPACE(tpch);
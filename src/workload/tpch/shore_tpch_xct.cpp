@@ -33,6 +33,7 @@
 #include "workload/tpch/tpch_random.h"
 #include "workload/tpch/tpch_struct.h"
 #include "workload/tpch/tpch_util.h"
+#include "workload/tpch/tpch_fused.h"
 
 #include <vector>
 #include <map>
@@ -403,7 +404,7 @@ w_rc_t ShoreTPCHEnv::_gen_one_cust_based(const int id, rep_row_t& areprow)
 	pror->set_value(1, (int)ao.custkey);
 	pror->set_value(2, ao.orderstatus);
 	pror->set_value(3, (double)ao.totalprice);
-	pror->set_value(4, ao.odate);
+	pror->set_date_value(4, str_to_date(ao.odate));
 	pror->set_value(5, ao.opriority);
 	pror->set_value(6, ao.clerk);
 	pror->set_value(7, (int)ao.spriority);
@@ -434,9 +435,9 @@ w_rc_t ShoreTPCHEnv::_gen_one_cust_based(const int id, rep_row_t& areprow)
 	    prli->set_value(7, (double)ao.l[j].tax);
 	    prli->set_value(8, ao.l[j].rflag);
 	    prli->set_value(9, ao.l[j].lstatus);
-	    prli->set_value(10, ao.l[j].cdate);
-	    prli->set_value(11, ao.l[j].sdate);
-	    prli->set_value(12, ao.l[j].rdate);
+	    prli->set_date_value(10, str_to_date(ao.l[j].cdate));
+	    prli->set_date_value(11, str_to_date(ao.l[j].sdate));
+	    prli->set_date_value(12, str_to_date(ao.l[j].rdate));
 	    prli->set_value(13, ao.l[j].shipinstruct);
 	    prli->set_value(14, ao.l[j].shipmode);
 	    prli->set_value(15, ao.l[j].comment);
@@ -785,6 +786,41 @@ DEFINE_TRX(ShoreTPCHEnv,qregion);
 DEFINE_TRX(ShoreTPCHEnv,qcustomer);
 
 
+
+/******************************************************************** 
+ *
+ *  @fn:    _run_query
+ *
+ *  @brief: Runs the iterator or the fused plan of a query, as set by
+ *          tpch-engine, or both of them and compares their results
+ *
+ ********************************************************************/
+
+template <class Input>
+w_rc_t ShoreTPCHEnv::_run_query(const char* qname, Input& in,
+                                w_rc_t (ShoreTPCHEnv::*piter)(Input&, tpch_result_t*),
+                                w_rc_t (ShoreTPCHEnv::*pfused)(Input&, tpch_result_t*))
+{
+    switch (_query_engine) {
+    case (TPCH_ENGINE_ITER):
+        return ((this->*piter)(in, NULL));
+    case (TPCH_ENGINE_FUSED):
+        return ((this->*pfused)(in, NULL));
+    default:
+        {
+            tpch_result_t iter_res;
+            tpch_result_t fused_res;
+            W_DO((this->*piter)(in, &iter_res));
+            W_DO((this->*pfused)(in, &fused_res));
+            if (!tpch_result_t::check(qname, iter_res, fused_res)) {
+                atomic_inc_32(&_query_mismatches);
+            }
+        }
+    }
+    return (RCOK);
+}
+
+
 // uncomment the line below if want to dump (part of) the trx results
 //#define PRINT_TRX_RESULTS
 
@@ -894,7 +930,7 @@ public:
 class q1_group_by_value_t {
 public:
     int sum_qty;
-    int sum_base_price;
+    double sum_base_price;
     decimal sum_disc_price;
     decimal sum_charge;
     decimal sum_discount;
@@ -937,7 +973,7 @@ struct q1_output_ele_t
     char l_returnflag;
     char l_linestatus;
     int sum_qty;
-    int sum_base_price;
+    double sum_base_price;
     decimal sum_disc_price;
     decimal sum_charge;
     decimal avg_qty;
@@ -948,6 +984,12 @@ struct q1_output_ele_t
 
 
 w_rc_t ShoreTPCHEnv::xct_q1(const int /* xct_id */, q1_input_t& pq1in)
+{
+    return (_run_query("Q1", pq1in, &ShoreTPCHEnv::_iter_q1,
+                       &ShoreTPCHEnv::_fused_q1));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q1(q1_input_t& pq1in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -1025,9 +1067,9 @@ w_rc_t ShoreTPCHEnv::xct_q1(const int /* xct_id */, q1_input_t& pq1in)
 	prlineitem->get_value(7, aline.L_TAX);
 	prlineitem->get_value(8, aline.L_RETURNFLAG);
 	prlineitem->get_value(9, aline.L_LINESTATUS);
-	prlineitem->get_value(10, aline.L_SHIPDATE, 15);
 	
-	time_t the_shipdate = str_to_timet(aline.L_SHIPDATE);
+	time_t the_shipdate;
+	prlineitem->get_value(10, the_shipdate);
 	
 	if (the_shipdate <= pq1in.l_shipdate) {
 	    q1_group_by_key_t key(aline.L_RETURNFLAG, aline.L_LINESTATUS);
@@ -1066,7 +1108,22 @@ w_rc_t ShoreTPCHEnv::xct_q1(const int /* xct_id */, q1_input_t& pq1in)
 	q1_output_ele.count_order = (*it).second.count;
 	q1_output.push_back(q1_output_ele);
 	
-	TRACE( TRACE_QUERY_RESULTS, "%d|%d|%d|%d|%.2f|%.2f|%.2f|%.2f|%.2f|%d\n",
+	if (presult) {
+	    const q1_group_by_value_t& v = (*it).second;
+	    presult->new_row();
+	    presult->add(q1_output_ele.l_returnflag);
+	    presult->add(q1_output_ele.l_linestatus);
+	    presult->add(v.sum_qty);
+	    presult->add(v.sum_base_price);
+	    presult->add(v.sum_disc_price.to_double());
+	    presult->add(v.sum_charge.to_double());
+	    presult->add((double)v.sum_qty / v.count);
+	    presult->add(v.sum_base_price / v.count);
+	    presult->add(v.sum_discount.to_double() / v.count);
+	    presult->add(v.count);
+	}
+
+	TRACE( TRACE_QUERY_RESULTS, "%d|%d|%d|%.2f|%.2f|%.2f|%.2f|%.2f|%.2f|%d\n",
 	       q1_output_ele.l_returnflag,
 	       q1_output_ele.l_linestatus,
 	       q1_output_ele.sum_qty,
@@ -1092,6 +1149,12 @@ w_rc_t ShoreTPCHEnv::xct_q1(const int /* xct_id */, q1_input_t& pq1in)
  ********************************************************************/
 
 w_rc_t ShoreTPCHEnv::xct_q2(const int /* xct_id */, q2_input_t& q2in)
+{
+    return (_run_query("Q2", q2in, &ShoreTPCHEnv::_iter_q2,
+                       &ShoreTPCHEnv::_fused_q2));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q2(q2_input_t& q2in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -1099,7 +1162,7 @@ w_rc_t ShoreTPCHEnv::xct_q2(const int /* xct_id */, q2_input_t& q2in)
     assert (_loaded);
 
     //table scan part    
-    map<int, pair< decimal, vector<int>* > > minlist;
+    map<int, pair< double, vector<int>* > > minlist;
 
     tuple_guard<part_man_impl> prpart(_ppart_man);
     
@@ -1132,9 +1195,9 @@ w_rc_t ShoreTPCHEnv::xct_q2(const int /* xct_id */, q2_input_t& q2in)
 	if( size == q2in.p_size && strstr(apart.P_TYPE, types3) != NULL){
 	    vector<int>* v = new vector<int>();
 	    minlist.insert(pair<int,
-			   pair< decimal,vector<int>* > >(apart.P_PARTKEY,
-							  pair<decimal,
-							  vector<int>* >(-1, v)));
+			   pair< double,vector<int>* > >(apart.P_PARTKEY,
+							 pair<double,
+							 vector<int>* >(-1, v)));
 	}
 	W_DO(p_iter->next(_pssm, eof, *prpart));
     }
@@ -1221,26 +1284,40 @@ w_rc_t ShoreTPCHEnv::xct_q2(const int /* xct_id */, q2_input_t& q2in)
     while(!eof){
 	prpartsupp->get_value(0, apartsupp.PS_PARTKEY);
 	prpartsupp->get_value(1, apartsupp.PS_SUPPKEY);
-	prpartsupp->get_value(3, apartsupp.PS_SUPPLYCOST);
+	double supplycost;
+	prpartsupp->get_value(3, supplycost);
 	
-	map<int, pair< decimal, vector<int>* > >::iterator pit =  minlist.find
+	map<int, pair< double, vector<int>* > >::iterator pit =  minlist.find
 	    (apartsupp.PS_PARTKEY);	
 	map<int,bool>::iterator sit = suppK.find(apartsupp.PS_SUPPKEY);
 	
 	if( pit != minlist.end() && sit != suppK.end() ){		
-	    if( pit->second.first > apartsupp.PS_SUPPLYCOST ||
+	    // a new minimum drops the suppliers of the previous one
+	    if( pit->second.first > supplycost ||
 		pit->second.first == -1){
-		minlist.insert(pair<int, pair< decimal, vector<int>* > >
-			       (apartsupp.PS_PARTKEY,pair< decimal, vector<int>* >
-				(apartsupp.PS_SUPPLYCOST, new vector<int>()) ));
+		pit->second.first = supplycost;
+		pit->second.second->clear();
 	    }
-	    //problem with decimal datatype
-	    if( pit->second.first == apartsupp.PS_SUPPLYCOST){ 		    
+	    if( pit->second.first == supplycost){ 		    
 		pit->second.second->push_back(apartsupp.PS_SUPPKEY);
 	    }
 	}
 	W_DO(ps_iter->next(_pssm, eof, *prpartsupp));
     }
+
+    map<int, pair< double, vector<int>* > >::iterator it;
+    for (it = minlist.begin(); it != minlist.end(); ++it) {
+	vector<int>* v = it->second.second;
+	if (presult) {
+	    for (uint i=0; i<v->size(); i++) {
+		presult->new_row();
+		presult->add(it->first);
+		presult->add((*v)[i]);
+		presult->add(it->second.first);
+	    }
+	}
+	delete (v);
+    }
         
     return RCOK;
 }
@@ -1316,6 +1393,12 @@ public:
 };
 
 w_rc_t ShoreTPCHEnv::xct_q3(const int /* xct_id */, q3_input_t&  q3in)
+{
+    return (_run_query("Q3", q3in, &ShoreTPCHEnv::_iter_q3,
+                       &ShoreTPCHEnv::_fused_q3));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q3(q3_input_t& q3in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -1380,9 +1463,9 @@ w_rc_t ShoreTPCHEnv::xct_q3(const int /* xct_id */, q3_input_t&  q3in)
 	c++;
 	prorder->get_value(0, anorder.O_ORDERKEY);
 	prorder->get_value(1, anorder.O_CUSTKEY);
-	prorder->get_value(4, anorder.O_ORDERDATE, 15);
 	prorder->get_value(7, anorder.O_SHIPPRIORITY);	
-	time_t the_date = str_to_timet(anorder.O_ORDERDATE);
+	time_t the_date;
+	prorder->get_value(4, the_date);
 	if(custkeys.find(anorder.O_CUSTKEY) != custkeys.end()
 	    && the_date < q3in.current_date) {		
 	    ordersdt.insert(pair<int,q3_order_needed_data>
@@ -1415,10 +1498,10 @@ w_rc_t ShoreTPCHEnv::xct_q3(const int /* xct_id */, q3_input_t&  q3in)
     
     while (!eof) {
 	prlineitem->get_value(0, aline.L_ORDERKEY);
-	prlineitem->get_value(10, aline.L_SHIPDATE, 15);
 	prlineitem->get_value(5, aline.L_EXTENDEDPRICE);
 	prlineitem->get_value(6, aline.L_DISCOUNT);	
-	time_t the_shipdate = str_to_timet(aline.L_SHIPDATE);	
+	time_t the_shipdate;
+	prlineitem->get_value(10, the_shipdate);
 	map<int, q3_order_needed_data>::iterator tmp =
 	    ordersdt.find(aline.L_ORDERKEY);
 	if(tmp != ordersdt.end() && the_shipdate > q3in.current_date ){
@@ -1428,15 +1511,27 @@ w_rc_t ShoreTPCHEnv::xct_q3(const int /* xct_id */, q3_input_t&  q3in)
 						 tmp->second.o_shippriority));
 	    double  sum = aline.L_EXTENDEDPRICE * (1-aline.L_DISCOUNT);
 	    if(tmp2 != shippingQ.end()){
-		sum += tmp2->second; 
+		tmp2->second += sum;
+	    } else {
+		shippingQ.insert(pair<q3_group_by_key_t, double >
+				 (q3_group_by_key_t(aline.L_ORDERKEY,
+						    tmp->second.o_orderdate,
+						    tmp->second.o_shippriority),sum));
 	    }
-	    shippingQ.insert(pair<q3_group_by_key_t, double >
-			     (q3_group_by_key_t(aline.L_ORDERKEY,
-						tmp->second.o_orderdate,
-						tmp->second.o_shippriority),sum));
 	}
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
     }
+
+    if (presult) {
+	map<q3_group_by_key_t, double, q3_group_by_comp>::iterator it;
+	for (it = shippingQ.begin(); it != shippingQ.end(); ++it) {
+	    presult->new_row();
+	    presult->add(it->first.l_orderkey);
+	    presult->add(date_key(it->first.o_orderdate));
+	    presult->add(it->first.o_shippriority);
+	    presult->add(it->second);
+	}
+    }
     
     return RCOK;
 }
@@ -1456,6 +1551,12 @@ struct ltstr {
 
 
 w_rc_t ShoreTPCHEnv::xct_q4(const int /* xct_id */, q4_input_t&  in)
+{
+    return (_run_query("Q4", in, &ShoreTPCHEnv::_iter_q4,
+                       &ShoreTPCHEnv::_fused_q4));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q4(q4_input_t& in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -1537,10 +1638,10 @@ w_rc_t ShoreTPCHEnv::xct_q4(const int /* xct_id */, q4_input_t&  in)
     
     while (!eof) {
 	prlineitem->get_value(0, aline.L_ORDERKEY);
-	prlineitem->get_value(11, aline.L_COMMITDATE, 15);
-	prlineitem->get_value(12, aline.L_RECEIPTDATE, 15);	
-	time_t the_commitdate = str_to_timet(aline.L_COMMITDATE);
-	time_t the_receiptdate = str_to_timet(aline.L_RECEIPTDATE);	
+	time_t the_commitdate;
+	prlineitem->get_value(11, the_commitdate);
+	time_t the_receiptdate;
+	prlineitem->get_value(12, the_receiptdate);
 	map<int,int>::iterator tmp;	
 	if((tmp = forder_prio.find(aline.L_ORDERKEY)) != forder_prio.end() &&
 	   the_commitdate < the_receiptdate){
@@ -1551,6 +1652,15 @@ w_rc_t ShoreTPCHEnv::xct_q4(const int /* xct_id */, q4_input_t&  in)
 	}
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
     }
+
+    if (presult) {
+	for (map<int,int>::iterator it = priority_count.begin();
+	     it != priority_count.end(); ++it) {
+	    presult->new_row();
+	    presult->add(it->first);
+	    presult->add(it->second);
+	}
+    }
            
     return RCOK;
 };// EOF: Q4
@@ -1564,6 +1674,12 @@ w_rc_t ShoreTPCHEnv::xct_q4(const int /* xct_id */, q4_input_t&  in)
  ********************************************************************/
 
 w_rc_t ShoreTPCHEnv::xct_q5(const int /* xct_id */, q5_input_t& q5in)
+{
+    return (_run_query("Q5", q5in, &ShoreTPCHEnv::_iter_q5,
+                       &ShoreTPCHEnv::_fused_q5));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q5(q5_input_t& q5in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -1666,8 +1782,8 @@ w_rc_t ShoreTPCHEnv::xct_q5(const int /* xct_id */, q5_input_t& q5in)
     while(!eof){
 	prorders->get_value(0, anorder.O_ORDERKEY);
 	prorders->get_value(1, anorder.O_CUSTKEY);
-	prorders->get_value(4, anorder.O_ORDERDATE, 15);
-	time_t orderT = str_to_timet(anorder.O_ORDERDATE);
+	time_t orderT;
+	prorders->get_value(4, orderT);
 	if( customer_nation.find(anorder.O_CUSTKEY) != customer_nation.end() &&
 	    (orderT >= q5in.o_orderdate && orderT < last_orderdate)) {
 	    ordersK_cust.insert(pair<int,int> (anorder.O_ORDERKEY,
@@ -1748,6 +1864,15 @@ w_rc_t ShoreTPCHEnv::xct_q5(const int /* xct_id */, q5_input_t& q5in)
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
     }
 
+    if (presult) {
+	for (map<int,double>::iterator it = nation_rev.begin();
+	     it != nation_rev.end(); ++it) {
+	    presult->new_row();
+	    presult->add(it->first);
+	    presult->add(it->second);
+	}
+    }
+
     return RCOK;
 }
 
@@ -1762,6 +1887,12 @@ w_rc_t ShoreTPCHEnv::xct_q5(const int /* xct_id */, q5_input_t& q5in)
 // l_extendedprice l_discount l_shipdate l_quantity
 
 w_rc_t ShoreTPCHEnv::xct_q6(const int /* xct_id */, q6_input_t& pq6in)
+{
+    return (_run_query("Q6", pq6in, &ShoreTPCHEnv::_iter_q6,
+                       &ShoreTPCHEnv::_fused_q6));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q6(q6_input_t& pq6in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -1820,7 +1951,6 @@ w_rc_t ShoreTPCHEnv::xct_q6(const int /* xct_id */, q6_input_t& pq6in)
 	prlineitem->get_value(4, aline.L_QUANTITY);
 	prlineitem->get_value(5, aline.L_EXTENDEDPRICE);
 	prlineitem->get_value(6, aline.L_DISCOUNT);
-	prlineitem->get_value(10, aline.L_SHIPDATE, 15);	
 	if ((aline.L_DISCOUNT > pq6in.l_discount - 0.01) &&
 	    (aline.L_DISCOUNT < pq6in.l_discount + 0.01) &&
 	    (aline.L_QUANTITY < pq6in.l_quantity)) {
@@ -1829,6 +1959,11 @@ w_rc_t ShoreTPCHEnv::xct_q6(const int /* xct_id */, q6_input_t& pq6in)
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
     }
 
+    if (presult) {
+	presult->new_row();
+	presult->add(q6_result);
+    }
+
     return RCOK;
 
 }; // EOF: Q6 
@@ -1889,6 +2024,12 @@ public:
 };
 
 w_rc_t ShoreTPCHEnv::xct_q7(const int /* xct_id */, q7_input_t&  q7in )
+{
+    return (_run_query("Q7", q7in, &ShoreTPCHEnv::_iter_q7,
+                       &ShoreTPCHEnv::_fused_q7));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q7(q7_input_t& q7in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -1999,18 +2140,6 @@ w_rc_t ShoreTPCHEnv::xct_q7(const int /* xct_id */, q7_input_t&  q7in )
 
     prlineitem->_rep = &alreprow;
 
-    struct tm start_shipdate;
-    start_shipdate.tm_year = 95;
-    start_shipdate.tm_mon = 0;
-    start_shipdate.tm_mday = 1;
-    time_t s_ship = mktime(&start_shipdate);
-    
-    struct tm end_shipdate;
-    end_shipdate.tm_year = 96;
-    end_shipdate.tm_mon = 11;
-    end_shipdate.tm_mday =31;
-    time_t e_ship = mktime(&end_shipdate);
-    
     guard< table_scan_iter_impl<lineitem_t> > l_iter;
     {
 	table_scan_iter_impl<lineitem_t>* tmp_l_iter;
@@ -2027,10 +2156,12 @@ w_rc_t ShoreTPCHEnv::xct_q7(const int /* xct_id */, q7_input_t&  q7in )
 	prlineitem->get_value(2, aline.L_SUPPKEY);
 	prlineitem->get_value(5, aline.L_EXTENDEDPRICE);
 	prlineitem->get_value(6, aline.L_DISCOUNT);
-	prlineitem->get_value(10, aline.L_SHIPDATE, 15);
 	    
-	time_t shipdate = str_to_timet(aline.L_SHIPDATE);
-	struct tm date = (*localtime(&shipdate));
+	// only the year of the date is needed, without localtime()
+	int shipdate;
+	prlineitem->get_date_value(10, shipdate);
+	struct tm date;
+	date.tm_year = date_year(shipdate) - 1900;
 	double price = aline.L_EXTENDEDPRICE*(1- aline.L_DISCOUNT);
 
 	map<int,int>:: iterator order = orderk_custk.find(aline.L_ORDERKEY);
@@ -2049,13 +2180,7 @@ w_rc_t ShoreTPCHEnv::xct_q7(const int /* xct_id */, q7_input_t&  q7in )
 							    cust->second,
 							    date.tm_year));
 		    if( it != vol_shipping.end()){
-			double c = it->second;
-			c +=  price;
-			vol_shipping.insert(pair<q7_group_by_key_t,
-					    double>
-					    (q7_group_by_key_t(supp->second,
-							       cust->second,
-							       date.tm_year), c));
+			it->second += price;
 		    } else {
 			vol_shipping.insert(pair<q7_group_by_key_t, double>
 					    (q7_group_by_key_t(supp->second,
@@ -2068,6 +2193,17 @@ w_rc_t ShoreTPCHEnv::xct_q7(const int /* xct_id */, q7_input_t&  q7in )
 	}
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
     }
+
+    if (presult) {
+	map<q7_group_by_key_t, double, q7_group_by_comp>::iterator it;
+	for (it = vol_shipping.begin(); it != vol_shipping.end(); ++it) {
+	    presult->new_row();
+	    presult->add(it->first.supp_nation);
+	    presult->add(it->first.cust_nation);
+	    presult->add(it->first.l_year + 1900);
+	    presult->add(it->second);
+	}
+    }
     
     return RCOK;
 }
@@ -2107,6 +2243,12 @@ struct q8_groupe_by_value_t{
 };
 
 w_rc_t ShoreTPCHEnv::xct_q8(const int /* xct_id */, q8_input_t&  q8in)
+{
+    return (_run_query("Q8", q8in, &ShoreTPCHEnv::_iter_q8,
+                       &ShoreTPCHEnv::_fused_q8));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q8(q8_input_t& q8in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -2229,10 +2371,8 @@ w_rc_t ShoreTPCHEnv::xct_q8(const int /* xct_id */, q8_input_t&  q8in)
     lowrep.set(_porders_desc->maxsize());
     highrep.set(_porders_desc->maxsize());
 
-    struct tm date1; date1.tm_year = 95; date1.tm_mon = 0; date1.tm_mday = 1;
-    struct tm date2; date2.tm_year = 96; date2.tm_mon = 11; date2.tm_mday = 31;
-    time_t t1 = mktime(&date1);
-    time_t t2 = mktime(&date2);
+    time_t t1 = date_to_timet(ymd_to_date(1995,1,1));
+    time_t t2 = date_to_timet(ymd_to_date(1996,12,31));
     
     guard<index_scan_iter_impl<orders_t> > o_iter;
     {
@@ -2249,9 +2389,10 @@ w_rc_t ShoreTPCHEnv::xct_q8(const int /* xct_id */, q8_input_t&  q8in)
     while(!eof){
 	prorders->get_value(0, anorder.O_ORDERKEY);
 	prorders->get_value(1, anorder.O_CUSTKEY);
-	prorders->get_value(4, anorder.O_ORDERDATE, 15);
-	time_t t = str_to_timet(anorder.O_ORDERDATE);
-	struct tm date = *(localtime(&t));
+	int odate;
+	prorders->get_date_value(4, odate);
+	struct tm date;
+	date.tm_year = date_year(odate) - 1900;
 	if( cust_k.find(anorder.O_CUSTKEY) != cust_k.end()) {
 	    orders_ky.insert(pair<int,int>(anorder.O_ORDERKEY, date.tm_year));
 	}
@@ -2328,23 +2469,26 @@ w_rc_t ShoreTPCHEnv::xct_q8(const int /* xct_id */, q8_input_t&  q8in)
     map<int,q8_groupe_by_value_t> mkt_share;
     map<int,q8_groupe_by_value_t>::iterator it;
     
-    for(int i = 0; i < all_nation.size(); i++){
+    for(uint i = 0; i < all_nation.size(); i++){
 	it = mkt_share.find(all_nation[i].o_year);
-	double a,b;
-	if (it != mkt_share.end()){
-	    a = it->second.a;
-	    b = it->second.b;
-	}else{
-	    a = 0;
-	    b =0;
+	if (it == mkt_share.end()){
+	    it = mkt_share.insert(pair<int,q8_groupe_by_value_t>
+				  (all_nation[i].o_year,
+				   q8_groupe_by_value_t(0, 0))).first;
+	}
+	map<int,int>::iterator sit = supp_nation.find(all_nation[i].s_key);
+	if( sit != supp_nation.end() && sit->second == q8in.n_name){
+	    it->second.a += all_nation[i].price;
 	}
-	if( supp_nation.find(all_nation[i].s_key)->second == q8in.n_name){
-	    a+=all_nation[i].price;
+	it->second.b += all_nation[i].price;
+    }
+
+    if (presult) {
+	for (it = mkt_share.begin(); it != mkt_share.end(); ++it) {
+	    presult->new_row();
+	    presult->add(it->first + 1900);
+	    presult->add(it->second.b > 0 ? it->second.a / it->second.b : 0);
 	}
-	b+=all_nation[i].price;
-	mkt_share.insert(pair<int,q8_groupe_by_value_t>(all_nation[i].o_year,
-							q8_groupe_by_value_t(a,
-									     b)));
     }
     
     return RCOK;
@@ -2383,6 +2527,12 @@ public:
 
 
 w_rc_t ShoreTPCHEnv::xct_q9(const int /* xct_id */, q9_input_t& q9in)
+{
+    return (_run_query("Q9", q9in, &ShoreTPCHEnv::_iter_q9,
+                       &ShoreTPCHEnv::_fused_q9));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q9(q9_input_t& q9in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -2472,16 +2622,17 @@ w_rc_t ShoreTPCHEnv::xct_q9(const int /* xct_id */, q9_input_t& q9in)
     W_DO(o_iter->next(_pssm, eof, *prorder));
 
     while(!eof){
-	prorder->get_value(1, anorder.O_ORDERKEY);
-	prorder->get_value(4, anorder.O_ORDERDATE,15);
-	time_t t = str_to_timet(anorder.O_ORDERDATE);
-	struct tm date = *localtime(&t);
+	prorder->get_value(0, anorder.O_ORDERKEY);
+	int odate;
+	prorder->get_date_value(4, odate);
+	struct tm date;
+	date.tm_year = date_year(odate) - 1900;
 	orderK_y.insert( pair<int,int> (anorder.O_ORDERKEY, date.tm_year));
 	W_DO(o_iter->next(_pssm, eof, *prorder));
     }
         
     //table scane lineitem
-    map <q9_group_by_key_t, decimal, q9_group_by_comp> profit_m;
+    map <q9_group_by_key_t, double, q9_group_by_comp> profit_m;
 
     tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
 
@@ -2505,7 +2656,6 @@ w_rc_t ShoreTPCHEnv::xct_q9(const int /* xct_id */, q9_input_t& q9in)
     }
     
     tpch_lineitem_tuple aline;
-    tpch_partsupp_tuple apartsupp;
     
     W_DO(l_iter->next(_pssm, eof, *prlineitem));
 	
@@ -2516,17 +2666,20 @@ w_rc_t ShoreTPCHEnv::xct_q9(const int /* xct_id */, q9_input_t& q9in)
 	prlineitem->get_value(4, aline.L_QUANTITY);
 	prlineitem->get_value(5, aline.L_EXTENDEDPRICE);
 	prlineitem->get_value(6, aline.L_DISCOUNT);
-	if((_ppartsupp_man->ps_index_probe(_pssm, prpartsupp, aline.L_PARTKEY,
-					   aline.L_SUPPKEY)).is_error()) {
-	    W_DO(l_iter->next(_pssm, eof, *prlineitem));
-	    continue;
-	}
-	prpartsupp->get_value(3, apartsupp.PS_SUPPLYCOST);
-	
-	decimal price = aline.L_EXTENDEDPRICE * (1 - aline.L_DISCOUNT) -
-	    apartsupp.PS_SUPPLYCOST* aline.L_QUANTITY;
 	
 	if( p_keys.find(aline.L_PARTKEY) != p_keys.end() ){		
+	    // only the lines of the selected parts probe partsupp
+	    if((_ppartsupp_man->ps_index_probe(_pssm, prpartsupp,
+					       aline.L_PARTKEY,
+					       aline.L_SUPPKEY)).is_error()) {
+		W_DO(l_iter->next(_pssm, eof, *prlineitem));
+		continue;
+	    }
+	    double supplycost;
+	    prpartsupp->get_value(3, supplycost);
+	    double price = aline.L_EXTENDEDPRICE * (1 - aline.L_DISCOUNT) -
+		supplycost * aline.L_QUANTITY;
+
 	    map<int,int>::iterator oit = orderK_y.find( aline.L_ORDERKEY);
 	    map<int,int>::iterator sit = suppK_nK.find( aline.L_SUPPKEY);
 	    
@@ -2537,17 +2690,27 @@ w_rc_t ShoreTPCHEnv::xct_q9(const int /* xct_id */, q9_input_t& q9in)
 	    
 	    int y = oit->second; 
 	    int nation_k = sit->second; 	    
-	    map <q9_group_by_key_t, decimal, q9_group_by_comp>::iterator it =
+	    map <q9_group_by_key_t, double, q9_group_by_comp>::iterator it =
 		profit_m.find(q9_group_by_key_t(nation_k, y));
-	    decimal c = price;
 	    if( it != profit_m.end()) {
-		c += it->second;
+		it->second += price;
+	    } else {
+		profit_m.insert(pair<q9_group_by_key_t, double>
+				(q9_group_by_key_t(nation_k, y), price));
 	    }
-	    profit_m.insert(pair<q9_group_by_key_t, decimal>
-			    (q9_group_by_key_t(nation_k, y) ,c) );
 	}
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
     }
+
+    if (presult) {
+	map <q9_group_by_key_t, double, q9_group_by_comp>::iterator it;
+	for (it = profit_m.begin(); it != profit_m.end(); ++it) {
+	    presult->new_row();
+	    presult->add(it->first.nation_k);
+	    presult->add(it->first.year + 1900);
+	    presult->add(it->second);
+	}
+    }
        
     return RCOK;
 }
@@ -2565,19 +2728,19 @@ class q10_group_by_key_t{
 public:
     
     int c_custkey;
-    char c_name[25];
+    char c_name[STRSIZE(25)];
     decimal c_acctbal;
-    char phone[15];
+    char phone[STRSIZE(15)];
     int n_key;
-    char c_address[40];
-    char c_comment[117];
+    char c_address[STRSIZE(40)];
+    char c_comment[STRSIZE(117)];
 
     q10_group_by_key_t
     (int k, char* name, decimal bal, char* phone, int n, char* add, char* cmt){
 	c_custkey = k;
 	strcpy(c_name, name);
 	c_acctbal = bal;
-	strcpy(phone, phone);
+	strcpy(this->phone, phone);
 	n_key = n;
 	strcpy(c_address, add);
 	strcpy(c_comment, cmt);
@@ -2598,7 +2761,13 @@ public:
 
 
 
-w_rc_t ShoreTPCHEnv::xct_q10(const int /* xct_id */, q10_input_t&  q10in)
+w_rc_t ShoreTPCHEnv::xct_q10(const int /* xct_id */, q10_input_t& q10in)
+{
+    return (_run_query("Q10", q10in, &ShoreTPCHEnv::_iter_q10,
+                       &ShoreTPCHEnv::_fused_q10));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q10(q10_input_t& q10in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -2641,8 +2810,8 @@ w_rc_t ShoreTPCHEnv::xct_q10(const int /* xct_id */, q10_input_t&  q10in)
     while(!eof){
 	prorder->get_value(0, anorder.O_ORDERKEY);
 	prorder->get_value(1, anorder.O_CUSTKEY);
-	prorder->get_value(4, anorder.O_ORDERDATE, 15);
-	time_t orderdate = str_to_timet(anorder.O_ORDERDATE);
+	time_t orderdate;
+	prorder->get_value(4, orderdate);
 	if(orderdate >= t1 && orderdate < t2){
 	    orders_price.insert(pair<int,double>(anorder.O_ORDERKEY, 0.0));
 	    map<int, vector<int>* >::iterator it =
@@ -2721,13 +2890,27 @@ w_rc_t ShoreTPCHEnv::xct_q10(const int /* xct_id */, q10_input_t&  q10in)
 	prcustomer->get_value(3, acust.C_NATIONKEY);
 	prcustomer->get_value(4, acust.C_PHONE, 15);
 	prcustomer->get_value(5, acust.C_ACCTBAL);
-	prcustomer->get_value(2, acust.C_COMMENT, 117);
+	prcustomer->get_value(7, acust.C_COMMENT, 117);
 	customer_rev[q10_group_by_key_t(cit->first, acust.C_NAME, acust.C_ACCTBAL,
 					acust.C_PHONE, acust.C_NATIONKEY,
 					acust.C_ADDRESS, acust.C_COMMENT)] = rev;
+	if (presult) {
+	    // the exact balance, decimal truncates it
+	    double acctbal;
+	    prcustomer->get_value(5, acctbal);
+	    presult->new_row();
+	    presult->add(cit->first);
+	    presult->add(rev);
+	    presult->add(acust.C_NATIONKEY);
+	    presult->add(acctbal);
+	}
 	cit++;
     }
 
+    for (cit = cust_ordersK.begin(); cit != cust_ordersK.end(); ++cit) {
+	delete cit->second;
+    }
+
     return RCOK;
 }
 
@@ -2740,6 +2923,12 @@ w_rc_t ShoreTPCHEnv::xct_q10(const int /* xct_id */, q10_input_t&  q10in)
  ********************************************************************/
 
 w_rc_t ShoreTPCHEnv::xct_q11(const int /* xct_id */, q11_input_t& q11in)
+{
+    return (_run_query("Q11", q11in, &ShoreTPCHEnv::_iter_q11,
+                       &ShoreTPCHEnv::_fused_q11));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q11(q11_input_t& q11in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -2778,8 +2967,8 @@ w_rc_t ShoreTPCHEnv::xct_q11(const int /* xct_id */, q11_input_t& q11in)
     }
     
     //table scan partsupp
-    map<int, decimal> partK_val;
-    decimal totalval = 0;
+    map<int, double> partK_val;
+    double totalval = 0;
 
     tuple_guard<partsupp_man_impl> prpartsupp(_ppartsupp_man);
 
@@ -2803,10 +2992,11 @@ w_rc_t ShoreTPCHEnv::xct_q11(const int /* xct_id */, q11_input_t& q11in)
 	prpartsupp->get_value(0, apartsupp.PS_PARTKEY);
 	prpartsupp->get_value(1, apartsupp.PS_SUPPKEY);
 	prpartsupp->get_value(2, apartsupp.PS_AVAILQTY);
-	prpartsupp->get_value(3, apartsupp.PS_SUPPLYCOST);
 	if( suppK.find(apartsupp.PS_SUPPKEY) != suppK.end() ){
-	    map<int,decimal>::iterator pit =partK_val.find(apartsupp.PS_PARTKEY);
-	    decimal c = apartsupp.PS_AVAILQTY * apartsupp.PS_SUPPLYCOST;
+	    map<int,double>::iterator pit =partK_val.find(apartsupp.PS_PARTKEY);
+	    double supplycost;
+	    prpartsupp->get_value(3, supplycost);
+	    double c = apartsupp.PS_AVAILQTY * supplycost;
 	    totalval += c;
 	    if( pit != partK_val.end()){
 		c += pit->second;
@@ -2816,6 +3006,18 @@ w_rc_t ShoreTPCHEnv::xct_q11(const int /* xct_id */, q11_input_t& q11in)
 	W_DO(ps_iter->next(_pssm, eof, *prpartsupp));
     }
 
+    // having value > total * fraction
+    if (presult) {
+	for (map<int,double>::iterator pit = partK_val.begin();
+	     pit != partK_val.end(); ++pit) {
+	    if (pit->second > totalval * q11in.fraction) {
+		presult->new_row();
+		presult->add(pit->first);
+		presult->add(pit->second);
+	    }
+	}
+    }
+
     return RCOK;
 }
 
@@ -2851,6 +3053,12 @@ w_rc_t ShoreTPCHEnv::xct_q11(const int /* xct_id */, q11_input_t& q11in)
 
 
 w_rc_t ShoreTPCHEnv::xct_q12(const int /* xct_id */, q12_input_t& q12in)
+{
+    return (_run_query("Q12", q12in, &ShoreTPCHEnv::_iter_q12,
+                       &ShoreTPCHEnv::_fused_q12));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q12(q12_input_t& q12in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -2903,13 +3111,13 @@ w_rc_t ShoreTPCHEnv::xct_q12(const int /* xct_id */, q12_input_t& q12in)
 
    while(!eof){
        prlineitem->get_value(0, aline.L_ORDERKEY);
-       prlineitem->get_value(10, aline.L_SHIPDATE, 15);
-       prlineitem->get_value(11, aline.L_COMMITDATE, 15);
-       prlineitem->get_value(12, aline.L_RECEIPTDATE, 15);
        prlineitem->get_value(14, aline.L_SHIPMODE, 10);
-       time_t shipdate = str_to_timet(aline.L_SHIPDATE);
-       time_t commitdate = str_to_timet(aline.L_COMMITDATE);	
-       time_t receiptdate = str_to_timet(aline.L_RECEIPTDATE);
+       time_t shipdate;
+       prlineitem->get_value(10, shipdate);
+       time_t commitdate;
+       prlineitem->get_value(11, commitdate);
+       time_t receiptdate;
+       prlineitem->get_value(12, receiptdate);
        int shipmode = str_to_shipmode(aline.L_SHIPMODE);
        if(shipmode == q12in.l_shipmode1 || shipmode == q12in.l_shipmode2) {
 	   if(commitdate < receiptdate && shipdate < commitdate) {
@@ -2963,6 +3171,16 @@ w_rc_t ShoreTPCHEnv::xct_q12(const int /* xct_id */, q12_input_t& q12in)
        }
    }
 
+   if (presult) {
+       for (map<int, pair<int,int> >::iterator it = shpmd_HLC_LLC.begin();
+	    it != shpmd_HLC_LLC.end(); ++it) {
+	   presult->new_row();
+	   presult->add(it->first);
+	   presult->add(it->second.first);
+	   presult->add(it->second.second);
+       }
+   }
+
    return RCOK;
 }// EOF: Q12
 
@@ -2974,7 +3192,13 @@ w_rc_t ShoreTPCHEnv::xct_q12(const int /* xct_id */, q12_input_t& q12in)
  *
  ********************************************************************/
 
-w_rc_t ShoreTPCHEnv::xct_q13(const int /* xct_id */, q13_input_t& /* in */)
+w_rc_t ShoreTPCHEnv::xct_q13(const int /* xct_id */, q13_input_t& in)
+{
+    return (_run_query("Q13", in, &ShoreTPCHEnv::_iter_q13,
+                       &ShoreTPCHEnv::_fused_q13));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q13(q13_input_t& /* in */, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -3072,6 +3296,15 @@ w_rc_t ShoreTPCHEnv::xct_q13(const int /* xct_id */, q13_input_t& /* in */)
 	}
     }
 
+    if (presult) {
+	for (map<int,int>::iterator iter = o_count_cust.begin();
+	     iter != o_count_cust.end(); ++iter) {
+	    presult->new_row();
+	    presult->add(iter->first);
+	    presult->add(iter->second);
+	}
+    }
+
     return RCOK;
 }// EOF: Q13
 
@@ -3084,6 +3317,12 @@ w_rc_t ShoreTPCHEnv::xct_q13(const int /* xct_id */, q13_input_t& /* in */)
  ********************************************************************/
 
 w_rc_t ShoreTPCHEnv::xct_q14(const int /* xct_id */, q14_input_t& q14in)
+{
+    return (_run_query("Q14", q14in, &ShoreTPCHEnv::_iter_q14,
+                       &ShoreTPCHEnv::_fused_q14));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q14(q14_input_t& q14in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -3184,6 +3423,16 @@ w_rc_t ShoreTPCHEnv::xct_q14(const int /* xct_id */, q14_input_t& q14in)
 	}
 	W_DO(p_iter->next(_pssm, eof, *prpart));
     }
+
+    for (map<int,vector<float>* >::iterator it = pKey_prices.begin();
+	 it != pKey_prices.end(); ++it) {
+	delete (it->second);
+    }
+
+    if (presult) {
+	presult->new_row();
+	presult->add(totalrevenue > 0 ? 100 * promorevenue / totalrevenue : 0);
+    }
     
     return RCOK;
 }// EOF: Q14
@@ -3204,13 +3453,19 @@ struct suppliercmp {
 
 
 w_rc_t ShoreTPCHEnv::xct_q15(const int /* xct_id */, q15_input_t& q15in)
+{
+    return (_run_query("Q15", q15in, &ShoreTPCHEnv::_iter_q15,
+                       &ShoreTPCHEnv::_fused_q15));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q15(q15_input_t& q15in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
 
-    map<int,float> stream_id;
+    map<int,double> stream_id;
 
     //phase 1 :create the view
     tuple_guard<lineitem_man_impl> prlineitem(_plineitem_man);
@@ -3257,10 +3512,10 @@ w_rc_t ShoreTPCHEnv::xct_q15(const int /* xct_id */, q15_input_t& q15in)
 	prlineitem->get_value(2, aline.L_SUPPKEY);
 	prlineitem->get_value(5, aline.L_EXTENDEDPRICE);
 	prlineitem->get_value(6, aline.L_DISCOUNT);
-	float theprice = aline.L_EXTENDEDPRICE *(1 - aline.L_DISCOUNT);
-	map<int, float>::iterator tmp =  stream_id.find(aline.L_SUPPKEY);
+	double theprice = aline.L_EXTENDEDPRICE *(1 - aline.L_DISCOUNT);
+	map<int, double>::iterator tmp =  stream_id.find(aline.L_SUPPKEY);
 	if(tmp != stream_id.end()){
-	    float s = tmp->second;
+	    double s = tmp->second;
 	    s += theprice;
 	    stream_id[ aline.L_SUPPKEY ] = s;
 	}else{	   
@@ -3269,24 +3524,29 @@ w_rc_t ShoreTPCHEnv::xct_q15(const int /* xct_id */, q15_input_t& q15in)
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
     }
 
-    float maxrev = stream_id.begin()->second;
-    for(map<int,float>::iterator iter = stream_id.begin();
+    if (stream_id.empty()) {
+	return RCOK;
+    }
+
+    double maxrev = stream_id.begin()->second;
+    for(map<int,double>::iterator iter = stream_id.begin();
 	iter != stream_id.end();
 	iter++) {
 	if( maxrev < iter->second ) {
 	    maxrev = iter->second;
 	}
     }
-    for(map<int,float>::iterator iter = stream_id.begin();
-	iter != stream_id.end();
-	iter++) {
+    for(map<int,double>::iterator iter = stream_id.begin();
+	iter != stream_id.end(); ) {
 	if(iter->second != maxrev) {
-	   stream_id.erase(iter);
+	   stream_id.erase(iter++);
+	} else {
+	   iter++;
 	}
     }
     
     //phase 2 joining with supply table: indexscan
-    map<tpch_supplier_tuple, int, suppliercmp> supprev;
+    map<tpch_supplier_tuple, double, suppliercmp> supprev;
 
     tuple_guard<supplier_man_impl> prsupp(_psupplier_man);
    
@@ -3295,15 +3555,24 @@ w_rc_t ShoreTPCHEnv::xct_q15(const int /* xct_id */, q15_input_t& q15in)
     
     prsupp->_rep = &sreprow;
     
-    for(map<int,float>::iterator iter = stream_id.begin();
+    for(map<int,double>::iterator iter = stream_id.begin();
 	iter != stream_id.end();
 	iter++){
-	_psupplier_man->s_index_probe(_pssm, prsupp, iter->first);
+	if((_psupplier_man->s_index_probe(_pssm, prsupp,
+					  iter->first)).is_error()) {
+	    continue;
+	}
 	tpch_supplier_tuple asupp;
+	asupp.S_SUPPKEY = iter->first;
 	prsupp->get_value(1, asupp.S_NAME, 25);
 	prsupp->get_value(2, asupp.S_ADDRESS, 40);
 	prsupp->get_value(4, asupp.S_PHONE, 15);
 	supprev[asupp] = iter->second;
+	if (presult) {
+	    presult->new_row();
+	    presult->add(iter->first);
+	    presult->add(iter->second);
+	}
     }
     
     return RCOK;    
@@ -3344,6 +3613,12 @@ struct required_type_cmp {
 
 
 w_rc_t ShoreTPCHEnv::xct_q16(const int /* xct_id */, q16_input_t& q16in)
+{
+    return (_run_query("Q16", q16in, &ShoreTPCHEnv::_iter_q16,
+                       &ShoreTPCHEnv::_fused_q16));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q16(q16_input_t& q16in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -3380,13 +3655,15 @@ w_rc_t ShoreTPCHEnv::xct_q16(const int /* xct_id */, q16_input_t& q16in)
 	prpart->get_value(5, psize);
 	int brand = str_to_Brand(apart.P_BRAND);
 	char *sylb;
+	char *saveptr;
 	int type;
-	sylb = strtok( apart.P_TYPE," ");
-	type = str_to_types1(sylb)*10 + str_to_types2(strtok(NULL," "));
+	sylb = strtok_r( apart.P_TYPE," ", &saveptr);
+	type = str_to_types1(sylb)*10 +
+	    str_to_types2(strtok_r(NULL," ", &saveptr));
 	if( brand != q16in.p_brand &&  type != q16in.p_type){
 	    for(int i = 0; i < 8; i++) {
 		if( q16in.p_size[i] == psize){
-		    pKeys_type[apart.P_PARTKEY]=required_type(brand, psize, type);
+		    pKeys_type[apart.P_PARTKEY]=required_type(brand, type, psize);
 		    break;
 		}
 	    }
@@ -3434,7 +3711,7 @@ w_rc_t ShoreTPCHEnv::xct_q16(const int /* xct_id */, q16_input_t& q16in)
     tuple_guard<partsupp_man_impl> prpartsupp(_ppartsupp_man);
 
     rep_row_t psreprow(_ppartsupp_man->ts());
-    sreprow.set(_ppartsupp_desc->maxsize());
+    psreprow.set(_ppartsupp_desc->maxsize());
 
     prpartsupp->_rep = &psreprow;
 
@@ -3461,11 +3738,22 @@ w_rc_t ShoreTPCHEnv::xct_q16(const int /* xct_id */, q16_input_t& q16in)
 		c++;
 		suppcount[tmpiter2->first] = c;
 	    } else {
-		suppcount[tmpiter2->first] = 1;
+		suppcount[tmpiter->second] = 1;
 	    }		
 	}
 	W_DO(ps_iter->next(_pssm, eof, *prpartsupp));
     }
+
+    if (presult) {
+	for (map<required_type, int, required_type_cmp>::iterator it =
+		 suppcount.begin(); it != suppcount.end(); ++it) {
+	    presult->new_row();
+	    presult->add(it->first.brand);
+	    presult->add(it->first.type);
+	    presult->add(it->first.size);
+	    presult->add(it->second);
+	}
+    }
     
     return RCOK;
 }// EOF: Q16
@@ -3478,7 +3766,13 @@ w_rc_t ShoreTPCHEnv::xct_q16(const int /* xct_id */, q16_input_t& q16in)
  *
  ********************************************************************/
 
-w_rc_t ShoreTPCHEnv::xct_q17(const int /* xct_id */, q17_input_t& q17in )
+w_rc_t ShoreTPCHEnv::xct_q17(const int /* xct_id */, q17_input_t& q17in)
+{
+    return (_run_query("Q17", q17in, &ShoreTPCHEnv::_iter_q17,
+                       &ShoreTPCHEnv::_fused_q17));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q17(q17_input_t& q17in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -3486,7 +3780,7 @@ w_rc_t ShoreTPCHEnv::xct_q17(const int /* xct_id */, q17_input_t& q17in )
     assert (_loaded);
 
     //phase#1 table scan part
-    map<int, vector<pair<int,int> >* > pKey_lineitems;
+    map<int, vector<pair<double,double> >* > pKey_lineitems;
 
     tuple_guard<part_man_impl> prpart(_ppart_man);
 
@@ -3512,11 +3806,12 @@ w_rc_t ShoreTPCHEnv::xct_q17(const int /* xct_id */, q17_input_t& q17in )
 	prpart->get_value(3, apart.P_BRAND, 10);
 	prpart->get_value(6, apart.P_CONTAINER, 10);
 	int brand = str_to_Brand(apart.P_BRAND);
-	char *s1 = strtok(apart.P_CONTAINER, " ");
+	char *saveptr;
+	char *s1 = strtok_r(apart.P_CONTAINER, " ", &saveptr);
 	int container = str_to_containers1(s1)*10+
-	    str_to_containers2(strtok(NULL," "));
+	    str_to_containers2(strtok_r(NULL," ", &saveptr));
 	if(brand == q17in.p_brand && container == q17in.p_container){
-	    vector<pair<int,int> > * v = new vector<pair<int,int> > ();
+	    vector<pair<double,double> > * v = new vector<pair<double,double> > ();
 	    pKey_lineitems[apart.P_PARTKEY] = v;
 	}
 	W_DO(p_iter->next(_pssm, eof, *prpart));
@@ -3545,10 +3840,10 @@ w_rc_t ShoreTPCHEnv::xct_q17(const int /* xct_id */, q17_input_t& q17in )
 	prlineitem->get_value(1, aline.L_PARTKEY);
 	prlineitem->get_value(5, aline.L_EXTENDEDPRICE);
 	prlineitem->get_value(4, aline.L_QUANTITY);
-	map<int, vector<pair<int,int> >* >::iterator tmpiter;
+	map<int, vector<pair<double,double> >* >::iterator tmpiter;
 	tmpiter = pKey_lineitems.find(aline.L_PARTKEY);
 	if(tmpiter != pKey_lineitems.end()){
-	    tmpiter->second->push_back(pair<int,int>
+	    tmpiter->second->push_back(pair<double,double>
 				       (aline.L_EXTENDEDPRICE, aline.L_QUANTITY));
 	}
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
@@ -3556,7 +3851,7 @@ w_rc_t ShoreTPCHEnv::xct_q17(const int /* xct_id */, q17_input_t& q17in )
 
     //phase#3 compute the scalar
     double sum = 0;
-    for(map<int, vector<pair<int,int> >* >::iterator iter=pKey_lineitems.begin();
+    for(map<int, vector<pair<double,double> >* >::iterator iter=pKey_lineitems.begin();
 	iter != pKey_lineitems.end();
 	iter++){
 	if(iter->second->size() == 0){
@@ -3577,6 +3872,11 @@ w_rc_t ShoreTPCHEnv::xct_q17(const int /* xct_id */, q17_input_t& q17in )
 	delete (iter->second);
     }
 
+    if (presult) {
+	presult->new_row();
+	presult->add(sum);
+    }
+
     return RCOK;
 }// EOF: Q17
 
@@ -3588,7 +3888,7 @@ w_rc_t ShoreTPCHEnv::xct_q17(const int /* xct_id */, q17_input_t& q17in )
  *
  ********************************************************************/
 struct Q18_row{
-    char c_name [25];
+    char c_name [STRSIZE(25)];
     int c_key;
     time_t o_orderdate;
     decimal o_totalprice;
@@ -3605,6 +3905,12 @@ struct Q18_row{
 };
 
 w_rc_t ShoreTPCHEnv::xct_q18(const int /* xct_id */, q18_input_t& q18in)
+{
+    return (_run_query("Q18", q18in, &ShoreTPCHEnv::_iter_q18,
+                       &ShoreTPCHEnv::_fused_q18));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q18(q18_input_t& q18in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -3667,36 +3973,53 @@ w_rc_t ShoreTPCHEnv::xct_q18(const int /* xct_id */, q18_input_t& q18in)
     for(map<int,int>::iterator it = order_Squant.begin();
 	it != order_Squant.end();
 	it++){
+	if( it->second <= q18in.l_quantity){
+	    continue;
+	}
+
 	// index scan order
 	tpch_orders_tuple anorder;
-	if( it->second > q18in.l_quantity){
-	    guard<index_scan_iter_impl<orders_t> > o_iter;
-	    {
-		index_scan_iter_impl<orders_t>* tmp_o_iter;
-		W_DO(_porders_man->o_get_iter_by_index(_pssm, tmp_o_iter,
-						       prorders, lowrep, highrep,
-						       it->first));
-		o_iter = tmp_o_iter;
-	    }
-	    
-	    bool eof;
-	    
-	    W_DO(o_iter->next(_pssm, eof, *prorders));
-	    prorders->get_value(1, anorder.O_CUSTKEY);
-	    prorders->get_value(3, anorder.O_TOTALPRICE);
-	    prorders->get_value(4, anorder.O_ORDERDATE, 15);
+	guard<index_scan_iter_impl<orders_t> > o_iter;
+	{
+	    index_scan_iter_impl<orders_t>* tmp_o_iter;
+	    W_DO(_porders_man->o_get_iter_by_index(_pssm, tmp_o_iter,
+						   prorders, lowrep, highrep,
+						   it->first));
+	    o_iter = tmp_o_iter;
 	}
-	
+
+	bool eof;
+
+	W_DO(o_iter->next(_pssm, eof, *prorders));
+	if (eof) {
+	    continue;
+	}
+	prorders->get_value(1, anorder.O_CUSTKEY);
+	prorders->get_value(3, anorder.O_TOTALPRICE);
+	double totalprice;
+	prorders->get_value(3, totalprice);
+	time_t the_orderdate;
+	prorders->get_value(4, the_orderdate);
+
 	//index proble customer
-	time_t the_orderdate = str_to_timet(anorder.O_ORDERDATE);     
 	tpch_customer_tuple acustomer;
-	_pcustomer_man->c_index_probe(_pssm, prcustomer, anorder.O_CUSTKEY);
+	if((_pcustomer_man->c_index_probe(_pssm, prcustomer,
+					  anorder.O_CUSTKEY)).is_error()) {
+	    continue;
+	}
 	prcustomer->get_value(1, acustomer.C_NAME, 25);
-	_pcustomer_man->give_tuple(prcustomer);
 	result.insert(pair<int,Q18_row>(it->first,Q18_row(acustomer.C_NAME,
 							  anorder.O_CUSTKEY,
 							  the_orderdate,
 							  anorder.O_TOTALPRICE)));
+	if (presult) {
+	    presult->new_row();
+	    presult->add(anorder.O_CUSTKEY);
+	    presult->add(it->first);
+	    presult->add(the_orderdate);
+	    presult->add(totalprice);
+	    presult->add(it->second);
+	}
     }
 
     return RCOK;
@@ -3711,6 +4034,12 @@ w_rc_t ShoreTPCHEnv::xct_q18(const int /* xct_id */, q18_input_t& q18in)
  ********************************************************************/
 
 w_rc_t ShoreTPCHEnv::xct_q19(const int /* xct_id */, q19_input_t& q19in)
+{
+    return (_run_query("Q19", q19in, &ShoreTPCHEnv::_iter_q19,
+                       &ShoreTPCHEnv::_fused_q19));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q19(q19_input_t& q19in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -3755,17 +4084,17 @@ w_rc_t ShoreTPCHEnv::xct_q19(const int /* xct_id */, q19_input_t& q19in)
 	    size > 1 && size < 5 ){
 	    partkey_brand.insert( pair<int,int>(apart.P_PARTKEY, 1));
 	} else if( brand == q19in.p_brand[1] &&
-		   ( strcmp( apart.P_CONTAINER, "MED BAG") ||
-		     strcmp( apart.P_CONTAINER, "MED BOX") ||
-		     strcmp( apart.P_CONTAINER, "MED PKG") ||
-		     strcmp( apart.P_CONTAINER, "MED PACK") ) &&
+		   ( strcmp( apart.P_CONTAINER, "MED BAG") == 0 ||
+		     strcmp( apart.P_CONTAINER, "MED BOX") == 0 ||
+		     strcmp( apart.P_CONTAINER, "MED PKG") == 0 ||
+		     strcmp( apart.P_CONTAINER, "MED PACK") == 0 ) &&
 		   size > 1 && size < 10){
 	    partkey_brand.insert( pair<int,int> (apart.P_PARTKEY, 2));
 	} else if( brand == q19in.p_brand[2] &&
-		   ( strcmp( apart.P_CONTAINER, "MED BAG") ||
-		     strcmp( apart.P_CONTAINER, "MED BAG") ||
-		     strcmp( apart.P_CONTAINER, "MED BAG") ||
-		     strcmp( apart.P_CONTAINER, "MED BAG") ) &&
+		   ( strcmp( apart.P_CONTAINER, "LG CASE") == 0 ||
+		     strcmp( apart.P_CONTAINER, "LG BOX") == 0 ||
+		     strcmp( apart.P_CONTAINER, "LG PACK") == 0 ||
+		     strcmp( apart.P_CONTAINER, "LG PKG") == 0 ) &&
 		   size > 1 && size < 15 ){
 	    partkey_brand.insert( pair<int,int> (apart.P_PARTKEY, 3));
 	} 
@@ -3810,6 +4139,11 @@ w_rc_t ShoreTPCHEnv::xct_q19(const int /* xct_id */, q19_input_t& q19in)
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
     }
 
+    if (presult) {
+	presult->new_row();
+	presult->add(revenue);
+    }
+
     return RCOK;
 }// EOF: Q19
 
@@ -3829,6 +4163,12 @@ struct int_pair_cmp {
 
 
 w_rc_t ShoreTPCHEnv::xct_q20(const int /* xct_id */, q20_input_t& q20in)
+{
+    return (_run_query("Q20", q20in, &ShoreTPCHEnv::_iter_q20,
+                       &ShoreTPCHEnv::_fused_q20));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q20(q20_input_t& q20in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -3863,8 +4203,9 @@ w_rc_t ShoreTPCHEnv::xct_q20(const int /* xct_id */, q20_input_t& q20in)
     while(!eof){
 	prpart->get_value(0, apart.P_PARTKEY);
 	prpart->get_value(1, apart.P_NAME, 55);
-	char* s1 = strtok(apart.P_NAME, " ");
-	if( strcmp( s1, p_name) == 0 ) {
+	char* saveptr;
+	char* s1 = strtok_r(apart.P_NAME, " ", &saveptr);
+	if( s1 != NULL && strcmp( s1, p_name) == 0 ) {
 	    partkey.insert(pair<int, bool> (apart.P_PARTKEY, 1));
 	}
 	W_DO(p_iter->next(_pssm, eof, *prpart));
@@ -3897,7 +4238,7 @@ w_rc_t ShoreTPCHEnv::xct_q20(const int /* xct_id */, q20_input_t& q20in)
 	prpartsupp->get_value(2, apartsupp.PS_AVAILQTY);
 	if( partkey.find(apartsupp.PS_PARTKEY) != partkey.end() ){
 	    pair< pair <int, int>,pair<int,int> > tmp
-		(pair<int,int>( apartsupp.PS_SUPPKEY, apartsupp.PS_SUPPKEY),
+		(pair<int,int>( apartsupp.PS_PARTKEY, apartsupp.PS_SUPPKEY),
 		 pair<int,int>( apartsupp.PS_AVAILQTY, 0) );
 	    supppart_avquant_sumquant.insert(tmp);
 	}
@@ -3936,7 +4277,6 @@ w_rc_t ShoreTPCHEnv::xct_q20(const int /* xct_id */, q20_input_t& q20in)
     }
 
     tpch_lineitem_tuple aline;
-    double q6_result = 0;
     
     W_DO(l_iter->next(_pssm, eof, *prlineitem));
 	
@@ -3959,7 +4299,7 @@ w_rc_t ShoreTPCHEnv::xct_q20(const int /* xct_id */, q20_input_t& q20in)
     
     //phase#4 : compare the available_quantity with sumof_quantity
     map<int, bool> suppkey;
-    map< pair<int,int>, pair<int, int> > :: iterator it =
+    map< pair<int,int>, pair<int, int>, int_pair_cmp > :: iterator it =
 	supppart_avquant_sumquant.begin();
     while( it != supppart_avquant_sumquant.end()){
 	if( it->second.first > .5 * it->second.second ){
@@ -3982,13 +4322,17 @@ w_rc_t ShoreTPCHEnv::xct_q20(const int /* xct_id */, q20_input_t& q20in)
     for(map<int,bool>::iterator iter = suppkey.begin();
 	iter != suppkey.end();
 	iter++){
-       _psupplier_man->s_index_probe(_pssm, prsupp, iter->first);
+       if((_psupplier_man->s_index_probe(_pssm, prsupp,
+					 iter->first)).is_error()) {
+	   continue;
+       }
        tpch_supplier_tuple asupp;
        prsupp->get_value(1, asupp.S_NAME, 25);
        prsupp->get_value(2, asupp.S_ADDRESS, 40);
        prsupp->get_value(3, asupp.S_NATIONKEY);
-       if(asupp.S_NATIONKEY == q20in.n_name){
-	   //result
+       if(asupp.S_NATIONKEY == q20in.n_name && presult){
+	   presult->new_row();
+	   presult->add(iter->first);
        }
     }
     
@@ -4004,6 +4348,12 @@ w_rc_t ShoreTPCHEnv::xct_q20(const int /* xct_id */, q20_input_t& q20in)
  ********************************************************************/
 
 w_rc_t ShoreTPCHEnv::xct_q21(const int /* xct_id */, q21_input_t& q21in)
+{
+    return (_run_query("Q21", q21in, &ShoreTPCHEnv::_iter_q21,
+                       &ShoreTPCHEnv::_fused_q21));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q21(q21_input_t& q21in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -4099,10 +4449,10 @@ w_rc_t ShoreTPCHEnv::xct_q21(const int /* xct_id */, q21_input_t& q21in)
     while (!eof) {
 	prlineitem->get_value(0, aline.L_ORDERKEY);
 	prlineitem->get_value(2, aline.L_SUPPKEY);	    
-	prlineitem->get_value(11, aline.L_COMMITDATE, 15);
-	prlineitem->get_value(12, aline.L_RECEIPTDATE, 15);
-	time_t the_commitdate = str_to_timet(aline.L_COMMITDATE);
-	time_t the_receiptdate = str_to_timet(aline.L_RECEIPTDATE);
+	time_t the_commitdate;
+	prlineitem->get_value(11, the_commitdate);
+	time_t the_receiptdate;
+	prlineitem->get_value(12, the_receiptdate);
 	if( orderkey.find(aline.L_ORDERKEY) != orderkey.end()){
 	    if (the_commitdate < the_receiptdate &&
 		suppkey.find(aline.L_SUPPKEY) != suppkey.end()){
@@ -4110,16 +4460,16 @@ w_rc_t ShoreTPCHEnv::xct_q21(const int /* xct_id */, q21_input_t& q21in)
 					   (aline.L_SUPPKEY, aline.L_ORDERKEY));
 		map<int,int>::iterator it = delay2order.find(aline.L_ORDERKEY);
 		if (it != delay2order.end() && it->second != aline.L_SUPPKEY){
-		    delay2order[it->first] = -1;
+		    delay2order[aline.L_ORDERKEY] = -1;
 		} else {
-		    delay2order[it->first] = aline.L_SUPPKEY;
+		    delay2order[aline.L_ORDERKEY] = aline.L_SUPPKEY;
 		}
 	    }
 	    map<int,int>::iterator it = multiOrders.find(aline.L_ORDERKEY);
 	    if (it != multiOrders.end() && it->second != aline.L_SUPPKEY){
-		multiOrders[it->first] = -1;
+		multiOrders[aline.L_ORDERKEY] = -1;
 	    } else {
-		multiOrders[it->first] = aline.L_SUPPKEY;
+		multiOrders[aline.L_ORDERKEY] = aline.L_SUPPKEY;
 	    }
 	}
 	W_DO(l_iter->next(_pssm, eof, *prlineitem));
@@ -4139,6 +4489,15 @@ w_rc_t ShoreTPCHEnv::xct_q21(const int /* xct_id */, q21_input_t& q21in)
 	    }
 	}
     }
+
+    if (presult) {
+	for (map<int,int>::iterator it = supK_numwait.begin();
+	     it != supK_numwait.end(); ++it) {
+	    presult->new_row();
+	    presult->add(it->first);
+	    presult->add(it->second);
+	}
+    }
    
     return RCOK;
 }
@@ -4152,6 +4511,12 @@ w_rc_t ShoreTPCHEnv::xct_q21(const int /* xct_id */, q21_input_t& q21in)
  ********************************************************************/
 
 w_rc_t ShoreTPCHEnv::xct_q22(const int /* xct_id */, q22_input_t& q22in)
+{
+    return (_run_query("Q22", q22in, &ShoreTPCHEnv::_iter_q22,
+                       &ShoreTPCHEnv::_fused_q22));
+}
+
+w_rc_t ShoreTPCHEnv::_iter_q22(q22_input_t& q22in, tpch_result_t* presult)
 {
     // ensure a valid environment
     assert (_pssm);
@@ -4159,8 +4524,8 @@ w_rc_t ShoreTPCHEnv::xct_q22(const int /* xct_id */, q22_input_t& q22in)
     assert (_loaded);
 
     //phase#1 tablescan customer: <ckey,acctbal,code> and AVG(acctbal)
-    map<int, pair<decimal,int> > ckey_acbalCcode;
-    decimal bal_avg = 0;
+    map<int, pair<double,int> > ckey_acbalCcode;
+    double bal_avg = 0;
 
     tuple_guard<customer_man_impl> prcustomer(_pcustomer_man);
 
@@ -4184,26 +4549,30 @@ w_rc_t ShoreTPCHEnv::xct_q22(const int /* xct_id */, q22_input_t& q22in)
     while(!eof){
 	prcustomer->get_value(0, acust.C_CUSTKEY);
 	prcustomer->get_value(4, acust.C_PHONE, 15);
-	prcustomer->get_value(5, acust.C_ACCTBAL);
-	char* c_cntrycode_str =  strtok ( acust.C_PHONE, "-" );
-	int c_cntrycode =  atoi( c_cntrycode_str);
+	double acctbal;
+	prcustomer->get_value(5, acctbal);
+	// the country code is the prefix of the phone, up to the '-'
+	int c_cntrycode =  atoi( acust.C_PHONE);
 	for(int i = 0; i < 7; i++ ){
 	    if( q22in.cntrycode[i] == c_cntrycode){
-		ckey_acbalCcode.insert( pair<int,  pair<decimal,int> >
-					(acust.C_CUSTKEY, pair<decimal,int>
-					 (acust.C_ACCTBAL, c_cntrycode)));
-		bal_avg += acust.C_ACCTBAL;
+		ckey_acbalCcode.insert( pair<int,  pair<double,int> >
+					(acust.C_CUSTKEY, pair<double,int>
+					 (acctbal, c_cntrycode)));
+		bal_avg += acctbal;
 		break;
 	    }
 	}
 	W_DO(c_iter->next(_pssm, eof, *prcustomer));
     }
 
+    if (ckey_acbalCcode.empty()) {
+	return RCOK;
+    }
     bal_avg /= (int)ckey_acbalCcode.size();
     
     //phase#2 index scan order
     //scalar: numof customer, total balance
-    map<int, pair<int, decimal> > cntrycode_scalars; 
+    map<int, pair<int, double> > cntrycode_scalars; 
 
     tuple_guard<orders_man_impl> prorders(_porders_man);
 
@@ -4218,7 +4587,7 @@ w_rc_t ShoreTPCHEnv::xct_q22(const int /* xct_id */, q22_input_t& q22in)
     lowrep.set(_porders_desc->maxsize());
     highrep.set(_porders_desc->maxsize());
 
-    map<int, pair<decimal,int> >::iterator it =  ckey_acbalCcode.begin();
+    map<int, pair<double,int> >::iterator it =  ckey_acbalCcode.begin();
     while(it != ckey_acbalCcode.end()){
 	guard<index_scan_iter_impl<orders_t> > o_iter;
 	{
@@ -4232,22 +4601,33 @@ w_rc_t ShoreTPCHEnv::xct_q22(const int /* xct_id */, q22_input_t& q22in)
 	W_DO(o_iter->next(_pssm, eof, *prorders));
 
 	if(!eof && it->second.first > bal_avg){
-	    map<int, pair<int,decimal> >::iterator tmp =
+	    map<int, pair<int,double> >::iterator tmp =
 		cntrycode_scalars.find( it->second.second);
 	    if(tmp != cntrycode_scalars.end()){
 		int c = tmp->second.first;
-		decimal t = tmp->second.second;
+		double t = tmp->second.second;
 		c++;
 		t+= it->second.first;
-		cntrycode_scalars[it->second.second] = pair<int, decimal> (c, t);
+		cntrycode_scalars[it->second.second] = pair<int, double> (c, t);
 	    } else {
-		cntrycode_scalars[it->second.second] = pair<int, decimal>
+		cntrycode_scalars[it->second.second] = pair<int, double>
 		    (1, it->second.first);
 	    }
 	}       
 	it++;
     }
 
+    if (presult) {
+	for (map<int, pair<int,double> >::iterator tmp =
+		 cntrycode_scalars.begin();
+	     tmp != cntrycode_scalars.end(); ++tmp) {
+	    presult->new_row();
+	    presult->add(tmp->first);
+	    presult->add(tmp->second.first);
+	    presult->add(tmp->second.second);
+	}
+    }
+
     return RCOK;
 }
 